@@ -128,6 +128,18 @@ extern const char* InterfaceName;                 /**< Interface name */
 
 }
 
+/**
+ * Interface definitions for org.allseen.IntrospectableTree
+ *
+ * Objects opt in to this interface by adding it with BusObject::AddInterface(). It returns the
+ * introspection data of the object and all of its descendants in a single reply.
+ */
+namespace IntrospectableTree {
+
+extern const char* InterfaceName;                 /**< Interface name */
+
+}
+
 
 }
 }
@@ -141,6 +141,27 @@ class BusAttachment : public MessageReceiver {
         virtual void PingCB(QStatus status, void* context) = 0;
     };
 
+    /**
+     * Pure virtual base class implemented by classes that wish to call PingAsync()
+     * for multiple names.
+     */
+    class PingMultipleAsyncCB {
+      public:
+        /** Destructor */
+        virtual ~PingMultipleAsyncCB() { }
+
+        /**
+         * Called when PingAsync() for multiple names completes.
+         *
+         * @param names        The names that were pinged, in the order they were passed to PingAsync().
+         * @param statuses     The outcome for each name, with the same values as the status
+         *                     passed to PingAsyncCB::PingCB().
+         * @param numNames     The number of names.
+         * @param context      User defined context which will be passed as-is to callback.
+         */
+        virtual void PingMultipleCB(const char** names, const QStatus* statuses, size_t numNames, void* context) = 0;
+    };
+
     /**
      * Pure virtual base class implemented by classes that wish to call GetNameOwnerAsync().
      */
@@ -1678,6 +1699,50 @@ class BusAttachment : public MessageReceiver {
      */
     QStatus PingAsync(const char* name, uint32_t timeout, BusAttachment::PingAsyncCB* callback, void* context);
 
+    /**
+     * Determine if you are able to find several remote connections based on their
+     * BusNames. The names are pinged by the router in a single request, which
+     * costs far less than a Ping() call per name.
+     *
+     * @param[in] names       The unique or well-known names to ping
+     * @param[in] numNames    The number of names
+     * @param[in] timeout     Timeout specified in milliseconds to wait for the replies
+     * @param[out] statuses   Array of numNames entries that returns the outcome for
+     *                        each name, with the same values as returned by Ping()
+     *
+     * @return
+     *   - #ER_OK the names were pinged and statuses holds the outcome for each of them
+     *   - #ER_BUS_NOT_CONNECTED the BusAttachment is not connected to the bus
+     *   - #ER_BUS_BAD_BUS_NAME one of the names is not a valid bus name
+     *   - #ER_BAD_ARG_2 no names were passed in
+     *   - An error status otherwise
+     */
+    QStatus Ping(const char** names, size_t numNames, uint32_t timeout, QStatus* statuses);
+
+    /**
+     * Determine if you are able to find several remote connections based on their
+     * BusNames. The names are pinged by the router in a single request.
+     *
+     * This call executes asynchronously. When the responses for all names are
+     * received, the callback will be called.
+     *
+     * @param[in] names     The unique or well-known names to ping
+     * @param[in] numNames  The number of names
+     * @param[in] timeout   Timeout specified in milliseconds to wait for the replies
+     * @param[in] callback  Called when the responses for all names are received.
+     * @param[in] context   User defined context which will be passed as-is to callback.
+     *
+     * @see PingMultipleAsyncCB
+     *
+     * @return
+     *     - #ER_OK iff method call to local router response was successful.
+     *     - #ER_BUS_NOT_CONNECTED the BusAttachment is not connected to the bus
+     *     - #ER_BUS_BAD_BUS_NAME one of the names is not a valid bus name
+     *     - #ER_BAD_ARG_2 no names were passed in
+     *     - Other error status codes indicating a failure.
+     */
+    QStatus PingAsync(const char** names, size_t numNames, uint32_t timeout, BusAttachment::PingMultipleAsyncCB* callback, void* context);
+
     /**
      * Set a Translator for all BusObjects and InterfaceDescriptions. This Translator is used for
      * descriptions appearing in introspection, and localizable text in about data. Note that any Translators
@@ -133,6 +133,56 @@ class BusObject : public MessageReceiver {
                             SessionId id,
                             uint8_t flags = 0);
 
+    /**
+     * Coalesce the PropertiesChanged signals of properties marked with MarkPropChanged().
+     *
+     * Changed properties are accumulated per interface, session and flags and emitted in a
+     * single PropertiesChanged signal once @a interval has passed since the first of them was
+     * marked or as soon as @a maxBatch distinct properties are pending, whichever comes first.
+     * The values are read when the signal is emitted so a property that changes several times
+     * within an interval is only sent once with its latest value.
+     *
+     * The signals are emitted from a timer thread shared by all objects, which reads the values
+     * through Get() or the handler registered with SetPropsGetter().  A derived class must
+     * therefore stop coalescing before it is torn down, at the latest in its own destructor:
+     * unregister the object from the bus, which drops the pending changes, or call this with an
+     * interval of 0, which emits them.  The BusObject destructor stops coalescing as well but by then the derived part of
+     * the object is already gone.
+     *
+     * @param interval  Maximum time in milliseconds a change is held back (0 to emit right away
+     *                  along with any changes still pending).
+     * @param maxBatch  Number of pending properties that triggers an emit (0 for no limit).
+     *
+     * @return   ER_OK if successful.
+     */
+    QStatus SetPropChangedCoalescing(uint32_t interval, size_t maxBatch = 0);
+
+    /**
+     * Mark a property as changed. The PropertiesChanged signal is emitted as configured with
+     * SetPropChangedCoalescing() or right away if coalescing has not been configured.
+     *
+     *  BusObject must be registered before calling this method.
+     *
+     * @param ifcName   The name of the interface
+     * @param propName  The name of the property that has changed
+     * @param id        ID of the session we broadcast the signal to (0 for all)
+     * @param flags     Flags to be added to the signal.
+     *
+     * @return
+     *      - #ER_OK if successful.
+     *      - #ER_BUS_OBJECT_NOT_REGISTERED if the object is not registered.
+     *      - An error status from EmitPropChanged() if the signal was emitted right away.
+     */
+    QStatus MarkPropChanged(const char* ifcName, const char* propName, SessionId id, uint8_t flags = 0);
+
+    /**
+     * Emit the PropertiesChanged signals for all properties marked with MarkPropChanged() that
+     * are still pending.
+     *
+     * @return   ER_OK if successful or the status of the first signal that failed.
+     */
+    QStatus FlushPropChanged();
+
     /**
      * Get a reference to the underlying BusAttachment
      *
@@ -200,6 +250,31 @@ class BusObject : public MessageReceiver {
                    uint8_t flags = 0,
                    Message* msg = NULL);
 
+    /**
+     * Send a signal whose arguments are serialized by a body writer such as
+     * TypedArgs instead of being passed as MsgArgs.
+     *
+     * @param destination  The unique or well-known bus name or the signal recipient (NULL for broadcast signals)
+     * @param sessionId    The session this message is for, see Signal() above.
+     * @param signal       Interface member of signal being emitted.
+     * @param body         Writer for the signal arguments. Its signature must match the signal's signature.
+     * @param timeToLive   If non-zero this specifies the useful lifetime for this signal, see Signal() above.
+     * @param flags        Logical OR of the message flags for this signal, see Signal() above.
+     * @param msg          [OUT] If non-null, the sent signal message is returned to the caller.
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_BUS_OBJECT_NOT_REGISTERED if bus object has not yet been registered
+     *      - #ER_BUS_UNEXPECTED_SIGNATURE if the body does not match the signal's signature
+     *      - An error status otherwise
+     */
+    QStatus Signal(const char* destination,
+                   SessionId sessionId,
+                   const InterfaceDescription::Member& signal,
+                   const MsgBodyWriter& body,
+                   uint16_t timeToLive = 0,
+                   uint8_t flags = 0,
+                   Message* msg = NULL);
+
     /**
      * Remove sessionless message sent from this object from local router's
      * store/forward cache.
@@ -317,6 +392,19 @@ class BusObject : public MessageReceiver {
      */
     QStatus MethodReply(const Message& msg, const MsgArg* args = NULL, size_t numArgs = 0, Message* replyMsg = NULL);
 
+    /**
+     * Reply to a method call with arguments serialized by a body writer such as TypedArgs.
+     *
+     * @param msg      The method call message
+     * @param body     Writer for the reply arguments. Its signature must match the method's reply signature.
+     * @param replyMsg Pointer to a Message object to receive a copy of the sent reply message (can be NULL if not needed)
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_BUS_OBJECT_NOT_REGISTERED if bus object has not yet been registered
+     *      - An error status otherwise
+     */
+    QStatus MethodReply(const Message& msg, const MsgBodyWriter& body, Message* replyMsg = NULL);
+
     /**
      * Reply to a method call with an error message.
      *
@@ -385,6 +473,25 @@ class BusObject : public MessageReceiver {
                              MessageReceiver::MethodHandler handler,
                              void* context = NULL);
 
+    /**
+     * Add a method handler that reads its arguments from the marshaled body, for
+     * example with TypedArgs::Get(), rather than from MsgArgs. The method call is
+     * dispatched without unmarshaling the body so Message::GetArg() and
+     * Message::GetArgs() return nothing in the handler.
+     *
+     * @param member   Interface member implemented by handler.
+     * @param handler  Method handler.
+     * @param context  An optional context. This is mainly intended for implementing language
+     *                 bindings and should normally be NULL.
+     *
+     * @return
+     *      - #ER_OK if the method handler was added.
+     *      - An error status otherwise
+     */
+    QStatus AddTypedMethodHandler(const InterfaceDescription::Member* member,
+                                  MessageReceiver::MethodHandler handler,
+                                  void* context = NULL);
+
     /**
      * Convenience method used to add a set of method handers at once.
      *
@@ -397,6 +504,32 @@ class BusObject : public MessageReceiver {
      */
     QStatus AddMethodHandlers(const MethodEntry* entries, size_t numEntries);
 
+    /**
+     * Handler that reads several properties of an interface from this object at once.
+     *
+     * @param ifcName    Identifies the interface that the properties are defined on
+     * @param propNames  Identifies the properties to get
+     * @param numProps   The number of properties in @a propNames
+     * @param[out] vals  Array of @a numProps entries that returns the property values in the
+     *                   same order as @a propNames.
+     * @return #ER_OK if all values were returned otherwise an error status
+     */
+    typedef QStatus (BusObject::* PropsGetter)(const char* ifcName, const char** propNames, size_t numProps, MsgArg* vals);
+
+    /**
+     * Register a handler that reads several properties at once. It is used for Properties.GetAll
+     * and for the values carried by PropertiesChanged. BusObjects that can provide a snapshot
+     * of their properties more efficiently than one at a time may register one. Without a
+     * handler the properties are read with Get() one at a time.
+     *
+     * @param getter  The handler, or NULL to read the properties with Get().
+     *
+     * @return
+     *      - #ER_OK if the handler was registered
+     *      - #ER_BUS_CANNOT_ADD_HANDLER if the object is already registered
+     */
+    QStatus SetPropsGetter(PropsGetter getter);
+
     /**
      * Handle a bus request to read a property from this object.
      * BusObjects that implement properties should override this method.
@@ -595,6 +728,40 @@ class BusObject : public MessageReceiver {
      */
     bool ImplementsInterface(const char* iface);
 
+    /**
+     * Returns the introspection XML for the content of this object's node including the nodes of
+     * all of its descendants. Unlike GenerateIntrospection() each node carries its own description
+     * and security annotation.
+     *
+     * @param languageTag   Language requested for <description>'s.
+     * @param indent        Number of characters to indent the XML
+     * @return              Description of the object tree in AllJoyn introspection XML format
+     */
+    qcc::String GenerateTreeIntrospection(const char* languageTag, size_t indent) const;
+
+    /**
+     * Read several properties of an interface with the handler registered by SetPropsGetter() or
+     * with Get().
+     *
+     * @param ifcName    Identifies the interface that the properties are defined on
+     * @param propNames  Identifies the properties to get
+     * @param numProps   The number of properties in @a propNames
+     * @param[out] vals  Array of @a numProps entries that returns the property values.
+     * @return #ER_OK if all values were returned otherwise the error of the first that was not
+     */
+    QStatus GetProps(const char* ifcName, const char** propNames, size_t numProps, MsgArg* vals);
+
+    /**
+     * Default handler for a bus attempt to read the introspection data of the object and all of its
+     * descendants in a single reply. This handler is only registered for objects that add the
+     * @c org.allseen.IntrospectableTree interface and did not add their own handler for the
+     * IntrospectTree method.
+     *
+     * @param member   Identifies the @c org.allseen.IntrospectableTree.IntrospectTree method.
+     * @param msg      The IntrospectableTree.IntrospectTree request.
+     */
+    void IntrospectTree(const InterfaceDescription::Member* member, Message& msg);
+
     /**
      * Replace this object by another one. This may require unlinking the existing object from its
      * parent and children and linking in the new one.
@@ -641,6 +808,12 @@ class BusObject : public MessageReceiver {
      */
     void InUseDecrement();
 
+    /**
+     * Drop the pending coalesced property changes and wait for any being emitted.
+     * Called when the object is unregistered.
+     */
+    void StopPropChangedCoalescing();
+
     /**
      * Get the introspection description for the provided language or NULL if not
      * defined.
@@ -663,7 +836,27 @@ class BusObject : public MessageReceiver {
                            uint16_t timeToLive = 0,
                            uint8_t flags = 0,
                            Message* msg = NULL,
-                           SignalAuthorizationCallback* authorizationCallback = NULL);
+                           SignalAuthorizationCallback* authorizationCallback = NULL,
+                           const MsgBodyWriter* body = NULL);
+
+    /**
+     * the internal method to reply to a method call.
+     * @see MethodReply
+     */
+    QStatus MethodReplyInternal(const Message& msg,
+                                const MsgArg* args,
+                                size_t numArgs,
+                                const MsgBodyWriter* body,
+                                Message* replyMsg);
+
+    /**
+     * the internal method to add a method handler.
+     * @see AddMethodHandler
+     */
+    QStatus AddMethodHandlerInternal(const InterfaceDescription::Member* member,
+                                     MessageReceiver::MethodHandler handler,
+                                     void* context,
+                                     bool typedArgs);
 
     struct Components;
     Components* components; /**< Internal components of this object */
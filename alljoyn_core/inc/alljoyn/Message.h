@@ -178,6 +178,46 @@ typedef qcc::ManagedObj<_RemoteEndpoint> RemoteEndpoint;
 typedef qcc::ManagedObj<_Message> Message;
 
 
+/**
+ * Writes a message body that was not built from #MsgArg values. A %MsgBodyWriter
+ * serializes its values straight into the message buffer. See TypedArgs.h for an
+ * implementation that derives the signature from C++ types.
+ */
+class MsgBodyWriter {
+  public:
+    /**
+     * Destructor
+     */
+    virtual ~MsgBodyWriter() { }
+
+    /**
+     * Get the signature of the body.
+     *
+     * @return  The signature of the values written by Marshal().
+     */
+    virtual const char* GetSignature() const = 0;
+
+    /**
+     * Get the number of bytes Marshal() will write.
+     *
+     * @return  The marshaled size of the body including padding.
+     */
+    virtual size_t GetSize() const = 0;
+
+    /**
+     * Serialize the body. The buffer is aligned on an 8 byte boundary and
+     * offsets are relative to the start of the body.
+     *
+     * @param buf          The buffer, at least GetSize() bytes long.
+     * @param endianSwap   True if the body must be written in non-native endianess.
+     *
+     * @return
+     *      - #ER_OK if the body was written
+     *      - An error status otherwise
+     */
+    virtual QStatus Marshal(uint8_t* buf, bool endianSwap) const = 0;
+};
+
 /**
  * This class implements the functionality underlying the #Message class. Instances
  * of #_Message should not be declared directly by applications. Rather applications
@@ -322,6 +362,50 @@ class _Message {
      */
     QStatus GetArgs(const char* signature, ...);
 
+    /**
+     * Get the marshaled message body without unmarshaling it into #MsgArg values.
+     * Encrypted bodies are decrypted first. This is used by readers that
+     * deserialize straight from the message buffer, see TypedArgs.h.
+     *
+     * @param expectedSignature       The expected signature for the message body.
+     * @param[out] body               Returns the start of the body or NULL if the body is empty.
+     * @param[out] bodyLen            Returns the length of the body.
+     * @param[out] endianSwap         Returns true if the body is in non-native endianess.
+     * @param expectedReplySignature  The expected reply signature for this message if it is a
+     *                                method call message or NULL otherwise.
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the body does not have the expected signature
+     *      - #ER_BUS_BAD_BODY_LEN if the body is empty but the signature is not or vice versa
+     *      - An error status otherwise
+     */
+    QStatus GetMarshaledBody(const char* expectedSignature,
+                             const uint8_t*& body,
+                             size_t& bodyLen,
+                             bool& endianSwap,
+                             const char* expectedReplySignature = NULL);
+
+    /**
+     * @internal
+     * Check if the body of the message is encrypted, that is the message was
+     * received encrypted and has not been decrypted yet or has already been
+     * encrypted for sending.
+     *
+     * @return  true if the body is encrypted.
+     */
+    bool IsBodyEncrypted() const { return IsEncrypted() && !encrypt && (msgArgs == NULL); }
+
+    /**
+     * @internal
+     * Get a file descriptor passed with the message.
+     *
+     * @param index  Index of the handle as marshaled in the message body.
+     *
+     * @return  The file descriptor or qcc::INVALID_SOCKET_FD if there is no such handle.
+     */
+    qcc::SocketFd GetHandle(size_t index) const;
+
     /**
      * Accessor function to get serial number for the message. Usually only important for
      * #MESSAGE_METHOD_CALL for matching up the reply to the call.
@@ -609,11 +693,12 @@ class _Message {
      * @param call        The call message - can be this message.
      * @param args        The arguments for the reply (can be NULL)
      * @param numArgs     The number of arguments
+     * @param body        Writer for the body, used instead of args if not NULL
      * @return
      *      - #ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus ReplyMsg(const Message& call, const MsgArg* args, size_t numArgs);
+    QStatus ReplyMsg(const Message& call, const MsgArg* args, size_t numArgs, const MsgBodyWriter* body = NULL);
 
     /**
      * @internal
@@ -623,11 +708,12 @@ class _Message {
      * @param sender      The sender of the message
      * @param args        The arguments for the reply (can be NULL)
      * @param numArgs     The number of arguments
+     * @param body        Writer for the body, used instead of args if not NULL
      * @return
      *      - #ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus ReplyMsg(const Message& call, const qcc::String& sender, const MsgArg* args, size_t numArgs);
+    QStatus ReplyMsg(const Message& call, const qcc::String& sender, const MsgArg* args, size_t numArgs, const MsgBodyWriter* body = NULL);
 
     /**
      * @internal
@@ -738,6 +824,9 @@ class _Message {
      * @param args        The method call argument list (can be NULL)
      * @param numArgs     The number of arguments
      * @param flags       A logical OR of the AllJoyn flags
+     * @param body        Writer for the body, used instead of args if not NULL
+     * @param headerKey   Identifies the member, e.g. its InterfaceDescription::Member,
+     *                    so the header fields can be reused; NULL if there is none
      * @return
      *      - #ER_OK if successful
      *      - An error status otherwise
@@ -750,7 +839,9 @@ class _Message {
                     const qcc::String& methodName,
                     const MsgArg* args,
                     size_t numArgs,
-                    uint8_t flags);
+                    uint8_t flags,
+                    const MsgBodyWriter* body = NULL,
+                    const void* headerKey = NULL);
 
     /**
      * @internal
@@ -766,6 +857,9 @@ class _Message {
      * @param args        The method call argument list (can be NULL)
      * @param numArgs     The number of arguments
      * @param flags       A logical OR of the AllJoyn flags
+     * @param body        Writer for the body, used instead of args if not NULL
+     * @param headerKey   Identifies the member, e.g. its InterfaceDescription::Member,
+     *                    so the header fields can be reused; NULL if there is none
      *
      * @return
      *      - #ER_OK if successful
@@ -780,7 +874,9 @@ class _Message {
                     const qcc::String& methodName,
                     const MsgArg* args,
                     size_t numArgs,
-                    uint8_t flags);
+                    uint8_t flags,
+                    const MsgBodyWriter* body = NULL,
+                    const void* headerKey = NULL);
 
     /**
      * @internal
@@ -797,6 +893,9 @@ class _Message {
      * @param flags       A logical OR of the AllJoyn flags.
      * @param timeToLive  Time-to-live. Units are seconds for sessionless signals. Milliseconds for non-sessionless signals.
      *                    Signals that cannot be sent within this time limit are discarded. Zero indicates reliable delivery.
+     * @param body        Writer for the body, used instead of args if not NULL
+     * @param headerKey   Identifies the member, e.g. its InterfaceDescription::Member,
+     *                    so the header fields can be reused; NULL if there is none
      * @return
      *      - #ER_OK if successful
      *      - An error status otherwise
@@ -810,7 +909,9 @@ class _Message {
                       const MsgArg* args,
                       size_t numArgs,
                       uint8_t flags,
-                      uint16_t timeToLive);
+                      uint16_t timeToLive,
+                      const MsgBodyWriter* body = NULL,
+                      const void* headerKey = NULL);
 
     /**
      * @internal
@@ -828,6 +929,9 @@ class _Message {
      * @param flags       A logical OR of the AllJoyn flags.
      * @param timeToLive  Time-to-live. Units are seconds for sessionless signals. Milliseconds for non-sessionless signals.
      *                    Signals that cannot be sent within this time limit are discarded. Zero indicates reliable delivery.
+     * @param body        Writer for the body, used instead of args if not NULL
+     * @param headerKey   Identifies the member, e.g. its InterfaceDescription::Member,
+     *                    so the header fields can be reused; NULL if there is none
      *
      * @return
      *      - #ER_OK if successful
@@ -843,7 +947,9 @@ class _Message {
                       const MsgArg* args,
                       size_t numArgs,
                       uint8_t flags,
-                      uint16_t timeToLive);
+                      uint16_t timeToLive,
+                      const MsgBodyWriter* body = NULL,
+                      const void* headerKey = NULL);
 
     /**
      * @internal
@@ -1317,6 +1423,9 @@ class _Message {
      * @param numArgs     number of MsgArg
      * @param flags       A logical OR of the AllJoyn flags
      * @param sessionId   The session id that the Message will be sent to
+     * @param body        Writer for the body, used instead of args if not NULL
+     * @param headerKey   Identifies the member, e.g. its InterfaceDescription::Member,
+     *                    so the header fields can be reused; NULL if there is none
      *
      *  @return
      *    - #ER_OK if successful
@@ -1329,7 +1438,9 @@ class _Message {
                            const MsgArg* args,
                            uint8_t numArgs,
                            uint8_t flags,
-                           SessionId sessionId);
+                           SessionId sessionId,
+                           const MsgBodyWriter* body = NULL,
+                           const void* headerKey = NULL);
 
     /**
      * Marshal the MsgArg arguments into the message
@@ -271,6 +271,24 @@ class ProxyBusObject : public MessageReceiver {
      */
     QStatus IntrospectRemoteObjectAsync(ProxyBusObject::Listener* listener, ProxyBusObject::Listener::IntrospectCB callback, void* context, uint32_t timeout = DefaultCallTimeout);
 
+    /**
+     * Query the remote object on the bus to determine the interfaces and
+     * children that exist for the object and all of its descendants. Use
+     * this information to populate the proxy hierarchy rooted at this object.
+     *
+     * If the remote object implements @c org.allseen.IntrospectableTree the
+     * whole subtree is retrieved in a single method call. Otherwise, or if
+     * that call fails for any reason, each object in the subtree is
+     * introspected in turn as with IntrospectRemoteObject().
+     *
+     * @param timeout   Timeout specified in milliseconds to wait for each reply
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - An error status otherwise
+     */
+    QStatus IntrospectRemoteObjectTree(uint32_t timeout = DefaultCallTimeout);
+
     /**
      * Get a property from an interface on the remote object.
      *
@@ -673,6 +691,28 @@ class ProxyBusObject : public MessageReceiver {
                        uint8_t flags = 0,
                        Message* callMsg = NULL) const;
 
+    /**
+     * Make a synchronous method call from this object with arguments serialized
+     * by a body writer such as TypedArgs instead of being passed as MsgArgs.
+     *
+     * @param method       Method being invoked.
+     * @param body         Writer for the method arguments. Its signature must match the method's signature.
+     * @param replyMsg     The reply message received for the method call
+     * @param timeout      Timeout specified in milliseconds to wait for a reply
+     * @param flags        Logical OR of the message flags for this method call, see MethodCall() above.
+     * @param callMsg      Pointer to a Message object to receive a copy of the sent call message (can be NULL if not needed)
+     *
+     * @return
+     *      - #ER_OK if the method call succeeded and the reply message type is #MESSAGE_METHOD_RET
+     *      - #ER_BUS_REPLY_IS_ERROR_MESSAGE if the reply message type is #MESSAGE_ERROR
+     */
+    QStatus MethodCall(const InterfaceDescription::Member& method,
+                       const MsgBodyWriter& body,
+                       Message& replyMsg,
+                       uint32_t timeout = DefaultCallTimeout,
+                       uint8_t flags = 0,
+                       Message* callMsg = NULL) const;
+
     /**
      * Make a synchronous method call from this object
      *
@@ -961,6 +1001,20 @@ class ProxyBusObject : public MessageReceiver {
      */
     void SyncReplyHandler(Message& msg, void* context);
 
+    /**
+     * @internal
+     * Make a synchronous method call with either MsgArg arguments or a body writer.
+     * @see MethodCall
+     */
+    QStatus MethodCallInternal(const InterfaceDescription::Member& method,
+                               const MsgArg* args,
+                               size_t numArgs,
+                               const MsgBodyWriter* body,
+                               Message& replyMsg,
+                               uint32_t timeout,
+                               uint8_t flags,
+                               Message* callMsg) const;
+
     /**
      * @internal
      * Introspection method_reply handler. (Internal use only)
@@ -0,0 +1,698 @@
+#ifndef _ALLJOYN_TYPEDARGS_H
+#define _ALLJOYN_TYPEDARGS_H
+/**
+ * @file
+ * This file defines a typed API for marshaling message bodies with a fixed signature
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include TypedArgs.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+#include <qcc/String.h>
+#include <qcc/Util.h>
+
+#include <string.h>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArg.h>
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+/**
+ * A string in a message body. When returned by TypedArgs::Get() it points into
+ * the message buffer and is only valid while the message is.
+ */
+struct StringView {
+    const char* str;  /**< The NUL terminated string */
+    size_t len;       /**< Length of the string not including the NUL */
+
+    /** Construct an empty string */
+    StringView() : str(""), len(0) { }
+
+    /** Construct a view of a NUL terminated string */
+    StringView(const char* str) : str(str), len(strlen(str)) { }
+
+    /** Construct a view of a NUL terminated string of known length */
+    StringView(const char* str, size_t len) : str(str), len(len) { }
+};
+
+/**
+ * A byte array in a message body. When returned by TypedArgs::Get() it points
+ * into the message buffer and is only valid while the message is.
+ */
+struct ByteArrayView {
+    const uint8_t* data;  /**< The bytes */
+    size_t len;           /**< Number of bytes */
+
+    /** Construct an empty array */
+    ByteArrayView() : data(NULL), len(0) { }
+
+    /** Construct a view of a byte array */
+    ByteArrayView(const uint8_t* data, size_t len) : data(data), len(len) { }
+};
+
+/**
+ * Marshals a C++ type as an AllJoyn type. There is a specialization for every
+ * supported C++ type, each of which provides:
+ *
+ *  - Alignment: the wire alignment of the type
+ *  - AppendSignature(): appends the type's signature
+ *  - Size(): the offset following a value marshaled at a given offset
+ *  - Marshal(): writes a value at an offset, adding padding
+ *  - Unmarshal(): reads a value at an offset, checking it against the buffer length
+ *
+ * Offsets are relative to the start of the message body which is always 8 byte aligned.
+ */
+template <typename T>
+struct TypedArg;
+
+/**
+ * @cond ALLJOYN_DEV
+ * @internal
+ * Helpers shared by the TypedArg specializations.
+ */
+namespace typedargs {
+
+/** Maximum length of a signature not including the NUL */
+static const size_t MAX_SIGNATURE_LEN = 255;
+
+inline size_t Align(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+inline size_t Pad(uint8_t* buf, size_t offset, size_t alignment)
+{
+    size_t aligned = Align(offset, alignment);
+    while (offset < aligned) {
+        buf[offset++] = 0;
+    }
+    return offset;
+}
+
+inline bool AppendSignature(char* sig, size_t& len, AllJoynTypeId typeId)
+{
+    if (len >= MAX_SIGNATURE_LEN) {
+        return false;
+    }
+    sig[len++] = static_cast<char>(typeId);
+    return true;
+}
+
+inline void Swap(uint8_t* val, size_t size)
+{
+    switch (size) {
+    case 2:
+        {
+            uint16_t v;
+            memcpy(&v, val, 2);
+            v = EndianSwap16(v);
+            memcpy(val, &v, 2);
+        }
+        break;
+
+    case 4:
+        {
+            uint32_t v;
+            memcpy(&v, val, 4);
+            v = EndianSwap32(v);
+            memcpy(val, &v, 4);
+        }
+        break;
+
+    case 8:
+        {
+            uint64_t v;
+            memcpy(&v, val, 8);
+            v = EndianSwap64(v);
+            memcpy(val, &v, 8);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * Marshaling for fixed size numeric types
+ */
+template <typename T, AllJoynTypeId TypeId>
+struct Scalar {
+    static const size_t Alignment = sizeof(T);
+
+    static bool AppendSignature(char* sig, size_t& len)
+    {
+        return typedargs::AppendSignature(sig, len, TypeId);
+    }
+
+    static size_t Size(size_t offset, const T& val)
+    {
+        QCC_UNUSED(val);
+        return Align(offset, sizeof(T)) + sizeof(T);
+    }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const T& val, bool endianSwap)
+    {
+        offset = Pad(buf, offset, sizeof(T));
+        memcpy(buf + offset, &val, sizeof(T));
+        if (endianSwap) {
+            Swap(buf + offset, sizeof(T));
+        }
+        offset += sizeof(T);
+        return ER_OK;
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, T& val)
+    {
+        size_t pos = Align(offset, sizeof(T));
+        if ((pos > len) || ((len - pos) < sizeof(T))) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        memcpy(&val, buf + pos, sizeof(T));
+        if (endianSwap) {
+            Swap(reinterpret_cast<uint8_t*>(&val), sizeof(T));
+        }
+        offset = pos + sizeof(T);
+        return ER_OK;
+    }
+};
+
+/**
+ * Marshaling for strings
+ */
+struct String {
+    static const size_t Alignment = 4;
+
+    static bool AppendSignature(char* sig, size_t& len)
+    {
+        return typedargs::AppendSignature(sig, len, ALLJOYN_STRING);
+    }
+
+    static size_t Size(size_t offset, size_t strLen)
+    {
+        return Align(offset, 4) + 4 + strLen + 1;
+    }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const char* str, size_t strLen, bool endianSwap)
+    {
+        uint32_t len32 = static_cast<uint32_t>(strLen);
+        Scalar<uint32_t, ALLJOYN_UINT32>::Marshal(buf, offset, len32, endianSwap);
+        memcpy(buf + offset, str, strLen);
+        offset += strLen;
+        buf[offset++] = 0;
+        return ER_OK;
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, const char*& str, size_t& strLen)
+    {
+        uint32_t len32;
+        QStatus status = Scalar<uint32_t, ALLJOYN_UINT32>::Unmarshal(buf, offset, len, endianSwap, len32);
+        if (status != ER_OK) {
+            return status;
+        }
+        if (len32 >= (len - offset)) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        if (buf[offset + len32] != 0) {
+            return ER_BUS_NOT_NUL_TERMINATED;
+        }
+        str = reinterpret_cast<const char*>(buf + offset);
+        strLen = len32;
+        offset += len32 + 1;
+        return ER_OK;
+    }
+};
+
+/**
+ * Marshaling for arrays of bytes
+ */
+struct Bytes {
+    static const size_t Alignment = 4;
+
+    static bool AppendSignature(char* sig, size_t& len)
+    {
+        return typedargs::AppendSignature(sig, len, ALLJOYN_ARRAY) && typedargs::AppendSignature(sig, len, ALLJOYN_BYTE);
+    }
+
+    static size_t Size(size_t offset, size_t numBytes)
+    {
+        return Align(offset, 4) + 4 + numBytes;
+    }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const uint8_t* data, size_t numBytes, bool endianSwap)
+    {
+        if (numBytes > ALLJOYN_MAX_ARRAY_LEN) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        uint32_t len32 = static_cast<uint32_t>(numBytes);
+        Scalar<uint32_t, ALLJOYN_UINT32>::Marshal(buf, offset, len32, endianSwap);
+        if (numBytes) {
+            memcpy(buf + offset, data, numBytes);
+        }
+        offset += numBytes;
+        return ER_OK;
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, const uint8_t*& data, size_t& numBytes)
+    {
+        uint32_t len32;
+        QStatus status = Scalar<uint32_t, ALLJOYN_UINT32>::Unmarshal(buf, offset, len, endianSwap, len32);
+        if (status != ER_OK) {
+            return status;
+        }
+        if ((len32 > ALLJOYN_MAX_ARRAY_LEN) || (len32 > (len - offset))) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        data = buf + offset;
+        numBytes = len32;
+        offset += len32;
+        return ER_OK;
+    }
+};
+
+/**
+ * Computes the signature of a list of types
+ */
+template <typename... Ts>
+struct Signature;
+
+template <>
+struct Signature<> {
+    static bool Append(char* sig, size_t& len)
+    {
+        QCC_UNUSED(sig);
+        QCC_UNUSED(len);
+        return true;
+    }
+};
+
+template <typename T, typename... Ts>
+struct Signature<T, Ts...> {
+    static bool Append(char* sig, size_t& len)
+    {
+        return TypedArg<T>::AppendSignature(sig, len) && Signature<Ts...>::Append(sig, len);
+    }
+};
+
+/**
+ * Build the NUL terminated signature of a list of types.
+ *
+ * @return  false if the signature is too long.
+ */
+template <typename... Ts>
+bool MakeSignature(char (&sig)[MAX_SIGNATURE_LEN + 1])
+{
+    size_t len = 0;
+    bool ok = Signature<Ts...>::Append(sig, len);
+    sig[ok ? len : 0] = 0;
+    return ok;
+}
+
+}
+/// @endcond
+
+template <> struct TypedArg<uint8_t> : public typedargs::Scalar<uint8_t, ALLJOYN_BYTE> { };
+template <> struct TypedArg<int16_t> : public typedargs::Scalar<int16_t, ALLJOYN_INT16> { };
+template <> struct TypedArg<uint16_t> : public typedargs::Scalar<uint16_t, ALLJOYN_UINT16> { };
+template <> struct TypedArg<int32_t> : public typedargs::Scalar<int32_t, ALLJOYN_INT32> { };
+template <> struct TypedArg<uint32_t> : public typedargs::Scalar<uint32_t, ALLJOYN_UINT32> { };
+template <> struct TypedArg<int64_t> : public typedargs::Scalar<int64_t, ALLJOYN_INT64> { };
+template <> struct TypedArg<uint64_t> : public typedargs::Scalar<uint64_t, ALLJOYN_UINT64> { };
+template <> struct TypedArg<double> : public typedargs::Scalar<double, ALLJOYN_DOUBLE> { };
+
+/**
+ * Booleans are marshaled as 32 bit values that must be 0 or 1
+ */
+template <>
+struct TypedArg<bool> {
+    static const size_t Alignment = 4;
+
+    static bool AppendSignature(char* sig, size_t& len)
+    {
+        return typedargs::AppendSignature(sig, len, ALLJOYN_BOOLEAN);
+    }
+
+    static size_t Size(size_t offset, bool val)
+    {
+        QCC_UNUSED(val);
+        return typedargs::Align(offset, 4) + 4;
+    }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, bool val, bool endianSwap)
+    {
+        uint32_t v = val ? 1 : 0;
+        return TypedArg<uint32_t>::Marshal(buf, offset, v, endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, bool& val)
+    {
+        uint32_t v;
+        QStatus status = TypedArg<uint32_t>::Unmarshal(buf, offset, len, endianSwap, v);
+        if (status == ER_OK) {
+            if (v > 1) {
+                status = ER_BUS_BAD_VALUE;
+            } else {
+                val = (v == 1);
+            }
+        }
+        return status;
+    }
+};
+
+template <>
+struct TypedArg<StringView> : public typedargs::String {
+    static size_t Size(size_t offset, const StringView& val) { return String::Size(offset, val.len); }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const StringView& val, bool endianSwap)
+    {
+        return String::Marshal(buf, offset, val.str, val.len, endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, StringView& val)
+    {
+        return String::Unmarshal(buf, offset, len, endianSwap, val.str, val.len);
+    }
+};
+
+template <>
+struct TypedArg<qcc::String> : public typedargs::String {
+    static size_t Size(size_t offset, const qcc::String& val) { return String::Size(offset, val.size()); }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const qcc::String& val, bool endianSwap)
+    {
+        return String::Marshal(buf, offset, val.data(), val.size(), endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, qcc::String& val)
+    {
+        StringView view;
+        QStatus status = String::Unmarshal(buf, offset, len, endianSwap, view.str, view.len);
+        if (status == ER_OK) {
+            val.assign(view.str, view.len);
+        }
+        return status;
+    }
+};
+
+template <>
+struct TypedArg<std::string> : public typedargs::String {
+    static size_t Size(size_t offset, const std::string& val) { return String::Size(offset, val.size()); }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const std::string& val, bool endianSwap)
+    {
+        return String::Marshal(buf, offset, val.data(), val.size(), endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, std::string& val)
+    {
+        StringView view;
+        QStatus status = String::Unmarshal(buf, offset, len, endianSwap, view.str, view.len);
+        if (status == ER_OK) {
+            val.assign(view.str, view.len);
+        }
+        return status;
+    }
+};
+
+template <>
+struct TypedArg<ByteArrayView> : public typedargs::Bytes {
+    static size_t Size(size_t offset, const ByteArrayView& val) { return Bytes::Size(offset, val.len); }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const ByteArrayView& val, bool endianSwap)
+    {
+        return Bytes::Marshal(buf, offset, val.data, val.len, endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, ByteArrayView& val)
+    {
+        return Bytes::Unmarshal(buf, offset, len, endianSwap, val.data, val.len);
+    }
+};
+
+/**
+ * Byte arrays are copied in one go rather than element by element
+ */
+template <>
+struct TypedArg<std::vector<uint8_t> > : public typedargs::Bytes {
+    static size_t Size(size_t offset, const std::vector<uint8_t>& val) { return Bytes::Size(offset, val.size()); }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const std::vector<uint8_t>& val, bool endianSwap)
+    {
+        return Bytes::Marshal(buf, offset, val.empty() ? NULL : &val[0], val.size(), endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, std::vector<uint8_t>& val)
+    {
+        ByteArrayView view;
+        QStatus status = Bytes::Unmarshal(buf, offset, len, endianSwap, view.data, view.len);
+        if (status == ER_OK) {
+            val.assign(view.data, view.data + view.len);
+        }
+        return status;
+    }
+};
+
+/**
+ * Arrays of any other supported type
+ */
+template <typename T>
+struct TypedArg<std::vector<T> > {
+    static const size_t Alignment = 4;
+
+    static bool AppendSignature(char* sig, size_t& len)
+    {
+        return typedargs::AppendSignature(sig, len, ALLJOYN_ARRAY) && TypedArg<T>::AppendSignature(sig, len);
+    }
+
+    static size_t Size(size_t offset, const std::vector<T>& val)
+    {
+        offset = typedargs::Align(typedargs::Align(offset, 4) + 4, TypedArg<T>::Alignment);
+        for (typename std::vector<T>::const_iterator it = val.begin(); it != val.end(); ++it) {
+            offset = TypedArg<T>::Size(offset, *it);
+        }
+        return offset;
+    }
+
+    static QStatus Marshal(uint8_t* buf, size_t& offset, const std::vector<T>& val, bool endianSwap)
+    {
+        size_t lenPos = typedargs::Pad(buf, offset, 4);
+        /* The length does not include the padding before the first element */
+        offset = typedargs::Pad(buf, lenPos + 4, TypedArg<T>::Alignment);
+        size_t start = offset;
+        for (typename std::vector<T>::const_iterator it = val.begin(); it != val.end(); ++it) {
+            QStatus status = TypedArg<T>::Marshal(buf, offset, *it, endianSwap);
+            if (status != ER_OK) {
+                return status;
+            }
+        }
+        if ((offset - start) > ALLJOYN_MAX_ARRAY_LEN) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        uint32_t len32 = static_cast<uint32_t>(offset - start);
+        return TypedArg<uint32_t>::Marshal(buf, lenPos, len32, endianSwap);
+    }
+
+    static QStatus Unmarshal(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, std::vector<T>& val)
+    {
+        uint32_t len32;
+        QStatus status = TypedArg<uint32_t>::Unmarshal(buf, offset, len, endianSwap, len32);
+        if (status != ER_OK) {
+            return status;
+        }
+        offset = typedargs::Align(offset, TypedArg<T>::Alignment);
+        if ((len32 > ALLJOYN_MAX_ARRAY_LEN) || (offset > len) || (len32 > (len - offset))) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        size_t end = offset + len32;
+        val.clear();
+        while (offset < end) {
+            T elem;
+            /* Elements must not run past the end of the array */
+            status = TypedArg<T>::Unmarshal(buf, offset, end, endianSwap, elem);
+            if (status != ER_OK) {
+                return status;
+            }
+            val.push_back(elem);
+        }
+        return ER_OK;
+    }
+};
+
+/**
+ * %TypedArgs marshals and unmarshals a message body with a fixed signature
+ * without going through MsgArgs. The signature is derived from the C++ types,
+ * for example TypedArgs<int32_t, std::string, std::vector<uint8_t> > has the
+ * signature "isay".
+ *
+ * Supported types are uint8_t, bool, int16_t, uint16_t, int32_t, uint32_t,
+ * int64_t, uint64_t, double, qcc::String, std::string, StringView,
+ * ByteArrayView and std::vector of any supported type.
+ *
+ * To send, pass a %TypedArgs to ProxyBusObject::MethodCall(),
+ * BusObject::Signal() or BusObject::MethodReply(). The values are serialized
+ * straight into the message buffer. %TypedArgs holds references to the values
+ * so it must not outlive them; it is normally constructed in the call
+ * expression:
+ *
+ * @code
+ * proxy.MethodCall(*member, TypedArgs<int32_t, qcc::String>(42, name), reply);
+ * @endcode
+ *
+ * To receive, call Get() from a method handler added with
+ * BusObject::AddTypedMethodHandler(), which dispatches the method call without
+ * unmarshaling the body, or on any other message.
+ */
+template <typename... Ts>
+class TypedArgs : public MsgBodyWriter {
+  public:
+    /**
+     * Constructor
+     *
+     * @param values  The values to marshal. These are not copied.
+     */
+    TypedArgs(const Ts&... values) : values(values...)
+    {
+        typedargs::MakeSignature<Ts...>(signature);
+    }
+
+    /**
+     * Get the signature derived from the types.
+     *
+     * @return  The signature or an empty string if the signature is too long.
+     */
+    const char* GetSignature() const { return signature; }
+
+    /**
+     * Get the marshaled size of the values.
+     *
+     * @return  The number of bytes Marshal() will write.
+     */
+    size_t GetSize() const { return SizeFrom<0>(0); }
+
+    /**
+     * Serialize the values into a message buffer.
+     *
+     * @param buf          The buffer, at least GetSize() bytes long.
+     * @param endianSwap   True if the values must be written in non-native endianess.
+     *
+     * @return
+     *      - #ER_OK if the values were written
+     *      - #ER_BUS_BAD_LENGTH if an array is too long
+     */
+    QStatus Marshal(uint8_t* buf, bool endianSwap) const
+    {
+        size_t offset = 0;
+        return MarshalFrom<0>(buf, offset, endianSwap);
+    }
+
+    /**
+     * Deserialize the body of a message. Views returned through StringView or
+     * ByteArrayView point into the message buffer.
+     *
+     * @param msg         The message.
+     * @param[out] out    The values.
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the message signature does not match the types
+     *      - An error status otherwise
+     */
+    static QStatus Get(Message& msg, Ts&... out)
+    {
+        char sig[typedargs::MAX_SIGNATURE_LEN + 1];
+        if (!typedargs::MakeSignature<Ts...>(sig)) {
+            return ER_BUS_BAD_SIGNATURE;
+        }
+        const uint8_t* body;
+        size_t bodyLen;
+        bool endianSwap;
+        QStatus status = msg->GetMarshaledBody(sig, body, bodyLen, endianSwap);
+        if (status == ER_OK) {
+            size_t offset = 0;
+            status = UnmarshalAll(body, offset, bodyLen, endianSwap, out ...);
+            if ((status == ER_OK) && (offset != bodyLen)) {
+                status = ER_BUS_BAD_SIGNATURE;
+            }
+        }
+        return status;
+    }
+
+  private:
+
+    template <size_t I>
+    typename std::enable_if < (I < sizeof...(Ts)), size_t >::type SizeFrom(size_t offset) const
+    {
+        typedef typename std::tuple_element<I, std::tuple<Ts...> >::type T;
+        return SizeFrom < I + 1 > (TypedArg<T>::Size(offset, std::get<I>(values)));
+    }
+
+    template <size_t I>
+    typename std::enable_if < (I == sizeof...(Ts)), size_t >::type SizeFrom(size_t offset) const
+    {
+        return offset;
+    }
+
+    template <size_t I>
+    typename std::enable_if < (I < sizeof...(Ts)), QStatus >::type MarshalFrom(uint8_t* buf, size_t& offset, bool endianSwap) const
+    {
+        typedef typename std::tuple_element<I, std::tuple<Ts...> >::type T;
+        QStatus status = TypedArg<T>::Marshal(buf, offset, std::get<I>(values), endianSwap);
+        return (status == ER_OK) ? MarshalFrom < I + 1 > (buf, offset, endianSwap) : status;
+    }
+
+    template <size_t I>
+    typename std::enable_if < (I == sizeof...(Ts)), QStatus >::type MarshalFrom(uint8_t* buf, size_t& offset, bool endianSwap) const
+    {
+        QCC_UNUSED(buf);
+        QCC_UNUSED(offset);
+        QCC_UNUSED(endianSwap);
+        return ER_OK;
+    }
+
+    static QStatus UnmarshalAll(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap)
+    {
+        QCC_UNUSED(buf);
+        QCC_UNUSED(offset);
+        QCC_UNUSED(len);
+        QCC_UNUSED(endianSwap);
+        return ER_OK;
+    }
+
+    template <typename T, typename... Rest>
+    static QStatus UnmarshalAll(const uint8_t* buf, size_t& offset, size_t len, bool endianSwap, T& val, Rest& ... rest)
+    {
+        QStatus status = TypedArg<T>::Unmarshal(buf, offset, len, endianSwap, val);
+        return (status == ER_OK) ? UnmarshalAll(buf, offset, len, endianSwap, rest ...) : status;
+    }
+
+    std::tuple<const Ts& ...> values;                     /**< References to the values to marshal */
+    char signature[typedargs::MAX_SIGNATURE_LEN + 1];     /**< Signature derived from the types */
+};
+
+}
+
+#endif
@@ -60,6 +60,7 @@
 #include "AllJoynPeerObj.h"
 #include "ConfigDB.h"
 #include "NameTable.h"
+#include "MsgArgCursor.h"
 
 #define QCC_MODULE "ALLJOYN_OBJ"
 
@@ -69,7 +70,6 @@ using namespace qcc;
 namespace ajn {
 
 void* AllJoynObj::NameMapEntry::truthiness = reinterpret_cast<void*>(true);
-volatile int32_t AllJoynObj::JoinSessionThread::jstCount = 0;
 struct AllJoynObj::PingAlarmContext {
     enum Type {
         TRANSPORT_CONTEXT,
@@ -82,6 +82,33 @@ struct AllJoynObj::PingAlarmContext {
     PingAlarmContext(Type type, String name, String sender = "") : type(type), name(name), sender(sender) { };
 };
 
+struct AllJoynObj::PingMethodContext {
+    Message msg;
+    String name;
+    PingMethodContext(Message msg, String name) : msg(msg), name(name) { };
+};
+
+struct AllJoynObj::PingRouteContext {
+    Message msg;
+    String b2bName;
+    uint32_t timeout;
+    vector<String> names;
+    PingRouteContext(Message msg, String b2bName, uint32_t timeout) : msg(msg), b2bName(b2bName), timeout(timeout) { };
+};
+
+/*
+ * A caller cannot ping a name that it is already pinging.  Another routing node
+ * pings on behalf of many of its clients so each of its requests counts as a
+ * caller of its own.
+ */
+static String PingCaller(const Message& msg)
+{
+    if (strcmp(msg->GetInterface(), org::alljoyn::Daemon::InterfaceName) == 0) {
+        return String(msg->GetSender()) + "#" + U32ToString(msg->GetCallSerial());
+    }
+    return msg->GetSender();
+}
+
 void AllJoynObj::AcquireLocks()
 {
     /*
@@ -109,6 +136,8 @@ AllJoynObj::AllJoynObj(Bus& bus, BusController* busController, DaemonRouter& rou
     daemonGuid(bus.GetInternal().GetGlobalGUID()),
     detachSessionSignal(NULL),
     timer("NameReaper"),
+    joinDispatcher(NULL),
+    attachDispatcher(NULL),
     isStopping(false),
     busController(busController)
 {
@@ -122,8 +151,11 @@ AllJoynObj::~AllJoynObj()
 
     Stop();
     Join();
+    delete joinDispatcher;
+    delete attachDispatcher;
     outgoingPingMap.clear();
     incomingPingMap.clear();
+    pingBatches.clear();
 }
 
 QStatus AllJoynObj::Init()
@@ -164,18 +196,26 @@ QStatus AllJoynObj::Init()
         { alljoynIntf->GetMember("AliasUnixUser"),            static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::AliasUnixUser) },
         { alljoynIntf->GetMember("OnAppSuspend"),             static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::OnAppSuspend) },
         { alljoynIntf->GetMember("OnAppResume"),              static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::OnAppResume) },
-        { alljoynIntf->GetMember("CancelSessionlessMessage"), static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::CancelSessionlessMessage) },
         { alljoynIntf->GetMember("RemoveSessionMember"),      static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::RemoveSessionMember) },
-        { alljoynIntf->GetMember("GetHostInfo"),              static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::GetHostInfo) },
         { alljoynIntf->GetMember("ReloadConfig"),             static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::ReloadConfig) },
-        { alljoynIntf->GetMember("Ping"),                     static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::Ping) },
         { alljoynIntf->GetMember("FindAdvertisementByTransport"),        static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::FindAdvertisementByTransport) },
         { alljoynIntf->GetMember("CancelFindAdvertisementByTransport"),  static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::CancelFindAdvertisementByTransport) },
-        { alljoynIntf->GetMember("SetIdleTimeouts"),  static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::SetIdleTimeouts) }
+        { alljoynIntf->GetMember("SetIdleTimeouts"),  static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::SetIdleTimeouts) },
+        { alljoynIntf->GetMember("PingMultiple"),     static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::PingMultiple) }
+    };
+
+    /* These handlers read their few arguments straight from the message body */
+    const MethodEntry typedMethodEntries[] = {
+        { alljoynIntf->GetMember("CancelSessionlessMessage"), static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::CancelSessionlessMessage) },
+        { alljoynIntf->GetMember("GetHostInfo"),              static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::GetHostInfo) },
+        { alljoynIntf->GetMember("Ping"),                     static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::Ping) }
     };
 
     AddInterface(*alljoynIntf);
     status = AddMethodHandlers(methodEntries, ArraySize(methodEntries));
+    for (size_t i = 0; (ER_OK == status) && (i < ArraySize(typedMethodEntries)); ++i) {
+        status = AddTypedMethodHandler(typedMethodEntries[i].member, typedMethodEntries[i].handler);
+    }
     if (ER_OK != status) {
         QCC_LogError(status, ("AddMethods for %s failed", org::alljoyn::Bus::InterfaceName));
     }
@@ -202,7 +242,8 @@ QStatus AllJoynObj::Init()
     const MethodEntry daemonMethodEntries[] = {
         { daemonIface->GetMember("AttachSession"),     static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::AttachSession) },
         { daemonIface->GetMember("AttachSessionWithNames"),     static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::AttachSession) },
-        { daemonIface->GetMember("GetSessionInfo"),    static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::GetSessionInfo) }
+        { daemonIface->GetMember("GetSessionInfo"),    static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::GetSessionInfo) },
+        { daemonIface->GetMember("PingMultiple"),      static_cast<MessageReceiver::MethodHandler>(&AllJoynObj::PingMultiple) }
     };
     AddInterface(*daemonIface);
     status = AddMethodHandlers(daemonMethodEntries, ArraySize(daemonMethodEntries));
@@ -258,6 +299,14 @@ QStatus AllJoynObj::Init()
         status = timer.Start();
     }
 
+    /* Start the dispatchers for JoinSession and AttachSession requests */
+    if (ER_OK == status) {
+        ConfigDB* config = ConfigDB::GetConfigDB();
+        uint32_t maxJoins = max(config->GetLimit("max_concurrent_session_joins", ALLJOYN_MAX_CONCURRENT_SESSION_JOINS_DEFAULT), 1U);
+        uint32_t maxAttaches = max(config->GetLimit("max_concurrent_session_attaches", ALLJOYN_MAX_CONCURRENT_SESSION_ATTACHES_DEFAULT), 1U);
+        status = StartSessionSetupDispatchers(maxJoins, maxAttaches);
+    }
+
     if (ER_OK == status) {
         status = bus.RegisterBusObject(*this);
     }
@@ -269,31 +318,55 @@ QStatus AllJoynObj::Init()
 
 QStatus AllJoynObj::Stop()
 {
-    /* Stop any outstanding JoinSessionThreads */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
+    /*
+     * Stop the dispatchers.  This alerts the requests being processed and
+     * drops the queued requests.
+     */
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
     isStopping = true;
-    vector<JoinSessionThread*>::iterator it = joinSessionThreads.begin();
-    while (it != joinSessionThreads.end()) {
-        (*it)->Stop();
-        ++it;
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
+    if (joinDispatcher) {
+        joinDispatcher->Stop();
+    }
+    if (attachDispatcher) {
+        attachDispatcher->Stop();
     }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
 
 QStatus AllJoynObj::Join()
 {
-    /* Wait for any outstanding JoinSessionThreads */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    while (!joinSessionThreads.empty()) {
-        joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
-        qcc::Sleep(50);
-        joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    /* Wait for any outstanding JoinSession and AttachSession requests */
+    if (joinDispatcher) {
+        joinDispatcher->Join();
+    }
+    if (attachDispatcher) {
+        attachDispatcher->Join();
+    }
     return ER_OK;
 }
 
+QStatus AllJoynObj::StartSessionSetupDispatchers(uint32_t maxJoins, uint32_t maxAttaches)
+{
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
+    joinDispatcher = new Timer("JoinSession", true, maxJoins);
+    attachDispatcher = new Timer("AttachSession", true, maxAttaches);
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
+    QStatus status = joinDispatcher->Start();
+    if (ER_OK == status) {
+        status = attachDispatcher->Start();
+    }
+    return status;
+}
+
+void AllJoynObj::GetSessionSetupStats(SessionSetupStats& joins, SessionSetupStats& attaches) const
+{
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
+    joins = joinStats;
+    attaches = attachStats;
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
+}
+
 void AllJoynObj::ObjectRegistered(void)
 {
     QStatus status;
@@ -512,16 +585,47 @@ void AllJoynObj::UnbindSessionPort(const InterfaceDescription::Member* member, M
     }
 }
 
-ThreadReturn STDCALL AllJoynObj::JoinSessionThread::Run(void* arg)
+void AllJoynObj::JoinSessionRequest::AlarmTriggered(const Alarm& alarm, QStatus reason)
 {
-    QCC_UNUSED(arg);
+    QCC_UNUSED(alarm);
+
+    SessionSetupStats& stats = isJoin ? ajObj.joinStats : ajObj.attachStats;
+    ajObj.sessionSetupLock.Lock(MUTEX_CONTEXT);
+    --stats.queued;
+    ajObj.sessionSetupLock.Unlock(MUTEX_CONTEXT);
 
+    /* The dispatcher is exiting so the request is dropped */
+    if (reason != ER_OK) {
+        delete this;
+        return;
+    }
+
+    ajObj.sessionSetupLock.Lock(MUTEX_CONTEXT);
+    ++stats.inFlight;
+    ajObj.sessionSetupLock.Unlock(MUTEX_CONTEXT);
+
+    Run();
+
+    uint64_t latency = GetTimestamp64() - arrivalTime;
+    QCC_DbgPrintf(("JoinSessionRequest::AlarmTriggered(): %s completed in %" PRIu64 " ms", isJoin ? "JoinSession" : "AttachSession", latency));
+    ajObj.sessionSetupLock.Lock(MUTEX_CONTEXT);
+    --stats.inFlight;
+    ++stats.completed;
+    stats.totalLatency += latency;
+    stats.maxLatency = max(stats.maxLatency, latency);
+    ajObj.sessionSetupLock.Unlock(MUTEX_CONTEXT);
+
+    delete this;
+}
+
+void AllJoynObj::JoinSessionRequest::Run()
+{
     if (isJoin) {
-        QCC_DbgTrace(("JoinSessionThread::RunJoin()"));
-        return RunJoin();
+        QCC_DbgTrace(("JoinSessionRequest::RunJoin()"));
+        RunJoin();
     } else {
-        QCC_DbgTrace(("JoinSessionThread::RunAttach()"));
-        return RunAttach();
+        QCC_DbgTrace(("JoinSessionRequest::RunAttach()"));
+        RunAttach();
     }
 }
 
@@ -542,7 +646,7 @@ bool AllJoynObj::IsSelfJoinSupported(BusEndpoint& joinerEp) const {
     return false;
 }
 
-QStatus AllJoynObj::JoinSessionThread::Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut)
+QStatus AllJoynObj::JoinSessionRequest::Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut)
 {
     /* Reply to request */
     MsgArg replyArgs[3];
@@ -550,13 +654,13 @@ QStatus AllJoynObj::JoinSessionThread::Reply(uint32_t replyCode, SessionId id, S
     replyArgs[1].Set("u", id);
     SetSessionOpts(optsOut, replyArgs[2]);
     QStatus status = ajObj.MethodReply(msg, replyArgs, ArraySize(replyArgs));
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): JoinSession returned (%d,%u) (status=%s)", replyCode, id, QCC_StatusText(status)));
+    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): JoinSession returned (%d,%u) (status=%s)", replyCode, id, QCC_StatusText(status)));
     return status;
 }
 
-ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
+void AllJoynObj::JoinSessionRequest::RunJoin()
 {
-    QCC_DbgTrace(("JoinSessionThread::RunJoin()"));
+    QCC_DbgTrace(("JoinSessionRequest::RunJoin()"));
 
     uint32_t replyCode = ALLJOYN_JOINSESSION_REPLY_SUCCESS;
     SessionId id = 0;
@@ -568,7 +672,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     RemoteEndpoint b2bEp;
     BusEndpoint joinerEp = ajObj.FindEndpoint(sender);
 
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): joinerEp=\"%s\"", joinerEp->GetUniqueName().c_str()));
+    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): joinerEp=\"%s\"", joinerEp->GetUniqueName().c_str()));
 
     /* Parse the message args */
     msg->GetArgs(numArgs, args);
@@ -581,14 +685,14 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
     if (status == ER_OK) {
         status = GetSessionOpts(args[2], optsIn);
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): optsIn=\"%s\"", optsIn.ToString().c_str()));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): optsIn=\"%s\"", optsIn.ToString().c_str()));
     }
 
     if (status == ER_OK) {
         BusEndpoint srcEp = ajObj.FindEndpoint(sender);
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): srcEp=\"%s\"", srcEp->GetUniqueName().c_str()));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): srcEp=\"%s\"", srcEp->GetUniqueName().c_str()));
         if (srcEp->IsValid()) {
-            status = TransportPermission::FilterTransports(srcEp, sender, optsIn.transports, "JoinSessionThread.Run");
+            status = TransportPermission::FilterTransports(srcEp, sender, optsIn.transports, "JoinSessionRequest.Run");
         }
     }
 
@@ -599,7 +703,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
         SessionMapType::iterator it = ajObj.SessionMapLowerBound(sender, 0);
         while ((it != ajObj.sessionMap.end()) && (it->first.first == sender) && (it->first.second == 0)) {
             if (ajObj.FindEndpoint(it->second.sessionHost) == hostEp) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): self-join!"));
+                QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): self-join!"));
                 isSelfJoin = true;
                 break;
             }
@@ -615,38 +719,38 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     if (status != ER_OK) {
         if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
             replyCode = ALLJOYN_JOINSESSION_REPLY_FAILED;
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): bad args"));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): bad args"));
         }
     } else if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin() sessionPort=%d, opts=<%u, 0x%x, 0x%x>)",
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin() sessionPort=%d, opts=<%u, 0x%x, 0x%x>)",
                        sessionPort, optsIn.traffic, optsIn.proximity, optsIn.transports));
 
         /* Decide how to proceed based on the session endpoint existence/type */
         VirtualEndpoint vSessionEp;
 
         QCC_ASSERT(sessionHost);
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): sessionHost=\"%s\"", sessionHost));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): sessionHost=\"%s\"", sessionHost));
         BusEndpoint ep = ajObj.FindEndpoint(sessionHost);
         if (ep->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL) {
             vSessionEp = VirtualEndpoint::cast(ep);
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): vSessionEp=\"%s\"", sessionHost));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): vSessionEp=\"%s\"", sessionHost));
         } else if ((ep->GetEndpointType() == ENDPOINT_TYPE_REMOTE) || (ep->GetEndpointType() == ENDPOINT_TYPE_NULL) ||
                    (ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL)) {
             rSessionEp = ep;
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): rSessionEp=\"%s\"", rSessionEp->GetUniqueName().c_str()));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): rSessionEp=\"%s\"", rSessionEp->GetUniqueName().c_str()));
         }
 
         if (rSessionEp->IsValid()) {
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): session is with another locally connected attachment"));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): session is with another locally connected attachment"));
 
             /* Find creator in session map */
             String creatorName = rSessionEp->GetUniqueName();
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): creatorName=\"%s\"", creatorName.c_str()));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): creatorName=\"%s\"", creatorName.c_str()));
             bool foundSessionMapEntry = false;
             SessionMapType::iterator sit = ajObj.SessionMapLowerBound(creatorName, 0);
             while ((sit != ajObj.sessionMap.end()) && (creatorName == sit->first.first)) {
                 if ((sit->second.isActive) && (sit->second.sessionHost == creatorName) && (sit->second.sessionPort == sessionPort)) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): found \"%s\" in sessionMap with expected port %d.",
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): found \"%s\" in sessionMap with expected port %d.",
                                    creatorName.c_str(), sessionPort));
                     if (sit->first.second == 0) {
                         sme = sit->second;
@@ -659,7 +763,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                         vector<String>::iterator mit = sit->second.memberNames.begin();
                         while (mit != sit->second.memberNames.end()) {
                             if (*mit == sender) {
-                                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): joiner already joined"));
+                                QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): joiner already joined"));
                                 foundSessionMapEntry = false;
                                 replyCode = ALLJOYN_JOINSESSION_REPLY_ALREADY_JOINED;
                                 break;
@@ -683,7 +787,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                         newSessionId = qcc::Rand32();
                     }
 
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): newsessinoId=%d.", newSessionId));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): newsessinoId=%d.", newSessionId));
 
                     /* Add an entry to sessionMap here (before sending accept session) since accept session
                      * may trigger a call to GetSessionFd or LeaveSession which must be aware of the new session's
@@ -703,7 +807,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
                     /* Ask creator to accept session */
                     ajObj.ReleaseLocks();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendAcceptSession()"));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): SendAcceptSession()"));
                     status = ajObj.SendAcceptSession(sme.sessionPort, newSessionId, sessionHost, sender.c_str(), optsIn, isAccepted);
                     if (status != ER_OK) {
                         QCC_LogError(status, ("SendAcceptSession failed"));
@@ -724,10 +828,10 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                     if (!isAccepted) {
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Join session request rejected"));
+                        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Join session request rejected"));
                         replyCode = ALLJOYN_JOINSESSION_REPLY_REJECTED;
                     } else if (sme.opts.traffic == SessionOpts::TRAFFIC_MESSAGES) {
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Join session request accepted"));
+                        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Join session request accepted"));
                         /* setup the forward and reverse routes through the local daemon */
                         RemoteEndpoint tEp;
                         status = ajObj.AddSessionRoute(newSessionId, joinerEp, NULL, rSessionEp, tEp);
@@ -736,7 +840,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                             QCC_LogError(status, ("AddSessionRoute(%u, %s, NULL, %s, tEp) failed", newSessionId, sender.c_str(), rSessionEp->GetUniqueName().c_str()));
                         }
                         if (status == ER_OK) {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Add local joiner to member list"));
+                            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Add local joiner to member list"));
                             /* Add (local) joiner to list of session members since no AttachSession will be sent */
                             SessionMapEntry* smEntry = ajObj.SessionMapFind(sme.endpointName, newSessionId);
                             if (smEntry) {
@@ -764,7 +868,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                             sme.id = newSessionId;
                         }
                     } else if ((sme.opts.traffic != SessionOpts::TRAFFIC_MESSAGES) && !sme.opts.isMultipoint) {
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Raw socket"));
+                        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Raw socket"));
                         /* Create a raw socket pair for the two local session participants */
                         SocketFd fds[2];
                         status = SocketPair(fds);
@@ -810,7 +914,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
             }
         } else {
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): session is with a remote attachment"));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): session is with a remote attachment"));
             /* Session is with a connected or unconnected remote device */
 
             /*
@@ -819,7 +923,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
             /* Check for an existing multipoint session. */
             if (vSessionEp->IsValid()) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Existing virtual endpoint IsValid() and isMultipoint"));
+                QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Existing virtual endpoint IsValid() and isMultipoint"));
                 SessionMapType::iterator it = ajObj.sessionMap.begin();
                 while (it != ajObj.sessionMap.end()) {
                     if ((it->second.sessionHost == vSessionEp->GetUniqueName()) && (it->second.sessionPort == sessionPort)) {
@@ -828,13 +932,13 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                                 b2bEp = vSessionEp->GetBusToBusEndpoint(it->second.id);
                                 optsIn.nameTransfer = it->second.opts.nameTransfer;
                                 if (b2bEp->IsValid()) {
-                                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): IncrementRef() on existing mp session"));
+                                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): IncrementRef() on existing mp session"));
                                     b2bEp->IncrementRef();
                                     replyCode = ALLJOYN_JOINSESSION_REPLY_SUCCESS;
                                 }
                             }
                         } else {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Blocked multiple connections to same dest with same session ID"));
+                            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Blocked multiple connections to same dest with same session ID"));
                             /* Cannot support more than one connection to the same destination with the same sessionId */
                             replyCode = ALLJOYN_JOINSESSION_REPLY_BAD_SESSION_OPTS;
                         }
@@ -860,11 +964,11 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                     ajObj.AcquireLocks();
                 }
                 if (busAddrs.empty()) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): No advertisement. No existing route.  Nothing we can do."));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): No advertisement. No existing route.  Nothing we can do."));
                     /* No advertisment or existing route to session creator */
                     replyCode = ALLJOYN_JOINSESSION_REPLY_NO_SESSION;
                 } else {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Have busaddrs to try."));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Have busaddrs to try."));
                 }
             }
             vector<String>::const_iterator bit = busAddrs.begin();
@@ -878,7 +982,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 TransportMask transport = optsIn.transports;
                 if (bit != busAddrs.end()) {
                     ajObj.ReleaseLocks();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Trying busaddr=\"%s\"", bit->c_str()));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Trying busaddr=\"%s\"", bit->c_str()));
                     b2bEp = ConnectBusToBusEndpoint(*bit, optsIn, transport, replyCode);
                     if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                         busAddr = *bit;
@@ -894,7 +998,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                      * Step 2: Wait for the new b2b endpoint to have a virtual ep for nextController
                      * only while interacting with a remote routing node with protocol version < 12.
                      */
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Wait for virtual endpoint."));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Wait for virtual endpoint."));
                     uint64_t startTime = GetTimestamp64();
                     while (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                         /* Do we route through b2bEp? If so, we're done */
@@ -904,12 +1008,12 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                             break;
                         }
 
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Remote name of new b2b endpoint is \"%s\"",
+                        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Remote name of new b2b endpoint is \"%s\"",
                                        b2bEp->GetRemoteName().c_str()));
 
                         VirtualEndpoint vep;
                         if (ajObj.FindEndpoint(b2bEp->GetRemoteName(), vep) && vep->CanUseRoute(b2bEp)) {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Found virtual endpoint for route"));
+                            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Found virtual endpoint for route"));
                             /* Got a virtual endpoint we can route through */
                             break;
                         }
@@ -923,7 +1027,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                         }
                         /* Give up the locks while waiting */
                         ajObj.ReleaseLocks();
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Sleep"));
+                        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Sleep"));
                         qcc::Sleep(10);
                         ajObj.AcquireLocks();
                     }
@@ -937,7 +1041,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 MsgArg membersArg;
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
                     const String nextControllerName = b2bEp->GetRemoteName();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendAttachSession()"));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): SendAttachSession()"));
                     ajObj.ReleaseLocks();
                     SessionOpts opts = optsIn;
                     opts.transports = transport;
@@ -952,7 +1056,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                     }
                     /* Re-acquire locks */
                     ajObj.AcquireLocks();
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): FindEndpoint(\"%s\")", sessionHost));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): FindEndpoint(\"%s\")", sessionHost));
                     ajObj.FindEndpoint(sessionHost, vSessionEp);
                     if (!vSessionEp->IsValid()) {
                         replyCode = ALLJOYN_JOINSESSION_REPLY_FAILED;
@@ -962,10 +1066,10 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
                 /* If session was successful, Add two-way session routes to the table */
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Attach session success(\"%s\")", sessionHost));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Attach session success(\"%s\")", sessionHost));
                     if (joinerEp->IsValid() && b2bEp->IsValid()) {
                         BusEndpoint busEndpoint = BusEndpoint::cast(vSessionEp);
-                        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): AddSessionRoute() for session ID %d.", id));
+                        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): AddSessionRoute() for session ID %d.", id));
                         status = ajObj.AddSessionRoute(id, joinerEp, NULL, busEndpoint, b2bEp);
                         if (status != ER_OK) {
                             replyCode = ALLJOYN_JOINSESSION_REPLY_FAILED;
@@ -980,7 +1084,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 /* Create session map entry */
                 bool sessionMapEntryCreated = false;
                 if (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Add session map entry for sender=\"%s\", id=%d., sessionHost=\"%s\", sessionPort=%d.",
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Add session map entry for sender=\"%s\", id=%d., sessionHost=\"%s\", sessionPort=%d.",
                                    sender.c_str(), id, vSessionEp->GetUniqueName().c_str(), sessionPort));
                     const MsgArg* sessionMembers;
                     size_t numSessionMembers = 0;
@@ -999,7 +1103,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
                 /* If a raw sesssion was requested, then teardown the new b2bEp to use it for a raw stream */
                 if ((replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && (optsOut.traffic != SessionOpts::TRAFFIC_MESSAGES)) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Raw session.  Tear down new endpoint"));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Raw session.  Tear down new endpoint"));
                     SessionMapEntry* smEntry = ajObj.SessionMapFind(sender, id);
                     if (smEntry) {
                         ajObj.ReleaseLocks();
@@ -1039,7 +1143,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     /* Send AttachSession to all other members of the multicast session */
     if ((replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && sme.opts.isMultipoint &&
         sme.sessionHost != sender /* test if we now just selfjoined */) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Multicast session joined."));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Multicast session joined."));
         for (size_t i = 0; i < sme.memberNames.size(); ++i) {
             const String& member = sme.memberNames[i];
             /* Skip this joiner since it is attached already */
@@ -1047,12 +1151,12 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 continue;
             }
 
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Member \"%s\"", sme.memberNames[i].c_str()));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Member \"%s\"", sme.memberNames[i].c_str()));
 
             BusEndpoint memberEp = ajObj.FindEndpoint(member);
             RemoteEndpoint memberB2BEp;
             if (memberEp->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Member \"%s\" is virtual", sme.memberNames[i].c_str()));
+                QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Member \"%s\" is virtual", sme.memberNames[i].c_str()));
                 /* Endpoint is not served directly by this daemon so forward the attach using existing b2bEp connection with session creator */
                 if (!b2bEp->IsValid()) {
                     VirtualEndpoint vMemberEp = VirtualEndpoint::cast(memberEp);
@@ -1084,7 +1188,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                      */
                     sme.opts.transports = TRANSPORT_ANY;
 
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendAttachSession()"));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): SendAttachSession()"));
                     status = ajObj.SendAttachSession(sessionPort,
                                                      sender.c_str(),
                                                      sessionHost,
@@ -1119,7 +1223,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
 
             } else if (memberEp->IsValid()) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Local (non-virtual) endpoint"));
+                QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Local (non-virtual) endpoint"));
                 /* Add joiner to any local member's sessionMap entry  since no AttachSession is sent */
                 SessionMapEntry* smEntry = ajObj.SessionMapFind(member, id);
                 if (smEntry) {
@@ -1127,7 +1231,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
                 }
                 /* Multipoint session member is local to this daemon. Send MPSessionChanged */
                 if (optsOut.isMultipoint) {
-                    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Local (non-virtual) MPSessionChanged"));
+                    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Local (non-virtual) MPSessionChanged"));
                     ajObj.ReleaseLocks();
                     ajObj.SendMPSessionChanged(id, sender.c_str(), true, member.c_str(), ALLJOYN_MPSESSIONCHANGED_REMOTE_MEMBER_ADDED);
                     ajObj.AcquireLocks();
@@ -1135,7 +1239,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
             }
             /* Add session routing */
             if (memberEp->IsValid() && joinerEp->IsValid() && (status == ER_OK)) {
-                QCC_DbgPrintf(("JoinSessionThread::RunJoin(): AddSessionRoute()"));
+                QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): AddSessionRoute()"));
                 status = ajObj.AddSessionRoute(id, joinerEp, NULL, memberEp, memberB2BEp);
                 if (status != ER_OK) {
                     QCC_LogError(status, ("AddSessionRoute(%u, %s, NULL, %s, %s) failed", id, sender.c_str(), memberEp->GetUniqueName().c_str(), memberB2BEp->GetUniqueName().c_str()));
@@ -1149,7 +1253,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
     }
     ajObj.ReleaseLocks();
 
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Reply to request"));
+    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Reply to request"));
 
     /* Reply to request */
     status = Reply(replyCode, id, optsOut);
@@ -1161,7 +1265,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
     /* Send SessionJoined to creator if creator is local since RunAttach does not run in this case */
     if ((status == ER_OK) && (replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && rSessionEp->IsValid()) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendSessionJoined() to local endpoint"));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): SendSessionJoined() to local endpoint"));
         ajObj.SendSessionJoined(sme.sessionPort, sme.id, sender.c_str(), sme.endpointName.c_str());
         /* If session is multipoint, send MPSessionChanged to sessionHost */
         if (sme.opts.isMultipoint) {
@@ -1171,7 +1275,7 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
 
     /* Send a series of MPSessionChanged to "catch up" the new joiner */
     if ((replyCode == ALLJOYN_JOINSESSION_REPLY_SUCCESS) && optsOut.isMultipoint) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): SendMPSessionChanged() series to local endpoint"));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): SendMPSessionChanged() series to local endpoint"));
         ajObj.AcquireLocks();
         SessionMapEntry* smEntry = ajObj.SessionMapFind(sender, id);
         if (smEntry) {
@@ -1194,20 +1298,18 @@ ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunJoin()
             ajObj.ReleaseLocks();
         }
     }
-
-    return 0;
 }
 
-void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* sessionHost, const SessionOpts& optsIn,
+void AllJoynObj::JoinSessionRequest::GetBusAddrsFromAdvertisements(const char* sessionHost, const SessionOpts& optsIn,
                                                                   std::vector<qcc::String>& busAddrs)
 {
     /* Look for busAddr from advertisements first */
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Look for busaddr corresponding to sessionHost"));
+    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Look for busaddr corresponding to sessionHost"));
     set<JoinSessionEntry> advertisements;
     multimap<String, NameMapEntry>::iterator nmit = ajObj.nameMap.lower_bound(sessionHost);
     while (nmit != ajObj.nameMap.end() && (nmit->first == sessionHost)) {
         if (nmit->second.transport & optsIn.transports) {
-            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Found busaddr in name map: \"%s\"", nmit->second.busAddr.c_str()));
+            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Found busaddr in name map: \"%s\"", nmit->second.busAddr.c_str()));
             JoinSessionEntry joinSessionEntry(nmit->first, nmit->second.transport, nmit->second.busAddr);
             advertisements.insert(joinSessionEntry);
         }
@@ -1221,7 +1323,7 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* se
 
     /* If no busAddrs, see if any exist in the adv alias map */
     if (busAddrs.empty() && (sessionHost[0] == ':')) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): look for busaddr in adv alias map"));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): look for busaddr in adv alias map"));
         String rguidStr = String(sessionHost).substr(1, GUID128::SIZE_SHORT);
         map<String, set<AdvAliasEntry> >::iterator ait = ajObj.advAliasMap.find(rguidStr);
         if (ait != ajObj.advAliasMap.end()) {
@@ -1231,7 +1333,7 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* se
                     multimap<String, NameMapEntry>::iterator nmit2 = ajObj.nameMap.lower_bound((*bit).name);
                     while (nmit2 != ajObj.nameMap.end() && (nmit2->first == (*bit).name)) {
                         if ((nmit2->second.transport & (*bit).transport & optsIn.transports) != 0) {
-                            QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Found busaddr in adv alias map: \"%s\"",
+                            QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Found busaddr in adv alias map: \"%s\"",
                                            nmit2->second.busAddr.c_str()));
                             busAddrs.push_back(nmit2->second.busAddr);
                         }
@@ -1244,10 +1346,10 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromAdvertisements(const char* se
     }
 }
 
-void AllJoynObj::JoinSessionThread::GetBusAddrsFromSession(const char* sessionHost, SessionPort sessionPort, const SessionOpts& optsIn,
+void AllJoynObj::JoinSessionRequest::GetBusAddrsFromSession(const char* sessionHost, SessionPort sessionPort, const SessionOpts& optsIn,
                                                            std::vector<qcc::String>& busAddrs)
 {
-    QCC_DbgPrintf(("JoinSessionThread::RunJoin(): no busaddr.  SendGetSessionInfo() directly."));
+    QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): no busaddr.  SendGetSessionInfo() directly."));
     QStatus status = ER_BUS_NO_ENDPOINT;
 
     BusEndpoint hostEp = ajObj.FindEndpoint(sessionHost);
@@ -1291,7 +1393,7 @@ void AllJoynObj::JoinSessionThread::GetBusAddrsFromSession(const char* sessionHo
     }
 }
 
-RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc::String& busAddr, const SessionOpts& optsIn,
+RemoteEndpoint AllJoynObj::JoinSessionRequest::ConnectBusToBusEndpoint(const qcc::String& busAddr, const SessionOpts& optsIn,
                                                                       TransportMask& transport, uint32_t& replyCode)
 {
     RemoteEndpoint b2bEp;
@@ -1300,7 +1402,7 @@ RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc:
     /* Ask the transport that provided the advertisement for an endpoint */
     Transport* trans = ajObj.GetTransport(busAddr);
     if (trans != NULL) {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): Connect(\"%s\")", busAddr.c_str()));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): Connect(\"%s\")", busAddr.c_str()));
 
         BusEndpoint newEp;
         QStatus status = trans->Connect(busAddr.c_str(), optsIn, newEp);
@@ -1315,68 +1417,47 @@ RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc:
             QCC_LogError(status, ("trans->Connect(%s) failed", busAddr.c_str()));
         }
     } else {
-        QCC_DbgPrintf(("JoinSessionThread::RunJoin(): No available transport for %s", busAddr.c_str()));
+        QCC_DbgPrintf(("JoinSessionRequest::RunJoin(): No available transport for %s", busAddr.c_str()));
     }
 
     return b2bEp;
 }
 
-void AllJoynObj::JoinSessionThread::ThreadExit(Thread* thread)
+void AllJoynObj::DispatchSessionSetup(JoinSessionRequest* request)
 {
-    ajObj.joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    vector<JoinSessionThread*>::iterator it = ajObj.joinSessionThreads.begin();
-    JoinSessionThread* deleteMe = NULL;
-    while (it != ajObj.joinSessionThreads.end()) {
-        if (*it == thread) {
-            deleteMe = *it;
-            ajObj.joinSessionThreads.erase(it);
-            break;
-        }
-        ++it;
+    sessionSetupLock.Lock(MUTEX_CONTEXT);
+    Timer* dispatcher = request->IsJoin() ? joinDispatcher : attachDispatcher;
+    if (isStopping || !dispatcher) {
+        sessionSetupLock.Unlock(MUTEX_CONTEXT);
+        delete request;
+        return;
     }
-    ajObj.joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
-    if (deleteMe) {
-        deleteMe->Join();
-        delete deleteMe;
-    } else {
-        QCC_LogError(ER_FAIL, ("Internal error: JoinSessionThread not found on list"));
+    SessionSetupStats& stats = request->IsJoin() ? joinStats : attachStats;
+    ++stats.queued;
+    sessionSetupLock.Unlock(MUTEX_CONTEXT);
+
+    QStatus status = dispatcher->AddAlarm(Alarm(request));
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Failed to dispatch %s request", request->IsJoin() ? "JoinSession" : "AttachSession"));
+        sessionSetupLock.Lock(MUTEX_CONTEXT);
+        --stats.queued;
+        sessionSetupLock.Unlock(MUTEX_CONTEXT);
+        delete request;
     }
 }
 
 void AllJoynObj::JoinSession(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
-    /* Handle JoinSession on another thread since JoinThread can block waiting for NameOwnerChanged */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    if (!isStopping) {
-        JoinSessionThread* jst = new JoinSessionThread(*this, msg, true);
-        QStatus status = jst->Start(NULL, jst);
-        if (status == ER_OK) {
-            joinSessionThreads.push_back(jst);
-        } else {
-            QCC_LogError(status, ("Join: Failed to start JoinSessionThread"));
-            delete jst;
-        }
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    /* Handle JoinSession on a dispatcher thread since JoinSession can block waiting for NameOwnerChanged */
+    DispatchSessionSetup(new JoinSessionRequest(*this, msg, true));
 }
 
 void AllJoynObj::AttachSession(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
-    /* Handle AttachSession on another thread since AttachSession can block when connecting through an intermediate node */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    if (!isStopping) {
-        JoinSessionThread* jst = new JoinSessionThread(*this, msg, false);
-        QStatus status = jst->Start(NULL, jst);
-        if (status == ER_OK) {
-            joinSessionThreads.push_back(jst);
-        } else {
-            QCC_LogError(status, ("Attach: Failed to start JoinSessionThread"));
-            delete jst;
-        }
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    /* Handle AttachSession on a dispatcher thread since AttachSession can block when connecting through an intermediate node */
+    DispatchSessionSetup(new JoinSessionRequest(*this, msg, false));
 }
 
 void AllJoynObj::LeaveHostedSession(const InterfaceDescription::Member* member, Message& msg)
@@ -1621,13 +1702,10 @@ void AllJoynObj::GetHostInfo(const InterfaceDescription::Member* member, Message
 
     uint32_t replyCode = ALLJOYN_GETHOSTINFO_REPLY_SUCCESS;
 
-    size_t numArgs;
-    const MsgArg* args;
-
     /* Parse the message args */
-    msg->GetArgs(numArgs, args);
-    QCC_ASSERT(numArgs == 1);
-    SessionId id = static_cast<SessionId>(args[0].v_uint32);
+    MsgArgCursor cursor(msg);
+    MsgArg idArg;
+    SessionId id = (cursor.Get(idArg) == ER_OK) ? static_cast<SessionId>(idArg.v_uint32) : 0;
 
     QCC_DbgPrintf(("AllJoynObj::GetHostInfo(%u)", id));
 
@@ -1834,9 +1912,9 @@ bool AllJoynObj::NamesHandler(Message msg, MsgArg arg)
     return madeChanges;
 }
 
-qcc::ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunAttach()
+void AllJoynObj::JoinSessionRequest::RunAttach()
 {
-    QCC_DbgTrace(("JoinSessionThread::RunAttach()"));
+    QCC_DbgTrace(("JoinSessionRequest::RunAttach()"));
 
     SessionId id = 0;
     String creatorName;
@@ -1871,7 +1949,7 @@ qcc::ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunAttach()
     QStatus status = MsgArg::Get(args, 6, "qsssss", &sessionPort, &src, &sessionHost, &dest, &srcB2B, &busAddr);
     const String srcB2BStr = srcB2B;
 
-    QCC_DbgPrintf(("JoinSessionThread::RunAttach(): sessionPort=%d, src=\"%s\", sessionHost=\"%s\", dest=\"%s\", srcB2B=\"%s\", busAddr=\"%s\"",
+    QCC_DbgPrintf(("JoinSessionRequest::RunAttach(): sessionPort=%d, src=\"%s\", sessionHost=\"%s\", dest=\"%s\", srcB2B=\"%s\", busAddr=\"%s\"",
                    sessionPort, src, sessionHost, dest, srcB2B, busAddr));
 
     bool sendSessionJoined = false;
@@ -2324,8 +2402,6 @@ qcc::ThreadReturn STDCALL AllJoynObj::JoinSessionThread::RunAttach()
     }
 
     QCC_DbgPrintf(("AllJoynObj::RunAttach(%d) returned (%d,%u) (status=%s)", sessionPort, replyCode, id, QCC_StatusText(status)));
-
-    return 0;
 }
 
 void AllJoynObj::AddAdvNameAlias(const String& guid, const TransportMask mask, const String& advName)
@@ -3992,6 +4068,7 @@ void AllJoynObj::RemoveBusToBusEndpoint(RemoteEndpoint& endpoint)
      * virtual endpoint while this function is in progress.
      */
     b2bEndpoints.erase(endpoint->GetUniqueName());
+    noPingMultipleRoutes.erase(endpoint->GetUniqueName());
 
     /* Remove any virtual endpoints associated with a removed bus-to-bus endpoint */
     map<qcc::String, VirtualEndpoint>::iterator it = virtualEndpoints.begin();
@@ -5341,7 +5418,7 @@ void AllJoynObj::AlarmTriggered(const Alarm& alarm, QStatus reason)
                 OutgoingPingInfo opi = it->second;
                 outgoingPingMap.erase(it);
                 ReleaseLocks();
-                PingReplyMethodHandlerUsingCode(opi.message, ALLJOYN_PING_REPLY_TIMEOUT);
+                PingReplyMethodHandlerUsingCode(opi.message, ctx->name, ALLJOYN_PING_REPLY_TIMEOUT);
             } else {
 
                 ReleaseLocks();
@@ -5534,16 +5611,23 @@ void AllJoynObj::Ping(const InterfaceDescription::Member* member, Message& msg)
 
     uint32_t replyCode = ALLJOYN_PING_REPLY_SUCCESS;
     TransportMask transports = TRANSPORT_ANY;
-    size_t numArgs;
-    const MsgArg* args;
     String sender = msg->GetSender();
     BusEndpoint senderEp = FindEndpoint(sender);
 
     /* Parse the message args */
-    msg->GetArgs(numArgs, args);
+    MsgArgCursor cursor(msg);
+    MsgArg nameArg;
+    MsgArg timeoutArg;
     const char* name = NULL;
-    uint32_t timeout;
-    QStatus status = MsgArg::Get(args, numArgs, "su", &name, &timeout);
+    uint32_t timeout = 0;
+    QStatus status = cursor.Get(nameArg);
+    if (status == ER_OK) {
+        status = cursor.Get(timeoutArg);
+    }
+    if (status == ER_OK) {
+        name = nameArg.v_string.str;
+        timeout = timeoutArg.v_uint32;
+    }
 
     if (status == ER_OK && senderEp->IsValid()) {
         status = TransportPermission::FilterTransports(senderEp, sender, transports, "AllJoynObj::Ping");
@@ -5555,164 +5639,376 @@ void AllJoynObj::Ping(const InterfaceDescription::Member* member, Message& msg)
     } else {
         QCC_ASSERT(name);
         QCC_DbgTrace(("Ping(%s)", name));
+        replyCode = StartPing(msg, name, timeout);
+    }
 
-        /* Decide how to proceed based on the endpoint existence/type */
-        BusEndpoint ep = FindEndpoint(name);
-        if ((ep->GetEndpointType() == ENDPOINT_TYPE_REMOTE) || (ep->GetEndpointType() == ENDPOINT_TYPE_NULL) || (ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL) || (ep->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL)) {
-            AcquireLocks();
-            if (dbusPingsInProgress.find(pair<String, String>(msg->GetSender(), name)) != dbusPingsInProgress.end()) {
-                replyCode = ALLJOYN_PING_REPLY_IN_PROGRESS;
-                ReleaseLocks();
-            } else {
+    /* Reply to request if something went wrong.  The success case is handled asynchronously. */
+    if (replyCode != ALLJOYN_PING_REPLY_SUCCESS) {
+        MsgArg replyArg("u", replyCode);
+        status = MethodReply(msg, &replyArg, 1);
+        QCC_DbgPrintf(("AllJoynObj::Ping(%s) returned %d (status=%s)", name, replyCode, QCC_StatusText(status)));
 
-                dbusPingsInProgress.insert(pair<String, String>(msg->GetSender(), name));
+        /* Log error if reply could not be sent */
+        if (ER_OK != status) {
+            QCC_LogError(status, ("Failed to respond to org.alljoyn.Bus.Ping"));
+        }
+    }
+
+    return;
+}
+
+void AllJoynObj::PingMultiple(const InterfaceDescription::Member* member, Message& msg)
+{
+    QCC_UNUSED(member);
+
+    QCC_DbgTrace(("AllJoynObj::PingMultiple()"));
+
+    TransportMask transports = TRANSPORT_ANY;
+    String sender = msg->GetSender();
+    BusEndpoint senderEp = FindEndpoint(sender);
+
+    size_t numNames = 0;
+    const MsgArg* names = NULL;
+    uint32_t timeout = 0;
+    QStatus status = msg->GetArgs("asu", &numNames, &names, &timeout);
+    if ((status == ER_OK) && (numNames > MAX_PING_NAMES)) {
+        QCC_LogError(ER_BUS_BAD_VALUE, ("PingMultiple of %u names exceeds the limit of %u", numNames, MAX_PING_NAMES));
+        status = MethodReply(msg, ER_BUS_BAD_VALUE);
+        if (ER_OK != status) {
+            QCC_LogError(status, ("Failed to respond to PingMultiple"));
+        }
+        return;
+    }
+    if (status == ER_OK && senderEp->IsValid()) {
+        status = TransportPermission::FilterTransports(senderEp, sender, transports, "AllJoynObj::PingMultiple");
+    }
+
+    /*
+     * Every distinct name is pinged once no matter how often it appears in the
+     * request.  The batch is registered before any ping is started since the
+     * pings may complete on other threads before we get to the end of the loop.
+     */
+    PingBatch batch;
+    if (status == ER_OK) {
+        for (size_t i = 0; i < numNames; ++i) {
+            batch.names.push_back(names[i].v_string.str);
+            batch.pending.insert(names[i].v_string.str);
+        }
+    }
+    std::set<String> unique = batch.pending;
+    if (!unique.empty()) {
+        AcquireLocks();
+        pingBatches[pair<String, uint32_t>(sender, msg->GetCallSerial())] = batch;
+        ReleaseLocks();
+    }
+
+    /* Names behind the same remote routing node are sent on to it in one request */
+    PingRouteMap routes;
+    vector<String> single;
+    GroupPingsByRoute(unique, routes, single);
+    for (PingRouteMap::iterator it = routes.begin(); it != routes.end(); ++it) {
+        StartRoutePing(msg, it->second, timeout);
+    }
+    for (vector<String>::iterator it = single.begin(); it != single.end(); ++it) {
+        QCC_DbgTrace(("PingMultiple(%s)", it->c_str()));
+        uint32_t replyCode = StartPing(msg, it->c_str(), timeout);
+        if (replyCode != ALLJOYN_PING_REPLY_SUCCESS) {
+            PingReplyMethodHandlerUsingCode(msg, *it, replyCode);
+        }
+    }
+
+    if (unique.empty()) {
+        /* Nothing to wait for, report a failure for each name in case the arguments were bad */
+        std::vector<uint32_t> replyCodes(numNames, ALLJOYN_PING_REPLY_FAILED);
+        MsgArg replyArg("au", replyCodes.size(), replyCodes.empty() ? NULL : &replyCodes[0]);
+        status = MethodReply(msg, &replyArg, 1);
+        if (ER_OK != status) {
+            QCC_LogError(status, ("Failed to respond to org.alljoyn.Bus.PingMultiple"));
+        }
+    }
+}
+
+uint32_t AllJoynObj::StartPing(Message& msg, const char* name, uint32_t timeout)
+{
+    uint32_t replyCode = ALLJOYN_PING_REPLY_SUCCESS;
+    QStatus status;
+    String caller = PingCaller(msg);
+
+    /* Decide how to proceed based on the endpoint existence/type */
+    BusEndpoint ep = FindEndpoint(name);
+    if ((ep->GetEndpointType() == ENDPOINT_TYPE_REMOTE) || (ep->GetEndpointType() == ENDPOINT_TYPE_NULL) || (ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL) || (ep->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL)) {
+        AcquireLocks();
+        if (dbusPingsInProgress.find(pair<String, String>(caller, name)) != dbusPingsInProgress.end()) {
+            replyCode = ALLJOYN_PING_REPLY_IN_PROGRESS;
+            ReleaseLocks();
+        } else {
+
+            dbusPingsInProgress.insert(pair<String, String>(caller, name));
+            ReleaseLocks();
+            /* Ping is to a locally connected or remote in session attachment */
+            ProxyBusObject peerObj(bus, name, "/", 0);
+            const InterfaceDescription* intf = bus.GetInterface(org::freedesktop::DBus::Peer::InterfaceName);
+            QCC_ASSERT(intf);
+            peerObj.AddInterface(*intf);
+            PingMethodContext* ctx = new PingMethodContext(msg, name);
+            status = peerObj.MethodCallAsync(org::freedesktop::DBus::Peer::InterfaceName,
+                                             "Ping",
+                                             this, static_cast<MessageReceiver::ReplyHandler>(&AllJoynObj::PingReplyMethodHandler),
+                                             NULL, 0,
+                                             ctx);
+            if (status != ER_OK) {
+                QCC_LogError(status, ("Send Ping failed"));
+                delete ctx;
+                replyCode = ALLJOYN_PING_REPLY_UNREACHABLE;
+                AcquireLocks();
+                dbusPingsInProgress.erase(pair<String, String>(caller, name));
                 ReleaseLocks();
-                /* Ping is to a locally connected or remote in session attachment */
-                ProxyBusObject peerObj(bus, name, "/", 0);
-                const InterfaceDescription* intf = bus.GetInterface(org::freedesktop::DBus::Peer::InterfaceName);
-                QCC_ASSERT(intf);
-                peerObj.AddInterface(*intf);
-                Message* ctx = new Message(msg);
-                status = peerObj.MethodCallAsync(org::freedesktop::DBus::Peer::InterfaceName,
-                                                 "Ping",
-                                                 this, static_cast<MessageReceiver::ReplyHandler>(&AllJoynObj::PingReplyMethodHandler),
-                                                 NULL, 0,
-                                                 ctx);
-                if (status != ER_OK) {
-                    QCC_LogError(status, ("Send Ping failed"));
-                    delete ctx;
-                    replyCode = ALLJOYN_PING_REPLY_UNREACHABLE;
-                    AcquireLocks();
-                    dbusPingsInProgress.erase(pair<String, String>(msg->GetSender(), name));
-                    ReleaseLocks();
-                }
             }
-        } else {
-            /*
-             * First order of business is to locate a guid corresponding to the name.
-             * The logic below follows the same logic as joining a session.
-             */
+        }
+    } else {
+        /*
+         * First order of business is to locate a guid corresponding to the name.
+         * The logic below follows the same logic as joining a session.
+         */
 
-            // Check if the name is advertised
-            TransportMask transport = TRANSPORT_TCP | TRANSPORT_UDP | TRANSPORT_LOCAL;                         // TODO transport hard-coded
-            String guid;
-            AcquireLocks();
-            for (multimap<String, NameMapEntry>::iterator nmit = nameMap.lower_bound(name);
-                 nmit != nameMap.end() && (nmit->first == name); ++nmit) {
-                if (nmit->second.transport & transport) {
-                    guid = qcc::GUID128(nmit->second.guid).ToShortString();
-                    break;
-                }
+        // Check if the name is advertised
+        TransportMask transport = TRANSPORT_TCP | TRANSPORT_UDP | TRANSPORT_LOCAL;                         // TODO transport hard-coded
+        String guid;
+        AcquireLocks();
+        for (multimap<String, NameMapEntry>::iterator nmit = nameMap.lower_bound(name);
+             nmit != nameMap.end() && (nmit->first == name); ++nmit) {
+            if (nmit->second.transport & transport) {
+                guid = qcc::GUID128(nmit->second.guid).ToShortString();
+                break;
             }
+        }
 
-            if (!ep->IsValid()) {
+        if (!ep->IsValid()) {
 
-                if (name[0] != ':') {
-                    // Well known name
-                    if (guid.empty()) {
-                        // No guid found for well known name
+            if (name[0] != ':') {
+                // Well known name
+                if (guid.empty()) {
+                    // No guid found for well known name
+                    replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
+                } else if (guid == bus.GetInternal().GetGlobalGUID().ToShortString()) {
+                    // Locally advertised not requested
+                    replyCode = ALLJOYN_PING_REPLY_UNREACHABLE;
+                }
+            } else {
+                // Unique name
+                String nameStr(name);
+                String guidStr = nameStr.substr(1, GUID128::SIZE_SHORT);
+                if (guidStr == bus.GetInternal().GetGlobalGUID().ToShortString()) {
+                    // Guid matches our guid but endpoint is invalid.
+                    // Check NameTable to find out if this is a name that has been assigned.
+                    if (!router.IsValidLocalUniqueName(nameStr)) {
                         replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
-                    } else if (guid == bus.GetInternal().GetGlobalGUID().ToShortString()) {
-                        // Locally advertised not requested
+                    } else {
                         replyCode = ALLJOYN_PING_REPLY_UNREACHABLE;
                     }
+                } else if (IsGuidShortStringAdvertising(guidStr)) {
+                    guid = guidStr;
                 } else {
-                    // Unique name
-                    String nameStr(name);
-                    String guidStr = nameStr.substr(1, GUID128::SIZE_SHORT);
-                    if (guidStr == bus.GetInternal().GetGlobalGUID().ToShortString()) {
-                        // Guid matches our guid but endpoint is invalid.
-                        // Check NameTable to find out if this is a name that has been assigned.
-                        if (!router.IsValidLocalUniqueName(nameStr)) {
-                            replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
-                        } else {
-                            replyCode = ALLJOYN_PING_REPLY_UNREACHABLE;
-                        }
-                    } else if (IsGuidShortStringAdvertising(guidStr)) {
-                        guid = guidStr;
-                    } else {
-                        replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
-                    }
+                    replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
                 }
             }
+        }
 
-            if (!guid.empty() && replyCode == ALLJOYN_PING_REPLY_SUCCESS) {
-                QCC_DbgPrintf(("Pinging GUID %s", guid.c_str()));
-                if (outgoingPingMap.find(pair<String, String>(name, msg->GetSender())) != outgoingPingMap.end()) {
-                    replyCode = ALLJOYN_PING_REPLY_IN_PROGRESS;
-                    ReleaseLocks();
-                } else {
-                    PingAlarmContext* ctx = new PingAlarmContext(PingAlarmContext::REPLY_CONTEXT, name, msg->GetSender());
-                    AllJoynObj* pObj = this;
-
-                    Alarm alarm(timeout, pObj, ctx);
-                    OutgoingPingInfo ogi(alarm, msg);
-                    pair<String, String> key(name, msg->GetSender());
-                    outgoingPingMap.insert(pair<pair<String, String>, OutgoingPingInfo>(key, ogi));
-                    timer.AddAlarm(alarm);
-                    ReleaseLocks();
-                    status = IpNameService::Instance().Ping(transport, guid, name);
-                    if (status != ER_OK) {
-                        QCC_DbgPrintf(("Query failed status %s", QCC_StatusText(status)));
-                        AcquireLocks();
-                        multimap<pair<String, String>, OutgoingPingInfo>::iterator it = outgoingPingMap.find(key);
-                        if (it != outgoingPingMap.end()) {
-                            replyCode = (status == ER_ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE) ? ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE : ALLJOYN_PING_REPLY_FAILED;
-                            outgoingPingMap.erase(it);
-                        }
-                        if (timer.RemoveAlarm(alarm, false)) {
-                            //Delete ctx if alarm was successfully removed.
-                            delete ctx;
-                        }
-                        ReleaseLocks();
+        if (!guid.empty() && replyCode == ALLJOYN_PING_REPLY_SUCCESS) {
+            QCC_DbgPrintf(("Pinging GUID %s", guid.c_str()));
+            if (outgoingPingMap.find(pair<String, String>(name, caller)) != outgoingPingMap.end()) {
+                replyCode = ALLJOYN_PING_REPLY_IN_PROGRESS;
+                ReleaseLocks();
+            } else {
+                PingAlarmContext* ctx = new PingAlarmContext(PingAlarmContext::REPLY_CONTEXT, name, caller);
+                AllJoynObj* pObj = this;
+
+                Alarm alarm(timeout, pObj, ctx);
+                OutgoingPingInfo ogi(alarm, msg);
+                pair<String, String> key(name, caller);
+                outgoingPingMap.insert(pair<pair<String, String>, OutgoingPingInfo>(key, ogi));
+                timer.AddAlarm(alarm);
+                ReleaseLocks();
+                status = IpNameService::Instance().Ping(transport, guid, name);
+                if (status != ER_OK) {
+                    QCC_DbgPrintf(("Query failed status %s", QCC_StatusText(status)));
+                    AcquireLocks();
+                    multimap<pair<String, String>, OutgoingPingInfo>::iterator it = outgoingPingMap.find(key);
+                    if (it != outgoingPingMap.end()) {
+                        replyCode = (status == ER_ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE) ? ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE : ALLJOYN_PING_REPLY_FAILED;
+                        outgoingPingMap.erase(it);
                     }
+                    if (timer.RemoveAlarm(alarm, false)) {
+                        //Delete ctx if alarm was successfully removed.
+                        delete ctx;
+                    }
+                    ReleaseLocks();
                 }
-            } else {
-                if (replyCode != ALLJOYN_PING_REPLY_UNREACHABLE) {
-                    replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
+            }
+        } else {
+            if (replyCode != ALLJOYN_PING_REPLY_UNREACHABLE) {
+                replyCode = ALLJOYN_PING_REPLY_UNKNOWN_NAME;
 
-                }
-                ReleaseLocks();
             }
+            ReleaseLocks();
         }
     }
 
-    /* Reply to request if something went wrong.  The success case is handled asynchronously. */
-    if (replyCode != ALLJOYN_PING_REPLY_SUCCESS) {
-        MsgArg replyArg("u", replyCode);
-        status = MethodReply(msg, &replyArg, 1);
-        QCC_DbgPrintf(("AllJoynObj::Ping(%s) returned %d (status=%s)", name, replyCode, QCC_StatusText(status)));
+    return replyCode;
+}
 
-        /* Log error if reply could not be sent */
-        if (ER_OK != status) {
-            QCC_LogError(status, ("Failed to respond to org.alljoyn.Bus.Ping"));
+void AllJoynObj::PingReplyMethodHandler(Message& reply, void* context)
+{
+    QCC_DbgTrace(("AllJoynObj::PingReplyMethodHandler()"));
+    PingMethodContext* ctx = static_cast<PingMethodContext*>(context);
+    uint32_t replyCode = (ajn::MESSAGE_ERROR == reply->GetType()) ? ALLJOYN_PING_REPLY_UNREACHABLE : ALLJOYN_PING_REPLY_SUCCESS;
+
+    AcquireLocks();
+    dbusPingsInProgress.erase(pair<String, String>(PingCaller(ctx->msg), ctx->name));
+    ReleaseLocks();
+
+    PingReplyMethodHandlerUsingCode(ctx->msg, ctx->name, replyCode);
+    delete ctx;
+}
+
+void AllJoynObj::GroupPingsByRoute(const std::set<String>& names, PingRouteMap& routes, vector<String>& single)
+{
+    for (std::set<String>::const_iterator it = names.begin(); it != names.end(); ++it) {
+        BusEndpoint ep = FindEndpoint(*it);
+        RemoteEndpoint b2bEp;
+        if (ep->GetEndpointType() == ENDPOINT_TYPE_VIRTUAL) {
+            b2bEp = VirtualEndpoint::cast(ep)->GetBusToBusEndpoint();
+        }
+        bool batch = b2bEp->IsValid();
+        if (batch) {
+            AcquireLocks();
+            batch = (noPingMultipleRoutes.find(b2bEp->GetUniqueName()) == noPingMultipleRoutes.end());
+            ReleaseLocks();
+        }
+        if (batch) {
+            PingRoute& route = routes[b2bEp->GetUniqueName()];
+            route.b2bEp = b2bEp;
+            route.names.push_back(*it);
+        } else {
+            /* Older routing nodes only know how to forward a Peer.Ping for each name */
+            single.push_back(*it);
         }
     }
 
-    return;
+    PingRouteMap::iterator it = routes.begin();
+    while (it != routes.end()) {
+        if (it->second.names.size() == 1) {
+            single.push_back(it->second.names[0]);
+            routes.erase(it++);
+        } else {
+            ++it;
+        }
+    }
 }
 
-void AllJoynObj::PingReplyMethodHandler(Message& reply, void* context)
+void AllJoynObj::StartRoutePing(Message& msg, const PingRoute& route, uint32_t timeout)
 {
-    QCC_DbgTrace(("AllJoynObj::PingReplyMethodHandler()"));
-    Message* msg = static_cast<Message*>(context);
-    uint32_t replyCode = (ajn::MESSAGE_ERROR == reply->GetType()) ? ALLJOYN_PING_REPLY_UNREACHABLE : ALLJOYN_PING_REPLY_SUCCESS;
+    String caller = PingCaller(msg);
+    PingRouteContext* ctx = new PingRouteContext(msg, route.b2bEp->GetUniqueName(), timeout);
+    vector<String> inProgress;
+    AcquireLocks();
+    for (vector<String>::const_iterator it = route.names.begin(); it != route.names.end(); ++it) {
+        if (dbusPingsInProgress.insert(pair<String, String>(caller, *it)).second) {
+            ctx->names.push_back(*it);
+        } else {
+            inProgress.push_back(*it);
+        }
+    }
+    ReleaseLocks();
+    for (vector<String>::iterator it = inProgress.begin(); it != inProgress.end(); ++it) {
+        PingReplyMethodHandlerUsingCode(msg, *it, ALLJOYN_PING_REPLY_IN_PROGRESS);
+    }
+    if (ctx->names.empty()) {
+        delete ctx;
+        return;
+    }
 
-    /* Parse the message args */
-    size_t numArgs;
-    const MsgArg* args;
+    vector<const char*> names;
+    for (vector<String>::iterator it = ctx->names.begin(); it != ctx->names.end(); ++it) {
+        names.push_back(it->c_str());
+    }
+    MsgArg args[2];
+    args[0].Set("as", names.size(), &names[0]);
+    args[1].Set("u", timeout);
 
-    (*msg)->GetArgs(numArgs, args);
-    const char* name = NULL;
-    uint32_t timeout;
-    MsgArg::Get(args, numArgs, "su", &name, &timeout);
+    QCC_DbgPrintf(("Sending PingMultiple of %u names to %s", names.size(), route.b2bEp->GetRemoteName().c_str()));
+    RemoteEndpoint b2bEp = route.b2bEp;
+    ProxyBusObject controllerObj(bus, route.b2bEp->GetRemoteName().c_str(), org::alljoyn::Daemon::ObjectPath, 0);
+    controllerObj.AddInterface(*daemonIface);
+    controllerObj.SetB2BEndpoint(b2bEp);
+    QStatus status = controllerObj.MethodCallAsync(org::alljoyn::Daemon::InterfaceName,
+                                                   "PingMultiple",
+                                                   this, static_cast<MessageReceiver::ReplyHandler>(&AllJoynObj::PingRouteReplyHandler),
+                                                   args, ArraySize(args),
+                                                   ctx, timeout);
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Send PingMultiple failed"));
+        AcquireLocks();
+        for (vector<String>::iterator it = ctx->names.begin(); it != ctx->names.end(); ++it) {
+            dbusPingsInProgress.erase(pair<String, String>(caller, *it));
+        }
+        ReleaseLocks();
+        for (vector<String>::iterator it = ctx->names.begin(); it != ctx->names.end(); ++it) {
+            PingReplyMethodHandlerUsingCode(msg, *it, ALLJOYN_PING_REPLY_UNREACHABLE);
+        }
+        delete ctx;
+    }
+}
+
+void AllJoynObj::PingRouteReplyHandler(Message& reply, void* context)
+{
+    QCC_DbgTrace(("AllJoynObj::PingRouteReplyHandler()"));
+    PingRouteContext* ctx = static_cast<PingRouteContext*>(context);
+    String caller = PingCaller(ctx->msg);
+
+    if ((reply->GetType() == MESSAGE_ERROR) && (strcmp(reply->GetErrorName(), "org.alljoyn.Bus.Timeout") != 0)) {
+        /*
+         * The remote routing node does not know PingMultiple. Remember that for
+         * as long as the bus-to-bus endpoint is up and ping the names one at a time.
+         */
+        QCC_DbgPrintf(("PingMultiple to %s failed (error=%s), pinging one name at a time", ctx->b2bName.c_str(), reply->GetErrorDescription().c_str()));
+        AcquireLocks();
+        if (b2bEndpoints.find(ctx->b2bName) != b2bEndpoints.end()) {
+            noPingMultipleRoutes.insert(ctx->b2bName);
+        }
+        for (vector<String>::iterator it = ctx->names.begin(); it != ctx->names.end(); ++it) {
+            dbusPingsInProgress.erase(pair<String, String>(caller, *it));
+        }
+        ReleaseLocks();
+        for (vector<String>::iterator it = ctx->names.begin(); it != ctx->names.end(); ++it) {
+            uint32_t replyCode = StartPing(ctx->msg, it->c_str(), ctx->timeout);
+            if (replyCode != ALLJOYN_PING_REPLY_SUCCESS) {
+                PingReplyMethodHandlerUsingCode(ctx->msg, *it, replyCode);
+            }
+        }
+        delete ctx;
+        return;
+    }
+
+    /* The remote routing node answers with one reply code per name in the order they were sent */
+    size_t numReplyCodes = 0;
+    uint32_t* replyCodes = NULL;
+    if ((reply->GetType() != MESSAGE_METHOD_RET) ||
+        (reply->GetArgs("au", &numReplyCodes, &replyCodes) != ER_OK) ||
+        (numReplyCodes != ctx->names.size())) {
+        numReplyCodes = 0;
+    }
 
     AcquireLocks();
-    dbusPingsInProgress.erase(pair<String, String>((*msg)->GetSender(), name));
+    for (vector<String>::iterator it = ctx->names.begin(); it != ctx->names.end(); ++it) {
+        dbusPingsInProgress.erase(pair<String, String>(caller, *it));
+    }
     ReleaseLocks();
 
-    PingReplyMethodHandlerUsingCode(*msg, replyCode);
-    delete msg;
+    for (size_t i = 0; i < ctx->names.size(); ++i) {
+        PingReplyMethodHandlerUsingCode(ctx->msg, ctx->names[i], numReplyCodes ? replyCodes[i] : ALLJOYN_PING_REPLY_UNREACHABLE);
+    }
+    delete ctx;
 }
 
 /* From IpNameServiceListener */
@@ -5766,20 +6062,47 @@ bool AllJoynObj::ResponseHandler(TransportMask transport, MDNSPacket response, u
 
     ReleaseLocks();
     for (list<Message>::iterator replyMsgsIt = replyMsgs.begin(); replyMsgsIt != replyMsgs.end(); replyMsgsIt++) {
-        PingReplyMethodHandlerUsingCode(*replyMsgsIt, replyCode);
+        PingReplyMethodHandlerUsingCode(*replyMsgsIt, name, replyCode);
     }
     return false;
 }
 
-void AllJoynObj::PingReplyMethodHandlerUsingCode(Message& msg, uint32_t replyCode)
+void AllJoynObj::PingReplyMethodHandlerUsingCode(Message& msg, const qcc::String& name, uint32_t replyCode)
 {
     QCC_DbgTrace(("AllJoynObj::PingReplyMethodHandlerUsingCode()"));
-    const char* name = NULL;
-    msg->GetArgs("s", &name);
-    QCC_DbgPrintf(("AllJoynObj::Ping(%s) returned %d", name, replyCode));
+    QCC_DbgPrintf(("AllJoynObj::Ping(%s) returned %d", msg->Description().c_str(), replyCode));
 
-    MsgArg replyArg("u", replyCode);
-    MethodReply(msg, &replyArg, 1);
+    if (strcmp(msg->GetMemberName(), "PingMultiple") != 0) {
+        MsgArg replyArg("u", replyCode);
+        MethodReply(msg, &replyArg, 1);
+        return;
+    }
+
+    /* Record the reply code and answer the PingMultiple request once all of its names are done */
+    std::vector<uint32_t> replyCodes;
+    AcquireLocks();
+    std::map<pair<String, uint32_t>, PingBatch>::iterator it = pingBatches.find(pair<String, uint32_t>(msg->GetSender(), msg->GetCallSerial()));
+    if ((it == pingBatches.end()) || (it->second.pending.erase(name) == 0)) {
+        ReleaseLocks();
+        return;
+    }
+    PingBatch& batch = it->second;
+    batch.replyCodes[name] = replyCode;
+    if (batch.pending.empty()) {
+        for (std::vector<String>::iterator nit = batch.names.begin(); nit != batch.names.end(); ++nit) {
+            replyCodes.push_back(batch.replyCodes[*nit]);
+        }
+        pingBatches.erase(it);
+    }
+    ReleaseLocks();
+
+    if (!replyCodes.empty()) {
+        MsgArg replyArg("au", replyCodes.size(), &replyCodes[0]);
+        QStatus status = MethodReply(msg, &replyArg, 1);
+        if (ER_OK != status) {
+            QCC_LogError(status, ("Failed to respond to org.alljoyn.Bus.PingMultiple"));
+        }
+    }
 }
 
 
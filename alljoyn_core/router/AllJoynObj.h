@@ -61,6 +61,8 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
     public IpNameServiceListener {
     friend class _RemoteEndpoint;
     struct PingAlarmContext;
+    struct PingMethodContext;
+    struct PingRouteContext;
     struct SessionMapEntry;
     class OutgoingPingInfo {
       public:
@@ -523,6 +525,15 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     void Ping(const InterfaceDescription::Member* member, Message& msg);
 
+    /**
+     * Method handler for org.alljoyn.Bus.PingMultiple
+     *
+     * @param member    Interface member.
+     * @param msg       The incoming method call message.
+     *
+     */
+    void PingMultiple(const InterfaceDescription::Member* member, Message& msg);
+
     /**
      * Add a new Bus-to-bus endpoint.
      *
@@ -643,31 +654,75 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     DaemonRouter& GetDaemonRouter() { return router; }
 
+    /**
+     * Counters describing the JoinSession or AttachSession requests handled by this object.
+     */
+    struct SessionSetupStats {
+        uint32_t queued;         /**< Requests waiting for a dispatcher thread */
+        uint32_t inFlight;       /**< Requests being processed */
+        uint32_t completed;      /**< Requests processed since Init() */
+        uint64_t totalLatency;   /**< Sum of the times in ms from arrival to completion of the completed requests */
+        uint64_t maxLatency;     /**< Longest time in ms from arrival to completion of a completed request */
+
+        SessionSetupStats() : queued(0), inFlight(0), completed(0), totalLatency(0), maxLatency(0) { }
+    };
+
+    /**
+     * Get the current JoinSession and AttachSession counters.
+     *
+     * @param[out] joins     Counters for JoinSession requests from local clients.
+     * @param[out] attaches  Counters for AttachSession requests from other routing nodes.
+     */
+    void GetSessionSetupStats(SessionSetupStats& joins, SessionSetupStats& attaches) const;
+
+    /**
+     * Default value of the configuration item "max_concurrent_session_joins", the number of
+     * JoinSession requests processed at the same time.  Further requests wait their turn.
+     */
+    static const uint32_t ALLJOYN_MAX_CONCURRENT_SESSION_JOINS_DEFAULT = 16;
+
+    /**
+     * Default value of the configuration item "max_concurrent_session_attaches", the number of
+     * AttachSession requests processed at the same time.  AttachSession requests have their own
+     * limit since the JoinSession requests of one routing node wait for the AttachSession requests
+     * they send to another.
+     */
+    static const uint32_t ALLJOYN_MAX_CONCURRENT_SESSION_ATTACHES_DEFAULT = 16;
+
   protected:
     /*
      * These methods and members are protected rather than private to facilitate unit testing.
      */
     /// @cond ALLJOYN_DEV
 
-    /** JoinSessionThread handles a JoinSession request from a local client on a separate thread */
-    class JoinSessionThread : public qcc::Thread, public qcc::ThreadListener {
+    /**
+     * JoinSessionRequest handles a JoinSession request from a local client or an AttachSession
+     * request from another routing node.  Requests are queued on a dispatcher that processes a
+     * limited number of them at the same time since processing blocks on B2B connections and
+     * method calls to other routing nodes.
+     */
+    class JoinSessionRequest : public qcc::AlarmListener {
       public:
-        JoinSessionThread(AllJoynObj& ajObj, const Message& msg, bool isJoin) :
-            qcc::Thread(qcc::String("JoinS-") + qcc::U32ToString(qcc::IncrementAndFetch(&jstCount))),
+        JoinSessionRequest(AllJoynObj& ajObj, const Message& msg, bool isJoin) :
             ajObj(ajObj),
             msg(msg),
-            isJoin(isJoin) { }
+            isJoin(isJoin),
+            arrivalTime(qcc::GetTimestamp64()) { }
+
+        virtual ~JoinSessionRequest() { }
+
+        bool IsJoin() const { return isJoin; }
 
-        qcc::ThreadReturn STDCALL RunJoin();
+        void RunJoin();
         virtual QStatus Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut);
-        void ThreadExit(Thread* thread);
 
-      protected:
-        qcc::ThreadReturn STDCALL Run(void* arg);
+        /**
+         * Called on a dispatcher thread to process the request.  The request deletes itself.
+         */
+        void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
 
       private:
-        static volatile int32_t jstCount;
-        qcc::ThreadReturn STDCALL RunAttach();
+        void RunAttach();
         /*
          * This must be called with the locks as it looks through the various advertisement maps.
          */
@@ -684,8 +739,32 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
         AllJoynObj& ajObj;
         Message msg;
         bool isJoin;
+        uint64_t arrivalTime;
+
+      protected:
+        /**
+         * Process the request with RunJoin() or RunAttach().
+         */
+        virtual void Run();
     };
 
+    /**
+     * Create and start the dispatchers for JoinSession and AttachSession requests.
+     *
+     * @param maxJoins     The number of JoinSession requests processed at the same time.
+     * @param maxAttaches  The number of AttachSession requests processed at the same time.
+     *
+     * @return  ER_OK if both dispatchers were started.
+     */
+    QStatus StartSessionSetupDispatchers(uint32_t maxJoins, uint32_t maxAttaches);
+
+    /**
+     * Queue a JoinSession or AttachSession request on its dispatcher.
+     *
+     * @param request  The request.  This object takes ownership of it.
+     */
+    void DispatchSessionSetup(JoinSessionRequest* request);
+
     typedef enum {
         JOINER, /* AttachSession from new session joiner to Host */
         HOST,   /* AttachSession response from session host to new joiner */
@@ -793,6 +872,55 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
     virtual QStatus AddSessionRoute(SessionId id, BusEndpoint& srcEp, RemoteEndpoint* srcB2bEp, BusEndpoint& destEp,
                                     RemoteEndpoint& destB2bEp);
 
+    /**
+     * The names of a PingMultiple request that are reached through the same
+     * bus-to-bus endpoint.
+     */
+    struct PingRoute {
+        RemoteEndpoint b2bEp;               /**< The bus-to-bus endpoint to the remote routing node */
+        std::vector<qcc::String> names;     /**< The names behind the remote routing node */
+    };
+    typedef std::map<qcc::String, PingRoute> PingRouteMap; /**< Keyed by the unique name of the bus-to-bus endpoint */
+
+    /** Largest number of names a PingMultiple request may carry */
+    static const size_t MAX_PING_NAMES = 1024;
+
+    /**
+     * Unique names of the bus-to-bus endpoints whose remote routing node
+     * answered org.alljoyn.Daemon.PingMultiple with an error.  Their names are
+     * pinged one at a time until the endpoint goes away.
+     */
+    std::set<qcc::String> noPingMultipleRoutes;
+
+    /**
+     * Split the names of a PingMultiple request into the ones that are pinged
+     * with one org.alljoyn.Daemon.PingMultiple request per remote routing node
+     * and the ones that are pinged one at a time.  Routing nodes that are known
+     * not to support org.alljoyn.Daemon.PingMultiple and routes with a single
+     * name are pinged one name at a time.
+     *
+     * @param names    The distinct names of the request.
+     * @param routes   [OUT] The names to ping in batches.
+     * @param single   [OUT] The names to ping one at a time.
+     */
+    void GroupPingsByRoute(const std::set<qcc::String>& names, PingRouteMap& routes, std::vector<qcc::String>& single);
+
+    /**
+     * Ping the names of a route with one org.alljoyn.Daemon.PingMultiple request
+     * to the remote routing node.  PingReplyMethodHandlerUsingCode() is called for
+     * each name once the request completes or fails.
+     *
+     * @param msg      The PingMultiple method call.
+     * @param route    The names and the bus-to-bus endpoint to reach them.
+     * @param timeout  Timeout in milliseconds.
+     */
+    void StartRoutePing(Message& msg, const PingRoute& route, uint32_t timeout);
+
+    /**
+     * Called with the reply code of each name of a PingMultiple request.
+     */
+    void PingReplyMethodHandlerUsingCode(Message& msg, const qcc::String& name, uint32_t replyCode);
+
     /// @endcond
 
   private:
@@ -988,9 +1116,12 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
 
-    std::vector<JoinSessionThread*> joinSessionThreads;  /**< List of outstanding join session requests */
-    qcc::Mutex joinSessionThreadsLock;                   /**< Lock that protects joinSessionThreads */
-    bool isStopping;                                     /**< True while waiting for threads to exit */
+    qcc::Timer* joinDispatcher;                          /**< Processes JoinSession requests */
+    qcc::Timer* attachDispatcher;                        /**< Processes AttachSession requests */
+    SessionSetupStats joinStats;                         /**< Counters for JoinSession requests */
+    SessionSetupStats attachStats;                       /**< Counters for AttachSession requests */
+    mutable qcc::Mutex sessionSetupLock;                 /**< Lock that protects the dispatchers and counters */
+    bool isStopping;                                     /**< True while waiting for the dispatchers to exit */
     BusController* busController;                        /**< BusController that created this BusObject */
 
     /**
@@ -1236,9 +1367,22 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
     bool IsGuidShortStringAdvertising(qcc::String& guid);
 
 
+    /**
+     * Start pinging a name on behalf of a Ping or PingMultiple request.
+     *
+     * @param msg       The Ping or PingMultiple method call.
+     * @param name      The name to ping.
+     * @param timeout   Timeout in milliseconds.
+     *
+     * @return ALLJOYN_PING_REPLY_SUCCESS if the ping is under way and
+     *         PingReplyMethodHandlerUsingCode() will be called once it completes,
+     *         otherwise the reply code for the name.
+     */
+    uint32_t StartPing(Message& msg, const char* name, uint32_t timeout);
+
     /* TODO document */
     void PingReplyMethodHandler(Message& reply, void* context);
-    void PingReplyMethodHandlerUsingCode(Message& msg, uint32_t replyCode);
+    void PingRouteReplyHandler(Message& reply, void* context);
     void PingReplyTransportHandler(Message& reply, void* context);
 
     bool QueryHandler(TransportMask transport, MDNSPacket query, const qcc::IPEndpoint& src, const qcc::IPEndpoint& dst);
@@ -1248,6 +1392,16 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
     std::multimap<std::pair<qcc::String, qcc::String>, OutgoingPingInfo> outgoingPingMap;
     std::multimap<qcc::String, IncomingPingInfo> incomingPingMap;
     std::set<std::pair<qcc::String, qcc::String> > dbusPingsInProgress; //contains the caller of ping and destination of ping
+
+    /**
+     * A PingMultiple request waiting for the pings of its names to complete.
+     */
+    struct PingBatch {
+        std::vector<qcc::String> names;             /**< The names in the order of the request */
+        std::set<qcc::String> pending;              /**< Names whose ping has not completed yet */
+        std::map<qcc::String, uint32_t> replyCodes; /**< Reply codes of the completed names */
+    };
+    std::map<std::pair<qcc::String, uint32_t>, PingBatch> pingBatches; //keyed by the sender and serial number of the request
     TransportMask GetCompleteTransportMaskFilter();
     void SendIPNSResponse(qcc::String name, uint32_t replyCode);
     bool IsSelfJoinSupported(BusEndpoint& joinerEp) const;
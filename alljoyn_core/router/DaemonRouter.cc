@@ -38,6 +38,7 @@
 #include "EndpointHelper.h"
 #include "AllJoynObj.h"
 #include "SessionlessObj.h"
+#include "MsgArgCursor.h"
 #ifdef ENABLE_POLICYDB
 #include "PolicyDB.h"
 #endif
@@ -278,14 +279,15 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
     SessionId detachId = 0;
     if ((strcmp("DetachSession", msg->GetMemberName()) == 0) &&
         (strcmp(org::alljoyn::Daemon::InterfaceName, msg->GetInterface()) == 0)) {
-        /* Clone the message since this message is unmarshalled by the
-         * LocalEndpoint too and the process of unmarshalling is not
-         * thread-safe.
+        /* Read the session id with a cursor since this message is
+         * unmarshalled by the LocalEndpoint too and the process of
+         * unmarshalling is not thread-safe.
          */
-        Message clone = Message(msg, true);
-        QStatus lStatus = clone->UnmarshalArgs("us");
+        MsgArgCursor cursor(msg);
+        MsgArg detachArg;
+        QStatus lStatus = (strcmp(msg->GetSignature(), "us") == 0) ? cursor.Get(detachArg) : ER_BUS_SIGNATURE_MISMATCH;
         if (lStatus == ER_OK) {
-            detachId = clone->GetArg(0)->v_uint32;
+            detachId = detachArg.v_uint32;
         } else {
             QCC_LogError(lStatus, ("Failed to unmarshal args for DetachSession message"));
         }
@@ -45,7 +45,7 @@ namespace ajn {
 
 
 DaemonTransport::DaemonTransport(BusAttachment& bus)
-    : Thread("DaemonTransport"), bus(bus), stopping(false)
+    : Thread("DaemonTransport"), bus(bus), stopping(false), m_authTimeout(ALLJOYN_AUTH_TIMEOUT_DEFAULT)
 {
     /*
      * We know we are daemon code, so we'd better be running with a daemon
@@ -72,8 +72,9 @@ QStatus DaemonTransport::Start()
     m_numHbeatProbes = HEARTBEAT_NUM_PROBES;
     m_maxHbeatProbeTimeout = config->GetLimit("dt_max_probe_timeout", MAX_HEARTBEAT_PROBE_TIMEOUT_DEFAULT);
     m_defaultHbeatProbeTimeout = config->GetLimit("dt_default_probe_timeout", DEFAULT_HEARTBEAT_PROBE_TIMEOUT_DEFAULT);
+    m_authTimeout = config->GetLimit("auth_timeout", ALLJOYN_AUTH_TIMEOUT_DEFAULT);
 
-    QCC_DbgPrintf(("DaemonTransport: Using m_minHbeatIdleTimeout=%u, m_maxHbeatIdleTimeout=%u, m_numHbeatProbes=%u, m_defaultHbeatProbeTimeout=%u m_maxHbeatProbeTimeout=%u", m_minHbeatIdleTimeout, m_maxHbeatIdleTimeout, m_numHbeatProbes, m_defaultHbeatProbeTimeout, m_maxHbeatProbeTimeout));
+    QCC_DbgPrintf(("DaemonTransport: Using m_minHbeatIdleTimeout=%u, m_maxHbeatIdleTimeout=%u, m_numHbeatProbes=%u, m_defaultHbeatProbeTimeout=%u m_maxHbeatProbeTimeout=%u m_authTimeout=%u", m_minHbeatIdleTimeout, m_maxHbeatIdleTimeout, m_numHbeatProbes, m_defaultHbeatProbeTimeout, m_maxHbeatProbeTimeout, m_authTimeout));
 
     return ER_OK;
 }
@@ -138,6 +139,16 @@ QStatus DaemonTransport::Join(void)
     return ER_OK;
 }
 
+void DaemonTransport::RemoveEndpoint(RemoteEndpoint& ep)
+{
+    endpointListLock.Lock(MUTEX_CONTEXT);
+    list<RemoteEndpoint>::iterator ei = find(endpointList.begin(), endpointList.end(), ep);
+    if (ei != endpointList.end()) {
+        endpointList.erase(ei);
+    }
+    endpointListLock.Unlock(MUTEX_CONTEXT);
+}
+
 void DaemonTransport::EndpointExit(RemoteEndpoint& ep)
 {
     /*
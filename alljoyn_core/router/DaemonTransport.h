@@ -200,6 +200,16 @@ class DaemonTransport : public Transport, public _RemoteEndpoint::EndpointListen
      */
     static const uint32_t HEARTBEAT_NUM_PROBES = 1;
 
+    /**
+     * @brief The default timeout for client authentication.
+     *
+     * Connections are authenticated by the accept loop, so a client that
+     * stops in mid-authentication only holds on to its own connection until
+     * this many milliseconds have passed. This value can be overridden in the
+     * daemon config file by setting "auth_timeout".
+     */
+    static const uint32_t ALLJOYN_AUTH_TIMEOUT_DEFAULT = 20000;
+
     /**
      * Empty private overloaded virtual function for Thread::Start
      * this avoids the overloaded-virtual warning. For the Thread::Start
@@ -217,6 +227,14 @@ class DaemonTransport : public Transport, public _RemoteEndpoint::EndpointListen
      */
     qcc::ThreadReturn STDCALL Run(void* arg);
 
+    /**
+     * @internal
+     * @brief Take an endpoint that is not going to run off the endpoint list.
+     *
+     * @param ep  The endpoint to remove.
+     */
+    void RemoveEndpoint(RemoteEndpoint& ep);
+
     uint32_t m_minHbeatIdleTimeout; /**< The minimum allowed idle timeout for the Heartbeat between Routing node
                                          and Leaf node - configurable in router config */
 
@@ -235,6 +253,8 @@ class DaemonTransport : public Transport, public _RemoteEndpoint::EndpointListen
     uint32_t m_numHbeatProbes;             /**< Number of probes Routing node should wait for Heartbeat response to be
                                               recieved from the Leaf node before declaring it dead - Transport specific */
 
+    uint32_t m_authTimeout;                /**< The time a client has to complete authentication - configurable in router config */
+
 };
 
 } // namespace ajn
@@ -20,6 +20,7 @@
  ******************************************************************************/
 
 #include <qcc/platform.h>
+#include <qcc/Util.h>
 
 #include <alljoyn/AllJoynStd.h>
 #include <alljoyn/Session.h>
@@ -27,6 +28,7 @@
 #include "SessionlessObj.h"
 #include "BusController.h"
 #include "ConfigDB.h"
+#include "MsgArgCursor.h"
 
 #ifdef ENABLE_POLICYDB
 #include "PolicyDB.h"
@@ -70,6 +72,13 @@ static const char* WellKnownName = "org.alljoyn.sl";      /**< Well known bus na
 /** The advertised name when the match rule does not specify an interface */
 static const char* WildcardInterfaceName = "org.alljoyn";
 
+/**
+ * The prefix of the advertised name carrying the interest filter.  This must
+ * not begin with "org.alljoyn.sl." so that it is not found by implementations
+ * that do not understand it.
+ */
+static const char* FilterNamePrefix = "org.alljoyn.slb.b";
+
 /*
  * Do not update the version without reviewing where it is used below.  It is
  * encoded in the 'x' part of the "org.alljoyn.sl.x" advertised name, thus care
@@ -87,6 +96,128 @@ static const char* WildcardInterfaceName = "org.alljoyn";
  */
 const uint32_t SessionlessObj::version = 1;
 
+const uint32_t SessionlessObj::InterestFilter::MIN_BITS;
+const uint32_t SessionlessObj::InterestFilter::MAX_BITS;
+const uint32_t SessionlessObj::InterestFilter::BITS_PER_KEY;
+const uint32_t SessionlessObj::InterestFilter::NUM_HASHES;
+
+SessionlessObj::InterestFilter SessionlessObj::InterestFilter::Create(const set<pair<String, String> >& members)
+{
+    set<String> ifaces;
+    set<String> memberNames;
+    for (set<pair<String, String> >::const_iterator it = members.begin(); it != members.end(); ++it) {
+        ifaces.insert(it->first);
+        memberNames.insert(it->second);
+    }
+    InterestFilter filter(NumBits(ifaces.size() + memberNames.size() + members.size()));
+    for (set<pair<String, String> >::const_iterator it = members.begin(); it != members.end(); ++it) {
+        filter.Add(it->first, it->second);
+    }
+    return filter;
+}
+
+uint32_t SessionlessObj::InterestFilter::NumBits(size_t numKeys)
+{
+    size_t numBits = ((numKeys * BITS_PER_KEY + 31) / 32) * 32;
+    return static_cast<uint32_t>(max(static_cast<size_t>(MIN_BITS), min(numBits, static_cast<size_t>(MAX_BITS))));
+}
+
+void SessionlessObj::InterestFilter::Clear()
+{
+    fill(bits.begin(), bits.end(), 0);
+}
+
+void SessionlessObj::InterestFilter::Add(const qcc::String& iface, const qcc::String& member)
+{
+    /*
+     * Interface names always contain a '.' and member names never do, so the
+     * keys below cannot collide with each other.
+     */
+    Insert(iface);
+    Insert(member);
+    Insert(iface + "." + member);
+}
+
+bool SessionlessObj::InterestFilter::MayMatch(const Rule& rule) const
+{
+    if (!rule.iface.empty() && !rule.member.empty()) {
+        return Contains(rule.iface + "." + rule.member);
+    } else if (!rule.iface.empty()) {
+        return Contains(rule.iface);
+    } else if (!rule.member.empty()) {
+        return Contains(rule.member);
+    } else {
+        return true;
+    }
+}
+
+/*
+ * Double hashing over a 64-bit FNV-1a hash of the key.  This must be the same
+ * on all implementations since the filter is exchanged between routers.
+ */
+static void InterestFilterHash(const qcc::String& key, uint32_t& h1, uint32_t& h2)
+{
+    uint64_t h = qcc::hash_fnv1a(key.data(), key.size());
+    h1 = static_cast<uint32_t>(h);
+    h2 = static_cast<uint32_t>(h >> 32) | 1;
+}
+
+void SessionlessObj::InterestFilter::Insert(const qcc::String& key)
+{
+    uint32_t h1, h2;
+    InterestFilterHash(key, h1, h2);
+    uint32_t numBits = GetNumBits();
+    for (uint32_t i = 0; i < NUM_HASHES; ++i) {
+        uint32_t bit = (h1 + i * h2) % numBits;
+        bits[bit / 32] |= (1u << (bit % 32));
+    }
+}
+
+bool SessionlessObj::InterestFilter::Contains(const qcc::String& key) const
+{
+    uint32_t h1, h2;
+    InterestFilterHash(key, h1, h2);
+    uint32_t numBits = GetNumBits();
+    for (uint32_t i = 0; i < NUM_HASHES; ++i) {
+        uint32_t bit = (h1 + i * h2) % numBits;
+        if ((bits[bit / 32] & (1u << (bit % 32))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qcc::String SessionlessObj::InterestFilter::ToString() const
+{
+    String str;
+    for (size_t i = 0; i < bits.size(); ++i) {
+        str.append(U32ToString(bits[i], 16, 8, '0'));
+    }
+    return str;
+}
+
+QStatus SessionlessObj::InterestFilter::FromString(const qcc::String& str)
+{
+    if (((str.size() % 8) != 0) || (str.size() < (MIN_BITS / 4)) || (str.size() > (MAX_BITS / 4))) {
+        return ER_FAIL;
+    }
+    for (size_t j = 0; j < str.size(); ++j) {
+        if (!IsHexDigit(str[j])) {
+            return ER_FAIL;
+        }
+    }
+    bits.resize(str.size() / 8);
+    for (size_t i = 0; i < bits.size(); ++i) {
+        bits[i] = StringToU32(str.substr(i * 8, 8), 16);
+    }
+    return ER_OK;
+}
+
+bool SessionlessObj::InterestFilter::operator==(const InterestFilter& other) const
+{
+    return bits == other.bits;
+}
+
 /*
  * The context for the implements query response.  It must be delivered on
  * a separate thread than the Query callback to avoid deadlock.
@@ -150,6 +281,7 @@ SessionlessObj::SessionlessObj(Bus& bus, BusController* busController, DaemonRou
             ConfigDB::GetConfigDB()->GetLimit("sls_backoff_max", 15 * 60))
 {
     sessionOpts.transports = ConfigDB::GetConfigDB()->GetLimit("sls_preferred_transports", TRANSPORT_ANY);
+    advertiseFilter = (ConfigDB::GetConfigDB()->GetLimit("sls_interest_filter", 1) != 0);
 }
 
 SessionlessObj::~SessionlessObj()
@@ -410,6 +542,24 @@ SessionlessObj::PushMessageWork::PushMessageWork(SessionlessObj& slObj, Message&
 {
 }
 
+void SessionlessObj::AddToLocalCache(const SessionlessMessageKey& key, const SessionlessMessage& val)
+{
+    LocalCache::iterator it = localCache.find(key);
+    if (it == localCache.end()) {
+        localCache.insert(pair<SessionlessMessageKey, SessionlessMessage>(key, val));
+    } else {
+        changeIdIndex.erase(make_pair(it->second.changeId, key));
+        it->second = val;
+    }
+    changeIdIndex.insert(make_pair(val.changeId, key));
+}
+
+void SessionlessObj::EraseFromLocalCache(LocalCache::iterator it)
+{
+    changeIdIndex.erase(make_pair(it->second.changeId, it->first));
+    localCache.erase(it);
+}
+
 bool SessionlessObj::IsSessionlessEmitter(String name)
 {
     lock.Lock();
@@ -428,18 +578,14 @@ void SessionlessObj::PushMessageWork::Run()
     /* Match the message against any existing implicit rules */
     uint32_t fromRulesId = slObj.nextRulesId - (numeric_limits<uint32_t>::max() >> 1);
     uint32_t toRulesId = slObj.nextRulesId;
-    slObj.SendMatchingThroughEndpoint(0, msg, fromRulesId, toRulesId);
+    SessionlessMessage val(slObj.curChangeId, msg);
+    slObj.SendMatchingThroughEndpoint(0, msg, *val.matchKeys, fromRulesId, toRulesId);
 
     /* Put the message in the local cache */
     SessionlessMessageKey key(msg->GetSender(), msg->GetInterface(), msg->GetMemberName(), msg->GetObjectPath());
     slObj.advanceChangeId = true;
-    SessionlessMessage val(slObj.curChangeId, msg);
-    LocalCache::iterator it = slObj.localCache.find(key);
-    if (it == slObj.localCache.end()) {
-        slObj.localCache.insert(pair<SessionlessMessageKey, SessionlessMessage>(key, val));
-    } else {
-        it->second = val;
-    }
+    val.changeId = slObj.curChangeId;
+    slObj.AddToLocalCache(key, val);
 
     slObj.lock.Unlock();
     slObj.router.UnlockNameTable();
@@ -485,14 +631,15 @@ void SessionlessObj::RouteSessionlessMessage(SessionId sid, Message& msg)
         cache.routedMessages.push_back(RoutedMessage(msg));
     }
 
-    SendMatchingThroughEndpoint(sid, msg, cache.fromRulesId, cache.toRulesId);
+    RuleMatchKeys keys(msg);
+    SendMatchingThroughEndpoint(sid, msg, keys, cache.fromRulesId, cache.toRulesId);
 
     lock.Unlock();
     router.UnlockNameTable();
     return;
 }
 
-void SessionlessObj::SendMatchingThroughEndpoint(SessionId sid, Message msg, uint32_t fromRulesId, uint32_t toRulesId)
+void SessionlessObj::SendMatchingThroughEndpoint(SessionId sid, Message msg, RuleMatchKeys& keys, uint32_t fromRulesId, uint32_t toRulesId)
 {
     bool isAnnounce = (0 == strcmp(msg->GetInterface(), "org.alljoyn.About")) && (0 == strcmp(msg->GetMemberName(), "Announce"));
     uint32_t rulesRangeLen = toRulesId - fromRulesId;
@@ -506,7 +653,7 @@ void SessionlessObj::SendMatchingThroughEndpoint(SessionId sid, Message msg, uin
         RuleIterator end = rules.upper_bound(epName);
         for (; rit != end; ++rit) {
             if (IN_WINDOW(uint32_t, fromRulesId, rulesRangeLen, rit->second.id) && epCanReceive) {
-                if (rit->second.IsMatch(msg)) {
+                if (rit->second.IsMatch(msg, keys)) {
                     isExplicitMatch = true;
                     if (isAnnounce && !rit->second.implements.empty()) {
                         /*
@@ -564,17 +711,20 @@ void SessionlessObj::CancelMessageWork::Run()
     QStatus status = ER_BUS_NO_SUCH_MESSAGE;
 
     qcc::String sender = msg->GetSender();
-    uint32_t serialNum = msg->GetArg(0)->v_uint32;
+    /* The message is not unmarshaled, serial number 0 is never used so nothing matches if it cannot be read */
+    MsgArgCursor cursor(msg);
+    MsgArg serialArg;
+    uint32_t serialNum = (cursor.Get(serialArg) == ER_OK) ? serialArg.v_uint32 : 0;
 
     slObj.lock.Lock();
     SessionlessMessageKey key(sender.c_str(), "", "", "");
     LocalCache::iterator it = slObj.localCache.lower_bound(key);
-    while ((it != slObj.localCache.end()) && (sender == it->second.second->GetSender())) {
-        if (it->second.second->GetCallSerial() == serialNum) {
-            if (!it->second.second->IsExpired()) {
+    while ((it != slObj.localCache.end()) && (sender == it->second.msg->GetSender())) {
+        if (it->second.msg->GetCallSerial() == serialNum) {
+            if (!it->second.msg->IsExpired()) {
                 status = ER_OK;
             }
-            slObj.localCache.erase(it);
+            slObj.EraseFromLocalCache(it);
             break;
         }
         ++it;
@@ -586,7 +736,7 @@ void SessionlessObj::CancelMessageWork::Run()
 
 void SessionlessObj::CancelMessage(Message& msg)
 {
-    QCC_DbgTrace(("SessionlessObj::CancelMessage(%s, 0x%x)", msg->GetSender(), msg->GetArg(0)->v_uint32));
+    QCC_DbgTrace(("SessionlessObj::CancelMessage(%s)", msg->GetSender()));
     ScheduleWork(new CancelMessageWork(*this, msg));
 }
 
@@ -628,8 +778,8 @@ void SessionlessObj::NameOwnerChangedWork::Run()
     /* Remove stored sessionless messages sent by the old owner */
     SessionlessMessageKey key(oldOwner.c_str(), "", "", "");
     LocalCache::iterator mit = slObj.localCache.lower_bound(key);
-    while ((mit != slObj.localCache.end()) && (::strcmp(oldOwner.c_str(), mit->second.second->GetSender()) == 0)) {
-        slObj.localCache.erase(mit++);
+    while ((mit != slObj.localCache.end()) && (::strcmp(oldOwner.c_str(), mit->second.msg->GetSender()) == 0)) {
+        slObj.EraseFromLocalCache(mit++);
     }
 
     /* Stop discovery if nobody is looking for sessionless signals */
@@ -668,6 +818,11 @@ void SessionlessObj::FoundAdvertisedNameHandler(const char* name, TransportMask
         return;
     }
 
+    if (::strncmp(name, FilterNamePrefix, ::strlen(FilterNamePrefix)) == 0) {
+        FoundFilterName(name, transport);
+        return;
+    }
+
     String guid, iface;
     uint32_t versionNumber, changeId;
     QStatus status = ParseAdvertisedName(name, &versionNumber, &guid, &iface, &changeId);
@@ -699,6 +854,39 @@ void SessionlessObj::FoundAdvertisedNameHandler(const char* name, TransportMask
     lock.Unlock();
 }
 
+void SessionlessObj::FoundFilterName(const char* name, TransportMask transport)
+{
+    String guid;
+    uint32_t versionNumber, changeId;
+    InterestFilter filter;
+    QStatus status = ParseFilterName(name, &versionNumber, &guid, &filter, &changeId);
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Found invalid filter name \"%s\"", name));
+        return;
+    }
+    QCC_DbgPrintf(("FoundFilterName(name=%s,transport=0x%x) guid=%s,version=%u,changeId=%u",
+                   name, transport, guid.c_str(), versionNumber, changeId));
+
+    lock.Lock();
+    RemoteCaches::iterator cit = remoteCaches.find(guid);
+    if (cit == remoteCaches.end()) {
+        /*
+         * The filter may be found before any of the interface advertisements.
+         * Remember it, but with no interfaces the cache will not match any
+         * rules until an interface advertisement is found.
+         */
+        cit = remoteCaches.insert(pair<String, RemoteCacheWork>(guid, RemoteCacheWork(name, versionNumber, guid, String(), changeId, transport))).first;
+        cit->second.ifaces.clear();
+    }
+    RemoteCache& cache = cit->second;
+    if (!cache.haveFilter || IS_GREATER_OR_EQUAL(uint32_t, changeId, cache.filterChangeId)) {
+        cache.haveFilter = true;
+        cache.filter = filter;
+        cache.filterChangeId = changeId;
+    }
+    lock.Unlock();
+}
+
 bool SessionlessObj::AcceptSessionJoiner(SessionPort port,
                                          const char* joiner,
                                          const SessionOpts& opts)
@@ -836,6 +1024,33 @@ void SessionlessObj::RequestRangeMatchSignalHandler(const InterfaceDescription::
     }
 }
 
+SessionlessObj::ChangeIdIndex::const_iterator SessionlessObj::NextInRange(const ChangeIdIndex& index, uint32_t fromChangeId, uint32_t toChangeId,
+                                                                         const ChangeIdIndex::value_type* last)
+{
+    uint32_t rangeLen = toChangeId - fromChangeId;
+    if (rangeLen == 0) {
+        return index.end();
+    }
+
+    /*
+     * A range that wraps around is walked in two segments, [fromChangeId, max]
+     * and then [0, toChangeId).  The second segment holds the change IDs below
+     * fromChangeId, and we never go back to the first segment from it.
+     */
+    bool wraps = toChangeId < fromChangeId;
+    bool inSecondSegment = wraps && last && (last->first < fromChangeId);
+    ChangeIdIndex::const_iterator it = last ? index.upper_bound(*last) : index.lower_bound(make_pair(fromChangeId, SessionlessMessageKey()));
+    if ((it == index.end()) && wraps && !inSecondSegment) {
+        it = index.begin();
+        inSecondSegment = true;
+    }
+    if ((it == index.end()) || !IN_WINDOW(uint32_t, fromChangeId, rangeLen, it->first) ||
+        (inSecondSegment && (it->first >= fromChangeId))) {
+        return index.end();
+    }
+    return it;
+}
+
 void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
                                         uint32_t fromChangeId, uint32_t toChangeId,
                                         uint32_t fromLocalRulesId, uint32_t toLocalRulesId,
@@ -853,44 +1068,63 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
         advanceChangeId = false;
     }
 
-    /* Send all messages in local cache in range [fromChangeId, toChangeId) */
-    LocalCache::iterator it = localCache.begin();
-    uint32_t rangeLen = toChangeId - fromChangeId;
-    while (it != localCache.end()) {
-        if (IN_WINDOW(uint32_t, fromChangeId, rangeLen, it->second.first)) {
-            SessionlessMessageKey key = it->first;
-            Message msg = it->second.second;
-            if (msg->IsExpired()) {
-                /* Remove expired message without sending */
-                localCache.erase(it++);
-                messageErased = true;
-            } else if (sid != 0) {
-                /* Send message to remote destination */
-                bool isMatch = remoteRules.empty();
-                for (vector<String>::iterator rit = remoteRules.begin(); !isMatch && (rit != remoteRules.end()); ++rit) {
-                    Rule rule(rit->c_str());
-                    isMatch = rule.IsMatch(msg) || (rule == legacyRule);
-                }
-                if (isMatch) {
-                    BusEndpoint ep = router.FindEndpoint(sender);
-                    if (ep->IsValid()) {
-                        lock.Unlock();
-                        router.UnlockNameTable();
-                        QCC_DbgPrintf(("Send cid=%u,serialNum=%u to sid=%u", it->second.first, msg->GetCallSerial(), sid));
-                        SendThroughEndpoint(msg, ep, sid);
-                        router.LockNameTable();
-                        lock.Lock();
-                    }
+    /*
+     * Parse the remote rules once for the whole request rather than once per
+     * cached message.  The legacy rule matches every message.
+     */
+    bool matchAll = remoteRules.empty();
+    vector<Rule> matchRules;
+    for (vector<String>::iterator rit = remoteRules.begin(); !matchAll && (rit != remoteRules.end()); ++rit) {
+        Rule rule(rit->c_str());
+        if (rule == legacyRule) {
+            matchAll = true;
+        } else {
+            matchRules.push_back(rule);
+        }
+    }
+
+    /*
+     * Send all messages in local cache in range [fromChangeId, toChangeId).
+     * The lock is released while sending, so after each send we find our
+     * place again from the last index entry visited.
+     */
+    ChangeIdIndex::const_iterator xit = NextInRange(changeIdIndex, fromChangeId, toChangeId, NULL);
+    while (xit != changeIdIndex.end()) {
+        ChangeIdIndex::value_type pos = *xit;
+        LocalCache::iterator it = localCache.find(pos.second);
+        QCC_ASSERT(it != localCache.end());
+        Message msg = it->second.msg;
+        if (msg->IsExpired()) {
+            /* Remove expired message without sending */
+            EraseFromLocalCache(it);
+            messageErased = true;
+        } else if (sid != 0) {
+            /* Send message to remote destination */
+            bool isMatch = matchAll;
+            for (vector<Rule>::iterator rit = matchRules.begin(); !isMatch && (rit != matchRules.end()); ++rit) {
+                isMatch = rit->IsMatch(msg, *it->second.matchKeys);
+            }
+            if (isMatch) {
+                BusEndpoint ep = router.FindEndpoint(sender);
+                if (ep->IsValid()) {
+                    lock.Unlock();
+                    router.UnlockNameTable();
+                    QCC_DbgPrintf(("Send cid=%u,serialNum=%u to sid=%u", pos.first, msg->GetCallSerial(), sid));
+                    SendThroughEndpoint(msg, ep, sid);
+                    router.LockNameTable();
+                    lock.Lock();
                 }
-                it = localCache.upper_bound(key);
-            } else {
-                /* Send message to local destination */
-                SendMatchingThroughEndpoint(sid, msg, fromLocalRulesId, toLocalRulesId);
-                it = localCache.upper_bound(key);
             }
         } else {
-            ++it;
+            /*
+             * Send message to local destination.  Hold a reference to the
+             * cached keys rather than to the cache entry, which may be erased
+             * while the lock is released to send.
+             */
+            qcc::ManagedObj<RuleMatchKeys> keys = it->second.matchKeys;
+            SendMatchingThroughEndpoint(sid, msg, *keys, fromLocalRulesId, toLocalRulesId);
         }
+        xit = NextInRange(changeIdIndex, fromChangeId, toChangeId, &pos);
     }
     lock.Unlock();
     router.UnlockNameTable();
@@ -934,8 +1168,8 @@ void SessionlessObj::AlarmTriggered(const Alarm& alarm, QStatus reason)
         lock.Lock();
         LocalCache::iterator it = localCache.begin();
         while (it != localCache.end()) {
-            if (it->second.second->IsExpired(&expire)) {
-                localCache.erase(it++);
+            if (it->second.msg->IsExpired(&expire)) {
+                EraseFromLocalCache(it++);
             } else {
                 ++it;
             }
@@ -1172,6 +1406,35 @@ QStatus SessionlessObj::ParseAdvertisedName(const qcc::String& name, uint32_t* v
     return ER_OK;
 }
 
+QStatus SessionlessObj::ParseFilterName(const qcc::String& name, uint32_t* versionNumber, qcc::String* guid, InterestFilter* filter, uint32_t* changeId)
+{
+    size_t filterPos = ::strlen(FilterNamePrefix);
+    if (name.compare(0, filterPos, FilterNamePrefix) != 0) {
+        return ER_FAIL;
+    }
+    size_t guidPos = name.find_first_of('.', filterPos);
+    if (guidPos == String::npos) {
+        return ER_FAIL;
+    }
+    size_t changePos = name.find_first_of('.', guidPos + 1);
+    if ((changePos == String::npos) || (changePos < guidPos + 2) || (name[changePos + 1] != 'x')) {
+        return ER_FAIL;
+    }
+    if (filter && (filter->FromString(name.substr(filterPos, guidPos - filterPos)) != ER_OK)) {
+        return ER_FAIL;
+    }
+    if (versionNumber) {
+        *versionNumber = name[guidPos + 1] - 'x';
+    }
+    if (guid) {
+        *guid = name.substr(guidPos + 2, changePos - guidPos - 2);
+    }
+    if (changeId) {
+        *changeId = StringToU32(name.substr(changePos + 2), 16);
+    }
+    return ER_OK;
+}
+
 QStatus SessionlessObj::RequestSignals(const char* name, SessionId sid, uint32_t fromId)
 {
     MsgArg args[1];
@@ -1231,11 +1494,13 @@ void SessionlessObj::UpdateAdvertisements()
 {
     /* Figure out what we need to advertise. */
     map<String, uint32_t> advertisements;
+    set<pair<String, String> > members;
     lock.Lock();
     for (LocalCache::iterator it = localCache.begin(); it != localCache.end(); ++it) {
-        Message msg = it->second.second;
-        advertisements[msg->GetInterface()] = max(advertisements[msg->GetInterface()], it->second.first);
-        advertisements[WildcardInterfaceName] = max(advertisements[WildcardInterfaceName], it->second.first); /* The v0 advertisement */
+        Message msg = it->second.msg;
+        advertisements[msg->GetInterface()] = max(advertisements[msg->GetInterface()], it->second.changeId);
+        advertisements[WildcardInterfaceName] = max(advertisements[WildcardInterfaceName], it->second.changeId); /* The v0 advertisement */
+        members.insert(pair<String, String>(msg->GetInterface(), msg->GetMemberName()));
     }
 
     /* First pass: cancel any names that don't need to be advertised anymore. */
@@ -1265,6 +1530,21 @@ void SessionlessObj::UpdateAdvertisements()
         }
     }
 
+    /* Last pass: update the interest filter, it follows the v0 advertisement. */
+    String filterName;
+    if (advertiseFilter && !advertisements.empty()) {
+        filterName = FilterName(InterestFilter::Create(members), advertisements[WildcardInterfaceName]);
+    }
+    if (filterName != lastFilterName) {
+        if (!lastFilterName.empty()) {
+            cancelNames.push_back(lastFilterName);
+        }
+        if (!filterName.empty()) {
+            advertiseNames.push_back(filterName);
+        }
+        lastFilterName = filterName;
+    }
+
     lock.Unlock();
 
     for (vector<String>::iterator it = cancelNames.begin(); it != cancelNames.end(); ++it) {
@@ -1286,6 +1566,18 @@ qcc::String SessionlessObj::AdvertisedName(const qcc::String& iface, uint32_t ch
     return name;
 }
 
+qcc::String SessionlessObj::FilterName(const InterestFilter& filter, uint32_t changeId)
+{
+    String name = FilterNamePrefix;
+    name.append(filter.ToString());
+    name.append('.');
+    name.append('x' + version);
+    name.append(bus.GetGlobalGUIDShortString());
+    name.append(".x");
+    name.append(U32ToString(changeId, 16));
+    return name;
+}
+
 QStatus SessionlessObj::AdvertiseName(const qcc::String& name)
 {
     QStatus status = bus.RequestName(name.c_str(), DBUS_NAME_FLAG_DO_NOT_QUEUE);
@@ -1351,6 +1643,10 @@ void SessionlessObj::FindAdvertisedNames()
         if (findingNames.insert(name).second) {
             names.insert(name);
         }
+        name = String("name='") + FilterNamePrefix + "*'";
+        if (findingNames.insert(name).second) {
+            names.insert(name);
+        }
     }
 
     lock.Unlock();
@@ -1511,10 +1807,17 @@ bool SessionlessObj::IsMatch(RemoteCache& cache, TimestampedRules& rules, uint32
     if (cache.version == 0) {
         return true;
     }
+    /*
+     * The interest filter describes the whole remote cache as of its change
+     * ID.  It may only be used to rule out a fetch when it is at least as
+     * recent as the newest advertisement.
+     */
+    bool filterValid = cache.haveFilter && IS_GREATER_OR_EQUAL(uint32_t, cache.filterChangeId, cache.changeId);
     uint32_t rulesRangeLen = toRulesId - fromRulesId;
     for (RuleIterator rit = rules.begin(); rit != rules.end(); ++rit) {
         if (IN_WINDOW(uint32_t, fromRulesId, rulesRangeLen, rit->second.id) &&
-            (cache.ifaces.find(rit->second.iface) != cache.ifaces.end())) {
+            (cache.ifaces.find(rit->second.iface) != cache.ifaces.end()) &&
+            (!filterValid || cache.filter.MayMatch(rit->second))) {
             return true;
         }
     }
@@ -1565,8 +1868,8 @@ bool SessionlessObj::SendResponseIfMatch(TransportMask transport, const qcc::IPE
     String name;
     lock.Lock();
     for (LocalCache::iterator mit = localCache.begin(); mit != localCache.end(); ++mit) {
-        Message& msg = mit->second.second;
-        if (rule.IsMatch(msg)) {
+        Message& msg = mit->second.msg;
+        if (rule.IsMatch(msg, *mit->second.matchKeys)) {
             name = AdvertisedName(msg->GetInterface(), lastAdvertisements[msg->GetInterface()]);
             sendResponse = true;
             break;
@@ -26,7 +26,9 @@
 #include <map>
 #include <set>
 #include <queue>
+#include <vector>
 
+#include <qcc/ManagedObj.h>
 #include <qcc/String.h>
 #include <qcc/Timer.h>
 
@@ -128,7 +130,8 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
     /**
      * Remove a sessionless signal with a given serial number from the store/forward cache.
      *
-     * @param msg      The org.alljoyn.Bus.CancelSessionlessMessage method call message.
+     * @param msg      The org.alljoyn.Bus.CancelSessionlessMessage method call message. The
+     *                 body is read in place, the message need not be unmarshaled.
      */
     void CancelMessage(Message& msg);
 
@@ -256,11 +259,112 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
                                    qcc::Timespec<qcc::MonotonicTime>& firstJoinTime,
                                    qcc::Timespec<qcc::MonotonicTime>& nextJoinTime);
 
+    /**
+     * A compact Bloom filter of the interface and member names carried by a
+     * cache.
+     *
+     * The provider advertises the filter of its current cache alongside the
+     * per-interface advertisements.  A consumer may skip fetching from the
+     * provider when the filter shows that none of its rules can match.  False
+     * positives only cost a fetch, there are no false negatives.
+     *
+     * The number of bits grows with the number of names in the cache so that
+     * the false positive rate stays around 2%, up to what fits in an
+     * advertised name.  The size is carried by the length of the encoding.
+     */
+    class InterestFilter {
+      public:
+        /** Smallest number of bits in a filter */
+        static const uint32_t MIN_BITS = 128;
+
+        /** Largest number of bits in a filter, limited by the length of a bus name */
+        static const uint32_t MAX_BITS = 768;
+
+        /** Number of bits per name, about 2% false positives with NUM_HASHES of 3 */
+        static const uint32_t BITS_PER_KEY = 10;
+
+        /** Number of bits set per name */
+        static const uint32_t NUM_HASHES = 3;
+
+        /**
+         * Construct an empty filter.
+         *
+         * @param[in] numBits the number of bits, a multiple of 32 between MIN_BITS and MAX_BITS
+         */
+        InterestFilter(uint32_t numBits = MIN_BITS) : bits(numBits / 32, 0) { }
+
+        /**
+         * Create a filter sized for, and holding, the interface and member
+         * names of a set of messages.
+         *
+         * @param[in] members the interface and member names
+         *
+         * @return the filter
+         */
+        static InterestFilter Create(const std::set<std::pair<qcc::String, qcc::String> >& members);
+
+        /**
+         * @param[in] numKeys the number of names to be added
+         *
+         * @return the number of bits of a filter for numKeys names.
+         */
+        static uint32_t NumBits(size_t numKeys);
+
+        /**
+         * @return the number of bits in the filter.
+         */
+        uint32_t GetNumBits() const { return static_cast<uint32_t>(bits.size() * 32); }
+
+        /**
+         * Clear the filter.
+         */
+        void Clear();
+
+        /**
+         * Add the interface and member names of a message to the filter.
+         *
+         * @param[in] iface the interface name
+         * @param[in] member the member name
+         */
+        void Add(const qcc::String& iface, const qcc::String& member);
+
+        /**
+         * @param[in] rule a match rule
+         *
+         * @return false if the rule cannot match any message added to the
+         * filter, true otherwise.
+         */
+        bool MayMatch(const Rule& rule) const;
+
+        /**
+         * @return the filter encoded as a string of hex digits.
+         */
+        qcc::String ToString() const;
+
+        /**
+         * Decode the filter from a string of hex digits.
+         *
+         * @param[in] str the encoded filter
+         *
+         * @return ER_OK if successful, ER_FAIL if str is not a valid filter.
+         */
+        QStatus FromString(const qcc::String& str);
+
+        bool operator==(const InterestFilter& other) const;
+        bool operator!=(const InterestFilter& other) const { return !(*this == other); }
+
+      private:
+        void Insert(const qcc::String& key);
+        bool Contains(const qcc::String& key) const;
+
+        std::vector<uint32_t> bits;
+    };
+
     class RemoteCache {
       public:
         RemoteCache(const qcc::String& name, uint32_t versionNumber, const qcc::String& guid, const qcc::String& iface, uint32_t changeId, TransportMask transport) :
-            name(name), version(versionNumber), guid(guid), changeId(changeId), transports(transport), haveReceived(false),
-            receivedChangeId(std::numeric_limits<uint32_t>::max()), appliedRulesId(std::numeric_limits<uint32_t>::max()) {
+            name(name), version(versionNumber), guid(guid), changeId(changeId), transports(transport), haveFilter(false), filterChangeId(0),
+            haveReceived(false), receivedChangeId(std::numeric_limits<uint32_t>::max()), appliedRulesId(std::numeric_limits<uint32_t>::max()) {
             ifaces.insert(iface);
         }
 
@@ -272,6 +376,10 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
         std::set<qcc::String> ifaces;
         uint32_t changeId;
         TransportMask transports;
+        /* The most recent interest filter advertisement, if any */
+        bool haveFilter;
+        InterestFilter filter;
+        uint32_t filterChangeId;
 
         /* State */
         bool haveReceived; /* true once we have received something from the remote cache */
@@ -303,6 +411,41 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
      */
     static WorkType PendingWork(RemoteCache& cache, TimestampedRules& rules, uint32_t nextRulesId);
 
+    /** A key into the local sessionless message queue */
+    class SessionlessMessageKey : public qcc::String {
+      public:
+        SessionlessMessageKey() { }
+        SessionlessMessageKey(const char* sender, const char* iface, const char* member, const char* objPath) :
+            qcc::String(sender, 0, ::strlen(sender) + ::strlen(iface) + ::strlen(member) + ::strlen(objPath) + 4)
+        {
+            append(':');
+            append(iface);
+            append(':');
+            append(member);
+            append(':');
+            append(objPath);
+        }
+    };
+
+    /** Change ID and key of the messages in the local cache */
+    typedef std::set<std::pair<uint32_t, SessionlessMessageKey> > ChangeIdIndex;
+
+    /**
+     * Find the next entry of a change ID index in a range of change IDs.  The
+     * range may wrap around, in which case the entries at the top of the
+     * change ID space come first.
+     *
+     * @param[in] index the change ID index
+     * @param[in] fromChangeId the first change ID of the range
+     * @param[in] toChangeId one past the last change ID of the range
+     * @param[in] last the entry visited last, or NULL to find the first entry.
+     *                 The entry does not need to be in the index any more.
+     *
+     * @return the next entry in the range or index.end() if there is none
+     */
+    static ChangeIdIndex::const_iterator NextInRange(const ChangeIdIndex& index, uint32_t fromChangeId, uint32_t toChangeId,
+                                                     const ChangeIdIndex::value_type* last);
+
   private:
     friend struct RemoteCacheWorkSnapshot;
 
@@ -365,26 +508,38 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
 
     qcc::Timer timer;                     /**< Timer object for reaping expired names */
 
-    /** A key into the local sessionless message queue */
-    class SessionlessMessageKey : public qcc::String {
-      public:
-        SessionlessMessageKey(const char* sender, const char* iface, const char* member, const char* objPath) :
-            qcc::String(sender, 0, ::strlen(sender) + ::strlen(iface) + ::strlen(member) + ::strlen(objPath) + 4)
-        {
-            append(':');
-            append(iface);
-            append(':');
-            append(member);
-            append(':');
-            append(objPath);
-        }
+    /** A cached sessionless message with its change ID and rule match keys */
+    struct SessionlessMessage {
+        SessionlessMessage(uint32_t changeId, const Message& msg) : changeId(changeId), msg(msg), matchKeys(msg) { }
+        uint32_t changeId;
+        Message msg;
+        qcc::ManagedObj<RuleMatchKeys> matchKeys; /**< Kept with the message so that it is unmarshalled at most once for matching */
     };
-    typedef std::pair<uint32_t, Message> SessionlessMessage;
 
     typedef std::map<SessionlessMessageKey, SessionlessMessage> LocalCache;
     /** Storage for sessionless messages waiting to be delivered */
     LocalCache localCache;
 
+    /** Index of localCache ordered by change ID, used to serve range requests */
+    ChangeIdIndex changeIdIndex;
+
+    /**
+     * Add or replace a message in the local cache, keeping the change ID
+     * index in sync.
+     *
+     * @param[in] key the local cache key
+     * @param[in] val the message and its change ID
+     */
+    void AddToLocalCache(const SessionlessMessageKey& key, const SessionlessMessage& val);
+
+    /**
+     * Remove a message from the local cache, keeping the change ID index in
+     * sync.
+     *
+     * @param[in] it the local cache entry to remove
+     */
+    void EraseFromLocalCache(LocalCache::iterator it);
+
     struct RoutedMessage {
         RoutedMessage(const Message& msg) : sender(msg->GetSender()), serial(msg->GetCallSerial()) { }
         qcc::String sender;
@@ -451,6 +606,19 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
      */
     QStatus ParseAdvertisedName(const qcc::String& name, uint32_t* versionNumber, qcc::String* guid, qcc::String* iface, uint32_t* changeId);
 
+    /**
+     * Parse an interest filter advertised name.
+     *
+     * @param[in] name the advertised name
+     * @param[out] versionNumber the version of the advertiser
+     * @param[out] guid the short GUID of the advertiser
+     * @param[out] filter the interest filter
+     * @param[out] changeId the change ID of the cache described by the filter
+     *
+     * @return ER_OK if successful, ER_FAIL if name is not a valid filter name.
+     */
+    QStatus ParseFilterName(const qcc::String& name, uint32_t* versionNumber, qcc::String* guid, InterestFilter* filter, uint32_t* changeId);
+
     /**
      * Internal helper for sending the RequestSignals signal.
      *
@@ -495,10 +663,11 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
      *
      * @param[in] sid Session ID
      * @param[in] msg The sessionless signal
+     * @param[in] keys The rule match keys of msg
      * @param[in] fromRulesId Beginning of rules ID range (inclusive)
      * @param[in] toRulesId End of rules ID range (exclusive)
      */
-    void SendMatchingThroughEndpoint(SessionId sid, Message msg, uint32_t fromRulesId, uint32_t toRulesId);
+    void SendMatchingThroughEndpoint(SessionId sid, Message msg, RuleMatchKeys& keys, uint32_t fromRulesId, uint32_t toRulesId);
 
     /** Rule iterator */
     typedef std::multimap<qcc::String, TimestampedRule>::iterator RuleIterator;
@@ -588,6 +757,21 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
      */
     qcc::String AdvertisedName(const qcc::String& iface, uint32_t changeId);
 
+    /*
+     * Helper to create the advertised name carrying the interest filter.
+     */
+    qcc::String FilterName(const InterestFilter& filter, uint32_t changeId);
+
+    /*
+     * true to advertise the interest filter of the local cache.
+     */
+    bool advertiseFilter;
+
+    /*
+     * The last advertised interest filter name, empty if none.
+     */
+    qcc::String lastFilterName;
+
     /*
      * Helper to request and advertise a name.
      */
@@ -638,6 +822,7 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
     bool ResponseHandler(TransportMask transport, MDNSPacket response, uint16_t recvPort);
 
     void FoundAdvertisedNameHandler(const char* name, TransportMask transport, const char* prefix, bool doInitialBackoff = true);
+    void FoundFilterName(const char* name, TransportMask transport);
 
     QStatus FindAdvertisementByTransport(const char* matching, TransportMask transports);
     QStatus CancelFindAdvertisementByTransport(const char* matching, TransportMask transports);
@@ -283,33 +283,29 @@
  * that an endpoint is not brought up immediately, but an authentication step
  * must be performed.  The server accept loop starts this process by placing the
  * new TCPEndpoint on an authList, or list of authenticating endpoints.
- * It then calls the endpoint Authenticate() method which spins up an
- * authentication thread and returns immediately.  This process transfers the
- * responsibility for the connection and its resources to the authentication
- * thread.  Authentication can succeed, fail, or take to long and be aborted.
+ * It then calls the endpoint Authenticate() method which starts a non-blocking
+ * handshake and returns immediately.  There is no thread per connection; the
+ * server accept loop waits on the sockets of all of the authenticating
+ * endpoints along with the listen sockets and calls AuthProgress() on an
+ * endpoint whenever data arrives for it.  Authentication can succeed, fail, or
+ * take to long and be aborted.
  *
- * If authentication succeeds, the authentication thread calls back into the
+ * If authentication succeeds, AuthProgress() calls back into the
  * TCPTransport's Authenticated() method.  Along with indicating that
- * authentication has completed successfully, this transfers ownership of the
- * TCPEndpoint back to the TCPTransport from the authentication
- * thread.  At this time, the TCPEndpoint is Start()ed which spins up
- * the transmit and receive threads and enables Message routing across the
- * transport.
+ * authentication has completed successfully, this moves the TCPEndpoint
+ * from the authList to the endpointList.  At this time, the TCPEndpoint is
+ * Start()ed which spins up the transmit and receive threads and enables
+ * Message routing across the transport.
  *
- * If the authentication fails, the authentication thread simply sets a the
- * TCPEndpoint state to FAILED and exits.  The server accept loop looks at
- * authenticating endpoints (those on the authList)each time through its loop.
- * If an endpoint has failed authentication, and its thread has actually gone
- * away (or more precisely is at least going away in such a way that it will
- * never touch the endpoint data structure again).  This means that the endpoint
- * can be deleted.
+ * If the authentication fails, AuthProgress() simply sets the TCPEndpoint
+ * state to FAILED.  The server accept loop looks at authenticating endpoints
+ * (those on the authList) each time through its loop.  If an endpoint has
+ * failed authentication it can be deleted.
  *
  * If the authentication takes "too long" we assume that a denial of service
- * attack in in progress.  We call AuthStop() on such an endpoint which will most
- * likely induce a failure (unless we happen to call abort just as the endpoint
- * actually finishes the authentication which is highly unlikely but okay).
- * This AuthStop() will cause the endpoint to be scavenged using the above mechanism
- * the next time through the accept loop.
+ * attack in in progress.  We call AuthStop() on such an endpoint which fails
+ * the handshake and causes the endpoint to be scavenged using the above
+ * mechanism.
  *
  * A daemon transport can accept incoming connections, and it can make outgoing
  * connections to another daemon.  This case is simpler than the accept case
@@ -351,8 +347,8 @@
  *
  *   1) Threads that may be running in the server accept loop with associated Events
  *      and their dependent socketFds stored in the listenFds list.
- *   2) Threads that may be running authentication with associated endpoint objects,
- *      streams and SocketFds.  These threads are accessible through endpoint objects
+ *   2) Handshakes that may be in progress with associated endpoint objects,
+ *      streams and SocketFds.  These are accessible through endpoint objects
  *      stored on the authList.
  *   3) Unregistering the endpoint from IODispatch that stops any future read/write callbacks
  *      from occuring and schedules a ExitCallback that can be used for clean up.
@@ -411,27 +407,27 @@ class _TCPEndpoint : public _RemoteEndpoint {
   public:
     friend class TCPTransport;
     /**
-     * There are three threads that can be running around in this data
-     * structure.  An auth thread is run before the endpoint is started in order
-     * to handle the security stuff that must be taken care of before messages
-     * can start passing.  This enum reflects the states of the authentication
-     * process and the state can be found in m_authState.  Once authentication
-     * is complete, the auth thread must go away, but it must also be joined,
-     * which is indicated by the AUTH_DONE state.  The state of Read and Write
-     * callbacks is dealt with by the EndpointState.
+     * Before the endpoint is started, the security stuff that must be taken
+     * care of before messages can start passing is handled by a handshake
+     * that the server accept loop advances whenever the socket becomes
+     * readable.  This enum reflects the states of the authentication process
+     * and the state can be found in m_authState.  Once authentication is
+     * complete and the server accept loop has taken note of it, the state
+     * becomes AUTH_DONE.  The state of Read and Write callbacks is dealt with
+     * by the EndpointState.
      */
     enum AuthState {
         AUTH_ILLEGAL = 0,
-        AUTH_INITIALIZED,    /**< This endpoint structure has been allocated but no auth thread has been run */
-        AUTH_AUTHENTICATING, /**< We have spun up an authentication thread and it has begun running our user function */
-        AUTH_FAILED,         /**< The authentication has failed and the authentication thread is exiting immidiately */
+        AUTH_INITIALIZED,    /**< This endpoint structure has been allocated but no handshake has been started */
+        AUTH_AUTHENTICATING, /**< The handshake has been started and is waiting for the remote side */
+        AUTH_FAILED,         /**< The authentication has failed and the handshake has been abandoned */
         AUTH_SUCCEEDED,      /**< The auth process (Establish) has succeeded and the connection is ready to be started */
-        AUTH_DONE,           /**< The auth thread has been successfully shut down and joined */
+        AUTH_DONE,           /**< The server accept loop has taken note of the successful authentication */
     };
 
     /**
-     * There is one dedicated thread and two types callbacks that can be running
-     * around in this data structure.
+     * There are two types of callbacks that can be running around in this
+     * data structure.
      * Read and Write callbacks are used to pump
      * messages through an endpoint.  These callbacks cannot be run until the
      * authentication process has completed.  This enum reflects the states of
@@ -476,7 +472,8 @@ class _TCPEndpoint : public _RemoteEndpoint {
         m_authState(AUTH_INITIALIZED),
         m_epState(EP_INITIALIZED),
         m_tStart(qcc::Timespec<qcc::MonotonicTime>(0)),
-        m_authThread(this),
+        m_authStopping(false),
+        m_gotNulByte(false),
         m_stream(sock),
         m_ipAddr(ipAddr),
         m_port(port) { }
@@ -493,7 +490,8 @@ class _TCPEndpoint : public _RemoteEndpoint {
         m_authState(AUTH_INITIALIZED),
         m_epState(EP_INITIALIZED),
         m_tStart(qcc::Timespec<qcc::MonotonicTime>(0)),
-        m_authThread(this),
+        m_authStopping(false),
+        m_gotNulByte(false),
         m_stream(family, type),
         m_ipAddr(ipAddr),
         m_port(port) { }
@@ -517,7 +515,8 @@ class _TCPEndpoint : public _RemoteEndpoint {
 
     void SetStartTime(qcc::Timespec<qcc::MonotonicTime> tStart) { m_tStart = tStart; }
     qcc::Timespec<qcc::MonotonicTime> GetStartTime(void) { return m_tStart; }
-    QStatus Authenticate(void);
+    QStatus Authenticate(uint32_t authTimeout);
+    void AuthProgress(void);
     void AuthStop(void);
     void AuthJoin(void);
     const qcc::IPAddress& GetIPAddress() { return m_ipAddr; }
@@ -622,248 +621,177 @@ class _TCPEndpoint : public _RemoteEndpoint {
         return _RemoteEndpoint::SetIdleTimeouts(reqIdleTimeout, reqProbeTimeout, maxIdleProbes);
     }
 
-    /*
-     * Return true if the auth thread is STARTED, RUNNING or STOPPING.  A true
-     * response means the authentication thread is in a state that indicates
-     * a possibility it might touch the endpoint data structure.  This means
-     * don't delete the endpoint if this method returns true.  This method
-     * indicates nothing about endpoint Read and WriteCallback state.
-     */
-    bool IsAuthThreadRunning(void)
-    {
-        return m_authThread.IsRunning();
-    }
-    virtual void ThreadExit(qcc::Thread* thread);
-
   private:
-    class AuthThread : public qcc::Thread {
-      public:
-        AuthThread(_TCPEndpoint* ep) : Thread("auth"), m_endpoint(ep)  { }
-      private:
-        virtual qcc::ThreadReturn STDCALL Run(void* arg);
-
-        _TCPEndpoint* m_endpoint;
-    };
+    void AuthFailed(QStatus status);
 
     TCPTransport* m_transport;        /**< The server holding the connection */
     volatile SideState m_sideState;   /**< Is this an active or passive connection */
     volatile AuthState m_authState;   /**< The state of the endpoint authentication process */
     volatile EndpointState m_epState; /**< The state of the endpoint authentication process */
     qcc::Timespec<qcc::MonotonicTime> m_tStart; /**< Timestamp indicating when the authentication process started */
-    AuthThread m_authThread;          /**< Thread used to do blocking calls during startup */
+    volatile bool m_authStopping;     /**< AuthStop() has been called on the handshake */
+    bool m_gotNulByte;                /**< The initial nul byte of the stream has been read */
     qcc::SocketStream m_stream;       /**< Stream used by authentication code */
     qcc::IPAddress m_ipAddr;          /**< Remote IP address. */
     uint16_t m_port;                  /**< Remote port. */
 };
 
-void _TCPEndpoint::ThreadExit(qcc::Thread* thread)
-{
-    /* If the auth thread exits before it even enters the AuthThread::Run() function, set the state to AUTH_FAILED. */
-    if (thread == &m_authThread) {
-        if (m_authState == AUTH_INITIALIZED) {
-            m_authState = AUTH_FAILED;
-        }
-        m_transport->Alert();
-    }
-    _RemoteEndpoint::ThreadExit(thread);
-}
-
-QStatus _TCPEndpoint::Authenticate(void)
+QStatus _TCPEndpoint::Authenticate(uint32_t authTimeout)
 {
     QCC_DbgTrace(("TCPEndpoint::Authenticate()"));
+
     /*
-     * Start the authentication thread.
+     * We're starting an authentication process here that cooperates with the
+     * main server thread.  Rather than dedicating a thread to each
+     * connection, the handshake is a state machine that does not block.  The
+     * server accept loop waits for the socket of every authenticating
+     * endpoint along with its listen sockets and calls AuthProgress() when
+     * the socket becomes readable.  All of the handshake processing therefore
+     * happens on the server thread, which also manages the authList, so there
+     * are no data sharing issues.
+     *
+     * If authentication fails, AuthProgress() sets the state to AUTH_FAILED
+     * and the server will remove the connection from the list of
+     * authenticating connections the next time it runs its Accept loop.  If
+     * authentication succeeds, AuthProgress() calls back into the server
+     * telling it that we are up and running.  It needs to take us off of the
+     * list of authenticating connections and put us on the list of running
+     * connections.  Once the endpoint is started, the Read and WriteCallbacks
+     * of the running RemoteEndpoint take over.
      */
-    QStatus status = m_authThread.Start(this, this);
-    if (status != ER_OK) {
-        m_authState = AUTH_FAILED;
-    }
-    return status;
-}
+    m_authState = AUTH_AUTHENTICATING;
 
-void _TCPEndpoint::AuthStop(void)
-{
-    QCC_DbgTrace(("TCPEndpoint::AuthStop()"));
+    /* Initialize the features for this endpoint */
+    GetFeatures().isBusToBus = false;
+    GetFeatures().handlePassing = false;
 
     /*
-     * Ask the auth thread to stop executing.  The only ways out of the thread
-     * run function will set the state to either AUTH_SUCCEEDED or AUTH_FAILED.
-     * There is a very small chance that we will send a stop to the thread after
-     * it has successfully authenticated, but we expect that this will result in
-     * an AUTH_FAILED state for the vast majority of cases.  In this case, we
-     * notice that the thread failed the next time through the main server run
-     * loop, join the thread via AuthJoin below and delete the endpoint.  Note
-     * that this is a lazy cleanup of the endpoint.
+     * Check any application connecting over TCP to see if it is running on the same machine and
+     * set the group ID appropriately if so.
      */
-    m_authThread.Stop();
+    TCPEndpoint tcpEp = TCPEndpoint::wrap(this);
+    TCPTransport::CheckEndpointLocalMachine(tcpEp);
+
+    DaemonRouter& router = reinterpret_cast<DaemonRouter&>(m_transport->m_bus.GetInternal().GetRouter());
+    AuthListener* authListener = router.GetBusController()->GetAuthListener();
+    /* Since the TCPTransport allows untrusted clients, it must implement UntrustedClientStart and
+     * UntrustedClientExit.
+     * As a part of Establish, the endpoint can call the Transport's UntrustedClientStart method if
+     * it is an untrusted client, so the transport MUST call SetListener before starting the handshake
+     * Note: This is only required on the accepting end i.e. for incoming endpoints.
+     * Thin Client 14.06 or higher uses ANONYMOUS to connect to routing nodes.
+     */
+    SetListener(m_transport);
+    QStatus status = BeginEstablish("ANONYMOUS", authListener, authTimeout);
+    if (status != ER_OK) {
+        m_authState = AUTH_FAILED;
+    }
+    return status;
 }
 
-void _TCPEndpoint::AuthJoin(void)
+void _TCPEndpoint::AuthFailed(QStatus status)
 {
-    QCC_DbgTrace(("TCPEndpoint::AuthJoin()"));
+    QCC_LogError(status, ("Failed to establish TCP endpoint"));
 
     /*
-     * Join the auth thread to stop executing.  All threads must be joined in
-     * order to communicate their return status.  The auth thread is no exception.
-     * This is done in a lazy fashion from the main server accept loop, where we
-     * cleanup every time through the loop.
+     * As soon as we set this state to AUTH_FAILED, we are telling the server
+     * Accept loop that it can get rid of the connection.  Wake it up so that
+     * it does so right away.
      */
-    m_authThread.Join();
+    AbortEstablish();
+    m_authState = AUTH_FAILED;
+    m_transport->Alert();
 }
 
-void* _TCPEndpoint::AuthThread::Run(void* arg)
+void _TCPEndpoint::AuthProgress(void)
 {
-    QCC_UNUSED(arg);
-
-    QCC_DbgTrace(("TCPEndpoint::AuthThread::Run()"));
+    QCC_DbgTrace(("TCPEndpoint::AuthProgress()"));
 
-    m_endpoint->m_authState = AUTH_AUTHENTICATING;
-
-    /*
-     * We're running an authentication process here and we are cooperating with
-     * the main server thread.  This thread is running in an object that is
-     * allocated on the heap, and the server is managing these objects so we
-     * need to coordinate getting all of this cleaned up.
-     *
-     * There is a state variable that only we write.  The server thread only
-     * reads this variable, so there are no data sharing issues.  If there is an
-     * authentication failure, this thread sets that state variable to
-     * AUTH_FAILED and then exits.  The server holds a list of currently
-     * authenticating connections and will look for AUTH_FAILED connections when
-     * it runs its Accept loop.  If it finds one, it will AuthJoin() this
-     * thread.  Since we set AUTH_FAILED immediately before exiting, there will
-     * be no problem having the server block waiting for the Join() to complete.
-     * We fail authentication here and let the server clean up after us, lazily.
-     *
-     * If we succeed in the authentication process, we set the state variable
-     * to AUTH_SUCEEDED and then call back into the server telling it that we are
-     * up and running.  It needs to take us off of the list of authenticating
-     * connections and put us on the list of running connections.  This thread
-     * will quickly go away and will be replaced by the Read and WriteCallbacks of
-     * the running RemoteEndpoint.
-     *
-     * If we are running an authentication process, we are probably ultimately
-     * blocked on a socket.  We expect that if the server is asked to shut
-     * down, it will run through its list of authenticating connections and
-     * AuthStop() each one.  That will cause a thread Stop() which should unblock
-     * all of the reads and return an error which will eventually pop out here
-     * with an authentication failure.
-     *
-     * Finally, if the server decides we've spent too much time here and we are
-     * actually a denial of service attack, it can close us down by doing an
-     * AuthStop() on the authenticating endpoint.  This will do a thread Stop()
-     * on the auth thread of the endpoint which will pop out of here as an
-     * authentication failure as well.  The only ways out of this method must be
-     * with state = AUTH_FAILED or state = AUTH_SUCCEEDED.
-     */
-    uint8_t byte;
-    size_t nbytes;
+    if (m_authState != AUTH_AUTHENTICATING) {
+        return;
+    }
 
-    /*
-     * Eat the first byte of the stream.  This is required to be zero by the
-     * DBus protocol.  It is used in the Unix socket implementation to carry
-     * out-of-band capabilities, but is discarded here.  We do this here since
-     * it involves a read that can block.
-     */
-    QStatus status = m_endpoint->m_stream.PullBytes(&byte, 1, nbytes);
-    if ((status != ER_OK) || (nbytes != 1) || (byte != 0)) {
-        QCC_LogError(status, ("Failed to read first byte from stream"));
+    if (m_authStopping) {
+        AuthFailed(ER_STOPPING_THREAD);
+        return;
+    }
 
+    QStatus status;
+    if (!m_gotNulByte) {
         /*
-         * Management of the resources used by the authentication thread is done
-         * in one place, by the server Accept loop.  The authentication thread
-         * writes its state into the connection and the server Accept loop reads
-         * this state.  As soon as we set this state to AUTH_FAILED, we are
-         * telling the Accept loop that we are done with the conn data
-         * structure.  That thread is then free to do anything it wants with the
-         * connection, including deleting it, so we are not allowed to touch
-         * conn after setting this state.
-         *
-         * In addition to releasing responsibility for the conn data structure,
-         * when we set the state to AUTH_SUCCEEDED we are telling the server
-         * accept loop that we are exiting now and so it can Join() on us (the
-         * authentication thread) without being worried about blocking since the
-         * next thing we do is exit.
+         * Eat the first byte of the stream.  This is required to be zero by the
+         * DBus protocol.  It is used in the Unix socket implementation to carry
+         * out-of-band capabilities, but is discarded here.
          */
-        m_endpoint->m_authState = AUTH_FAILED;
-        return (void*)ER_FAIL;
+        uint8_t byte;
+        size_t nbytes;
+        status = m_stream.PullBytes(&byte, 1, nbytes, 0);
+        if ((status == ER_TIMEOUT) || (status == ER_ALERTED_THREAD)) {
+            return;
+        }
+        if ((status != ER_OK) || (nbytes != 1) || (byte != 0)) {
+            AuthFailed((status != ER_OK) ? status : ER_FAIL);
+            return;
+        }
+        m_gotNulByte = true;
     }
 
-    /* Initialize the features for this endpoint */
-    m_endpoint->GetFeatures().isBusToBus = false;
-    m_endpoint->GetFeatures().isBusToBus = false;
-    m_endpoint->GetFeatures().handlePassing = false;
-
-    /*
-     * Check any application connecting over TCP to see if it is running on the same machine and
-     * set the group ID appropriately if so.
-     */
-    TCPEndpoint tcpEp = TCPEndpoint::wrap(m_endpoint);
-    TCPTransport::CheckEndpointLocalMachine(tcpEp);
-
-    /* Run the actual connection authentication code. */
+    /* Run the actual connection authentication code on whatever has arrived. */
     qcc::String authName;
     qcc::String redirection;
-    DaemonRouter& router = reinterpret_cast<DaemonRouter&>(m_endpoint->m_transport->m_bus.GetInternal().GetRouter());
-    AuthListener* authListener = router.GetBusController()->GetAuthListener();
-    /* Since the TCPTransport allows untrusted clients, it must implement UntrustedClientStart and
-     * UntrustedClientExit.
-     * As a part of Establish, the endpoint can call the Transport's UntrustedClientStart method if
-     * it is an untrusted client, so the transport MUST call m_endpoint->SetListener before calling Establish
-     * Note: This is only required on the accepting end i.e. for incoming endpoints.
-     * Thin Client 14.06 or higher uses ANONYMOUS to connect to routing nodes.
-     */
-    m_endpoint->SetListener(m_endpoint->m_transport);
-    status = m_endpoint->Establish("ANONYMOUS", authName, redirection, authListener);
+    status = ContinueEstablish(authName, redirection);
+    if (status == ER_WOULDBLOCK) {
+        return;
+    }
     if (status != ER_OK) {
-        QCC_LogError(status, ("Failed to establish TCP endpoint"));
-
-        /*
-         * Management of the resources used by the authentication thread is done
-         * in one place, by the server Accept loop.  The authentication thread
-         * writes its state into the connection and the server Accept loop reads
-         * this state.  As soon as we set this state to AUTH_FAILED, we are
-         * telling the Accept loop that we are done with the conn data
-         * structure.  That thread is then free to do anything it wants with the
-         * connection, including deleting it, so we are not allowed to touch
-         * conn after setting this state.
-         *
-         * In addition to releasing responsibility for the conn data structure,
-         * when we set the state to AUTH_SUCCEEDED we are telling the server
-         * accept loop that we are exiting now and so it can Join() on us (the
-         * authentication thread) without being worried about blocking since the
-         * next thing we do is exit.
-         */
-        m_endpoint->m_authState = AUTH_FAILED;
-        return (void*)status;
+        AuthFailed(status);
+        return;
     }
 
     /*
      * Tell the transport that the authentication has succeeded and that it can
      * now bring the connection up.
      */
-    m_endpoint->m_transport->Authenticated(tcpEp);
+    TCPEndpoint tcpEp = TCPEndpoint::wrap(this);
+    m_transport->Authenticated(tcpEp);
+
+    /*
+     * We have succeeded doing the authentication and we may or may not have
+     * succeeded in starting the endpoint Read and WriteCallbacks depending on
+     * what happened down in Authenticated().  The server accept loop notices
+     * AUTH_SUCCEEDED the next time it manages the endpoint list.
+     */
+    m_authState = AUTH_SUCCEEDED;
+}
 
-    QCC_DbgTrace(("TCPEndpoint::AuthThread::Run(): Returning"));
+void _TCPEndpoint::AuthStop(void)
+{
+    QCC_DbgTrace(("TCPEndpoint::AuthStop()"));
 
     /*
-     * We are now done with the authentication process.  We have succeeded doing
-     * the authentication and we may or may not have succeeded in starting the
-     * endpoint TX and RX threads depending on what happened down in
-     * Authenticated().  What concerns us here is that we are done with this
-     * thread (the authentication thread) and we are about to exit.  Before
-     * exiting, we must tell server accept loop that we are done with this data
-     * structure.  As soon as we set this state to AUTH_SUCCEEDED that thread is
-     * then free to do anything it wants with the connection, including deleting
-     * it, so we are not allowed to touch conn after setting this state.
-     *
-     * In addition to releasing responsibility for the conn data structure, when
-     * we set the state to AUTH_SUCCEEDED we are telling the server accept loop
-     * that we are exiting now and so it can Join() the authentication thread
-     * without being worried about blocking since the next thing we do is exit.
+     * Ask the handshake to stop.  AuthStop() can be called from any thread
+     * while the handshake itself is only ever touched by the server accept
+     * loop, so we just leave a note here.  The handshake fails the next time
+     * it is advanced or is abandoned by AuthJoin() below.
      */
-    m_endpoint->m_authState = AUTH_SUCCEEDED;
-    return (void*)status;
+    m_authStopping = true;
+}
+
+void _TCPEndpoint::AuthJoin(void)
+{
+    QCC_DbgTrace(("TCPEndpoint::AuthJoin()"));
+
+    /*
+     * There is no thread to join since the handshake is driven by the server
+     * accept loop.  This is called either from that loop or after it has
+     * exited, so it is safe to abandon a handshake that did not complete.
+     * The handshake holds a reference to the endpoint which must be released
+     * for the endpoint to be deleted.
+     */
+    AbortEstablish();
+    if (m_authState == AUTH_AUTHENTICATING) {
+        m_authState = AUTH_FAILED;
+    }
 }
 
 TCPTransport::TCPTransport(BusAttachment& bus)
@@ -901,7 +829,7 @@ void TCPTransport::Authenticated(TCPEndpoint& conn)
     }
     /*
      * If Authenticated() is being called, it is as a result of the
-     * authentication thread telling us that it has succeeded.  What we need to
+     * authentication handshake telling us that it has succeeded.  What we need to
      * do here is to try and Start() the endpoint which will set up
      * Read and WriteCallbacks and register the endpoint with the daemon router.
      * As soon as we call Start(), we are transferring responsibility for error reporting
@@ -1114,11 +1042,11 @@ QStatus TCPTransport::Stop(void)
     }
 
     /*
-     * Ask any authenticating endpoints to shut down and exit their threads.  By its
-     * presence on the m_authList, we know that the endpoint is authenticating and
-     * the authentication thread has responsibility for dealing with the endpoint
-     * data structure.  We call Stop() to stop that thread from running.  The
-     * endpoint Read and WriteCallbacks will not be running yet.
+     * Ask any authenticating endpoints to shut down.  By its presence on the
+     * m_authList, we know that the endpoint is authenticating and the server
+     * accept loop has responsibility for dealing with the endpoint data
+     * structure.  We call AuthStop() to stop the handshake.  The endpoint Read
+     * and WriteCallbacks will not be running yet.
      */
     for (set<TCPEndpoint>::iterator i = m_authList.begin(); i != m_authList.end(); ++i) {
         TCPEndpoint ep = *i;
@@ -1179,20 +1107,20 @@ QStatus TCPTransport::Join(void)
      * running in those endpoints actually stop running.
      *
      * Since Stop() is a request to stop, and this is what has ultimately been
-     * done to both authentication threads and Read and WriteCallbacks, it is possible
-     * that a thread is actually running after the call to Stop().  If that
-     * thread happens to be an authenticating endpoint, it is possible that an
-     * authentication actually completes after Stop() is called.  This will move
-     * a connection from the m_authList to the m_endpointList, so we need to
-     * make sure we wait for all of the connections on the m_authList to go away
-     * before we look for the connections on the m_endpointlist.
+     * done to both authenticating endpoints and Read and WriteCallbacks, it is
+     * possible that an authentication actually completes after Stop() is
+     * called.  This will move a connection from the m_authList to the
+     * m_endpointList, so we need to make sure all of the connections on the
+     * m_authList go away before we look for the connections on the
+     * m_endpointlist.
      */
     m_endpointListLock.Lock(MUTEX_CONTEXT);
 
     /*
-     * Any authenticating endpoints have been asked to shut down and exit their
-     * authentication threads in a previously required Stop().  We need to
-     * Join() all of these auth threads here.
+     * Any authenticating endpoints have been asked to shut down in a
+     * previously required Stop().  The server accept loop that drives their
+     * handshakes has been joined above, so we abandon whatever is left of
+     * the handshakes here.
      */
     set<TCPEndpoint>::iterator it = m_authList.begin();
     while (it != m_authList.end()) {
@@ -1541,10 +1469,9 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
 
         if (authState == _TCPEndpoint::AUTH_FAILED) {
             /*
-             * The endpoint has failed authentication and the auth thread is
-             * gone or is going away.  Since it has failed there is no way this
-             * endpoint is going to be started so we can get rid of it as soon
-             * as we Join() the (failed) authentication thread.
+             * The endpoint has failed authentication.  Since it has failed
+             * there is no way this endpoint is going to be started so we can
+             * get rid of it as soon as we AuthJoin() the (failed) handshake.
              */
             QCC_DbgHLPrintf(("TCPTransport::ManageEndpoints(): Scavenging failed authenticator"));
             m_authList.erase(i);
@@ -1559,28 +1486,25 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
         Timespec<MonotonicTime> tNow;
         GetTimeNow(&tNow);
 
-        if (ep->GetStartTime() + authTimeout < tNow) {
+        if ((authState == _TCPEndpoint::AUTH_AUTHENTICATING) && (ep->GetStartTime() + authTimeout < tNow)) {
             /*
              * This endpoint is taking too long to authenticate.  Stop the
-             * authentication process.  The auth thread is still running, so we
-             * can't just delete the connection, we need to let it stop in its
-             * own time.  What that thread will do is to set AUTH_FAILED and
-             * exit.  we will then clean it up the next time through this loop.
-             * In the hope that the thread can exit and we can catch its exit
-             * here and now, we take our thread off the OS ready list (Sleep)
-             * and let the other thread run before looping back.
+             * authentication process.  Since the handshake is only ever
+             * advanced on this thread, stopping it fails it right away, so we
+             * look at the same endpoint again to clean it up.
              */
             QCC_DbgHLPrintf(("TCPTransport::ManageEndpoints(): Scavenging slow authenticator"));
             ep->AuthStop();
-            qcc::Sleep(1);
+            ep->AuthProgress();
+            continue;
         }
         ++i;
     }
 
     /*
      * We've handled the authList, so now run through the list of connections on
-     * the endpointList and cleanup any that are no longer running or Join()
-     * authentication threads that have successfully completed.
+     * the endpointList and cleanup any that are no longer running or take note
+     * of authentications that have successfully completed.
      */
     i = m_endpointList.begin();
     while (i != m_endpointList.end()) {
@@ -1601,11 +1525,9 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
 
         if (authState == _TCPEndpoint::AUTH_SUCCEEDED) {
             /*
-             * The endpoint has succeeded authentication and the auth thread is
-             * gone or is going away.  Take this opportunity to join the auth
-             * thread.  Since the auth thread promised not to touch the state
-             * after setting AUTH_SUCCEEEDED, we can safely change the state
-             * here since we now own the conn.  We do this through a method call
+             * The endpoint has succeeded authentication.  Take this
+             * opportunity to note that the handshake is done and to start the
+             * clock on the session setup.  We do this through a method call
              * to enable this single special case where we are allowed to set
              * the state.
              */
@@ -1662,7 +1584,7 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
          * the endpoint threads, remove the endpoint from the
          * endpoint list and delete it.  Note that we are calling
          * the endpoint Join() to join the TX and RX threads and not
-         * the endpoint AuthJoin() to join the auth thread.
+         * the endpoint AuthJoin() to abandon the handshake.
          */
         if (endpointState == _TCPEndpoint::EP_STOPPING) {
             m_endpointList.erase(i);
@@ -1772,16 +1694,46 @@ void* TCPTransport::Run(void* arg)
         }
         m_listenFdsLock.Unlock(MUTEX_CONTEXT);
 
+        /*
+         * We also wait on the SocketFds of the connections that are in the
+         * middle of authenticating, since it is this thread that advances
+         * their handshakes.  Each endpoint already has an event for its
+         * socket, the source event of its stream, so nothing is allocated
+         * for them here.  The wait is bounded by the first of those
+         * handshakes to run out of time so that slow authenticators are
+         * scavenged even if nothing else happens.
+         */
+        map<Event*, TCPEndpoint> authEvents;
+        uint32_t maxWait = Event::WAIT_FOREVER;
+        m_endpointListLock.Lock(MUTEX_CONTEXT);
+        for (set<TCPEndpoint>::iterator i = m_authList.begin(); i != m_authList.end(); ++i) {
+            TCPEndpoint ep = *i;
+            if (ep->GetAuthState() != _TCPEndpoint::AUTH_AUTHENTICATING) {
+                continue;
+            }
+            Event* authEvent = &ep->m_stream.GetSourceEvent();
+            checkEvents.push_back(authEvent);
+            authEvents.insert(pair<Event*, TCPEndpoint>(authEvent, ep));
+            uint32_t remaining = ep->GetEstablishTimeRemaining();
+            if (remaining != Event::WAIT_FOREVER) {
+                maxWait = min(maxWait, remaining + 1);
+            }
+        }
+        m_endpointListLock.Unlock(MUTEX_CONTEXT);
+
         /*
          * We have our list of events, so now wait for something to happen
          * on that list (or get alerted).
          */
         signaledEvents.clear();
 
-        status = Event::Wait(checkEvents, signaledEvents);
+        status = Event::Wait(checkEvents, signaledEvents, maxWait);
+        if (ER_TIMEOUT == status) {
+            status = ER_OK;
+        }
         if (ER_OK != status) {
             for (vector<Event*>::iterator i = checkEvents.begin(); i != checkEvents.end(); ++i) {
-                if (*i != &stopEvent) {
+                if ((*i != &stopEvent) && (authEvents.find(*i) == authEvents.end())) {
                     delete *i;
                 }
             }
@@ -1800,24 +1752,33 @@ void* TCPTransport::Run(void* arg)
          * difference can be found by a call to IsStopping() which is found
          * above.  An alert means that a request to start or stop listening
          * on a given address and port has been queued up for us.
+         *
+         * The stopEvent may get set indirectly by ManageEndpoints below, so
+         * make sure to reset it before calling ManageEndpoints.
+         */
+        if (find(signaledEvents.begin(), signaledEvents.end(), &stopEvent) != signaledEvents.end()) {
+            stopEvent.ResetEvent();
+        }
+
+        /*
+         * In order to rationalize management of resources, we manage the
+         * various lists in one place on one thread.  This thread is a
+         * convenient victim, so we do it here.
          */
+        ManageEndpoints(authTimeout, sessionSetupTimeout);
+
         for (vector<Event*>::iterator i = signaledEvents.begin(); i != signaledEvents.end(); ++i) {
-            /*
-             * The stopEvent may get set indirectly by ManageEndpoints below, so
-             * make sure to reset it before calling ManageEndpoints.
-             */
             if (*i == &stopEvent) {
-                stopEvent.ResetEvent();
+                continue;
             }
 
             /*
-             * In order to rationalize management of resources, we manage the
-             * various lists in one place on one thread.  This thread is a
-             * convenient victim, so we do it here.
+             * Data has arrived on the connection of an authenticating
+             * endpoint, so advance its handshake as far as it will go.
              */
-            ManageEndpoints(authTimeout, sessionSetupTimeout);
-
-            if (*i == &stopEvent) {
+            map<Event*, TCPEndpoint>::iterator ae = authEvents.find(*i);
+            if (ae != authEvents.end()) {
+                ae->second->AuthProgress();
                 continue;
             }
 
@@ -1859,20 +1820,21 @@ void* TCPTransport::Run(void* arg)
                     GetTimeNow(&tNow);
                     conn->SetStartTime(tNow);
                     /*
-                     * By putting the connection on the m_authList, we are
-                     * transferring responsibility for the connection to the
-                     * Authentication thread.  Therefore, we must check that the
-                     * thread actually started running to ensure the handoff
-                     * worked.  If it didn't we need to deal with the connection
-                     * here.  Since there are no threads running we can just
-                     * pitch the connection.
+                     * By putting the connection on the m_authList, this
+                     * loop takes on the job of advancing its handshake.  We
+                     * must check that the handshake actually started.  If it
+                     * didn't we need to deal with the connection here.
+                     * Since nothing else is using it we can just pitch the
+                     * connection.
                      */
-                    std::pair<std::set<TCPEndpoint>::iterator, bool> ins = m_authList.insert(conn);
-                    status = conn->Authenticate();
+                    m_authList.insert(conn);
+                    m_endpointListLock.Unlock(MUTEX_CONTEXT);
+                    status = conn->Authenticate(authTimeout);
                     if (status != ER_OK) {
-                        m_authList.erase(ins.first);
+                        m_endpointListLock.Lock(MUTEX_CONTEXT);
+                        m_authList.erase(conn);
+                        m_endpointListLock.Unlock(MUTEX_CONTEXT);
                     }
-                    m_endpointListLock.Unlock(MUTEX_CONTEXT);
                 } else {
                     m_endpointListLock.Unlock(MUTEX_CONTEXT);
                     qcc::SetLinger(newSock, true, 0);
@@ -1898,10 +1860,11 @@ void* TCPTransport::Run(void* arg)
         /*
          * We're going to loop back and create a new list of checkEvents that
          * reflect the current state, so we need to delete the checkEvents we
-         * created on this iteration.
+         * created on this iteration.  The events of the authenticating
+         * endpoints belong to their streams.
          */
         for (vector<Event*>::iterator i = checkEvents.begin(); i != checkEvents.end(); ++i) {
-            if (*i != &stopEvent) {
+            if ((*i != &stopEvent) && (authEvents.find(*i) == authEvents.end())) {
                 delete *i;
             }
         }
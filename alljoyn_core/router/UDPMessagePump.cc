@@ -0,0 +1,333 @@
+/**
+ * @file
+ * MessagePump moves messages received by the UDP Transport into the router on
+ * a bounded pool of worker threads.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+#include <qcc/Debug.h>
+
+#include "UDPMessagePump.h"
+
+#define QCC_MODULE "UDP"
+
+using namespace std;
+using namespace qcc;
+
+namespace ajn {
+
+MessagePump::MessagePump(uint32_t maxThreads)
+    : m_lock(), m_threads(), m_maxThreads(maxThreads ? maxThreads : 1), m_idleThreads(0), m_busyThreads(0),
+    m_peakBusyThreads(0), m_queues(), m_ready(), m_queued(0), m_peakQueued(0), m_dispatched(0), m_condition(), m_stopping(false)
+{
+    QCC_DbgTrace(("MessagePump::MessagePump(maxThreads=%d.)", maxThreads));
+}
+
+MessagePump::~MessagePump()
+{
+    QCC_DbgTrace(("MessagePump::~MessagePump()"));
+    QCC_ASSERT(m_queues.empty() && "MessagePump::~MessagePump(): Message queues must be empty here");
+    QCC_ASSERT(m_threads.empty() && "MessagePump::~MessagePump(): Pump threads must be gone here");
+}
+
+/*
+ * Determine whether or not there is a pump thread currently dispatching
+ * a message.
+ */
+bool MessagePump::IsActive()
+{
+    QCC_DbgTrace(("MessagePump::IsActive()"));
+    m_lock.Lock();
+    bool ret = m_busyThreads != 0;
+    m_lock.Unlock();
+    QCC_DbgPrintf(("MessagePump::IsActive() => \"%s\"", ret ? "true" : "false"));
+    return ret;
+}
+
+/*
+ * The Message Pump doesn't inherit from qcc::Thread so it isn't going to
+ * Start(), Stop() and Join() direcly.  It HASA pool of threads that are
+ * Start()ed on-demand.  We do implement Stop() to allow us to do something
+ * when we need to cause the pump threads to stop.
+ */
+QStatus MessagePump::Stop()
+{
+    QCC_DbgTrace(("MessagePump::Stop()"));
+    QStatus status = ER_OK;
+
+    /*
+     * The pump threads aren't going to be waiting on their stop events.
+     * In order to minimize the number of events we create, they will be
+     * waiting on a condition variable and then test for stopping whenever
+     * they wake up.  So we have to call Stop() to set the state and then
+     * Broadcast() our condition variable to wake up all of the threads.
+     */
+    m_lock.Lock();
+    m_stopping = true;
+    for (std::vector<PumpThread*>::iterator i = m_threads.begin(); i != m_threads.end(); ++i) {
+        (*i)->Stop();
+    }
+    m_condition.Broadcast();
+    m_lock.Unlock();
+
+    QCC_DbgTrace(("MessagePump::Stop() => \"%s\"", QCC_StatusText(status)));
+    return status;
+}
+
+/*
+ * The Message Pump doesn't inherit from qcc::Thread so it isn't going to
+ * Start(), Stop() and Join() direcly.  We implement Join() to allow us to
+ * join *all* of the pump threads when we need the pump to shut down.  Since
+ * Stop() has been called, RecvCb() will not spin up any more threads.
+ */
+QStatus MessagePump::Join()
+{
+    QCC_DbgTrace(("MessagePump::Join()"));
+    QStatus status = ER_OK;
+
+    m_lock.Lock();
+    QCC_ASSERT((m_stopping || m_threads.empty()) && "MessagePump::Join(): Must Stop() before Join()");
+    std::vector<PumpThread*> threads;
+    threads.swap(m_threads);
+    m_lock.Unlock();
+
+    for (std::vector<PumpThread*>::iterator i = threads.begin(); i != threads.end(); ++i) {
+        QStatus jstatus = (*i)->Join();
+        if (jstatus != ER_OK) {
+            QCC_LogError(jstatus, ("MessagePump::Join: PumpThread Join() error"));
+            status = jstatus;
+        }
+        delete *i;
+    }
+
+    QCC_DbgPrintf(("MessagePump::Join() => \"%s\"", QCC_StatusText(status)));
+    return status;
+}
+
+void MessagePump::RecvCb(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId, ArdpRcvBuf* rcv, QStatus status)
+{
+    QCC_DbgTrace(("MessagePump::RecvCb(handle=%p, conn=%p, connId=%d., rcv=%p, status=%s)", handle, conn, connId, rcv, QCC_StatusText(status)));
+
+    QCC_ASSERT(status == ER_OK && "MessagePump::RecvCb(): Asked to dispatch an error!?");
+
+    /*
+     * We always want to pump the message in the callback so create a queue
+     * entry and push it onto the queue for its connection.  If the
+     * connection did not already have queued messages it is not owned by
+     * any pump thread, so we put it on the tail of the ready list.  If we
+     * are stopping we still queue the message; it will be handled when the
+     * pump is cleaned up.
+     */
+    m_lock.Lock();
+    std::queue<QueueEntry>& q = m_queues[connId];
+    bool wasIdle = q.empty();
+    q.push(QueueEntry(handle, conn, connId, rcv, status));
+    if (wasIdle) {
+        m_ready.push_back(connId);
+    }
+    ++m_queued;
+    if (m_queued > m_peakQueued) {
+        m_peakQueued = m_queued;
+    }
+
+    /*
+     * RecvCb() callbacks can continue to happen after we have stopped the
+     * pump threads, so make sure we don't spin up a new thread after we
+     * acknowledge a Stop() request.
+     */
+    if (m_stopping) {
+        QCC_DbgPrintf(("MessagePump::RecvCb(): Stopping"));
+        m_lock.Unlock();
+        return;
+    }
+
+    /*
+     * If every existing pump thread is busy and we have room in the pool,
+     * spin up another one.  What happens if we can allocate a pump thread
+     * object but we can't start the pump thread?  We can't block ARDP
+     * trying again here, so we just leave the message queued.  Either an
+     * existing thread will get to it when it frees up, or the next incoming
+     * message will try to spin up a thread again.  If we cannot spin up a
+     * thread, we have bigger problems than a temporarily stalled message.
+     */
+    if (m_idleThreads == 0 && m_threads.size() < m_maxThreads) {
+        QCC_DbgPrintf(("MessagePump::RecvCb(): Spin up new PumpThread"));
+        PumpThread* pt = new PumpThread(this);
+        status = pt->Start(NULL, NULL);
+        if (status != ER_OK) {
+            QCC_LogError(status, ("MessagePump::RecvCb(): Unable to start PumpThread"));
+            delete pt;
+        } else {
+            m_threads.push_back(pt);
+        }
+    }
+
+    QCC_DbgPrintf(("MessagePump::RecvCb(): threads=%d., idle=%d., queued=%d.", m_threads.size(), m_idleThreads, m_queued));
+
+    /*
+     * Signal the condition to wake up an existing thread that may be asleep
+     * waiting for something to do.
+     */
+    m_condition.Signal();
+    m_lock.Unlock();
+}
+
+/*
+ * Take a snapshot of the pool utilization and queue depth statistics.
+ */
+void MessagePump::GetStats(UDPTransport::MessagePumpStats& stats)
+{
+    m_lock.Lock();
+    stats.maxThreads = m_maxThreads;
+    stats.threads = m_threads.size();
+    stats.busyThreads = m_busyThreads;
+    stats.peakBusyThreads = m_peakBusyThreads;
+    stats.queuedMessages = m_queued;
+    stats.peakQueuedMessages = m_peakQueued;
+    stats.queuedConnections = m_queues.size();
+    stats.dispatchedMessages = m_dispatched;
+    m_lock.Unlock();
+}
+
+/*
+ * Anything left on the per-connection queues is given back in the order we
+ * received it.
+ */
+void MessagePump::ReleaseQueued()
+{
+    QCC_DbgTrace(("MessagePump::ReleaseQueued()"));
+    m_lock.Lock();
+    QCC_ASSERT(m_threads.empty() && "MessagePump::ReleaseQueued(): Must Join() before ReleaseQueued()");
+    std::map<uint32_t, std::queue<QueueEntry> > queues;
+    std::deque<uint32_t> ready;
+    queues.swap(m_queues);
+    ready.swap(m_ready);
+    m_queued = 0;
+    m_lock.Unlock();
+
+    while (ready.empty() == false) {
+        std::map<uint32_t, std::queue<QueueEntry> >::iterator i = queues.find(ready.front());
+        ready.pop_front();
+        if (i == queues.end()) {
+            continue;
+        }
+        while (i->second.empty() == false) {
+            Release(i->second.front());
+            i->second.pop();
+        }
+        queues.erase(i);
+    }
+    QCC_ASSERT(queues.empty() && "MessagePump::ReleaseQueued(): Queued messages on a connection that is not ready");
+}
+
+/*
+ * A thread function to move received messages from the per-connection queues
+ * of a message pump into the router.
+ */
+ThreadReturn STDCALL MessagePump::PumpThread::Run(void* arg)
+{
+    QCC_UNUSED(arg);
+
+    QCC_DbgTrace(("MessagePump::PumpThread::Run()"));
+    QCC_ASSERT(m_pump && "MessagePump::PumpThread::Run(): pointer to enclosing pump must be specified");
+
+    /*
+     * We need to implement a classic condition variable idiom.  Here the mutex
+     * is the m_lock mutex member variable and the condition that needs to be
+     * met is "some connection on the ready list."  We live inside a while loop
+     * and execute until we are asked to stop.  Pool threads do not exit when
+     * idle; that is the whole point of having a pool.
+     *
+     * Note that IsStopping() is a call to the thread base class that indicates
+     * the underlying thread has received a Stop() request.  The member variable
+     * m_stopping is a boolean we use to synchronize the pump threads and any
+     * RecvCb() callbacks we might get from the UDP Transport dispatcher thread.
+     */
+    m_pump->m_lock.Lock();
+    while (!m_pump->m_stopping && !IsStopping()) {
+        QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Top."));
+        /*
+         * Note that if the condition returns an unexpected status we loop in
+         * the hope that it is recoverable.
+         */
+        while (m_pump->m_ready.empty() && !m_pump->m_stopping && !IsStopping()) {
+            QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Wait for condition"));
+            ++m_pump->m_idleThreads;
+            QStatus status = m_pump->m_condition.Wait(m_pump->m_lock);
+            --m_pump->m_idleThreads;
+            QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Wait returns \"%s\"", QCC_StatusText(status)));
+        }
+
+        QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Done with wait."));
+
+        if (m_pump->m_stopping || IsStopping()) {
+            continue;
+        }
+
+        /*
+         * Take ownership of the connection at the head of the ready list and
+         * pull the entry describing its oldest message off its queue.  Nobody
+         * else can dispatch on this connection until we put it back on the
+         * ready list, which is what keeps its messages in order.
+         */
+        QCC_DbgTrace(("MessagePump::PumpThread::Run(): Have work."));
+        uint32_t connId = m_pump->m_ready.front();
+        m_pump->m_ready.pop_front();
+        std::map<uint32_t, std::queue<QueueEntry> >::iterator qi = m_pump->m_queues.find(connId);
+        QCC_ASSERT(qi != m_pump->m_queues.end() && qi->second.empty() == false && "MessagePump::PumpThread::Run(): Ready connection with no queued messages");
+        QueueEntry entry = qi->second.front();
+        --m_pump->m_queued;
+
+        ++m_pump->m_busyThreads;
+        if (m_pump->m_busyThreads > m_pump->m_peakBusyThreads) {
+            m_pump->m_peakBusyThreads = m_pump->m_busyThreads;
+        }
+        m_pump->m_lock.Unlock();
+
+        m_pump->Dispatch(entry);
+
+        m_pump->m_lock.Lock();
+        --m_pump->m_busyThreads;
+        ++m_pump->m_dispatched;
+
+        /*
+         * We only pop the entry now so that RecvCb() sees a non-empty queue
+         * while we are dispatching and doesn't put the connection back on the
+         * ready list behind our back.  If there is more to do for this
+         * connection, it goes to the tail of the ready list so other
+         * connections get their turn.
+         */
+        qi = m_pump->m_queues.find(connId);
+        QCC_ASSERT(qi != m_pump->m_queues.end() && "MessagePump::PumpThread::Run(): Owned connection queue disappeared");
+        qi->second.pop();
+        if (qi->second.empty()) {
+            m_pump->m_queues.erase(qi);
+        } else {
+            m_pump->m_ready.push_back(connId);
+            m_pump->m_condition.Signal();
+        }
+    }
+
+    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Exiting"));
+    m_pump->m_lock.Unlock();
+    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Return"));
+    return 0;
+}
+
+} // namespace ajn
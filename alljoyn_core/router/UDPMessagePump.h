@@ -0,0 +1,197 @@
+/**
+ * @file
+ * MessagePump moves messages received by the UDP Transport into the router on
+ * a bounded pool of worker threads.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _ALLJOYN_UDPMESSAGEPUMP_H
+#define _ALLJOYN_UDPMESSAGEPUMP_H
+
+#ifndef __cplusplus
+#error Only include UDPMessagePump.h in C++ code.
+#endif
+
+#include <deque>
+#include <map>
+#include <queue>
+#include <vector>
+
+#include <qcc/platform.h>
+#include <qcc/Condition.h>
+#include <qcc/Mutex.h>
+#include <qcc/Thread.h>
+
+#include <alljoyn/Status.h>
+
+#include "ArdpProtocol.h"
+#include "UDPTransport.h"
+
+namespace ajn {
+
+/**
+ * A class to encapsulate the queues of messages to be dispatched and an
+ * associated fixed-size pool of worker threads to pump the messages.
+ *
+ * Each connection ID has its own FIFO queue of received messages.  A
+ * connection with queued messages is placed on the ready list exactly once,
+ * and a worker that takes it off the ready list owns it until it has
+ * dispatched one message.  If more messages are queued after that, the
+ * connection goes back to the tail of the ready list.  This pins a connection
+ * to at most one worker at any time, which preserves message ordering at the
+ * destination, while a slow reader on one connection only ties up a single
+ * worker.
+ *
+ * Workers are started lazily (only when all of the existing workers are busy
+ * and there is work waiting) up to the configured maximum, and then stay
+ * around until the pump is stopped.
+ *
+ * What it means to dispatch a message, and to give back a message that was
+ * never dispatched, is left to the derived class.
+ */
+class MessagePump {
+  public:
+
+    /**
+     * Construct a message pump.
+     *
+     * @param maxThreads  The maximum number of pump threads in the pool.
+     */
+    MessagePump(uint32_t maxThreads);
+
+    /**
+     * Destructor.  The derived class must have stopped and joined the pump
+     * and called ReleaseQueued() by the time this runs.
+     */
+    virtual ~MessagePump();
+
+    /**
+     * Determine whether or not there is a pump thread currently dispatching
+     * a message.
+     *
+     * @return  true if a pump thread is busy.
+     */
+    bool IsActive();
+
+    /**
+     * Ask all of the pump threads to stop.  Messages received from now on are
+     * queued but not dispatched.
+     *
+     * @return  ER_OK.
+     */
+    QStatus Stop();
+
+    /**
+     * Join all of the pump threads.  Stop() must have been called.
+     *
+     * @return  ER_OK or the status of the first failed Join().
+     */
+    QStatus Join();
+
+    /**
+     * Queue a received message for dispatch on its connection.
+     *
+     * @param handle  The ARDP handle the message was received on.
+     * @param conn    The ARDP connection the message was received on.
+     * @param connId  The ID of the connection, which determines the ordering.
+     * @param rcv     The received message buffers.
+     * @param status  The receive status.
+     */
+    void RecvCb(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId, ArdpRcvBuf* rcv, QStatus status);
+
+    /**
+     * Take a snapshot of the pool utilization and queue depth statistics.
+     *
+     * @param[out] stats  The current statistics.
+     */
+    void GetStats(UDPTransport::MessagePumpStats& stats);
+
+  protected:
+
+    /**
+     * A received message waiting to be dispatched.
+     */
+    class QueueEntry {
+      public:
+        QueueEntry(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId, ArdpRcvBuf* rcv, QStatus status)
+            : m_handle(handle), m_conn(conn), m_connId(connId), m_rcv(rcv), m_status(status) { }
+
+        ArdpHandle* m_handle;
+        ArdpConnRecord* m_conn;
+        uint32_t m_connId;
+        ArdpRcvBuf* m_rcv;
+        QStatus m_status;
+    };
+
+    /**
+     * Dispatch a message.  Called on a pump thread without the pump lock held.
+     * No other message of the same connection is dispatched at the same time.
+     *
+     * @param entry  The message to dispatch.
+     */
+    virtual void Dispatch(QueueEntry& entry) = 0;
+
+    /**
+     * Give back a message that is never going to be dispatched.  Called from
+     * ReleaseQueued().
+     *
+     * @param entry  The message to give back.
+     */
+    virtual void Release(QueueEntry& entry) = 0;
+
+    /**
+     * Release() every message that is still queued, connection by connection
+     * in the order the messages were received.  Must be called after Join().
+     */
+    void ReleaseQueued();
+
+  private:
+
+    /* Private copy constructor and assignment operator to prevent copying */
+    MessagePump(const MessagePump& other);
+    MessagePump& operator=(const MessagePump& other);
+
+    class PumpThread : public qcc::Thread {
+      public:
+        PumpThread(MessagePump* pump) : qcc::Thread(qcc::String("PumpThread")), m_pump(pump) { }
+
+      protected:
+        qcc::ThreadReturn STDCALL Run(void* arg);
+
+      private:
+        MessagePump* m_pump;
+    };
+
+    qcc::Mutex m_lock;                      /**< Mutex that protects multithread access to the queues */
+    std::vector<PumpThread*> m_threads;     /**< The pool of pump threads that have been spawned but not joined */
+    uint32_t m_maxThreads;                  /**< The maximum number of pump threads in the pool */
+    uint32_t m_idleThreads;                 /**< The number of pump threads waiting for work */
+    uint32_t m_busyThreads;                 /**< The number of pump threads calling out to an endpoint */
+    uint32_t m_peakBusyThreads;             /**< High water mark of m_busyThreads */
+    std::map<uint32_t, std::queue<QueueEntry> > m_queues; /**< Per connection ID queues of received messages to dispatch to the router */
+    std::deque<uint32_t> m_ready;           /**< Connection IDs with queued messages that are not owned by a pump thread */
+    uint32_t m_queued;                      /**< The total number of messages on all of the queues */
+    uint32_t m_peakQueued;                  /**< High water mark of m_queued */
+    uint64_t m_dispatched;                  /**< The number of messages dispatched by the pump threads */
+    qcc::Condition m_condition;             /**< Condition variable coordinating consumption of queue entries by the pump threads */
+    bool m_stopping;                        /**< True if Stop() has been called and we shouldn't spin up new threads */
+};
+
+} // namespace ajn
+
+#endif
@@ -20,6 +20,10 @@
  ******************************************************************************/
 
 #include <algorithm>
+#include <deque>
+#include <map>
+#include <queue>
+#include <vector>
 #include <qcc/platform.h>
 #include <qcc/IPAddress.h>
 #include <qcc/Socket.h>
@@ -45,6 +49,7 @@
 #include "ArdpProtocol.h"
 #include "ns/IpNameService.h"
 #include "UDPTransport.h"
+#include "UDPMessagePump.h"
 
 #if ARDP_TESTHOOKS
 #include "ScatterGatherList.h"
@@ -444,7 +449,7 @@ const uint32_t UDP_ENDPOINT_MANAGEMENT_TIMER = 1000;  /** Maximum time between c
 const uint32_t UDP_ENDPOINT_MANAGEMENT_MIN = 100;  /** There's really no reason to run the management faster than this */
 const uint32_t UDP_WAIT_WATCHDOG_TIMEOUT = 5000; /** Max time in EP_WAITING state before giving up on sending msgs */
 const uint32_t UDP_WATCHDOG_TIMEOUT = 30000;  /**< How long to wait before printing an error if an endpoint is not going away */
-const uint32_t UDP_MESSAGE_PUMP_TIMEOUT = 10000;  /**< How long to keep a message pump thread running with nothing to do */
+const uint32_t UDP_MESSAGE_PUMP_THREADS = 8;  /**< The maximum number of message pump threads moving messages into the router */
 
 const uint32_t UDP_CONNECT_TIMEOUT = 1000;  /**< How long before we expect a connection to complete */
 const uint32_t UDP_CONNECT_RETRIES = 10;  /**< How many times do we retry a connection before giving up */
@@ -1555,8 +1560,8 @@ bool operator<(const ArdpStream::ThreadEntry& lhs, const ArdpStream::ThreadEntry
 }
 
 /*
- * A class to encapsulate a queue of messages to be dispatched and an associated
- * thread to pump the messages.
+ * The MessagePump (see UDPMessagePump.h) specialized to dispatch messages to
+ * the UDP endpoints of a transport.
  *
  * Whevever we have an AllJoyn Message that is ready for delivery, ideally we
  * would just hand it off to the daemon router by calling PushMessage and the
@@ -1577,365 +1582,42 @@ bool operator<(const ArdpStream::ThreadEntry& lhs, const ArdpStream::ThreadEntry
  * we need to be able to accommodate ardpConfig.segmax messages queued up for
  * each endpoint.
  *
- * The phenomenon of the destination queue filling up has been called the "slow
- * reader problem."  Daemon Router-based solutions are being considered, but we
- * have to do something now; so we solve the problem by having a thread other
- * than the message dispatcher thread dispatch the PushMessage to the router.
- * The RemoteEndpoint has a pool of up to 100 threads available, but they are
- * deeply wired down into the concept of a stream socket, which we don't use.
- * So the thread in question lives here.
- *
- * It is relatively cheap to spin up a thread, but this behavior is highly
- * platform dependent so we don't want to do this arbitrarily frequently.  Since
- * our threads consume at least one qcc::Event which, in turn, consumes one or
- * two FDs, we need to be careful about leaving lots of them around.  This leads
- * to a design wjere we associate a thread with an endpoint in an on-demand
- * basis, with the thread exiting after some relatively short period of non-use,
- * but hanging around for bursts of messages.
+ * We used to spin up a transient thread per pump on demand and have it exit
+ * after a period of non-use.  Under connection churn that meant paying thread
+ * create and join costs over and over again, so the pump now keeps a bounded
+ * pool of worker threads.  Since our threads consume at least one qcc::Event
+ * which, in turn, consumes one or two FDs, the bound keeps us from leaving
+ * lots of them around.
  */
-class MessagePump {
+class UDPMessagePump : public MessagePump {
   public:
-    MessagePump(UDPTransport* transport)
-        : m_transport(transport), m_lock(), m_activeThread(NULL), m_pastThreads(), m_queue(), m_condition(), m_spawnedThreads(0), m_stopping(false)
-    {
-        QCC_DbgTrace(("MessagePump::MessagePump()"));
-    }
+    UDPMessagePump(UDPTransport* transport, uint32_t maxThreads) : MessagePump(maxThreads), m_transport(transport) { }
 
-    virtual ~MessagePump()
+    virtual ~UDPMessagePump()
     {
-        QCC_DbgTrace(("MessagePump::~MessagePump()"));
-        QCC_DbgTrace(("MessagePump::~MessagePump(): Dealing with threads"));
+        QCC_DbgTrace(("UDPMessagePump::~UDPMessagePump()"));
         Stop();
         Join();
 
-        QCC_DbgTrace(("MessagePump::~MessagePump(): Dealing with remaining queued messages"));
-        while (m_queue.empty() == false) {
-            QueueEntry entry = m_queue.front();
-            m_queue.pop();
-            m_transport->m_ardpLock.Lock();
-            ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
-            m_transport->m_ardpLock.Unlock();
-        }
-
-        QCC_ASSERT(m_queue.empty() && "MessagePump::~MessagePump(): Message queue must be empty here");
-        QCC_ASSERT(m_activeThread == NULL && "MessagePump::~MessagePump(): Active thread must be gone here");
-        QCC_ASSERT(m_pastThreads.empty() && "MessagePump::~MessagePump(): Past threads must be gone here");
-
-        QCC_DbgTrace(("MessagePump::~MessagePump(): Done"));
-    }
-
-    /*
-     * Determine whether or not there is an active pump thread that may be wanting to
-     * call out to the daemon.
-     */
-    bool IsActive()
-    {
-        QCC_DbgTrace(("MessagePump::IsActive()"));
-        bool ret = m_activeThread != NULL;
-        QCC_DbgPrintf(("MessagePump::IsActive() => \"%s\"", ret ? "true" : "false"));
-        return ret;
-    }
-
-    /*
-     * The Message Pump doesn't inherit from qcc::Thread so it isn't going to
-     * Start(), Stop() and Join() direcly.  It HASA Thread That is Start()ed
-     * on-demand.  We do implement Stop() to allow us to do something when we
-     * need to cause the pump thread to stop.
-     */
-    QStatus Stop()
-    {
-        QCC_DbgTrace(("MessagePump::Stop()"));
-        QStatus status = ER_OK;
-
         /*
-         * There may be at most one m_activeThread running.  We need to set its
-         * state to STOPPING.  This thread isn't going to be waiting on its stop
-         * event though.  In order to minimize the number of events we create,
-         * it will be waiting on a condition variable and then test for stopping
-         * whenever it wakes up.  So we have to call Stop() to set the state and
-         * then Signal() our condition variable to wake up the thread.
+         * Anything left on the per-connection queues is returned to ARDP in
+         * the order we received it.
          */
-        m_lock.Lock();
-        m_stopping = true;
-        if (m_activeThread) {
-            QCC_DbgPrintf(("MessagePump::Stop(): m_activeThread->Stop()"));
-            m_activeThread->Stop();
-            QCC_DbgPrintf(("MessagePump::Stop(): m_condition.Signal()"));
-            m_condition.Signal();
-        }
-#ifndef NDEBUG
-        else {
-            QCC_DbgPrintf(("MessagePump::Stop(): m_activeThread is NULL"));
-        }
-#endif
-        m_lock.Unlock();
-
-        QCC_DbgTrace(("MessagePump::Stop() => \"%s\"", QCC_StatusText(status)));
-        return status;
+        ReleaseQueued();
     }
 
-    /*
-     * The Message Pump doesn't inherit from qcc::Thread so it isn't going to
-     * Start(), Stop() and Join() direcly.  It HASA Thread That is Start()ed
-     * on-demand and can be Stop()ped.  It also HASA list of threads that have
-     * decided to shut down.  We implement Join() to allow us to join *all* of
-     * those threads when we need the pump to shut down
-     */
-    QStatus Join()
-    {
-        QCC_DbgTrace(("MessagePump::Join()"));
-        return DoJoin(true);
-    }
+  protected:
+    virtual void Dispatch(QueueEntry& entry);
 
-    /*
-     * The Message Pump doesn't inherit from qcc::Thread so it isn't going to
-     * Start(), Stop() and Join() direcly.  It HASA Thread That is Start()ed
-     * on-demand and can be Stop()ped.  It also HASA list of threads that have
-     * decided to shut down.  We implement JoinPast() to allow the endpoint
-     * management thread to join those shutdown threads but allow an active
-     * thread to continue running.
-     */
-    QStatus JoinPast()
-    {
-        QCC_DbgTrace(("MessagePump::JoinPast()"));
-        return DoJoin(false);
-    }
-
-    /*
-     * Common internal method implementing both flavors of join.
-     */
-    QStatus DoJoin(bool both)
+    virtual void Release(QueueEntry& entry)
     {
-        QCC_DbgTrace(("MessagePump::DoJoin(both=\"%s\")", both ? "true" : "false"));
-        QStatus status = ER_OK;
-
-        /*
-         * There may be at most one m_activeThread running and there may be a
-         * set of past threads that need Join()ing.  We expect that the active
-         * thread will stop and put itself on the past threads queue.  So we
-         * need to join all of the threads on the past threads queue until the
-         * spawned thread count goes to zero.  We also expect that pump threads
-         * will time out and exit if unused and the endpoint manager will have
-         * periodically joined any past threads so this may not happen much in
-         * practice.
-         */
-        m_lock.Lock();
-        while (m_spawnedThreads) {
-            QCC_DbgPrintf(("MessagePump::DoJoin(): m_spawnedThreads=%d.", m_spawnedThreads));
-            QCC_ASSERT((m_activeThread ? 1 : 0) + m_pastThreads.size() == m_spawnedThreads && "MessagePump::DoJoin(): m_spawnedThreads count inconsistent");
-
-            if (m_pastThreads.size()) {
-                PumpThread* pt = m_pastThreads.front();
-                m_pastThreads.pop();
-                --m_spawnedThreads;
-                m_lock.Unlock();
-                status = pt->Join();
-                if (status != ER_OK) {
-                    QCC_LogError(status, ("MessagePump::DoJoin: PumpThread Join() error"));
-                }
-                delete pt;
-                pt = NULL;
-                m_lock.Lock();
-            } else {
-                /*
-                 * If there is a spawned thread left and no threads on the
-                 * past threads list, it means that there is an acive thread
-                 * that has not yet stopped.  Since the endpoint manager wants
-                 * to clean up zombies periodically, it needs to be able to
-                 * Join() past threads but not the active thread.  It calls
-                 * JoinPast() to do this, and JoinPast() calls DoJoin(both=false)
-                 * which sets both to false.  The endpoint Join() needs to
-                 * wait for all threads to be joined so it calls Join() which
-                 * calls DoJoin(both=true).
-                 */
-                if (both) {
-
-                    /*
-                     * We need to wait for the active thread to put itself on
-                     * the past threads queue.
-                     *
-                     * TODO: use condition variable and thread exit routine
-                     * instead of sleeping/polling.
-                     */
-                    QCC_ASSERT(m_stopping == true && "MessagePump::DoJoin(): m_stopping must be true if both=true)");
-
-                    m_lock.Unlock();
-                    qcc::Sleep(10);
-                    m_lock.Lock();
-
-                    /*
-                     * We are taking and giving the mutex lock constantly in
-                     * order to call out to Join() in particular which might
-                     * block.  Since we are turning loose of the lock, it could
-                     * be the case that there are race conditions between the
-                     * Stop() and condition Signal that is going to drive the
-                     * active thread to exit, and the spinning up of new active
-                     * threads.  In order to prevent waiting around forever, we
-                     * keep poking the active thread as we wait for it to go
-                     * away.
-                     */
-                    if (m_activeThread) {
-                        m_activeThread->Stop();
-                        m_condition.Signal();
-                    }
-                } else {
-                    /*
-                     * Okay to leave the m_activeThread unJoin()ed.
-                     */
-                    break;
-                }
-            }
-        }
-#ifndef NDEBUG
-        if (both) {
-            QCC_ASSERT(m_spawnedThreads == 0 && "MessagePump::DoJoin(): m_spawnedThreads must be 0 after DoJoin(true)");
-        } else {
-            QCC_ASSERT(m_spawnedThreads <= 1 && "MessagePump::DoJoin(): m_spawnedThreads must be 0 or 1 after DoJoin(false)");
-        }
-#endif
-        m_lock.Unlock();
-
-        QCC_DbgPrintf(("MessagePump::DoJoin(): m_spawnedThreads=%d. at return", m_spawnedThreads));
-        QCC_DbgPrintf(("MessagePump::DoJoin() => \"%s\"", QCC_StatusText(status)));
-        return status;
-    }
-
-    void RecvCb(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId, ArdpRcvBuf* rcv, QStatus status)
-    {
-        QCC_DbgTrace(("MessagePump::RecvCb(handle=%p, conn=%p, connId=%d., rcv=%p, status=%s)", handle, conn, connId, rcv, QCC_StatusText(status)));
-
-        QCC_ASSERT(status == ER_OK && "MessagePump::RecvCb(): Asked to dispatch an error!?");
-
-        /*
-         * We always want to pump the message in the callback so create a queue
-         * entry and push it onto the queue.  If we start a thread, the first
-         * thing it will do is to check the condition (queue is not empty) so it
-         * will handle this entry.  If it turns out that there is a thread that
-         * has stopped we don't want to spin up a new thread, but we can queue
-         * up the message which will be handled when the pump is cleaned up.
-         */
-        m_lock.Lock();
-        QueueEntry entry(handle, conn, connId, rcv, status);
-        m_queue.push(entry);
-
-        /*
-         * RecvCb() callbacks can continue to happen after we have stopped the
-         * active thread, so make sure we don't spin up a new thread that might
-         * after we acknowledge a Stop() request.
-         */
-        if (m_stopping) {
-            QCC_DbgPrintf(("MessagePump::RecvCb(): Stopping"));
-            m_lock.Unlock();
-            return;
-        }
-
-        /*
-         * The thread rules: If there is no pump thread in existence, create one
-         * and start it running.  Put the PumpThread* into m_activeThread.  If
-         * there is a PumpThread* in m_activeThread, it must be running.  If you
-         * want to stop a pump thread you must remove it from m_activeThread
-         * before you do the stop.  If a thread detects it is no longer needed
-         * (the wait times out) it will remove itself as the active thread and
-         * put itself on the past threads list so it can be Join()ed.
-         *
-         * Here's a tricky question: what happens if we can allocate a pump
-         * thread object but we can't start the pump thread?  We need the thread
-         * to do something with the data, but we have no thread.  We could sit
-         * in a loop trying to spawn a thread here. but that would block ARDP
-         * that is trying to get rid of incoming messages.  We can wait for a
-         * next incoming message to try again, but since the thread is going to
-         * open the receive window we will only get SEGMAX tries and then the
-         * process stalls.  If no new connection happens to start driving the
-         * process again, the messages simply remain on the input queue.  We
-         * choose bailing and waiting for a new message to drive the process
-         * since if we cannot spin up a thread, we have bigger problems than
-         * a temporarily stalled message.  The bytes aren't lost, they are
-         * temporarily stashed until things maybe get better.  We hope ARDP
-         * is understanding.
-         */
-        if (m_activeThread == NULL) {
-            QCC_DbgPrintf(("MessagePump::RecvCb(): Spin up new PumpThread"));
-            m_activeThread = new PumpThread(this);
-            status = m_activeThread->Start(NULL, NULL);
-
-            /*
-             * The choice described in the above comment.
-             */
-            if (status != ER_OK) {
-                delete m_activeThread;
-                m_activeThread = NULL;
-                m_lock.Unlock();
-                return;
-            } else {
-                ++m_spawnedThreads;
-            }
-        }
-
-        QCC_DbgPrintf(("MessagePump::RecvCb(): m_spawnedThreads=%d.", m_spawnedThreads));
-        QCC_ASSERT(m_activeThread && "MessagePump::RecvCb(): Expecting an active thread at this time.");
-
-        /*
-         * It may be the case that the active thread is stopping but it has not
-         * yet moved its pointer m_activeThread to the list of past threads.  In
-         * this case, there will be nobody to read and dispatch the queue entry
-         * correcponding to the RecvCb.  We expect that if the thread
-         * IsStopping() it must be because someone has called Stop() on the
-         * message pump, and the place where this is done is in the endpoint
-         * Stop() method.  This means that the endpoint is in the process of
-         * being torn down.  When the message pump is eventually deleted, the
-         * queued messages will be pulled off the queue and returned to ARDP.
-         * The upshot is that it is okay that the thread is stopping.  We return
-         * any queued messages in the order that we received them in the
-         * destructor.  We just print a message that this is happening in debug
-         * mode.
-         */
-#ifndef NDEBUG
-        if (m_activeThread->IsStopping()) {
-            QCC_DbgPrintf(("MessagePump::RecvCb(): Thread stopping."));
-        }
-#endif
-
-        /*
-         * Signal the condition to wake up an existing thread that may be asleep
-         * waiting for something to do.
-         */
-        m_condition.Signal();
-        m_lock.Unlock();
+        m_transport->m_ardpLock.Lock();
+        ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
+        m_transport->m_ardpLock.Unlock();
     }
 
   private:
-    class QueueEntry {
-      public:
-        QueueEntry(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId, ArdpRcvBuf* rcv, QStatus status)
-            : m_handle(handle), m_conn(conn), m_connId(connId), m_rcv(rcv), m_status(status) { }
-
-        ArdpHandle* m_handle;
-        ArdpConnRecord* m_conn;
-        uint32_t m_connId;
-        ArdpRcvBuf* m_rcv;
-        QStatus m_status;
-    };
-
-    class PumpThread : public qcc::Thread {
-      public:
-        PumpThread(MessagePump* pump) : qcc::Thread(qcc::String("PumpThread")), m_pump(pump) { }
-        void ThreadExit(Thread* thread);
-
-      protected:
-        qcc::ThreadReturn STDCALL Run(void* arg);
-
-      private:
-        MessagePump* m_pump;
-    };
-
     UDPTransport* m_transport;              /**< The UDP Transport instance associated with this pump */
-    qcc::Mutex m_lock;                      /**< Mutex that protects multithread access to the queue */
-    PumpThread* m_activeThread;             /**< Thread doing the actual work */
-    std::queue<PumpThread*> m_pastThreads;  /**< Queue of transient threads have shut down or are shutting and need to be joined */
-    std::queue<QueueEntry> m_queue;         /**< Queue of received messages and associated data to dispatch to the router */
-    qcc::Condition m_condition;             /**< Condition variable coordinating consumption of queue entries by the pump thread */
-    uint32_t m_spawnedThreads;              /**< The number of threads that have been spawned but not joined */
-    bool m_stopping;                        /**< True if Stop() has been called and we shouldn't spin up new threads */
 };
 
 /*
@@ -4192,181 +3874,76 @@ class _UDPEndpoint : public _RemoteEndpoint {
 };
 
 /*
- * A thread function to dispatch all of the callbacks from the ARDP protocol.
+ * Call out to the endpoint identified by the queue entry to have it push the
+ * message off to the router.  Called without the pump lock held.
  */
-ThreadReturn STDCALL MessagePump::PumpThread::Run(void* arg)
+void UDPMessagePump::Dispatch(QueueEntry& entry)
 {
-    QCC_UNUSED(arg);
-
-    QCC_DbgTrace(("MessagePump::PumpThread::Run()"));
-    QCC_ASSERT(m_pump && "MessagePump::PumpThread::Run(): pointer to enclosing pump must be specified");
-
     /*
-     * We need to implement a classic condition variable idiom.  Here the mutex
-     * is the m_lock mutex member variable and the condition that needs to be
-     * met is "something in the queue."  This is complicated a bit (but not
-     * much) since we need to live inside a while loop and execute until we are
-     * asked to stop or have hung around for some time without something useful
-     * to do (see the class doxygen for more description).
+     * We need to call out to the daemon to have it go ahead and push the
+     * message off to the destination.  This gets tricky since we have several
+     * threads that need to deal with the endpoint including those that may
+     * want to delete it.
      *
-     * Note that IsStopping() is a call to the thread base class that indicates
-     * the underlying thread has received a Stop() request.  The member variable
-     * m_stopping is a boolean we use to synchronize the run thread and any
-     * RecvCb() callbacks we might get from the UDP Transport dispatcher thread.
-     * We don't want to have to understand the details of how and when the
-     * internal stopping member of a thread is set, so we use our own with know
-     * semantics for synchronization up here.
-     */
-    QStatus status = ER_OK;
-    m_pump->m_lock.Lock();
-    while (!m_pump->m_stopping && !IsStopping() && status != ER_TIMEOUT) {
-        QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Top."));
-        /*
-         * Note that if the condition returns an unexpected status we loop in
-         * the hope that it is recoverable.
-         */
-        while (m_pump->m_queue.empty() && !m_pump->m_stopping && !IsStopping() && status != ER_TIMEOUT) {
-            QCC_DbgPrintf(("MessagePump::PumpThread::Run(): TimedWait for condition"));
-            status = m_pump->m_condition.TimedWait(m_pump->m_lock, UDP_MESSAGE_PUMP_TIMEOUT);
-            QCC_DbgPrintf(("MessagePump::PumpThread::Run(): TimedWait returns \"%s\"", QCC_StatusText(status)));
-        }
-
-        QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Done with wait."));
-
-        /*
-         * One of three things has happened: 1) the condition has been signaled
-         * because there is something on the queue; 2) the condition has been
-         * signaled because we have been asked to stop; 3) the timed wait has
-         * timed out and we have had nothing to do for that amount of time.  If
-         * we've been asked to stop, or we time out, we just loop back to the
-         * top and break out of the while loop -- we just need to work if the
-         * queue is not empty.
-         */
-        if (m_pump->m_stopping || IsStopping() || status == ER_TIMEOUT) {
-            continue;
-        } else if (m_pump->m_queue.empty() == false) {
-            QCC_DbgTrace(("MessagePump::PumpThread::Run(): Have work."));
-
+     * While we hold the endpoint lock we are going to call IncrementRefs() on
+     * the endpoint to ensure it isn't deleted before the call out to the
+     * endpoint is made.  Then we call out to the RecvCb() ahd then finally we
+     * DecrementRefs() to allow deletion.
+     */
+    bool handled = false;
+    m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
+    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
+        UDPEndpoint ep = *i;
+        if (entry.m_connId == ep->GetConnId()) {
+            QCC_DbgPrintf(("UDPMessagePump::Dispatch(): found endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
             /*
-             * Pull the entry describing the message off the work queue.
+             * We have a managed object reference to ep, but also increment the
+             * endpoint reference count (different from the managed object
+             * reference count) to make sure the endpoint manager doesn't try to
+             * delete the endpoint before our call actually makes it there.
              */
-            QueueEntry entry = m_pump->m_queue.front();
-            m_pump->m_queue.pop();
-
+            ep->IncrementRefs();
+            m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
+            QCC_DbgPrintf(("UDPMessagePump::Dispatch(): Call out to endopint with connId=%d.", entry.m_connId));
+            ep->RecvCb(entry.m_handle, entry.m_conn, entry.m_connId, entry.m_rcv, entry.m_status);
+            QCC_DbgPrintf(("UDPMessagePump::Dispatch(): Back from endpoint RecvCb()"));
+            handled = true;
+            m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
             /*
-             * We need to call out to the daemon to have it go ahead and push
-             * the message off to the destination.  This gets tricky since we
-             * have several threads that need to deal with the endpoint
-             * including those that may want to delete it.
-             *
-             * While we hold the endpoint lock we are going to call
-             * IncrementRefs() on the endpoint to ensure it isn't deleted before
-             * the call out to the endpoint is made.  Then we call out to the
-             * RecvCb() ahd then finally we DecrementRefs() to allow deletion.
+             * Since we held a reference to ep and we incremented the reference
+             * count, we expect this reference to remain valid.  We use it to
+             * decrement the refs and then forget it.  We can never use the
+             * iterator again since the moment we released the lock it could
+             * have become invalid.
              */
-            bool handled = false;
-            m_pump->m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
-            for (set<UDPEndpoint>::iterator i = m_pump->m_transport->m_endpointList.begin(); i != m_pump->m_transport->m_endpointList.end(); ++i) {
-                UDPEndpoint ep = *i;
-                if (entry.m_connId == ep->GetConnId()) {
-                    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): found endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
-                    /*
-                     * We have a managed object reference to ep, but also
-                     * increment the endpoint reference count (different from
-                     * the managed object reference count) to make sure the
-                     * endpoint manager doesn't try to delete the endpoint
-                     * before our call actually makes it there.
-                     */
-                    ep->IncrementRefs();
-                    m_pump->m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
-                    m_pump->m_lock.Unlock();
-                    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Call out to endopint with connId=%d.", entry.m_connId));
-                    ep->RecvCb(entry.m_handle, entry.m_conn, entry.m_connId, entry.m_rcv, entry.m_status);
-                    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Back from endpoint RecvCb()"));
-                    handled = true;
-                    m_pump->m_lock.Lock();
-                    m_pump->m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
-                    /*
-                     * Since we held a reference to ep and we incremented the
-                     * reference count, we expect this reference to remain
-                     * valid.  We use it to decrement the refs and then forget
-                     * it.  We can never use the iterator again since the moment
-                     * we released the lock it could have become invalid.
-                     */
-                    ep->DecrementRefs();
-                    break;
-                }
-            }
-            m_pump->m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
+            ep->DecrementRefs();
+            break;
+        }
+    }
+    m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
-            /*
-             * If we were able to find an endpoint on which to dispatch this
-             * callback then the endpoint RecvCb() took responsibility for the
-             * message.
-             *
-             * If we were unable to find an endpoint to dispatch this callback
-             * to we still need to do something about the message we were given.
-             * This means returning the bytes back to ARDP.
-             */
-            if (handled == false) {
+    /*
+     * If we were able to find an endpoint on which to dispatch this callback
+     * then the endpoint RecvCb() took responsibility for the message.
+     *
+     * If we were unable to find an endpoint to dispatch this callback to we
+     * still need to do something about the message we were given.  This means
+     * returning the bytes back to ARDP.
+     */
+    if (handled == false) {
 #if RETURN_ORPHAN_BUFS
 
-                QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Unable to find endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
-                m_pump->m_transport->m_ardpLock.Lock();
-                ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
-                m_pump->m_transport->m_ardpLock.Unlock();
+        QCC_DbgPrintf(("UDPMessagePump::Dispatch(): Unable to find endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
+        m_transport->m_ardpLock.Lock();
+        ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
+        m_transport->m_ardpLock.Unlock();
 
 #else // not RETURN_ORPHAN_BUFS
 
-                QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Unable to find endpoint with conn ID == %d. on m_endpointList. Ignore message", entry.m_connId));
+        QCC_DbgPrintf(("UDPMessagePump::Dispatch(): Unable to find endpoint with conn ID == %d. on m_endpointList. Ignore message", entry.m_connId));
 
 #endif // not RETURN_ORPHAN_BUFS
-            }
-        }
     }
-
-
-    /*
-     * If we are exiting, we need to make sure that there are no race conditions
-     * between our decision to exit and a RecvCb() decision to use an existing
-     * active thread.  We also need to recognize that if we are returning because
-     * of an inactivity timeout we need to allow RecvCb() to spin up a new thread.
-     *
-     * We hold the pump lock here, and RecvCb() must also hold the lock thread
-     * when it makes its decisions.  If we know RecvCb() will run after we are
-     * done.  If we are exiting because of a Stop(), then IsStopping() will be
-     * true and our version (m_stopping) will also be true.  RecvCb() will not
-     * spin up a new thread if m_stopping is true.  If we are exiting because of
-     * inactivity at this point IsStopping() and m_stopping may or may not be
-     * true depending on races.  We don't care, since m_stopping is going to
-     * determine what happens after we are gone.  We just exit.
-     *
-     * If we are exiting, we must be the active thread.  The rules say we are
-     * the one who must remove our own pointer from the activeThread, zero it
-     * out and add ourselves to the pastThread queue.  If we do this atomically
-     * with the pump lock held, then RecvCb() can do what it needs to do also
-     * atomically.
-     */
-    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Exiting"));
-    PumpThread* i = (PumpThread*)GetThread();
-    QCC_ASSERT(m_pump->m_activeThread == i && "MessagePump::PumpThread::Run(): I should be the active thread");
-    m_pump->m_pastThreads.push(i);
-    m_pump->m_activeThread = NULL;
-    m_pump->m_lock.Unlock();
-    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Return"));
-
-    /*
-     * The last thing we need to do is to bug the endpoint so its endpoint
-     * management function will run and Join() our thread.  We've pushed our
-     * thread ID onto the list of past threads, and the endpoint will assume
-     * that we have exited and join us if our ID is on pastThreads.  This will
-     * happen even if we get swapped out "between" the Alert() and the return
-     * (especially during the closing printfs in debug mode).
-     */
-    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Alert()"));
-    m_pump->m_transport->Alert();
-    QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Return"));
-    return 0;
 }
 
 static void UdpEpStateLock(_UDPEndpoint* ep)
@@ -4449,9 +4026,7 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
     }
     memcpy(&m_ardpConfig, &ardpConfig, sizeof(ArdpGlobalConfig));
 
-    for (uint32_t i = 0; i < N_PUMPS; ++i) {
-        m_messagePumps[i] = new MessagePump(this);
-    }
+    m_messagePump = new UDPMessagePump(this, config->GetLimit("udp_message_pump_threads", UDP_MESSAGE_PUMP_THREADS));
 
     /*
      * User configured UDP-specific values trump defaults if longer.
@@ -4513,11 +4088,9 @@ UDPTransport::~UDPTransport()
     Stop();
     Join();
 
-    for (uint32_t i = 0; i < N_PUMPS; ++i) {
-        QCC_ASSERT(m_messagePumps[i]->IsActive() == false && "UDPTransport::~UDPTransport(): Destroying with active message pump");
-        delete m_messagePumps[i];
-        m_messagePumps[i] = NULL;
-    }
+    QCC_ASSERT(m_messagePump->IsActive() == false && "UDPTransport::~UDPTransport(): Destroying with active message pump");
+    delete m_messagePump;
+    m_messagePump = NULL;
 
     ARDP_FreeHandle(m_handle);
     m_handle = NULL;
@@ -4714,23 +4287,18 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                                 {
                                     QCC_DbgPrintf(("UDPTransport::DispatcherThread::Run(): RECV_CB: Call RecvCb() on endpoint message pump"));
                                     /*
-                                     * We have N_PUMPS worth of what amounts to
-                                     * worker threads to handle making the calls
-                                     * out to the daemon router.  This is to
-                                     * handle cases where the reader of the
-                                     * messages is slow, that then leads to the
-                                     * callout to the PushMessage to block.
-                                     *
-                                     * We assume entry.connId to be selected
-                                     * from a uniform distribution and so simply
-                                     * selecting a message pump based on a mod
-                                     * operation on the connection ID will
-                                     * uniformly distribute the load among the
-                                     * threads.
+                                     * We have a pool of what amounts to worker
+                                     * threads to handle making the calls out
+                                     * to the daemon router.  This is to handle
+                                     * cases where the reader of the messages
+                                     * is slow, that then leads to the callout
+                                     * to the PushMessage to block.
                                      *
-                                     * We always select the same pump for a
-                                     * given connection ID since that preserves
-                                     * message ordering at the destination.
+                                     * The message pump keeps a queue per
+                                     * connection ID and never lets more than
+                                     * one pump thread work on a connection at
+                                     * a time, which preserves message ordering
+                                     * at the destination.
                                      *
                                      * There are complications here because
                                      * there is a possibility that the endpoint
@@ -4740,14 +4308,9 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                                      * The MessagePump deals with the
                                      * possibility that things are disappearing
                                      * out from underneath it.
-                                     *
-                                     * We assume that the message pumps array
-                                     * will not be changed out from underneath
-                                     * us while we are running at least.
                                      */
-                                    MessagePump* mp = m_transport->m_messagePumps[entry.m_connId % N_PUMPS];
-                                    QCC_ASSERT(mp != NULL && "UDPTransport::DispatcherThread::Run(): Pumps array not initialized");
-                                    mp->RecvCb(entry.m_handle, entry.m_conn, entry.m_connId, entry.m_rcv, entry.m_status);
+                                    QCC_ASSERT(m_transport->m_messagePump != NULL && "UDPTransport::DispatcherThread::Run(): Message pump not initialized");
+                                    m_transport->m_messagePump->RecvCb(entry.m_handle, entry.m_conn, entry.m_connId, entry.m_rcv, entry.m_status);
                                     break;
                                 }
 
@@ -5279,10 +4842,8 @@ QStatus UDPTransport::Join(void)
      * take down the message pumps and dispatcher threads since thre
      * is no more work for them.
      */
-    QCC_DbgPrintf(("UDPTransport::Stop(): Stop() message pumps"));
-    for (uint32_t i = 0; i < N_PUMPS; ++i) {
-        m_messagePumps[i]->Stop();
-    }
+    QCC_DbgPrintf(("UDPTransport::Stop(): Stop() message pump"));
+    m_messagePump->Stop();
 
     QCC_DbgPrintf(("UDPTransport::Join(): Stop message dispatcher thread"));
     if (m_dispatcher) {
@@ -5307,12 +4868,10 @@ QStatus UDPTransport::Join(void)
     }
 
     /*
-     * Join() all of the message pumps.
+     * Join() all of the message pump threads.
      */
-    QCC_DbgPrintf(("UDPTransport::Join(): Join() message pumps"));
-    for (uint32_t i = 0; i < N_PUMPS; ++i) {
-        m_messagePumps[i]->Join();
-    }
+    QCC_DbgPrintf(("UDPTransport::Join(): Join() message pump"));
+    m_messagePump->Join();
 
     /*
      * We waited for the dispatcher thread to finish dispatching all in-process
@@ -5538,6 +5097,12 @@ QStatus UDPTransport::Join(void)
     return ER_OK;
 }
 
+void UDPTransport::GetMessagePumpStats(MessagePumpStats& stats)
+{
+    QCC_DbgTrace(("UDPTransport::GetMessagePumpStats()"));
+    m_messagePump->GetStats(stats);
+}
+
 /**
  * This is a convenience function that tells a caller whether or not this
  * transport will support a set of options for a connection.  Lets the caller
@@ -5944,20 +5509,6 @@ void UDPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
     QCC_DbgTrace(("UDPTransport::ManageEndpoints()"));
     bool managed = false;
 
-    /*
-     * We have an array of message pumps running in order to handle messages
-     * that need to be pushed into the daemon router.  There is a chance that
-     * any one of these pumps has had a message pump thread running, but that
-     * pump decided that it could stop the thread due to a lack of message
-     * traffic.  These threads that are stopped are called past threads.
-     * Something needs to join those defunct pump threads and that something is
-     * us.
-     */
-    QCC_DbgPrintf(("UDPTransport::ManageEndpoints(): MessagePump::JoinPast()"));
-    for (uint32_t i = 0; i < N_PUMPS; ++i) {
-        m_messagePumps[i]->JoinPast();
-    }
-
     set<UDPEndpoint>::iterator i;
 
     QCC_DbgPrintf(("UDPTransport::ManageEndpoints(): Taking endpoint list lock"));
@@ -9618,7 +9169,7 @@ QStatus UDPTransport::NormalizeTransportSpec(const char* inSpec, qcc::String& ou
 /**
  * This is the method that is called in order to initiate an outbound (active)
  * connection.  This is called from the AllJoyn Object in the course of
- * processing a JoinSession request in the context of a JoinSessionThread.
+ * processing a JoinSession request on a JoinSession dispatcher thread.
  */
 QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts, BusEndpoint& newEp)
 {
@@ -60,15 +60,13 @@ class _UDPEndpoint; /**< Forward declaration for a class of endpoints implementi
 
 class MessagePump; /**< Forward declaration for a class implementing an active message pump to move messages into the router */
 
-#define N_PUMPS 8 /**<  The number of message pumps and possibly concurrent threads we use to move messages */
-
 typedef qcc::ManagedObj<_UDPEndpoint> UDPEndpoint;
 
 /**
  * @brief A class for UDP Transports used in daemons.
  */
 class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener, public qcc::Thread {
-    friend class MessagePump;
+    friend class UDPMessagePump;
     friend class _UDPEndpoint;
     friend class ArdpStream;
 
@@ -293,6 +291,28 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
      */
     bool IsBusToBus() const { return true; }
 
+    /**
+     * Utilization and queue depth statistics of the pool of threads that move
+     * received messages into the router.
+     */
+    struct MessagePumpStats {
+        uint32_t maxThreads;          /**< The maximum number of pump threads in the pool */
+        uint32_t threads;             /**< The number of pump threads currently started */
+        uint32_t busyThreads;         /**< The number of pump threads currently calling out to an endpoint */
+        uint32_t peakBusyThreads;     /**< The largest number of simultaneously busy pump threads seen */
+        uint32_t queuedMessages;      /**< The number of received messages waiting for a pump thread */
+        uint32_t peakQueuedMessages;  /**< The largest number of simultaneously waiting messages seen */
+        uint32_t queuedConnections;   /**< The number of connections with messages waiting or being dispatched */
+        uint64_t dispatchedMessages;  /**< The total number of messages dispatched by the pump threads */
+    };
+
+    /**
+     * Get a snapshot of the message pump statistics.
+     *
+     * @param stats  [OUT] The current message pump statistics.
+     */
+    void GetMessagePumpStats(MessagePumpStats& stats);
+
     /**
      * Callback for UDPEndpoint exit.
      *
@@ -351,7 +371,7 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
     std::set<ConnectEntry> m_connectThreads;                       /**< List of threads starting up active endpoints */
     qcc::Mutex m_endpointListLock;                                 /**< Mutex that protects the endpoint and auth lists */
 
-    MessagePump* m_messagePumps[N_PUMPS];                          /**< array of MessagePumps (with possiblly running pump threads) */
+    MessagePump* m_messagePump;                                    /**< The MessagePump (with its pool of pump threads) */
 
     class ListenFdEntry {
       public:
@@ -388,7 +388,8 @@ IpNameServiceImpl::IpNameServiceImpl()
     m_ipv4UnicastSockFd(qcc::INVALID_SOCKET_FD), m_unicastEvent(NULL),
     m_protectListeners(false), m_packetScheduler(*this),
     m_networkChangeScheduleCount(ArraySize(RETRY_INTERVALS)), m_staticScore(0), m_dynamicScore(0), m_priority(0),
-    m_powerSource(0), m_mobility(0), m_availability(0), m_nodeConnection(0)
+    m_powerSource(0), m_mobility(0), m_availability(0), m_nodeConnection(0),
+    m_packetReplay(NULL), m_responseTracker(RESPONSE_SUPPRESSION_INTERVAL)
 {
     QCC_DbgHLPrintf(("IpNameServiceImpl::IpNameServiceImpl()"));
     TRANSPORT_INDEX_TCP = IndexFromBit(TRANSPORT_TCP);
@@ -408,6 +409,7 @@ IpNameServiceImpl::IpNameServiceImpl()
 
     memset(&m_processTransport[0], 0, sizeof(m_processTransport));
     memset(&m_doNetworkCallback[0], 0, sizeof(m_doNetworkCallback));
+    memset(&m_packetBuildStats, 0, sizeof(m_packetBuildStats));
     for (uint32_t i = 0; i < N_TRANSPORTS; i++) {
         m_dynamicParams[i].availableTransportConnections = 0;
         m_dynamicParams[i].availableTransportRemoteClients = 0;
@@ -957,6 +959,11 @@ void IpNameServiceImpl::ClearLiveInterfaces(void)
         }
     }
 
+    //
+    // Anything we serialized for the old interfaces is now meaningless.
+    //
+    m_packetCache.ClearSerialized();
+
     QCC_DbgPrintf(("IpNameServiceImpl::ClearLiveInterfaces(): Clear interfaces"));
     m_liveInterfaces.clear();
 
@@ -1703,6 +1710,12 @@ QStatus IpNameServiceImpl::Enable(TransportMask transportMask,
             m_doDisable = true;
         }
     }
+
+    //
+    // The port maps feed directly into the contents of our advertisements, so
+    // any packets we have built and cached so far are now stale.
+    //
+    InvalidatePacketCache();
     m_mutex.Unlock();
 
     m_forceLazyUpdate = true;
@@ -2330,6 +2343,9 @@ void IpNameServiceImpl::SetCriticalParameters(
     m_tQuestion = tQuestion;
     m_modulus = modulus;
     m_retries = (retries < ArraySize(RETRY_INTERVALS)) ? retries : ArraySize(RETRY_INTERVALS);
+    m_mutex.Lock();
+    InvalidatePacketCache();
+    m_mutex.Unlock();
 }
 
 QStatus IpNameServiceImpl::SetCallback(TransportMask transportMask,
@@ -2531,6 +2547,7 @@ QStatus IpNameServiceImpl::AdvertiseName(TransportMask transportMask, vector<qcc
             set<qcc::String>::iterator j = find(m_advertised_quietly[transportIndex].begin(), m_advertised_quietly[transportIndex].end(), wkn[i]);
             if (j == m_advertised_quietly[transportIndex].end()) {
                 m_advertised_quietly[transportIndex].insert(wkn[i]);
+                InvalidatePacketCache();
             } else {
                 //
                 // Nothing has changed, so don't bother.
@@ -2553,6 +2570,7 @@ QStatus IpNameServiceImpl::AdvertiseName(TransportMask transportMask, vector<qcc
             set<qcc::String>::iterator j = find(m_advertised[transportIndex].begin(), m_advertised[transportIndex].end(), wkn[i]);
             if (j == m_advertised[transportIndex].end()) {
                 m_advertised[transportIndex].insert(wkn[i]);
+                InvalidatePacketCache();
             } else {
                 //
                 // Nothing has changed, so don't bother.
@@ -2868,6 +2886,7 @@ QStatus IpNameServiceImpl::CancelAdvertiseName(TransportMask transportMask, vect
             set<qcc::String>::iterator k = find(m_advertised_quietly[transportIndex].begin(), m_advertised_quietly[transportIndex].end(), wkn[i]);
             if (k != m_advertised_quietly[transportIndex].end()) {
                 m_advertised_quietly[transportIndex].erase(k);
+                InvalidatePacketCache();
             }
         }
         //
@@ -2883,6 +2902,7 @@ QStatus IpNameServiceImpl::CancelAdvertiseName(TransportMask transportMask, vect
             if (j != m_advertised[transportIndex].end()) {
                 m_advertised[transportIndex].erase(j);
                 changed = true;
+                InvalidatePacketCache();
             }
         }
         if (changed == false) {
@@ -3550,15 +3570,43 @@ void IpNameServiceImpl::SendProtocolMessage(
         }
     }
 
-    size_t size = packet->GetSerializedSize();
-    if (size > NS_MESSAGE_MAX) {
-        QCC_LogError(ER_FAIL, ("SendProtocolMessage: Message (%d bytes) is longer than NS_MESSAGE_MAX (%d bytes)",
-                               size, NS_MESSAGE_MAX));
-        return;
+    //
+    // If we are resending a version zero or one packet from the packet cache,
+    // the rewritten packet for this interface is the same as it was the last
+    // time around, so we can skip serializing it again.  Version two packets
+    // carry a fresh search ID every time and so are always serialized.
+    //
+    PacketCache::SerializedPacket* serialized = NULL;
+    if (m_packetReplay && msgVersion != 2 && !packet->DestinationSet() && interfaceIndex < m_liveInterfaces.size()) {
+        serialized = &m_packetReplay->serialized[interfaceIndex];
+        if (serialized->buffer.empty() || serialized->address != m_liveInterfaces[interfaceIndex].m_address) {
+            serialized->buffer.clear();
+            serialized->address = m_liveInterfaces[interfaceIndex].m_address;
+        }
     }
 
-    uint8_t* buffer = new uint8_t[size];
-    size = packet->Serialize(buffer);
+    size_t size;
+    uint8_t* buffer;
+    if (serialized && !serialized->buffer.empty()) {
+        size = serialized->buffer.size();
+        buffer = new uint8_t[size];
+        memcpy(buffer, &serialized->buffer[0], size);
+        ++m_packetBuildStats.serializationsReused;
+    } else {
+        size = packet->GetSerializedSize();
+        if (size > NS_MESSAGE_MAX) {
+            QCC_LogError(ER_FAIL, ("SendProtocolMessage: Message (%d bytes) is longer than NS_MESSAGE_MAX (%d bytes)",
+                                   size, NS_MESSAGE_MAX));
+            return;
+        }
+
+        buffer = new uint8_t[size];
+        size = packet->Serialize(buffer);
+        ++m_packetBuildStats.packetsSerialized;
+        if (serialized) {
+            serialized->buffer.assign(buffer, buffer + size);
+        }
+    }
 
     size_t sent;
 
@@ -6337,6 +6385,25 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
         return;
     }
 
+    //
+    // Building the responses means walking every advertised name and sizing
+    // the packet as each one is added, which adds up when we are answering a
+    // steady stream of queries.  Unless we are saying goodbye or have been
+    // asked for only the matching names, the packets we build depend only on
+    // the arguments folded into the key below and on state that invalidates
+    // the packet cache when it changes, so we can resend what we built last
+    // time.
+    //
+    bool cacheable = !exiting && wkns.empty();
+    uint64_t key = PacketCache::Key(completeTransportMask, transportIndex, type, quietly);
+    if (cacheable) {
+        if (RetransmitFromCache(key, quietly, destination, source, interfaceIndex, family)) {
+            m_mutex.Unlock();
+            return;
+        }
+        m_packetCache.BeginCapture(key, GetCurrentPriority());
+    }
+
     //
     // We are now at version one of the protocol.  There is a significant
     // difference between version zero and version one messages, so down-version
@@ -6467,6 +6534,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
                 //
                 QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Sending partial list"));
                 nspacket->AddAnswer(isAt);
+                CachePacket(Packet::cast(nspacket));
 
                 if (quietly) {
                     nspacket->SetDestination(destination);
@@ -6522,6 +6590,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
 
         QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Sending final version zero message "));
         nspacket->AddAnswer(isAt);
+        CachePacket(Packet::cast(nspacket));
 
         nspacket->ClearDestination();
         if (interfaceIndex != -1) {
@@ -6680,6 +6749,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
                 //
                 QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Sending partial list"));
                 nspacket->AddAnswer(isAt);
+                CachePacket(Packet::cast(nspacket));
 
                 if (quietly) {
                     nspacket->SetDestination(destination);
@@ -6745,6 +6815,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
                     QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Message is full"));
                     QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Sending partial list"));
                     nspacket->AddAnswer(isAt);
+                    CachePacket(Packet::cast(nspacket));
 
                     if (quietly) {
                         nspacket->SetDestination(destination);
@@ -6782,6 +6853,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
 
         QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Sending final message "));
         nspacket->AddAnswer(isAt);
+        CachePacket(Packet::cast(nspacket));
 
         if (quietly) {
             nspacket->SetDestination(destination);
@@ -6976,6 +7048,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
                     // 2. IpNameServiceImpl::Run will call into Retransmit with exiting = true
                     //    and respondQuietly = false when the thread is shut down. In this case,
                     //    we need to send only the actively advertised names over multicast.
+                    CachePacket(Packet::cast(mdnsPacket));
                     if (!exiting) {
                         mdnsPacket->SetDestination(destination);
                         SendOutboundMessageQuietly(Packet::cast(mdnsPacket));
@@ -7033,6 +7106,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
                         QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Message is full"));
                         QCC_DbgPrintf(("IpNameServiceImpl::Retransmit(): Sending partial list"));
 
+                        CachePacket(Packet::cast(mdnsPacket));
                         mdnsPacket->SetDestination(destination);
                         SendOutboundMessageQuietly(Packet::cast(mdnsPacket));
 
@@ -7076,6 +7150,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
         // 2. IpNameServiceImpl::Run will call into Retransmit with exiting = true
         //    and respondQuietly = false when the thread is shut down. In this case,
         //    we need to send only the actively advertised names over multicast.
+        CachePacket(Packet::cast(mdnsPacket));
         if (!exiting) {
             mdnsPacket->SetDestination(destination);
             SendOutboundMessageQuietly(Packet::cast(mdnsPacket));
@@ -7085,6 +7160,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
         }
 
     }
+    m_packetCache.EndCapture();
     m_mutex.Unlock();
 }
 
@@ -7093,10 +7169,11 @@ bool IpNameServiceImpl::IsPeriodicMaintenanceTimerNeeded(void) const
 {
     //
     // The timer is needed when we're in the midst of handling a terminal message,
-    // we have an outbound message queued, or we're counting down to send the
-    // queued advertisement (in V1 config).
+    // we have an outbound message queued, we're counting down to send the
+    // queued advertisement (in V1 config), or we have deferred responses to
+    // questions waiting to go out.
     //
-    if (m_terminal || (m_outbound.size() > 0) || (m_enableV1 && (m_timer > 0))) {
+    if (m_terminal || (m_outbound.size() > 0) || (m_enableV1 && (m_timer > 0)) || !m_deferredResponses.empty()) {
         return true;
     } else {
         return false;
@@ -7126,6 +7203,8 @@ void IpNameServiceImpl::DoPeriodicMaintenance(void)
         }
     }
 
+    SendDeferredResponses();
+
     m_mutex.Unlock();
 }
 
@@ -7260,7 +7339,6 @@ void IpNameServiceImpl::HandleProtocolQuestion(WhoHas whoHas, const qcc::IPEndpo
         // are exporting; this just means to retransmit all of our advertisements.
         //
         if (respond) {
-            m_mutex.Unlock();
             qcc::AddressFamily family = qcc::QCC_AF_UNSPEC;
             if (remote.GetAddress().IsIPv4()) {
                 family = QCC_AF_INET;
@@ -7268,11 +7346,16 @@ void IpNameServiceImpl::HandleProtocolQuestion(WhoHas whoHas, const qcc::IPEndpo
             if (remote.GetAddress().IsIPv6()) {
                 family = QCC_AF_INET6;
             }
-            if (nsVersion == 0 && msgVersion == 0) {
-                vector<String> empty;
+            vector<String> empty;
+            bool respondV0 = nsVersion == 0 && msgVersion == 0 &&
+                             !SuppressResponse(index, respondQuietly, remote, local, TRANSMIT_V0, MaskFromIndex(index), empty, interfaceIndex, family);
+            bool respondV1 = nsVersion == 1 && msgVersion == 1 &&
+                             !SuppressResponse(index, respondQuietly, remote, local, TRANSMIT_V1, MaskFromIndex(index), wkns, interfaceIndex, family);
+            m_mutex.Unlock();
+            if (respondV0) {
                 Retransmit(index, false, respondQuietly, remote, local, TRANSMIT_V0, MaskFromIndex(index), empty, interfaceIndex, family);
             }
-            if (nsVersion == 1 && msgVersion == 1) {
+            if (respondV1) {
                 Retransmit(index, false, respondQuietly, remote, local, TRANSMIT_V1, MaskFromIndex(index), wkns, interfaceIndex, family);
             }
             m_mutex.Lock();
@@ -7719,6 +7802,15 @@ void IpNameServiceImpl::HandleProtocolMessage(uint8_t const* buffer, uint32_t nb
             if (m_loopback || (isAt.GetGuid() != m_guid)) {
                 HandleProtocolAnswer(isAt, nsPacket->GetTimer(), remote, interfaceIndex);
             }
+
+            //
+            // Our own answer heard from somewhere else, such as another of our
+            // interfaces on the same link, tells us that anyone on this link
+            // asking for it has just heard it.
+            //
+            if (isAt.GetGuid() == m_guid) {
+                ObserveAnswer(isAt, nsPacket->GetTimer(), remote, interfaceIndex);
+            }
         }
     } else {
         // Messages not received on port 9956 are version two messages.
@@ -7822,6 +7914,423 @@ void IpNameServiceImpl::PurgeMDNSPacketTracker()
     m_mutex.Unlock();
 }
 
+// Note: this function assumes the mutex is locked
+void IpNameServiceImpl::InvalidatePacketCache()
+{
+    QCC_DbgPrintf(("IpNameServiceImpl::InvalidatePacketCache()"));
+    m_packetCache.Invalidate();
+    ++m_packetBuildStats.cacheInvalidations;
+}
+
+// Note: this function assumes the mutex is locked
+void IpNameServiceImpl::CachePacket(Packet packet)
+{
+    ++m_packetBuildStats.packetsBuilt;
+    m_packetCache.Add(packet);
+}
+
+// Note: this function assumes the mutex is locked
+bool IpNameServiceImpl::RetransmitFromCache(uint64_t key, bool quietly, const qcc::IPEndpoint& destination, const qcc::IPEndpoint& source,
+                                            const int32_t interfaceIndex, const qcc::AddressFamily family)
+{
+    list<PacketCache::CachedPacket>* packets = m_packetCache.Find(key, GetCurrentPriority());
+    if (packets == NULL) {
+        return false;
+    }
+
+    QCC_DbgPrintf(("IpNameServiceImpl::RetransmitFromCache(): Sending %d cached packets", packets->size()));
+
+    int32_t burstId = 0;
+    for (list<PacketCache::CachedPacket>::iterator i = packets->begin(); i != packets->end(); ++i) {
+        uint32_t nsVersion, msgVersion;
+        i->packet->GetVersion(nsVersion, msgVersion);
+
+        //
+        // The send paths rewrite the packets they are given for each interface
+        // and may prune records from them, so we always send a copy of the
+        // cached packet.
+        //
+        if (msgVersion == 2) {
+            MDNSPacket mdnsPacket(MDNSPacket::cast(i->packet), true);
+
+            //
+            // Receivers drop packets whose search ID they have already seen,
+            // so every response we send needs a fresh one.  As in Retransmit(),
+            // all of the packets in one response share the header ID.
+            //
+            int32_t id = IncrementAndFetch(&INCREMENTAL_PACKET_ID);
+            if (burstId == 0) {
+                burstId = id;
+            }
+            MDNSHeader mdnsHeader = mdnsPacket->GetHeader();
+            mdnsHeader.SetId(burstId);
+            mdnsPacket->SetHeader(mdnsHeader);
+
+            MDNSResourceRecord* refRecord;
+            if (mdnsPacket->GetAdditionalRecord("sender-info.*", MDNSResourceRecord::TXT, MDNSTextRData::TXTVERS, &refRecord)) {
+                MDNSSenderRData* refRData = static_cast<MDNSSenderRData*>(refRecord->GetRData());
+                refRData->SetSearchID(id);
+            }
+
+            //
+            // Only responses to queries are cached, and those always go back
+            // over unicast.
+            //
+            mdnsPacket->SetSource(source);
+            mdnsPacket->SetDestination(destination);
+            SendOutboundMessageQuietly(Packet::cast(mdnsPacket));
+        } else {
+            NSPacket nspacket(NSPacket::cast(i->packet), true);
+            nspacket->SetSource(source);
+
+            if (quietly) {
+                nspacket->SetDestination(destination);
+                SendOutboundMessageQuietly(Packet::cast(nspacket));
+            } else {
+                nspacket->ClearDestination();
+                if (interfaceIndex != -1) {
+                    nspacket->SetInterfaceIndex(interfaceIndex);
+                } else {
+                    nspacket->ClearInterfaceIndex();
+                }
+                if (family != qcc::QCC_AF_UNSPEC) {
+                    nspacket->SetAddressFamily(family);
+                } else {
+                    nspacket->ClearAddressFamily();
+                }
+
+                //
+                // Let SendProtocolMessage() reuse the bytes it serialized for
+                // each interface the last time this packet went out.
+                //
+                m_packetReplay = &(*i);
+                if (source.addr != IPAddress("0.0.0.0")) {
+                    SendOutboundMessageActively(Packet::cast(nspacket), source.addr);
+                } else {
+                    SendOutboundMessageActively(Packet::cast(nspacket));
+                }
+                m_packetReplay = NULL;
+            }
+        }
+        ++m_packetBuildStats.packetsReused;
+    }
+    return true;
+}
+
+void IpNameServiceImpl::GetPacketBuildStats(PacketBuildStats& stats)
+{
+    m_mutex.Lock();
+    stats = m_packetBuildStats;
+    m_mutex.Unlock();
+}
+
+list<IpNameServiceImpl::PacketCache::CachedPacket>* IpNameServiceImpl::PacketCache::Find(uint64_t key, uint16_t priority)
+{
+    map<uint64_t, Entry>::iterator it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return NULL;
+    }
+
+    //
+    // The priority is carried in the version two SRV records, so a change in
+    // the dynamic score means the cached packets have to be rebuilt.
+    //
+    if (it->second.priority != priority) {
+        if (m_capture == &it->second) {
+            m_capture = NULL;
+        }
+        m_entries.erase(it);
+        return NULL;
+    }
+    return &it->second.packets;
+}
+
+void IpNameServiceImpl::PacketCache::BeginCapture(uint64_t key, uint16_t priority)
+{
+    m_capture = &m_entries[key];
+    m_capture->priority = priority;
+    m_capture->packets.clear();
+}
+
+bool IpNameServiceImpl::PacketCache::Add(Packet packet)
+{
+    if (m_capture == NULL) {
+        return false;
+    }
+
+    uint32_t nsVersion, msgVersion;
+    packet->GetVersion(nsVersion, msgVersion);
+
+    if (msgVersion == 2) {
+        MDNSPacket clone(MDNSPacket::cast(packet), true);
+        m_capture->packets.push_back(CachedPacket(Packet::cast(clone)));
+    } else {
+        NSPacket clone(NSPacket::cast(packet), true);
+        m_capture->packets.push_back(CachedPacket(Packet::cast(clone)));
+    }
+    return true;
+}
+
+void IpNameServiceImpl::PacketCache::Invalidate()
+{
+    m_entries.clear();
+    m_capture = NULL;
+}
+
+void IpNameServiceImpl::PacketCache::ClearSerialized()
+{
+    for (map<uint64_t, Entry>::iterator i = m_entries.begin(); i != m_entries.end(); ++i) {
+        for (list<CachedPacket>::iterator j = i->second.packets.begin(); j != i->second.packets.end(); ++j) {
+            j->serialized.clear();
+        }
+    }
+}
+
+bool IpNameServiceImpl::ResponseTracker::Answer(const qcc::String& key, uint64_t now)
+{
+    map<String, Entry>::iterator it = m_entries.find(key);
+    if (it != m_entries.end() && now < it->second.sent + m_interval) {
+        return false;
+    }
+
+    Entry entry;
+    entry.sent = now;
+    entry.pending = false;
+    m_entries[key] = entry;
+    return true;
+}
+
+bool IpNameServiceImpl::ResponseTracker::Defer(const qcc::String& key, uint64_t& due)
+{
+    map<String, Entry>::iterator it = m_entries.find(key);
+    QCC_ASSERT(it != m_entries.end() && "IpNameServiceImpl::ResponseTracker::Defer(): Response was never answered");
+    if (it == m_entries.end() || it->second.pending) {
+        return false;
+    }
+    it->second.pending = true;
+    due = it->second.sent + m_interval;
+    return true;
+}
+
+bool IpNameServiceImpl::ResponseTracker::Observe(const qcc::String& key, uint64_t now)
+{
+    map<String, Entry>::iterator it = m_entries.find(key);
+    bool pending = (it != m_entries.end()) && it->second.pending;
+
+    Entry entry;
+    entry.sent = now;
+    entry.pending = false;
+    m_entries[key] = entry;
+    return pending;
+}
+
+void IpNameServiceImpl::ResponseTracker::Purge(uint64_t now)
+{
+    map<String, Entry>::iterator it = m_entries.begin();
+    while (it != m_entries.end()) {
+        if (!it->second.pending && now >= it->second.sent + m_interval) {
+            m_entries.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Note: this function assumes the mutex is locked
+qcc::String IpNameServiceImpl::ResponseKey(uint32_t transportIndex, bool quietly, const qcc::IPEndpoint& destination, uint8_t type,
+                                           TransportMask completeTransportMask, const vector<qcc::String>& wkns,
+                                           const int32_t interfaceIndex, const qcc::AddressFamily family)
+{
+    //
+    // Version two responses and quiet responses go back over unicast to the
+    // querier, everything else is multicast out the interface the question
+    // arrived on.  The key must capture everything that determines what we
+    // send and where we send it.  Only unicast responses are limited to the
+    // names asked about, a multicast response carries all of our actively
+    // advertised names whatever the question was.
+    //
+    bool unicast = quietly || (type & TRANSMIT_V2);
+    String key = U32ToString(type) + "," + U32ToString(transportIndex) + "," + U32ToString(completeTransportMask) + "," + (quietly ? "q" : "a");
+    if (unicast) {
+        key += "," + destination.ToString();
+        for (vector<String>::const_iterator it = wkns.begin(); it != wkns.end(); ++it) {
+            key += "," + *it;
+        }
+    } else {
+        key += "," + I32ToString(interfaceIndex) + "," + U32ToString(family);
+    }
+    return key;
+}
+
+// Note: this function assumes the mutex is locked
+bool IpNameServiceImpl::SuppressResponse(uint32_t transportIndex, bool quietly, const qcc::IPEndpoint& destination, const qcc::IPEndpoint& source,
+                                         uint8_t type, TransportMask completeTransportMask, vector<qcc::String>& wkns,
+                                         const int32_t interfaceIndex, const qcc::AddressFamily family)
+{
+    bool unicast = quietly || (type & TRANSMIT_V2);
+    String key = ResponseKey(transportIndex, quietly, destination, type, completeTransportMask, wkns, interfaceIndex, family);
+
+    //
+    // Only bother clearing out old responses once there are enough of them
+    // to be worth the walk.
+    //
+    static const size_t MAX_TRACKED_RESPONSES = 256;
+
+    Timespec<MonotonicTime> now;
+    GetTimeNow(&now);
+    if (m_responseTracker.Size() > MAX_TRACKED_RESPONSES) {
+        m_responseTracker.Purge(now.GetMillis());
+    }
+
+    if (m_responseTracker.Answer(key, now.GetMillis())) {
+        ++m_packetBuildStats.responsesSent;
+        return false;
+    }
+
+    //
+    // The querier has just been sent everything it is asking about, so there
+    // is nothing new for it in another response.  Questions that arrive from
+    // other hosts within the interval, or are duplicates of one we have
+    // answered, end up here too.
+    //
+    if (unicast) {
+        QCC_DbgPrintf(("IpNameServiceImpl::SuppressResponse(): Suppressing duplicate response to %s", destination.ToString().c_str()));
+        ++m_packetBuildStats.responsesSuppressed;
+        return true;
+    }
+
+    //
+    // We can't tell whether whoever is asking heard our last multicast
+    // response, so rather than answering right away, we answer once the
+    // suppression interval has passed.  Everyone asking the same question
+    // until then gets that one response.
+    //
+    DeferredResponse deferred;
+    if (!m_responseTracker.Defer(key, deferred.due)) {
+        QCC_DbgPrintf(("IpNameServiceImpl::SuppressResponse(): Merging with pending response"));
+        ++m_packetBuildStats.responsesMerged;
+        return true;
+    }
+
+    QCC_DbgPrintf(("IpNameServiceImpl::SuppressResponse(): Deferring response"));
+    ++m_packetBuildStats.responsesSuppressed;
+    deferred.key = key;
+    deferred.transportIndex = transportIndex;
+    deferred.source = source;
+    deferred.type = type;
+    deferred.completeTransportMask = completeTransportMask;
+    deferred.wkns = wkns;
+    deferred.interfaceIndex = interfaceIndex;
+    deferred.family = family;
+    m_deferredResponses.push_back(deferred);
+
+    //
+    // Make sure the main thread runs the periodic maintenance timer.
+    //
+    m_wakeEvent.SetEvent();
+    return true;
+}
+
+// Note: this function assumes the mutex is locked
+void IpNameServiceImpl::SendDeferredResponses()
+{
+    Timespec<MonotonicTime> now;
+    GetTimeNow(&now);
+
+    list<DeferredResponse>::iterator it = m_deferredResponses.begin();
+    while (it != m_deferredResponses.end()) {
+        if (now.GetMillis() < it->due) {
+            ++it;
+            continue;
+        }
+        DeferredResponse deferred = *it;
+        m_deferredResponses.erase(it++);
+
+        QCC_DbgPrintf(("IpNameServiceImpl::SendDeferredResponses(): Retransmit()"));
+        m_responseTracker.Answer(deferred.key, now.GetMillis());
+        ++m_packetBuildStats.responsesSent;
+        Retransmit(deferred.transportIndex, false, false, qcc::IPEndpoint("0.0.0.0", 0), deferred.source, deferred.type,
+                   deferred.completeTransportMask, deferred.wkns, deferred.interfaceIndex, deferred.family);
+    }
+}
+
+void IpNameServiceImpl::ObserveAnswer(IsAt isAt, uint32_t timer, const qcc::IPEndpoint& remote, int32_t interfaceIndex)
+{
+    //
+    // A goodbye is not the answer to anything.
+    //
+    if (timer == 0 || !isAt.GetCompleteFlag()) {
+        return;
+    }
+
+    uint32_t nsVersion, msgVersion;
+    isAt.GetVersion(nsVersion, msgVersion);
+    uint32_t transportIndex;
+    if (msgVersion == 0) {
+        transportIndex = TRANSPORT_INDEX_TCP;
+    } else {
+        TransportMask transportMask = isAt.GetTransportMask();
+        if (CountOnes(transportMask) != 1) {
+            return;
+        }
+        transportIndex = IndexFromBit(transportMask);
+        if (transportIndex >= N_TRANSPORTS) {
+            return;
+        }
+    }
+
+    m_mutex.Lock();
+
+    //
+    // Our own multicast answers come back to us on the interface we sent them
+    // out on, and we already know about those.
+    //
+    if (remote.port == MULTICAST_PORT) {
+        for (uint32_t i = 0; i < m_liveInterfaces.size(); ++i) {
+            if ((m_liveInterfaces[i].m_index == static_cast<uint32_t>(interfaceIndex)) && (m_liveInterfaces[i].m_address == remote.addr)) {
+                m_mutex.Unlock();
+                return;
+            }
+        }
+    }
+
+    //
+    // The answer is only as good as ours if it carries exactly the names our
+    // multicast response would.
+    //
+    set<String>& advertised = m_advertised[transportIndex];
+    bool identical = isAt.GetNumberNames() == advertised.size();
+    for (uint32_t i = 0; identical && i < isAt.GetNumberNames(); ++i) {
+        identical = advertised.find(isAt.GetName(i)) != advertised.end();
+    }
+    if (!identical) {
+        m_mutex.Unlock();
+        return;
+    }
+
+    qcc::AddressFamily family = remote.addr.IsIPv4() ? qcc::QCC_AF_INET : qcc::QCC_AF_INET6;
+    uint8_t type = (msgVersion == 0) ? TRANSMIT_V0 : TRANSMIT_V1;
+    String key = ResponseKey(transportIndex, false, remote, type, MaskFromIndex(transportIndex), vector<String>(), interfaceIndex, family);
+
+    QCC_DbgPrintf(("IpNameServiceImpl::ObserveAnswer(): Answer from %s is identical to ours", remote.ToString().c_str()));
+    ++m_packetBuildStats.answersObserved;
+
+    Timespec<MonotonicTime> now;
+    GetTimeNow(&now);
+    if (m_responseTracker.Observe(key, now.GetMillis())) {
+        list<DeferredResponse>::iterator it = m_deferredResponses.begin();
+        while (it != m_deferredResponses.end()) {
+            if (it->key == key) {
+                QCC_DbgPrintf(("IpNameServiceImpl::ObserveAnswer(): Dropping pending response"));
+                m_deferredResponses.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+    m_mutex.Unlock();
+}
+
 bool IpNameServiceImpl::IsMDNSPacketTrackerEmpty()
 {
     m_mutex.Lock();
@@ -8392,11 +8901,10 @@ bool IpNameServiceImpl::HandleSearchQuery(TransportMask completeTransportMask, M
         // Since any response we send must include all of the advertisements we
         // are exporting; this just means to retransmit all of our advertisements.
         //
-        if (respond) {
+        if (respond && dst.GetAddress().IsIPv4() &&
+            !SuppressResponse(index, respondQuietly, dst, src, TRANSMIT_V2, completeTransportMask, wkns, -1, qcc::QCC_AF_UNSPEC)) {
             m_mutex.Unlock();
-            if (dst.GetAddress().IsIPv4()) {
-                Retransmit(index, false, respondQuietly, dst, src, TRANSMIT_V2, completeTransportMask, wkns);
-            }
+            Retransmit(index, false, respondQuietly, dst, src, TRANSMIT_V2, completeTransportMask, wkns);
             m_mutex.Lock();
         }
     }
@@ -8624,7 +9132,7 @@ bool IpNameServiceImpl::PurgeAndUpdatePacket(MDNSPacket mdnspacket, bool updateS
         uint32_t numSearch = searchRData->GetNumSearchCriteria();
         for (uint32_t k = 0; k < numSearch; k++) {
             String crit = searchRData->GetSearchCriterion(k);
-            if (std::find(set_union_tcp_udp.begin(), set_union_tcp_udp.end(), crit) == set_union_tcp_udp.end()) {
+            if (set_union_tcp_udp.find(crit) == set_union_tcp_udp.end()) {
                 searchRData->RemoveSearchCriterion(k);
                 k--;
                 numSearch = searchRData->GetNumSearchCriteria();
@@ -8673,12 +9181,12 @@ bool IpNameServiceImpl::PurgeAndUpdatePacket(MDNSPacket mdnspacket, bool updateS
             set<String> advertising = GetAdvertising(tm);
             set<String> advertisingQuietly = GetAdvertisingQuietly(tm);
             numNames[i] = advRData->GetNumNames(tm);
-            for (uint32_t k = 0; k < numNames[i]; k++) {
-                if (ttl == 0) {
-                    //If this is a packet with ttl == 0, ensure that we are NOT advertising the names mentioned in the packet.
 
-                    if (std::find(advertising.begin(), advertising.end(), advRData->GetNameAt(tm, k)) != advertising.end() ||
-                        (isUnicast && (std::find(advertisingQuietly.begin(), advertisingQuietly.end(), advRData->GetNameAt(tm, k)) != advertisingQuietly.end()))) {
+            if (ttl == 0) {
+                //If this is a packet with ttl == 0, ensure that we are NOT advertising the names mentioned in the packet.
+                for (uint32_t k = 0; k < numNames[i]; k++) {
+                    if (advertising.find(advRData->GetNameAt(tm, k)) != advertising.end() ||
+                        (isUnicast && (advertisingQuietly.find(advRData->GetNameAt(tm, k)) != advertisingQuietly.end()))) {
 
                         advRData->RemoveNameAt(tm, k);
                         // a name has been removed from the IsAt response header make
@@ -8687,21 +9195,25 @@ bool IpNameServiceImpl::PurgeAndUpdatePacket(MDNSPacket mdnspacket, bool updateS
                         k = k - 1;
                         numNames[i] = advRData->GetNumNames(tm);
                     }
-                } else {
-                    //If this is a packet with ttl >0, ensure that we are still advertising all the names mentioned in the packet.
-                    // If only one of the transports has been enabled because the interface specified for the other transport
-                    // is yet to be IFF_UP, then restrict the search space to only the transport that is enabled.
-
-                    if ((tm == (TRANSPORT_TCP | TRANSPORT_UDP)) && m_enabledReliableIPv4[TRANSPORT_INDEX_TCP] && !m_enabledUnreliableIPv4[TRANSPORT_INDEX_UDP]) {
+                }
+            } else {
+                //If this is a packet with ttl >0, ensure that we are still advertising all the names mentioned in the packet.
+                // If only one of the transports has been enabled because the interface specified for the other transport
+                // is yet to be IFF_UP, then restrict the search space to only the transport that is enabled.  This is
+                // worked out once per transport mask rather than once per name.
+                if (numNames[i] && (tm == (TRANSPORT_TCP | TRANSPORT_UDP))) {
+                    if (m_enabledReliableIPv4[TRANSPORT_INDEX_TCP] && !m_enabledUnreliableIPv4[TRANSPORT_INDEX_UDP]) {
                         advertising = GetAdvertising(TRANSPORT_TCP);
                         advertisingQuietly = GetAdvertisingQuietly(TRANSPORT_TCP);
                     }
-                    if ((tm == (TRANSPORT_TCP | TRANSPORT_UDP)) && !m_enabledReliableIPv4[TRANSPORT_INDEX_TCP] && m_enabledUnreliableIPv4[TRANSPORT_INDEX_UDP]) {
+                    if (!m_enabledReliableIPv4[TRANSPORT_INDEX_TCP] && m_enabledUnreliableIPv4[TRANSPORT_INDEX_UDP]) {
                         advertising = GetAdvertising(TRANSPORT_UDP);
                         advertisingQuietly = GetAdvertisingQuietly(TRANSPORT_UDP);
                     }
-                    if (std::find(advertising.begin(), advertising.end(), advRData->GetNameAt(tm, k)) == advertising.end() &&
-                        (!isUnicast || (std::find(advertisingQuietly.begin(), advertisingQuietly.end(), advRData->GetNameAt(tm, k)) == advertisingQuietly.end()))) {
+                }
+                for (uint32_t k = 0; k < numNames[i]; k++) {
+                    if (advertising.find(advRData->GetNameAt(tm, k)) == advertising.end() &&
+                        (!isUnicast || (advertisingQuietly.find(advRData->GetNameAt(tm, k)) == advertisingQuietly.end()))) {
 
                         advRData->RemoveNameAt(tm, k);
                         // a name has been removed from the IsAt response header make
@@ -8709,9 +9221,7 @@ bool IpNameServiceImpl::PurgeAndUpdatePacket(MDNSPacket mdnspacket, bool updateS
                         // the removal of that name.
                         k = k - 1;
                         numNames[i] = advRData->GetNumNames(tm);
-
                     }
-
                 }
             }
             numNamesTotal += numNames[i];
@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <list>
+#include <map>
 
 #include <qcc/String.h>
 #include <qcc/Thread.h>
@@ -180,6 +181,14 @@ class IpNameServiceImpl : public qcc::Thread {
      */
     static const uint32_t BURST_RESPONSE_RETRIES = 3;
 
+    /**
+     * The minimum time between identical responses to questions, either
+     * multicast out the same interface or unicast to the same querier.
+     * Questions answered by a response sent within this interval are not
+     * answered again.  Units are in milli-seconds.
+     */
+    static const uint32_t RESPONSE_SUPPRESSION_INTERVAL = 1000;
+
     /**
      * @brief The maximum size of the payload of a name service message.
      *
@@ -550,6 +559,194 @@ class IpNameServiceImpl : public qcc::Thread {
 
     QStatus UpdateDynamicScore(TransportMask transportMask, uint32_t availableTransportConnections, uint32_t maximumTransportConnections, uint32_t availableTransportRemoteClients, uint32_t maximumTransportRemoteClients);
 
+    /**
+     * @brief Counters describing the work done building and serializing
+     * name service packets.
+     */
+    struct PacketBuildStats {
+        uint32_t packetsBuilt;          /**< Packets built from the advertised names */
+        uint32_t packetsReused;         /**< Packets sent from the packet cache instead of being built */
+        uint32_t packetsSerialized;     /**< Packets serialized for an interface */
+        uint32_t serializationsReused;  /**< Serialized packets sent from the cache instead of being serialized */
+        uint32_t cacheInvalidations;    /**< Times the advertisements or port maps changed */
+        uint32_t responsesSuppressed;   /**< Questions not answered since the answer was just sent */
+        uint32_t responsesMerged;       /**< Questions folded into a response already waiting to be sent */
+        uint32_t responsesSent;         /**< Responses to questions sent, right away or once deferred */
+        uint32_t answersObserved;       /**< Answers identical to one of ours received from another host */
+    };
+
+    /**
+     * @brief Get a snapshot of the packet build counters.
+     *
+     * @param stats Filled in with the current counters.
+     */
+    void GetPacketBuildStats(PacketBuildStats& stats);
+
+    /**
+     * @brief Keeps track of the responses recently sent to questions, in the
+     * spirit of mDNS known-answer and duplicate-question suppression (RFC
+     * 6762 sections 7.1 and 7.3).
+     *
+     * Each response is identified by a key describing everything that goes
+     * into it and where it is sent.  A response that was sent less than the
+     * suppression interval ago need not be sent again.  A multicast response
+     * is instead deferred until the interval has passed, and any further
+     * questions that arrive in the meantime are merged into that pending
+     * response.  An identical response received from another host counts as
+     * though it had been sent by us.
+     */
+    class ResponseTracker {
+      public:
+        ResponseTracker(uint32_t interval) : m_interval(interval) { }
+
+        /**
+         * @brief Decide whether a response may be sent now.  If it may, it is
+         * recorded as having been sent at the given time.
+         *
+         * @param key  Identifies the response.
+         * @param now  The current time in milliseconds.
+         *
+         * @return true if the response should be sent now, false if an
+         *     identical response was sent within the suppression interval.
+         */
+        bool Answer(const qcc::String& key, uint64_t now);
+
+        /**
+         * @brief Mark a suppressed response as waiting to be sent once the
+         * suppression interval has passed.
+         *
+         * @param key  Identifies the response.
+         * @param due  Filled in with the time at which the response may be sent.
+         *
+         * @return true if the caller should schedule the response, false if
+         *     it is already pending and the question has been merged into it.
+         */
+        bool Defer(const qcc::String& key, uint64_t& due);
+
+        /**
+         * @brief Record that a response identical to ours was seen on the
+         * wire.  Anyone who asked for it has now heard it, so it counts as
+         * sent at the given time and a pending response is no longer needed.
+         *
+         * @param key  Identifies the response.
+         * @param now  The current time in milliseconds.
+         *
+         * @return true if a pending response was satisfied and should be
+         *     dropped by the caller.
+         */
+        bool Observe(const qcc::String& key, uint64_t now);
+
+        /**
+         * @brief Forget responses sent longer than the suppression interval
+         * ago that are not waiting to be sent.
+         */
+        void Purge(uint64_t now);
+
+        size_t Size() const { return m_entries.size(); }
+
+      private:
+        struct Entry {
+            uint64_t sent;
+            bool pending;
+        };
+        uint32_t m_interval;
+        std::map<qcc::String, Entry> m_entries;
+    };
+
+    /**
+     * @brief The packets built by Retransmit() in answer to questions, keyed
+     * by the Retransmit() arguments they depend on.
+     *
+     * Each entry also remembers the priority the packets were built with,
+     * since the priority is carried in the version two SRV records.  Version
+     * zero and one packets keep their serialized form for each live interface
+     * they have been sent out on, until the live interfaces are next torn
+     * down.
+     */
+    class PacketCache {
+      public:
+        /**
+         * @brief A version zero or one packet serialized for one live interface.
+         */
+        struct SerializedPacket {
+            qcc::IPAddress address;         /**< The live interface address the packet was rewritten for */
+            std::vector<uint8_t> buffer;
+        };
+
+        /**
+         * @brief A cached packet along with its serialized form for each live
+         * interface, indexed by interface.
+         */
+        struct CachedPacket {
+            Packet packet;
+            std::map<uint32_t, SerializedPacket> serialized;
+            CachedPacket(Packet packet) : packet(packet) { }
+        };
+
+        PacketCache() : m_capture(NULL) { }
+
+        /**
+         * @brief Build the key for the packets built by Retransmit().
+         */
+        static uint64_t Key(TransportMask completeTransportMask, uint32_t transportIndex, uint8_t type, bool quietly)
+        {
+            return (static_cast<uint64_t>(completeTransportMask) << 32) | (transportIndex << 16) | (type << 8) | (quietly ? 1 : 0);
+        }
+
+        /**
+         * @brief Find the packets cached for a key.  Packets built with a
+         * different priority are dropped.
+         *
+         * @param key       Identifies the packets.
+         * @param priority  The current priority.
+         *
+         * @return The cached packets or NULL if there are none.
+         */
+        std::list<CachedPacket>* Find(uint64_t key, uint16_t priority);
+
+        /**
+         * @brief Start recording the packets built for a key, replacing any
+         * that were cached for it.
+         */
+        void BeginCapture(uint64_t key, uint16_t priority);
+
+        /**
+         * @brief Record a copy of a packet if a capture is in progress.  The
+         * packet is cloned since Retransmit() reuses the same packet for each
+         * partial list it sends.
+         *
+         * @return true if the packet was recorded.
+         */
+        bool Add(Packet packet);
+
+        /**
+         * @brief Stop recording packets.
+         */
+        void EndCapture() { m_capture = NULL; }
+
+        /**
+         * @brief Drop every cached packet.  Called whenever the advertised
+         * names, port maps or advertisement duration change.
+         */
+        void Invalidate();
+
+        /**
+         * @brief Drop the serialized forms of the cached packets.  Called when
+         * the live interfaces are torn down.
+         */
+        void ClearSerialized();
+
+        size_t Size() const { return m_entries.size(); }
+
+      private:
+        struct Entry {
+            uint16_t priority;              /**< The priority when the packets were built */
+            std::list<CachedPacket> packets;
+        };
+        std::map<uint64_t, Entry> m_entries;
+        Entry* m_capture;                   /**< The entry being filled in, if any */
+    };
+
     /**
      * @brief Ask the name service whether or not it thinks there is or is not a
      *     listener on the specified ports for the given transport.
@@ -1692,6 +1889,90 @@ class IpNameServiceImpl : public qcc::Thread {
     DynamicParams m_dynamicParams[N_TRANSPORTS];
     bool PurgeAndUpdatePacket(MDNSPacket mdnspacket, bool updateSid);
     void PurgeMDNSPacketTracker();
+
+    /**
+     * @internal
+     * @brief Invalidate the cached packets.  Called whenever the advertised
+     * names, port maps or advertisement duration change.
+     */
+    void InvalidatePacketCache();
+
+    /**
+     * @internal
+     * @brief Record a packet built by Retransmit() so that it may be resent
+     * from the packet cache.
+     */
+    void CachePacket(Packet packet);
+
+    /**
+     * @internal
+     * @brief Resend the packets previously built by Retransmit() for the same
+     * arguments, if they are still valid.
+     *
+     * @return true if the packets were sent from the cache.
+     */
+    bool RetransmitFromCache(uint64_t key, bool quietly, const qcc::IPEndpoint& destination, const qcc::IPEndpoint& source,
+                             const int32_t interfaceIndex, const qcc::AddressFamily family);
+
+    PacketCache m_packetCache;
+    PacketCache::CachedPacket* m_packetReplay; /**< The cached packet being sent by RetransmitFromCache(), if any */
+
+    /**
+     * @internal
+     * @brief Decide whether a response to a question should be sent now.
+     * The arguments are those that would be passed to Retransmit().  A
+     * multicast response that is suppressed is deferred and sent from
+     * DoPeriodicMaintenance() instead.
+     *
+     * @return true if the response should not be sent now.
+     */
+    bool SuppressResponse(uint32_t transportIndex, bool quietly, const qcc::IPEndpoint& destination, const qcc::IPEndpoint& source,
+                          uint8_t type, TransportMask completeTransportMask, std::vector<qcc::String>& wkns,
+                          const int32_t interfaceIndex, const qcc::AddressFamily family);
+
+    /**
+     * @internal
+     * @brief Build the key that identifies a response in the response
+     * tracker.  The arguments are those that would be passed to Retransmit().
+     */
+    qcc::String ResponseKey(uint32_t transportIndex, bool quietly, const qcc::IPEndpoint& destination, uint8_t type,
+                            TransportMask completeTransportMask, const std::vector<qcc::String>& wkns,
+                            const int32_t interfaceIndex, const qcc::AddressFamily family);
+
+    /**
+     * @internal
+     * @brief Feed an answer received from another host into the response
+     * tracker if it is identical to the multicast response we would send on
+     * the interface it arrived on.
+     */
+    void ObserveAnswer(IsAt isAt, uint32_t timer, const qcc::IPEndpoint& remote, int32_t interfaceIndex);
+
+    /**
+     * @internal
+     * @brief Send the deferred responses whose suppression interval has
+     * passed.
+     */
+    void SendDeferredResponses();
+
+    /**
+     * @internal
+     * @brief A multicast response deferred by SuppressResponse().
+     */
+    struct DeferredResponse {
+        qcc::String key;
+        uint64_t due;
+        uint32_t transportIndex;
+        qcc::IPEndpoint source;
+        uint8_t type;
+        TransportMask completeTransportMask;
+        std::vector<qcc::String> wkns;
+        int32_t interfaceIndex;
+        qcc::AddressFamily family;
+    };
+    ResponseTracker m_responseTracker;
+    std::list<DeferredResponse> m_deferredResponses;
+
+    PacketBuildStats m_packetBuildStats;
     bool IsMDNSPacketTrackerEmpty();
 };
 
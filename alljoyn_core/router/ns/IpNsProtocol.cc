@@ -2211,11 +2211,15 @@ size_t MDNSTextRData::GetSerializedSize(std::map<qcc::String, uint32_t>& offsets
     Fields::const_iterator it = m_fields.begin();
 
     while (it != m_fields.end()) {
-        String str = it->first;
+        //
+        // Each entry is serialized as a length byte followed by "key" or
+        // "key=value".  Compute the size directly rather than building the
+        // string, this is called for every name added to a packet.
+        //
+        rdlen += 1 + it->first.length();
         if (!it->second.empty()) {
-            str += "=" + it->second;
+            rdlen += 1 + it->second.length();
         }
-        rdlen += str.length() + 1;
         it++;
     }
     return rdlen + 2;
@@ -713,6 +713,42 @@ bool _PolicyDB::CheckMessage(bool& allow, const PolicyRuleList& ruleList,
 }
 
 
+bool _PolicyDB::CheckDestNameNeeded(const PolicyRuleList& ruleList, const NormalizedMsgHdr& nmh)
+{
+    for (PolicyRuleList::const_iterator it = ruleList.begin(); it != ruleList.end(); ++it) {
+        if ((it->busName != WILDCARD) &&
+            it->CheckType(nmh.type) &&
+            it->CheckInterface(nmh.ifcID) &&
+            it->CheckMember(nmh.memberID) &&
+            it->CheckPath(nmh.pathID, nmh.pathIDSet) &&
+            it->CheckError(nmh.errorID)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool _PolicyDB::SendNeedsDestName(const NormalizedMsgHdr& nmh) const
+{
+    if (CheckDestNameNeeded(sendRS.mandatoryRules, nmh)) {
+        return true;
+    }
+
+    IDRuleMap::const_iterator it = sendRS.userRules.find(nmh.sender->GetUserId());
+    if ((it != sendRS.userRules.end()) && CheckDestNameNeeded(it->second, nmh)) {
+        return true;
+    }
+
+    it = sendRS.groupRules.find(nmh.sender->GetGroupId());
+    if ((it != sendRS.groupRules.end()) && CheckDestNameNeeded(it->second, nmh)) {
+        return true;
+    }
+
+    return CheckDestNameNeeded(sendRS.defaultRules, nmh);
+}
+
+
 
 bool _PolicyDB::OKToConnect(uint32_t uid, uint32_t gid) const
 {
@@ -806,6 +842,16 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
     bool allow = true;
     bool ruleMatch = false;
 
+    uint32_t destUid = dest->GetUserId();
+    uint32_t gid = dest->GetGroupId();
+    const uint64_t verdictKey = VerdictKey(destUid, gid);
+    unordered_map<uint64_t, bool>::const_iterator vit = nmh.receiveVerdicts.find(verdictKey);
+    if (vit != nmh.receiveVerdicts.end()) {
+        QCC_DbgPrintf(("Endpoint %s %s to receive %s (cached)", dest->GetUniqueName().c_str(),
+                       vit->second ? "allowed" : "not allowed", nmh.msg->Description().c_str()));
+        return vit->second;
+    }
+
     QCC_DbgPrintf(("Check if OK for endpoint %s to receive %s (%s{%s} --> %s{%s})",
                    dest->GetUniqueName().c_str(), nmh.msg->Description().c_str(),
                    nmh.msg->GetSender(), IDSet2String(nmh.senderIDSet).c_str(),
@@ -813,7 +859,6 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
 
     uint32_t senderUid = nmh.sender->GetUserId();
     uint32_t senderGid = nmh.sender->GetGroupId();
-    uint32_t destUid = dest->GetUserId();
     if (!receiveRS.mandatoryRules.empty()) {
         QCC_DbgPrintf(("    checking mandatory receive rules"));
         ruleMatch = CheckMessage(allow, receiveRS.mandatoryRules, nmh, nmh.senderIDSet, senderUid, destUid, senderGid);
@@ -827,7 +872,6 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
         }
     }
 
-    uint32_t gid = dest->GetGroupId();
     if (!ruleMatch && !receiveRS.groupRules.empty()) {
         IDRuleMap::const_iterator it = receiveRS.groupRules.find(gid);
         if (it != receiveRS.groupRules.end()) {
@@ -841,6 +885,7 @@ bool _PolicyDB::OKToReceive(const NormalizedMsgHdr& nmh, BusEndpoint& dest) cons
         ruleMatch = CheckMessage(allow, receiveRS.defaultRules, nmh, nmh.senderIDSet, senderUid, destUid, senderGid);
     }
 
+    nmh.receiveVerdicts[verdictKey] = allow;
     return allow;
 }
 
@@ -850,13 +895,6 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
     /* Implicitly default to allow messages to be sent. */
     bool allow = true;
     bool ruleMatch = false;
-    const IDSet destIDSet = LookupBusNameID(dest->GetUniqueName().c_str());
-
-    QCC_DbgPrintf(("Check if OK for endpoint %s to send %s to destination %s (%s{%s} --> %s{%s})",
-                   nmh.sender->GetUniqueName().c_str(), nmh.msg->Description().c_str(),
-                   (dest->IsValid() ? dest->GetUniqueName().c_str() : ""),
-                   nmh.msg->GetSender(), IDSet2String(nmh.senderIDSet).c_str(),
-                   nmh.msg->GetDestination(), IDSet2String(destIDSet).c_str()));
 
     uint32_t destUid = ((uint32_t)-1);
     uint32_t destGid = ((uint32_t)-1);
@@ -866,6 +904,29 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
         destGid = dest->GetGroupId();
     }
 
+    const uint64_t verdictKey = VerdictKey(destUid, destGid);
+    if (!nmh.sendNeedsDestName) {
+        unordered_map<uint64_t, bool>::const_iterator vit = nmh.sendVerdicts.find(verdictKey);
+        if (vit != nmh.sendVerdicts.end()) {
+            QCC_DbgPrintf(("Endpoint %s %s to send %s to destination %s (cached)",
+                           nmh.sender->GetUniqueName().c_str(), vit->second ? "allowed" : "not allowed",
+                           nmh.msg->Description().c_str(), (dest->IsValid() ? dest->GetUniqueName().c_str() : "")));
+            return vit->second;
+        }
+    }
+
+    /*
+     * Looking up the bus names of the destination requires a copy of its
+     * alias set so skip it when none of the matching rules need it.
+     */
+    const IDSet destIDSet = nmh.sendNeedsDestName ? LookupBusNameID(dest->GetUniqueName().c_str()) : IDSet();
+
+    QCC_DbgPrintf(("Check if OK for endpoint %s to send %s to destination %s (%s{%s} --> %s{%s})",
+                   nmh.sender->GetUniqueName().c_str(), nmh.msg->Description().c_str(),
+                   (dest->IsValid() ? dest->GetUniqueName().c_str() : ""),
+                   nmh.msg->GetSender(), IDSet2String(nmh.senderIDSet).c_str(),
+                   nmh.msg->GetDestination(), IDSet2String(destIDSet).c_str()));
+
     uint32_t senderUid = nmh.sender->GetUserId();
     if (!sendRS.mandatoryRules.empty()) {
         QCC_DbgPrintf(("    checking mandatory send rules"));
@@ -894,5 +955,8 @@ bool _PolicyDB::OKToSend(const NormalizedMsgHdr& nmh, BusEndpoint& dest) const
         ruleMatch = CheckMessage(allow, sendRS.defaultRules, nmh, destIDSet, destUid, senderUid, destGid);
     }
 
+    if (!nmh.sendNeedsDestName) {
+        nmh.sendVerdicts[verdictKey] = allow;
+    }
     return allow;
 }
@@ -462,6 +462,42 @@ class _PolicyDB {
                              const NormalizedMsgHdr& nmh, const IDSet& bnIDSet,
                              uint32_t userId, uint32_t userId2, uint32_t groupId);
 
+    /**
+     * Check rule list for a rule that matches the message but still depends
+     * on the bus name of the destination.
+     *
+     * @param ruleList  rule list to search
+     * @param nmh       normalized message header
+     *
+     * @return  true if such a rule was found, false otherwise
+     */
+    static bool CheckDestNameNeeded(const PolicyRuleList& ruleList, const NormalizedMsgHdr& nmh);
+
+    /**
+     * Determine if the send rules that apply to the sender of a message
+     * depend on the bus name of the destination.  If they do not, the send
+     * verdict only depends on the user and group ID of the destination.
+     *
+     * @param nmh       normalized message header
+     *
+     * @return  true if the destination bus name must be checked, false otherwise
+     */
+    bool SendNeedsDestName(const NormalizedMsgHdr& nmh) const;
+
+    /**
+     * Build the key under which verdicts for a destination are cached in the
+     * normalized message header.
+     *
+     * @param uid       numeric user ID of the destination
+     * @param gid       numeric group ID of the destination
+     *
+     * @return  The verdict cache key
+     */
+    static uint64_t VerdictKey(uint32_t uid, uint32_t gid)
+    {
+        return (static_cast<uint64_t>(uid) << 32) | gid;
+    }
+
     PolicyRuleListSet ownRS;        /**< bus name ownership policy rule sets */
     PolicyRuleListSet sendRS;       /**< sender message policy rule sets */
     PolicyRuleListSet receiveRS;    /**< receiver message policy rule sets */
@@ -500,7 +536,8 @@ class NormalizedMsgHdr {
         pathIDSet(policy->LookupStringIDPrefix(msg->GetObjectPath(), '/')),
         senderIDSet(policy->LookupBusNameID(msg->GetSender())),
         type(msg->GetType()),
-        sender(sender)
+        sender(sender),
+        sendNeedsDestName(true)
     {
         if (destIDSet->empty()) {
             const char* destStr = msg->GetDestination();
@@ -522,8 +559,33 @@ class NormalizedMsgHdr {
                 }
             }
         }
+        sendNeedsDestName = policy->SendNeedsDestName(*this);
     }
 
+    /**
+     * Determine if the send verdicts for this message depend on the bus name
+     * of the destination, in which case they are never cached.
+     *
+     * @return  true if the send verdicts are not cached.
+     */
+    bool SendNeedsDestName() const { return sendNeedsDestName; }
+
+    /**
+     * Get the number of distinct destination user and group IDs for which a
+     * send verdict has been cached.
+     *
+     * @return  The number of cached send verdicts.
+     */
+    size_t CachedSendVerdicts() const { return sendVerdicts.size(); }
+
+    /**
+     * Get the number of distinct destination user and group IDs for which a
+     * receive verdict has been cached.
+     *
+     * @return  The number of cached receive verdicts.
+     */
+    size_t CachedReceiveVerdicts() const { return receiveVerdicts.size(); }
+
   private:
     friend class _PolicyDB;  /**< Give PolicyDB access to the internals */
     /* private copy constructor */
@@ -543,6 +605,17 @@ class NormalizedMsgHdr {
     _PolicyDB::IDSet senderIDSet;           /**< set of normalized well known bus name senders */
     AllJoynMessageType type;                /**< message type */
     BusEndpoint& sender;                    /**< sender bus endpoint */
+
+    /*
+     * Apart from the destination bus name, the only destination specific
+     * inputs to the send and receive rules are the destination's user and
+     * group IDs.  The verdicts are cached here by those IDs so that routing
+     * a broadcast to many endpoints only walks the rule lists once for each
+     * distinct user and group.
+     */
+    bool sendNeedsDestName;                                 /**< a matching send rule checks the destination bus name */
+    mutable std::unordered_map<uint64_t, bool> sendVerdicts;    /**< send verdicts by destination user and group ID */
+    mutable std::unordered_map<uint64_t, bool> receiveVerdicts; /**< receive verdicts by destination user and group ID */
 };
 
 
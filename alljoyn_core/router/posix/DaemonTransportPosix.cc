@@ -22,6 +22,10 @@
 
 #include <errno.h>
 
+#include <algorithm>
+#include <list>
+#include <vector>
+
 #include <qcc/platform.h>
 #include <qcc/Socket.h>
 #include <qcc/SocketStream.h>
@@ -209,14 +213,79 @@ void* DaemonTransport::Run(void* arg)
 
     Event listenEvent(listenFd, Event::IO_READ);
 
+    /*
+     * Connections that are in the middle of authenticating.  Rather than
+     * running each handshake to completion before accepting the next
+     * connection, we wait on the streams of these connections along with the
+     * listen socket and advance each handshake as its data arrives.  A client
+     * that is slow to authenticate then only holds up itself.
+     */
+    list<DaemonEndpoint> authList;
+
     while (!IsStopping()) {
-        status = Event::Wait(listenEvent);
-        if (status != ER_OK) {
-            if (status != ER_STOPPING_THREAD) {
-                QCC_LogError(status, ("Event::Wait failed"));
+        vector<Event*> checkEvents, signaledEvents;
+        checkEvents.push_back(&stopEvent);
+        checkEvents.push_back(&listenEvent);
+
+        /*
+         * The wait is bounded by the first handshake to run out of time so
+         * that it is abandoned even if the client sends nothing more.
+         */
+        uint32_t maxWait = Event::WAIT_FOREVER;
+        for (list<DaemonEndpoint>::iterator i = authList.begin(); i != authList.end(); ++i) {
+            checkEvents.push_back(&(*i)->GetSource().GetSourceEvent());
+            uint32_t remaining = (*i)->GetEstablishTimeRemaining();
+            if (remaining != Event::WAIT_FOREVER) {
+                maxWait = min(maxWait, remaining + 1);
             }
+        }
+
+        status = Event::Wait(checkEvents, signaledEvents, maxWait);
+        if (status == ER_TIMEOUT) {
+            status = ER_OK;
+        }
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Event::Wait failed"));
             break;
         }
+        if (find(signaledEvents.begin(), signaledEvents.end(), &stopEvent) != signaledEvents.end()) {
+            stopEvent.ResetEvent();
+            continue;
+        }
+
+        list<DaemonEndpoint>::iterator i = authList.begin();
+        while (i != authList.end()) {
+            DaemonEndpoint conn = *i;
+            Event* authEvent = &conn->GetSource().GetSourceEvent();
+            if ((find(signaledEvents.begin(), signaledEvents.end(), authEvent) == signaledEvents.end()) &&
+                (conn->GetEstablishTimeRemaining() > 0)) {
+                ++i;
+                continue;
+            }
+            qcc::String authName;
+            qcc::String redirection;
+            status = conn->ContinueEstablish(authName, redirection);
+            if (status == ER_WOULDBLOCK) {
+                ++i;
+                continue;
+            }
+            i = authList.erase(i);
+            if (status == ER_OK) {
+                conn->SetListener(this);
+                status = conn->Start(m_defaultHbeatIdleTimeout, m_defaultHbeatProbeTimeout, m_numHbeatProbes, m_maxHbeatProbeTimeout);
+            }
+            if (status != ER_OK) {
+                QCC_LogError(status, ("Error starting RemoteEndpoint"));
+                RemoteEndpoint rep = RemoteEndpoint::cast(conn);
+                RemoveEndpoint(rep);
+            }
+        }
+        status = ER_OK;
+
+        if (find(signaledEvents.begin(), signaledEvents.end(), &listenEvent) == signaledEvents.end()) {
+            continue;
+        }
+
         SocketFd newSock;
 
         status = Accept(listenFd, newSock);
@@ -238,8 +307,6 @@ void* DaemonTransport::Run(void* arg)
 #endif
 
         if (status == ER_OK) {
-            qcc::String authName;
-            qcc::String redirection;
             static const bool truthiness = true;
             DaemonTransport* trans = this;
             DaemonEndpoint conn = DaemonEndpoint(trans, bus, truthiness, DaemonTransport::TransportName, newSock);
@@ -256,19 +323,13 @@ void* DaemonTransport::Run(void* arg)
             endpointListLock.Lock(MUTEX_CONTEXT);
             endpointList.push_back(RemoteEndpoint::cast(conn));
             endpointListLock.Unlock(MUTEX_CONTEXT);
-            status = conn->Establish("EXTERNAL", authName, redirection);
+            status = conn->BeginEstablish("EXTERNAL", NULL, m_authTimeout);
             if (status == ER_OK) {
-                conn->SetListener(this);
-                status = conn->Start(m_defaultHbeatIdleTimeout, m_defaultHbeatProbeTimeout, m_numHbeatProbes, m_maxHbeatProbeTimeout);
-            }
-            if (status != ER_OK) {
+                authList.push_back(conn);
+            } else {
                 QCC_LogError(status, ("Error starting RemoteEndpoint"));
-                endpointListLock.Lock(MUTEX_CONTEXT);
-                list<RemoteEndpoint>::iterator ei = find(endpointList.begin(), endpointList.end(), RemoteEndpoint::cast(conn));
-                if (ei != endpointList.end()) {
-                    endpointList.erase(ei);
-                }
-                endpointListLock.Unlock(MUTEX_CONTEXT);
+                RemoteEndpoint rep = RemoteEndpoint::cast(conn);
+                RemoveEndpoint(rep);
             }
         } else if (ER_WOULDBLOCK == status || ER_READ_ERROR == status) {
             status = ER_OK;
@@ -280,6 +341,17 @@ void* DaemonTransport::Run(void* arg)
 
     }
 
+    /*
+     * Abandon the handshakes that did not complete.  The handshake holds a
+     * reference to its endpoint so this is needed for the endpoints to go.
+     */
+    for (list<DaemonEndpoint>::iterator i = authList.begin(); i != authList.end(); ++i) {
+        (*i)->AbortEstablish();
+        RemoteEndpoint rep = RemoteEndpoint::cast(*i);
+        RemoveEndpoint(rep);
+    }
+    authList.clear();
+
     qcc::Close(listenFd);
 
     QCC_DbgPrintf(("DaemonTransport::Run is exiting status=%s\n", QCC_StatusText(status)));
@@ -18,13 +18,116 @@
 
 #include <qcc/Mutex.h>
 
+#include <list>
 #include <map>
 #include <algorithm>
+#include <unordered_map>
 
 #include "AboutObjectDescriptionInternal.h"
+#include "MsgArgUtils.h"
 
 namespace ajn {
 
+typedef std::map<qcc::String, std::set<qcc::String> > ObjectMap;
+
+const size_t AnnouncedObjectsCache::MAX_ENTRIES;
+
+struct CachedObjectDescription {
+    uint64_t hash;
+    MsgArg arg;    /* Compared against to rule out hash collisions */
+    AnnouncedObjects objects;
+
+    CachedObjectDescription(uint64_t hash, const MsgArg& arg, const AnnouncedObjects& objects) : hash(hash), arg(arg), objects(objects) { }
+};
+
+/*
+ * The cached descriptions from most to least recently used and an index into
+ * that list by hash.  The least recently used description is replaced once
+ * the cache is full.
+ */
+typedef std::list<CachedObjectDescription> ObjectDescriptionList;
+typedef std::unordered_multimap<uint64_t, ObjectDescriptionList::iterator> ObjectDescriptionIndex;
+
+struct ObjectDescriptionCache {
+    ObjectDescriptionList lru;
+    ObjectDescriptionIndex index;
+};
+
+static ObjectDescriptionCache* objectDescriptionCache = NULL;
+static qcc::Mutex* objectDescriptionCacheLock = NULL;
+
+void AnnouncedObjectsCache::Init()
+{
+    objectDescriptionCache = new ObjectDescriptionCache();
+    objectDescriptionCacheLock = new qcc::Mutex();
+}
+
+void AnnouncedObjectsCache::Shutdown()
+{
+    delete objectDescriptionCache;
+    objectDescriptionCache = NULL;
+    delete objectDescriptionCacheLock;
+    objectDescriptionCacheLock = NULL;
+}
+
+/* Must be called with objectDescriptionCacheLock held */
+static ObjectDescriptionList::iterator FindCached(const MsgArg& arg, uint64_t hash)
+{
+    std::pair<ObjectDescriptionIndex::iterator, ObjectDescriptionIndex::iterator> range = objectDescriptionCache->index.equal_range(hash);
+    for (ObjectDescriptionIndex::iterator it = range.first; it != range.second; ++it) {
+        if (it->second->arg == arg) {
+            return it->second;
+        }
+    }
+    return objectDescriptionCache->lru.end();
+}
+
+bool AnnouncedObjectsCache::Find(const MsgArg& arg, uint64_t hash, AnnouncedObjects& objects)
+{
+    bool found = false;
+    if (objectDescriptionCacheLock) {
+        objectDescriptionCacheLock->Lock(MUTEX_CONTEXT);
+        ObjectDescriptionList& lru = objectDescriptionCache->lru;
+        ObjectDescriptionList::iterator it = FindCached(arg, hash);
+        if (it != lru.end()) {
+            lru.splice(lru.begin(), lru, it);
+            objects = it->objects;
+            found = true;
+        }
+        objectDescriptionCacheLock->Unlock(MUTEX_CONTEXT);
+    }
+    return found;
+}
+
+void AnnouncedObjectsCache::Add(const MsgArg& arg, uint64_t hash, const AnnouncedObjects& objects)
+{
+    if (objectDescriptionCacheLock) {
+        objectDescriptionCacheLock->Lock(MUTEX_CONTEXT);
+        ObjectDescriptionList& lru = objectDescriptionCache->lru;
+        ObjectDescriptionIndex& index = objectDescriptionCache->index;
+        ObjectDescriptionList::iterator it = FindCached(arg, hash);
+        if (it != lru.end()) {
+            lru.splice(lru.begin(), lru, it);
+            it->objects = objects;
+        } else {
+            if (lru.size() >= MAX_ENTRIES) {
+                ObjectDescriptionList::iterator oldest = --lru.end();
+                std::pair<ObjectDescriptionIndex::iterator, ObjectDescriptionIndex::iterator> range = index.equal_range(oldest->hash);
+                for (ObjectDescriptionIndex::iterator idx = range.first; idx != range.second; ++idx) {
+                    if (idx->second == oldest) {
+                        index.erase(idx);
+                        break;
+                    }
+                }
+                lru.erase(oldest);
+            }
+            lru.push_front(CachedObjectDescription(hash, arg, objects));
+            index.insert(std::make_pair(hash, lru.begin()));
+        }
+        objectDescriptionCacheLock->Unlock(MUTEX_CONTEXT);
+    }
+}
+
 AboutObjectDescription::AboutObjectDescription() : aodInternal(new AboutObjectDescription::Internal)
 {
     //Empty constructor
@@ -60,36 +163,67 @@ AboutObjectDescription::~AboutObjectDescription()
 
 QStatus AboutObjectDescription::CreateFromMsgArg(const MsgArg& arg)
 {
+    /*
+     * An empty description can simply share the objects of an earlier
+     * description parsed from the same MsgArg.
+     */
+    uint64_t hash = MsgArgUtils::Hash(arg);
+    bool isEmpty = aodInternal->GetObjects()->empty();
+    if (isEmpty) {
+        AnnouncedObjects cached;
+        if (AnnouncedObjectsCache::Find(arg, hash, cached)) {
+            aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
+            aodInternal->announceObjectsMap = cached;
+            aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
+            return ER_OK;
+        }
+    }
+
     QStatus status = ER_OK;
+    AnnouncedObjects parsed;
     MsgArg* structarg;
     size_t struct_size;
     status = arg.Get("a(oas)", &struct_size, &structarg);
-    if (status != ER_OK) {
-        return status;
-    }
-
-    for (size_t i = 0; i < struct_size; ++i) {
+    for (size_t i = 0; (status == ER_OK) && (i < struct_size); ++i) {
         char* objectPath;
         size_t numberItfs;
         MsgArg* interfacesArg;
         status = structarg[i].Get("(oas)", &objectPath, &numberItfs, &interfacesArg);
         if (status != ER_OK) {
-            return status;
+            break;
         }
-        std::set<qcc::String> interfaceNames;
+        /* Like Add() a path is only listed once it has an interface */
+        std::set<qcc::String>* interfaceNames = NULL;
         for (size_t j = 0; j < numberItfs; ++j) {
             char* intfName;
             status = interfacesArg[j].Get("s", &intfName);
             if (status != ER_OK) {
-                return status;
+                break;
             }
-            status = Add(objectPath, intfName);
-            if (status != ER_OK) {
-                return status;
+            if (!interfaceNames) {
+                interfaceNames = &(*parsed)[objectPath];
             }
+            interfaceNames->insert(intfName);
+        }
+    }
+
+    aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
+    if (aodInternal->announceObjectsMap->empty()) {
+        aodInternal->announceObjectsMap = parsed;
+    } else {
+        /* Merge with what was there before, leaving the shared objects untouched */
+        AnnouncedObjects merged(aodInternal->announceObjectsMap, true);
+        for (ObjectMap::const_iterator it = parsed->begin(); it != parsed->end(); ++it) {
+            (*merged)[it->first].insert(it->second.begin(), it->second.end());
         }
+        aodInternal->announceObjectsMap = merged;
+        isEmpty = false;
     }
+    aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
 
+    if ((status == ER_OK) && isEmpty) {
+        AnnouncedObjectsCache::Add(arg, hash, parsed);
+    }
     return status;
 }
 
@@ -97,12 +231,14 @@ QStatus AboutObjectDescription::Add(const char* path, const char* interfaceName)
 {
     QStatus status = ER_OK;
     aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
-    if (aodInternal->announceObjectsMap.find(path) == aodInternal->announceObjectsMap.end()) {
-        std::set<qcc::String> newInterfaceName;
-        newInterfaceName.insert(interfaceName);
-        aodInternal->announceObjectsMap[path] = newInterfaceName;
+    if (aodInternal->announceObjectsMap.GetRefCount() == 1) {
+        /* Nothing else holds the objects so they can be changed in place */
+        (*aodInternal->announceObjectsMap)[path].insert(interfaceName);
     } else {
-        aodInternal->announceObjectsMap[path].insert(interfaceName);
+        /* The objects are shared with other descriptions so modify a copy */
+        AnnouncedObjects objects(aodInternal->announceObjectsMap, true);
+        (*objects)[path].insert(interfaceName);
+        aodInternal->announceObjectsMap = objects;
     }
     aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
     return status;
@@ -110,45 +246,41 @@ QStatus AboutObjectDescription::Add(const char* path, const char* interfaceName)
 
 size_t AboutObjectDescription::GetPaths(const char** paths, size_t numPaths) const
 {
+    AnnouncedObjects objects = aodInternal->GetObjects();
     if (paths == NULL) {
-        return aodInternal->announceObjectsMap.size();
+        return objects->size();
     }
-    aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
     size_t count = 0;
-    for (std::map<qcc::String, std::set<qcc::String> >::const_iterator it = aodInternal->announceObjectsMap.begin();
-         it != aodInternal->announceObjectsMap.end() && count < numPaths; ++it, ++count) {
+    for (ObjectMap::const_iterator it = objects->begin(); it != objects->end() && count < numPaths; ++it, ++count) {
         paths[count] = it->first.c_str();
     }
-    aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
-    return aodInternal->announceObjectsMap.size();
+    return objects->size();
 }
 
 size_t AboutObjectDescription::GetInterfaces(const char* path, const char** interfaces, size_t numInterfaces) const
 {
-    std::map<qcc::String, std::set<qcc::String> >::const_iterator aom_it = aodInternal->announceObjectsMap.find(path);
-    if (aom_it == aodInternal->announceObjectsMap.end()) {
+    AnnouncedObjects objects = aodInternal->GetObjects();
+    ObjectMap::const_iterator aom_it = objects->find(path);
+    if (aom_it == objects->end()) {
         return static_cast<size_t>(0);
     }
 
     if (interfaces == NULL) {
         return aom_it->second.size();
     }
-    aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
     size_t count = 0;
     for (std::set<qcc::String>::const_iterator it = aom_it->second.begin();
          it != aom_it->second.end() && count < numInterfaces; ++it, ++count) {
         interfaces[count] = it->c_str();
     }
-    aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
     return aom_it->second.size();
 }
 
 size_t AboutObjectDescription::GetInterfacePaths(const char* iface, const char** paths, size_t numPaths) const
 {
-    std::map<qcc::String, std::set<qcc::String> >::const_iterator it;
+    AnnouncedObjects objects = aodInternal->GetObjects();
     size_t count = 0;
-    aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
-    for (it = aodInternal->announceObjectsMap.begin(); it != aodInternal->announceObjectsMap.end(); ++it) {
+    for (ObjectMap::const_iterator it = objects->begin(); it != objects->end(); ++it) {
         std::set<qcc::String>::const_iterator it2 = it->second.find(iface);
         if (it2 != it->second.end()) {
             if (count < numPaths) {
@@ -157,27 +289,25 @@ size_t AboutObjectDescription::GetInterfacePaths(const char* iface, const char**
             ++count;
         }
     }
-    aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
     return count;
 }
 
 void AboutObjectDescription::Clear()
 {
     aodInternal->announceObjectsMapLock.Lock(MUTEX_CONTEXT);
-    aodInternal->announceObjectsMap.clear();
+    aodInternal->announceObjectsMap = AnnouncedObjects();
     aodInternal->announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
 }
 bool AboutObjectDescription::HasPath(const char* path)  const
 {
-    std::map<qcc::String, std::set<qcc::String> >::const_iterator find_it = aodInternal->announceObjectsMap.find(path);
-    std::map<qcc::String, std::set<qcc::String> >::const_iterator end_it = aodInternal->announceObjectsMap.end();
-    return (find_it != end_it);
+    AnnouncedObjects objects = aodInternal->GetObjects();
+    return (objects->find(path) != objects->end());
 }
 
 bool AboutObjectDescription::HasInterface(const char* interfaceName) const
 {
-    std::map<qcc::String, std::set<qcc::String> >::const_iterator it;
-    for (it = aodInternal->announceObjectsMap.begin(); it != aodInternal->announceObjectsMap.end(); ++it) {
+    AnnouncedObjects objects = aodInternal->GetObjects();
+    for (ObjectMap::const_iterator it = objects->begin(); it != objects->end(); ++it) {
         if (HasInterface(it->first.c_str(), interfaceName)) {
             return true;
         }
@@ -188,8 +318,9 @@ bool AboutObjectDescription::HasInterface(const char* interfaceName) const
 
 bool AboutObjectDescription::HasInterface(const char* path, const char* interfaceName) const
 {
-    std::map<qcc::String, std::set<qcc::String> >::const_iterator it = aodInternal->announceObjectsMap.find(path);
-    if (it == aodInternal->announceObjectsMap.end()) {
+    AnnouncedObjects objects = aodInternal->GetObjects();
+    ObjectMap::const_iterator it = objects->find(path);
+    if (it == objects->end()) {
         return false;
     }
     qcc::String interfaceNameStr(interfaceName);
@@ -208,10 +339,10 @@ bool AboutObjectDescription::HasInterface(const char* path, const char* interfac
 QStatus AboutObjectDescription::GetMsgArg(MsgArg* msgArg)
 {
     QStatus status = ER_OK;
-    MsgArg* announceObjectsArg = new MsgArg[aodInternal->announceObjectsMap.size()];
+    AnnouncedObjects objects = aodInternal->GetObjects();
+    MsgArg* announceObjectsArg = new MsgArg[objects->size()];
     int objIndex = 0;
-    for (std::map<qcc::String, std::set<qcc::String> >::const_iterator it = aodInternal->announceObjectsMap.begin();
-         it != aodInternal->announceObjectsMap.end(); ++it) {
+    for (ObjectMap::const_iterator it = objects->begin(); it != objects->end(); ++it) {
 
         qcc::String objectPath = it->first;
         const char** interfaces = new const char*[it->second.size()];
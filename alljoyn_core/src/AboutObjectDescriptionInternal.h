@@ -17,12 +17,22 @@
 #define _ALLJOYN_ABOUTOBJECTDESCRIPTIONINTERNAL_H
 
 #include <alljoyn/AboutObjectDescription.h>
+#include <qcc/ManagedObj.h>
 #include <qcc/Mutex.h>
 
 #include <set>
 #include <map>
 
 namespace ajn {
+
+/**
+ * Map of object paths to the interfaces implemented at each path.  It is
+ * shared by every AboutObjectDescription parsed from the same object
+ * description and by copies of those, and is copied when one of them is
+ * modified while it is shared.
+ */
+typedef qcc::ManagedObj<std::map<qcc::String, std::set<qcc::String> > > AnnouncedObjects;
+
 /**
  * Class used to hold internal values for the AboutObjectDescription
  */
@@ -30,23 +40,78 @@ class AboutObjectDescription::Internal {
     friend class AboutObjectDescription;
   public:
     AboutObjectDescription::Internal& operator=(const AboutObjectDescription::Internal& other) {
-        announceObjectsMap = other.announceObjectsMap;
+        AnnouncedObjects objects = other.GetObjects();
+        announceObjectsMapLock.Lock(MUTEX_CONTEXT);
+        announceObjectsMap = objects;
+        announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
         return *this;
     }
 
   private:
     /**
-     * Mutex that protects the announceObjectsMap
+     * Get a reference to the current objects. Objects that are referenced
+     * from more than one place are never modified in place so they can be
+     * read without holding the lock.
+     */
+    AnnouncedObjects GetObjects() const {
+        announceObjectsMapLock.Lock(MUTEX_CONTEXT);
+        AnnouncedObjects objects = announceObjectsMap;
+        announceObjectsMapLock.Unlock(MUTEX_CONTEXT);
+        return objects;
+    }
+
+    /**
+     * Mutex that protects the reference to the announceObjectsMap
      *
      * this is marked as mutable so we can grab the lock to prevent the Objects
-     * map being modified while its being read.
+     * map being replaced while its being read.
      */
     mutable qcc::Mutex announceObjectsMapLock;
 
     /**
      *  map that holds interfaces
      */
-    std::map<qcc::String, std::set<qcc::String> > announceObjectsMap;
+    AnnouncedObjects announceObjectsMap;
+};
+
+/**
+ * Cache of parsed object descriptions keyed by a hash of the a(oas) MsgArg.
+ * Devices re-announce periodically and devices of the same kind announce the
+ * same objects so most object descriptions have been parsed before.  The
+ * objects in the cache are shared and must not be modified.
+ */
+class AnnouncedObjectsCache {
+  public:
+    /**
+     * Number of object descriptions kept before the least recently used one
+     * is replaced.
+     */
+    static const size_t MAX_ENTRIES = 64;
+
+    /**
+     * Find the objects parsed from an object description.
+     *
+     * @param arg          The a(oas) object description.
+     * @param hash         MsgArgUtils::Hash() of the object description.
+     * @param[out] objects Returns the parsed objects if found.
+     *
+     * @return true if the object description is in the cache.
+     */
+    static bool Find(const MsgArg& arg, uint64_t hash, AnnouncedObjects& objects);
+
+    /**
+     * Add the objects parsed from an object description to the cache.
+     *
+     * @param arg      The a(oas) object description.
+     * @param hash     MsgArgUtils::Hash() of the object description.
+     * @param objects  The parsed objects.
+     */
+    static void Add(const MsgArg& arg, uint64_t hash, const AnnouncedObjects& objects);
+
+  private:
+    static void Init();
+    static void Shutdown();
+    friend class StaticGlobals;
 };
 }
 #endif //_ALLJOYN_ABOUTOBJECTDESCRIPTIONINTERNAL_H
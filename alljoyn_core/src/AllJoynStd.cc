@@ -82,6 +82,9 @@ const char* org::allseen::Introspectable::IntrospectDocType =
     "\"http://www.allseen.org/alljoyn/introspect-1.0.dtd\""
     ">\n";
 
+/** org.allseen.IntrospectableTree interface definitions */
+const char* org::allseen::IntrospectableTree::InterfaceName = "org.allseen.IntrospectableTree";
+
 QStatus org::alljoyn::CreateInterfaces(BusAttachment& bus)
 {
     QStatus status;
@@ -149,6 +152,7 @@ QStatus org::alljoyn::CreateInterfaces(BusAttachment& bus)
         ifc->AddMethod("GetHostInfo",              "u",                 "uss",               "sessionId,disposition,localipaddr,remoteipaddr", 0);
         ifc->AddMethod("ReloadConfig",             "",                  "b",                 "loaded",                                     0);
         ifc->AddMethod("Ping",                     "su",                "u",                 "name,timeout,disposition",                   0);
+        ifc->AddMethod("PingMultiple",             "asu",               "au",                "names,timeout,dispositions",                 0);
         ifc->AddMethod("FindAdvertisementByTransport",       "sq",                "u",                 "matching,transports,disposition",     0);
         ifc->AddMethod("CancelFindAdvertisementByTransport", "sq",                "u",                 "matching,transports,disposition",     0);
         ifc->AddMethod("SetIdleTimeouts",     "uu",                "uuu",
@@ -192,6 +196,7 @@ QStatus org::alljoyn::CreateInterfaces(BusAttachment& bus)
         ifc->AddMethod("AttachSession",  "qsssss" SESSIONOPTS_SIG, "uu" SESSIONOPTS_SIG "as", "port,joiner,creator,dest,b2b,busAddr,optsIn,status,id,optsOut,members", 0);
         ifc->AddMethod("AttachSessionWithNames",  "qsssss" SESSIONOPTS_SIG "a(sas)", "uu" SESSIONOPTS_SIG "asa(sas)", "port,joiner,creator,dest,b2b,busAddr,optsIn,namesIn,status,id,optsOut,members,namesOut", 0);
         ifc->AddMethod("GetSessionInfo", "sq" SESSIONOPTS_SIG, "as", "creator,port,opts,busAddrs", 0);
+        ifc->AddMethod("PingMultiple",   "asu",    "au", "names,timeout,dispositions", 0);
         ifc->AddSignal("DetachSession",  "us",     "sessionId,joiner",       0);
         ifc->AddSignal("ExchangeNames",  "a(sas)", "uniqueName,aliases",     0);
         ifc->AddSignal("NameChanged",    "sss",    "name,oldOwner,newOwner", 0);
@@ -349,6 +354,17 @@ QStatus org::alljoyn::CreateInterfaces(BusAttachment& bus)
         introspectIntf->AddMethod("IntrospectWithDescription",   "s",  "s",  "languageTag,data");
         introspectIntf->Activate();
     }
+    {
+        InterfaceDescription* treeIntf = NULL;
+        status = bus.CreateInterface(org::allseen::IntrospectableTree::InterfaceName, treeIntf, AJ_IFC_SECURITY_OFF);
+        if (ER_OK != status) {
+            QCC_LogError(status, ("Failed to create interface \"%s\"", org::allseen::IntrospectableTree::InterfaceName));
+            return status;
+        }
+
+        treeIntf->AddMethod("IntrospectTree", "s", "s", "languageTag,data");
+        treeIntf->Activate();
+    }
     return status;
 }
 
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <memory>
 #include <set>
+#include <vector>
 
 #define PING_TIMEOUT 5000
 
@@ -50,11 +51,12 @@ struct Destination {
 
 // Group data
 struct PingGroup {
-    PingGroup(uint32_t pingInterval,      /* milliseconds */
+    PingGroup(uint32_t firstPing,         /* milliseconds */
+              uint32_t pingInterval,      /* milliseconds */
               qcc::AlarmListener* alarmListener,
               void* context,
               PingListener& _pingListener) :
-        alarm(pingInterval, alarmListener, context, pingInterval), pingListener(_pingListener) { }
+        alarm(firstPing, alarmListener, context, pingInterval), pingListener(_pingListener) { }
 
     ~PingGroup() {
         qcc::String* ctx = static_cast<qcc::String*>(alarm->GetContext());
@@ -76,15 +78,12 @@ class PingAsyncContext {
   public:
     PingAsyncContext(AutoPingerInternal* _pinger,
                      const qcc::String& _group,
-                     const qcc::String& _destination,
-                     const AutoPingerInternal::PingState _oldState,
                      PingListener& listener) :
-        pinger(_pinger), group(_group), destination(_destination), oldState(_oldState), pingListener(listener)  { }
+        pinger(_pinger), group(_group), pingListener(listener)  { }
 
     AutoPingerInternal* pinger;
     qcc::String group;
-    qcc::String destination;
-    AutoPingerInternal::PingState oldState;
+    std::vector<Destination> destinations; /* in the order they were pinged */
     PingListener& pingListener;
   private:
     PingAsyncContext& operator=(const PingAsyncContext&);
@@ -95,9 +94,14 @@ static qcc::Mutex* globalPingerLock = NULL;
 static bool callbackInProgress = false;
 
 // Callback handler for async ping calls
-class AutoPingAsyncCB : public BusAttachment::PingAsyncCB {
+class AutoPingAsyncCB : public BusAttachment::PingAsyncCB, public BusAttachment::PingMultipleAsyncCB {
   public:
     void PingCB(QStatus status, void* context) {
+        PingMultipleCB(NULL, &status, 1, context);
+    }
+
+    void PingMultipleCB(const char** names, const QStatus* statuses, size_t numNames, void* context) {
+        QCC_UNUSED(names);
         PingAsyncContext* ctx = (PingAsyncContext*)context;
         bool found = false;
 
@@ -109,39 +113,14 @@ class AutoPingAsyncCB : public BusAttachment::PingAsyncCB {
         }
 
         if (found) {
-            if (ctx->pinger->IsRunning() && !ctx->pinger->pausing) {
-                if (ER_OK != status) {
-                    if (ER_ALLJOYN_PING_REPLY_IN_PROGRESS != status) {
-                        if (ctx->oldState != AutoPingerInternal::LOST) {
-                            // update state
-                            if (ctx->pinger->UpdatePingStateOfDestination(ctx->group, ctx->destination, AutoPingerInternal::LOST)) {
-
-                                // call external listener
-                                callbackInProgress = true;
-                                globalPingerLock->Unlock(MUTEX_CONTEXT);
-                                ctx->pingListener.DestinationLost(ctx->group, ctx->destination);
-                                globalPingerLock->Lock(MUTEX_CONTEXT);
-                                callbackInProgress = false;
-                            }
-                        }
-                    }
-                } else {
-                    if (ctx->oldState != AutoPingerInternal::AVAILABLE) {
-                        // update state
-                        if (ctx->pinger->UpdatePingStateOfDestination(ctx->group, ctx->destination, AutoPingerInternal::AVAILABLE)) {
-
-                            // call external listener
-                            callbackInProgress = true;
-                            globalPingerLock->Unlock(MUTEX_CONTEXT);
-                            ctx->pingListener.DestinationFound(ctx->group, ctx->destination);
-                            globalPingerLock->Lock(MUTEX_CONTEXT);
-                            callbackInProgress = false;
-                        }
-                    }
+            for (size_t i = 0; (i < numNames) && (i < ctx->destinations.size()); ++i) {
+                /* the pinger may be paused or stopped while a listener is being called */
+                if (!ctx->pinger->IsRunning() || ctx->pinger->pausing) {
+                    QCC_DbgPrintf(("AutoPingerInternal: ignoring callback - pinger not running"));
+                    break;
                 }
-
-            } else {
-                QCC_DbgPrintf(("AutoPingerInternal: ignoring callback - pinger not running"));
+                ctx->pinger->PingCompleted(ctx->group, ctx->destinations[i].destination, ctx->destinations[i].oldState,
+                                           ctx->pingListener, statuses[i]);
             }
         } else {
             QCC_DbgPrintf(("AutoPingerInternal: ignoring callback - ping already gone"));
@@ -171,6 +150,18 @@ void AutoPingerInternal::Shutdown()
     pingCallback = NULL;
 }
 
+/*
+ * Delay before the first periodic ping of a new group.  Successive groups are
+ * offset from each other by the golden ratio of the interval, which spreads
+ * them evenly over the interval however many there are, rather than having
+ * groups that were created together ping all their destinations at once.
+ */
+static uint32_t FirstPingDelay(size_t groupIndex, uint32_t interval)
+{
+    uint64_t offset = (static_cast<uint64_t>(interval) * ((groupIndex * 618) % 1000)) / 1000;
+    return interval - static_cast<uint32_t>(offset);
+}
+
 AutoPingerInternal::AutoPingerInternal(ajn::BusAttachment& _busAttachment) :
     timer("autopinger"), busAttachment(_busAttachment), pausing(false)
 {
@@ -234,24 +225,70 @@ void AutoPingerInternal::AlarmTriggered(const qcc::Alarm& alarm, QStatus reason)
     globalPingerLock->Unlock(MUTEX_CONTEXT);
 }
 
+void AutoPingerInternal::PingCompleted(const qcc::String& group, const qcc::String& destination, PingState oldState, PingListener& pingListener, QStatus status)
+{
+    /* called with global lock taken, the lock is released while calling the listener */
+    if (ER_OK != status) {
+        if (ER_ALLJOYN_PING_REPLY_IN_PROGRESS != status) {
+            if (oldState != AutoPingerInternal::LOST) {
+                // update state
+                if (UpdatePingStateOfDestination(group, destination, AutoPingerInternal::LOST)) {
+
+                    // call external listener
+                    callbackInProgress = true;
+                    globalPingerLock->Unlock(MUTEX_CONTEXT);
+                    pingListener.DestinationLost(group, destination);
+                    globalPingerLock->Lock(MUTEX_CONTEXT);
+                    callbackInProgress = false;
+                }
+            }
+        }
+    } else {
+        if (oldState != AutoPingerInternal::AVAILABLE) {
+            // update state
+            if (UpdatePingStateOfDestination(group, destination, AutoPingerInternal::AVAILABLE)) {
+
+                // call external listener
+                callbackInProgress = true;
+                globalPingerLock->Unlock(MUTEX_CONTEXT);
+                pingListener.DestinationFound(group, destination);
+                globalPingerLock->Lock(MUTEX_CONTEXT);
+                callbackInProgress = false;
+            }
+        }
+    }
+}
+
 void AutoPingerInternal::PingGroupDestinations(const qcc::String& group)
 {
     /* called with global lock taken */
     QCC_DbgPrintf(("AutoPingerInternal: start pinging destination in group: '%s'", group.c_str()));
     std::map<qcc::String, PingGroup*>::const_iterator it = pingGroups.find(group);
-    if (it != pingGroups.end()) {
-        std::map<Destination, unsigned int>::iterator mapIt = (*it).second->destinations.begin();
-        for (; mapIt != (*it).second->destinations.end(); ++mapIt) {
-            PingDestination(group, mapIt->first.destination, mapIt->first.oldState, it->second->pingListener);
-        }
+    if ((it == pingGroups.end()) || it->second->destinations.empty()) {
+        return;
+    }
+
+    /* ping all destinations of the group with a single request to the router */
+    PingAsyncContext* context = new PingAsyncContext(this, group, it->second->pingListener);
+    std::vector<const char*> names;
+    std::map<Destination, unsigned int>::iterator mapIt = (*it).second->destinations.begin();
+    for (; mapIt != (*it).second->destinations.end(); ++mapIt) {
+        context->destinations.push_back(mapIt->first);
+        names.push_back(mapIt->first.destination.c_str());
+    }
+
+    std::pair<std::set<PingAsyncContext*>::iterator, bool> pair = ctxs->insert(context);
+    if (ER_OK != busAttachment.PingAsync(&names[0], names.size(), PING_TIMEOUT, pingCallback, context)) {
+        ctxs->erase(pair.first);
+        delete context;
     }
 }
 
 void AutoPingerInternal::PingDestination(const qcc::String& group, const qcc::String& destination, PingState oldState, PingListener& pingListener)
 {
     /* called with global lock taken */
-    PingAsyncContext* context =
-        new PingAsyncContext(this, group, destination, oldState, pingListener);
+    PingAsyncContext* context = new PingAsyncContext(this, group, pingListener);
+    context->destinations.push_back(Destination(destination, oldState));
 
     std::pair<std::set<PingAsyncContext*>::iterator, bool> pair = ctxs->insert(context);
     if (ER_OK != busAttachment.PingAsync(destination.c_str(), PING_TIMEOUT, pingCallback, context)) {
@@ -319,7 +356,7 @@ void AutoPingerInternal::AddPingGroup(const qcc::String& group, PingListener& li
         QCC_DbgPrintf(("AutoPingerInternal: adding new group: '%s' with ping time: %u", group.c_str(), pingInterval));
 
         void* context = (void*)(new qcc::String(group));
-        PingGroup* pingGroup = new PingGroup(intervalMillisec, this, context, listener);
+        PingGroup* pingGroup = new PingGroup(FirstPingDelay(pingGroups.size(), intervalMillisec), intervalMillisec, this, context, listener);
         pingGroups.insert(std::pair<qcc::String, PingGroup*>(group, pingGroup));
         timer.AddAlarmNonBlocking(pingGroup->alarm);
     }
@@ -139,6 +139,7 @@ class AutoPingerInternal : public qcc::AlarmListener {
     void operator=(const AutoPingerInternal&);
 
     bool UpdatePingStateOfDestination(const qcc::String& group, const qcc::String& destination, const AutoPingerInternal::PingState state);
+    void PingCompleted(const qcc::String& group, const qcc::String& destination, PingState oldState, PingListener& pingListener, QStatus status);
     void PingGroupDestinations(const qcc::String& group);
     void PingDestination(const qcc::String& group, const qcc::String& destination, PingState oldState, PingListener& pingListener);
     bool IsRunning();
@@ -119,6 +119,57 @@ struct PingAsyncCBContext {
     { }
 };
 
+struct PingMultipleCBContext : public BusAttachment::PingAsyncCB {
+    BusAttachment::PingMultipleAsyncCB* callback;
+    void* context;
+    std::vector<qcc::String> names;
+    std::vector<QStatus> statuses;
+    uint32_t timeout;
+    size_t outstanding;
+    qcc::Mutex lock;
+
+    PingMultipleCBContext(BusAttachment::PingMultipleAsyncCB* callback, void* context,
+                          const char** names, size_t numNames, uint32_t timeout) :
+        callback(callback),
+        context(context),
+        names(names, names + numNames),
+        statuses(numNames, ER_FAIL),
+        timeout(timeout),
+        outstanding(1)
+    { }
+
+    /* Record the outcome for one name */
+    void Complete(size_t index, QStatus status)
+    {
+        lock.Lock(MUTEX_CONTEXT);
+        statuses[index] = status;
+        lock.Unlock(MUTEX_CONTEXT);
+        Release();
+    }
+
+    /* Drop one outstanding reference; the last one calls back and cleans up */
+    void Release()
+    {
+        lock.Lock(MUTEX_CONTEXT);
+        bool done = (--outstanding == 0);
+        lock.Unlock(MUTEX_CONTEXT);
+        if (done) {
+            std::vector<const char*> cnames;
+            for (size_t i = 0; i < names.size(); ++i) {
+                cnames.push_back(names[i].c_str());
+            }
+            callback->PingMultipleCB(&cnames[0], &statuses[0], names.size(), context);
+            delete this;
+        }
+    }
+
+    /* Used when the names have to be pinged one at a time */
+    void PingCB(QStatus status, void* index)
+    {
+        Complete(reinterpret_cast<uintptr_t>(index), status);
+    }
+};
+
 struct GetNameOwnerCBContext {
     BusAttachment::GetNameOwnerAsyncCB* callback;
     void* context;
@@ -3088,6 +3139,35 @@ QStatus BusAttachment::OnAppResume()
     return status;
 }
 
+static QStatus PingDispositionToStatus(uint32_t disposition)
+{
+    switch (disposition) {
+    case ALLJOYN_PING_REPLY_SUCCESS:
+        return ER_OK;
+
+    case ALLJOYN_PING_REPLY_FAILED:
+        return ER_ALLJOYN_PING_FAILED;
+
+    case ALLJOYN_PING_REPLY_TIMEOUT:
+        return ER_ALLJOYN_PING_REPLY_TIMEOUT;
+
+    case ALLJOYN_PING_REPLY_UNKNOWN_NAME:
+        return ER_ALLJOYN_PING_REPLY_UNKNOWN_NAME;
+
+    case ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE:
+        return ER_ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE;
+
+    case ALLJOYN_PING_REPLY_UNREACHABLE:
+        return ER_ALLJOYN_PING_REPLY_UNREACHABLE;
+
+    case ALLJOYN_PING_REPLY_IN_PROGRESS:
+        return ER_ALLJOYN_PING_REPLY_IN_PROGRESS;
+
+    default:
+        return ER_BUS_UNEXPECTED_DISPOSITION;
+    }
+}
+
 QStatus BusAttachment::Ping(const char* name, uint32_t timeout)
 {
     QCC_DbgTrace(("BusAttachment::Ping(name = %s , timeout = %d)", name, timeout));
@@ -3115,38 +3195,7 @@ QStatus BusAttachment::Ping(const char* name, uint32_t timeout)
         uint32_t disposition;
         status = reply->GetArgs("u", &disposition);
         if (ER_OK == status) {
-            switch (disposition) {
-            case ALLJOYN_PING_REPLY_SUCCESS:
-                break;
-
-            case ALLJOYN_PING_REPLY_FAILED:
-                status = ER_ALLJOYN_PING_FAILED;
-                break;
-
-            case ALLJOYN_PING_REPLY_TIMEOUT:
-                status = ER_ALLJOYN_PING_REPLY_TIMEOUT;
-                break;
-
-            case ALLJOYN_PING_REPLY_UNKNOWN_NAME:
-                status = ER_ALLJOYN_PING_REPLY_UNKNOWN_NAME;
-                break;
-
-            case ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE:
-                status = ER_ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE;
-                break;
-
-            case ALLJOYN_PING_REPLY_UNREACHABLE:
-                status = ER_ALLJOYN_PING_REPLY_UNREACHABLE;
-                break;
-
-            case ALLJOYN_PING_REPLY_IN_PROGRESS:
-                status = ER_ALLJOYN_PING_REPLY_IN_PROGRESS;
-                break;
-
-            default:
-                status = ER_BUS_UNEXPECTED_DISPOSITION;
-                break;
-            }
+            status = PingDispositionToStatus(disposition);
         }
     } else if (reply->GetType() == MESSAGE_ERROR) {
         if (!strcmp(reply->GetErrorDescription().c_str(), "org.alljoyn.Bus.Timeout")) {
@@ -3203,38 +3252,7 @@ void BusAttachment::Internal::PingAsyncCB(Message& reply, void* context)
         uint32_t disposition;
         status = reply->GetArgs("u", &disposition);
         if (ER_OK == status) {
-            switch (disposition) {
-            case ALLJOYN_PING_REPLY_SUCCESS:
-                break;
-
-            case ALLJOYN_PING_REPLY_FAILED:
-                status = ER_ALLJOYN_PING_FAILED;
-                break;
-
-            case ALLJOYN_PING_REPLY_TIMEOUT:
-                status = ER_ALLJOYN_PING_REPLY_TIMEOUT;
-                break;
-
-            case ALLJOYN_PING_REPLY_UNKNOWN_NAME:
-                status = ER_ALLJOYN_PING_REPLY_UNKNOWN_NAME;
-                break;
-
-            case ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE:
-                status = ER_ALLJOYN_PING_REPLY_INCOMPATIBLE_REMOTE_ROUTING_NODE;
-                break;
-
-            case ALLJOYN_PING_REPLY_UNREACHABLE:
-                status = ER_ALLJOYN_PING_REPLY_UNREACHABLE;
-                break;
-
-            case ALLJOYN_PING_REPLY_IN_PROGRESS:
-                status = ER_ALLJOYN_PING_REPLY_IN_PROGRESS;
-                break;
-
-            default:
-                status = ER_BUS_UNEXPECTED_DISPOSITION;
-                break;
-            }
+            status = PingDispositionToStatus(disposition);
         }
     } else if (reply->GetType() == MESSAGE_ERROR) {
         if (!strcmp(reply->GetErrorDescription().c_str(), "org.alljoyn.Bus.Timeout")) {
@@ -3250,6 +3268,141 @@ void BusAttachment::Internal::PingAsyncCB(Message& reply, void* context)
     delete ctx;
 }
 
+QStatus BusAttachment::Ping(const char** names, size_t numNames, uint32_t timeout, QStatus* statuses)
+{
+    QCC_DbgTrace(("BusAttachment::Ping(numNames = %u , timeout = %d)", numNames, timeout));
+    if (!IsConnected()) {
+        return ER_BUS_NOT_CONNECTED;
+    }
+    if (!names) {
+        return ER_BAD_ARG_1;
+    }
+    if (numNames == 0) {
+        return ER_BAD_ARG_2;
+    }
+    if (!statuses) {
+        return ER_BAD_ARG_4;
+    }
+    for (size_t i = 0; i < numNames; ++i) {
+        if (!IsLegalBusName(names[i])) {
+            return ER_BUS_BAD_BUS_NAME;
+        }
+    }
+
+    Message reply(*this);
+    MsgArg args[2];
+    size_t numArgs = ArraySize(args);
+
+    MsgArg::Set(args, numArgs, "asu", numNames, names, timeout);
+
+    const ProxyBusObject& alljoynObj = this->GetAllJoynProxyObj();
+    QStatus status = alljoynObj.MethodCall(org::alljoyn::Bus::InterfaceName, "PingMultiple", args, numArgs, reply, timeout + 1000);
+    if (ER_OK == status) {
+        size_t numDispositions;
+        uint32_t* dispositions;
+        status = reply->GetArgs("au", &numDispositions, &dispositions);
+        if ((ER_OK == status) && (numDispositions != numNames)) {
+            status = ER_BUS_UNEXPECTED_DISPOSITION;
+        }
+        for (size_t i = 0; i < numNames; ++i) {
+            statuses[i] = (ER_OK == status) ? PingDispositionToStatus(dispositions[i]) : status;
+        }
+    } else if (reply->GetType() == MESSAGE_ERROR) {
+        if (!strcmp(reply->GetErrorDescription().c_str(), "org.alljoyn.Bus.Timeout")) {
+            for (size_t i = 0; i < numNames; ++i) {
+                statuses[i] = ER_ALLJOYN_PING_REPLY_TIMEOUT;
+            }
+        } else {
+            /* The router predates PingMultiple, ping the names one at a time */
+            QCC_DbgPrintf(("%s.PingMultiple returned ERROR_MESSAGE (error=%s)", org::alljoyn::Bus::InterfaceName, reply->GetErrorDescription().c_str()));
+            for (size_t i = 0; i < numNames; ++i) {
+                statuses[i] = Ping(names[i], timeout);
+            }
+        }
+        status = ER_OK;
+    }
+    return status;
+}
+
+QStatus BusAttachment::PingAsync(const char** names, size_t numNames, uint32_t timeout, BusAttachment::PingMultipleAsyncCB* callback, void* context)
+{
+    if (!IsConnected()) {
+        return ER_BUS_NOT_CONNECTED;
+    }
+    if (!names) {
+        return ER_BAD_ARG_1;
+    }
+    if (numNames == 0) {
+        return ER_BAD_ARG_2;
+    }
+    for (size_t i = 0; i < numNames; ++i) {
+        if (!IsLegalBusName(names[i])) {
+            return ER_BUS_BAD_BUS_NAME;
+        }
+    }
+
+    MsgArg args[2];
+    size_t numArgs = ArraySize(args);
+
+    MsgArg::Set(args, numArgs, "asu", numNames, names, timeout);
+
+    const ProxyBusObject& alljoynObj = this->GetAllJoynProxyObj();
+    PingMultipleCBContext* cbCtx = new PingMultipleCBContext(callback, context, names, numNames, timeout);
+
+    QStatus status = alljoynObj.MethodCallAsync(org::alljoyn::Bus::InterfaceName,
+                                                "PingMultiple",
+                                                busInternal,
+                                                static_cast<MessageReceiver::ReplyHandler>(&BusAttachment::Internal::PingMultipleAsyncCB),
+                                                args,
+                                                ArraySize(args),
+                                                cbCtx,
+                                                timeout + 1000);
+    if (status != ER_OK) {
+        delete cbCtx;
+    }
+    return status;
+}
+
+void BusAttachment::Internal::PingMultipleAsyncCB(Message& reply, void* context)
+{
+    PingMultipleCBContext* ctx = reinterpret_cast<PingMultipleCBContext*>(context);
+    size_t numNames = ctx->names.size();
+
+    if (reply->GetType() == MESSAGE_METHOD_RET) {
+        size_t numDispositions;
+        uint32_t* dispositions;
+        QStatus status = reply->GetArgs("au", &numDispositions, &dispositions);
+        if ((ER_OK == status) && (numDispositions != numNames)) {
+            status = ER_BUS_UNEXPECTED_DISPOSITION;
+        }
+        for (size_t i = 0; i < numNames; ++i) {
+            ctx->statuses[i] = (ER_OK == status) ? PingDispositionToStatus(dispositions[i]) : status;
+        }
+    } else if (!strcmp(reply->GetErrorDescription().c_str(), "org.alljoyn.Bus.Timeout")) {
+        for (size_t i = 0; i < numNames; ++i) {
+            ctx->statuses[i] = ER_ALLJOYN_PING_REPLY_TIMEOUT;
+        }
+    } else {
+        /*
+         * The router predates PingMultiple, ping the names one at a time.  Each
+         * ping holds a reference on the context on top of our own so that the
+         * callback is only made once all of them are done.
+         */
+        QCC_DbgPrintf(("%s.PingMultiple returned ERROR_MESSAGE (error=%s)", org::alljoyn::Bus::InterfaceName, reply->GetErrorDescription().c_str()));
+        ctx->lock.Lock(MUTEX_CONTEXT);
+        ctx->outstanding += numNames;
+        ctx->lock.Unlock(MUTEX_CONTEXT);
+        for (size_t i = 0; i < numNames; ++i) {
+            QStatus status = bus.PingAsync(ctx->names[i].c_str(), ctx->timeout, ctx, reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+            if (status != ER_OK) {
+                ctx->Complete(i, status);
+            }
+        }
+    }
+
+    ctx->Release();
+}
+
 qcc::String BusAttachment::GetNameOwner(const char* alias)
 {
     if (!IsConnected()) {
@@ -40,6 +40,7 @@
 #include "AuthManager.h"
 #include "ObserverManager.h"
 #include "ClientRouter.h"
+#include "HeaderTemplateCache.h"
 #include "KeyStore.h"
 #include "PeerState.h"
 #include "Transport.h"
@@ -114,6 +115,13 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
      */
     PeerStateTable* GetPeerStateTable() { return &peerStateTable; }
 
+    /**
+     * Get the cache of marshaled header fields for messages sent by this bus.
+     *
+     * @return  The header template cache.
+     */
+    HeaderTemplateCache& GetHeaderTemplateCache() { return headerTemplateCache; }
+
     /**
      * Get the global GUID for this bus.
      *
@@ -314,6 +322,11 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
      */
     void PingAsyncCB(Message& message, void* context);
 
+    /**
+     * PingMultiple method_reply handler
+     */
+    void PingMultipleAsyncCB(Message& message, void* context);
+
     /**
      * Get a reference to the internal permission manager
      *
@@ -539,6 +552,7 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
     volatile int32_t msgSerial;           /* Serial number is updated for every message sent by this bus */
     Router* router;                       /* Message bus router */
     PeerStateTable peerStateTable;        /* Table that maintains state information about remote peers */
+    HeaderTemplateCache headerTemplateCache; /* Marshaled header fields of recently sent messages */
     LocalEndpoint localEndpoint;          /* The local endpoint */
 
     bool allowRemoteMessages;             /* true iff endpoints of this attachment can receive messages from remote devices */
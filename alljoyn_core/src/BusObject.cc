@@ -43,6 +43,7 @@
 #include "AllJoynPeerObj.h"
 #include "MethodTable.h"
 #include "BusInternal.h"
+#include "PropChangedCoalescer.h"
 
 
 #define QCC_MODULE "ALLJOYN"
@@ -59,6 +60,7 @@ typedef struct {
     const InterfaceDescription::Member* member;   /**< Pointer to method's member */
     MessageReceiver::MethodHandler handler;       /**< Method implementation */
     void* context;
+    bool typedArgs;                               /**< Handler reads the marshaled body with TypedArgs */
 } MethodContext;
 #pragma pack(pop, MethodContext)
 
@@ -82,6 +84,15 @@ struct BusObject::Components {
 
     /** counter to prevent this BusObject being deleted if it is being used by another thread. */
     volatile int32_t inUseCounter;
+
+    /** lock protecting the creation of the coalescer */
+    qcc::Mutex coalescerLock;
+
+    /** Batches PropertiesChanged signals, NULL until coalescing is configured */
+    PropChangedCoalescer* coalescer;
+
+    /** Reads several properties at once, NULL to read them with Get() */
+    BusObject::PropsGetter propsGetter;
 };
 
 /**
@@ -349,7 +360,7 @@ QStatus BusObject::EmitPropChanged(const char* ifcName, const char** propNames,
     if (!ifc) {
         status = ER_BUS_UNKNOWN_INTERFACE;
     } else {
-        MsgArg* updatedProp = new MsgArg[numProps];
+        const char** updatedNames = new const char*[numProps];
         const char** invalidatedProp = new const char*[numProps];
         size_t updatedPropNum = 0;
         size_t invalidatedPropNum = 0;
@@ -371,15 +382,7 @@ QStatus BusObject::EmitPropChanged(const char* ifcName, const char** propNames,
                 /* property has emitschanged annotation and is readable */
                 if (emitsChanged == "true") {
                     /* also emit the value */
-                    MsgArg* val = new MsgArg();
-                    status = Get(ifcName, propName, *val);
-                    if (status != ER_OK) {
-                        delete val;
-                        status = ER_BUS_NO_SUCH_PROPERTY;
-                        break;
-                    }
-                    updatedProp[updatedPropNum].Set("{sv}", propName, val);
-                    updatedProp[updatedPropNum].SetOwnershipFlags(MsgArg::OwnsArgs, true /*deep*/);
+                    updatedNames[updatedPropNum] = propName;
                     updatedPropNum++;
                     vNames.push_back(propName);
                 } else if (emitsChanged == "invalidates") {
@@ -390,6 +393,18 @@ QStatus BusObject::EmitPropChanged(const char* ifcName, const char** propNames,
                 }
             }
         }
+
+        /* Get all of the updated values at once, the dictionary entries refer to them */
+        MsgArg* vals = new MsgArg[updatedPropNum];
+        MsgArg* updatedProp = new MsgArg[updatedPropNum];
+        if ((status == ER_OK) && (updatedPropNum > 0)) {
+            if (GetProps(ifcName, updatedNames, updatedPropNum, vals) != ER_OK) {
+                status = ER_BUS_NO_SUCH_PROPERTY;
+            }
+            for (size_t i = 0; (status == ER_OK) && (i < updatedPropNum); ++i) {
+                updatedProp[i].Set("{sv}", updatedNames[i], &vals[i]);
+            }
+        }
         if (status == ER_OK) {
             const InterfaceDescription* bus_ifc = bus->GetInterface(org::freedesktop::DBus::Properties::InterfaceName);
             QCC_ASSERT(bus_ifc);
@@ -407,11 +422,80 @@ QStatus BusObject::EmitPropChanged(const char* ifcName, const char** propNames,
         vNames.clear();
 
         delete[] updatedProp;
+        delete[] vals;
+        delete[] updatedNames;
         delete[] invalidatedProp;
     }
     return status;
 }
 
+QStatus BusObject::SetPropsGetter(PropsGetter getter)
+{
+    if (isRegistered) {
+        QStatus status = ER_BUS_CANNOT_ADD_HANDLER;
+        QCC_LogError(status, ("Cannot set the properties getter of an object that is already registered"));
+        return status;
+    }
+    components->propsGetter = getter;
+    return ER_OK;
+}
+
+QStatus BusObject::GetProps(const char* ifcName, const char** propNames, size_t numProps, MsgArg* vals)
+{
+    if (components->propsGetter) {
+        return (this->*components->propsGetter)(ifcName, propNames, numProps, vals);
+    }
+    QStatus status = ER_OK;
+    for (size_t i = 0; (status == ER_OK) && (i < numProps); ++i) {
+        status = Get(ifcName, propNames[i], vals[i]);
+    }
+    return status;
+}
+
+QStatus BusObject::SetPropChangedCoalescing(uint32_t interval, size_t maxBatch)
+{
+    components->coalescerLock.Lock(MUTEX_CONTEXT);
+    if (!components->coalescer) {
+        components->coalescer = new PropChangedCoalescer(*this);
+    }
+    QStatus status = components->coalescer->Configure(interval, maxBatch);
+    components->coalescerLock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
+QStatus BusObject::MarkPropChanged(const char* ifcName, const char* propName, SessionId id, uint8_t flags)
+{
+    if (!bus || !isRegistered) {
+        return ER_BUS_OBJECT_NOT_REGISTERED;
+    }
+    components->coalescerLock.Lock(MUTEX_CONTEXT);
+    PropChangedCoalescer* coalescer = components->coalescer;
+    components->coalescerLock.Unlock(MUTEX_CONTEXT);
+    if (coalescer) {
+        return coalescer->Mark(ifcName, propName, id, flags);
+    } else {
+        return EmitPropChanged(ifcName, &propName, 1, id, flags);
+    }
+}
+
+QStatus BusObject::FlushPropChanged()
+{
+    components->coalescerLock.Lock(MUTEX_CONTEXT);
+    PropChangedCoalescer* coalescer = components->coalescer;
+    components->coalescerLock.Unlock(MUTEX_CONTEXT);
+    return coalescer ? coalescer->Flush() : ER_OK;
+}
+
+void BusObject::StopPropChangedCoalescing()
+{
+    components->coalescerLock.Lock(MUTEX_CONTEXT);
+    PropChangedCoalescer* coalescer = components->coalescer;
+    components->coalescerLock.Unlock(MUTEX_CONTEXT);
+    if (coalescer) {
+        coalescer->Stop();
+    }
+}
+
 void BusObject::SetProp(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
@@ -460,6 +544,7 @@ void BusObject::GetAllProps(const InterfaceDescription::Member* member, Message&
     QStatus status = ER_OK;
     const MsgArg* iface = msg->GetArg(0);
     MsgArg vals;
+    MsgArg* values = NULL;
     const InterfaceDescription::Property** props = NULL;
 
     /* Check interface exists and has properties */
@@ -500,24 +585,25 @@ void BusObject::GetAllProps(const InterfaceDescription::Member* member, Message&
                     }
                 }
             }
-            MsgArg* dict = new MsgArg[readable];
-            MsgArg* entry = dict;
-            /* Get readable properties */
+            const char** names = new const char*[readable];
+            size_t entries = 0;
             for (size_t i = 0; i < numProps; i++) {
                 if ((props[i]->access & PROP_ACCESS_READ) && allowed[i]) {
-                    MsgArg* val = new MsgArg();
-                    status = Get(iface->v_string.str, props[i]->name.c_str(), *val);
-                    if (status != ER_OK) {
-                        delete val;
-                        break;
-                    }
-                    entry->Set("{sv}", props[i]->name.c_str(), val);
-                    entry->v_dictEntry.val->SetOwnershipFlags(MsgArg::OwnsArgs, false);
-                    entry++;
+                    names[entries++] = props[i]->name.c_str();
+                }
+            }
+            /* Get readable properties all at once, the dictionary entries refer to the values */
+            values = new MsgArg[readable];
+            status = GetProps(iface->v_string.str, names, readable, values);
+            if (status == ER_OK) {
+                MsgArg* dict = new MsgArg[readable];
+                for (size_t i = 0; i < readable; i++) {
+                    dict[i].Set("{sv}", names[i], &values[i]);
                 }
+                vals.Set("a{sv}", readable, dict);
+                vals.SetOwnershipFlags(MsgArg::OwnsArgs, false);
             }
-            vals.Set("a{sv}", readable, dict);
-            vals.SetOwnershipFlags(MsgArg::OwnsArgs, false);
+            delete [] names;
             delete [] allowed;
         }
     } else {
@@ -529,6 +615,8 @@ void BusObject::GetAllProps(const InterfaceDescription::Member* member, Message&
     } else {
         MethodReply(msg, status);
     }
+    vals.Clear();
+    delete [] values;
     delete [] props;
 }
 
@@ -551,6 +639,16 @@ void BusObject::Introspect(const InterfaceDescription::Member* member, Message&
 }
 
 QStatus BusObject::AddMethodHandler(const InterfaceDescription::Member* member, MessageReceiver::MethodHandler handler, void* handlerContext)
+{
+    return AddMethodHandlerInternal(member, handler, handlerContext, false);
+}
+
+QStatus BusObject::AddTypedMethodHandler(const InterfaceDescription::Member* member, MessageReceiver::MethodHandler handler, void* handlerContext)
+{
+    return AddMethodHandlerInternal(member, handler, handlerContext, true);
+}
+
+QStatus BusObject::AddMethodHandlerInternal(const InterfaceDescription::Member* member, MessageReceiver::MethodHandler handler, void* handlerContext, bool typedArgs)
 {
     if (!member) {
         return ER_BAD_ARG_1;
@@ -563,7 +661,7 @@ QStatus BusObject::AddMethodHandler(const InterfaceDescription::Member* member,
         status = ER_BUS_CANNOT_ADD_HANDLER;
         QCC_LogError(status, ("Cannot add method handler to an object that is already registered"));
     } else if (ImplementsInterface(member->iface->GetName())) {
-        MethodContext ctx = { member, handler, handlerContext };
+        MethodContext ctx = { member, handler, handlerContext, typedArgs };
         if (find(components->methodContexts.begin(), components->methodContexts.end(), ctx) == components->methodContexts.end()) {
             components->methodContexts.push_back(ctx);
         }
@@ -595,7 +693,7 @@ void BusObject::InstallMethods(MethodTable& methodTable)
     vector<MethodContext>::iterator iter;
     for (iter = components->methodContexts.begin(); iter != components->methodContexts.end(); iter++) {
         const MethodContext methodContext = *iter;
-        methodTable.Add(this, methodContext.handler, methodContext.member, methodContext.context);
+        methodTable.Add(this, methodContext.handler, methodContext.member, methodContext.context, methodContext.typedArgs);
     }
 }
 
@@ -654,6 +752,13 @@ QStatus BusObject::DoRegistration(BusAttachment& busAttachment)
     // overwrite the one from the (deprecated) constructor.
     bus = &busAttachment;
 
+    /* Unregistering stopped coalescing, hold changes back again */
+    components->coalescerLock.Lock(MUTEX_CONTEXT);
+    if (components->coalescer) {
+        components->coalescer->Resume();
+    }
+    components->coalescerLock.Unlock(MUTEX_CONTEXT);
+
     /* Add the standard DBus interfaces */
     const InterfaceDescription* introspectable = bus->GetInterface(org::freedesktop::DBus::Introspectable::InterfaceName);
     QCC_ASSERT(introspectable);
@@ -706,6 +811,20 @@ QStatus BusObject::DoRegistration(BusAttachment& busAttachment)
         }
     }
     status = AddMethodHandlers(methodEntries, ArraySize(methodEntries));
+
+    /* Objects that opted in to tree introspection get the handler for it unless they brought their own */
+    if ((ER_OK == status) && ImplementsInterface(org::allseen::IntrospectableTree::InterfaceName)) {
+        const InterfaceDescription* treeIntf = bus->GetInterface(org::allseen::IntrospectableTree::InterfaceName);
+        QCC_ASSERT(treeIntf);
+        const InterfaceDescription::Member* treeMember = treeIntf->GetMember("IntrospectTree");
+        bool hasHandler = false;
+        for (size_t i = 0; !hasHandler && (i < components->methodContexts.size()); ++i) {
+            hasHandler = (components->methodContexts[i].member == treeMember);
+        }
+        if (!hasHandler) {
+            status = AddMethodHandler(treeMember, static_cast<MessageReceiver::MethodHandler>(&BusObject::IntrospectTree));
+        }
+    }
     return status;
 }
 
@@ -717,7 +836,8 @@ QStatus BusObject::SignalInternal(const char* destination,
                                   uint16_t timeToLive,
                                   uint8_t flags,
                                   Message* outMsg,
-                                  SignalAuthorizationCallback* authorizationCallback)
+                                  SignalAuthorizationCallback* authorizationCallback,
+                                  const MsgBodyWriter* body)
 {
     /* Protect against calling Signal before object is registered */
     if (!bus) {
@@ -813,7 +933,9 @@ QStatus BusObject::SignalInternal(const char* destination,
                                          args,
                                          numArgs,
                                          flags,
-                                         timeToLive);
+                                         timeToLive,
+                                         body,
+                                         &signalMember);
         if (aStatus == ER_OK) {
             if (msg->IsEncrypted()) {
                 if (authorizationCallback != NULL) {
@@ -862,6 +984,17 @@ QStatus BusObject::Signal(const char* destination,
     return SignalInternal(destination, sessionId, signalMember, args, numArgs, timeToLive, flags, outMsg, NULL);
 }
 
+QStatus BusObject::Signal(const char* destination,
+                          SessionId sessionId,
+                          const InterfaceDescription::Member& signalMember,
+                          const MsgBodyWriter& body,
+                          uint16_t timeToLive,
+                          uint8_t flags,
+                          Message* outMsg)
+{
+    return SignalInternal(destination, sessionId, signalMember, NULL, 0, timeToLive, flags, outMsg, NULL, &body);
+}
+
 QStatus BusObject::CancelSessionlessMessage(uint32_t serialNum)
 {
     if (!bus) {
@@ -902,6 +1035,16 @@ QStatus BusObject::CancelSessionlessMessage(uint32_t serialNum)
 }
 
 QStatus BusObject::MethodReply(const Message& msg, const MsgArg* args, size_t numArgs, Message* replyMsg)
+{
+    return MethodReplyInternal(msg, args, numArgs, NULL, replyMsg);
+}
+
+QStatus BusObject::MethodReply(const Message& msg, const MsgBodyWriter& body, Message* replyMsg)
+{
+    return MethodReplyInternal(msg, NULL, 0, &body, replyMsg);
+}
+
+QStatus BusObject::MethodReplyInternal(const Message& msg, const MsgArg* args, size_t numArgs, const MsgBodyWriter* body, Message* replyMsg)
 {
     QStatus status;
 
@@ -919,7 +1062,7 @@ QStatus BusObject::MethodReply(const Message& msg, const MsgArg* args, size_t nu
         status = ER_BUS_NO_CALL_FOR_REPLY;
     } else {
         Message reply(*bus);
-        status = reply->ReplyMsg(msg, args, numArgs);
+        status = reply->ReplyMsg(msg, args, numArgs, body);
         if (status == ER_OK) {
             BusEndpoint bep = BusEndpoint::cast(bus->GetInternal().GetLocalEndpoint());
             status = bus->GetInternal().GetRouter().PushMessage(reply, bep);
@@ -1075,6 +1218,8 @@ BusObject::BusObject(BusAttachment& bus, const char* path, bool isPlaceholder) :
     translator(NULL)
 {
     components->inUseCounter = 0;
+    components->coalescer = NULL;
+    components->propsGetter = NULL;
 }
 
 BusObject::BusObject(const char* path, bool isPlaceholder) :
@@ -1090,10 +1235,20 @@ BusObject::BusObject(const char* path, bool isPlaceholder) :
     translator(NULL)
 {
     components->inUseCounter = 0;
+    components->coalescer = NULL;
+    components->propsGetter = NULL;
 }
 
 BusObject::~BusObject()
 {
+    /*
+     * Emitting coalesced property changes reads them through the virtual Get()
+     * so derived objects must have been unregistered, which stops the coalescer,
+     * before they are destroyed.  This only catches objects that never were.
+     */
+    delete components->coalescer;
+    components->coalescer = NULL;
+
     components->counterLock.Lock(MUTEX_CONTEXT);
     while (components->inUseCounter != 0) {
         components->counterLock.Unlock(MUTEX_CONTEXT);
@@ -1170,6 +1325,62 @@ void BusObject::IntrospectWithDescription(const InterfaceDescription::Member* me
     }
 }
 
+void BusObject::IntrospectTree(const InterfaceDescription::Member* member, Message& msg)
+{
+    QCC_UNUSED(member);
+
+    char* langTag;
+    msg->GetArgs("s", &langTag);
+
+    qcc::String xml = org::allseen::Introspectable::IntrospectDocType;
+    xml += "<node>\n";
+    xml += GenerateTreeIntrospection(langTag, 2);
+    xml += "</node>\n";
+    MsgArg arg("s", xml.c_str());
+    QStatus status = MethodReply(msg, &arg, 1);
+    if (status != ER_OK) {
+        /* The tree may be too large for a single message, the caller falls back to introspecting each object */
+        QCC_LogError(status, ("IntrospectTree reply for %s failed", GetPath()));
+        MethodReply(msg, status);
+    }
+}
+
+qcc::String BusObject::GenerateTreeIntrospection(const char* languageTag, size_t indent) const
+{
+    qcc::String in(indent, ' ');
+    qcc::String xml;
+    qcc::String buffer;
+
+    const char* desc = GetDescription(languageTag, buffer);
+    if (desc) {
+        xml += in + "<description>" + XmlElement::EscapeXml(desc) + "</description>\n";
+    }
+    if (isSecure) {
+        xml += in + "<annotation name=\"org.alljoyn.Bus.Secure\" value=\"true\"/>\n";
+    }
+
+    /* Iterate over child nodes */
+    vector<BusObject*>::const_iterator iter = components->children.begin();
+    while (iter != components->children.end()) {
+        BusObject* child = *iter++;
+        xml += in + "<node name=\"" + child->GetName() + "\">\n";
+        xml += child->GenerateTreeIntrospection(languageTag, indent + 2);
+        xml += in + "</node>\n";
+    }
+    if (!isPlaceholder) {
+        /* Iterate over interfaces omitting the standard D-Bus interfaces as in GenerateIntrospection() */
+        vector<pair<const InterfaceDescription*, bool> >::const_iterator itIf = components->ifaces.begin();
+        while (itIf != components->ifaces.end()) {
+            const InterfaceDescription* iface = (itIf++)->first;
+            if ((strcmp(iface->GetName(), org::freedesktop::DBus::InterfaceName) != 0) &&
+                (strcmp(iface->GetName(), org::freedesktop::DBus::Properties::InterfaceName) != 0)) {
+                xml += iface->Introspect(indent, languageTag, bus ? bus->GetDescriptionTranslator() : NULL);
+            }
+        }
+    }
+    return xml;
+}
+
 void mergeTranslationLanguages(Translator* t, std::set<qcc::String>& langs)
 {
     size_t numLangs = t->NumTargetLanguages();
@@ -0,0 +1,324 @@
+/**
+ * @file
+ *
+ * This file implements the cache of the property values of a proxy object's interface.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <qcc/Debug.h>
+
+#include "CachedProps.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+
+namespace ajn {
+
+CachedProps::CachedProps() :
+    lock(), numSnapshots(0), published(new Snapshot(0, &numSnapshots)),
+    description(NULL), isFullyCacheable(false),
+    numProperties(0), lastMessageSerial(0),
+    enabled(false)
+{
+}
+
+CachedProps::CachedProps(const InterfaceDescription* intf) :
+    lock(), numSnapshots(0), published(new Snapshot(0, &numSnapshots)),
+    description(intf), isFullyCacheable(false), lastMessageSerial(0),
+    enabled(false)
+{
+    numProperties = description->GetProperties();
+    if (numProperties > 0) {
+        isFullyCacheable = true;
+        const InterfaceDescription::Property** props = new const InterfaceDescription::Property* [numProperties];
+        description->GetProperties(props, numProperties);
+        for (size_t i = 0; i < numProperties; ++i) {
+            if (props[i]->cacheable == false) {
+                isFullyCacheable = false;
+            } else {
+                names.push_back(props[i]->name);
+            }
+        }
+        delete[] props;
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        index[qcc::StringMapKey(names[i])] = i;
+    }
+    delete published.Exchange(new Snapshot(names.size(), &numSnapshots));
+}
+
+CachedProps::CachedProps(const CachedProps& other) :
+    lock(), index(other.index), names(other.names),
+    numSnapshots(0), published(other.CopySnapshot(&numSnapshots)),
+    description(other.description), isFullyCacheable(other.isFullyCacheable),
+    numProperties(other.numProperties), lastMessageSerial(other.lastMessageSerial),
+    enabled(other.enabled)
+{
+}
+
+CachedProps& CachedProps::operator=(const CachedProps& other)
+{
+    if (&other != this) {
+        lock.Lock(MUTEX_CONTEXT);
+        index = other.index;
+        names = other.names;
+        Publish(other.CopySnapshot(&numSnapshots));
+        description = other.description;
+        isFullyCacheable = other.isFullyCacheable;
+        numProperties = other.numProperties;
+        lastMessageSerial = other.lastMessageSerial;
+        enabled = other.enabled;
+        lock.Unlock(MUTEX_CONTEXT);
+    }
+    return *this;
+}
+
+CachedProps::~CachedProps()
+{
+    delete published.Current();
+}
+
+bool CachedProps::Lookup(const char* propname, size_t& i) const
+{
+    std::map<qcc::StringMapKey, size_t>::const_iterator it = index.find(propname);
+    if (it == index.end()) {
+        return false;
+    }
+    i = it->second;
+    return true;
+}
+
+CachedProps::Snapshot* CachedProps::CopySnapshot(volatile int32_t* live) const
+{
+    EpochPointer<Snapshot>::ReadGuard guard(published);
+    const Snapshot* snapshot = guard.Get();
+    Snapshot* copy = new Snapshot(snapshot->values.size(), live);
+    copy->values = snapshot->values;
+    copy->cached = snapshot->cached;
+    copy->numCached = snapshot->numCached;
+    return copy;
+}
+
+void CachedProps::Publish(Snapshot* snapshot)
+{
+    /* Returns once no reader can still see the replaced snapshot */
+    delete published.Exchange(snapshot);
+}
+
+bool CachedProps::Get(const char* propname, MsgArg& val)
+{
+    size_t i;
+    if (!Lookup(propname, i)) {
+        return false;
+    }
+    EpochPointer<Snapshot>::ReadGuard guard(published);
+    const Snapshot* snapshot = guard.Get();
+    bool found = snapshot->cached[i];
+    if (found) {
+        val = *(snapshot->values[i]);
+    }
+    return found;
+}
+
+bool CachedProps::GetAll(MsgArg& val)
+{
+    if (!isFullyCacheable || numProperties == 0) {
+        return false;
+    }
+
+    EpochPointer<Snapshot>::ReadGuard guard(published);
+    const Snapshot* snapshot = guard.Get();
+    bool complete = (snapshot->numCached == numProperties);
+    if (complete) {
+        MsgArg* dict = new MsgArg[numProperties];
+        for (size_t i = 0; i < numProperties; ++i) {
+            MsgArg* inner;
+            snapshot->values[i]->Get("v", &inner);
+            dict[i].Set("{sv}", names[i].c_str(), inner);
+        }
+        val.Set("a{sv}", numProperties, dict);
+        val.Stabilize();
+        delete[] dict;
+    }
+    return complete;
+}
+
+bool CachedProps::IsValidMessageSerial(uint32_t messageSerial)
+{
+    uint32_t threshold = (uint32_t) (0x1 << 31);
+    if (messageSerial >= lastMessageSerial) {
+        // messageSerial should be higher than the last.
+        // The check returns true unless the diff is too big.
+        // In this case we assume an out-of-order message is processed.
+        // The message was sent prior to a wrap around of the uint32_t counter.
+        return ((messageSerial - lastMessageSerial) < threshold);
+    }
+    // The messageSerial is smaller than the last. This is an out-of-order
+    // message (return false) unless the diff is too big. if the diff is high
+    // we assume we hit a wrap around of the message serial counter (return true).
+    return ((lastMessageSerial - messageSerial) > threshold);
+}
+
+void CachedProps::Set(const char* propname, const MsgArg& val, const uint32_t messageSerial)
+{
+    size_t i;
+    if (!Lookup(propname, i)) {
+        return;
+    }
+
+    lock.Lock(MUTEX_CONTEXT);
+    if (!enabled) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+
+    if (!IsValidMessageSerial(messageSerial)) {
+        Publish(new Snapshot(names.size(), &numSnapshots));
+    } else {
+        Snapshot* snapshot = new Snapshot(*published.Current());
+        CachedValue value;
+        *value = val;
+        snapshot->Set(i, value);
+        Publish(snapshot);
+        lastMessageSerial = messageSerial;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void CachedProps::SetAll(const MsgArg& allValues, const uint32_t messageSerial)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    if (!enabled) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+
+    Snapshot* snapshot = new Snapshot(*published.Current());
+    size_t nelem;
+    MsgArg* elems;
+    QStatus status = allValues.Get("a{sv}", &nelem, &elems);
+    if (status != ER_OK) {
+        goto error;
+    }
+
+    if (!IsValidMessageSerial(messageSerial)) {
+        status = ER_FAIL;
+        goto error;
+    }
+
+    for (size_t i = 0; i < nelem; ++i) {
+        const char* prop;
+        MsgArg* val;
+        size_t num;
+        status = elems[i].Get("{sv}", &prop, &val);
+        if (status != ER_OK) {
+            goto error;
+        }
+        if (Lookup(prop, num)) {
+            CachedValue value;
+            value->Set("v", val);
+            value->Stabilize();
+            snapshot->Set(num, value);
+        }
+    }
+
+    Publish(snapshot);
+    lastMessageSerial = messageSerial;
+
+    lock.Unlock(MUTEX_CONTEXT);
+    return;
+
+error:
+    /* We can't make sense of the property values for some reason.
+     * Play it safe and invalidate all properties */
+    QCC_LogError(status, ("Failed to parse GetAll return value or inconsistent message serial number. Invalidating property cache."));
+    delete snapshot;
+    Publish(new Snapshot(names.size(), &numSnapshots));
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void CachedProps::PropertiesChanged(MsgArg* changed, size_t numChanged, MsgArg* invalidated, size_t numInvalidated, const uint32_t messageSerial)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    if (!enabled) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+
+    Snapshot* snapshot = new Snapshot(*published.Current());
+    QStatus status;
+
+    if (!IsValidMessageSerial(messageSerial)) {
+        status = ER_FAIL;
+        goto error;
+    }
+
+    for (size_t i = 0; i < numChanged; ++i) {
+        const char* prop;
+        MsgArg* val;
+        size_t num;
+        status = changed[i].Get("{sv}", &prop, &val);
+        if (status != ER_OK) {
+            goto error;
+        }
+        if (Lookup(prop, num)) {
+            CachedValue value;
+            value->Set("v", val);
+            value->Stabilize();
+            snapshot->Set(num, value);
+        }
+    }
+
+    for (size_t i = 0; i < numInvalidated; ++i) {
+        char* prop;
+        size_t num;
+        status = invalidated[i].Get("s", &prop);
+        if (status != ER_OK) {
+            goto error;
+        }
+        if (Lookup(prop, num)) {
+            snapshot->Clear(num);
+        }
+    }
+
+    Publish(snapshot);
+    lastMessageSerial = messageSerial;
+
+    lock.Unlock(MUTEX_CONTEXT);
+    return;
+
+error:
+    /* We can't make sense of the property update signal for some reason.
+     * Play it safe and invalidate all properties */
+    QCC_LogError(status, ("Failed to parse PropertiesChanged signal or inconsistent message serial number. Invalidating property cache."));
+    delete snapshot;
+    Publish(new Snapshot(names.size(), &numSnapshots));
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void CachedProps::Enable()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    enabled = true;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+}
@@ -0,0 +1,154 @@
+#ifndef _ALLJOYN_CACHEDPROPS_H
+#define _ALLJOYN_CACHEDPROPS_H
+/**
+ * @file
+ * This file defines the cache of the property values of a proxy object's interface.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include CachedProps.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <map>
+#include <vector>
+
+#include <qcc/ManagedObj.h>
+#include <qcc/Mutex.h>
+#include <qcc/String.h>
+#include <qcc/StringMapKey.h>
+#include <qcc/atomic.h>
+
+#include <alljoyn/InterfaceDescription.h>
+#include <alljoyn/MsgArg.h>
+
+#include "EpochPointer.h"
+
+namespace ajn {
+
+/**
+ * Cache of the property values of one interface.
+ *
+ * The cacheable properties of the interface are numbered once, when the cache
+ * is created.  The values are kept in an immutable snapshot indexed by that
+ * number which is replaced as a whole whenever the cache is updated.  The
+ * values are reference counted and shared between snapshots so an update only
+ * copies the array of references and replaces the entries that changed.
+ *
+ * Readers take no lock.  The snapshot is published through an EpochPointer so
+ * a reader always sees either the snapshot before or the one after an update
+ * and never a partly applied one.  An update waits for the readers of the
+ * snapshot it replaced and frees it, so no more than two snapshots exist at
+ * any time however busy the readers are.
+ */
+class CachedProps {
+  public:
+    CachedProps();
+
+    CachedProps(const InterfaceDescription* intf);
+
+    CachedProps(const CachedProps& other);
+
+    CachedProps& operator=(const CachedProps& other);
+
+    ~CachedProps();
+
+    bool Get(const char* propname, MsgArg& val);
+    bool GetAll(MsgArg& val);
+    void Set(const char* propname, const MsgArg& val, const uint32_t messageSerial);
+    void SetAll(const MsgArg& allValues, const uint32_t messageSerial);
+    void PropertiesChanged(MsgArg* changed, size_t numChanged, MsgArg* invalidated, size_t numInvalidated, const uint32_t messageSerial);
+    void Enable();
+
+    /**
+     * Get the number of snapshots of the cache that have not been freed.
+     *
+     * @return  The number of snapshots.
+     */
+    int32_t GetNumSnapshots() const { return numSnapshots; }
+
+  private:
+    /** A cached property value (a variant) shared between snapshots */
+    typedef qcc::ManagedObj<MsgArg> CachedValue;
+
+    struct Snapshot {
+        std::vector<CachedValue> values;   /**< Values by property number */
+        std::vector<bool> cached;          /**< Whether a property's value is cached */
+        size_t numCached;                  /**< Number of cached values */
+        volatile int32_t* live;            /**< Number of snapshots of the cache */
+
+        Snapshot(size_t numProperties, volatile int32_t* live) :
+            values(numProperties, CachedValue()), cached(numProperties, false), numCached(0), live(live)
+        {
+            qcc::IncrementAndFetch(live);
+        }
+
+        Snapshot(const Snapshot& other) :
+            values(other.values), cached(other.cached), numCached(other.numCached), live(other.live)
+        {
+            qcc::IncrementAndFetch(live);
+        }
+
+        ~Snapshot()
+        {
+            qcc::DecrementAndFetch(live);
+        }
+
+        void Set(size_t i, const CachedValue& value)
+        {
+            values[i] = value;
+            if (!cached[i]) {
+                cached[i] = true;
+                ++numCached;
+            }
+        }
+
+        void Clear(size_t i)
+        {
+            if (cached[i]) {
+                cached[i] = false;
+                --numCached;
+            }
+        }
+
+      private:
+        Snapshot& operator=(const Snapshot& other);
+    };
+
+    bool Lookup(const char* propname, size_t& i) const;
+    bool IsValidMessageSerial(uint32_t messageSerial);
+    Snapshot* CopySnapshot(volatile int32_t* live) const;
+    void Publish(Snapshot* snapshot);
+
+    mutable qcc::Mutex lock;                        /**< Serializes updates of the cache */
+    std::map<qcc::StringMapKey, size_t> index;      /**< Cacheable property numbers (never changes once built) */
+    std::vector<qcc::String> names;                 /**< Cacheable property names by number */
+    volatile int32_t numSnapshots;                  /**< Snapshots that have not been freed */
+    EpochPointer<Snapshot> published;               /**< The snapshot readers see */
+    const InterfaceDescription* description;
+    bool isFullyCacheable;
+    size_t numProperties;
+    uint32_t lastMessageSerial;
+    bool enabled;
+};
+
+}
+
+#endif
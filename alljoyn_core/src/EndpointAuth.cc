@@ -168,20 +168,11 @@ QStatus EndpointAuth::Hello(qcc::String& redirection)
 static const uint32_t REDIRECT_TIMEOUT = 30 * 1000;
 
 
-QStatus EndpointAuth::WaitHello(qcc::String& authUsed)
+QStatus EndpointAuth::HandleHello(qcc::String& authUsed, qcc::String& redirection)
 {
-    QCC_DbgTrace(("EndpointAuth::WaitHello(authUsed=\"%s\")", authUsed.c_str()));
+    QCC_DbgTrace(("EndpointAuth::HandleHello(authUsed=\"%s\")", authUsed.c_str()));
 
-    qcc::String redirection;
-    QStatus status;
-    Message hello(bus);
-
-    status = hello->Read(endpoint, false);
-
-    if (status != ER_OK) {
-        return status;
-    }
-    status = hello->Unmarshal(endpoint, false);
+    QStatus status = hello->Unmarshal(endpoint, false);
     if (ER_OK == status) {
         if (hello->GetType() != MESSAGE_METHOD_CALL) {
             QCC_DbgPrintf(("First message must be Hello/BusHello method call"));
@@ -298,24 +289,6 @@ QStatus EndpointAuth::WaitHello(qcc::String& authUsed)
             QCC_LogError(status, ("%s", __FUNCTION__));
         }
     }
-    if ((ER_OK == status) && !redirection.empty()) {
-        /*
-         * We expect the other end to shutdown the endpoint socket as soon as it receives the
-         * redirection error response. The only way we can tell if the socket is closed is by
-         * attempting to read or write to it. We do a read with a timeout. If we actually read data
-         * or the timeout expires it means the socket wasn't closed by the other end so we assume
-         * the the redirection failed.
-         */
-        uint8_t buf[1];
-        size_t sz;
-        Source& source = endpoint->GetSource();
-        status = source.PullBytes(buf, sizeof(buf), sz, REDIRECT_TIMEOUT);
-        if (status == ER_OK || status == ER_TIMEOUT) {
-            status = ER_BUS_ESTABLISH_FAILED;
-        } else {
-            status = ER_BUS_ENDPOINT_REDIRECTED;
-        }
-    }
     return status;
 }
 
@@ -417,54 +390,20 @@ QStatus EndpointAuth::Establish(const qcc::String& authMechanisms,
 
     if (isAccepting) {
         QCC_DbgPrintf(("EndpointAuth::Establish(): Accepting"));
-        SASLEngine sasl(bus, AuthMechanism::CHALLENGER, authMechanisms, NULL, authListener, this);
-        /*
-         * The server's GUID is sent to the client when the authentication succeeds
-         */
-        String guidStr = bus.GetInternal().GetGlobalGUID().ToString();
-        sasl.SetLocalId(guidStr);
-        for (;;) {
-            /*
-             * Get the challenge
-             */
-            inStr.clear();
-            status = endpoint->GetSource().GetLine(inStr, timeout);
-            if (status != ER_OK) {
-                QCC_LogError(status, ("Failed to read from stream"));
-                goto ExitEstablish;
-            }
-            QCC_DbgPrintf(("EndpointAuth::Establish(): Got \"%s\" from stream", inStr.c_str()));
-            status = sasl.Advance(inStr, outStr, state);
-            if (status != ER_OK) {
-                QCC_DbgPrintf(("Server authentication failed %s", QCC_StatusText(status)));
-                goto ExitEstablish;
-            }
-            if (state == SASLEngine::ALLJOYN_AUTH_SUCCESS) {
-                /*
-                 * Remember the authentication mechanism that was used
-                 */
-                authUsed = sasl.GetMechanism();
+        status = BeginAccept(authMechanisms, listener);
+        while (status == ER_OK) {
+            status = ContinueAccept(authUsed, redirection);
+            if (status != ER_WOULDBLOCK) {
                 break;
             }
-            /*
-             * Send the response
-             */
-            QCC_DbgPrintf(("EndpointAuth::Establish(): Responding with \"%s\" to stream", outStr.c_str()));
-            status = endpoint->GetSink().PushBytes((void*)(outStr.data()), outStr.length(), numPushed);
-            if (status == ER_OK) {
-                QCC_DbgPrintf(("Sent %s", outStr.c_str()));
-            } else {
-                QCC_LogError(status, ("Failed to write to stream"));
-                goto ExitEstablish;
+            bool redirecting = (acceptState == ACCEPT_REDIRECT);
+            status = Event::Wait(endpoint->GetSource().GetSourceEvent(), redirecting ? REDIRECT_TIMEOUT : timeout);
+            if (redirecting && (status == ER_TIMEOUT)) {
+                /* The other end did not close the connection so the redirection failed */
+                status = ER_BUS_ESTABLISH_FAILED;
             }
         }
-        /*
-         * Wait for the hello message
-         */
-        QCC_DbgPrintf(("EndpointAuth::Establish(): WaitHello()"));
-        endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_HELLO);
-        status = WaitHello(authUsed);
-        endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_MSGS);
+        AbortAccept();
     } else {
         QCC_DbgPrintf(("EndpointAuth::Establish(): Not accepting"));
         SASLEngine sasl(bus, AuthMechanism::RESPONDER, authMechanisms, NULL, authListener, endpoint->GetFeatures().isBusToBus ? NULL : this);
@@ -532,4 +471,138 @@ ExitEstablish:
     return status;
 }
 
+QStatus EndpointAuth::BeginAccept(const qcc::String& authMechanisms, AuthListener* listener)
+{
+    QCC_DbgTrace(("EndpointAuth::BeginAccept(authMechanisms=\"%s\", listener=0x%p)", authMechanisms.c_str(), listener));
+
+    if (!isAccepting || (acceptState != ACCEPT_IDLE)) {
+        return ER_BUS_ESTABLISH_FAILED;
+    }
+    endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_CHARS);
+    if (listener) {
+        authListener.Set(listener);
+    }
+    sasl = new SASLEngine(bus, AuthMechanism::CHALLENGER, authMechanisms, NULL, authListener, this);
+    /*
+     * The server's GUID is sent to the client when the authentication succeeds
+     */
+    sasl->SetLocalId(bus.GetInternal().GetGlobalGUID().ToString());
+    saslLine.clear();
+    acceptState = ACCEPT_SASL;
+    return ER_OK;
+}
+
+QStatus EndpointAuth::ContinueAccept(qcc::String& authUsed, qcc::String& redirection)
+{
+    QCC_DbgTrace(("EndpointAuth::ContinueAccept()"));
+
+    QStatus status = ER_OK;
+    Source& source = endpoint->GetSource();
+
+    /*
+     * Reads are done with a zero timeout so every step below either consumes
+     * data that is already available or reports that it has to wait for more.
+     */
+    while (status == ER_OK) {
+        if (acceptState == ACCEPT_SASL) {
+            /*
+             * Get the challenge, a partial line is kept until the rest arrives
+             */
+            status = source.GetLine(saslLine, 0);
+            if (status != ER_OK) {
+                if ((status != ER_TIMEOUT) && (status != ER_ALERTED_THREAD)) {
+                    QCC_LogError(status, ("Failed to read from stream"));
+                }
+                break;
+            }
+            QCC_DbgPrintf(("EndpointAuth::ContinueAccept(): Got \"%s\" from stream", saslLine.c_str()));
+            SASLEngine::AuthState state;
+            qcc::String outStr;
+            status = sasl->Advance(saslLine, outStr, state);
+            saslLine.clear();
+            if (status != ER_OK) {
+                QCC_DbgPrintf(("Server authentication failed %s", QCC_StatusText(status)));
+                break;
+            }
+            if (state == SASLEngine::ALLJOYN_AUTH_SUCCESS) {
+                /*
+                 * Remember the authentication mechanism that was used
+                 */
+                authUsed = sasl->GetMechanism();
+                delete sasl;
+                sasl = NULL;
+                endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_HELLO);
+                acceptState = ACCEPT_HELLO;
+                continue;
+            }
+            /*
+             * Send the response
+             */
+            size_t numPushed;
+            QCC_DbgPrintf(("EndpointAuth::ContinueAccept(): Responding with \"%s\" to stream", outStr.c_str()));
+            status = endpoint->GetSink().PushBytes((void*)(outStr.data()), outStr.length(), numPushed);
+            if (status != ER_OK) {
+                QCC_LogError(status, ("Failed to write to stream"));
+            }
+        } else if (acceptState == ACCEPT_HELLO) {
+            status = hello->ReadNonBlocking(endpoint, false);
+            if (status != ER_OK) {
+                break;
+            }
+            status = HandleHello(authUsed, redirection);
+            endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_MSGS);
+            if ((status != ER_OK) || redirection.empty()) {
+                EndAccept();
+                return status;
+            }
+            acceptState = ACCEPT_REDIRECT;
+        } else if (acceptState == ACCEPT_REDIRECT) {
+            /*
+             * We expect the other end to shutdown the endpoint socket as soon as it receives the
+             * redirection error response. The only way we can tell if the socket is closed is by
+             * attempting to read from it. If we actually read data it means the socket wasn't
+             * closed by the other end so we assume the the redirection failed.
+             */
+            uint8_t buf[1];
+            size_t sz;
+            status = source.PullBytes(buf, sizeof(buf), sz, 0);
+            if (status == ER_OK) {
+                status = ER_BUS_ESTABLISH_FAILED;
+            } else if ((status != ER_TIMEOUT) && (status != ER_ALERTED_THREAD)) {
+                status = ER_BUS_ENDPOINT_REDIRECTED;
+            }
+            break;
+        } else {
+            status = ER_BUS_ESTABLISH_FAILED;
+        }
+    }
+    /*
+     * A timeout or an alert of the calling thread only means that there is
+     * nothing more to read at the moment.
+     */
+    if ((status == ER_TIMEOUT) || (status == ER_ALERTED_THREAD)) {
+        return ER_WOULDBLOCK;
+    }
+    EndAccept();
+    return status;
+}
+
+void EndpointAuth::AbortAccept()
+{
+    if (acceptState != ACCEPT_IDLE) {
+        QCC_DbgPrintf(("EndpointAuth::AbortAccept()"));
+        endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_MSGS);
+        EndAccept();
+    }
+}
+
+void EndpointAuth::EndAccept()
+{
+    delete sasl;
+    sasl = NULL;
+    saslLine.clear();
+    acceptState = ACCEPT_IDLE;
+    authListener.Set(NULL);
+}
+
 }
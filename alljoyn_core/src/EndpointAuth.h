@@ -60,13 +60,16 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
         uniqueName(bus.GetInternal().GetRouter().GenerateUniqueName()),
         isAccepting(isAcceptor),
         remoteProtocolVersion(0),
-        nameTransfer(SessionOpts::P2P_NAMES)
+        nameTransfer(SessionOpts::P2P_NAMES),
+        acceptState(ACCEPT_IDLE),
+        sasl(NULL),
+        hello(bus)
     { }
 
     /**
      * Destructor
      */
-    ~EndpointAuth() { };
+    ~EndpointAuth() { delete sasl; };
 
     /**
      * Establish a connection.
@@ -85,6 +88,41 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
      */
     QStatus Establish(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener = NULL, uint32_t timeout = qcc::Event::WAIT_FOREVER);
 
+    /**
+     * Start establishing an accepted connection without blocking. The
+     * handshake is then driven by calling ContinueAccept() each time the
+     * source of the endpoint has data available.
+     *
+     * @param authMechanisms  The authentication mechanisms to offer.
+     * @param listener        Authentication credentials listener.
+     *
+     * @return
+     *      - ER_OK if the handshake was started
+     *      - An error status otherwise
+     */
+    QStatus BeginAccept(const qcc::String& authMechanisms, AuthListener* listener = NULL);
+
+    /**
+     * Process the SASL commands and Hello message received so far without
+     * blocking on the endpoint's source.
+     *
+     * @param authUsed     Returns the name of the authentication method that was used to establish the connection.
+     * @param redirection  Returns a redirection address for the endpoint. This value is only meaninful if the
+     *                     return status is ER_BUS_ENDPOINT_REDIRECTED.
+     *
+     * @return
+     *      - ER_OK if the connection has been established
+     *      - ER_WOULDBLOCK if more data from the remote side is needed
+     *      - ER_BUS_ENDPOINT_REDIRECTED if the endpoint has been redirected
+     *      - An error status otherwise
+     */
+    QStatus ContinueAccept(qcc::String& authUsed, qcc::String& redirection);
+
+    /**
+     * Abandon a handshake started by BeginAccept().
+     */
+    void AbortAccept();
+
     /**
      * Get the unique bus name assigned by the bus for this endpoint.
      *
@@ -148,10 +186,26 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
     SessionOpts::NameTransferType nameTransfer;
     ProtectedAuthListener authListener;  ///< Authentication listener
 
+    /**
+     * The steps of establishing an accepted connection
+     */
+    enum AcceptState {
+        ACCEPT_IDLE,        ///< No handshake in progress
+        ACCEPT_SASL,        ///< Exchanging SASL commands
+        ACCEPT_HELLO,       ///< Receiving the Hello or BusHello message
+        ACCEPT_REDIRECT     ///< Waiting for the remote side to close a redirected connection
+    };
+
+    AcceptState acceptState;         ///< Progress of an accept handshake
+    SASLEngine* sasl;                ///< SASL engine of an accept handshake
+    qcc::String saslLine;            ///< SASL command received so far
+    Message hello;                   ///< Hello message received so far
+
     /* Internal methods */
 
     QStatus Hello(qcc::String& redirection);
-    QStatus WaitHello(qcc::String& authUsed);
+    QStatus HandleHello(qcc::String& authUsed, qcc::String& redirection);
+    void EndAccept();
 };
 
 }
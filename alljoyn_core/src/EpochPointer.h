@@ -0,0 +1,147 @@
+#ifndef _ALLJOYN_EPOCHPOINTER_H
+#define _ALLJOYN_EPOCHPOINTER_H
+/**
+ * @file
+ * This file defines a pointer that can be read without taking a lock.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include EpochPointer.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+#include <qcc/atomic.h>
+#include <qcc/Thread.h>
+
+namespace ajn {
+
+/**
+ * %EpochPointer publishes an immutable version of a read-mostly structure.
+ *
+ * Readers enter a short read-side section by bumping the reader count of the
+ * current epoch; this takes no lock and allocates nothing. A writer swaps in a
+ * new version, advances the epoch and then waits for the readers of the
+ * previous epoch to drain, after which nothing can still see the previous
+ * version and it is handed back to the writer to reclaim.
+ *
+ * Writers must be serialized by the owner of the %EpochPointer. Read-side
+ * sections must be short and must not call back into the writer since the
+ * writer waits for them.
+ */
+template <typename T>
+class EpochPointer {
+
+  public:
+
+    /**
+     * A read-side section. The version returned by Get() remains valid for
+     * the lifetime of the ReadGuard.
+     */
+    class ReadGuard {
+      public:
+        /**
+         * Enter a read-side section.
+         *
+         * @param ptr   The pointer to read.
+         */
+        ReadGuard(const EpochPointer& ptr) : ptr(ptr)
+        {
+            while (true) {
+                epoch = ptr.epoch;
+                qcc::IncrementAndFetch(&ptr.readers[epoch & 1]);
+                if (epoch == ptr.epoch) {
+                    break;
+                }
+                /* A writer advanced the epoch under us so retry in the new epoch */
+                qcc::DecrementAndFetch(&ptr.readers[epoch & 1]);
+            }
+        }
+
+        /**
+         * Leave the read-side section.
+         */
+        ~ReadGuard()
+        {
+            qcc::DecrementAndFetch(&ptr.readers[epoch & 1]);
+        }
+
+        /**
+         * Get the version that was current when the section was entered.
+         */
+        const T* Get() const { return ptr.versions[epoch & 1]; }
+
+      private:
+        ReadGuard(const ReadGuard& other);
+        ReadGuard& operator=(const ReadGuard& other);
+
+        const EpochPointer& ptr;
+        int32_t epoch;
+    };
+
+    /**
+     * Constructor
+     *
+     * @param initial   The initial version, ownership stays with the caller.
+     */
+    EpochPointer(T* initial) : epoch(0)
+    {
+        readers[0] = 0;
+        readers[1] = 0;
+        versions[0] = initial;
+        versions[1] = NULL;
+    }
+
+    /**
+     * Get the current version. Only the writer may call this.
+     */
+    T* Current() const { return versions[epoch & 1]; }
+
+    /**
+     * Publish a new version. Only one writer may call this at a time.
+     *
+     * @param next   The new version.
+     *
+     * @return  The previous version, which no reader can still see.
+     */
+    T* Exchange(T* next)
+    {
+        int32_t prev = epoch;
+        versions[(prev + 1) & 1] = next;
+        /* The atomic increment orders the store above before the new epoch */
+        qcc::IncrementAndFetch(&epoch);
+        while (readers[prev & 1] != 0) {
+            qcc::Sleep(1);
+        }
+        T* old = versions[prev & 1];
+        versions[prev & 1] = NULL;
+        return old;
+    }
+
+  private:
+    EpochPointer(const EpochPointer& other);
+    EpochPointer& operator=(const EpochPointer& other);
+
+    T* volatile versions[2];              /**< Current and next version indexed by epoch parity */
+    mutable volatile int32_t epoch;       /**< Current epoch */
+    mutable volatile int32_t readers[2];  /**< Read-side sections in progress per epoch parity */
+};
+
+}
+
+#endif
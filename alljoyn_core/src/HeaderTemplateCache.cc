@@ -0,0 +1,307 @@
+/**
+ * @file
+ * This file implements a cache of marshaled message header fields.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <string.h>
+
+#include <qcc/Debug.h>
+#include <qcc/Util.h>
+
+#include "HeaderTemplateCache.h"
+
+/** @internal */
+#define QCC_MODULE "ALLJOYN"
+
+using namespace std;
+using namespace qcc;
+
+namespace ajn {
+
+const size_t HeaderTemplateCache::MAX_TEMPLATES;
+
+/*
+ * Header fields that are the same every time a given method is called or
+ * signal is emitted.
+ */
+static bool IsTemplateField(uint32_t fieldId)
+{
+    switch (fieldId) {
+    case ALLJOYN_HDR_FIELD_PATH:
+    case ALLJOYN_HDR_FIELD_INTERFACE:
+    case ALLJOYN_HDR_FIELD_MEMBER:
+    case ALLJOYN_HDR_FIELD_DESTINATION:
+    case ALLJOYN_HDR_FIELD_SENDER:
+    case ALLJOYN_HDR_FIELD_SIGNATURE:
+    case ALLJOYN_HDR_FIELD_SESSION_ID:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/*
+ * Get the string value of a string valued header field
+ */
+static inline const char* FieldString(const MsgArg& field, uint32_t& len)
+{
+    if (field.typeId == ALLJOYN_SIGNATURE) {
+        len = field.v_signature.len;
+        return field.v_signature.sig;
+    } else {
+        len = field.v_string.len;
+        return field.v_string.str;
+    }
+}
+
+void HeaderTemplateCache::Template::Apply(HeaderFields& fields, uint8_t* buf) const
+{
+    if (!bytes.empty()) {
+        memcpy(buf, &bytes[0], bytes.size());
+    }
+    for (uint32_t fieldId = ALLJOYN_HDR_FIELD_PATH; fieldId < ArraySize(fields.field); fieldId++) {
+        MsgArg& field = fields.field[fieldId];
+        AllJoynTypeId id = types[fieldId];
+        switch (id) {
+        case ALLJOYN_SIGNATURE:
+            field.Clear();
+            field.typeId = id;
+            field.v_signature.sig = reinterpret_cast<char*>(buf + offsets[fieldId]);
+            field.v_signature.len = static_cast<uint8_t>(values[fieldId]);
+            break;
+
+        case ALLJOYN_OBJECT_PATH:
+        case ALLJOYN_STRING:
+            field.Clear();
+            field.typeId = id;
+            field.v_string.str = reinterpret_cast<char*>(buf + offsets[fieldId]);
+            field.v_string.len = values[fieldId];
+            break;
+
+        case ALLJOYN_UINT32:
+            field.Clear();
+            field.typeId = id;
+            field.v_uint32 = values[fieldId];
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+bool HeaderTemplateCache::Template::FieldEquals(uint32_t fieldId, const char* str, size_t len) const
+{
+    switch (types[fieldId]) {
+    case ALLJOYN_INVALID:
+        return len == 0;
+
+    case ALLJOYN_SIGNATURE:
+    case ALLJOYN_OBJECT_PATH:
+    case ALLJOYN_STRING:
+        return (len == values[fieldId]) && (memcmp(str, &bytes[offsets[fieldId]], len) == 0);
+
+    default:
+        return false;
+    }
+}
+
+bool HeaderTemplateCache::Template::Matches(const HeaderFields& fields, const qcc::String& destination, uint32_t sessionId,
+                                            const qcc::String& sender, bool endianSwap) const
+{
+    if (endianSwap != this->endianSwap) {
+        return false;
+    }
+    if (sessionId == 0) {
+        if (types[ALLJOYN_HDR_FIELD_SESSION_ID] != ALLJOYN_INVALID) {
+            return false;
+        }
+    } else if ((types[ALLJOYN_HDR_FIELD_SESSION_ID] != ALLJOYN_UINT32) || (values[ALLJOYN_HDR_FIELD_SESSION_ID] != sessionId)) {
+        return false;
+    }
+    static const uint32_t nameFields[] = { ALLJOYN_HDR_FIELD_PATH, ALLJOYN_HDR_FIELD_INTERFACE, ALLJOYN_HDR_FIELD_MEMBER };
+    for (size_t i = 0; i < ArraySize(nameFields); i++) {
+        const MsgArg& field = fields.field[nameFields[i]];
+        uint32_t len = 0;
+        const char* str = (field.typeId == ALLJOYN_INVALID) ? NULL : FieldString(field, len);
+        if (!FieldEquals(nameFields[i], str, len)) {
+            return false;
+        }
+    }
+    return FieldEquals(ALLJOYN_HDR_FIELD_DESTINATION, destination.c_str(), destination.size()) &&
+           FieldEquals(ALLJOYN_HDR_FIELD_SENDER, sender.c_str(), sender.size());
+}
+
+HeaderTemplateCache::~HeaderTemplateCache()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    for (UseList::iterator it = used.begin(); it != used.end(); ++it) {
+        it->second->Release();
+    }
+    used.clear();
+    templates.clear();
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+bool HeaderTemplateCache::IsCacheable(const HeaderFields& fields)
+{
+    for (uint32_t fieldId = ALLJOYN_HDR_FIELD_PATH; fieldId < ArraySize(fields.field); fieldId++) {
+        const MsgArg& field = fields.field[fieldId];
+        if (field.typeId == ALLJOYN_INVALID) {
+            continue;
+        }
+        if (!IsTemplateField(fieldId)) {
+            return false;
+        }
+        switch (field.typeId) {
+        case ALLJOYN_SIGNATURE:
+            if (field.v_signature.sig == NULL) {
+                return false;
+            }
+            break;
+
+        case ALLJOYN_OBJECT_PATH:
+        case ALLJOYN_STRING:
+            if (field.v_string.str == NULL) {
+                return false;
+            }
+            break;
+
+        case ALLJOYN_UINT32:
+            break;
+
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+const HeaderTemplateCache::Template* HeaderTemplateCache::Acquire(const void* key, const HeaderFields& fields, const qcc::String& destination,
+                                                                  uint32_t sessionId, const qcc::String& sender, bool endianSwap)
+{
+    const Template* found = NULL;
+    lock.Lock(MUTEX_CONTEXT);
+    pair<multimap<const void*, UseList::iterator>::iterator, multimap<const void*, UseList::iterator>::iterator> range = templates.equal_range(key);
+    for (multimap<const void*, UseList::iterator>::iterator it = range.first; it != range.second; ++it) {
+        if (it->second->second->Matches(fields, destination, sessionId, sender, endianSwap)) {
+            found = it->second->second;
+            IncrementAndFetch(&found->refCount);
+            used.splice(used.begin(), used, it->second);
+            break;
+        }
+    }
+    if (found) {
+        ++hits;
+    } else {
+        ++misses;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void HeaderTemplateCache::Add(const void* key, const HeaderFields& fields, bool endianSwap, const uint8_t* buf, size_t paddedLen, uint32_t headerLen)
+{
+    Template* tmpl = new Template();
+    tmpl->bytes.assign(buf, buf + paddedLen);
+    tmpl->headerLen = headerLen;
+    tmpl->endianSwap = endianSwap;
+    for (uint32_t fieldId = ALLJOYN_HDR_FIELD_PATH; fieldId < ArraySize(fields.field); fieldId++) {
+        const MsgArg& field = fields.field[fieldId];
+        tmpl->types[fieldId] = field.typeId;
+        tmpl->offsets[fieldId] = 0;
+        tmpl->values[fieldId] = 0;
+        switch (field.typeId) {
+        case ALLJOYN_SIGNATURE:
+        case ALLJOYN_OBJECT_PATH:
+        case ALLJOYN_STRING:
+            {
+                uint32_t len;
+                const char* str = FieldString(field, len);
+                const uint8_t* pos = reinterpret_cast<const uint8_t*>(str);
+                if ((pos < buf) || ((pos + len) > (buf + paddedLen))) {
+                    /* The fields were not marshaled into this buffer */
+                    QCC_ASSERT(!"Header fields do not point into the marshaled buffer");
+                    delete tmpl;
+                    return;
+                }
+                tmpl->offsets[fieldId] = static_cast<uint32_t>(pos - buf);
+                tmpl->values[fieldId] = len;
+            }
+            break;
+
+        case ALLJOYN_UINT32:
+            tmpl->values[fieldId] = field.v_uint32;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    lock.Lock(MUTEX_CONTEXT);
+    /*
+     * Replace any template for the same path, destination and session id.
+     * Another thread may have just built it, or it no longer matches the
+     * names of the member or the sender.
+     */
+    pair<multimap<const void*, UseList::iterator>::iterator, multimap<const void*, UseList::iterator>::iterator> range = templates.equal_range(key);
+    for (multimap<const void*, UseList::iterator>::iterator it = range.first; it != range.second; ++it) {
+        const Template* old = it->second->second;
+        if ((old->endianSwap == endianSwap) &&
+            (old->types[ALLJOYN_HDR_FIELD_SESSION_ID] == tmpl->types[ALLJOYN_HDR_FIELD_SESSION_ID]) &&
+            (old->values[ALLJOYN_HDR_FIELD_SESSION_ID] == tmpl->values[ALLJOYN_HDR_FIELD_SESSION_ID]) &&
+            old->FieldEquals(ALLJOYN_HDR_FIELD_PATH, reinterpret_cast<const char*>(buf + tmpl->offsets[ALLJOYN_HDR_FIELD_PATH]), tmpl->values[ALLJOYN_HDR_FIELD_PATH]) &&
+            old->FieldEquals(ALLJOYN_HDR_FIELD_DESTINATION, reinterpret_cast<const char*>(buf + tmpl->offsets[ALLJOYN_HDR_FIELD_DESTINATION]), tmpl->values[ALLJOYN_HDR_FIELD_DESTINATION])) {
+            old->Release();
+            used.erase(it->second);
+            templates.erase(it);
+            break;
+        }
+    }
+    if (used.size() >= MAX_TEMPLATES) {
+        /* Replace the least recently used template */
+        const void* oldKey = used.back().first;
+        range = templates.equal_range(oldKey);
+        for (multimap<const void*, UseList::iterator>::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == --used.end()) {
+                templates.erase(it);
+                break;
+            }
+        }
+        used.back().second->Release();
+        used.pop_back();
+    }
+    used.push_front(pair<const void*, Template*>(key, tmpl));
+    templates.insert(pair<const void*, UseList::iterator>(key, used.begin()));
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void HeaderTemplateCache::GetStats(uint32_t& hits, uint32_t& misses)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    hits = this->hits;
+    misses = this->misses;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+}
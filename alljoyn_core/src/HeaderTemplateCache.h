@@ -0,0 +1,202 @@
+#ifndef _ALLJOYN_HEADERTEMPLATECACHE_H
+#define _ALLJOYN_HEADERTEMPLATECACHE_H
+/**
+ * @file
+ * This file defines a cache of marshaled message header fields.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include HeaderTemplateCache.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+#include <qcc/Mutex.h>
+#include <qcc/String.h>
+#include <qcc/atomic.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <alljoyn/Message.h>
+
+namespace ajn {
+
+/**
+ * %HeaderTemplateCache holds the marshaled header fields of recently sent
+ * method calls and signals.
+ *
+ * Templates are looked up by the member being called or emitted, object
+ * path, destination and session id, which MarshalMessage() has before it
+ * builds any of the header fields, so a hit skips computing the header
+ * length and marshaling the fields altogether. The serial number and body
+ * length live in the fixed part of the header, and the signature is fixed
+ * by the member, so a template can be copied into a new message unchanged.
+ *
+ * The member is identified by an opaque key, normally the address of its
+ * InterfaceDescription::Member. Because an interface that was never
+ * activated can be deleted and its address reused, a hit also checks the
+ * interface and member names and the signature against the template.
+ */
+class HeaderTemplateCache {
+
+  public:
+
+    /**
+     * A marshaled copy of the header fields.
+     */
+    class Template {
+      public:
+        /**
+         * Length of the header fields as recorded in the message header.
+         */
+        uint32_t GetHeaderLen() const { return headerLen; }
+
+        /**
+         * Length of the header fields padded to an 8 byte boundary.
+         */
+        size_t GetPaddedLen() const { return bytes.size(); }
+
+        /**
+         * Check the signature computed from the message arguments against
+         * the signature in the template.
+         *
+         * @param signature   The signature of the message body.
+         * @param len         Length of the signature.
+         *
+         * @return  true if the template carries this signature.
+         */
+        bool HasSignature(const char* signature, size_t len) const { return FieldEquals(ALLJOYN_HDR_FIELD_SIGNATURE, signature, len); }
+
+        /**
+         * Copy the header fields into a message buffer and point the header
+         * fields at the copy, as marshaling them would have done.
+         *
+         * @param fields   Header fields to set from this template.
+         * @param buf      Where the header fields start in the message buffer.
+         */
+        void Apply(HeaderFields& fields, uint8_t* buf) const;
+
+        /**
+         * Release the reference returned by HeaderTemplateCache::Acquire().
+         */
+        void Release() const
+        {
+            if (qcc::DecrementAndFetch(&refCount) == 0) {
+                delete this;
+            }
+        }
+
+      private:
+        friend class HeaderTemplateCache;
+
+        Template() : headerLen(0), endianSwap(false), refCount(1) { }
+
+        bool FieldEquals(uint32_t fieldId, const char* str, size_t len) const;
+
+        bool Matches(const HeaderFields& fields, const qcc::String& destination, uint32_t sessionId,
+                     const qcc::String& sender, bool endianSwap) const;
+
+        std::vector<uint8_t> bytes;                       /**< The marshaled header fields */
+        uint32_t headerLen;                               /**< Unpadded length of the header fields */
+        bool endianSwap;                                  /**< True if marshaled in non-native endianess */
+        uint32_t offsets[ALLJOYN_HDR_FIELD_UNKNOWN];      /**< Offset of each string valued field in bytes */
+        uint32_t values[ALLJOYN_HDR_FIELD_UNKNOWN];       /**< Length of string valued fields or value of integer fields */
+        AllJoynTypeId types[ALLJOYN_HDR_FIELD_UNKNOWN];   /**< Type of each field, ALLJOYN_INVALID if absent */
+        mutable volatile int32_t refCount;                /**< The cache's and callers' references */
+    };
+
+    /**
+     * Maximum number of templates kept. When full the least recently used
+     * template is replaced.
+     */
+    static const size_t MAX_TEMPLATES = 128;
+
+    /**
+     * Constructor
+     */
+    HeaderTemplateCache() : hits(0), misses(0) { }
+
+    /**
+     * Destructor
+     */
+    ~HeaderTemplateCache();
+
+    /**
+     * Check if a set of header fields can be served from a template. Fields
+     * that change with every message, such as timestamps and reply serials,
+     * rule out a template.
+     *
+     * @param fields   The header fields.
+     *
+     * @return  true if the header fields can be templated.
+     */
+    static bool IsCacheable(const HeaderFields& fields);
+
+    /**
+     * Look up a template.
+     *
+     * @param key          Identifies the member being called or emitted.
+     * @param fields       The header fields with only the path, interface and member set.
+     * @param destination  Destination of the message.
+     * @param sessionId    Session id of the message.
+     * @param sender       Sender of the message.
+     * @param endianSwap   True if the message is marshaled in non-native endianess.
+     *
+     * @return  A referenced template that must be released by the caller or
+     *          NULL if there is no matching template.
+     */
+    const Template* Acquire(const void* key, const HeaderFields& fields, const qcc::String& destination,
+                            uint32_t sessionId, const qcc::String& sender, bool endianSwap);
+
+    /**
+     * Add a template for a set of header fields that have just been
+     * marshaled.
+     *
+     * @param key          Identifies the member being called or emitted.
+     * @param fields       The header fields, pointing into the marshaled buffer.
+     * @param endianSwap   True if the message was marshaled in non-native endianess.
+     * @param buf          Where the header fields start in the message buffer.
+     * @param paddedLen    Length of the marshaled header fields including padding.
+     * @param headerLen    Length of the header fields as recorded in the message header.
+     */
+    void Add(const void* key, const HeaderFields& fields, bool endianSwap, const uint8_t* buf, size_t paddedLen, uint32_t headerLen);
+
+    /**
+     * Get the number of lookups that found a template and that did not.
+     *
+     * @param[out] hits     Lookups that found a template.
+     * @param[out] misses   Lookups that did not.
+     */
+    void GetStats(uint32_t& hits, uint32_t& misses);
+
+  private:
+
+    typedef std::list<std::pair<const void*, Template*> > UseList;
+
+    qcc::Mutex lock;                                        /**< Lock protecting the templates */
+    UseList used;                                           /**< Templates with the most recently used first */
+    std::multimap<const void*, UseList::iterator> templates; /**< Templates by the member they were built for */
+    uint32_t hits;                                          /**< Lookups that found a template */
+    uint32_t misses;                                        /**< Lookups that did not */
+};
+
+}
+
+#endif
@@ -74,6 +74,47 @@ static const uint16_t CompositeKeyKeyStoreVersion = 0x0104;
  */
 static const uint16_t KeyStoreVersion = 0x0104;
 
+/*
+ * A key store log starts with a header holding the magic number, version,
+ * key store GUID and the generation of the log, followed by records each
+ * consisting of the length of the encrypted data, a sequence number and the
+ * encrypted data. The generation and sequence number form the nonce.
+ */
+static const uint8_t KeyStoreLogMagic[4] = { 'A', 'J', 'K', 'L' };
+
+static const uint16_t KeyStoreLogVersion = 0x0001;
+
+static const size_t KeyStoreLogHeaderLen = sizeof(KeyStoreLogMagic) + 2 * sizeof(uint16_t) + qcc::GUID128::SIZE + sizeof(uint64_t);
+
+static const size_t KeyStoreLogRecordHeaderLen = 2 * sizeof(uint32_t);
+
+static const uint8_t KeyStoreLogAuthLen = 16;
+
+/*
+ * Kinds of key store log records
+ */
+static const uint8_t LOG_RECORD_PUT = 1;    /* Key added or changed */
+static const uint8_t LOG_RECORD_DELETE = 2; /* Key deleted */
+static const uint8_t LOG_RECORD_CLEAR = 3;  /* All keys deleted */
+
+/*
+ * Sanity check on the length of a log record
+ */
+static const uint32_t MaxLogRecordLen = 64000;
+
+/*
+ * A log is not worth compacting until it has this many records
+ */
+static const size_t MinLogRecordsToCompact = 1024;
+
+static KeyBlob LogNonce(uint64_t generation, uint32_t seq)
+{
+    uint8_t nonce[sizeof(generation) + sizeof(seq)];
+    memcpy(nonce, &generation, sizeof(generation));
+    memcpy(nonce + sizeof(generation), &seq, sizeof(seq));
+    return KeyBlob(nonce, sizeof(nonce), KeyBlob::GENERIC);
+}
+
 QStatus KeyStoreListener::PutKeys(KeyStore& keyStore, const qcc::String& source, const qcc::String& password)
 {
     StringSource stringSource(source);
@@ -94,6 +135,11 @@ KeyStore::KeyStore(const qcc::String& application) :
     application(application),
     storeState(UNAVAILABLE),
     keys(new KeyMap),
+    logged(false),
+    logCleared(false),
+    logGeneration(0),
+    logSeq(0),
+    logRecords(0),
     defaultListener(NULL),
     listener(NULL),
     thisGuid(),
@@ -254,8 +300,11 @@ QStatus KeyStore::Store()
     }
     EraseExpiredKeys();
 
-    /* Reload to merge keystore changes before storing */
-    if (revision > 0) {
+    /*
+     * Reload to merge keystore changes before storing. Changes to a log are
+     * merged by the listener as it appends to the log.
+     */
+    if ((revision > 0) && !logged) {
         lock.Unlock(MUTEX_CONTEXT);
         status = Reload();
         lock.Lock(MUTEX_CONTEXT);
@@ -283,12 +332,14 @@ QStatus KeyStore::Store()
     return status;
 }
 
-QStatus KeyStore::Load()
+QStatus KeyStore::Load(bool incremental)
 {
     QStatus status;
     lock.Lock(MUTEX_CONTEXT);
-    keys->clear();
-    storeState = UNAVAILABLE;
+    if (!incremental) {
+        ClearKeyRecords();
+        storeState = UNAVAILABLE;
+    }
     if (loadedRefCount == 0) {
         loaded = new Event();
     }
@@ -312,28 +363,20 @@ QStatus KeyStore::Load()
 size_t KeyStore::EraseExpiredKeys()
 {
     size_t count = 0;
-    bool dirty = true;
-    while (dirty) {
-        dirty = false;
-        KeyMap::iterator it = keys->begin();
-        while (it != keys->end()) {
-            KeyMap::iterator current = it++;
-            if (current->second.keyBlob.HasExpired()) {
-                QCC_DbgPrintf(("Deleting expired key for GUID %s", current->first.ToString().c_str()));
-                bool affected = false;
-                if (keyEventListener) {
-                    affected = keyEventListener->NotifyAutoDelete(this, current->first);
-                }
-                keys->erase(current);
-                ++count;
-                dirty = true;
-                if (affected) {
-                    break;  /* need to refresh the iterator because the list members may have changed by the NotifyAutoDelete call */
-                }
-            }
+    Timespec<EpochTime> now(GetEpochTimestamp());
+    /*
+     * Always start from the earliest expiration because the index may have been changed by the
+     * NotifyAutoDelete call
+     */
+    while (!expirations.empty() && (expirations.begin()->first <= now)) {
+        Key key = expirations.begin()->second;
+        QCC_DbgPrintf(("Deleting expired key for GUID %s", key.ToString().c_str()));
+        if (keyEventListener) {
+            keyEventListener->NotifyAutoDelete(this, key);
         }
-    } /* clean sweep */
-
+        EraseKeyRecord(key);
+        ++count;
+    }
     return count;
 }
 
@@ -354,6 +397,9 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
     size_t len = 0;
     uint16_t version;
 
+    logged = false;
+    modifications.clear();
+
     /* Pull and check the key store version */
     QStatus status = source.PullBytes(&version, sizeof(version), pulled);
     if ((status == ER_OK) && ((version > KeyStoreVersion) || (version < LowStoreVersion))) {
@@ -380,7 +426,7 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
 
     /* Allow for an uninitialized (empty) key store */
     if (status == ER_EOF) {
-        keys->clear();
+        ClearKeyRecords();
         storeState = MODIFIED;
         revision = 0;
         MarkGuidSet();  /* make thisGuid the keystore guid */
@@ -460,7 +506,7 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
                     qcc::GUID128 guid(0);
                     guid.SetBytes(guidBuf);
                     Key key(keyType, guid);
-                    KeyRecord& keyRec = (*keys)[key];
+                    KeyRecord keyRec;
                     keyRec.revision = rev;
                     status = keyRec.keyBlob.Load(strSource);
                     if (status == ER_OK) {
@@ -475,6 +521,9 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
                             }
                         }
                     }
+                    if (status == ER_OK) {
+                        PutKeyRecord(key, keyRec);
+                    }
                     QCC_DbgPrintf(("KeyStore::Pull rev:%d GUID %s %s", rev, QCC_StatusText(status), guid.ToString().c_str()));
                 }
             }
@@ -496,7 +545,7 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
 ExitPull:
 
     if (status != ER_OK) {
-        keys->clear();
+        ClearKeyRecords();
         storeState = MODIFIED;
     }
     if (loaded) {
@@ -513,10 +562,12 @@ QStatus KeyStore::Clear()
         lock.Unlock(MUTEX_CONTEXT);
         return ER_BUS_KEYSTORE_NOT_LOADED;
     }
-    keys->clear();
+    ClearKeyRecords();
     storeState = MODIFIED;
     revision = 0;
     deletions.clear();
+    modifications.clear();
+    logCleared = true;
     lock.Unlock(MUTEX_CONTEXT);
     listener->StoreRequest(*this);
     return ER_OK;
@@ -581,11 +632,20 @@ QStatus KeyStore::Reload()
         lock.Unlock(MUTEX_CONTEXT);
         return ER_OK;
     }
+    /*
+     * A log only needs to be read from where it was last read and the
+     * changes that have not been stored are kept while doing so.
+     */
+    if (logged) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return Load(true);
+    }
 
     QStatus status;
     uint32_t currentRevision = revision;
     KeyMap* currentKeys = keys;
     keys = new KeyMap();
+    RebuildIndexes();
 
     /*
      * Load the keys so we can check for changes and merge if needed
@@ -608,7 +668,7 @@ QStatus KeyStore::Reload()
             it = keys->find(*itDel);
             if ((it != keys->end()) && (it->second.revision <= currentRevision)) {
                 QCC_DbgPrintf(("KeyStore::Reload deleting %s", itDel->ToString().c_str()));
-                keys->erase(*itDel);
+                EraseKeyRecord(it);
             }
         }
         /*
@@ -617,13 +677,14 @@ QStatus KeyStore::Reload()
         for (it = currentKeys->begin(); it != currentKeys->end(); ++it) {
             if (it->second.revision > currentRevision) {
                 QCC_DbgPrintf(("KeyStore::Reload added rev:%d %s", it->second.revision, it->first.ToString().c_str()));
-                if ((*keys)[it->first].revision > currentRevision) {
+                KeyMap::iterator stored = keys->find(it->first);
+                if ((stored != keys->end()) && (stored->second.revision > currentRevision)) {
                     /*
                      * In case of a merge conflict go with the key that is currently stored
                      */
                     QCC_DbgPrintf(("KeyStore::Reload merge conflict rev:%d %s", it->second.revision, it->first.ToString().c_str()));
                 } else {
-                    (*keys)[it->first] = it->second;
+                    PutKeyRecord(it->first, it->second);
                     QCC_DbgPrintf(("KeyStore::Reload merging %s", it->first.ToString().c_str()));
                 }
             }
@@ -637,6 +698,7 @@ QStatus KeyStore::Reload()
         KeyMap* goner = keys;
         keys = currentKeys;
         delete goner;
+        RebuildIndexes();
         revision = currentRevision;
     }
 
@@ -719,6 +781,8 @@ QStatus KeyStore::Push(Sink& sink)
         goto ExitPush;
     }
     storeState = LOADED;
+    modifications.clear();
+    logCleared = false;
 
 ExitPush:
 
@@ -729,6 +793,309 @@ ExitPush:
     return status;
 }
 
+bool KeyStore::IsLog(const uint8_t* data, size_t len)
+{
+    return (len >= sizeof(KeyStoreLogMagic)) && (memcmp(data, KeyStoreLogMagic, sizeof(KeyStoreLogMagic)) == 0);
+}
+
+QStatus KeyStore::PullLog(const uint8_t* log, size_t len, size_t& offset, const qcc::String& password)
+{
+    QStatus status = ER_OK;
+    size_t pulled;
+
+    lock.Lock(MUTEX_CONTEXT);
+    bool initial = (storeState == UNAVAILABLE);
+    if (initial) {
+        offset = 0;
+    }
+    QCC_DbgPrintf(("KeyStore::PullLog %s from %u of %u", initial ? "load" : "reload", (unsigned int)offset, (unsigned int)len));
+
+    if (offset == 0) {
+        if (len == 0) {
+            /* Allow for an uninitialized (empty) key store */
+            if (initial) {
+                if (!keyStoreKey) {
+                    keyStoreKey = new KeyStoreEncryptionKey();
+                }
+                keyStoreKey->Build(password, thisGuid.ToString());
+                ClearKeyRecords();
+                revision = 0;
+                storeState = MODIFIED;
+                MarkGuidSet();  /* make thisGuid the keystore guid */
+            }
+            logRecords = 0;
+            goto ExitPullLog;
+        }
+        if ((len < KeyStoreLogHeaderLen) || !IsLog(log, len)) {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+            goto ExitPullLog;
+        }
+        uint16_t version;
+        memcpy(&version, log + sizeof(KeyStoreLogMagic), sizeof(version));
+        if (version != KeyStoreLogVersion) {
+            status = ER_BUS_KEYSTORE_VERSION_MISMATCH;
+            QCC_LogError(status, ("Keystore log has wrong version expected %d got %d", KeyStoreLogVersion, version));
+            goto ExitPullLog;
+        }
+        qcc::GUID128 guid(0);
+        guid.SetBytes(log + sizeof(KeyStoreLogMagic) + 2 * sizeof(uint16_t));
+        memcpy(&logGeneration, log + KeyStoreLogHeaderLen - sizeof(logGeneration), sizeof(logGeneration));
+        if (initial) {
+            thisGuid = guid;
+            MarkGuidSet();
+            if (!keyStoreKey) {
+                keyStoreKey = new KeyStoreEncryptionKey();
+            }
+            keyStoreKey->Build(password, thisGuid.ToString());
+            ClearKeyRecords();
+        } else {
+            if (!(guid == thisGuid)) {
+                status = ER_BUS_CORRUPT_KEYSTORE;
+                goto ExitPullLog;
+            }
+            /*
+             * The log was rewritten, start over keeping only the changes that
+             * have not been stored yet.
+             */
+            KeyMap::iterator it = keys->begin();
+            while (it != keys->end()) {
+                if (modifications.count(it->first) == 0) {
+                    EraseKeyRecord(it++);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        logSeq = 0;
+        logRecords = 0;
+        offset = KeyStoreLogHeaderLen;
+    }
+
+    while ((len - offset) >= KeyStoreLogRecordHeaderLen) {
+        uint32_t recLen;
+        uint32_t seq;
+        memcpy(&recLen, log + offset, sizeof(recLen));
+        memcpy(&seq, log + offset + sizeof(recLen), sizeof(seq));
+        if ((recLen > MaxLogRecordLen) || (recLen < KeyStoreLogAuthLen)) {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+            break;
+        }
+        if (recLen > (len - offset - KeyStoreLogRecordHeaderLen)) {
+            /* The last record was cut short by the end of the file */
+            break;
+        }
+        uint8_t* data = new uint8_t[recLen];
+        size_t dataLen = recLen;
+        Crypto_AES aes(*keyStoreKey, Crypto_AES::CCM);
+        status = aes.Decrypt_CCM(log + offset + KeyStoreLogRecordHeaderLen, data, dataLen, LogNonce(logGeneration, seq),
+                                 log + offset, KeyStoreLogRecordHeaderLen, KeyStoreLogAuthLen);
+        if (status != ER_OK) {
+            /* A complete record that does not authenticate is not a partial write */
+            delete [] data;
+            status = ER_BUS_CORRUPT_KEYSTORE;
+            break;
+        }
+        StringSource strSource(data, dataLen);
+        uint8_t kind = 0;
+        Key::KeyType keyType = Key::REMOTE;
+        uint8_t guidBuf[qcc::GUID128::SIZE];
+        KeyRecord keyRec;
+        status = strSource.PullBytes(&kind, sizeof(kind), pulled);
+        if ((status == ER_OK) && (kind != LOG_RECORD_CLEAR)) {
+            status = strSource.PullBytes(&keyType, sizeof(keyType), pulled);
+            if (status == ER_OK) {
+                status = strSource.PullBytes(guidBuf, qcc::GUID128::SIZE, pulled);
+            }
+        }
+        if ((status == ER_OK) && (kind == LOG_RECORD_PUT)) {
+            status = strSource.PullBytes(&keyRec.revision, sizeof(keyRec.revision), pulled);
+            if (status == ER_OK) {
+                status = keyRec.keyBlob.Load(strSource);
+            }
+            if (status == ER_OK) {
+                status = strSource.PullBytes(&keyRec.accessRights, sizeof(keyRec.accessRights), pulled);
+            }
+        }
+        delete [] data;
+        if (status != ER_OK) {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+            break;
+        }
+        qcc::GUID128 guid(0);
+        guid.SetBytes(guidBuf);
+        Key key(keyType, guid);
+        /* Changes that have not been stored yet supersede the log */
+        switch (kind) {
+        case LOG_RECORD_PUT:
+            if (!modifications.count(key) && !deletions.count(key)) {
+                PutKeyRecord(key, keyRec);
+            }
+            break;
+
+        case LOG_RECORD_DELETE:
+            if (!modifications.count(key)) {
+                EraseKeyRecord(key);
+            }
+            break;
+
+        case LOG_RECORD_CLEAR:
+            if (initial) {
+                ClearKeyRecords();
+            } else {
+                KeyMap::iterator it = keys->begin();
+                while (it != keys->end()) {
+                    if (modifications.count(it->first) == 0) {
+                        EraseKeyRecord(it++);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            break;
+
+        default:
+            status = ER_BUS_CORRUPT_KEYSTORE;
+            break;
+        }
+        if (status != ER_OK) {
+            break;
+        }
+        QCC_DbgPrintf(("KeyStore::PullLog seq:%u kind:%u %s", seq, kind, key.ToString().c_str()));
+        logSeq = seq;
+        ++logRecords;
+        offset += KeyStoreLogRecordHeaderLen + recLen;
+    }
+    if (status != ER_OK) {
+        goto ExitPullLog;
+    }
+    logged = true;
+    if (EraseExpiredKeys() || (storeState == MODIFIED)) {
+        storeState = MODIFIED;
+    } else {
+        storeState = LOADED;
+    }
+
+ExitPullLog:
+
+    if ((status != ER_OK) && initial) {
+        /* Start a new log when the key store is next stored */
+        QCC_LogError(status, ("Failed to load key store log"));
+        ClearKeyRecords();
+        storeState = MODIFIED;
+        logged = true;
+        offset = 0;
+    }
+    if (loaded) {
+        loaded->SetEvent();
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
+QStatus KeyStore::PushLogRecord(Sink& sink, uint8_t kind, const Key& key, const KeyRecord* keyRec)
+{
+    size_t pushed;
+    StringSink strSink;
+    strSink.PushBytes(&kind, sizeof(kind), pushed);
+    if (kind != LOG_RECORD_CLEAR) {
+        Key::KeyType keyType = key.GetType();
+        strSink.PushBytes(&keyType, sizeof(keyType), pushed);
+        strSink.PushBytes(key.GetGUID().GetBytes(), qcc::GUID128::SIZE, pushed);
+    }
+    if (keyRec) {
+        strSink.PushBytes(&keyRec->revision, sizeof(keyRec->revision), pushed);
+        keyRec->keyBlob.Store(strSink);
+        strSink.PushBytes(&keyRec->accessRights, sizeof(keyRec->accessRights), pushed);
+    }
+    size_t len = strSink.GetString().size();
+    uint8_t* record = new uint8_t[KeyStoreLogRecordHeaderLen + len + KeyStoreLogAuthLen];
+    uint32_t recLen = len + KeyStoreLogAuthLen;
+    uint32_t seq = ++logSeq;
+    memcpy(record, &recLen, sizeof(recLen));
+    memcpy(record + sizeof(recLen), &seq, sizeof(seq));
+    Crypto_AES aes(*keyStoreKey, Crypto_AES::CCM);
+    QStatus status = aes.Encrypt_CCM(strSink.GetString().data(), record + KeyStoreLogRecordHeaderLen, len, LogNonce(logGeneration, seq),
+                                     record, KeyStoreLogRecordHeaderLen, KeyStoreLogAuthLen);
+    if (status == ER_OK) {
+        status = sink.PushBytes(record, KeyStoreLogRecordHeaderLen + len, pushed);
+    }
+    delete [] record;
+    if (status == ER_OK) {
+        ++logRecords;
+    }
+    return status;
+}
+
+QStatus KeyStore::PushLog(Sink& sink, bool compact)
+{
+    size_t pushed;
+    QStatus status = ER_OK;
+
+    lock.Lock(MUTEX_CONTEXT);
+    QCC_DbgHLPrintf(("KeyStore::PushLog %s", compact ? "compact" : "append"));
+    if (storeState == UNAVAILABLE) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return ER_BUS_KEYSTORE_NOT_LOADED;
+    }
+    if (compact) {
+        const uint16_t reserved = 0;
+        logGeneration = qcc::Rand64();
+        logSeq = 0;
+        logRecords = 0;
+        status = sink.PushBytes(KeyStoreLogMagic, sizeof(KeyStoreLogMagic), pushed);
+        if (status == ER_OK) {
+            status = sink.PushBytes(&KeyStoreLogVersion, sizeof(KeyStoreLogVersion), pushed);
+        }
+        if (status == ER_OK) {
+            status = sink.PushBytes(&reserved, sizeof(reserved), pushed);
+        }
+        if (status == ER_OK) {
+            status = sink.PushBytes(thisGuid.GetBytes(), qcc::GUID128::SIZE, pushed);
+            MarkGuidSet(); /* now thisGuid is active */
+        }
+        if (status == ER_OK) {
+            status = sink.PushBytes(&logGeneration, sizeof(logGeneration), pushed);
+        }
+        for (KeyMap::iterator it = keys->begin(); (status == ER_OK) && (it != keys->end()); ++it) {
+            status = PushLogRecord(sink, LOG_RECORD_PUT, it->first, &it->second);
+        }
+    } else {
+        if (logCleared) {
+            status = PushLogRecord(sink, LOG_RECORD_CLEAR, Key(), NULL);
+        }
+        for (std::set<Key>::iterator it = deletions.begin(); (status == ER_OK) && (it != deletions.end()); ++it) {
+            status = PushLogRecord(sink, LOG_RECORD_DELETE, *it, NULL);
+        }
+        for (std::set<Key>::iterator it = modifications.begin(); (status == ER_OK) && (it != modifications.end()); ++it) {
+            KeyMap::iterator keyIt = keys->find(*it);
+            if (keyIt != keys->end()) {
+                status = PushLogRecord(sink, LOG_RECORD_PUT, keyIt->first, &keyIt->second);
+            }
+        }
+    }
+    if (status == ER_OK) {
+        ++revision;
+        storeState = LOADED;
+        logged = true;
+        logCleared = false;
+        deletions.clear();
+        modifications.clear();
+    }
+    if (stored) {
+        stored->SetEvent();
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
+bool KeyStore::LogNeedsCompaction()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    bool compact = (logRecords >= MinLogRecordsToCompact) && (logRecords > (2 * keys->size()));
+    lock.Unlock(MUTEX_CONTEXT);
+    return compact;
+}
+
 QStatus KeyStore::GetKey(const Key& key, KeyBlob& keyBlob, uint8_t accessRights[4])
 {
     lock.Lock(MUTEX_CONTEXT);
@@ -771,17 +1138,97 @@ QStatus KeyStore::AddKey(const Key& key, const KeyBlob& keyBlob, const uint8_t a
         return ER_BUS_KEYSTORE_NOT_LOADED;
     }
     QCC_DbgPrintf(("KeyStore::AddKey %s", key.ToString().c_str()));
-    KeyRecord& keyRec = (*keys)[key];
+    KeyRecord keyRec;
     keyRec.revision = revision + 1;
     keyRec.keyBlob = keyBlob;
     QCC_DbgPrintf(("AccessRights %1x%1x%1x%1x", accessRights[0], accessRights[1], accessRights[2], accessRights[3]));
     memcpy(&keyRec.accessRights, accessRights, sizeof(uint8_t) * 4);
+    PutKeyRecord(key, keyRec);
     storeState = MODIFIED;
     deletions.erase(key);
+    modifications.insert(key);
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
 
+void KeyStore::IndexKeyRecord(const Key& key, KeyRecord& keyRec)
+{
+    KeyBlob::AssociationMode mode = keyRec.keyBlob.GetAssociationMode();
+    if ((mode == KeyBlob::ASSOCIATE_MEMBER) || (mode == KeyBlob::ASSOCIATE_BOTH)) {
+        associations.insert(std::pair<GUID128, Key>(keyRec.keyBlob.GetAssociation(), key));
+    }
+    Timespec<EpochTime> expiration;
+    if (keyRec.keyBlob.GetExpiration(expiration)) {
+        expirations.insert(std::pair<Timespec<EpochTime>, Key>(expiration, key));
+    }
+}
+
+void KeyStore::UnindexKeyRecord(const Key& key, KeyRecord& keyRec)
+{
+    KeyBlob::AssociationMode mode = keyRec.keyBlob.GetAssociationMode();
+    if ((mode == KeyBlob::ASSOCIATE_MEMBER) || (mode == KeyBlob::ASSOCIATE_BOTH)) {
+        std::pair<std::multimap<GUID128, Key>::iterator, std::multimap<GUID128, Key>::iterator> range = associations.equal_range(keyRec.keyBlob.GetAssociation());
+        for (std::multimap<GUID128, Key>::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == key) {
+                associations.erase(it);
+                break;
+            }
+        }
+    }
+    Timespec<EpochTime> expiration;
+    if (keyRec.keyBlob.GetExpiration(expiration)) {
+        std::pair<std::multimap<Timespec<EpochTime>, Key>::iterator, std::multimap<Timespec<EpochTime>, Key>::iterator> range = expirations.equal_range(expiration);
+        for (std::multimap<Timespec<EpochTime>, Key>::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == key) {
+                expirations.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+void KeyStore::PutKeyRecord(const Key& key, const KeyRecord& keyRec)
+{
+    KeyMap::iterator it = keys->find(key);
+    if (it != keys->end()) {
+        UnindexKeyRecord(it->first, it->second);
+        it->second = keyRec;
+    } else {
+        it = keys->insert(std::pair<Key, KeyRecord>(key, keyRec)).first;
+    }
+    IndexKeyRecord(it->first, it->second);
+}
+
+void KeyStore::EraseKeyRecord(KeyMap::iterator it)
+{
+    UnindexKeyRecord(it->first, it->second);
+    keys->erase(it);
+}
+
+void KeyStore::EraseKeyRecord(const Key& key)
+{
+    KeyMap::iterator it = keys->find(key);
+    if (it != keys->end()) {
+        EraseKeyRecord(it);
+    }
+}
+
+void KeyStore::ClearKeyRecords()
+{
+    keys->clear();
+    associations.clear();
+    expirations.clear();
+}
+
+void KeyStore::RebuildIndexes()
+{
+    associations.clear();
+    expirations.clear();
+    for (KeyMap::iterator it = keys->begin(); it != keys->end(); ++it) {
+        IndexKeyRecord(it->first, it->second);
+    }
+}
+
 /**
  * This internal method deletes the key assuming the lock is already acquired.
  */
@@ -793,8 +1240,9 @@ QStatus KeyStore::DeleteKey(const Key& key)
     QCC_DbgPrintf(("KeyStore::DeleleKey %s", key.ToString().c_str()));
     /* Use a local copy because erase might destroy the key */
     Key keyCopy(key);
-    keys->erase(key);
+    EraseKeyRecord(keyCopy);
     storeState = MODIFIED;
+    modifications.erase(keyCopy);
     deletions.insert(keyCopy);
     return ER_OK;
 }
@@ -820,9 +1268,13 @@ QStatus KeyStore::SetKeyExpiration(const Key& key, const Timespec<qcc::EpochTime
     }
     QStatus status = ER_OK;
     QCC_DbgPrintf(("KeyStore::SetExpiration %s", key.ToString().c_str()));
-    if (keys->count(key) != 0) {
-        (*keys)[key].keyBlob.SetExpiration(expiration);
+    KeyMap::iterator it = keys->find(key);
+    if (it != keys->end()) {
+        UnindexKeyRecord(it->first, it->second);
+        it->second.keyBlob.SetExpiration(expiration);
+        IndexKeyRecord(it->first, it->second);
         storeState = MODIFIED;
+        modifications.insert(key);
     } else {
         status = ER_BUS_KEY_UNAVAILABLE;
     }
@@ -860,41 +1312,18 @@ QStatus KeyStore::GetKeyExpiration(const Key& key, Timespec<EpochTime>& expirati
 
 QStatus KeyStore::SearchAssociatedKeys(const Key& key, Key** list, size_t* numItems)
 {
-    size_t count = 0;
     lock.Lock(MUTEX_CONTEXT);
-    for (KeyMap::iterator it = keys->begin(); it != keys->end(); ++it) {
-        if ((it->second.keyBlob.GetAssociationMode() != KeyBlob::ASSOCIATE_MEMBER)
-            && (it->second.keyBlob.GetAssociationMode() != KeyBlob::ASSOCIATE_BOTH)) {
-            continue;
-        }
-        if (it->second.keyBlob.GetAssociation() == key.GetGUID()) {
-            count++;
-        }
-    }
-    if (count == 0) {
-        *numItems = count;
-        lock.Unlock(MUTEX_CONTEXT);
-        return ER_OK;
-    }
-
-    Key* keyList = new Key[count];
-    size_t idx = 0;
-    for (KeyMap::iterator it = keys->begin(); it != keys->end(); ++it) {
-        if ((it->second.keyBlob.GetAssociationMode() != KeyBlob::ASSOCIATE_MEMBER)
-            && (it->second.keyBlob.GetAssociationMode() != KeyBlob::ASSOCIATE_BOTH)) {
-            continue;
-        }
-        if (it->second.keyBlob.GetAssociation() == key.GetGUID()) {
-            if (idx >= count) { /* bound check */
-                delete [] keyList;
-                lock.Unlock(MUTEX_CONTEXT);
-                return ER_FAIL;
-            }
-            keyList[idx++] = it->first;
+    std::pair<std::multimap<GUID128, Key>::iterator, std::multimap<GUID128, Key>::iterator> range = associations.equal_range(key.GetGUID());
+    size_t count = std::distance(range.first, range.second);
+    *numItems = count;
+    if (count > 0) {
+        Key* keyList = new Key[count];
+        size_t idx = 0;
+        for (std::multimap<GUID128, Key>::iterator it = range.first; it != range.second; ++it) {
+            keyList[idx++] = it->second;
         }
+        *list = keyList;
     }
-    *numItems = count;
-    *list = keyList;
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
@@ -386,6 +386,64 @@ class KeyStore {
      */
     QStatus Push(qcc::Sink& sink);
 
+    /**
+     * Replay the records of a key store log into the key store. A log is the
+     * alternative to the format written by Push() where each change to a key
+     * is appended as a separate encrypted record so storing a change does
+     * not require rewriting all of the keys.
+     *
+     * If the key store is not loaded the whole log is replayed. Otherwise
+     * only the records from @a offset onwards are applied so the key store
+     * can catch up with changes appended by other applications sharing the
+     * log. Changes that have not been stored yet take precedence over the
+     * records. A record at the end of the log that was cut short by the end
+     * of the file is ignored, any other damaged record is an error.
+     *
+     * @param log       The contents of the log.
+     * @param len       Length of the log.
+     * @param offset    On input the offset of the first record to replay, 0 if the log was
+     *                  rewritten since it was last replayed. Returns the offset just past
+     *                  the last complete record.
+     * @param password  The password required to decrypt the log.
+     *
+     * @return
+     *      - ER_OK if successful
+     *      - ER_BUS_CORRUPT_KEYSTORE if a complete record cannot be read
+     *      - An error status otherwise
+     */
+    QStatus PullLog(const uint8_t* log, size_t len, size_t& offset, const qcc::String& password);
+
+    /**
+     * Write records to a key store log for the keys that were added, changed
+     * or deleted since the key store was last stored.
+     *
+     * @param sink     The sink to write the records to. These are appended to the log.
+     * @param compact  If true write a new log holding only the current keys instead.
+     *
+     * @return
+     *      - ER_OK if successful
+     *      - An error status otherwise
+     */
+    QStatus PushLog(qcc::Sink& sink, bool compact);
+
+    /**
+     * Check if enough of the records in the key store log have been superseded
+     * that the log should be rewritten with PushLog().
+     *
+     * @return  true if the log should be compacted.
+     */
+    bool LogNeedsCompaction();
+
+    /**
+     * Check if stored key data is a log written by PushLog().
+     *
+     * @param data  The start of the stored key data.
+     * @param len   Length of the data.
+     *
+     * @return  true if the data is a key store log.
+     */
+    static bool IsLog(const uint8_t* data, size_t len);
+
     /**
      * Indicates if this is a shared key store.
      *
@@ -480,8 +538,11 @@ class KeyStore {
 
     /**
      * Internal Load function
+     *
+     * @param incremental  If true keep the current keys and only catch up with changes
+     *                     appended to a key store log.
      */
-    QStatus Load();
+    QStatus Load(bool incremental = false);
 
     /**
      * wait for the guid to set
@@ -542,16 +603,111 @@ class KeyStore {
      */
     typedef std::map<Key, KeyRecord> KeyMap;
 
+    /**
+     * Append one encrypted record to a key store log. The lock must be acquired prior to calling this method.
+     *
+     * @param sink    The sink to write the record to.
+     * @param kind    The kind of record.
+     * @param key     The key the record is for.
+     * @param keyRec  The key record for an added or changed key, NULL otherwise.
+     */
+    QStatus PushLogRecord(qcc::Sink& sink, uint8_t kind, const Key& key, const KeyRecord* keyRec);
+
+    /**
+     * Add or replace a key record and update the indexes. The lock must be acquired prior to calling this method.
+     *
+     * @param key     The unique identifier for the key
+     * @param keyRec  The key record
+     */
+    void PutKeyRecord(const Key& key, const KeyRecord& keyRec);
+
+    /**
+     * Remove a key record and its index entries. The lock must be acquired prior to calling this method.
+     *
+     * @param it  The key record to remove
+     */
+    void EraseKeyRecord(KeyMap::iterator it);
+
+    /**
+     * Remove a key record and its index entries if there is one. The lock must be acquired prior to
+     * calling this method.
+     *
+     * @param key  The unique identifier for the key
+     */
+    void EraseKeyRecord(const Key& key);
+
+    /**
+     * Remove all key records and index entries. The lock must be acquired prior to calling this method.
+     */
+    void ClearKeyRecords();
+
+    /**
+     * Add or remove the index entries for a key record. The lock must be acquired prior to calling
+     * this method.
+     *
+     * @param key     The unique identifier for the key
+     * @param keyRec  The key record
+     */
+    void IndexKeyRecord(const Key& key, KeyRecord& keyRec);
+    void UnindexKeyRecord(const Key& key, KeyRecord& keyRec);
+
+    /**
+     * Rebuild the indexes after the key map has been replaced. The lock must be acquired prior to
+     * calling this method.
+     */
+    void RebuildIndexes();
+
     /**
      * In memory copy of the key store
      */
     KeyMap* keys;
 
+    /**
+     * Keys with an ASSOCIATE_MEMBER or ASSOCIATE_BOTH key blob indexed by the GUID they are
+     * associated with
+     */
+    std::multimap<qcc::GUID128, Key> associations;
+
+    /**
+     * Keys with an expiration time ordered by expiration time
+     */
+    std::multimap<qcc::Timespec<qcc::EpochTime>, Key> expirations;
+
     /**
      * GUID for keys that have been deleted
      */
     std::set<Key> deletions;
 
+    /**
+     * Keys that have been added or changed since the key store was last stored
+     */
+    std::set<Key> modifications;
+
+    /**
+     * Indicates if the key store was loaded from a log
+     */
+    bool logged;
+
+    /**
+     * Indicates if the key store was cleared since it was last stored to a log
+     */
+    bool logCleared;
+
+    /**
+     * Random value that makes the record nonces of each new log unique
+     */
+    uint64_t logGeneration;
+
+    /**
+     * Sequence number of the last record in the log
+     */
+    uint32_t logSeq;
+
+    /**
+     * Number of records in the log
+     */
+    size_t logRecords;
+
     /**
      * Default listener for handling load/store requests
      */
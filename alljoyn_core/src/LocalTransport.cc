@@ -23,6 +23,7 @@
 #include <qcc/platform.h>
 
 #include <list>
+#include <vector>
 
 #include <qcc/Debug.h>
 #include <qcc/GUID.h>
@@ -798,6 +799,7 @@ void _LocalEndpoint::UnregisterBusObject(BusObject& object)
 
     /* Notify object and detach from bus*/
     if (object.isRegistered) {
+        object.StopPropChangedCoalescing();
         object.ObjectUnregistered();
         object.isRegistered = false;
     }
@@ -1186,10 +1188,9 @@ QStatus _LocalEndpoint::HandleMethodCall(Message& message)
     QStatus status = ER_OK;
 
     /* Look up the member */
-    MethodTable::SafeEntry* safeEntry = methodTable.Find(message->GetObjectPath(),
-                                                         message->GetInterface(),
-                                                         message->GetMemberName());
-    const MethodTable::Entry* entry = safeEntry ? safeEntry->entry : NULL;
+    MethodTable::SafeEntry safeEntry;
+    methodTable.Find(message->GetObjectPath(), message->GetInterface(), message->GetMemberName(), safeEntry);
+    const MethodTable::Entry* entry = safeEntry.entry;
 
     if (entry == NULL) {
         if (strcmp(message->GetInterface(), org::freedesktop::DBus::Peer::InterfaceName) == 0) {
@@ -1216,7 +1217,15 @@ QStatus _LocalEndpoint::HandleMethodCall(Message& message)
             }
         }
         if (status == ER_OK) {
-            status = message->UnmarshalArgs(entry->member->signature, entry->member->returnSignature.c_str());
+            if (entry->typedArgs) {
+                /* The handler deserializes straight from the message buffer */
+                const uint8_t* body;
+                size_t bodyLen;
+                bool endianSwap;
+                status = message->GetMarshaledBody(entry->member->signature.c_str(), body, bodyLen, endianSwap, entry->member->returnSignature.c_str());
+            } else {
+                status = message->UnmarshalArgs(entry->member->signature, entry->member->returnSignature.c_str());
+            }
         }
     }
     if (status == ER_OK) {
@@ -1288,8 +1297,6 @@ QStatus _LocalEndpoint::HandleMethodCall(Message& message)
         status = ER_OK;
     }
 
-    // safeEntry might be null here
-    delete safeEntry;
     return status;
 }
 
@@ -1297,33 +1304,38 @@ QStatus _LocalEndpoint::HandleSignal(Message& message)
 {
     QStatus status = ER_OK;
 
-    signalTable.Lock();
-
     /* Look up the signal */
-    pair<SignalTable::const_iterator, SignalTable::const_iterator> range =
-        signalTable.Find(message->GetInterface(), message->GetMemberName());
+    SignalTable::SafeRange range;
+    signalTable.Find(message->GetInterface(), message->GetMemberName(), range);
 
     /*
      * Quick exit if there are no handlers for this signal
      */
-    if (range.first == range.second) {
-        signalTable.Unlock();
+    if (range.empty()) {
         return ER_OK;
     }
     /*
-     * Build a list of all signal handlers for this signal
+     * Select the signal handlers for this signal. The rules are matched before
+     * the signal is unmarshalled. The pinned range stays valid while the
+     * handlers are called so only the matches need to be remembered, on the
+     * stack unless there are an unusual number of handlers.
      */
-    list<SignalTable::Entry> callList;
-    const InterfaceDescription::Member* signal = range.first->second.member;
-    do {
-        if (range.first->second.rule.IsMatch(message)) {
-            callList.push_back(range.first->second);
+    static const size_t MAX_INLINE_HANDLERS = 16;
+    const SignalTable::Entry* inlineCallList[MAX_INLINE_HANDLERS];
+    vector<const SignalTable::Entry*> overflowCallList;
+    size_t numCalls = 0;
+    RuleMatchKeys keys(message);
+    const InterfaceDescription::Member* signal = range.begin()->second.member;
+    for (SignalTable::const_iterator it = range.begin(); it != range.end(); ++it) {
+        if (it->second.rule.IsMatch(message, keys)) {
+            if (numCalls < MAX_INLINE_HANDLERS) {
+                inlineCallList[numCalls] = &it->second;
+            } else {
+                overflowCallList.push_back(&it->second);
+            }
+            ++numCalls;
         }
-    } while (++range.first != range.second);
-    /*
-     * We have our callback list so we can unlock the signal table.
-     */
-    signalTable.Unlock();
+    }
     /*
      * Validate and unmarshal the signal
      */
@@ -1339,15 +1351,15 @@ QStatus _LocalEndpoint::HandleSignal(Message& message)
             status = ER_OK;
         }
     } else {
-        list<SignalTable::Entry>::const_iterator callit;
-        for (callit = callList.begin(); callit != callList.end(); ++callit) {
-            MessageReceiver* object = callit->object;
+        for (size_t i = 0; i < numCalls; ++i) {
+            const SignalTable::Entry* call = (i < MAX_INLINE_HANDLERS) ? inlineCallList[i] : overflowCallList[i - MAX_INLINE_HANDLERS];
+            MessageReceiver* object = call->object;
             handlerThreadsLock.Lock();
             bool unregistering = unregisteringObjects.find(object) != unregisteringObjects.end();
             if (!unregistering) {
                 activeHandlers[object].insert(Thread::GetThread());
                 handlerThreadsLock.Unlock();
-                (object->*callit->handler)(callit->member, message->GetObjectPath(), message);
+                (object->*call->handler)(call->member, message->GetObjectPath(), message);
                 handlerThreadsLock.Lock();
                 activeHandlers[object].erase(Thread::GetThread());
                 if (activeHandlers[object].empty()) {
@@ -41,6 +41,7 @@
 #include "AllJoynCrypto.h"
 #include "AllJoynPeerObj.h"
 #include "SignatureUtils.h"
+#include "ScalarArrayUtils.h"
 #include "BusInternal.h"
 
 #define QCC_MODULE "ALLJOYN"
@@ -209,14 +210,8 @@ QStatus _Message::MarshalArgs(const MsgArg* arg, size_t numArgs)
             } else {
                 Marshal4(len);
             }
-            for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                uint32_t b = arg->v_scalarArray.v_bool[i] ? 1 : 0;
-                if (endianSwap) {
-                    MarshalReversed(&b, 4);
-                } else {
-                    Marshal4(b);
-                }
-            }
+            ScalarArrayUtils::MarshalBooleans((uint32_t*)bufPos, arg->v_scalarArray.v_bool, arg->v_scalarArray.numElements, endianSwap);
+            bufPos += len;
             break;
 
         case ALLJOYN_INT32_ARRAY:
@@ -231,9 +226,8 @@ QStatus _Message::MarshalArgs(const MsgArg* arg, size_t numArgs)
             }
             if (endianSwap) {
                 MarshalReversed(&len, 4);
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    MarshalReversed(&arg->v_scalarArray.v_uint32[i], 4);
-                }
+                ScalarArrayUtils::Swap32((uint32_t*)bufPos, arg->v_scalarArray.v_uint32, arg->v_scalarArray.numElements);
+                bufPos += len;
             } else {
                 Marshal4(len);
                 if (arg->v_scalarArray.v_uint32) {
@@ -257,9 +251,8 @@ QStatus _Message::MarshalArgs(const MsgArg* arg, size_t numArgs)
                 if (endianSwap) {
                     MarshalReversed(&len, 4);
                     MarshalPad(8);
-                    for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                        MarshalReversed(&arg->v_scalarArray.v_uint64[i], 8);
-                    }
+                    ScalarArrayUtils::Swap64((uint64_t*)bufPos, arg->v_scalarArray.v_uint64, arg->v_scalarArray.numElements);
+                    bufPos += len;
                 } else {
                     Marshal4(len);
                     MarshalPad(8);
@@ -286,9 +279,8 @@ QStatus _Message::MarshalArgs(const MsgArg* arg, size_t numArgs)
             }
             if (endianSwap) {
                 MarshalReversed(&len, 4);
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    MarshalReversed(&arg->v_scalarArray.v_uint16[i], 2);
-                }
+                ScalarArrayUtils::Swap16((uint16_t*)bufPos, arg->v_scalarArray.v_uint16, arg->v_scalarArray.numElements);
+                bufPos += len;
             } else {
                 Marshal4(len);
                 if (arg->v_scalarArray.v_uint16) {
@@ -834,17 +826,28 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
                                  const MsgArg* args,
                                  uint8_t numArgs,
                                  uint8_t flags,
-                                 uint32_t sessionId)
+                                 uint32_t sessionId,
+                                 const MsgBodyWriter* body,
+                                 const void* headerKey)
 {
     char signature[256];
+    size_t sigLen = 0;
     QStatus status = ER_OK;
     // if the MsgArg passed in is NULL force the numArgs to be zero.
-    if (args == NULL) {
+    if ((args == NULL) || (body != NULL)) {
         numArgs = 0;
     }
-    size_t argsLen = (numArgs == 0) ? 0 : SignatureUtils::GetSize(args, numArgs);
+    size_t argsLen;
+    if (body) {
+        argsLen = body->GetSize();
+    } else {
+        argsLen = (numArgs == 0) ? 0 : SignatureUtils::GetSize(args, numArgs);
+    }
     size_t hdrLen = 0;
     size_t maxCryptoValsLen = 0;
+    HeaderTemplateCache& headerCache = bus->GetInternal().GetHeaderTemplateCache();
+    const HeaderTemplateCache::Template* headerTemplate = NULL;
+    bool cacheHeader = false;
 
     /*
      * Check if endianess needs to be swapped.
@@ -900,39 +903,21 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
      * Set the serial number. This may be changed later if the message gets delayed.
      */
     SetSerialNumber();
-    /*
-     * Add the destination if there is one.
-     */
-    hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].Clear();
-    if (!destination.empty()) {
-        hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].typeId = ALLJOYN_STRING;
-        hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].v_string.str = destination.c_str();
-        hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].v_string.len = destination.size();
-    }
-    /*
-     * Sender is obtained from the bus
-     */
-    hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].Clear();
-    if (!sender.empty()) {
-        hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].typeId = ALLJOYN_STRING;
-        hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].v_string.str = sender.c_str();
-        hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].v_string.len = sender.size();
-    }
     /*
      * If there are arguments build the signature
      */
-    hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].Clear();
-    if (numArgs > 0) {
-        size_t sigLen = 0;
+    if (body) {
+        sigLen = strlen(body->GetSignature());
+        if (sigLen >= sizeof(signature)) {
+            status = ER_BUS_BAD_SIGNATURE;
+            goto ExitMarshalMessage;
+        }
+        memcpy(signature, body->GetSignature(), sigLen + 1);
+    } else if (numArgs > 0) {
         status = SignatureUtils::MakeSignature(args, numArgs, signature, sigLen);
         if (status != ER_OK) {
             goto ExitMarshalMessage;
         }
-        if (sigLen > 0) {
-            hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].typeId = ALLJOYN_SIGNATURE;
-            hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].v_signature.sig = signature;
-            hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].v_signature.len = (uint8_t)sigLen;
-        }
     } else {
         signature[0] = 0;
     }
@@ -944,16 +929,61 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
         QCC_LogError(status, ("MarshalMessage expected signature \"%s\" got \"%s\"", expectedSignature.c_str(), signature));
         goto ExitMarshalMessage;
     }
-    /* Check if we are adding a session id */
-    hdrFields.field[ALLJOYN_HDR_FIELD_SESSION_ID].Clear();
-    if (sessionId != 0) {
-        hdrFields.field[ALLJOYN_HDR_FIELD_SESSION_ID].v_uint32 = sessionId;
-        hdrFields.field[ALLJOYN_HDR_FIELD_SESSION_ID].typeId = ALLJOYN_UINT32;
+    /*
+     * Method calls and signals that are sent repeatedly have the same header
+     * fields every time so reuse the fields marshaled last time if we can.
+     * The path, interface and member are already set and nothing else needs
+     * to be built to find the template.
+     */
+    if (headerKey && ((msgType == MESSAGE_METHOD_CALL) || (msgType == MESSAGE_SIGNAL)) && HeaderTemplateCache::IsCacheable(hdrFields)) {
+        headerTemplate = headerCache.Acquire(headerKey, hdrFields, destination, sessionId, sender, endianSwap);
+        if (headerTemplate && !headerTemplate->HasSignature(signature, sigLen)) {
+            headerTemplate->Release();
+            headerTemplate = NULL;
+        }
+        cacheHeader = (headerTemplate == NULL);
+    }
+    if (!headerTemplate) {
+        /*
+         * Add the destination if there is one.
+         */
+        hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].Clear();
+        if (!destination.empty()) {
+            hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].typeId = ALLJOYN_STRING;
+            hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].v_string.str = destination.c_str();
+            hdrFields.field[ALLJOYN_HDR_FIELD_DESTINATION].v_string.len = destination.size();
+        }
+        /*
+         * Sender is obtained from the bus
+         */
+        hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].Clear();
+        if (!sender.empty()) {
+            hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].typeId = ALLJOYN_STRING;
+            hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].v_string.str = sender.c_str();
+            hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].v_string.len = sender.size();
+        }
+        hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].Clear();
+        if (sigLen > 0) {
+            hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].typeId = ALLJOYN_SIGNATURE;
+            hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].v_signature.sig = signature;
+            hdrFields.field[ALLJOYN_HDR_FIELD_SIGNATURE].v_signature.len = (uint8_t)sigLen;
+        }
+        /* Check if we are adding a session id */
+        hdrFields.field[ALLJOYN_HDR_FIELD_SESSION_ID].Clear();
+        if (sessionId != 0) {
+            hdrFields.field[ALLJOYN_HDR_FIELD_SESSION_ID].v_uint32 = sessionId;
+            hdrFields.field[ALLJOYN_HDR_FIELD_SESSION_ID].typeId = ALLJOYN_UINT32;
+        }
     }
     /*
      * Calculate space required for the header fields
      */
-    hdrLen = ComputeHeaderLen();
+    if (headerTemplate) {
+        msgHeader.headerLen = headerTemplate->GetHeaderLen();
+        hdrLen = sizeof(msgHeader) + headerTemplate->GetPaddedLen();
+    } else {
+        hdrLen = ComputeHeaderLen();
+    }
     /*
      * Check that total packet size is within limits
      */
@@ -995,7 +1025,16 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
     /*
      * Marshal the header fields
      */
-    MarshalHeaderFields();
+    if (headerTemplate) {
+        headerTemplate->Apply(hdrFields, bufPos);
+        bufPos += headerTemplate->GetPaddedLen();
+    } else {
+        MarshalHeaderFields();
+        if (cacheHeader) {
+            uint8_t* fieldsPos = reinterpret_cast<uint8_t*>(msgBuf) + sizeof(msgHeader);
+            headerCache.Add(headerKey, hdrFields, endianSwap, fieldsPos, bufPos - fieldsPos, msgHeader.headerLen);
+        }
+    }
     QCC_ASSERT((bufPos - (uint8_t*)msgBuf) == static_cast<ptrdiff_t>(hdrLen));
     if (msgHeader.bodyLen == 0) {
         bufEOD = bufPos;
@@ -1007,7 +1046,15 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
      * Marshal the message body
      */
     bodyPtr = bufPos;
-    status = MarshalArgs(args, numArgs);
+    if (body) {
+        /*
+         * The body writer serializes its values directly into the buffer
+         */
+        status = body->Marshal(bufPos, endianSwap);
+        bufPos += argsLen;
+    } else {
+        status = MarshalArgs(args, numArgs);
+    }
     if (status != ER_OK) {
         goto ExitMarshalMessage;
     }
@@ -1048,6 +1095,9 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
 
 ExitMarshalMessage:
 
+    if (headerTemplate) {
+        headerTemplate->Release();
+    }
     /*
      * Don't need the old message buffer any more
      */
@@ -1168,13 +1218,15 @@ QStatus _Message::CallMsg(const qcc::String& signature,
                           const qcc::String& methodName,
                           const MsgArg* args,
                           size_t numArgs,
-                          uint8_t flags)
+                          uint8_t flags,
+                          const MsgBodyWriter* body,
+                          const void* headerKey)
 {
     if (!bus->IsStarted()) {
         return ER_BUS_BUS_NOT_STARTED;
     }
     return CallMsg(signature, bus->GetInternal().GetLocalEndpoint()->GetUniqueName(), destination,
-                   sessionId, objPath, iface, methodName, args, numArgs, flags);
+                   sessionId, objPath, iface, methodName, args, numArgs, flags, body, headerKey);
 }
 
 QStatus _Message::CallMsg(const qcc::String& signature,
@@ -1186,7 +1238,9 @@ QStatus _Message::CallMsg(const qcc::String& signature,
                           const qcc::String& methodName,
                           const MsgArg* args,
                           size_t numArgs,
-                          uint8_t flags)
+                          uint8_t flags,
+                          const MsgBodyWriter* body,
+                          const void* headerKey)
 {
     QStatus status;
 
@@ -1243,7 +1297,7 @@ QStatus _Message::CallMsg(const qcc::String& signature,
      * Build method call message
      */
     status = MarshalMessage(signature, sender, destination, MESSAGE_METHOD_CALL,
-                            args, numArgs, flags, sessionId);
+                            args, numArgs, flags, sessionId, body, headerKey);
 
 ExitCallMsg:
     return status;
@@ -1258,14 +1312,16 @@ QStatus _Message::SignalMsg(const qcc::String& signature,
                             const MsgArg* args,
                             size_t numArgs,
                             uint8_t flags,
-                            uint16_t timeToLive)
+                            uint16_t timeToLive,
+                            const MsgBodyWriter* body,
+                            const void* headerKey)
 {
     if (!bus->IsStarted()) {
         return ER_BUS_BUS_NOT_STARTED;
     }
     return SignalMsg(signature, bus->GetInternal().GetLocalEndpoint()->GetUniqueName(), destination,
                      sessionId, objPath, iface, signalName, args, numArgs,
-                     flags, timeToLive);
+                     flags, timeToLive, body, headerKey);
 }
 
 QStatus _Message::SignalMsg(const qcc::String& signature,
@@ -1278,7 +1334,9 @@ QStatus _Message::SignalMsg(const qcc::String& signature,
                             const MsgArg* args,
                             size_t numArgs,
                             uint8_t flags,
-                            uint16_t timeToLive)
+                            uint16_t timeToLive,
+                            const MsgBodyWriter* body,
+                            const void* headerKey)
 {
     QStatus status;
 
@@ -1342,21 +1400,21 @@ QStatus _Message::SignalMsg(const qcc::String& signature,
      * Build signal message
      */
     status = MarshalMessage(signature, sender, destination, MESSAGE_SIGNAL,
-                            args, numArgs, flags, sessionId);
+                            args, numArgs, flags, sessionId, body, headerKey);
 
 ExitSignalMsg:
     return status;
 }
 
-QStatus _Message::ReplyMsg(const Message& call, const MsgArg* args, size_t numArgs)
+QStatus _Message::ReplyMsg(const Message& call, const MsgArg* args, size_t numArgs, const MsgBodyWriter* body)
 {
     if (!bus->IsStarted()) {
         return ER_BUS_BUS_NOT_STARTED;
     }
-    return ReplyMsg(call, bus->GetInternal().GetLocalEndpoint()->GetUniqueName(), args, numArgs);
+    return ReplyMsg(call, bus->GetInternal().GetLocalEndpoint()->GetUniqueName(), args, numArgs, body);
 }
 
-QStatus _Message::ReplyMsg(const Message& call, const qcc::String& sender, const MsgArg* args, size_t numArgs)
+QStatus _Message::ReplyMsg(const Message& call, const qcc::String& sender, const MsgArg* args, size_t numArgs, const MsgBodyWriter* body)
 {
     QStatus status;
     SessionId sessionId = call->GetSessionId();
@@ -1382,7 +1440,7 @@ QStatus _Message::ReplyMsg(const Message& call, const qcc::String& sender, const
      * Build method return message (encrypted if the method call was encrypted)
      */
     status = MarshalMessage(call->replySignature, sender, destination, MESSAGE_METHOD_RET,
-                            args, numArgs, call->msgHeader.flags & ALLJOYN_FLAG_ENCRYPTED, sessionId);
+                            args, numArgs, call->msgHeader.flags & ALLJOYN_FLAG_ENCRYPTED, sessionId, body);
     SetMessageEncryptionNotification(call->encryptionNotification);
     return status;
 }
@@ -40,6 +40,7 @@
 #include "AllJoynCrypto.h"
 #include "AllJoynPeerObj.h"
 #include "SignatureUtils.h"
+#include "ScalarArrayUtils.h"
 #include "BusInternal.h"
 
 #define QCC_MODULE "ALLJOYN"
@@ -117,13 +118,9 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 2);
             if (endianSwap) {
-                arg->v_scalarArray.v_uint16 = new uint16_t[arg->v_scalarArray.numElements];
-                uint16_t* p = (uint16_t*)arg->v_scalarArray.v_uint16;
-                uint16_t* n = (uint16_t*)bufPos;
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    *p++ = EndianSwap16(*n);
-                    n++;
-                }
+                uint16_t* p = new uint16_t[arg->v_scalarArray.numElements];
+                ScalarArrayUtils::Swap16(p, (uint16_t*)bufPos, arg->v_scalarArray.numElements);
+                arg->v_scalarArray.v_uint16 = p;
                 arg->flags = MsgArg::OwnsData;
             } else {
                 arg->v_scalarArray.v_uint16 = (uint16_t*)bufPos;
@@ -138,28 +135,13 @@ QStatus _Message::ParseArray(MsgArg* arg,
         if ((len & 3) == 0) {
             size_t num = (size_t)(len / 4);
             bool* bools = new bool[num];
-            for (size_t i = 0; i < num; i++) {
-                uint32_t b = *(uint32_t*)bufPos;
-                if (endianSwap) {
-                    b = EndianSwap32(b);
-                }
-                if (b > 1) {
-                    delete [] bools;
-                    status = ER_BUS_BAD_VALUE;
-                    break;
-                }
-                bools[i] = (b == 1);
-                bufPos += 4;
-            }
-            /*
-             * if status is set to ER_BUS_BAD_VALUE it means the for loop above
-             * found that the value was not an ALLJOYN_BOOLEAN type and deleted
-             * the array 'bools' then exited the for loop. Do not try and set
-             * the 'v_scalarArray.v_bool' to the now invalid 'bools'.
-             */
-            if (status == ER_BUS_BAD_VALUE) {
+            if (!ScalarArrayUtils::UnmarshalBooleans(bools, (uint32_t*)bufPos, num, endianSwap)) {
+                /* One of the values was not an ALLJOYN_BOOLEAN */
+                delete [] bools;
+                status = ER_BUS_BAD_VALUE;
                 break;
             }
+            bufPos += len;
             arg->typeId = ALLJOYN_BOOLEAN_ARRAY;
             arg->v_scalarArray.numElements = num;
             arg->v_scalarArray.v_bool = bools;
@@ -175,13 +157,9 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 4);
             if (endianSwap) {
-                arg->v_scalarArray.v_uint32 = new uint32_t[arg->v_scalarArray.numElements];
-                uint32_t* p = (uint32_t*)arg->v_scalarArray.v_uint32;
-                uint32_t* n = (uint32_t*)bufPos;
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    *p++ = EndianSwap32(*n);
-                    n++;
-                }
+                uint32_t* p = new uint32_t[arg->v_scalarArray.numElements];
+                ScalarArrayUtils::Swap32(p, (uint32_t*)bufPos, arg->v_scalarArray.numElements);
+                arg->v_scalarArray.v_uint32 = p;
                 arg->flags = MsgArg::OwnsData;
             } else {
                 arg->v_scalarArray.v_uint32 = (uint32_t*)bufPos;
@@ -199,15 +177,10 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 8);
             bufPos = AlignPtr(bufPos, 8);
-            arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
             if (endianSwap) {
-                arg->v_scalarArray.v_uint64 = new uint64_t[arg->v_scalarArray.numElements];
-                uint64_t* p = (uint64_t*)arg->v_scalarArray.v_uint64;
-                uint64_t* n = (uint64_t*)bufPos;
-                for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
-                    *p++ = EndianSwap64(*n);
-                    n++;
-                }
+                uint64_t* p = new uint64_t[arg->v_scalarArray.numElements];
+                ScalarArrayUtils::Swap64(p, (uint64_t*)bufPos, arg->v_scalarArray.numElements);
+                arg->v_scalarArray.v_uint64 = p;
                 arg->flags = MsgArg::OwnsData;
             } else {
                 arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
@@ -720,6 +693,65 @@ ExitUnmarshalArgs:
     return status;
 }
 
+QStatus _Message::GetMarshaledBody(const char* expectedSignature,
+                                   const uint8_t*& body,
+                                   size_t& bodyLen,
+                                   bool& endianSwap,
+                                   const char* expectedReplySignature)
+{
+    const char* sig = GetSignature();
+
+    if ((msgHeader.msgType == MESSAGE_INVALID) || (msgBuf == NULL)) {
+        return ER_FAIL;
+    }
+    if (strcmp(expectedSignature, sig) != 0) {
+        QStatus status = ER_BUS_SIGNATURE_MISMATCH;
+        QCC_LogError(status, ("Expected \"%s\" got \"%s\"", expectedSignature, sig));
+        return status;
+    }
+    if (IsBodyEncrypted()) {
+        /*
+         * Decryption and the permission checks that go with it are done by
+         * UnmarshalArgs. The body is decrypted in place so it can be read from
+         * the buffer afterwards.
+         */
+        QStatus status = UnmarshalArgs(expectedSignature, expectedReplySignature);
+        if (status != ER_OK) {
+            return status;
+        }
+    } else if (expectedReplySignature) {
+        /*
+         * Save the reply signature so we can check it when we marshall the reply.
+         */
+        replySignature = expectedReplySignature;
+    }
+    /*
+     * UnmarshalArgs switches the message header to native endianess but the
+     * buffer keeps the endianess it was received in.
+     */
+    endianSwap = reinterpret_cast<const MessageHeader*>(msgBuf)->endian != myEndian;
+    body = bodyPtr;
+    bodyLen = msgHeader.bodyLen;
+    /*
+     * Every type takes at least one byte so the body is empty if and only if
+     * the signature is.
+     */
+    if ((bodyLen == 0) != (sig[0] == 0)) {
+        QStatus status = ER_BUS_BAD_BODY_LEN;
+        QCC_LogError(status, ("Body length %u does not fit signature \"%s\"", static_cast<uint32_t>(bodyLen), sig));
+        return status;
+    }
+    if (bodyLen && (body == NULL)) {
+        return ER_BUS_BAD_BODY_LEN;
+    }
+    return ER_OK;
+}
+
+qcc::SocketFd _Message::GetHandle(size_t index) const
+{
+    return (index < numHandles) ? handles[index] : qcc::INVALID_SOCKET_FD;
+}
+
 
 
 static QStatus PedanticCheck(const MsgArg* field, uint32_t fieldId)
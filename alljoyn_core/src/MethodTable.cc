@@ -23,6 +23,8 @@
 
 #include <qcc/platform.h>
 
+#include <qcc/Debug.h>
+
 #include "MethodTable.h"
 
 /** @internal */
@@ -33,6 +35,10 @@ using namespace std;
 
 namespace ajn {
 
+MethodTable::MethodTable() : published(new MapType()), stale(0)
+{
+}
+
 MethodTable::~MethodTable()
 {
     lock.Lock(MUTEX_CONTEXT);
@@ -43,17 +49,30 @@ MethodTable::~MethodTable()
     }
 
     hashTable.clear();
+    for (vector<Entry*>::iterator it = retired.begin(); it != retired.end(); ++it) {
+        delete *it;
+    }
+    retired.clear();
+    delete published.Current();
     lock.Unlock(MUTEX_CONTEXT);
 }
 
 void MethodTable::Add(BusObject* object,
                       MessageReceiver::MethodHandler func,
                       const InterfaceDescription::Member* member,
-                      void* context)
+                      void* context,
+                      bool typedArgs)
 {
-    Entry* entry = new Entry(object, func, member, context);
+    Entry* entry = new Entry(object, func, member, context, typedArgs);
     lock.Lock(MUTEX_CONTEXT);
-    hashTable[Key(object->GetPath(), entry->ifaceStr.empty() ? NULL : entry->ifaceStr.c_str(), member->name.c_str())] = entry;
+    Key key(object->GetPath(), entry->ifaceStr.empty() ? NULL : entry->ifaceStr.c_str(), member->name.c_str());
+    MapType::iterator iter = hashTable.find(key);
+    if (iter != hashTable.end()) {
+        /* The key points into the entry being replaced so it must be replaced too */
+        retired.push_back(iter->second);
+        hashTable.erase(iter);
+    }
+    hashTable[key] = entry;
 
     /* Method calls don't require an interface so we need to add an entry with a NULL interface */
     if (!entry->ifaceStr.empty()) {
@@ -61,52 +80,80 @@ void MethodTable::Add(BusObject* object,
         // with the same name, the results are undefined." We choose to only
         // use the first member that was added.
         if (hashTable.find(Key(object->GetPath(), NULL, member->name.c_str())) == hashTable.end()) {
-            hashTable[Key(object->GetPath(), NULL, member->name.c_str())] = new Entry(*entry);
+            Entry* noIfaceEntry = new Entry(*entry);
+            hashTable[Key(object->GetPath(), NULL, noIfaceEntry->methodStr.c_str())] = noIfaceEntry;
         }
     }
+    /* Readers see the change once the next Find() publishes it */
+    stale = 1;
     lock.Unlock(MUTEX_CONTEXT);
 }
 
-MethodTable::SafeEntry* MethodTable::Find(const char* objectPath,
-                                          const char* iface,
-                                          const char* methodName)
+bool MethodTable::Find(const char* objectPath,
+                       const char* iface,
+                       const char* methodName,
+                       SafeEntry& found)
 {
-    SafeEntry* entry = NULL;
+    QCC_ASSERT(found.entry == NULL);
+    if (stale) {
+        lock.Lock(MUTEX_CONTEXT);
+        if (stale) {
+            Publish();
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+    }
     Key key(objectPath, iface, methodName);
-    lock.Lock(MUTEX_CONTEXT);
-    MapType::iterator iter = hashTable.find(key);
-    if (iter != hashTable.end()) {
-        entry = new SafeEntry();
-        entry->Set(iter->second);
+    EpochPointer<MapType>::ReadGuard guard(published);
+    const MapType* table = guard.Get();
+    MapType::const_iterator iter = table->find(key);
+    if (iter == table->end()) {
+        return false;
     }
-    lock.Unlock(MUTEX_CONTEXT);
-    return entry;
+    found.Set(iter->second);
+    return true;
 }
 
 void MethodTable::RemoveAll(BusObject* object)
 {
-    MapType::iterator iter;
     /*
-     * Iterate over all entries deleting all entries that reference the object
+     * Iterate over all entries removing all entries that reference the object
      */
     lock.Lock(MUTEX_CONTEXT);
-    iter = hashTable.begin();
+    MapType::iterator iter = hashTable.begin();
     while (iter != hashTable.end()) {
         if (iter->second->object == object) {
-            Entry* deleteMe = iter->second;
-            hashTable.erase(iter);
-            delete deleteMe;
-            iter = hashTable.begin();
+            retired.push_back(iter->second);
+            iter = hashTable.erase(iter);
         } else {
             ++iter;
         }
     }
+    /* The object may be deleted as soon as we return so this can't wait */
+    if (!retired.empty()) {
+        Publish();
+    }
     lock.Unlock(MUTEX_CONTEXT);
 }
 
+void MethodTable::Publish()
+{
+    stale = 0;
+    delete published.Exchange(new MapType(hashTable));
+    /*
+     * No reader can find the retired entries any more. Deleting an entry
+     * waits for any SafeEntry still referring to it to be released.
+     */
+    for (vector<Entry*>::iterator iter = retired.begin(); iter != retired.end(); ++iter) {
+        delete *iter;
+    }
+    retired.clear();
+}
+
 void MethodTable::AddAll(BusObject* object)
 {
+    lock.Lock(MUTEX_CONTEXT);
     object->InstallMethods(*this);
+    lock.Unlock(MUTEX_CONTEXT);
 }
 
 }
@@ -23,11 +23,13 @@
 
 #include <qcc/platform.h>
 
+#include <string.h>
 #include <vector>
 
 #include <qcc/String.h>
 #include <qcc/Mutex.h>
 #include <qcc/Thread.h>
+#include <qcc/Util.h>
 #include <qcc/atomic.h>
 
 #include <alljoyn/BusObject.h>
@@ -36,12 +38,16 @@
 
 #include <alljoyn/Status.h>
 
+#include "EpochPointer.h"
+
 #include <qcc/STLContainer.h>
 
 namespace ajn {
 
 /**
  * %MethodTable is a hash table that maps object paths to BusObject instances.
+ * Lookups read an immutable copy of the table that is republished whenever
+ * the table changes, so dispatching a method call takes no lock.
  */
 class MethodTable {
 
@@ -58,9 +64,10 @@ class MethodTable {
         Entry(BusObject* object,
               MessageReceiver::MethodHandler handler,
               const InterfaceDescription::Member* member,
-              void* context)
+              void* context,
+              bool typedArgs)
             : object(object), handler(handler), member(member), context(context), ifaceStr(member->iface->GetName()), methodStr(member->name),
-            refCount(0) { }
+            typedArgs(typedArgs), refCount(0) { }
 
         ~Entry()
         {
@@ -72,7 +79,7 @@ class MethodTable {
         /**
          * Construct an empty Entry.
          */
-        Entry(void) : object(NULL), handler(), ifaceStr(), methodStr() { }
+        Entry(void) : object(NULL), handler(), ifaceStr(), methodStr(), typedArgs(false) { }
 
         BusObject* object;                             /**<  BusObject instance*/
         MessageReceiver::MethodHandler handler;        /**<  Handler for method */
@@ -80,11 +87,17 @@ class MethodTable {
         void* context;                                 /**<  Optional context provided when handler was registered */
         qcc::String ifaceStr;                          /**<  Interface string */
         qcc::String methodStr;                         /**<  Method string */
-        mutable volatile int32_t refCount;
+        bool typedArgs;                                /**<  Handler reads the marshaled body instead of MsgArgs */
+        mutable volatile int32_t refCount;             /**<  Number of SafeEntry references to this entry */
     };
 #pragma pack(pop, Entry)
-    struct SafeEntry {
-        SafeEntry() : entry(NULL) {   }
+    /**
+     * A pinned reference to an Entry returned by Find(). The entry cannot be
+     * removed from under the caller while a SafeEntry refers to it.
+     */
+    class SafeEntry {
+      public:
+        SafeEntry() : entry(NULL) { }
 
         ~SafeEntry()
         {
@@ -93,43 +106,63 @@ class MethodTable {
             }
         }
 
-        void Set(Entry* newEntry)
+        const Entry* entry;  /**< The pinned entry or NULL */
+
+      private:
+        friend class MethodTable;
+
+        SafeEntry(const SafeEntry& other);
+        SafeEntry& operator=(const SafeEntry& other);
+
+        void Set(const Entry* newEntry)
         {
             qcc::IncrementAndFetch(&(newEntry->refCount));
             this->entry = newEntry;
         }
-
-        const Entry* entry;
     };
 
+    /**
+     * Constructor
+     */
+    MethodTable();
+
     /**
      * Destructor
      */
     ~MethodTable();
 
     /**
-     * Add an entry to the method hash table.
+     * Add an entry to the method hash table. Additions are published to
+     * readers by the next Find() so that registering many methods copies the
+     * table once rather than once per method.
      *
      * @param object     Object instance.
      * @param func       Handler for method.
      * @param member     Member that func implements.
+     * @param context    Optional context passed to the handler.
+     * @param typedArgs  True if the handler reads the marshaled body with TypedArgs.
      */
     void Add(BusObject* object,
              MessageReceiver::MethodHandler func,
              const InterfaceDescription::Member* member,
-             void* context = NULL);
+             void* context = NULL,
+             bool typedArgs = false);
 
     /**
-     * Find an Entry based on set of criteria.
+     * Find an Entry based on set of criteria. The lookup takes no lock and
+     * does not allocate, except that the first lookup after entries were
+     * added publishes them.
      *
      * @param objectPath   The object path.
      * @param iface        The interface.
      * @param methodName   The method name.
+     * @param[out] found   Pinned reference to the entry that matches
+     *                     objectPath, interface and method.
      * @return
-     *      - Entry that matches objectPath, interface and method
-     *      - NULL if not found
+     *      - true if an entry was found
+     *      - false if not found
      */
-    SafeEntry* Find(const char* objectPath, const char* iface, const char* methodName);
+    bool Find(const char* objectPath, const char* iface, const char* methodName, SafeEntry& found);
 
     /**
      * Remove all hash entries related to the specified object.
@@ -147,7 +180,7 @@ class MethodTable {
 
   private:
 
-    qcc::Mutex lock; /**< Lock protecting the method table */
+    qcc::Mutex lock; /**< Lock serializing changes to the method table */
 
     /**
      * Type definition for method hash table key
@@ -166,19 +199,21 @@ class MethodTable {
     struct Hash {
         /** Calculate hash for Key k  */
         size_t operator()(const Key& k) const {
-            size_t hash = 37;
-            for (const char* p = k.methodName; *p; ++p) {
-                hash = *p + hash * 11;
-            }
-            for (const char* p = k.objPath; *p; ++p) {
-                hash = *p + hash * 5;
-            }
-            if (k.iface) {
-                for (const char* p = k.iface; *p; ++p) {
-                    hash += *p * 7;
-                }
-            }
-            return hash;
+            /*
+             * FNV-1a over all three strings. Each string is terminated so
+             * that characters cannot move between fields without changing
+             * the hash.
+             */
+            uint64_t hash = qcc::FNV1A_64_INIT;
+            hash = Mix(hash, k.objPath);
+            hash = Mix(hash, k.iface ? k.iface : "");
+            hash = Mix(hash, k.methodName);
+            return static_cast<size_t>(hash);
+        }
+
+        /** Fold a NUL terminated string into the hash */
+        static uint64_t Mix(uint64_t hash, const char* p) {
+            return qcc::hash_fnv1a(p, strlen(p) + 1, hash);
         }
     };
 
@@ -200,7 +235,17 @@ class MethodTable {
 
     /** The hash table */
     typedef std::unordered_map<Key, Entry*, Hash, Equal> MapType;
-    MapType hashTable;
+
+    /**
+     * Publish a copy of the writer's table to readers and delete the retired
+     * entries once no reader can reach them. Must be called with lock held.
+     */
+    void Publish();
+
+    MapType hashTable;                  /**< The writer's copy of the table, protected by lock */
+    std::vector<Entry*> retired;        /**< Entries removed since the last Publish(), protected by lock */
+    EpochPointer<MapType> published;    /**< Immutable copy of the table used by Find() */
+    volatile int32_t stale;             /**< Non-zero when entries were added since the last Publish() */
 };
 
 }
@@ -27,6 +27,7 @@
 #include <qcc/Debug.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
+#include <qcc/Util.h>
 
 #include <alljoyn/Message.h>
 #include <alljoyn/MsgArg.h>
@@ -1238,6 +1239,104 @@ QStatus MsgArgUtils::SetV(MsgArg* args, size_t& numArgs, const char* signature,
     return status;
 }
 
+uint64_t MsgArgUtils::Hash(const MsgArg& arg, uint64_t hash)
+{
+    uint16_t typeId = static_cast<uint16_t>(arg.typeId);
+    hash = hash_fnv1a(&typeId, sizeof(typeId), hash);
+    switch (arg.typeId) {
+    case ALLJOYN_DICT_ENTRY:
+        hash = Hash(*arg.v_dictEntry.key, hash);
+        hash = Hash(*arg.v_dictEntry.val, hash);
+        break;
+
+    case ALLJOYN_STRUCT:
+        hash = hash_fnv1a(&arg.v_struct.numMembers, sizeof(arg.v_struct.numMembers), hash);
+        for (size_t i = 0; i < arg.v_struct.numMembers; i++) {
+            hash = Hash(arg.v_struct.members[i], hash);
+        }
+        break;
+
+    case ALLJOYN_ARRAY:
+        {
+            size_t numElements = arg.v_array.GetNumElements();
+            hash = hash_fnv1a(&numElements, sizeof(numElements), hash);
+            for (size_t i = 0; i < numElements; i++) {
+                hash = Hash(arg.v_array.GetElements()[i], hash);
+            }
+        }
+        break;
+
+    case ALLJOYN_VARIANT:
+        hash = Hash(*arg.v_variant.val, hash);
+        break;
+
+    case ALLJOYN_OBJECT_PATH:
+    case ALLJOYN_STRING:
+        hash = hash_fnv1a(arg.v_string.str, arg.v_string.len, hash);
+        break;
+
+    case ALLJOYN_SIGNATURE:
+        hash = hash_fnv1a(arg.v_signature.sig, arg.v_signature.len, hash);
+        break;
+
+    case ALLJOYN_BOOLEAN_ARRAY:
+        hash = hash_fnv1a(arg.v_scalarArray.v_bool, arg.v_scalarArray.numElements * sizeof(bool), hash);
+        break;
+
+    case ALLJOYN_INT32_ARRAY:
+    case ALLJOYN_UINT32_ARRAY:
+        hash = hash_fnv1a(arg.v_scalarArray.v_uint32, arg.v_scalarArray.numElements * sizeof(uint32_t), hash);
+        break;
+
+    case ALLJOYN_INT16_ARRAY:
+    case ALLJOYN_UINT16_ARRAY:
+        hash = hash_fnv1a(arg.v_scalarArray.v_uint16, arg.v_scalarArray.numElements * sizeof(uint16_t), hash);
+        break;
+
+    case ALLJOYN_DOUBLE_ARRAY:
+    case ALLJOYN_UINT64_ARRAY:
+    case ALLJOYN_INT64_ARRAY:
+        hash = hash_fnv1a(arg.v_scalarArray.v_uint64, arg.v_scalarArray.numElements * sizeof(uint64_t), hash);
+        break;
+
+    case ALLJOYN_BYTE_ARRAY:
+        hash = hash_fnv1a(arg.v_scalarArray.v_byte, arg.v_scalarArray.numElements, hash);
+        break;
+
+    case ALLJOYN_BYTE:
+        hash = hash_fnv1a(&arg.v_byte, sizeof(arg.v_byte), hash);
+        break;
+
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+        hash = hash_fnv1a(&arg.v_uint16, sizeof(arg.v_uint16), hash);
+        break;
+
+    case ALLJOYN_BOOLEAN:
+        hash = hash_fnv1a(&arg.v_bool, sizeof(arg.v_bool), hash);
+        break;
+
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+        hash = hash_fnv1a(&arg.v_uint32, sizeof(arg.v_uint32), hash);
+        break;
+
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_UINT64:
+    case ALLJOYN_INT64:
+        hash = hash_fnv1a(&arg.v_uint64, sizeof(arg.v_uint64), hash);
+        break;
+
+    case ALLJOYN_HANDLE:
+        hash = hash_fnv1a(&arg.v_handle.fd, sizeof(arg.v_handle.fd), hash);
+        break;
+
+    default:
+        break;
+    }
+    return hash;
+}
+
 QStatus AJ_CALL MsgArg::Set(MsgArg* args, size_t& numArgs, const char* signature, ...)
 {
     va_list argp;
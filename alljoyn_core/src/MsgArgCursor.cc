@@ -0,0 +1,454 @@
+/**
+ * @file
+ * This file implements a cursor for reading individual arguments from a
+ * marshaled message body.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <string.h>
+
+#include <qcc/Debug.h>
+#include <qcc/SocketWrapper.h>
+#include <qcc/Util.h>
+
+#include "MsgArgCursor.h"
+#include "SignatureUtils.h"
+
+/** @internal */
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+
+namespace ajn {
+
+MsgArgCursor::MsgArgCursor(const Message& message) :
+    msg(message),
+    body(NULL),
+    bodyLen(0),
+    pos(0),
+    endianSwap(false),
+    depth(0),
+    status(ER_OK)
+{
+    if (msg->IsBodyEncrypted()) {
+        /*
+         * The body has not been decrypted. Decrypting modifies the message
+         * buffer so work on a copy. This also runs the permission checks that
+         * go with decryption.
+         */
+        msg = Message(message, true);
+    }
+    status = msg->GetMarshaledBody(msg->GetSignature(), body, bodyLen, endianSwap);
+    const char* sig = msg->GetSignature();
+    levels[0].sigStart = sig;
+    levels[0].sig = sig;
+    levels[0].sigEnd = sig + strlen(sig);
+    levels[0].end = 0;
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Cannot read arguments of message %s", msg->Description().c_str()));
+    }
+}
+
+bool MsgArgCursor::AtEnd() const
+{
+    const Level& level = levels[depth];
+    if (level.end) {
+        return pos >= level.end;
+    } else {
+        return level.sig >= level.sigEnd;
+    }
+}
+
+AllJoynTypeId MsgArgCursor::GetTypeId() const
+{
+    if ((status != ER_OK) || AtEnd()) {
+        return ALLJOYN_INVALID;
+    }
+    switch (*levels[depth].sig) {
+    case ALLJOYN_STRUCT_OPEN:
+        return ALLJOYN_STRUCT;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        return ALLJOYN_DICT_ENTRY;
+
+    default:
+        return static_cast<AllJoynTypeId>(*levels[depth].sig);
+    }
+}
+
+QStatus MsgArgCursor::Align(size_t alignment)
+{
+    pos = (pos + alignment - 1) & ~(alignment - 1);
+    return (pos > bodyLen) ? ER_BUS_BAD_LENGTH : ER_OK;
+}
+
+QStatus MsgArgCursor::ReadUint32(uint32_t& value)
+{
+    QStatus result = Align(4);
+    if (result == ER_OK) {
+        if ((bodyLen - pos) < 4) {
+            return ER_BUS_BAD_LENGTH;
+        }
+        value = *reinterpret_cast<const uint32_t*>(body + pos);
+        if (endianSwap) {
+            value = EndianSwap32(value);
+        }
+        pos += 4;
+    }
+    return result;
+}
+
+QStatus MsgArgCursor::Push(const char* sig, const char* sigEnd, size_t end)
+{
+    if ((depth + 1) >= MAX_DEPTH) {
+        return ER_BUS_BAD_SIGNATURE;
+    }
+    Level& level = levels[++depth];
+    level.sigStart = sig;
+    level.sig = sig;
+    level.sigEnd = sigEnd;
+    level.end = end;
+    return ER_OK;
+}
+
+void MsgArgCursor::Next(const char* sigNext)
+{
+    Level& level = levels[depth];
+    level.sig = sigNext;
+    /* Array elements all have the same type */
+    if (level.end && (level.sig >= level.sigEnd) && (pos < level.end)) {
+        level.sig = level.sigStart;
+    }
+}
+
+QStatus MsgArgCursor::Seek(size_t index)
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    depth = 0;
+    pos = 0;
+    levels[0].sig = levels[0].sigStart;
+    for (size_t i = 0; i < index; ++i) {
+        if (AtEnd()) {
+            return ER_BUS_SIGNATURE_MISMATCH;
+        }
+        QStatus result = Skip();
+        if (result != ER_OK) {
+            return result;
+        }
+    }
+    return AtEnd() ? ER_BUS_SIGNATURE_MISMATCH : ER_OK;
+}
+
+QStatus MsgArgCursor::Skip()
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    if (AtEnd()) {
+        return ER_BUS_NO_SUCH_OBJECT;
+    }
+    const char* sig = levels[depth].sig;
+    QStatus result = ER_OK;
+    switch (*sig) {
+    case ALLJOYN_ARRAY:
+        {
+            uint32_t len;
+            const char* sigNext = sig + 1;
+            result = SignatureUtils::ParseCompleteType(sigNext);
+            if (result == ER_OK) {
+                result = ReadUint32(len);
+            }
+            if (result == ER_OK) {
+                result = Align(SignatureUtils::AlignmentForType(static_cast<AllJoynTypeId>(sig[1])));
+            }
+            if (result == ER_OK) {
+                if ((len > ALLJOYN_MAX_ARRAY_LEN) || (len > (bodyLen - pos))) {
+                    result = ER_BUS_BAD_LENGTH;
+                } else {
+                    pos += len;
+                    Next(sigNext);
+                }
+            }
+        }
+        break;
+
+    case ALLJOYN_STRUCT_OPEN:
+    case ALLJOYN_DICT_ENTRY_OPEN:
+    case ALLJOYN_VARIANT:
+        result = Enter();
+        if (result == ER_OK) {
+            result = Exit();
+        }
+        break;
+
+    default:
+        {
+            /* All basic types can be decoded without allocating anything */
+            MsgArg arg;
+            result = Get(arg);
+        }
+        break;
+    }
+    return result;
+}
+
+QStatus MsgArgCursor::Get(MsgArg& arg)
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    if (AtEnd()) {
+        return ER_BUS_NO_SUCH_OBJECT;
+    }
+    QStatus result = ER_OK;
+    const char* sig = levels[depth].sig;
+    AllJoynTypeId typeId = static_cast<AllJoynTypeId>(*sig);
+
+    arg.Clear();
+    switch (typeId) {
+    case ALLJOYN_BYTE:
+        if (pos >= bodyLen) {
+            result = ER_BUS_BAD_LENGTH;
+        } else {
+            arg.v_byte = body[pos++];
+        }
+        break;
+
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+        result = Align(2);
+        if ((result == ER_OK) && ((bodyLen - pos) < 2)) {
+            result = ER_BUS_BAD_LENGTH;
+        }
+        if (result == ER_OK) {
+            arg.v_uint16 = *reinterpret_cast<const uint16_t*>(body + pos);
+            if (endianSwap) {
+                arg.v_uint16 = EndianSwap16(arg.v_uint16);
+            }
+            pos += 2;
+        }
+        break;
+
+    case ALLJOYN_BOOLEAN:
+        {
+            uint32_t v = 0;
+            result = ReadUint32(v);
+            if ((result == ER_OK) && (v > 1)) {
+                result = ER_BUS_BAD_VALUE;
+            }
+            arg.v_bool = (v == 1);
+        }
+        break;
+
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+        result = ReadUint32(arg.v_uint32);
+        break;
+
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_UINT64:
+    case ALLJOYN_INT64:
+        result = Align(8);
+        if ((result == ER_OK) && ((bodyLen - pos) < 8)) {
+            result = ER_BUS_BAD_LENGTH;
+        }
+        if (result == ER_OK) {
+            arg.v_uint64 = *reinterpret_cast<const uint64_t*>(body + pos);
+            if (endianSwap) {
+                arg.v_uint64 = EndianSwap64(arg.v_uint64);
+            }
+            pos += 8;
+        }
+        break;
+
+    case ALLJOYN_OBJECT_PATH:
+    case ALLJOYN_STRING:
+        {
+            uint32_t len = 0;
+            result = ReadUint32(len);
+            if (result == ER_OK) {
+                if (len >= (bodyLen - pos)) {
+                    result = ER_BUS_BAD_LENGTH;
+                } else if (body[pos + len] != 0) {
+                    result = ER_BUS_NOT_NUL_TERMINATED;
+                } else {
+                    arg.v_string.str = reinterpret_cast<const char*>(body + pos);
+                    arg.v_string.len = len;
+                    pos += len + 1;
+                }
+            }
+        }
+        break;
+
+    case ALLJOYN_SIGNATURE:
+        if (pos >= bodyLen) {
+            result = ER_BUS_BAD_LENGTH;
+        } else {
+            size_t len = body[pos];
+            if ((len + 1) >= (bodyLen - pos)) {
+                result = ER_BUS_BAD_LENGTH;
+            } else if (body[pos + 1 + len] != 0) {
+                result = ER_BUS_NOT_NUL_TERMINATED;
+            } else {
+                arg.v_signature.sig = reinterpret_cast<const char*>(body + pos + 1);
+                arg.v_signature.len = static_cast<uint8_t>(len);
+                pos += len + 2;
+            }
+        }
+        break;
+
+    case ALLJOYN_HANDLE:
+        {
+            uint32_t index = 0;
+            result = ReadUint32(index);
+            if (result == ER_OK) {
+                arg.v_handle.fd = msg->GetHandle(index);
+                if (arg.v_handle.fd == qcc::INVALID_SOCKET_FD) {
+                    result = ER_BUS_NO_SUCH_HANDLE;
+                }
+            }
+        }
+        break;
+
+    case ALLJOYN_ARRAY:
+    case ALLJOYN_STRUCT_OPEN:
+    case ALLJOYN_DICT_ENTRY_OPEN:
+    case ALLJOYN_VARIANT:
+        return ER_BUS_BAD_VALUE_TYPE;
+
+    default:
+        result = ER_BUS_BAD_SIGNATURE;
+        break;
+    }
+    if (result == ER_OK) {
+        arg.typeId = typeId;
+        Next(sig + 1);
+    } else {
+        arg.Clear();
+        QCC_LogError(result, ("Message arg parse error at or near %lu", static_cast<unsigned long>(pos)));
+    }
+    return result;
+}
+
+QStatus MsgArgCursor::Enter()
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    if (AtEnd()) {
+        return ER_BUS_NO_SUCH_OBJECT;
+    }
+    QStatus result = ER_OK;
+    const char* sig = levels[depth].sig;
+    switch (*sig) {
+    case ALLJOYN_ARRAY:
+        {
+            uint32_t len;
+            const char* elemSig = sig + 1;
+            const char* sigNext = elemSig;
+            result = SignatureUtils::ParseCompleteType(sigNext);
+            if (result == ER_OK) {
+                result = ReadUint32(len);
+            }
+            if (result == ER_OK) {
+                result = Align(SignatureUtils::AlignmentForType(static_cast<AllJoynTypeId>(*elemSig)));
+            }
+            if (result == ER_OK) {
+                if ((len > ALLJOYN_MAX_ARRAY_LEN) || (len > (bodyLen - pos))) {
+                    result = ER_BUS_BAD_LENGTH;
+                } else {
+                    Next(sigNext);
+                    result = Push(elemSig, sigNext, pos + len);
+                }
+            }
+        }
+        break;
+
+    case ALLJOYN_STRUCT_OPEN:
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        {
+            const char* sigNext = sig;
+            result = SignatureUtils::ParseCompleteType(sigNext);
+            if (result == ER_OK) {
+                result = Align(8);
+            }
+            if (result == ER_OK) {
+                Next(sigNext);
+                /* The members are between the brackets */
+                result = Push(sig + 1, sigNext - 1, 0);
+            }
+        }
+        break;
+
+    case ALLJOYN_VARIANT:
+        if (pos >= bodyLen) {
+            result = ER_BUS_BAD_LENGTH;
+        } else {
+            size_t len = body[pos];
+            const char* vsig = reinterpret_cast<const char*>(body + pos + 1);
+            if ((len + 1) >= (bodyLen - pos)) {
+                result = ER_BUS_BAD_LENGTH;
+            } else if (vsig[len] != 0) {
+                result = ER_BUS_NOT_NUL_TERMINATED;
+            } else if (!SignatureUtils::IsCompleteType(vsig)) {
+                result = ER_BUS_BAD_SIGNATURE;
+            } else {
+                pos += len + 2;
+                Next(sig + 1);
+                result = Push(vsig, vsig + len, 0);
+            }
+        }
+        break;
+
+    default:
+        return ER_BUS_BAD_VALUE_TYPE;
+    }
+    if (result != ER_OK) {
+        QCC_LogError(result, ("Message arg parse error at or near %lu", static_cast<unsigned long>(pos)));
+    }
+    return result;
+}
+
+QStatus MsgArgCursor::Exit()
+{
+    if (status != ER_OK) {
+        return status;
+    }
+    if (depth == 0) {
+        return ER_BUS_NO_SUCH_OBJECT;
+    }
+    if (levels[depth].end) {
+        pos = levels[depth].end;
+    } else {
+        while (!AtEnd()) {
+            QStatus result = Skip();
+            if (result != ER_OK) {
+                return result;
+            }
+        }
+    }
+    --depth;
+    Next(levels[depth].sig);
+    return ER_OK;
+}
+
+}
@@ -0,0 +1,184 @@
+#ifndef _ALLJOYN_MSGARGCURSOR_H
+#define _ALLJOYN_MSGARGCURSOR_H
+/**
+ * @file
+ * This file defines a cursor for reading individual arguments from a
+ * marshaled message body.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include MsgArgCursor.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArg.h>
+
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+/**
+ * %MsgArgCursor reads the arguments of a message straight from the marshaled
+ * body without building the MsgArg array that _Message::UnmarshalArgs()
+ * creates. Arguments that are not of interest are skipped using the
+ * signature and alignment rules and only the values that are asked for are
+ * decoded.
+ *
+ * The cursor never modifies the message so, unlike UnmarshalArgs(), it can be
+ * used on a message that is shared with other threads. Received encrypted
+ * messages that have not been unmarshaled yet are the exception: decryption
+ * happens in place, so the cursor decrypts a private copy of the message.
+ *
+ * Values returned by Get() point into the message buffer and are only valid
+ * as long as the cursor or the message is alive.
+ */
+class MsgArgCursor {
+  public:
+
+    /**
+     * Create a cursor positioned on the first argument of a message.
+     *
+     * @param msg   The message to read.
+     */
+    MsgArgCursor(const Message& msg);
+
+    /**
+     * Check if the message body could be accessed.
+     *
+     * @return
+     *      - #ER_OK if the body is ready to be read
+     *      - An error status otherwise
+     */
+    QStatus GetStatus() const { return status; }
+
+    /**
+     * Get the type of the value at the cursor. Structs and dictionary entries
+     * are reported as #ALLJOYN_STRUCT and #ALLJOYN_DICT_ENTRY.
+     *
+     * @return  The type of the value or #ALLJOYN_INVALID if there are no more
+     *          values in the current container.
+     */
+    AllJoynTypeId GetTypeId() const;
+
+    /**
+     * Check if all of the values in the current container have been read.
+     *
+     * @return  true if there are no more values in the current container.
+     */
+    bool AtEnd() const;
+
+    /**
+     * Move the cursor to one of the top level arguments of the message.
+     *
+     * @param index   Index of the argument, 0 for the first one.
+     *
+     * @return
+     *      - #ER_OK if the cursor is on the argument
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the message has fewer arguments
+     *      - An error status if the body is malformed
+     */
+    QStatus Seek(size_t index);
+
+    /**
+     * Step over the value at the cursor without decoding it.
+     *
+     * @return
+     *      - #ER_OK if the value was skipped
+     *      - An error status if the body is malformed or there is no value
+     */
+    QStatus Skip();
+
+    /**
+     * Decode the value at the cursor and advance to the next value. Only
+     * basic types can be decoded, containers must be read with Enter().
+     * String values point into the message buffer.
+     *
+     * @param arg   Returns the value.
+     *
+     * @return
+     *      - #ER_OK if the value was decoded
+     *      - #ER_BUS_BAD_VALUE_TYPE if the value is a container
+     *      - An error status if the body is malformed or there is no value
+     */
+    QStatus Get(MsgArg& arg);
+
+    /**
+     * Move into the array, struct, dictionary entry or variant at the cursor.
+     * The cursor is then positioned on the first value in the container.
+     *
+     * @return
+     *      - #ER_OK if the cursor is in the container
+     *      - #ER_BUS_BAD_VALUE_TYPE if the value is not a container
+     *      - An error status if the body is malformed or there is no value
+     */
+    QStatus Enter();
+
+    /**
+     * Skip the remaining values in the current container and move the cursor
+     * to the value after it.
+     *
+     * @return
+     *      - #ER_OK if the cursor left the container
+     *      - An error status if the body is malformed or the cursor is not in
+     *        a container
+     */
+    QStatus Exit();
+
+  private:
+
+    /**
+     * Containers can be nested 32 arrays and 32 structs deep
+     */
+    static const size_t MAX_DEPTH = 64;
+
+    /**
+     * Signature and extent of a container the cursor is in. The message body
+     * is the outermost level.
+     */
+    struct Level {
+        const char* sigStart;   /**< First type in the container, where array elements restart */
+        const char* sig;        /**< Type of the value at the cursor */
+        const char* sigEnd;     /**< End of the types in the container */
+        size_t end;             /**< Offset of the end of an array, 0 if the container is not an array */
+    };
+
+    /* Prevent copy construction and assignment */
+    MsgArgCursor(const MsgArgCursor& other);
+    MsgArgCursor& operator=(const MsgArgCursor& other);
+
+    QStatus Align(size_t alignment);
+    QStatus ReadUint32(uint32_t& value);
+    QStatus Push(const char* sig, const char* sigEnd, size_t end);
+    void Next(const char* sigNext);
+
+    Message msg;                /**< Keeps the message buffer alive */
+    const uint8_t* body;        /**< The marshaled body */
+    size_t bodyLen;             /**< Length of the marshaled body */
+    size_t pos;                 /**< Offset of the cursor in the body */
+    bool endianSwap;            /**< True if the body is in non-native endianess */
+    Level levels[MAX_DEPTH];    /**< The containers the cursor is in */
+    size_t depth;               /**< Index of the innermost container in levels */
+    QStatus status;             /**< Status of accessing the body */
+};
+
+}
+
+#endif
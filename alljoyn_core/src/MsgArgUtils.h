@@ -27,6 +27,7 @@
 
 #include <qcc/platform.h>
 #include <qcc/String.h>
+#include <qcc/Util.h>
 #include <stdarg.h>
 #include <alljoyn/Status.h>
 
@@ -53,6 +54,18 @@ class MsgArgUtils {
      */
     static QStatus SetV(MsgArg* args, size_t& numArgs, const char* signature, va_list* argp);
 
+    /**
+     * Compute a 64 bit hash of the type and value of a MsgArg. Two MsgArgs
+     * that compare equal have the same hash so it can be used to recognize
+     * values that were seen before without parsing them again.
+     *
+     * @param arg   The MsgArg to hash.
+     * @param hash  Hash to continue from, used when hashing a series of MsgArgs.
+     *
+     * @return  The hash of the MsgArg.
+     */
+    static uint64_t Hash(const MsgArg& arg, uint64_t hash = qcc::FNV1A_64_INIT);
+
 };
 
 }
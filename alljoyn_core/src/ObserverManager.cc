@@ -23,6 +23,7 @@
 #include "ObserverManager.h"
 #include "CoreObserver.h"
 #include "BusInternal.h"
+#include "MsgArgUtils.h"
 
 #include <algorithm>
 
@@ -84,14 +85,14 @@ struct ObserverManager::WorkItem {
 struct ObserverManager::AnnouncementWork : public ObserverManager::WorkItem {
 
     ObserverManager::Peer peer;
-    ObserverManager::ObjectSet announced;
+    ObserverManager::SharedObjectSet announced;
 
     AnnouncementWork(const qcc::String& busname, SessionPort port,
-                     const ObserverManager::ObjectSet& announced)
+                     const ObserverManager::SharedObjectSet& announced)
         : peer(busname, port), announced(announced) { }
     virtual ~AnnouncementWork() { }
     void Execute() {
-        mgr->ProcessAnnouncement(peer, announced);
+        mgr->ProcessAnnouncement(peer, *announced);
     }
 };
 
@@ -340,6 +341,7 @@ void ObserverManager::ProcessRegisterObserver(CoreObserver* observer)
         /* first observer for this particular set of mandatory interfaces */
         ic = new InterfaceCombination(this, observer->mandatory);
         combinations[observer->mandatory] = ic;
+        IndexCombination(ic);
         const char** intfs = SetToArray(observer->mandatory);
         bus.WhoImplementsNonBlocking(intfs, observer->mandatory.size());
         delete[] intfs;
@@ -374,11 +376,15 @@ void ObserverManager::ProcessUnregisterObserver(CoreObserver* observer)
         if (!keep) {
             /* clean up everything related to this InterfaceCombination */
             combinations.erase(it);
+            UnindexCombination(ic);
             const char** intfs = SetToArray(observer->mandatory);
             bus.CancelWhoImplementsNonBlocking(intfs, observer->mandatory.size());
             delete[] intfs;
+            /* only peers implementing the index key of the combination can have
+             * lost their relevance */
+            qcc::String key = ic->key;
             delete ic;
-            CheckRelevanceAllPeers();
+            CheckRelevanceAllPeers(key);
         }
     } else {
         QCC_LogError(ER_FAIL, ("Unregistering an observer that was not registered"));
@@ -431,6 +437,7 @@ void ObserverManager::HandleNewPeerAnnouncement(const Peer& peer, const ObjectSe
     /* add to list of pending peers and wait for the session to be established */
     std::pair<DiscoveryMap::iterator, bool> inserted =
         pending.insert(std::make_pair(peer, announced));
+    UpdatePeerIndex(peer, ObjectSet(), announced);
     Peer* ctx = new Peer(peer);
 
     SessionOpts opts(SessionOpts::TRAFFIC_MESSAGES, false,
@@ -440,7 +447,7 @@ void ObserverManager::HandleNewPeerAnnouncement(const Peer& peer, const ObjectSe
     if (ER_OK != status) {
         /* could not set up session. abort. */
         QCC_LogError(status, ("JoinSessionAsync invocation failed"));
-        pending.erase(inserted.first);
+        ErasePeer(pending, inserted.first);
         delete ctx;
     }
 }
@@ -455,34 +462,69 @@ void ObserverManager::HandlePendingPeerAnnouncement(DiscoveryMap::iterator peeri
          * has removed its last object of interest. We'll replace the
          * announced object set with an empty set to indicate to the
          * SessionEstablished callback that it can discard the session. */
-        peerit->second.clear();
+        UpdatePeerObjects(peerit, ObjectSet());
         return;
     }
 
     /* simply update the set of announced objects */
-    peerit->second = announced;
+    UpdatePeerObjects(peerit, announced);
 }
 
 void ObserverManager::HandleActivePeerAnnouncement(DiscoveryMap::iterator peerit, const ObjectSet& announced)
 {
     QCC_DbgTrace(("%s(%s)", __FUNCTION__, peerit->first.busname.c_str()));
-    ObjectSet previous = peerit->second;
+    const ObjectSet& previous = peerit->second;
+    SessionId sessionid = peerit->first.sessionid;
 
+    /* both sets are ordered by object id, so a single merge pass tells us which
+     * objects were added, which were removed and which changed their interfaces */
     ObjectSet added, removed;
-    set_difference(announced.begin(), announced.end(),
-                   previous.begin(), previous.end(),
-                   std::inserter(added, added.begin()));
-    set_difference(previous.begin(), previous.end(),
-                   announced.begin(), announced.end(),
-                   std::inserter(removed, removed.begin()));
+    std::vector<std::pair<ObjectSet::const_iterator, ObjectSet::const_iterator> > changed;
+    ObjectSet::const_iterator pit = previous.begin();
+    ObjectSet::const_iterator ait = announced.begin();
+    while ((pit != previous.end()) || (ait != announced.end())) {
+        if ((ait == announced.end()) || ((pit != previous.end()) && (*pit < *ait))) {
+            removed.insert(removed.end(), *pit++);
+        } else if ((pit == previous.end()) || (*ait < *pit)) {
+            added.insert(added.end(), *ait++);
+        } else {
+            if (pit->implements != ait->implements) {
+                changed.push_back(std::make_pair(pit, ait));
+            }
+            ++pit;
+            ++ait;
+        }
+    }
 
-    CombinationMap::iterator cit;
-    for (cit = combinations.begin(); cit != combinations.end(); ++cit) {
-        cit->second->ObjectsLost(removed);
+    if (added.empty() && removed.empty() && changed.empty()) {
+        /* a re-announcement of what we already know */
+        QCC_DbgPrintf(("no changes"));
+        return;
     }
-    bool relevant = false;
-    for (cit = combinations.begin(); cit != combinations.end(); ++cit) {
-        relevant = cit->second->ObjectsDiscovered(added, peerit->first.sessionid) || relevant;
+
+    NotifyObjectsLost(removed);
+    bool relevant = NotifyObjectsDiscovered(added, sessionid);
+
+    /* an object that changed its interfaces is lost for the combinations it is
+     * no longer relevant to, and discovered for the ones it has become relevant to */
+    std::vector<InterfaceCombination*> before, after, diff;
+    for (size_t i = 0; i < changed.size(); ++i) {
+        GetRelevantCombinations(*changed[i].first, before);
+        GetRelevantCombinations(*changed[i].second, after);
+        relevant = relevant || !after.empty();
+
+        diff.clear();
+        set_difference(before.begin(), before.end(), after.begin(), after.end(),
+                       std::back_inserter(diff));
+        for (std::vector<InterfaceCombination*>::iterator cit = diff.begin(); cit != diff.end(); ++cit) {
+            (*cit)->ObjectLost(*changed[i].first);
+        }
+        diff.clear();
+        set_difference(after.begin(), after.end(), before.begin(), before.end(),
+                       std::back_inserter(diff));
+        for (std::vector<InterfaceCombination*>::iterator cit = diff.begin(); cit != diff.end(); ++cit) {
+            (*cit)->ObjectDiscovered(*changed[i].second, sessionid);
+        }
     }
 
     if (!relevant) {
@@ -495,51 +537,199 @@ void ObserverManager::HandleActivePeerAnnouncement(DiscoveryMap::iterator peerit
         /* this peer is no longer relevant to us, tear down session and remove from the
          * active peer list */
         QCC_DbgPrintf(("not relevant"));
-        bus.LeaveJoinedSessionAsync(peerit->first.sessionid, this, NULL);
+        bus.LeaveJoinedSessionAsync(sessionid, this, NULL);
         pinger->RemoveDestination(PING_GROUP, peerit->first.busname);
-        active.erase(peerit);
+        ErasePeer(active, peerit);
     } else {
         /* update the set of discovered objects */
-        peerit->second = announced;
+        UpdatePeerObjects(peerit, announced);
     }
 }
 
 bool ObserverManager::CheckRelevance(const ObjectSet& objects)
 {
-    ObjectSet::iterator oit;
+    std::vector<InterfaceCombination*> relevant;
+    ObjectSet::const_iterator oit;
     for (oit = objects.begin(); oit != objects.end(); ++oit) {
-        CombinationMap::iterator cit;
-        for (cit = combinations.begin(); cit != combinations.end(); ++cit) {
-            if (oit->ImplementsAll(cit->second->interfaces)) {
-                return true;
-            }
+        GetRelevantCombinations(*oit, relevant);
+        if (!relevant.empty()) {
+            return true;
         }
     }
     return false;
 }
 
-void ObserverManager::CheckRelevanceAllPeers()
+void ObserverManager::GetRelevantCombinations(const DiscoveredObject& object,
+                                              std::vector<InterfaceCombination*>& relevant) const
+{
+    relevant.clear();
+    /* the empty key holds the combinations without mandatory interfaces, if any */
+    CombinationIndex::const_iterator cit = combinationIndex.find(qcc::String());
+    if (cit != combinationIndex.end()) {
+        relevant.insert(relevant.end(), cit->second.begin(), cit->second.end());
+    }
+    InterfaceSet::const_iterator iit;
+    for (iit = object.implements.begin(); iit != object.implements.end(); ++iit) {
+        cit = combinationIndex.find(*iit);
+        if (cit == combinationIndex.end()) {
+            continue;
+        }
+        std::vector<InterfaceCombination*>::const_iterator icit;
+        for (icit = cit->second.begin(); icit != cit->second.end(); ++icit) {
+            if (object.ImplementsAll((*icit)->interfaces)) {
+                relevant.push_back(*icit);
+            }
+        }
+    }
+    /* every combination is filed under exactly one key, so there are no duplicates */
+    sort(relevant.begin(), relevant.end());
+}
+
+bool ObserverManager::NotifyObjectsDiscovered(const ObjectSet& objects, SessionId sessionid)
+{
+    bool relevant = false;
+    std::vector<InterfaceCombination*> combos;
+    ObjectSet::const_iterator oit;
+    for (oit = objects.begin(); oit != objects.end(); ++oit) {
+        QCC_DbgPrintf(("Checking object %s:%s", oit->id.uniqueBusName.c_str(), oit->id.objectPath.c_str()));
+        GetRelevantCombinations(*oit, combos);
+        if (combos.empty()) {
+            QCC_DbgPrintf(("Not relevant..."));
+            continue;
+        }
+        relevant = true;
+        std::vector<InterfaceCombination*>::iterator cit;
+        for (cit = combos.begin(); cit != combos.end(); ++cit) {
+            (*cit)->ObjectDiscovered(*oit, sessionid);
+        }
+    }
+    return relevant;
+}
+
+void ObserverManager::NotifyObjectsLost(const ObjectSet& objects)
 {
-    DiscoveryMap::iterator it;
-    for (it = pending.begin(); it != pending.end(); ++it) {
-        bool relevant = CheckRelevance(it->second);
-        if (!relevant) {
-            it->second.clear();
+    std::vector<InterfaceCombination*> combos;
+    ObjectSet::const_iterator oit;
+    for (oit = objects.begin(); oit != objects.end(); ++oit) {
+        GetRelevantCombinations(*oit, combos);
+        std::vector<InterfaceCombination*>::iterator cit;
+        for (cit = combos.begin(); cit != combos.end(); ++cit) {
+            (*cit)->ObjectLost(*oit);
         }
     }
+}
 
-    std::vector<DiscoveryMap::iterator> irrelevant;
-    for (it = active.begin(); it != active.end(); ++it) {
-        bool relevant = CheckRelevance(it->second);
-        if (!relevant) {
-            irrelevant.push_back(it);
+void ObserverManager::IndexCombination(InterfaceCombination* ic)
+{
+    /* file the combination under the interface implemented by the fewest known
+     * peers, so it is considered for as few objects as possible */
+    size_t fewest = 0;
+    ic->key = qcc::String();
+    InterfaceSet::const_iterator it;
+    for (it = ic->interfaces.begin(); it != ic->interfaces.end(); ++it) {
+        PeerIndex::const_iterator pit = peerIndex.find(*it);
+        size_t count = (pit == peerIndex.end()) ? 0 : pit->second.size();
+        if ((it == ic->interfaces.begin()) || (count < fewest)) {
+            ic->key = *it;
+            fewest = count;
         }
     }
-    for (std::vector<DiscoveryMap::iterator>::iterator iit = irrelevant.begin();
-         iit != irrelevant.end(); ++iit) {
-        bus.LeaveJoinedSessionAsync((*iit)->first.sessionid, this, NULL);
-        pinger->RemoveDestination(PING_GROUP, (*iit)->first.busname);
-        active.erase(*iit);
+    combinationIndex[ic->key].push_back(ic);
+}
+
+void ObserverManager::UnindexCombination(InterfaceCombination* ic)
+{
+    CombinationIndex::iterator cit = combinationIndex.find(ic->key);
+    if (cit == combinationIndex.end()) {
+        return;
+    }
+    std::vector<InterfaceCombination*>& combos = cit->second;
+    combos.erase(std::remove(combos.begin(), combos.end(), ic), combos.end());
+    if (combos.empty()) {
+        combinationIndex.erase(cit);
+    }
+}
+
+void ObserverManager::UpdatePeerObjects(DiscoveryMap::iterator peerit, const ObjectSet& objects)
+{
+    UpdatePeerIndex(peerit->first, peerit->second, objects);
+    peerit->second = objects;
+}
+
+void ObserverManager::ErasePeer(DiscoveryMap& peers, DiscoveryMap::iterator peerit)
+{
+    UpdatePeerIndex(peerit->first, peerit->second, ObjectSet());
+    announcementCacheLock.Lock(MUTEX_CONTEXT);
+    announcementCache.erase(peerit->first.busname);
+    announcementCacheLock.Unlock(MUTEX_CONTEXT);
+    peers.erase(peerit);
+}
+
+void ObserverManager::UpdatePeerIndex(const Peer& peer, const ObjectSet& previous, const ObjectSet& current)
+{
+    InterfaceSet before, after;
+    ObjectSet::const_iterator oit;
+    for (oit = previous.begin(); oit != previous.end(); ++oit) {
+        before.insert(oit->implements.begin(), oit->implements.end());
+    }
+    for (oit = current.begin(); oit != current.end(); ++oit) {
+        after.insert(oit->implements.begin(), oit->implements.end());
+    }
+
+    InterfaceSet::const_iterator iit;
+    for (iit = before.begin(); iit != before.end(); ++iit) {
+        if (after.find(*iit) != after.end()) {
+            continue;
+        }
+        PeerIndex::iterator pit = peerIndex.find(*iit);
+        if (pit != peerIndex.end()) {
+            pit->second.erase(peer);
+            if (pit->second.empty()) {
+                peerIndex.erase(pit);
+            }
+        }
+    }
+    for (iit = after.begin(); iit != after.end(); ++iit) {
+        if (before.find(*iit) == before.end()) {
+            peerIndex[*iit].insert(peer);
+        }
+    }
+}
+
+void ObserverManager::CheckRelevanceAllPeers(const qcc::String& intf)
+{
+    std::vector<Peer> candidates;
+    if (intf.empty()) {
+        DiscoveryMap::iterator it;
+        for (it = pending.begin(); it != pending.end(); ++it) {
+            candidates.push_back(it->first);
+        }
+        for (it = active.begin(); it != active.end(); ++it) {
+            candidates.push_back(it->first);
+        }
+    } else {
+        PeerIndex::iterator pit = peerIndex.find(intf);
+        if (pit != peerIndex.end()) {
+            candidates.assign(pit->second.begin(), pit->second.end());
+        }
+    }
+
+    /* the peer index changes as peers are dropped, hence the copy above */
+    std::vector<Peer>::iterator cit;
+    for (cit = candidates.begin(); cit != candidates.end(); ++cit) {
+        DiscoveryMap::iterator it = pending.find(*cit);
+        if (it != pending.end()) {
+            if (!CheckRelevance(it->second)) {
+                UpdatePeerObjects(it, ObjectSet());
+            }
+            continue;
+        }
+        it = active.find(*cit);
+        if ((it != active.end()) && !CheckRelevance(it->second)) {
+            bus.LeaveJoinedSessionAsync(it->first.sessionid, this, NULL);
+            pinger->RemoveDestination(PING_GROUP, it->first.busname);
+            ErasePeer(active, it);
+        }
     }
 }
 
@@ -599,9 +789,9 @@ void ObserverManager::Announced(const char* busName, uint16_t version,
     QCC_UNUSED(aboutDataArg);
     QCC_DbgPrintf(("Received announcement from '%s'", busName));
 
-    ObjectSet announced = ParseObjectDescriptionArg(busName, objectDescriptionArg);
+    SharedObjectSet announced = GetAnnouncedObjects(busName, objectDescriptionArg);
 #ifndef NDEBUG
-    for (ObjectSet::iterator it = announced.begin(); it != announced.end(); ++it) {
+    for (ObjectSet::iterator it = announced->begin(); it != announced->end(); ++it) {
         QCC_DbgPrintf(("- %s", it->id.objectPath.c_str()));
         for (InterfaceSet::iterator iit = it->implements.begin();
              iit != it->implements.end(); ++iit) {
@@ -615,6 +805,35 @@ void ObserverManager::Announced(const char* busName, uint16_t version,
     TriggerDoWork();
 }
 
+ObserverManager::SharedObjectSet ObserverManager::GetAnnouncedObjects(const qcc::String& busname, const MsgArg& arg)
+{
+    uint64_t hash = MsgArgUtils::Hash(arg);
+    SharedObjectSet objects;
+
+    announcementCacheLock.Lock(MUTEX_CONTEXT);
+    AnnouncementCache::iterator it = announcementCache.find(busname);
+    if ((it != announcementCache.end()) && (it->second.hash == hash) && (it->second.arg == arg)) {
+        objects = it->second.objects;
+        announcementCacheLock.Unlock(MUTEX_CONTEXT);
+        return objects;
+    }
+    announcementCacheLock.Unlock(MUTEX_CONTEXT);
+
+    *objects = ParseObjectDescriptionArg(busname, arg);
+
+    announcementCacheLock.Lock(MUTEX_CONTEXT);
+    if ((announcementCache.size() >= MAX_CACHED_ANNOUNCEMENTS) && (announcementCache.find(busname) == announcementCache.end())) {
+        /* Bus names do not say when they go away, make room by dropping any one of them */
+        announcementCache.erase(announcementCache.begin());
+    }
+    CachedAnnouncement& cached = announcementCache[busname];
+    cached.hash = hash;
+    cached.arg = arg;
+    cached.objects = objects;
+    announcementCacheLock.Unlock(MUTEX_CONTEXT);
+    return objects;
+}
+
 void ObserverManager::ProcessAnnouncement(const Peer& peer, const ObjectSet& announced)
 {
     QCC_DbgTrace(("%s", __FUNCTION__));
@@ -663,20 +882,17 @@ void ObserverManager::ProcessSessionEstablished(const ObserverManager::Peer& pee
     } else if (peerit->second.empty()) {
         /* in the time it took us to set up the session, the peer removed the last
          * of its relevant objects. */
-        pending.erase(peerit);
+        ErasePeer(pending, peerit);
         bus.LeaveJoinedSessionAsync(peer.sessionid, this, NULL);
     } else {
-        /* move peer from pending set to active set */
+        /* move peer from pending set to active set, the peer index is unaffected */
         DiscoveryMap::iterator newit = active.insert(std::make_pair(peer, peerit->second)).first;
         pending.erase(peerit);
         pinger->AddDestination(PING_GROUP, peer.busname);
 
         QCC_DbgPrintf(("Moving peer %s from pending to active state.", peer.busname.c_str()));
         /* notify interested observers of the newly announced objects */
-        CombinationMap::iterator cit;
-        for (cit = combinations.begin(); cit != combinations.end(); ++cit) {
-            cit->second->ObjectsDiscovered(newit->second, peer.sessionid);
-        }
+        NotifyObjectsDiscovered(newit->second, peer.sessionid);
     }
 }
 
@@ -690,7 +906,7 @@ void ObserverManager::ProcessSessionEstablishmentFailed(const ObserverManager::P
         QCC_LogError(ER_FAIL,
                      ("Unexpected: session establishment failed, but the peer is not part of the pending set"));
     } else {
-        pending.erase(peerit);
+        ErasePeer(pending, peerit);
     }
 }
 
@@ -714,13 +930,10 @@ void ObserverManager::ProcessSessionLost(SessionId sessionid)
     }
     if (peerit != active.end()) {
         /* remove from the active list, notify interested observers */
-        CombinationMap::iterator cit;
-        for (cit = combinations.begin(); cit != combinations.end(); ++cit) {
-            cit->second->ObjectsLost(peerit->second);
-        }
+        NotifyObjectsLost(peerit->second);
 
         pinger->RemoveDestination(PING_GROUP, peerit->first.busname);
-        active.erase(peerit);
+        ErasePeer(active, peerit);
     } else {
         QCC_LogError(ER_FAIL, ("Unexpected: lost a session we didn't ask for to begin with"));
     }
@@ -757,52 +970,25 @@ void ObserverManager::ProcessDestinationLost(const qcc::String& busname)
     if (peerit != active.end()) {
         /* remove from the active list, notify interested observers, drop session */
         bus.LeaveJoinedSessionAsync(peerit->first.sessionid, this, NULL);
-        CombinationMap::iterator cit;
-        for (cit = combinations.begin(); cit != combinations.end(); ++cit) {
-            cit->second->ObjectsLost(peerit->second);
-        }
-        active.erase(peerit);
+        NotifyObjectsLost(peerit->second);
+        ErasePeer(active, peerit);
     }
 }
 
-bool ObserverManager::InterfaceCombination::ObjectsDiscovered(const ObjectSet& objects, SessionId sessionid)
+void ObserverManager::InterfaceCombination::ObjectDiscovered(const DiscoveredObject& object, SessionId sessionid)
 {
-    bool relevant = false;
-
-    ObjectSet::iterator oit;
-    for (oit = objects.begin(); oit != objects.end(); ++oit) {
-        QCC_DbgPrintf(("Checking object %s:%s", oit->id.uniqueBusName.c_str(), oit->id.objectPath.c_str()));
-        if (!oit->ImplementsAll(interfaces)) {
-            QCC_DbgPrintf(("Not relevant..."));
-            continue;
-        }
-        relevant = true;
-
-        std::vector<CoreObserver*>::iterator it;
-        for (it = observers.begin(); it != observers.end(); ++it) {
-            (*it)->ObjectDiscovered(oit->id, oit->implements, sessionid);
-        }
+    std::vector<CoreObserver*>::iterator it;
+    for (it = observers.begin(); it != observers.end(); ++it) {
+        (*it)->ObjectDiscovered(object.id, object.implements, sessionid);
     }
-    return relevant;
 }
 
-bool ObserverManager::InterfaceCombination::ObjectsLost(const ObjectSet& objects)
+void ObserverManager::InterfaceCombination::ObjectLost(const DiscoveredObject& object)
 {
-    bool relevant = false;
-
-    ObjectSet::iterator oit;
-    for (oit = objects.begin(); oit != objects.end(); ++oit) {
-        if (!oit->ImplementsAll(interfaces)) {
-            continue;
-        }
-        relevant = true;
-
-        std::vector<CoreObserver*>::iterator it;
-        for (it = observers.begin(); it != observers.end(); ++it) {
-            (*it)->ObjectLost(oit->id);
-        }
+    std::vector<CoreObserver*>::iterator it;
+    for (it = observers.begin(); it != observers.end(); ++it) {
+        (*it)->ObjectLost(object.id);
     }
-    return relevant;
 }
 
 void ObserverManager::InterfaceCombination::AddObserver(CoreObserver* observer)
@@ -24,6 +24,7 @@
 #include <iterator>
 
 #include <qcc/String.h>
+#include <qcc/ManagedObj.h>
 #include <qcc/Mutex.h>
 #include <qcc/Condition.h>
 
@@ -154,11 +155,8 @@ class ObserverManager :
         }
 
         bool ImplementsAll(const InterfaceSet& interfaces) const {
-            InterfaceSet diff;
-            set_difference(interfaces.begin(), interfaces.end(),
-                           implements.begin(), implements.end(),
-                           std::inserter(diff, diff.begin()));
-            return diff.empty();
+            return std::includes(implements.begin(), implements.end(),
+                                 interfaces.begin(), interfaces.end());
         }
         bool ImplementsAny(const InterfaceSet& interfaces) const {
             InterfaceSet intersection;
@@ -187,6 +185,7 @@ class ObserverManager :
     };
     typedef std::set<DiscoveredObject> ObjectSet;
     typedef std::map<Peer, ObjectSet> DiscoveryMap;
+    typedef qcc::ManagedObj<ObjectSet> SharedObjectSet;
 
     /**
      * Data structure that keeps track of the common data for all
@@ -195,6 +194,7 @@ class ObserverManager :
     struct InterfaceCombination {
         ObserverManager* obsmgr;
         InterfaceSet interfaces;
+        qcc::String key;        /**< the interface under which the combination is indexed */
         std::vector<CoreObserver*> observers;
 
         InterfaceCombination(ObserverManager* mgr, const InterfaceSet& intfs) :
@@ -202,29 +202,28 @@ class ObserverManager :
         { }
 
         InterfaceCombination(const InterfaceCombination& other) :
-            obsmgr(other.obsmgr), interfaces(other.interfaces), observers(other.observers)
+            obsmgr(other.obsmgr), interfaces(other.interfaces), key(other.key), observers(other.observers)
         { }
 
         InterfaceCombination& operator=(const InterfaceCombination& other) {
             obsmgr = other.obsmgr;
             interfaces = other.interfaces;
+            key = other.key;
             observers = other.observers;
             return *this;
         }
 
         /**
-         * A set of objects is lost.
-         * Will trigger observer notifications if relevant.
-         * \return true if any of the objects is relevant to the observer at hand
+         * A relevant object is lost.
+         * Will trigger observer notifications.
          */
-        bool ObjectsLost(const ObserverManager::ObjectSet& objects);
+        void ObjectLost(const ObserverManager::DiscoveredObject& object);
 
         /**
-         * A set of objects is discovered.
-         * Will trigger observer notifications if relevant.
-         * \return true if any of the objects is relevant to the observer at hand
+         * A relevant object is discovered.
+         * Will trigger observer notifications.
          */
-        bool ObjectsDiscovered(const ObserverManager::ObjectSet& objects, SessionId sessionid);
+        void ObjectDiscovered(const ObserverManager::DiscoveredObject& object, SessionId sessionid);
 
         /**
          * A new observer is registered for this interface combination.
@@ -250,6 +249,22 @@ class ObserverManager :
     typedef std::map<InterfaceSet, InterfaceCombination*> CombinationMap;
     CombinationMap combinations;
 
+    /**
+     * The interface combinations, indexed by a single one of their interfaces.
+     * An object can only be relevant to a combination if it implements all of
+     * its interfaces, so only the combinations filed under the interfaces an
+     * object implements need to be considered.
+     */
+    typedef std::map<qcc::String, std::vector<InterfaceCombination*> > CombinationIndex;
+    CombinationIndex combinationIndex;
+
+    /**
+     * The pending and active peers, indexed by the interfaces their discovered
+     * objects implement.
+     */
+    typedef std::map<qcc::String, std::set<Peer> > PeerIndex;
+    PeerIndex peerIndex;
+
     /**
      * Discovered objects, waiting for a session with the peer to be set up.
      */
@@ -286,16 +301,93 @@ class ObserverManager :
     void HandleNewPeerAnnouncement(const Peer& peer, const ObjectSet& announced);
 
     /**
-     * Iterates over all pending and active peers to check whether they still hold
-     * any relevant objects for any of the remaining observers.
+     * Iterates over the pending and active peers that implement an interface to
+     * check whether they still hold any relevant objects for any of the remaining
+     * observers. An empty interface name means all peers.
      */
-    void CheckRelevanceAllPeers();
+    void CheckRelevanceAllPeers(const qcc::String& intf);
 
     /**
      * Checks whether any of the objects in the set holds relevance for a registered observer
      */
     bool CheckRelevance(const ObjectSet& objects);
 
+    /**
+     * Collects the interface combinations to which an object is relevant.
+     * The combinations are returned in ascending pointer order.
+     */
+    void GetRelevantCombinations(const DiscoveredObject& object,
+                                 std::vector<InterfaceCombination*>& relevant) const;
+
+    /**
+     * Notifies the interested observers of a set of discovered objects.
+     * \return true if any of the objects is relevant to a registered observer
+     */
+    bool NotifyObjectsDiscovered(const ObjectSet& objects, SessionId sessionid);
+
+    /**
+     * Notifies the interested observers of a set of lost objects.
+     */
+    void NotifyObjectsLost(const ObjectSet& objects);
+
+    /**
+     * Adds an interface combination to the combination index.
+     */
+    void IndexCombination(InterfaceCombination* ic);
+
+    /**
+     * Removes an interface combination from the combination index.
+     */
+    void UnindexCombination(InterfaceCombination* ic);
+
+    /**
+     * Replaces the set of objects discovered for a pending or active peer,
+     * keeping the peer index up to date.
+     */
+    void UpdatePeerObjects(DiscoveryMap::iterator peerit, const ObjectSet& objects);
+
+    /**
+     * Removes a pending or active peer, keeping the peer index up to date.
+     */
+    void ErasePeer(DiscoveryMap& peers, DiscoveryMap::iterator peerit);
+
+    /**
+     * Updates the peer index for a peer whose set of discovered objects
+     * changes from previous to current.
+     */
+    void UpdatePeerIndex(const Peer& peer, const ObjectSet& previous, const ObjectSet& current);
+
+    /**
+     * The last object description announced by a bus name and the objects
+     * parsed from it. Peers re-announce periodically, mostly without any
+     * change, so the parsed objects can usually be reused.
+     */
+    struct CachedAnnouncement {
+        uint64_t hash;              /**< MsgArgUtils::Hash() of the object description */
+        MsgArg arg;                 /**< The object description, to rule out hash collisions */
+        SharedObjectSet objects;    /**< The objects parsed from the object description */
+
+        CachedAnnouncement() : hash(0) { }
+    };
+    typedef std::map<qcc::String, CachedAnnouncement> AnnouncementCache;
+
+    /**
+     * Maximum number of bus names in the announcement cache
+     */
+    static const size_t MAX_CACHED_ANNOUNCEMENTS = 256;
+
+    AnnouncementCache announcementCache;   /**< Last announcement by bus name */
+    qcc::Mutex announcementCacheLock;      /**< Protects announcementCache */
+
+    /**
+     * Get the objects announced in an object description, parsing it only
+     * if it differs from the last one announced by the bus name.
+     *
+     * \param busname the bus name that sent the announcement
+     * \param arg the object description argument from the About announcement
+     */
+    SharedObjectSet GetAnnouncedObjects(const qcc::String& busname, const MsgArg& arg);
+
     /****************************
      * work queue related stuff *
      ****************************/
@@ -339,6 +339,48 @@ void _PeerState::SetGuildMetadata(const qcc::String& serial, const qcc::String&
         guildMap.erase(key);
     }
     guildMap[key] = guild;
+    ClearAuthorizationCache();
+}
+
+bool _PeerState::GetCachedAuthorization(uint32_t generation, const qcc::String& request, bool& authorized, uint32_t& clears)
+{
+    bool found = false;
+    authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    clears = authorizationCacheClears;
+    if (authorizationCacheGeneration == generation) {
+        std::map<qcc::String, bool>::iterator it = authorizationCache.find(request);
+        if (it != authorizationCache.end()) {
+            authorized = it->second;
+            found = true;
+        }
+    }
+    authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void _PeerState::CacheAuthorization(uint32_t generation, uint32_t clears, const qcc::String& request, bool authorized)
+{
+    authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    if (clears != authorizationCacheClears) {
+        /* The peer changed while the decision was being made */
+        authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+    /* Start over when the policy has changed or the cache is full */
+    if ((authorizationCacheGeneration != generation) || (authorizationCache.size() >= MAX_CACHED_AUTHORIZATIONS)) {
+        authorizationCache.clear();
+        authorizationCacheGeneration = generation;
+    }
+    authorizationCache[request] = authorized;
+    authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+}
+
+void _PeerState::ClearAuthorizationCache()
+{
+    authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    authorizationCache.clear();
+    ++authorizationCacheClears;
+    authorizationCacheLock.Unlock(MUTEX_CONTEXT);
 }
 
 _PeerState::GuildMetadata* _PeerState::GetGuildMetadata(const qcc::String& serial, const String& issuerAki)
@@ -127,7 +127,9 @@ class _PeerState {
         expectedSerial(0),
         isSecure(false),
         authEvent(NULL),
-        hashUtil(NULL)
+        hashUtil(NULL),
+        authorizationCacheGeneration(0),
+        authorizationCacheClears(0)
     {
         ::memset(window, 0, sizeof(window));
         ::memset(authorizations, 0, sizeof(authorizations));
@@ -177,6 +179,7 @@ class _PeerState {
     void SetGuidAndAuthVersion(const qcc::GUID128& newGuid, uint32_t authenticationVersion) {
         this->guid = newGuid;
         this->authVersion = authenticationVersion;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -188,6 +191,7 @@ class _PeerState {
     void SetKey(const qcc::KeyBlob& key, PeerKeyType keyType) {
         keys[keyType] = key;
         isSecure = key.IsValid();
+        ClearAuthorizationCache();
     }
 
     /**
@@ -220,6 +224,7 @@ class _PeerState {
         keys[PEER_SESSION_KEY].Erase();
         keys[PEER_GROUP_KEY].Erase();
         isSecure = false;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -297,6 +302,43 @@ class _PeerState {
         }
     }
 
+    /**
+     * Maximum number of authorization decisions cached for a peer.
+     */
+    static const size_t MAX_CACHED_AUTHORIZATIONS = 128;
+
+    /**
+     * Look up a cached decision of the permission manager for a message to or from this peer.
+     *
+     * @param generation  The permission manager generation the decision must have been made in.
+     * @param request     Identifies the object path, interface, member and kind of the message.
+     * @param authorized  Returns the cached decision.
+     * @param clears      Returns the number of times the cache has been cleared, to be passed
+     *                    to CacheAuthorization() if no decision was cached.
+     *
+     * @return  Returns true if a decision was cached.
+     */
+    bool GetCachedAuthorization(uint32_t generation, const qcc::String& request, bool& authorized, uint32_t& clears);
+
+    /**
+     * Cache a decision of the permission manager for a message to or from this peer.
+     *
+     * The decision is dropped if the cache was cleared while it was being made since it may
+     * be based on the keys, memberships or manifest that were replaced.
+     *
+     * @param generation  The permission manager generation the decision was made in.
+     * @param clears      The number of clears returned by GetCachedAuthorization() before the
+     *                    decision was made.
+     * @param request     Identifies the object path, interface, member and kind of the message.
+     * @param authorized  The decision.
+     */
+    void CacheAuthorization(uint32_t generation, uint32_t clears, const qcc::String& request, bool authorized);
+
+    /**
+     * Forget the cached authorization decisions. This must be called whenever the keys, the
+     * memberships or the manifest of the peer change.
+     */
+    void ClearAuthorizationCache();
 
     /**
      * Set the guild metadata indexed by the serial number and the issuer.
@@ -546,6 +588,26 @@ class _PeerState {
      * Mutex to protect the conversation hash
      */
     qcc::Mutex hashLock;
+
+    /**
+     * Authorization decisions made by the permission manager for this peer
+     */
+    std::map<qcc::String, bool> authorizationCache;
+
+    /**
+     * The permission manager generation the cached authorization decisions were made in
+     */
+    uint32_t authorizationCacheGeneration;
+
+    /**
+     * Number of times the authorization cache has been cleared
+     */
+    uint32_t authorizationCacheClears;
+
+    /**
+     * Mutex to protect the authorization cache
+     */
+    qcc::Mutex authorizationCacheLock;
 };
 
 
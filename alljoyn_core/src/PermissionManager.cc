@@ -25,6 +25,7 @@
 #include <alljoyn/PermissionPolicy.h>
 #include <qcc/Debug.h>
 #include "PermissionManager.h"
+#include "MsgArgCursor.h"
 #include "BusUtil.h"
 #include "KeyExchanger.h"
 #include "AuthMechSRP.h"
@@ -228,13 +229,17 @@ static bool IsRuleMatched(const PermissionPolicy::Rule& rule, const Request& req
     }
 }
 
-static bool IsPolicyAclMatched(const PermissionPolicy::Acl& acl, const Request& request, uint8_t requiredAuth, bool scanForDenied, bool& denied)
+/**
+ * Only the candidate rules picked by the policy index for the request's
+ * interface need to be checked. The other rules cannot match.
+ */
+static bool IsPolicyAclMatched(const PermissionPolicy::Acl& acl, const std::vector<size_t>& candidates, const Request& request, uint8_t requiredAuth, bool scanForDenied, bool& denied)
 {
     bool strictGetAllProperties = request.outgoing;
     const PermissionPolicy::Rule* rules = acl.GetRules();
     bool allowed = false;
-    for (size_t cnt = 0; cnt < acl.GetRulesSize(); cnt++) {
-        if (IsRuleMatched(rules[cnt], request, requiredAuth, scanForDenied, denied, strictGetAllProperties)) {
+    for (size_t cnt = 0; cnt < candidates.size(); cnt++) {
+        if (IsRuleMatched(rules[candidates[cnt]], request, requiredAuth, scanForDenied, denied, strictGetAllProperties)) {
             allowed = true; /* track it */
         } else if (denied) {
             /* skip the remainder of the search */
@@ -372,7 +377,7 @@ static bool IsPeerQualifiedForAcl(const PermissionPolicy::Acl& acl, PeerState& p
  * The peer is authorized if there is no applicable deny and at least one allow.
  */
 
-static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* policy, PeerState& peerState, bool trustedPeer, const qcc::ECCPublicKey* peerPublicKey, const std::vector<ECCPublicKey>& issuerChain, uint8_t requiredAuth, bool& denied)
+static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* policy, const PermissionPolicyIndex* policyIndex, PeerState& peerState, bool trustedPeer, const qcc::ECCPublicKey* peerPublicKey, const std::vector<ECCPublicKey>& issuerChain, uint8_t requiredAuth, bool& denied)
 {
     bool allowed = false;
     denied = false;
@@ -382,7 +387,7 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
         if (!IsPeerQualifiedForAcl(acls[cnt], peerState, trustedPeer, peerPublicKey, issuerChain, qualifiedPeerWithPublicKey)) {
             continue;
         }
-        if (IsPolicyAclMatched(acls[cnt], request, requiredAuth, qualifiedPeerWithPublicKey, denied)) {
+        if (IsPolicyAclMatched(acls[cnt], policyIndex->GetCandidateRules(cnt, request.iName), request, requiredAuth, qualifiedPeerWithPublicKey, denied)) {
             allowed = true;   /* track it */
         }
         if (denied) {
@@ -402,7 +407,7 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
  * 5. all peers
  */
 
-static bool IsAuthorized(const Request& request, const PermissionPolicy* policy, PeerState& peerState, PermissionMgmtObj* permissionMgmtObj)
+static bool IsAuthorized(const Request& request, const PermissionPolicy* policy, const PermissionPolicyIndex* policyIndex, PeerState& peerState, PermissionMgmtObj* permissionMgmtObj)
 {
     Right right;
     GenRight(request, right);
@@ -414,7 +419,7 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
     QCC_DbgPrintf(("IsAuthorized with required permission %d\n", right.authByPolicy));
 
     if (right.authByPolicy) {
-        if (policy == NULL) {
+        if ((policy == NULL) || (policyIndex == NULL)) {
             authorized = false;  /* no policy deny all */
             QCC_DbgPrintf(("Not authorized because of missing policy"));
             return false;
@@ -449,7 +454,7 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
                 }
             }
         }
-        authorized = IsPeerAuthorized(request, policy, peerState, trustedPeer, trustedPeerPublicKey, issuerPublicKeys, right.authByPolicy, denied);
+        authorized = IsPeerAuthorized(request, policy, policyIndex, peerState, trustedPeer, trustedPeerPublicKey, issuerPublicKeys, right.authByPolicy, denied);
 #ifndef NDEBUG
         for (_PeerState::GuildMap::iterator it = peerState->guildMap.begin(); it != peerState->guildMap.end(); it++) {
             _PeerState::GuildMetadata* metadata = it->second;
@@ -474,6 +479,40 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
     return authorized;
 }
 
+/**
+ * Build the key of a request in the peer's authorization cache. The decision
+ * depends on nothing else in the request.
+ */
+static String AuthorizationCacheKey(const Request& request)
+{
+    String key;
+    key += request.outgoing ? 'o' : 'i';
+    key += request.propertyRequest ? (request.isSetProperty ? 's' : 'p') : 'm';
+    key += (char)('0' + request.mbrType);
+    key += request.objPath ? request.objPath : "";
+    key += '\0';
+    key += request.iName ? request.iName : "";
+    key += '\0';
+    key += request.mbrName ? request.mbrName : "";
+    return key;
+}
+
+bool PermissionManager::IsAuthorizedCached(const Request& request, PeerState& peerState)
+{
+    uint32_t currentGeneration = (uint32_t)generation;
+    String key = AuthorizationCacheKey(request);
+    bool authorized;
+    uint32_t clears;
+    if (peerState->GetCachedAuthorization(currentGeneration, key, authorized, clears)) {
+        IncrementAndFetch(&cacheHits);
+        return authorized;
+    }
+    IncrementAndFetch(&cacheMisses);
+    authorized = IsAuthorized(request, GetPolicy(), policyIndex, peerState, permissionMgmtObj);
+    peerState->CacheAuthorization(currentGeneration, clears, key, authorized);
+    return authorized;
+}
+
 static bool IsStdInterface(const char* iName)
 {
     if (strcmp(iName, org::alljoyn::Bus::InterfaceName) == 0) {
@@ -531,6 +570,22 @@ static bool IsPermissionMgmtInterface(const char* iName)
     return false;
 }
 
+/*
+ * Read a string argument from the message body
+ */
+static QStatus GetStringArg(MsgArgCursor& cursor, const char*& str)
+{
+    if (cursor.AtEnd()) {
+        return ER_INVALID_DATA;
+    }
+    MsgArg arg;
+    QStatus status = cursor.Get(arg);
+    if (status == ER_OK) {
+        status = arg.Get("s", &str);
+    }
+    return status;
+}
+
 static QStatus ParsePropertiesMessage(Request& request, Message& msg)
 {
     QStatus status;
@@ -538,19 +593,15 @@ static QStatus ParsePropertiesMessage(Request& request, Message& msg)
     const char* propIName;
     const char* propName = "";
 
+    /*
+     * Only the leading interface and property names are needed. They are read
+     * straight from the marshaled body which is there for both incoming and
+     * outgoing messages.
+     */
+    MsgArgCursor cursor(msg);
     if (strncmp(mbrName, "GetAll", 6) == 0) {
         propName = NULL;
-        if (request.outgoing) {
-            const MsgArg* args;
-            size_t numArgs;
-            msg->GetRefArgs(numArgs, args);
-            if (numArgs < 1) {
-                return ER_INVALID_DATA;
-            }
-            status = args[0].Get("s", &propIName);
-        } else {
-            status = msg->GetArgs("s", &propIName);
-        }
+        status = GetStringArg(cursor, propIName);
         if (status != ER_OK) {
             return status;
         }
@@ -558,22 +609,12 @@ static QStatus ParsePropertiesMessage(Request& request, Message& msg)
         request.mbrType = PermissionPolicy::Rule::Member::PROPERTY;
         QCC_DbgPrintf(("PermissionManager::ParsePropertiesMessage %s %s", mbrName, propIName));
     } else if ((strncmp(mbrName, "Get", 3) == 0) || (strncmp(mbrName, "Set", 3) == 0)) {
-        const MsgArg* args;
-        size_t numArgs;
-        if (request.outgoing) {
-            msg->GetRefArgs(numArgs, args);
-        } else {
-            msg->GetArgs(numArgs, args);
-        }
-        if (numArgs < 2) {
-            return ER_INVALID_DATA;
-        }
         /* only interested in the first two arguments */
-        status = args[0].Get("s", &propIName);
+        status = GetStringArg(cursor, propIName);
         if (ER_OK != status) {
             return status;
         }
-        status = args[1].Get("s", &propName);
+        status = GetStringArg(cursor, propName);
         if (status != ER_OK) {
             return status;
         }
@@ -582,7 +623,7 @@ static QStatus ParsePropertiesMessage(Request& request, Message& msg)
         request.isSetProperty = (strncmp(mbrName, "Set", 3) == 0);
         QCC_DbgPrintf(("PermissionManager::ParsePropertiesMessage %s %s.%s", mbrName, propIName, propName));
     } else if (strncmp(mbrName, "PropertiesChanged", 17) == 0) {
-        status = msg->GetArg(0)->Get("s", &propIName);
+        status = GetStringArg(cursor, propIName);
         if (status != ER_OK) {
             return status;
         }
@@ -705,7 +746,7 @@ QStatus PermissionManager::AuthorizeMessage(bool outgoing, Message& msg, PeerSta
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage with outgoing: %d msg %s", outgoing, msg->ToString().c_str()));
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage: local policy %s", GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
-    authorized = IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj);
+    authorized = IsAuthorizedCached(request, peerState);
     if (!authorized) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeMessage IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
@@ -727,7 +768,7 @@ QStatus PermissionManager::AuthorizeGetProperty(const char* objPath, const char*
     QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty: ifc %s prop %s local policy %s", ifcName, propName, GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
     Request request(objPath, ifcName, propName, PermissionPolicy::Rule::Member::PROPERTY, false, true);
-    if (!IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj)) {
+    if (!IsAuthorizedCached(request, peerState)) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
     }
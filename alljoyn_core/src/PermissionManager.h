@@ -25,11 +25,15 @@
 #error Only include PermissionManager.h in C++ code.
 #endif
 
+#include <qcc/atomic.h>
 #include <alljoyn/PermissionPolicy.h>
 #include "PermissionMgmtObj.h"
+#include "PermissionPolicyIndex.h"
 
 namespace ajn {
 
+struct Request;
+
 class PermissionManager {
 
   public:
@@ -38,7 +42,7 @@ class PermissionManager {
      * Constructor
      *
      */
-    PermissionManager() : policy(NULL), permissionMgmtObj(NULL)
+    PermissionManager() : policy(NULL), policyIndex(NULL), permissionMgmtObj(NULL), generation(1), cacheHits(0), cacheMisses(0)
     {
     }
 
@@ -47,6 +51,7 @@ class PermissionManager {
      */
     virtual ~PermissionManager()
     {
+        delete policyIndex;
         delete policy;
     }
 
@@ -57,8 +62,12 @@ class PermissionManager {
 
     void SetPolicy(PermissionPolicy* policy)
     {
+        delete policyIndex;
+        policyIndex = policy ? new PermissionPolicyIndex(*policy) : NULL;
         delete this->policy;
         this->policy = policy;
+        /* Authorization decisions cached by the peers no longer apply */
+        qcc::IncrementAndFetch(&generation);
     }
 
     /**
@@ -103,6 +112,19 @@ class PermissionManager {
         return permissionMgmtObj;
     }
 
+    /**
+     * Get the number of authorization decisions that were found in and that were missing from
+     * the per peer decision caches.
+     *
+     * @param[out] hits    Number of decisions found in the caches.
+     * @param[out] misses  Number of decisions that had to be made against the policy.
+     */
+    void GetAuthorizationCacheStats(uint32_t& hits, uint32_t& misses) const
+    {
+        hits = (uint32_t)cacheHits;
+        misses = (uint32_t)cacheMisses;
+    }
+
   private:
     /* Private assigment operator to prevent double freeing of memory */
     PermissionManager& operator=(const PermissionManager& src);
@@ -111,8 +133,14 @@ class PermissionManager {
 
     bool AuthorizePermissionMgmt(bool outgoing, const char* iName, const char* mbrName, bool& authorized);
 
+    bool IsAuthorizedCached(const Request& request, PeerState& peerState);
+
     PermissionPolicy* policy;
+    PermissionPolicyIndex* policyIndex;    /**< Rules of the policy by interface name */
     PermissionMgmtObj* permissionMgmtObj;
+    volatile int32_t generation;     /**< Changes whenever the policy changes */
+    volatile int32_t cacheHits;      /**< Authorization decisions found in the peer caches */
+    volatile int32_t cacheMisses;    /**< Authorization decisions missing from the peer caches */
 };
 
 }
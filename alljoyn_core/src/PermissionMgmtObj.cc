@@ -1943,6 +1943,7 @@ QStatus PermissionMgmtObj::ParseSendManifest(Message& msg, PeerState& peerState)
     delete [] peerState->manifest;
     peerState->manifest = rules;
     peerState->manifestSize = count;
+    peerState->ClearAuthorizationCache();
     return ER_OK;  /* done */
 
 DoneValidation:
@@ -2009,6 +2010,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
         status = GetConnectedPeerPublicKey(peerState->GetGuid(), &peerPublicKey);
         if (ER_OK != status) {
             _PeerState::ClearGuildMap(peerState->guildMap);
+            peerState->ClearAuthorizationCache();
             done = true;
             return ER_OK;  /* could not validate */
         }
@@ -2051,6 +2053,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
                 break;  /* done */
             }
         }
+        peerState->ClearAuthorizationCache();
         done = true;
     }
     return ER_OK;
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * This file implements the index over the rules of an installed permission policy.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "PermissionPolicyIndex.h"
+
+#define QCC_MODULE "PERMISSION_MGMT"
+
+using namespace std;
+using namespace qcc;
+
+namespace ajn {
+
+PermissionPolicyIndex::PermissionPolicyIndex(const PermissionPolicy& policy) : acls(policy.GetAclsSize())
+{
+    const PermissionPolicy::Acl* policyAcls = policy.GetAcls();
+    for (size_t acl = 0; acl < policy.GetAclsSize(); ++acl) {
+        AclIndex& index = acls[acl];
+        const PermissionPolicy::Rule* rules = policyAcls[acl].GetRules();
+        for (size_t rule = 0; rule < policyAcls[acl].GetRulesSize(); ++rule) {
+            if ((rules[rule].GetMembersSize() == 0) || rules[rule].GetObjPath().empty()) {
+                continue;
+            }
+            String iName = rules[rule].GetInterfaceName();
+            if (iName.empty()) {
+                continue;
+            }
+            size_t wildcard = iName.find_first_of("*?");
+            if (wildcard == String::npos) {
+                index.exact[StringMapKey(iName)].push_back(rule);
+                continue;
+            }
+            size_t node = 0;
+            for (size_t i = 0; i < wildcard; ++i) {
+                map<char, size_t>::iterator child = index.prefixes[node].children.find(iName[i]);
+                if (child == index.prefixes[node].children.end()) {
+                    index.prefixes.push_back(PrefixNode(node));
+                    index.prefixes[node].children[iName[i]] = index.prefixes.size() - 1;
+                    node = index.prefixes.size() - 1;
+                } else {
+                    node = child->second;
+                }
+            }
+            index.prefixes[node].rules.push_back(rule);
+        }
+        /*
+         * Every node on the path spelled by an interface name holds rules
+         * whose literal prefix matches, so fold the rules of the ancestors
+         * into each node. Parents come before their children in the trie.
+         * The rules were added in ascending order so each list is sorted.
+         */
+        for (size_t node = 1; node < index.prefixes.size(); ++node) {
+            vector<size_t> merged;
+            const vector<size_t>& inherited = index.prefixes[index.prefixes[node].parent].rules;
+            vector<size_t>& own = index.prefixes[node].rules;
+            merge(inherited.begin(), inherited.end(), own.begin(), own.end(), back_inserter(merged));
+            own.swap(merged);
+        }
+        for (unordered_map<StringMapKey, vector<size_t> >::iterator it = index.exact.begin(); it != index.exact.end(); ++it) {
+            vector<size_t> merged;
+            const vector<size_t>& wild = index.Deepest(it->first.c_str()).rules;
+            merge(it->second.begin(), it->second.end(), wild.begin(), wild.end(), back_inserter(merged));
+            it->second.swap(merged);
+        }
+    }
+}
+
+const PermissionPolicyIndex::PrefixNode& PermissionPolicyIndex::AclIndex::Deepest(const char* iName) const
+{
+    size_t node = 0;
+    for (const char* c = iName; *c != '\0'; ++c) {
+        map<char, size_t>::const_iterator child = prefixes[node].children.find(*c);
+        if (child == prefixes[node].children.end()) {
+            break;
+        }
+        node = child->second;
+    }
+    return prefixes[node];
+}
+
+const vector<size_t>& PermissionPolicyIndex::GetCandidateRules(size_t acl, const char* iName) const
+{
+    if ((acl >= acls.size()) || !iName) {
+        return none;
+    }
+    const AclIndex& index = acls[acl];
+    unordered_map<StringMapKey, vector<size_t> >::const_iterator exact = index.exact.find(StringMapKey(iName));
+    if (exact != index.exact.end()) {
+        return exact->second;
+    }
+    return index.Deepest(iName).rules;
+}
+
+}
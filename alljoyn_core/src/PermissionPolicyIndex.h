@@ -0,0 +1,112 @@
+#ifndef _ALLJOYN_PERMISSIONPOLICYINDEX_H
+#define _ALLJOYN_PERMISSIONPOLICYINDEX_H
+/**
+ * @file
+ * This file defines an index over the rules of an installed permission policy.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include PermissionPolicyIndex.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <map>
+#include <vector>
+
+#include <qcc/STLContainer.h>
+#include <qcc/StringMapKey.h>
+
+#include <alljoyn/PermissionPolicy.h>
+
+namespace ajn {
+
+/**
+ * Index of the rules in each ACL of a permission policy by interface name.
+ *
+ * Rules that name an interface exactly are found through a hash table. Rules
+ * with a wildcard interface name are found through a trie of the literal
+ * text in front of the first wildcard. A rule can only match a message if
+ * its interface name does, so the index narrows down the rules that have to
+ * be evaluated without changing the outcome. Rules that can never match,
+ * i.e. those without an object path, an interface name or members, are left
+ * out altogether.
+ *
+ * The sorted list of candidates is worked out when the index is built, for
+ * every interface name in the hash table and for every node of the trie, so
+ * a lookup returns a list that is already there.
+ */
+class PermissionPolicyIndex {
+  public:
+
+    /**
+     * Build the index for a policy. The index refers to the rules by their
+     * position in the ACLs so it is only valid for as long as the policy
+     * is not changed.
+     *
+     * @param policy  The policy to index.
+     */
+    PermissionPolicyIndex(const PermissionPolicy& policy);
+
+    /**
+     * Get the rules of an ACL that may match a message on an interface.
+     *
+     * @param acl       Position of the ACL in the policy.
+     * @param iName     The interface name of the message.
+     *
+     * @return  The positions of the candidate rules in the ACL in ascending
+     *          order. The list is owned by the index.
+     */
+    const std::vector<size_t>& GetCandidateRules(size_t acl, const char* iName) const;
+
+  private:
+
+    /**
+     * Node of the trie of wildcard interface names
+     */
+    struct PrefixNode {
+        std::map<char, size_t> children;   /**< Position of the child node for each next character */
+        size_t parent;                     /**< Position of the parent node */
+        std::vector<size_t> rules;         /**< Sorted rules whose literal prefix ends at this node or an ancestor */
+
+        PrefixNode(size_t parent) : parent(parent) { }
+    };
+
+    /**
+     * Index of a single ACL
+     */
+    struct AclIndex {
+        std::unordered_map<qcc::StringMapKey, std::vector<size_t> > exact;   /**< Sorted candidates by exact interface name */
+        std::vector<PrefixNode> prefixes;                                    /**< The trie, the root is the first node */
+
+        AclIndex() : prefixes(1, PrefixNode(0)) { }
+
+        /**
+         * Find the deepest node on the path spelled by an interface name.
+         */
+        const PrefixNode& Deepest(const char* iName) const;
+    };
+
+    std::vector<AclIndex> acls;
+    std::vector<size_t> none;           /**< Returned for unknown ACLs */
+};
+
+}
+
+#endif
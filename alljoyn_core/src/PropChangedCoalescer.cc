@@ -0,0 +1,234 @@
+/**
+ * @file
+ *
+ * This file implements the class that batches the PropertiesChanged signals of a BusObject.
+ *
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <algorithm>
+
+#include <qcc/Debug.h>
+
+#include <alljoyn/BusObject.h>
+
+#include "PropChangedCoalescer.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+using namespace std;
+
+namespace ajn {
+
+/*
+ * Number of threads emitting coalesced PropertiesChanged signals for all of
+ * the BusObjects in the process.
+ */
+static const uint32_t COALESCER_THREADS = 2;
+
+static Timer* coalescerTimer = NULL;
+static Mutex* coalescerTimerLock = NULL;
+
+void PropChangedCoalescer::Init()
+{
+    coalescerTimer = new Timer("PropChanged", true, COALESCER_THREADS);
+    coalescerTimerLock = new Mutex();
+}
+
+void PropChangedCoalescer::Shutdown()
+{
+    coalescerTimer->Stop();
+    coalescerTimer->Join();
+    delete coalescerTimer;
+    coalescerTimer = NULL;
+    delete coalescerTimerLock;
+    coalescerTimerLock = NULL;
+}
+
+PropChangedCoalescer::PropChangedCoalescer(BusObject& obj) :
+    obj(obj),
+    interval(0),
+    maxBatch(0),
+    scheduled(false),
+    stopped(false)
+{
+}
+
+PropChangedCoalescer::~PropChangedCoalescer()
+{
+    Stop();
+}
+
+QStatus PropChangedCoalescer::Configure(uint32_t interval, size_t maxBatch)
+{
+    QStatus status = ER_OK;
+    if (interval > 0) {
+        /* The timer is only started once some object holds changes back */
+        coalescerTimerLock->Lock(MUTEX_CONTEXT);
+        if (!coalescerTimer->IsRunning()) {
+            status = coalescerTimer->Start();
+        }
+        coalescerTimerLock->Unlock(MUTEX_CONTEXT);
+    }
+    if (status == ER_OK) {
+        lock.Lock(MUTEX_CONTEXT);
+        this->interval = interval;
+        this->maxBatch = maxBatch;
+        lock.Unlock(MUTEX_CONTEXT);
+        if (interval == 0) {
+            status = Flush();
+        }
+    }
+    return status;
+}
+
+QStatus PropChangedCoalescer::Mark(const char* ifcName, const char* propName, SessionId id, uint8_t flags)
+{
+    QStatus status = ER_OK;
+    Key key(ifcName, id, flags);
+    lock.Lock(MUTEX_CONTEXT);
+    if (stopped) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return obj.EmitPropChanged(ifcName, &propName, 1, id, flags);
+    }
+    vector<qcc::String>& names = pending[key];
+    if (find(names.begin(), names.end(), propName) == names.end()) {
+        names.push_back(propName);
+    }
+    if ((interval == 0) || (maxBatch && (names.size() >= maxBatch))) {
+        PendingMap batch;
+        batch[key].swap(names);
+        pending.erase(key);
+        lock.Unlock(MUTEX_CONTEXT);
+        return Emit(batch);
+    }
+    if (!scheduled) {
+        AlarmListener* listener = this;
+        alarm = Alarm(interval, listener);
+        status = coalescerTimer->AddAlarm(alarm);
+        scheduled = (status == ER_OK);
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
+QStatus PropChangedCoalescer::Flush()
+{
+    PendingMap batch;
+    lock.Lock(MUTEX_CONTEXT);
+    batch.swap(pending);
+    lock.Unlock(MUTEX_CONTEXT);
+    return Emit(batch);
+}
+
+void PropChangedCoalescer::Stop()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    stopped = true;
+    pending.clear();
+    bool wasScheduled = scheduled;
+    Alarm last = alarm;
+    lock.Unlock(MUTEX_CONTEXT);
+
+    /*
+     * No alarm is added once stopped is set so the last one is the only one
+     * that can still be waiting on the timer.  Removing it waits for
+     * AlarmTriggered() unless it is this thread that is in it.
+     */
+    if (wasScheduled && coalescerTimer) {
+        coalescerTimer->RemoveAlarm(last, true);
+    }
+
+    /* The callback of an earlier alarm may still be finishing */
+    Thread* self = Thread::GetThread();
+    lock.Lock(MUTEX_CONTEXT);
+    while (!triggering.empty() && ((triggering.size() > 1) || (triggering[0] != self))) {
+        lock.Unlock(MUTEX_CONTEXT);
+        qcc::Sleep(2);
+        lock.Lock(MUTEX_CONTEXT);
+    }
+    scheduled = false;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void PropChangedCoalescer::Resume()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    stopped = false;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void PropChangedCoalescer::AlarmTriggered(const Alarm& alarm, QStatus reason)
+{
+    QCC_UNUSED(alarm);
+
+    PendingMap batch;
+    Thread* self = Thread::GetThread();
+    lock.Lock(MUTEX_CONTEXT);
+    triggering.push_back(self);
+    batch.swap(pending);
+    lock.Unlock(MUTEX_CONTEXT);
+    if (reason == ER_OK) {
+        QStatus status = Emit(batch);
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Failed to emit coalesced PropertiesChanged for %s", obj.GetPath()));
+        }
+    }
+
+    /*
+     * The alarm stays scheduled while the batch is emitted so that there is
+     * only ever one alarm for Stop() to wait for.  Changes marked in the
+     * meantime get an alarm of their own.
+     */
+    lock.Lock(MUTEX_CONTEXT);
+    scheduled = false;
+    if ((reason == ER_OK) && !stopped && !pending.empty()) {
+        AlarmListener* listener = this;
+        this->alarm = Alarm(interval, listener);
+        scheduled = (coalescerTimer->AddAlarm(this->alarm) == ER_OK);
+    }
+    /* Stop() returns once this is gone so nothing may touch the coalescer afterwards */
+    triggering.erase(find(triggering.begin(), triggering.end(), self));
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+QStatus PropChangedCoalescer::Emit(const PendingMap& batch)
+{
+    QStatus status = ER_OK;
+    for (PendingMap::const_iterator it = batch.begin(); it != batch.end(); ++it) {
+        const vector<qcc::String>& names = it->second;
+        if (names.empty()) {
+            continue;
+        }
+        const char** propNames = new const char*[names.size()];
+        for (size_t i = 0; i < names.size(); ++i) {
+            propNames[i] = names[i].c_str();
+        }
+        QStatus result = obj.EmitPropChanged(it->first.ifcName.c_str(), propNames, names.size(), it->first.id, it->first.flags);
+        if (status == ER_OK) {
+            status = result;
+        }
+        delete [] propNames;
+    }
+    return status;
+}
+
+}
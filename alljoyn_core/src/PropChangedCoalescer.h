@@ -0,0 +1,167 @@
+#ifndef _ALLJOYN_PROPCHANGEDCOALESCER_H
+#define _ALLJOYN_PROPCHANGEDCOALESCER_H
+/**
+ * @file
+ *
+ * This file defines the class that batches the PropertiesChanged signals of a BusObject.
+ *
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include PropChangedCoalescer.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <map>
+#include <vector>
+
+#include <qcc/Mutex.h>
+#include <qcc/String.h>
+#include <qcc/Thread.h>
+#include <qcc/Timer.h>
+
+#include <alljoyn/Session.h>
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+class BusObject;
+
+/**
+ * Accumulates the properties marked as changed on a BusObject and emits them
+ * in batches of one PropertiesChanged signal per interface, session and flags.
+ *
+ * The batches of all BusObjects are emitted from one process-wide timer that is
+ * started the first time coalescing is configured.  Emitting a batch reads the
+ * property values through the virtual BusObject::Get() so the coalescer
+ * must be stopped before the derived object is torn down.  Unregistering the
+ * object does that.
+ */
+class PropChangedCoalescer : public qcc::AlarmListener {
+  public:
+
+    /**
+     * Create the process-wide timer.
+     */
+    static void Init();
+
+    /**
+     * Stop and destroy the process-wide timer.
+     */
+    static void Shutdown();
+
+    /**
+     * Constructor.
+     *
+     * @param obj  The object whose properties are coalesced.
+     */
+    PropChangedCoalescer(BusObject& obj);
+
+    /**
+     * Destructor.  Stops the coalescer.
+     */
+    ~PropChangedCoalescer();
+
+    /**
+     * Set the coalescing interval and batch size.  Pending properties are
+     * emitted right away if the interval is 0.
+     *
+     * @param interval  Maximum time in milliseconds a change is held back.
+     * @param maxBatch  Number of pending properties that triggers an emit (0 for no limit).
+     *
+     * @return  ER_OK if successful.
+     */
+    QStatus Configure(uint32_t interval, size_t maxBatch);
+
+    /**
+     * Mark a property as changed.  Once the coalescer is stopped the change is
+     * emitted right away.
+     *
+     * @return  ER_OK or the status of the signal if it was emitted right away.
+     */
+    QStatus Mark(const char* ifcName, const char* propName, SessionId id, uint8_t flags);
+
+    /**
+     * Emit all pending properties.
+     *
+     * @return  ER_OK or the status of the first signal that failed.
+     */
+    QStatus Flush();
+
+    /**
+     * Drop the pending properties and wait for a batch being emitted from the
+     * timer to complete.  Nothing is emitted from the timer afterwards until
+     * Resume() is called.
+     */
+    void Stop();
+
+    /**
+     * Hold changes back again after Stop().
+     */
+    void Resume();
+
+    /**
+     * Emit the pending properties from the process-wide timer.
+     */
+    void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
+
+  private:
+
+    struct Key {
+        qcc::String ifcName;
+        SessionId id;
+        uint8_t flags;
+
+        Key(const char* ifcName, SessionId id, uint8_t flags) : ifcName(ifcName), id(id), flags(flags) { }
+
+        bool operator<(const Key& other) const
+        {
+            if (id != other.id) {
+                return id < other.id;
+            }
+            if (flags != other.flags) {
+                return flags < other.flags;
+            }
+            return ifcName < other.ifcName;
+        }
+    };
+
+    typedef std::map<Key, std::vector<qcc::String> > PendingMap;
+
+    QStatus Emit(const PendingMap& batch);
+
+    /* Private copy constructor and assignment operator to prevent copying */
+    PropChangedCoalescer(const PropChangedCoalescer& other);
+    PropChangedCoalescer& operator=(const PropChangedCoalescer& other);
+
+    BusObject& obj;
+    qcc::Mutex lock;
+    PendingMap pending;
+    uint32_t interval;
+    size_t maxBatch;
+    qcc::Alarm alarm;       /**< The last alarm added to the timer */
+    bool scheduled;         /**< True while the alarm is waiting on the timer */
+    bool stopped;           /**< True after Stop(), no alarms are added to the timer */
+    std::vector<qcc::Thread*> triggering; /**< Timer threads in AlarmTriggered() */
+};
+
+}
+
+#endif
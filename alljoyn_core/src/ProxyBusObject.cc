@@ -36,6 +36,7 @@
 #include <qcc/StringSource.h>
 #include <qcc/Util.h>
 #include <qcc/XmlElement.h>
+#include <qcc/atomic.h>
 
 #include <alljoyn/AllJoynStd.h>
 #include <alljoyn/BusAttachment.h>
@@ -47,6 +48,7 @@
 
 #include "AllJoynPeerObj.h"
 #include "BusInternal.h"
+#include "CachedProps.h"
 #include "LocalTransport.h"
 #include "Router.h"
 #include "XmlHelper.h"
@@ -100,74 +102,6 @@ struct _PropertiesChangedCB {
 
 typedef ManagedObj<_PropertiesChangedCB> PropertiesChangedCB;
 
-class CachedProps {
-    qcc::Mutex lock;
-    typedef std::map<qcc::StringMapKey, MsgArg> ValueMap;
-    ValueMap values;
-    const InterfaceDescription* description;
-    bool isFullyCacheable;
-    size_t numProperties;
-    uint32_t lastMessageSerial;
-    bool enabled;
-
-    bool IsCacheable(const char* propname);
-    bool IsValidMessageSerial(uint32_t messageSerial);
-
-  public:
-    CachedProps() :
-        lock(), values(), description(NULL),
-        isFullyCacheable(false),
-        numProperties(0), lastMessageSerial(0),
-        enabled(false) { }
-
-    CachedProps(const InterfaceDescription*intf) :
-        lock(), values(), description(intf),
-        isFullyCacheable(false), lastMessageSerial(0),
-        enabled(false) {
-        numProperties = description->GetProperties();
-        if (numProperties > 0) {
-            isFullyCacheable = true;
-            const InterfaceDescription::Property** props = new const InterfaceDescription::Property* [numProperties];
-            description->GetProperties(props, numProperties);
-            for (size_t i = 0; i < numProperties; ++i) {
-                if (props[i]->cacheable == false) {
-                    isFullyCacheable = false;
-                    break;
-                }
-            }
-            delete[] props;
-        }
-    }
-
-    CachedProps(const CachedProps& other) :
-        lock(), values(other.values), description(other.description),
-        isFullyCacheable(other.isFullyCacheable),
-        numProperties(other.numProperties), lastMessageSerial(other.lastMessageSerial),
-        enabled(other.enabled) { }
-
-    CachedProps& operator=(const CachedProps& other) {
-        if (&other != this) {
-            values = other.values;
-            description = other.description;
-            isFullyCacheable = other.isFullyCacheable;
-            numProperties = other.numProperties;
-            lastMessageSerial = other.lastMessageSerial;
-            enabled = other.enabled;
-        }
-        return *this;
-    }
-
-    ~CachedProps() { }
-
-    bool Get(const char* propname, MsgArg& val);
-    bool GetAll(MsgArg& val);
-    void Set(const char* propname, const MsgArg& val, const uint32_t messageSerial);
-    void SetAll(const MsgArg& allValues, const uint32_t messageSerial);
-    void PropertiesChanged(MsgArg* changed, size_t numChanged, MsgArg* invalidated, size_t numInvalidated, const uint32_t messageSerial);
-    void Enable();
-};
-
-
 /**
  * Internal context structure used between synchronous method_call and method_return
  */
@@ -275,6 +209,15 @@ class ProxyBusObject::Internal : public MessageReceiver, public BusAttachment::A
      */
     void RemoveAllPropertiesChangedRules();
 
+    /**
+     * @internal
+     * Get the property cache for an interface
+     *
+     * @param intf the interface name
+     * @return the cache or NULL if properties of the interface are not cached
+     */
+    CachedProps* GetCache(const char* intf) const;
+
     /**
      * @internal
      * Handle property changed signals. (Internal use only)
@@ -319,7 +262,7 @@ class ProxyBusObject::Internal : public MessageReceiver, public BusAttachment::A
     /** The interfaces this object implements */
     map<qcc::StringMapKey, const InterfaceDescription*> ifaces;
 
-    /** The property caches for the various interfaces */
+    /** The property caches for the various interfaces, entries are never removed */
     mutable map<qcc::StringMapKey, CachedProps> caches;
 
     /** Names of child objects of this object */
@@ -449,14 +392,10 @@ QStatus ProxyBusObject::GetAllProperties(const char* iface, MsgArg& value, uint3
     } else {
         /* If all values are stored in the cache, we can reply immediately */
         bool cached = false;
-        internal->lock.Lock(MUTEX_CONTEXT);
-        if (internal->cacheProperties) {
-            map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-            if (it != internal->caches.end()) {
-                cached = it->second.GetAll(value);
-            }
+        CachedProps* cache = internal->GetCache(iface);
+        if (cache) {
+            cached = cache->GetAll(value);
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
         if (cached) {
             QCC_DbgPrintf(("GetAllProperties(%s) -> cache hit", iface));
             return ER_OK;
@@ -482,14 +421,10 @@ QStatus ProxyBusObject::GetAllProperties(const char* iface, MsgArg& value, uint3
             if (ER_OK == status) {
                 value = *(reply->GetArg(0));
                 /* use the retrieved property values to update the cache, if applicable */
-                internal->lock.Lock(MUTEX_CONTEXT);
-                if (internal->cacheProperties) {
-                    map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-                    if (it != internal->caches.end()) {
-                        it->second.SetAll(value, reply->GetCallSerial());
-                    }
+                CachedProps* cache = internal->GetCache(iface);
+                if (cache) {
+                    cache->SetAll(value, reply->GetCallSerial());
                 }
-                internal->lock.Unlock(MUTEX_CONTEXT);
             }
         }
     }
@@ -505,14 +440,10 @@ void ProxyBusObject::GetAllPropsMethodCB(Message& message, void* context)
 
     if (message->GetType() == MESSAGE_METHOD_RET) {
         /* use the retrieved property values to update the cache, if applicable */
-        internal->lock.Lock(MUTEX_CONTEXT);
-        if (internal->cacheProperties) {
-            map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-            if (it != internal->caches.end()) {
-                it->second.SetAll(*message->GetArg(0), message->GetCallSerial());
-            }
+        CachedProps* cache = internal->GetCache(iface);
+        if (cache) {
+            cache->SetAll(*message->GetArg(0), message->GetCallSerial());
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
         /* alert the application */
         (ctx->listener->*ctx->callback)(ER_OK, this, *message->GetArg(0), unwrappedContext);
     } else {
@@ -546,14 +477,10 @@ QStatus ProxyBusObject::GetAllPropertiesAsync(const char* iface,
         /* If all values are stored in the cache, we can reply immediately */
         bool cached = false;
         MsgArg value;
-        internal->lock.Lock(MUTEX_CONTEXT);
-        if (internal->cacheProperties) {
-            map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-            if (it != internal->caches.end()) {
-                cached = it->second.GetAll(value);
-            }
+        CachedProps* cache = internal->GetCache(iface);
+        if (cache) {
+            cached = cache->GetAll(value);
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
         if (cached) {
             QCC_DbgPrintf(("GetAllPropertiesAsync(%s) -> cache hit", iface));
             internal->bus->GetInternal().GetLocalEndpoint()->ScheduleCachedGetPropertyReply(this, listener, callback, context, value);
@@ -603,14 +530,10 @@ QStatus ProxyBusObject::GetProperty(const char* iface, const char* property, Msg
     } else {
         /* if the property is cached, we can reply immediately */
         bool cached = false;
-        internal->lock.Lock(MUTEX_CONTEXT);
-        if (internal->cacheProperties) {
-            map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-            if (it != internal->caches.end()) {
-                cached = it->second.Get(property, value);
-            }
+        CachedProps* cache = internal->GetCache(iface);
+        if (cache) {
+            cached = cache->Get(property, value);
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
         if (cached) {
             QCC_DbgPrintf(("GetProperty(%s, %s) -> cache hit", iface, property));
             return ER_OK;
@@ -638,14 +561,10 @@ QStatus ProxyBusObject::GetProperty(const char* iface, const char* property, Msg
             if (ER_OK == status) {
                 value = *(reply->GetArg(0));
                 /* use the retrieved property value to update the cache, if applicable */
-                internal->lock.Lock(MUTEX_CONTEXT);
-                if (internal->cacheProperties) {
-                    map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-                    if (it != internal->caches.end()) {
-                        it->second.Set(property, value, reply->GetCallSerial());
-                    }
+                CachedProps* cache = internal->GetCache(iface);
+                if (cache) {
+                    cache->Set(property, value, reply->GetCallSerial());
                 }
-                internal->lock.Unlock(MUTEX_CONTEXT);
             } else {
                 GetReplyErrorStatus(reply, status);
             }
@@ -664,14 +583,10 @@ void ProxyBusObject::GetPropMethodCB(Message& message, void* context)
 
     if (message->GetType() == MESSAGE_METHOD_RET) {
         /* use the retrieved property value to update the cache, if applicable */
-        internal->lock.Lock(MUTEX_CONTEXT);
-        if (internal->cacheProperties) {
-            map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-            if (it != internal->caches.end()) {
-                it->second.Set(property, *message->GetArg(0), message->GetCallSerial());
-            }
+        CachedProps* cache = internal->GetCache(iface);
+        if (cache) {
+            cache->Set(property, *message->GetArg(0), message->GetCallSerial());
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
         /* let the application know we've got a result */
         (ctx->listener->*ctx->callback)(ER_OK, this, *message->GetArg(0), unwrappedContext);
     } else {
@@ -706,14 +621,10 @@ QStatus ProxyBusObject::GetPropertyAsync(const char* iface,
         /* if the property is cached, we can reply immediately */
         bool cached = false;
         MsgArg value;
-        internal->lock.Lock(MUTEX_CONTEXT);
-        if (internal->cacheProperties) {
-            map<qcc::StringMapKey, CachedProps>::iterator it = internal->caches.find(iface);
-            if (it != internal->caches.end()) {
-                cached = it->second.Get(property, value);
-            }
+        CachedProps* cache = internal->GetCache(iface);
+        if (cache) {
+            cached = cache->Get(property, value);
         }
-        internal->lock.Unlock(MUTEX_CONTEXT);
         if (cached) {
             QCC_DbgPrintf(("GetPropertyAsync(%s, %s) -> cache hit", iface, property));
             internal->bus->GetInternal().GetLocalEndpoint()->ScheduleCachedGetPropertyReply(this, listener, callback, context, value);
@@ -940,15 +851,14 @@ void ProxyBusObject::Internal::PropertiesChangedHandler(const InterfaceDescripti
         return;
     }
 
-    lock.Lock(MUTEX_CONTEXT);
     /* first, update caches */
-    if (cacheProperties) {
-        map<StringMapKey, CachedProps>::iterator it = caches.find(ifaceName);
-        if (it != caches.end()) {
-            it->second.PropertiesChanged(changedProps, numChangedProps, invalidProps, numInvalidProps, message->GetCallSerial());
-        }
+    CachedProps* cache = GetCache(ifaceName);
+    if (cache) {
+        cache->PropertiesChanged(changedProps, numChangedProps, invalidProps, numInvalidProps, message->GetCallSerial());
     }
 
+    lock.Lock(MUTEX_CONTEXT);
+
     /* then, alert listeners */
     handlerThreads[Thread::GetThread()] = nullptr;
     multimap<StringMapKey, PropertiesChangedCB>::iterator it = propertiesChangedCBs.lower_bound(ifaceName);
@@ -1160,6 +1070,20 @@ QStatus ProxyBusObject::AddInterface(const char* ifaceName)
     }
 }
 
+CachedProps* ProxyBusObject::Internal::GetCache(const char* intf) const
+{
+    CachedProps* cache = NULL;
+    lock.Lock(MUTEX_CONTEXT);
+    if (cacheProperties) {
+        map<StringMapKey, CachedProps>::iterator it = caches.find(intf);
+        if (it != caches.end()) {
+            cache = &it->second;
+        }
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return cache;
+}
+
 void ProxyBusObject::Internal::AddMatchCB(QStatus status, void* context)
 {
     QCC_UNUSED(status);
@@ -1536,7 +1460,7 @@ QStatus ProxyBusObject::MethodCallAsync(const InterfaceDescription::Member& meth
     if ((flags & ALLJOYN_FLAG_ENCRYPTED) && !internal->bus->IsPeerSecurityEnabled()) {
         return ER_BUS_SECURITY_NOT_ENABLED;
     }
-    status = msg->CallMsg(method.signature, internal->serviceName, internal->sessionId, internal->path, method.iface->GetName(), method.name, args, numArgs, flags);
+    status = msg->CallMsg(method.signature, internal->serviceName, internal->sessionId, internal->path, method.iface->GetName(), method.name, args, numArgs, flags, NULL, &method);
     if (status == ER_OK) {
         if (!(flags & ALLJOYN_FLAG_NO_REPLY_EXPECTED)) {
             status = localEndpoint->RegisterReplyHandler(receiver, replyHandler, method, msg, context, timeout);
@@ -1597,6 +1521,28 @@ QStatus ProxyBusObject::MethodCall(const InterfaceDescription::Member& method,
                                    uint32_t timeout,
                                    uint8_t flags,
                                    Message* callMsg) const
+{
+    return MethodCallInternal(method, args, numArgs, NULL, replyMsg, timeout, flags, callMsg);
+}
+
+QStatus ProxyBusObject::MethodCall(const InterfaceDescription::Member& method,
+                                   const MsgBodyWriter& body,
+                                   Message& replyMsg,
+                                   uint32_t timeout,
+                                   uint8_t flags,
+                                   Message* callMsg) const
+{
+    return MethodCallInternal(method, NULL, 0, &body, replyMsg, timeout, flags, callMsg);
+}
+
+QStatus ProxyBusObject::MethodCallInternal(const InterfaceDescription::Member& method,
+                                           const MsgArg* args,
+                                           size_t numArgs,
+                                           const MsgBodyWriter* body,
+                                           Message& replyMsg,
+                                           uint32_t timeout,
+                                           uint8_t flags,
+                                           Message* callMsg) const
 {
     QStatus status;
     Message msg(*internal->bus);
@@ -1631,7 +1577,7 @@ QStatus ProxyBusObject::MethodCall(const InterfaceDescription::Member& method,
         status = ER_BUS_SECURITY_NOT_ENABLED;
         goto MethodCallExit;
     }
-    status = msg->CallMsg(method.signature, internal->serviceName, internal->sessionId, internal->path, method.iface->GetName(), method.name, args, numArgs, flags);
+    status = msg->CallMsg(method.signature, internal->serviceName, internal->sessionId, internal->path, method.iface->GetName(), method.name, args, numArgs, flags, body, &method);
     if (status != ER_OK) {
         goto MethodCallExit;
     }
@@ -1852,6 +1798,66 @@ QStatus ProxyBusObject::IntrospectRemoteObject(uint32_t timeout)
     return status;
 }
 
+QStatus ProxyBusObject::IntrospectRemoteObjectTree(uint32_t timeout)
+{
+    /*
+     * The tree interface is needed to make the call but we only know whether
+     * the remote object implements it after it has answered.
+     */
+    const InterfaceDescription* treeIntf = internal->bus->GetInterface(org::allseen::IntrospectableTree::InterfaceName);
+    QCC_ASSERT(treeIntf);
+    bool added = (AddInterface(*treeIntf) == ER_OK);
+
+    /* Attempt to retrieve the introspection of the whole subtree using sync call */
+    Message reply(*internal->bus);
+    const InterfaceDescription::Member* treeMember = treeIntf->GetMember("IntrospectTree");
+    QCC_ASSERT(treeMember);
+    MsgArg langArg("s", "");
+    QStatus status = MethodCall(*treeMember, &langArg, 1, reply, timeout);
+
+    /* Parse the XML reply */
+    if (ER_OK == status) {
+        QCC_DbgPrintf(("Introspection XML: %s\n", reply->GetArg(0)->v_string.str));
+        qcc::String ident = reply->GetSender();
+        if (internal->uniqueName.empty()) {
+            internal->uniqueName = ident;
+        }
+        ident += " : ";
+        ident += reply->GetObjectPath();
+        return ParseXml(reply->GetArg(0)->v_string.str, ident.c_str());
+    }
+
+    if (added) {
+        internal->lock.Lock(MUTEX_CONTEXT);
+        internal->ifaces.erase(StringMapKey(org::allseen::IntrospectableTree::InterfaceName));
+        internal->lock.Unlock(MUTEX_CONTEXT);
+    }
+
+    /*
+     * The remote object does not support tree introspection or could not
+     * answer it, for instance because the tree is too large for a single
+     * message, so walk the tree one object at a time.
+     */
+    QCC_DbgPrintf(("IntrospectTree failed for %s (%s), introspecting level by level", internal->path.c_str(), QCC_StatusText(status)));
+    vector<ProxyBusObject*> pending(1, this);
+    while (!pending.empty()) {
+        ProxyBusObject* obj = pending.back();
+        pending.pop_back();
+        status = obj->IntrospectRemoteObject(timeout);
+        if (status != ER_OK) {
+            break;
+        }
+        size_t numChildren = obj->GetChildren();
+        if (numChildren > 0) {
+            ProxyBusObject** children = new ProxyBusObject*[numChildren];
+            numChildren = obj->GetChildren(children, numChildren);
+            pending.insert(pending.end(), children, children + numChildren);
+            delete [] children;
+        }
+    }
+    return status;
+}
+
 QStatus ProxyBusObject::IntrospectRemoteObjectAsync(ProxyBusObject::Listener* listener,
                                                     ProxyBusObject::Listener::IntrospectCB callback,
                                                     void* context,
@@ -1914,14 +1920,17 @@ void ProxyBusObject::IntrospectMethodCB(Message& msg, void* context)
 
 QStatus ProxyBusObject::ParseXml(const char* xml, const char* ident)
 {
-    StringSource source(xml);
-
-    /* Parse the XML to update this ProxyBusObject instance (plus any new children and interfaces) */
-    XmlParseContext pc(source);
-    QStatus status = XmlElement::Parse(pc);
-    if (status == ER_OK) {
-        XmlHelper xmlHelper(internal->bus, ident ? ident : internal->path.c_str());
-        status = xmlHelper.AddProxyObjects(*this, pc.GetRoot());
+    /* Scan the XML to update this ProxyBusObject instance (plus any new children and interfaces) */
+    XmlHelper xmlHelper(internal->bus, ident ? ident : internal->path.c_str());
+    QStatus status = xmlHelper.ScanProxyObjects(*this, xml);
+    if (status == ER_BUS_BAD_XML) {
+        /* The XML parser is more forgiving than the scanner so let it have a go */
+        StringSource source(xml);
+        XmlParseContext pc(source);
+        status = XmlElement::Parse(pc);
+        if (status == ER_OK) {
+            status = xmlHelper.AddProxyObjects(*this, pc.GetRoot());
+        }
     }
     return status;
 }
@@ -2005,194 +2014,9 @@ void ProxyBusObject::SetB2BEndpoint(RemoteEndpoint& b2bEp)
     internal->b2bEp = b2bEp;
 }
 
-bool CachedProps::Get(const char* propname, MsgArg& val)
-{
-    bool found = false;
-    lock.Lock(MUTEX_CONTEXT);
-    ValueMap::iterator it = values.find(propname);
-    if (it != values.end()) {
-        found = true;
-        val = it->second;
-    }
-    lock.Unlock(MUTEX_CONTEXT);
-    return found;
-}
-
-bool CachedProps::GetAll(MsgArg& val)
-{
-    if (!isFullyCacheable || numProperties == 0) {
-        return false;
-    }
-
-    bool found = false;
-    lock.Lock(MUTEX_CONTEXT);
-    if (values.size() == numProperties) {
-        found = true;
-        MsgArg* dict = new MsgArg[numProperties];
-        ValueMap::iterator it = values.begin();
-        for (int i = 0; it != values.end(); ++it, ++i) {
-            MsgArg* inner;
-            it->second.Get("v", &inner);
-            dict[i].Set("{sv}", it->first.c_str(), inner);
-            /* dict[i].Set("{sv}", it->first.c_str(), &(it->second)); */
-        }
-        val.Set("a{sv}", numProperties, dict);
-        val.Stabilize();
-        delete[] dict;
-    }
-    lock.Unlock(MUTEX_CONTEXT);
-    return found;
-}
-
-bool CachedProps::IsValidMessageSerial(uint32_t messageSerial)
-{
-    uint32_t threshold = (uint32_t) (0x1 << 31);
-    if (messageSerial >= lastMessageSerial) {
-        // messageSerial should be higher than the last.
-        // The check returns true unless the diff is too big.
-        // In this case we assume an out-of-order message is processed.
-        // The message was sent prior to a wrap around of the uint32_t counter.
-        return ((messageSerial - lastMessageSerial) < threshold);
-    }
-    // The messageSerial is smaller than the last. This is an out-of-order
-    // message (return false) unless the diff is too big. if the diff is high
-    // we assume we hit a wrap around of the message serial counter (return true).
-    return ((lastMessageSerial - messageSerial) > threshold);
-}
-
-bool CachedProps::IsCacheable(const char* propname)
-{
-    const InterfaceDescription::Property* prop = description->GetProperty(propname);
-    return (prop != NULL && prop->cacheable);
-}
-
-void CachedProps::Set(const char* propname, const MsgArg& val, const uint32_t messageSerial)
-{
-    if (!IsCacheable(propname)) {
-        return;
-    }
-
-    lock.Lock(MUTEX_CONTEXT);
-    if (!enabled) {
-        lock.Unlock(MUTEX_CONTEXT);
-        return;
-    }
-
-    if (!IsValidMessageSerial(messageSerial)) {
-        values.clear();
-    } else {
-        values[qcc::String(propname)] = val;
-        lastMessageSerial = messageSerial;
-    }
-    lock.Unlock(MUTEX_CONTEXT);
-}
-
-void CachedProps::SetAll(const MsgArg& allValues, const uint32_t messageSerial)
-{
-    lock.Lock(MUTEX_CONTEXT);
-    if (!enabled) {
-        lock.Unlock(MUTEX_CONTEXT);
-        return;
-    }
-
-    size_t nelem;
-    MsgArg* elems;
-    QStatus status = allValues.Get("a{sv}", &nelem, &elems);
-    if (status != ER_OK) {
-        goto error;
-    }
-
-    if (!IsValidMessageSerial(messageSerial)) {
-        status = ER_FAIL;
-        goto error;
-    }
-
-    for (size_t i = 0; i < nelem; ++i) {
-        const char* prop;
-        MsgArg* val;
-        status = elems[i].Get("{sv}", &prop, &val);
-        if (status != ER_OK) {
-            goto error;
-        }
-        if (IsCacheable(prop)) {
-            values[qcc::String(prop)].Set("v", val);
-            values[qcc::String(prop)].Stabilize();
-        }
-    }
-
-    lastMessageSerial = messageSerial;
-
-    lock.Unlock(MUTEX_CONTEXT);
-    return;
-
-error:
-    /* We can't make sense of the property values for some reason.
-     * Play it safe and invalidate all properties */
-    QCC_LogError(status, ("Failed to parse GetAll return value or inconsistent message serial number. Invalidating property cache."));
-    values.clear();
-    lock.Unlock(MUTEX_CONTEXT);
-}
-
-void CachedProps::PropertiesChanged(MsgArg* changed, size_t numChanged, MsgArg* invalidated, size_t numInvalidated, const uint32_t messageSerial)
-{
-    lock.Lock(MUTEX_CONTEXT);
-    if (!enabled) {
-        lock.Unlock(MUTEX_CONTEXT);
-        return;
-    }
-
-    QStatus status;
-
-    if (!IsValidMessageSerial(messageSerial)) {
-        status = ER_FAIL;
-        goto error;
-    }
-
-    for (size_t i = 0; i < numChanged; ++i) {
-        const char* prop;
-        MsgArg* val;
-        status = changed[i].Get("{sv}", &prop, &val);
-        if (status != ER_OK) {
-            goto error;
-        }
-        if (IsCacheable(prop)) {
-            values[qcc::String(prop)].Set("v", val);
-            values[qcc::String(prop)].Stabilize();
-        }
-    }
-
-    for (size_t i = 0; i < numInvalidated; ++i) {
-        char* prop;
-        status = invalidated[i].Get("s", &prop);
-        if (status != ER_OK) {
-            goto error;
-        }
-        values.erase(prop);
-    }
-
-    lastMessageSerial = messageSerial;
-
-    lock.Unlock(MUTEX_CONTEXT);
-    return;
-
-error:
-    /* We can't make sense of the property update signal for some reason.
-     * Play it safe and invalidate all properties */
-    QCC_LogError(status, ("Failed to parse PropertiesChanged signal or inconsistent message serial number. Invalidating property cache."));
-    values.clear();
-    lock.Unlock(MUTEX_CONTEXT);
-}
-
 BusAttachment& ProxyBusObject::GetBusAttachment() const
 {
     return *(internal->bus);
 }
 
-void CachedProps::Enable()
-{
-    lock.Lock(MUTEX_CONTEXT);
-    enabled = true;
-    lock.Unlock(MUTEX_CONTEXT);
-}
-
 }
@@ -19,6 +19,7 @@
  ******************************************************************************/
 #include <qcc/platform.h>
 
+#include <algorithm>
 
 #include <qcc/Debug.h>
 #include <qcc/String.h>
@@ -28,6 +29,7 @@
 #include <qcc/SocketStream.h>
 #include <qcc/atomic.h>
 #include <qcc/IODispatch.h>
+#include <qcc/time.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/AllJoynStd.h>
@@ -38,10 +40,6 @@
 #include "AllJoynPeerObj.h"
 #include "BusInternal.h"
 
-#ifndef NDEBUG
-#include <qcc/time.h>
-#endif
-
 #define QCC_MODULE "ALLJOYN"
 
 using namespace std;
@@ -86,11 +84,25 @@ class _RemoteEndpoint::Internal {
         sendTimeout(0),
         maxControlMessages(30),
         numControlMessages(0),
-        numDataMessages(0)
+        numDataMessages(0),
+        pendingAuth(NULL),
+        establishDeadline(0)
     {
     }
 
     ~Internal() {
+        delete pendingAuth;
+    }
+
+    /* Take over what was learned about the remote side while establishing the connection */
+    void Established(const EndpointAuth& auth, const qcc::String& authUsed)
+    {
+        uniqueName = auth.GetUniqueName();
+        remoteName = auth.GetRemoteName();
+        remoteGUID = auth.GetRemoteGUID();
+        features.protocolVersion = auth.GetRemoteProtocolVersion();
+        features.trusted = (authUsed != "ANONYMOUS");
+        features.nameTransfer = (SessionOpts::NameTransferType)auth.GetNameTransfer();
     }
 
     BusAttachment& bus;                      /**< Message bus associated with this endpoint */
@@ -140,6 +152,8 @@ class _RemoteEndpoint::Internal {
                                                   - used on Routing nodes only */
     size_t numControlMessages;               /**< Number of control messages in txQueue - used on Routing nodes only */
     size_t numDataMessages;                  /**< Number of data messages in txQueue - used on Routing nodes only */
+    EndpointAuth* pendingAuth;               /**< Handshake started by BeginEstablish() that has not completed yet */
+    uint64_t establishDeadline;              /**< Time by which the pending handshake must complete, 0 for no limit */
   private:
     Internal& operator=(const Internal&);
 };
@@ -285,18 +299,72 @@ QStatus _RemoteEndpoint::Establish(const qcc::String& authMechanisms, qcc::Strin
 
         status = auth.Establish(authMechanisms, authUsed, redirection, listener, timeout);
         if (status == ER_OK) {
-            internal->uniqueName = auth.GetUniqueName();
-            internal->remoteName = auth.GetRemoteName();
-            internal->remoteGUID = auth.GetRemoteGUID();
-            internal->features.protocolVersion = auth.GetRemoteProtocolVersion();
-            internal->features.trusted = (authUsed != "ANONYMOUS");
-            internal->features.nameTransfer = (SessionOpts::NameTransferType)auth.GetNameTransfer();
+            internal->Established(auth, authUsed);
+        }
+    }
+    return status;
+}
+
+QStatus _RemoteEndpoint::BeginEstablish(const qcc::String& authMechanisms, AuthListener* listener, uint32_t timeout)
+{
+    if (!internal || minimalEndpoint || !internal->incoming || internal->pendingAuth) {
+        return ER_BUS_NO_ENDPOINT;
+    }
+    RemoteEndpoint rep = RemoteEndpoint::wrap(this);
+    internal->pendingAuth = new EndpointAuth(internal->bus, rep, true);
+    internal->establishDeadline = (timeout == Event::WAIT_FOREVER) ? 0 : GetTimestamp64() + timeout;
+    QStatus status = internal->pendingAuth->BeginAccept(authMechanisms, listener);
+    if (status != ER_OK) {
+        AbortEstablish();
+    }
+    return status;
+}
 
+QStatus _RemoteEndpoint::ContinueEstablish(qcc::String& authUsed, qcc::String& redirection)
+{
+    if (!internal || !internal->pendingAuth) {
+        return ER_BUS_NO_ENDPOINT;
+    }
+    QStatus status = internal->pendingAuth->ContinueAccept(authUsed, redirection);
+    if (status == ER_WOULDBLOCK) {
+        if (GetEstablishTimeRemaining() > 0) {
+            return status;
         }
+        status = ER_TIMEOUT;
     }
+    if (status == ER_OK) {
+        internal->Established(*internal->pendingAuth, authUsed);
+    }
+    AbortEstablish();
     return status;
 }
 
+uint32_t _RemoteEndpoint::GetEstablishTimeRemaining() const
+{
+    if (!internal || !internal->pendingAuth || (internal->establishDeadline == 0)) {
+        return Event::WAIT_FOREVER;
+    }
+    uint64_t now = GetTimestamp64();
+    if (now >= internal->establishDeadline) {
+        return 0;
+    }
+    return static_cast<uint32_t>(min(internal->establishDeadline - now, static_cast<uint64_t>(Event::WAIT_FOREVER - 1)));
+}
+
+void _RemoteEndpoint::AbortEstablish()
+{
+    if (internal && internal->pendingAuth) {
+        /*
+         * The handshake holds a reference to this endpoint so it must be
+         * released explicitly for the endpoint to ever be freed.
+         */
+        EndpointAuth* auth = internal->pendingAuth;
+        internal->pendingAuth = NULL;
+        auth->AbortAccept();
+        delete auth;
+    }
+}
+
 QStatus _RemoteEndpoint::SetLinkTimeout(uint32_t& idleTimeout)
 {
     QCC_UNUSED(idleTimeout);
@@ -308,6 +308,56 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     QStatus Establish(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener = NULL, uint32_t timeout = qcc::Event::WAIT_FOREVER);
 
+    /**
+     * Start establishing an incoming connection without blocking. Instead of
+     * dedicating a thread to the handshake the transport calls
+     * ContinueEstablish() whenever the stream of the endpoint has data
+     * available.
+     *
+     * @param[in] authMechanisms  The authentication mechanism(s) to offer.
+     * @param[in] listener        Optional authentication listener
+     * @param[in] timeout         Time in milliseconds the remote side has to
+     *                            complete the handshake.
+     *
+     * @return
+     *      - ER_OK if the handshake was started.
+     *      - An error status otherwise
+     */
+    QStatus BeginEstablish(const qcc::String& authMechanisms, AuthListener* listener = NULL, uint32_t timeout = qcc::Event::WAIT_FOREVER);
+
+    /**
+     * Continue a handshake started by BeginEstablish() with whatever the
+     * remote side has sent so far.
+     *
+     * @param[out] authUsed    Returns the name of the authentication method
+     *                         that was used to establish the connection.
+     * @param[out] redirection Returns a redirection address for the endpoint. This value
+     *                         is only meaninful if the return status is ER_BUS_ENDPOINT_REDIRECT.
+     *
+     * @return
+     *      - ER_OK if the connection has been established.
+     *      - ER_WOULDBLOCK if the handshake is waiting for the remote side.
+     *      - ER_BUS_ENDPOINT_REDIRECTED if the endpoint is being redirected.
+     *      - ER_TIMEOUT if the handshake did not complete in time.
+     *      - An error status otherwise
+     */
+    QStatus ContinueEstablish(qcc::String& authUsed, qcc::String& redirection);
+
+    /**
+     * Get the time left for a handshake started by BeginEstablish(). The
+     * transport bounds its wait for the stream of the endpoint by this and
+     * calls ContinueEstablish() once it runs out even if no data arrived.
+     *
+     * @return  The time left in milliseconds or qcc::Event::WAIT_FOREVER if
+     *          there is no limit.
+     */
+    uint32_t GetEstablishTimeRemaining() const;
+
+    /**
+     * Abandon a handshake started by BeginEstablish().
+     */
+    void AbortEstablish();
+
     /**
      * Get the GUID of the remote side of a bus-to-bus endpoint.
      *
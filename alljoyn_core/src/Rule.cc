@@ -24,6 +24,7 @@
 #include <alljoyn/Message.h>
 
 #include "Rule.h"
+#include "MsgArgCursor.h"
 #include "BusUtil.h"
 
 #include <qcc/Debug.h>
@@ -127,7 +128,91 @@ Rule::Rule(const char* ruleSpec, QStatus* outStatus) : type(MESSAGE_INVALID), se
     }
 }
 
+void RuleMatchKeys::Extract()
+{
+    extracted = true;
+
+    /*
+     * Only string arguments can be matched so read the body with a cursor
+     * rather than unmarshaling all of it. The cursor does not modify the
+     * message so it is safe even though the LocalEndpoint may be
+     * unmarshalling the same message.
+     */
+    MsgArgCursor cursor(msg);
+    argsStatus = cursor.GetStatus();
+    for (uint32_t i = 0; (argsStatus == ER_OK) && !cursor.AtEnd(); ++i) {
+        if (cursor.GetTypeId() == ALLJOYN_STRING) {
+            MsgArg arg;
+            argsStatus = cursor.Get(arg);
+            if (argsStatus == ER_OK) {
+                args[i] = qcc::String(arg.v_string.str, arg.v_string.len);
+            }
+        } else {
+            argsStatus = cursor.Skip();
+        }
+    }
+    if (argsStatus != ER_OK) {
+        args.clear();
+        implementsStatus = argsStatus;
+        return;
+    }
+
+    implementsStatus = ER_FAIL;
+    if (strcmp(msg->GetInterface(), "org.alljoyn.About") || strcmp(msg->GetMemberName(), "Announce") ||
+        strcmp(msg->GetSignature(), "qqa(oas)a{sv}")) {
+        return;
+    }
+    /* The object descriptions are the third argument */
+    if ((cursor.Seek(2) != ER_OK) || (cursor.Enter() != ER_OK)) {
+        return;
+    }
+    while (!cursor.AtEnd()) {
+        /* Step over the object path to the interface names */
+        if ((cursor.Enter() != ER_OK) || (cursor.Skip() != ER_OK) || (cursor.Enter() != ER_OK)) {
+            announced.clear();
+            return;
+        }
+        while (!cursor.AtEnd()) {
+            MsgArg intf;
+            if (cursor.Get(intf) != ER_OK) {
+                announced.clear();
+                return;
+            }
+            announced.insert(qcc::String(intf.v_string.str, intf.v_string.len));
+        }
+        if ((cursor.Exit() != ER_OK) || (cursor.Exit() != ER_OK)) {
+            announced.clear();
+            return;
+        }
+    }
+    implementsStatus = ER_OK;
+}
+
+QStatus RuleMatchKeys::GetArgs(const std::map<uint32_t, qcc::String>*& stringArgs)
+{
+    if (!extracted) {
+        Extract();
+    }
+    stringArgs = &args;
+    return argsStatus;
+}
+
+QStatus RuleMatchKeys::GetAnnouncedInterfaces(const std::set<qcc::String>*& interfaces)
+{
+    if (!extracted) {
+        Extract();
+    }
+    interfaces = &announced;
+    return implementsStatus;
+}
+
 bool Rule::IsMatch(const Message& msg) const
+{
+    RuleMatchKeys keys(msg);
+    return IsMatch(msg, keys);
+}
+
+bool Rule::IsMatch(const Message& msg, RuleMatchKeys& keys) const
 {
     /* The fields of a rule (if specified) are logically anded together */
     if ((type != MESSAGE_INVALID) && (type != msg->GetType())) {
@@ -149,75 +234,28 @@ bool Rule::IsMatch(const Message& msg) const
         return false;
     }
     if (!args.empty()) {
-        /*
-         * Clone the message since this message is unmarshalled by the
-         * LocalEndpoint too and the process of unmarshalling is not
-         * thread-safe.
-         */
-        Message clone = Message(msg, true);
-        QStatus status = clone->UnmarshalArgs(clone->GetSignature());
-        if (status != ER_OK) {
+        const map<uint32_t, String>* stringArgs;
+        if (keys.GetArgs(stringArgs) != ER_OK) {
             return false;
         }
         for (map<uint32_t, String>::const_iterator it = args.begin(); it != args.end(); ++it) {
-            const MsgArg* arg = clone->GetArg(it->first);
-            if (!arg) {
-                return false;
-            }
-            if (ALLJOYN_STRING != arg->typeId) {
+            map<uint32_t, String>::const_iterator sit = stringArgs->find(it->first);
+            if (sit == stringArgs->end()) {
                 return false;
             }
-            if (it->second != arg->v_string.str) {
+            if (it->second != sit->second) {
                 return false;
             }
         }
     }
     if (!implements.empty()) {
-        if (strcmp(msg->GetInterface(), "org.alljoyn.About") || strcmp(msg->GetMemberName(), "Announce")) {
-            return false;
-        }
-        /*
-         * Clone the message since this message is unmarshalled by the
-         * LocalEndpoint too and the process of unmarshalling is not
-         * thread-safe.
-         */
-        Message clone = Message(msg, true);
-        QStatus status = clone->UnmarshalArgs("qqa(oas)a{sv}");
-        if (status != ER_OK) {
+        const set<String>* interfaces;
+        if (keys.GetAnnouncedInterfaces(interfaces) != ER_OK) {
             return false;
         }
-
-        const MsgArg* arg = clone->GetArg(2);
-        if (!arg) {
-            return false;
-        }
-        size_t numObjectDescriptions;
-        MsgArg* objectDescriptions;
-        status = arg->Get("a(oas)", &numObjectDescriptions, &objectDescriptions);
-        if (status != ER_OK) {
-            return false;
-        }
-        set<String> interfaces;
-        for (size_t ob = 0; ob < numObjectDescriptions; ++ob) {
-            char* objectPath;
-            size_t numIntfs;
-            MsgArg* intfs;
-            status = objectDescriptions[ob].Get("(oas)", &objectPath, &numIntfs, &intfs);
-            if (status != ER_OK) {
-                return false;
-            }
-            for (size_t in = 0; in < numIntfs; ++in) {
-                char* intf;
-                status = intfs[in].Get("s", &intf);
-                if (status != ER_OK) {
-                    return false;
-                }
-                interfaces.insert(intf);
-            }
-        }
         size_t numMatches = 0;
         for (set<String>::const_iterator im = implements.begin(); im != implements.end(); ++im) {
-            for (set<String>::const_iterator in = interfaces.begin(); in != interfaces.end(); ++in) {
+            for (set<String>::const_iterator in = interfaces->begin(); in != interfaces->end(); ++in) {
                 if (WildcardMatch(*in, *im) == 0) {
                     ++numMatches;
                     break;
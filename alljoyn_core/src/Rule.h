@@ -32,6 +32,50 @@
 
 namespace ajn {
 
+/**
+ * The values from a message body that match rules compare against.
+ *
+ * The values are extracted lazily, the first time a rule that needs them is
+ * matched, and then kept.  Holding on to a RuleMatchKeys lets the same message
+ * be matched against many rules while its body is read at most once.
+ */
+class RuleMatchKeys {
+  public:
+    /**
+     * Constructor
+     *
+     * @param msg   Message to extract the keys from.
+     */
+    RuleMatchKeys(const Message& msg) : msg(msg), extracted(false), argsStatus(ER_NONE), implementsStatus(ER_NONE) { }
+
+    /**
+     * Get the string-typed body arguments of the message.
+     *
+     * @param[out] stringArgs   Map of argument index to string value.
+     * @return  ER_OK if the message body could be unmarshalled.
+     */
+    QStatus GetArgs(const std::map<uint32_t, qcc::String>*& stringArgs);
+
+    /**
+     * Get the interfaces listed in the object description of an
+     * org.alljoyn.About.Announce message.
+     *
+     * @param[out] interfaces   Set of announced interface names.
+     * @return  ER_OK if the message is a well-formed Announce signal.
+     */
+    QStatus GetAnnouncedInterfaces(const std::set<qcc::String>*& interfaces);
+
+  private:
+    void Extract();
+
+    Message msg;
+    bool extracted;
+    QStatus argsStatus;
+    std::map<uint32_t, qcc::String> args;
+    QStatus implementsStatus;
+    std::set<qcc::String> announced;
+};
+
 /**
  * Rule defines a message bus routing rule.
  */
@@ -94,6 +138,16 @@ struct Rule {
      */
     bool IsMatch(const Message& msg) const;
 
+    /**
+     * Return true if messages matches rule.
+     *
+     * @param msg   Message to compare with rule.
+     * @param keys  Body match keys of msg, extracted only if this rule
+     *              needs them.
+     * @return  true if this rule matches the message.
+     */
+    bool IsMatch(const Message& msg, RuleMatchKeys& keys) const;
+
     /**
      * String representation of a rule
      */
@@ -0,0 +1,285 @@
+/**
+ * @file
+ * This file implements bulk conversions for marshaling and unmarshaling
+ * arrays of scalar values.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+#include <qcc/Util.h>
+
+#include "ScalarArrayUtils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SCALAR_ARRAY_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+ * AVX2 code is compiled for a target that may not support it so it is only
+ * called after checking the processor at runtime.
+ */
+#if defined(SCALAR_ARRAY_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCALAR_ARRAY_AVX2
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace ajn {
+
+#ifdef SCALAR_ARRAY_AVX2
+
+static bool DetectAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}
+
+static bool HasAVX2()
+{
+    static const bool hasAVX2 = DetectAVX2();
+    return hasAVX2;
+}
+
+/*
+ * Each function converts as many whole 32 byte blocks as there are and
+ * returns the number of elements converted.
+ */
+AVX2_TARGET static size_t Swap16AVX2(uint16_t* dst, const uint16_t* src, size_t num)
+{
+    const __m256i mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t i = 0;
+    for (; (num - i) >= 16; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+AVX2_TARGET static size_t Swap32AVX2(uint32_t* dst, const uint32_t* src, size_t num)
+{
+    const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                          3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t i = 0;
+    for (; (num - i) >= 8; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+AVX2_TARGET static size_t Swap64AVX2(uint64_t* dst, const uint64_t* src, size_t num)
+{
+    const __m256i mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    size_t i = 0;
+    for (; (num - i) >= 4; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+#endif
+
+#ifdef SCALAR_ARRAY_SSE2
+
+/*
+ * SSE2 has no byte shuffle so bytes are swapped within 16 bit words with
+ * shifts and the words are then reordered.
+ */
+static inline __m128i SwapWords(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static size_t Swap16SSE2(uint16_t* dst, const uint16_t* src, size_t num)
+{
+    size_t i = 0;
+    for (; (num - i) >= 8; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), SwapWords(v));
+    }
+    return i;
+}
+
+static size_t Swap32SSE2(uint32_t* dst, const uint32_t* src, size_t num)
+{
+    size_t i = 0;
+    for (; (num - i) >= 4; i += 4) {
+        __m128i v = SwapWords(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    return i;
+}
+
+static size_t Swap64SSE2(uint64_t* dst, const uint64_t* src, size_t num)
+{
+    size_t i = 0;
+    for (; (num - i) >= 2; i += 2) {
+        __m128i v = SwapWords(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    return i;
+}
+
+static_assert(sizeof(bool) == 1, "SSE2 boolean conversions assume one byte bools");
+
+/*
+ * Converts 16 booleans at a time. Any bits that are set outside of the
+ * position of a marshaled 1 are accumulated in invalid.
+ */
+static size_t UnmarshalBooleansSSE2(bool* dst, const uint32_t* src, size_t num, bool endianSwap)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i notOne = _mm_set1_epi32(static_cast<int>(endianSwap ? ~0x01000000U : ~1U));
+    __m128i invalid = zero;
+    size_t i = 0;
+    for (; (num - i) >= 16; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+        __m128i v0 = _mm_loadu_si128(p);
+        __m128i v1 = _mm_loadu_si128(p + 1);
+        __m128i v2 = _mm_loadu_si128(p + 2);
+        __m128i v3 = _mm_loadu_si128(p + 3);
+        invalid = _mm_or_si128(invalid, _mm_and_si128(_mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3)), notOne));
+        /* -1 for false and 0 for true narrowed to bytes then offset to 0 and 1 */
+        __m128i f01 = _mm_packs_epi32(_mm_cmpeq_epi32(v0, zero), _mm_cmpeq_epi32(v1, zero));
+        __m128i f23 = _mm_packs_epi32(_mm_cmpeq_epi32(v2, zero), _mm_cmpeq_epi32(v3, zero));
+        __m128i b = _mm_add_epi8(_mm_packs_epi16(f01, f23), one);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), b);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, zero)) != 0xFFFF) {
+        return num + 1;
+    }
+    return i;
+}
+
+static size_t MarshalBooleansSSE2(uint32_t* dst, const bool* src, size_t num, bool endianSwap)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    size_t i = 0;
+    for (; (num - i) >= 16; i += 16) {
+        __m128i b = _mm_min_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), one);
+        __m128i lo = _mm_unpacklo_epi8(b, zero);
+        __m128i hi = _mm_unpackhi_epi8(b, zero);
+        __m128i v0 = _mm_unpacklo_epi16(lo, zero);
+        __m128i v1 = _mm_unpackhi_epi16(lo, zero);
+        __m128i v2 = _mm_unpacklo_epi16(hi, zero);
+        __m128i v3 = _mm_unpackhi_epi16(hi, zero);
+        if (endianSwap) {
+            v0 = _mm_slli_epi32(v0, 24);
+            v1 = _mm_slli_epi32(v1, 24);
+            v2 = _mm_slli_epi32(v2, 24);
+            v3 = _mm_slli_epi32(v3, 24);
+        }
+        __m128i* p = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(p, v0);
+        _mm_storeu_si128(p + 1, v1);
+        _mm_storeu_si128(p + 2, v2);
+        _mm_storeu_si128(p + 3, v3);
+    }
+    return i;
+}
+
+#endif
+
+void ScalarArrayUtils::Swap16(uint16_t* dst, const uint16_t* src, size_t num)
+{
+    size_t i = 0;
+#ifdef SCALAR_ARRAY_AVX2
+    if (HasAVX2()) {
+        i = Swap16AVX2(dst, src, num);
+    }
+#endif
+#ifdef SCALAR_ARRAY_SSE2
+    i += Swap16SSE2(dst + i, src + i, num - i);
+#endif
+    for (; i < num; ++i) {
+        dst[i] = EndianSwap16(src[i]);
+    }
+}
+
+void ScalarArrayUtils::Swap32(uint32_t* dst, const uint32_t* src, size_t num)
+{
+    size_t i = 0;
+#ifdef SCALAR_ARRAY_AVX2
+    if (HasAVX2()) {
+        i = Swap32AVX2(dst, src, num);
+    }
+#endif
+#ifdef SCALAR_ARRAY_SSE2
+    i += Swap32SSE2(dst + i, src + i, num - i);
+#endif
+    for (; i < num; ++i) {
+        dst[i] = EndianSwap32(src[i]);
+    }
+}
+
+void ScalarArrayUtils::Swap64(uint64_t* dst, const uint64_t* src, size_t num)
+{
+    size_t i = 0;
+#ifdef SCALAR_ARRAY_AVX2
+    if (HasAVX2()) {
+        i = Swap64AVX2(dst, src, num);
+    }
+#endif
+#ifdef SCALAR_ARRAY_SSE2
+    i += Swap64SSE2(dst + i, src + i, num - i);
+#endif
+    for (; i < num; ++i) {
+        dst[i] = EndianSwap64(src[i]);
+    }
+}
+
+bool ScalarArrayUtils::UnmarshalBooleans(bool* dst, const uint32_t* src, size_t num, bool endianSwap)
+{
+    size_t i = 0;
+#ifdef SCALAR_ARRAY_SSE2
+    i = UnmarshalBooleansSSE2(dst, src, num, endianSwap);
+    if (i > num) {
+        return false;
+    }
+#endif
+    for (; i < num; ++i) {
+        uint32_t b = endianSwap ? EndianSwap32(src[i]) : src[i];
+        if (b > 1) {
+            return false;
+        }
+        dst[i] = (b == 1);
+    }
+    return true;
+}
+
+void ScalarArrayUtils::MarshalBooleans(uint32_t* dst, const bool* src, size_t num, bool endianSwap)
+{
+    size_t i = 0;
+#ifdef SCALAR_ARRAY_SSE2
+    i = MarshalBooleansSSE2(dst, src, num, endianSwap);
+#endif
+    const uint32_t one = endianSwap ? EndianSwap32(1) : 1;
+    for (; i < num; ++i) {
+        dst[i] = src[i] ? one : 0;
+    }
+}
+
+}
@@ -0,0 +1,97 @@
+#ifndef _ALLJOYN_SCALARARRAYUTILS_H
+#define _ALLJOYN_SCALARARRAYUTILS_H
+/**
+ * @file
+ * This file defines bulk conversions for marshaling and unmarshaling arrays
+ * of scalar values.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include ScalarArrayUtils.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+namespace ajn {
+
+/**
+ * Bulk conversions between scalar arrays in memory and on the wire.
+ *
+ * On x86 the conversions use SSE2, and AVX2 when the processor supports it,
+ * falling back to one element at a time for the remainder and on other
+ * processors. Source and destination need not be aligned beyond the natural
+ * alignment of the element type but must not overlap.
+ */
+class ScalarArrayUtils {
+  public:
+
+    /**
+     * Copy an array of 16 bit values reversing the byte order of each.
+     *
+     * @param dst   Where to write the values.
+     * @param src   The values to copy.
+     * @param num   Number of values.
+     */
+    static void Swap16(uint16_t* dst, const uint16_t* src, size_t num);
+
+    /**
+     * Copy an array of 32 bit values reversing the byte order of each.
+     *
+     * @param dst   Where to write the values.
+     * @param src   The values to copy.
+     * @param num   Number of values.
+     */
+    static void Swap32(uint32_t* dst, const uint32_t* src, size_t num);
+
+    /**
+     * Copy an array of 64 bit values reversing the byte order of each.
+     *
+     * @param dst   Where to write the values.
+     * @param src   The values to copy.
+     * @param num   Number of values.
+     */
+    static void Swap64(uint64_t* dst, const uint64_t* src, size_t num);
+
+    /**
+     * Convert an array of marshaled booleans, which are 32 bit values that
+     * must be 0 or 1, to an array of bool.
+     *
+     * @param dst          Where to write the booleans.
+     * @param src          The marshaled booleans.
+     * @param num          Number of booleans.
+     * @param endianSwap   True if the marshaled booleans are in non-native endianess.
+     *
+     * @return  false if any of the marshaled values is not 0 or 1.
+     */
+    static bool UnmarshalBooleans(bool* dst, const uint32_t* src, size_t num, bool endianSwap);
+
+    /**
+     * Convert an array of bool to marshaled booleans.
+     *
+     * @param dst          Where to write the marshaled booleans.
+     * @param src          The booleans.
+     * @param num          Number of booleans.
+     * @param endianSwap   True if the booleans are to be marshaled in non-native endianess.
+     */
+    static void MarshalBooleans(uint32_t* dst, const bool* src, size_t num, bool endianSwap);
+};
+
+}
+
+#endif
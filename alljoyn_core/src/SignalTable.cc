@@ -36,6 +36,15 @@ using namespace std;
 
 namespace ajn {
 
+SignalTable::SignalTable() : published(new Snapshot(hashTable)), stale(0)
+{
+}
+
+SignalTable::~SignalTable()
+{
+    published.Current()->Release();
+}
+
 void SignalTable::Add(MessageReceiver* receiver,
                       MessageReceiver::SignalHandler handler,
                       const InterfaceDescription::Member* member,
@@ -49,6 +58,8 @@ void SignalTable::Add(MessageReceiver* receiver,
     Key key(member->iface->GetName(), member->name);
     lock.Lock(MUTEX_CONTEXT);
     hashTable.insert(pair<const Key, Entry>(key, entry));
+    /* Readers see the change once the next Find() publishes it */
+    stale = 1;
     lock.Unlock(MUTEX_CONTEXT);
 }
 
@@ -71,6 +82,8 @@ QStatus SignalTable::Remove(MessageReceiver* receiver,
             (iter->second.handler == handler) &&
             (iter->second.rule == matchRule)) {
             hashTable.erase(iter);
+            /* The receiver may be deleted as soon as we return so this can't wait */
+            Publish();
             status = ER_OK;
             break;
         } else {
@@ -83,26 +96,53 @@ QStatus SignalTable::Remove(MessageReceiver* receiver,
 
 void SignalTable::RemoveAll(MessageReceiver* receiver)
 {
-    bool removed;
+    bool removed = false;
     lock.Lock(MUTEX_CONTEXT);
-    do {
-        removed = false;
-        for (iterator iter = hashTable.begin(); iter != hashTable.end(); ++iter) {
-            if (iter->second.object == receiver) {
-                hashTable.erase(iter);
-                removed = true;
-                break;
-            }
+    iterator iter = hashTable.begin();
+    while (iter != hashTable.end()) {
+        if (iter->second.object == receiver) {
+            iter = hashTable.erase(iter);
+            removed = true;
+        } else {
+            ++iter;
         }
-    } while (removed);
+    }
+    if (removed) {
+        Publish();
+    }
     lock.Unlock(MUTEX_CONTEXT);
 }
 
-pair<SignalTable::const_iterator, SignalTable::const_iterator> SignalTable::Find(const char* iface,
-                                                                                 const char* signalName)
+void SignalTable::Find(const char* iface, const char* signalName, SafeRange& found)
 {
+    QCC_ASSERT(found.snapshot == NULL);
+    if (stale) {
+        lock.Lock(MUTEX_CONTEXT);
+        if (stale) {
+            Publish();
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+    }
     Key key(iface, signalName);
-    return hashTable.equal_range(key);
+    EpochPointer<Snapshot>::ReadGuard guard(published);
+    const Snapshot* snapshot = guard.Get();
+    pair<const_iterator, const_iterator> range = snapshot->table.equal_range(key);
+    if (range.first != range.second) {
+        qcc::IncrementAndFetch(&snapshot->refCount);
+        found.snapshot = snapshot;
+        found.first = range.first;
+        found.last = range.second;
+    }
+}
+
+void SignalTable::Publish()
+{
+    /*
+     * Readers may still hold the previous snapshot through a SafeRange in
+     * which case the last of them deletes it.
+     */
+    stale = 0;
+    published.Exchange(new Snapshot(hashTable))->Release();
 }
 
 }
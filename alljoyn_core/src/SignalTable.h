@@ -33,12 +33,14 @@
 #include <qcc/String.h>
 #include <qcc/StringMapKey.h>
 #include <qcc/Mutex.h>
+#include <qcc/Util.h>
 
 #include <alljoyn/InterfaceDescription.h>
 #include <alljoyn/MessageReceiver.h>
 
 #include <alljoyn/Status.h>
 
+#include "EpochPointer.h"
 #include "Rule.h"
 
 #include <qcc/STLContainer.h>
@@ -47,6 +49,8 @@ namespace ajn {
 
 /**
  * %SignalTable is a multimap that maps interface/signalname to SignalHandler instances.
+ * Lookups read an immutable copy of the table that is republished whenever
+ * the table changes, so dispatching a signal takes no lock.
  */
 class SignalTable {
 
@@ -100,14 +104,11 @@ class SignalTable {
     struct Hash {
         /** Calculate hash for Key k */
         size_t operator()(const Key& k) const {
-            size_t hash = 0;
-            for (const char* p = k.signalName.c_str(); *p; ++p) {
-                hash = *p + hash * 11;
-            }
-            for (const char* p = k.iface.c_str(); *p; ++p) {
-                hash += *p * 7;
-            }
-            return hash;
+            /* FNV-1a over both strings including their terminators */
+            uint64_t hash = qcc::FNV1A_64_INIT;
+            hash = qcc::hash_fnv1a(k.iface.c_str(), k.iface.size() + 1, hash);
+            hash = qcc::hash_fnv1a(k.signalName.c_str(), k.signalName.size() + 1, hash);
+            return static_cast<size_t>(hash);
         }
     };
 
@@ -131,7 +132,68 @@ class SignalTable {
     typedef std::unordered_multimap<Key, Entry, Hash, Equal>::const_iterator const_iterator;
 
     /**
-     * Add an entry to the signal hash table.
+     * Immutable copy of the table shared by Find() callers.
+     */
+    struct Snapshot {
+        std::unordered_multimap<Key, Entry, Hash, Equal> table;  /**< The signal handlers */
+        mutable volatile int32_t refCount;                      /**< The table's and SafeRange references */
+
+        /**
+         * Construct a Snapshot referenced by the table.
+         */
+        Snapshot(const std::unordered_multimap<Key, Entry, Hash, Equal>& table) : table(table), refCount(1) { }
+
+        /**
+         * Drop a reference, deleting the snapshot with the last one.
+         */
+        void Release() const
+        {
+            if (qcc::DecrementAndFetch(&refCount) == 0) {
+                delete this;
+            }
+        }
+    };
+
+    /**
+     * A pinned range of entries returned by Find(). The entries remain valid
+     * while the SafeRange exists even if they are removed from the table, so
+     * handlers may be called without holding any lock.
+     */
+    class SafeRange {
+      public:
+        SafeRange() : snapshot(NULL) { }
+
+        ~SafeRange()
+        {
+            if (snapshot) {
+                snapshot->Release();
+            }
+        }
+
+        /** Start of the range */
+        const_iterator begin() const { return first; }
+
+        /** End of the range */
+        const_iterator end() const { return last; }
+
+        /** Return true if there are no entries in the range */
+        bool empty() const { return first == last; }
+
+      private:
+        friend class SignalTable;
+
+        SafeRange(const SafeRange& other);
+        SafeRange& operator=(const SafeRange& other);
+
+        const Snapshot* snapshot;
+        const_iterator first;
+        const_iterator last;
+    };
+
+    /**
+     * Add an entry to the signal hash table. Additions are published to
+     * readers by the next Find() so that registering many handlers copies
+     * the table once rather than once per handler.
      *
      * @param receiver    Object receiving the message.
      * @param func        Handler for signal.
@@ -166,32 +228,41 @@ class SignalTable {
     void RemoveAll(MessageReceiver* receiver);
 
     /**
-     * Find Entries for a certain signal
-     * Signal table lock should be held until iterators are no longer in use.
+     * Find Entries for a certain signal. The lookup takes no lock and does
+     * not allocate, except that the first lookup after entries were added
+     * publishes them.
      *
-     * @param iface    The interface.
+     * @param iface        The interface.
      * @param signalName   The signal name.
-     *
-     * @return   Iterator range of entries with matching criteria.
+     * @param[out] found   Pinned range of entries with matching criteria.
      */
-    std::pair<const_iterator, const_iterator> Find(const char* iface, const char* signalName);
+    void Find(const char* iface, const char* signalName, SafeRange& found);
 
     /**
-     * Get the lock that protects the signal table.
+     * Constructor
      */
-    void Lock(void) { lock.Lock(MUTEX_CONTEXT); }
+    SignalTable();
 
     /**
-     * Release the lock that protects the signal table.
+     * Destructor
      */
-    void Unlock(void) { lock.Unlock(MUTEX_CONTEXT); }
+    ~SignalTable();
 
   private:
 
-    qcc::Mutex lock; /**< Lock protecting the signal table */
+    /**
+     * Publish a copy of the writer's table to readers. Must be called with
+     * lock held.
+     */
+    void Publish();
+
+    qcc::Mutex lock; /**< Lock serializing changes to the signal table */
 
     /**  The hash table */
     std::unordered_multimap<Key, Entry, Hash, Equal> hashTable;
+
+    EpochPointer<Snapshot> published; /**< Immutable copy of the table used by Find() */
+    volatile int32_t stale;           /**< Non-zero when entries were added since the last Publish() */
 };
 
 }
@@ -23,9 +23,12 @@
 #include <qcc/StaticGlobals.h>
 #include <alljoyn/Init.h>
 #include <alljoyn/PasswordManager.h>
+#include "AboutObjectDescriptionInternal.h"
 #include "AutoPingerInternal.h"
 #include "BusInternal.h"
 #include "NamedPipeClientTransport.h"
+#include "PropChangedCoalescer.h"
+#include "XmlHelper.h"
 
 namespace ajn {
 
@@ -37,10 +40,16 @@ class StaticGlobals {
         AutoPingerInternal::Init();
         PasswordManager::Init();
         BusAttachment::Internal::Init();
+        XmlHelper::Init();
+        PropChangedCoalescer::Init();
+        AnnouncedObjectsCache::Init();
     }
 
     static void Shutdown()
     {
+        AnnouncedObjectsCache::Shutdown();
+        PropChangedCoalescer::Shutdown();
+        XmlHelper::Shutdown();
         BusAttachment::Internal::Shutdown();
         PasswordManager::Shutdown();
         AutoPingerInternal::Shutdown();
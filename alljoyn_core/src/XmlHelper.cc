@@ -23,9 +23,18 @@
 #include <qcc/platform.h>
 
 
+#include <string.h>
+#include <list>
+
 #include <qcc/Debug.h>
+#include <qcc/Mutex.h>
+#include <qcc/STLContainer.h>
 #include <qcc/String.h>
+#include <qcc/StringSource.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Util.h>
 #include <qcc/XmlElement.h>
+#include <qcc/atomic.h>
 
 #include <alljoyn/AllJoynStd.h>
 #include <alljoyn/BusAttachment.h>
@@ -75,6 +84,17 @@ bool GetDescription(const XmlElement* elem, qcc::String& description)
 }
 
 QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
+{
+    InterfaceDescription* intf = NULL;
+    QStatus status = ParseInterface(elem, intf);
+    if (intf) {
+        status = AddInterface(*intf, obj);
+        delete intf;
+    }
+    return status;
+}
+
+QStatus XmlHelper::ParseInterface(const XmlElement* elem, InterfaceDescription*& parsed)
 {
     QStatus status = ER_OK;
     InterfaceSecurityPolicy secPolicy;
@@ -117,7 +137,8 @@ QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
     }
 
     /* Create a new interface */
-    InterfaceDescription intf(ifName.c_str(), secPolicy);
+    parsed = new InterfaceDescription(ifName.c_str(), secPolicy);
+    InterfaceDescription& intf = *parsed;
 
     /* Iterate over <method>, <signal> and <property> elements */
     vector<XmlElement*>::const_iterator ifIt = elem->GetChildren().begin();
@@ -283,37 +304,44 @@ QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
             break;
         }
     }
+    if (ER_OK != status) {
+        delete parsed;
+        parsed = NULL;
+    }
+    return status;
+}
+
+QStatus XmlHelper::AddInterface(const InterfaceDescription& intf, ProxyBusObject* obj)
+{
     /* Add the interface with all its methods, signals and properties */
+    InterfaceDescription* newIntf = NULL;
+    QStatus status = bus->CreateInterface(intf.GetName(), newIntf);
     if (ER_OK == status) {
-        InterfaceDescription* newIntf = NULL;
-        status = bus->CreateInterface(intf.GetName(), newIntf);
-        if (ER_OK == status) {
-            /* Assign new interface */
-            *newIntf = intf;
-            newIntf->Activate();
-            if (obj) {
-                obj->AddInterface(*newIntf);
-            }
-        } else if (ER_BUS_IFACE_ALREADY_EXISTS == status) {
-            /* Make sure definition matches existing one */
-            const InterfaceDescription* existingIntf = bus->GetInterface(intf.GetName());
-            if (existingIntf) {
-                if (*existingIntf == intf) {
-                    if (obj) {
-                        obj->AddInterface(*existingIntf);
-                    }
-                    status = ER_OK;
-                } else {
-                    status = ER_BUS_INTERFACE_MISMATCH;
-                    QCC_LogError(status, ("XML interface does not match existing definition for \"%s\"", intf.GetName()));
+        /* Assign new interface */
+        *newIntf = intf;
+        newIntf->Activate();
+        if (obj) {
+            obj->AddInterface(*newIntf);
+        }
+    } else if (ER_BUS_IFACE_ALREADY_EXISTS == status) {
+        /* Make sure definition matches existing one */
+        const InterfaceDescription* existingIntf = bus->GetInterface(intf.GetName());
+        if (existingIntf) {
+            if (*existingIntf == intf) {
+                if (obj) {
+                    obj->AddInterface(*existingIntf);
                 }
+                status = ER_OK;
             } else {
-                status = ER_FAIL;
-                QCC_LogError(status, ("Failed to retrieve existing interface \"%s\"", intf.GetName()));
+                status = ER_BUS_INTERFACE_MISMATCH;
+                QCC_LogError(status, ("XML interface does not match existing definition for \"%s\"", intf.GetName()));
             }
         } else {
-            QCC_LogError(status, ("Failed to create new inteface \"%s\"", intf.GetName()));
+            status = ER_FAIL;
+            QCC_LogError(status, ("Failed to retrieve existing interface \"%s\"", intf.GetName()));
         }
+    } else {
+        QCC_LogError(status, ("Failed to create new inteface \"%s\"", intf.GetName()));
     }
     return status;
 }
@@ -372,4 +400,463 @@ QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj)
     return status;
 }
 
+const size_t XmlHelper::MAX_CACHED_INTERFACES;
+const size_t XmlHelper::MAX_CACHED_INTERFACE_BYTES;
+const size_t XmlHelper::MAX_CACHED_INTERFACE_SIZE;
+
+/*
+ * Interfaces parsed from introspection XML.  The same interfaces, the standard
+ * ones in particular, show up in the introspection of most remote objects so
+ * they are kept keyed by a hash of the XML of the <interface> element.  An
+ * interface dropped from the cache lives on until the scans using it release
+ * their references.
+ */
+class XmlHelper::CachedInterface {
+  public:
+    qcc::String xml;
+    InterfaceDescription* intf;   /* NULL for the standard interfaces that are ignored */
+
+    CachedInterface(const qcc::String& xml, InterfaceDescription* intf) : xml(xml), intf(intf), refCount(1) { }
+
+    void AddRef() { IncrementAndFetch(&refCount); }
+
+    void Release()
+    {
+        if (DecrementAndFetch(&refCount) == 0) {
+            delete this;
+        }
+    }
+
+  private:
+    ~CachedInterface() { delete intf; }
+
+    CachedInterface(const CachedInterface& other);
+    CachedInterface& operator=(const CachedInterface& other);
+
+    volatile int32_t refCount;
+};
+
+/*
+ * The cached interfaces with the most recently used first, indexed by the hash
+ * of their XML.
+ */
+struct InterfaceCache {
+    typedef std::list<XmlHelper::CachedInterface*> UseList;
+    typedef std::unordered_multimap<uint64_t, UseList::iterator> Index;
+
+    UseList used;
+    Index index;
+    size_t bytes;
+
+    InterfaceCache() : bytes(0) { }
+};
+
+static InterfaceCache* interfaceCache = NULL;
+static qcc::Mutex* interfaceCacheLock = NULL;
+
+void XmlHelper::Init()
+{
+    interfaceCache = new InterfaceCache();
+    interfaceCacheLock = new qcc::Mutex();
+}
+
+void XmlHelper::Shutdown()
+{
+    for (InterfaceCache::UseList::iterator it = interfaceCache->used.begin(); it != interfaceCache->used.end(); ++it) {
+        (*it)->Release();
+    }
+    delete interfaceCache;
+    interfaceCache = NULL;
+    delete interfaceCacheLock;
+    interfaceCacheLock = NULL;
+}
+
+void XmlHelper::GetInterfaceCacheSize(size_t& count, size_t& bytes)
+{
+    count = 0;
+    bytes = 0;
+    if (interfaceCacheLock) {
+        interfaceCacheLock->Lock(MUTEX_CONTEXT);
+        count = interfaceCache->used.size();
+        bytes = interfaceCache->bytes;
+        interfaceCacheLock->Unlock(MUTEX_CONTEXT);
+    }
+}
+
+/*
+ * A tag found by the introspection XML scanner.  Only the attributes that are
+ * needed at the <node> level are kept.
+ */
+struct XmlTag {
+    const char* start;      /* The '<' of the tag */
+    qcc::String name;
+    bool isEnd;             /* The tag is an end tag </name> */
+    bool isEmpty;           /* The tag is an empty element tag <name/> */
+    qcc::String nameAttr;
+    qcc::String valueAttr;
+};
+
+/*
+ * Find the next tag skipping content, comments, declarations and processing
+ * instructions the same way the XmlElement parser does.
+ *
+ * @return ER_OK if a tag was found, ER_EOF if there are no more tags or
+ *         ER_BUS_BAD_XML if the tag is not as expected.
+ */
+static QStatus NextTag(const char*& xml, XmlTag& tag)
+{
+    const char* p = strchr(xml, '<');
+    while (p && ((p[1] == '!') || (p[1] == '?'))) {
+        p = strchr(p, '>');
+        if (p) {
+            p = strchr(p, '<');
+        }
+    }
+    if (!p) {
+        return ER_EOF;
+    }
+    tag.start = p++;
+    tag.name.clear();
+    tag.isEnd = false;
+    tag.isEmpty = false;
+    tag.nameAttr.clear();
+    tag.valueAttr.clear();
+
+    while (IsWhite(*p)) {
+        ++p;
+    }
+    if (*p == '/') {
+        tag.isEnd = true;
+        ++p;
+    }
+    const char* name = p;
+    while (*p && !IsWhite(*p) && (*p != '>') && (*p != '/')) {
+        ++p;
+    }
+    if (p == name) {
+        return ER_BUS_BAD_XML;
+    }
+    tag.name.assign(name, p - name);
+
+    /* Attributes */
+    while (true) {
+        while (IsWhite(*p)) {
+            ++p;
+        }
+        if (*p == '>') {
+            ++p;
+            break;
+        } else if (*p == '/') {
+            tag.isEmpty = true;
+            ++p;
+            continue;
+        }
+        const char* attr = p;
+        while (*p && !IsWhite(*p) && (*p != '=') && (*p != '>') && (*p != '/')) {
+            ++p;
+        }
+        size_t attrLen = p - attr;
+        while (IsWhite(*p)) {
+            ++p;
+        }
+        if ((attrLen == 0) || (*p++ != '=')) {
+            return ER_BUS_BAD_XML;
+        }
+        while (IsWhite(*p)) {
+            ++p;
+        }
+        const char quote = *p;
+        if ((quote != '"') && (quote != '\'')) {
+            return ER_BUS_BAD_XML;
+        }
+        const char* value = ++p;
+        p = strchr(p, quote);
+        if (!p) {
+            return ER_BUS_BAD_XML;
+        }
+        qcc::String* target = NULL;
+        if ((attrLen == 4) && (strncmp(attr, "name", 4) == 0)) {
+            target = &tag.nameAttr;
+        } else if ((attrLen == 5) && (strncmp(attr, "value", 5) == 0)) {
+            target = &tag.valueAttr;
+        }
+        if (target) {
+            target->assign(value, p - value);
+            if (target->find_first_of('&') != qcc::String::npos) {
+                *target = XmlElement::UnescapeXml(*target);
+            }
+        }
+        ++p;
+    }
+    if (tag.isEnd && tag.isEmpty) {
+        return ER_BUS_BAD_XML;
+    }
+    xml = p;
+    return ER_OK;
+}
+
+/*
+ * Skip over the content and end tag of an element whose start tag has just
+ * been scanned.
+ */
+static QStatus SkipElement(const char*& xml, const XmlTag& start)
+{
+    if (start.isEmpty) {
+        return ER_OK;
+    }
+    XmlTag tag;
+    size_t depth = 1;
+    while (depth > 0) {
+        QStatus status = NextTag(xml, tag);
+        if (status != ER_OK) {
+            return ER_BUS_BAD_XML;
+        }
+        if (tag.isEnd) {
+            --depth;
+        } else if (!tag.isEmpty) {
+            ++depth;
+        }
+    }
+    return ER_OK;
+}
+
+/*
+ * Look ahead through the children of a <node> element for the secure
+ * annotation since it applies to child nodes that may come before it.
+ */
+static bool IsSecureNode(const char* xml)
+{
+    XmlTag tag;
+    while (NextTag(xml, tag) == ER_OK) {
+        if (tag.isEnd) {
+            break;
+        }
+        if ((tag.name == "annotation") && (tag.nameAttr == org::alljoyn::Bus::Secure)) {
+            return (tag.valueAttr == "true");
+        }
+        if (SkipElement(xml, tag) != ER_OK) {
+            break;
+        }
+    }
+    return false;
+}
+
+/*
+ * Nothing is added to the bus or the proxy objects while scanning so that a
+ * document the scanner rejects can be handed to the XmlElement parser as if
+ * the scanner had never seen it.
+ */
+class XmlHelper::ScannedNode {
+  public:
+    ScannedNode(const qcc::String& relativePath) : relativePath(relativePath), isSecure(false) { }
+
+    ~ScannedNode()
+    {
+        for (std::vector<ScannedNode*>::iterator it = children.begin(); it != children.end(); ++it) {
+            delete *it;
+        }
+    }
+
+    qcc::String relativePath;
+    bool isSecure;
+    std::vector<const InterfaceDescription*> interfaces;
+    std::vector<ScannedNode*> children;
+
+  private:
+    ScannedNode(const ScannedNode& other);
+    ScannedNode& operator=(const ScannedNode& other);
+};
+
+QStatus XmlHelper::ScanProxyObjects(ProxyBusObject& parent, const char* xml)
+{
+    XmlTag tag;
+    QStatus status = NextTag(xml, tag);
+    if ((status != ER_OK) || tag.isEnd || (tag.name != "node")) {
+        return ER_BUS_BAD_XML;
+    }
+    if (tag.isEmpty) {
+        return ER_OK;
+    }
+    ScannedNode root(qcc::String::Empty);
+    std::vector<CachedInterface*> used;
+    status = ScanNode(xml, parent.GetPath(), root, used);
+    if (status == ER_OK) {
+        status = AddScannedNode(root, parent);
+    }
+    for (std::vector<CachedInterface*>::iterator it = used.begin(); it != used.end(); ++it) {
+        (*it)->Release();
+    }
+    return status;
+}
+
+QStatus XmlHelper::ScanNode(const char*& xml, const qcc::String& path, ScannedNode& node, std::vector<CachedInterface*>& used)
+{
+    node.isSecure = IsSecureNode(xml);
+    /* Iterate over <interface> and <node> elements */
+    XmlTag tag;
+    while (true) {
+        QStatus status = NextTag(xml, tag);
+        if (status != ER_OK) {
+            return ER_BUS_BAD_XML;
+        }
+        if (tag.isEnd) {
+            return ER_OK;
+        }
+        if (tag.name == "interface") {
+            const char* start = tag.start;
+            status = SkipElement(xml, tag);
+            if (status == ER_OK) {
+                const InterfaceDescription* intf = NULL;
+                status = ScanInterface(start, xml - start, intf, used);
+                if (intf) {
+                    node.interfaces.push_back(intf);
+                }
+            }
+        } else if (tag.name == "node") {
+            const qcc::String& relativePath = tag.nameAttr;
+            qcc::String childObjPath = path;
+            if (childObjPath.size() > 1) {
+                childObjPath += '/';
+            }
+            childObjPath += relativePath;
+            if (!relativePath.empty() && IsLegalObjectPath(childObjPath.c_str())) {
+                ScannedNode* child = new ScannedNode(relativePath);
+                node.children.push_back(child);
+                status = tag.isEmpty ? ER_OK : ScanNode(xml, childObjPath, *child, used);
+            } else {
+                status = ER_FAIL;
+                QCC_LogError(status, ("Illegal child object name \"%s\" specified in introspection for %s", relativePath.c_str(), ident));
+            }
+        } else {
+            status = SkipElement(xml, tag);
+        }
+        if (status != ER_OK) {
+            return status;
+        }
+    }
+}
+
+QStatus XmlHelper::AddScannedNode(const ScannedNode& node, ProxyBusObject& obj)
+{
+    if (node.isSecure) {
+        obj.SetSecure(true);
+    }
+    QStatus status = ER_OK;
+    for (std::vector<const InterfaceDescription*>::const_iterator it = node.interfaces.begin(); (ER_OK == status) && (it != node.interfaces.end()); ++it) {
+        status = AddInterface(**it, &obj);
+    }
+    for (std::vector<ScannedNode*>::const_iterator it = node.children.begin(); (ER_OK == status) && (it != node.children.end()); ++it) {
+        const ScannedNode& child = **it;
+        qcc::String childObjPath = obj.GetPath();
+        if (childObjPath.size() > 1) {
+            childObjPath += '/';
+        }
+        childObjPath += child.relativePath;
+        /* Check for existing child with the same name. Use this child if found, otherwise create a new one */
+        ProxyBusObject* childObj = obj.GetChild(child.relativePath.c_str());
+        if (childObj) {
+            status = AddScannedNode(child, *childObj);
+        } else {
+            ProxyBusObject newChild(*bus, obj.GetServiceName().c_str(), obj.GetUniqueName().c_str(), childObjPath.c_str(), obj.GetSessionId(), obj.IsSecure());
+            status = AddScannedNode(child, newChild);
+            if (ER_OK == status) {
+                obj.AddChild(newChild);
+            }
+        }
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Failed to parse child object %s in introspection data for %s", childObjPath.c_str(), ident));
+        }
+    }
+    return status;
+}
+
+/*
+ * Find an interface in the cache and make it the most recently used.  Must be
+ * called with interfaceCacheLock held.
+ */
+static XmlHelper::CachedInterface* FindCachedInterface(uint64_t hash, const char* xml, size_t len)
+{
+    pair<InterfaceCache::Index::iterator, InterfaceCache::Index::iterator> range = interfaceCache->index.equal_range(hash);
+    for (InterfaceCache::Index::iterator it = range.first; it != range.second; ++it) {
+        XmlHelper::CachedInterface* cached = *it->second;
+        if ((cached->xml.size() == len) && (memcmp(cached->xml.data(), xml, len) == 0)) {
+            interfaceCache->used.splice(interfaceCache->used.begin(), interfaceCache->used, it->second);
+            return cached;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Drop the least recently used interface from the cache.  Must be called with
+ * interfaceCacheLock held.
+ */
+static void DropCachedInterface()
+{
+    XmlHelper::CachedInterface* oldest = interfaceCache->used.back();
+    uint64_t hash = hash_fnv1a(oldest->xml.data(), oldest->xml.size());
+    pair<InterfaceCache::Index::iterator, InterfaceCache::Index::iterator> range = interfaceCache->index.equal_range(hash);
+    for (InterfaceCache::Index::iterator it = range.first; it != range.second; ++it) {
+        if (*it->second == oldest) {
+            interfaceCache->index.erase(it);
+            break;
+        }
+    }
+    interfaceCache->bytes -= oldest->xml.size();
+    interfaceCache->used.pop_back();
+    oldest->Release();
+}
+
+QStatus XmlHelper::ScanInterface(const char* xml, size_t len, const InterfaceDescription*& intf, std::vector<CachedInterface*>& used)
+{
+    uint64_t hash = hash_fnv1a(xml, len);
+    CachedInterface* cached = NULL;
+    if (interfaceCacheLock) {
+        interfaceCacheLock->Lock(MUTEX_CONTEXT);
+        cached = FindCachedInterface(hash, xml, len);
+        if (cached) {
+            cached->AddRef();
+        }
+        interfaceCacheLock->Unlock(MUTEX_CONTEXT);
+    }
+    if (cached) {
+        /* Cached interfaces are never changed so the reference keeps this valid */
+        used.push_back(cached);
+        intf = cached->intf;
+        return ER_OK;
+    }
+
+    /* Not seen before so parse the <interface> element */
+    qcc::String text(xml, len);
+    StringSource source(text);
+    XmlParseContext pc(source);
+    QStatus status = XmlElement::Parse(pc);
+    if ((status != ER_OK) || (pc.GetRoot()->GetName() != "interface")) {
+        return ER_BUS_BAD_XML;
+    }
+    InterfaceDescription* newIntf = NULL;
+    status = ParseInterface(pc.GetRoot(), newIntf);
+    if (status != ER_OK) {
+        return status;
+    }
+    cached = new CachedInterface(text, newIntf);
+    used.push_back(cached);
+    if (interfaceCacheLock && (len <= MAX_CACHED_INTERFACE_SIZE)) {
+        interfaceCacheLock->Lock(MUTEX_CONTEXT);
+        if (!FindCachedInterface(hash, xml, len)) {
+            while (!interfaceCache->used.empty() &&
+                   ((interfaceCache->used.size() >= MAX_CACHED_INTERFACES) || ((interfaceCache->bytes + len) > MAX_CACHED_INTERFACE_BYTES))) {
+                DropCachedInterface();
+            }
+            cached->AddRef();
+            interfaceCache->used.push_front(cached);
+            interfaceCache->index.insert(pair<uint64_t, InterfaceCache::UseList::iterator>(hash, interfaceCache->used.begin()));
+            interfaceCache->bytes += len;
+        }
+        interfaceCacheLock->Unlock(MUTEX_CONTEXT);
+    }
+    intf = newIntf;
+    return ER_OK;
+}
+
 } // ajn::
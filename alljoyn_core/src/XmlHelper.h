@@ -31,6 +31,8 @@
 #include <qcc/String.h>
 #include <qcc/XmlElement.h>
 
+#include <vector>
+
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/ProxyBusObject.h>
 #include <alljoyn/InterfaceDescription.h>
@@ -85,11 +87,120 @@ class XmlHelper {
         }
     }
 
+    /**
+     * Scan introspection XML adding all nodes as children of a parent proxy object.
+     *
+     * This does the same as AddProxyObjects() in a single pass over the XML without building
+     * an XmlElement tree for it.  Only <interface> elements that are not in the interface
+     * cache are parsed into XmlElements.  The scanner is stricter than the XmlElement parser
+     * so the caller should fall back to AddProxyObjects() if this returns #ER_BUS_BAD_XML.
+     * The whole document is scanned before anything is added to the bus or the proxy objects
+     * so #ER_BUS_BAD_XML also means that nothing was changed.
+     *
+     * @param parent  The parent proxy object to add the children too.
+     * @param xml     The introspection XML. The root must be a <node> element.
+     *
+     * @return #ER_OK if the XML was well formed and the children were added.
+     *         #ER_BUS_BAD_XML if the XML was not as expected.
+     *         #Other errors indicating the children were not succesfully added.
+     */
+    QStatus ScanProxyObjects(ProxyBusObject& parent, const char* xml);
+
+    /**
+     * Create the process-wide cache of interfaces parsed from introspection XML.
+     */
+    static void Init();
+
+    /**
+     * Destroy the process-wide cache of interfaces parsed from introspection XML.
+     */
+    static void Shutdown();
+
+    /**
+     * Get the number of interfaces in the interface cache and the total size of their XML.
+     *
+     * @param[out] count  Number of cached interfaces.
+     * @param[out] bytes  Total size of the XML of the cached interfaces.
+     */
+    static void GetInterfaceCacheSize(size_t& count, size_t& bytes);
+
+    /**
+     * Maximum number of interfaces kept in the interface cache.
+     */
+    static const size_t MAX_CACHED_INTERFACES = 512;
+
+    /**
+     * Maximum total size of the XML of the interfaces kept in the interface cache. The least
+     * recently used interfaces are dropped to stay within this and MAX_CACHED_INTERFACES.
+     */
+    static const size_t MAX_CACHED_INTERFACE_BYTES = 256 * 1024;
+
+    /**
+     * Interfaces with more XML than this are parsed every time rather than cached.
+     */
+    static const size_t MAX_CACHED_INTERFACE_SIZE = 16 * 1024;
+
+    /**
+     * An interface parsed from introspection XML, shared by the interface cache and the
+     * scans that use it.
+     */
+    class CachedInterface;
+
   private:
 
     QStatus ParseNode(const qcc::XmlElement* elem, ProxyBusObject* obj);
     QStatus ParseInterface(const qcc::XmlElement* elem, ProxyBusObject* obj);
 
+    /**
+     * Build an interface from an <interface> element.
+     *
+     * @param elem         The <interface> element.
+     * @param[out] parsed  Returns a new interface that the caller must delete, or NULL on
+     *                     failure or if this is one of the standard interfaces that are
+     *                     ignored in introspection XML.
+     */
+    QStatus ParseInterface(const qcc::XmlElement* elem, InterfaceDescription*& parsed);
+
+    /**
+     * Add an interface to the bus, or check that it matches the one the bus has, and to a
+     * proxy object.
+     */
+    QStatus AddInterface(const InterfaceDescription& intf, ProxyBusObject* obj);
+
+    /**
+     * The interfaces and children of a <node> element found by the scanner.
+     */
+    class ScannedNode;
+
+    /**
+     * Scan the content of a <node> element up to and including its end tag.
+     *
+     * @param xml          The XML following the start tag of the <node> element.
+     * @param path         The object path of the node.
+     * @param node         Returns what was found in the node.
+     * @param[out] used    References to the interfaces used by the scan that the caller must
+     *                     release once it is done with them.
+     */
+    QStatus ScanNode(const char*& xml, const qcc::String& path, ScannedNode& node, std::vector<CachedInterface*>& used);
+
+    /**
+     * Get the interface of an <interface> element found by the scanner, parsing it only if
+     * the same XML is not in the interface cache.
+     *
+     * @param xml          The <interface> element.
+     * @param len          The length of the <interface> element.
+     * @param[out] intf    Returns the interface or NULL for the standard interfaces that are
+     *                     ignored in introspection XML.
+     * @param[out] used    Gets a reference to the interface that keeps it valid even if it is
+     *                     dropped from the cache.
+     */
+    QStatus ScanInterface(const char* xml, size_t len, const InterfaceDescription*& intf, std::vector<CachedInterface*>& used);
+
+    /**
+     * Add what the scanner found in a <node> element to a proxy object.
+     */
+    QStatus AddScannedNode(const ScannedNode& node, ProxyBusObject& obj);
+
     BusAttachment* bus;
     const char* ident;
 };
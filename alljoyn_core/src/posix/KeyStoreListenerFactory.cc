@@ -1,6 +1,7 @@
 /**
  * @file
  * The KeyStoreListenerFactory implements the default key store listener to stores key blobs.
+ * Key blobs are stored in a log so that adding or deleting a key only appends to the file.
  */
 
 /******************************************************************************
@@ -20,9 +21,22 @@
  ******************************************************************************/
 
 #include <qcc/platform.h>
+
+#include <sys/types.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
 #include <qcc/Debug.h>
 #include <qcc/String.h>
+#include <qcc/StringSink.h>
 #include <qcc/FileStream.h>
+#include <qcc/Mutex.h>
+#include <qcc/Thread.h>
 #include <qcc/Util.h>
 
 #include <alljoyn/KeyStoreListener.h>
@@ -38,11 +52,56 @@ using namespace qcc;
 
 namespace ajn {
 
+/*
+ * Create the directories leading up to a file
+ */
+static QStatus MakeParentDirs(const qcc::String& fileName)
+{
+    size_t pos = fileName.find_first_of('/', 1);
+    while (pos != qcc::String::npos) {
+        qcc::String dir = fileName.substr(0, pos);
+        if ((mkdir(dir.c_str(), S_IRWXU) != 0) && (errno != EEXIST)) {
+            QCC_LogError(ER_OS_ERROR, ("mkdir(%s) failed with '%s'", dir.c_str(), strerror(errno)));
+            return ER_OS_ERROR;
+        }
+        pos = fileName.find_first_of('/', pos + 1);
+    }
+    return ER_OK;
+}
+
+static QStatus WriteAll(int fd, const qcc::String& data, off_t offset)
+{
+    const char* buf = data.data();
+    size_t len = data.size();
+    while (len > 0) {
+        ssize_t ret = pwrite(fd, buf, len, offset);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            QCC_LogError(ER_OS_ERROR, ("Writing key store failed with '%s'", strerror(errno)));
+            return ER_BUS_WRITE_ERROR;
+        }
+        buf += ret;
+        len -= ret;
+        offset += ret;
+    }
+    return ER_OK;
+}
+
+/*
+ * The key store file is a log of encrypted key records. Storing appends
+ * records for the keys that changed and loading reads only the records that
+ * were appended since the last load. When most of the records in the log have
+ * been superseded a background thread rewrites the log with just the current
+ * keys. A key store file written in the older format, which has all of the
+ * keys in a single encrypted block, is converted to a log when it is loaded.
+ */
 class DefaultKeyStoreListener : public KeyStoreListener {
 
   public:
 
-    DefaultKeyStoreListener(const qcc::String& application, const char* fname) {
+    DefaultKeyStoreListener(const qcc::String& application, const char* fname) : offset(0), fileDev(0), fileIno(0), rewrite(false), compactor(*this) {
         if (fname) {
             fileName = GetHomeDir() + "/" + fname;
         } else {
@@ -50,70 +109,284 @@ class DefaultKeyStoreListener : public KeyStoreListener {
         }
     }
 
+    ~DefaultKeyStoreListener() {
+        compactor.Join();
+    }
+
     QStatus LoadRequest(KeyStore& keyStore) {
         QStatus status;
-        /* Try to load the keystore */
-        {
+        lock.Lock(MUTEX_CONTEXT);
+        int fd = OpenLocked();
+        if (fd < 0) {
+            status = ER_BUS_READ_ERROR;
+            QCC_LogError(status, ("Cannot initialize key store %s", fileName.c_str()));
+            lock.Unlock(MUTEX_CONTEXT);
+            return status;
+        }
+        if (IsSnapshot(fd)) {
+            /* The lock is held on fd so the source must not lock the file again */
             FileSource source(fileName);
-            if (source.IsValid()) {
-                source.Lock(true);
-                status = keyStore.Pull(source, fileName);
-                if (status == ER_OK) {
-                    QCC_DbgHLPrintf(("Read key store from %s", fileName.c_str()));
-                }
-                source.Unlock();
-                return status;
+            status = keyStore.Pull(source, fileName);
+            if (status == ER_OK) {
+                QCC_DbgHLPrintf(("Converting key store %s to a log", fileName.c_str()));
+                status = Compact(keyStore, fd, false);
             }
+        } else if (!rewrite) {
+            status = Replay(keyStore, fd);
+        } else {
+            /* The log is out of step with the key store until it is rewritten */
+            status = ER_OK;
+        }
+        if (status == ER_OK) {
+            QCC_DbgHLPrintf(("Read key store from %s", fileName.c_str()));
         }
-        /* Create an empty keystore */
+        close(fd);
+        lock.Unlock(MUTEX_CONTEXT);
+        return status;
+    }
+
+    QStatus StoreRequest(KeyStore& keyStore) {
+        QStatus status;
+        lock.Lock(MUTEX_CONTEXT);
+        int fd = OpenLocked();
+        if (fd < 0) {
+            status = ER_BUS_WRITE_ERROR;
+            QCC_LogError(status, ("Cannot write key store to %s", fileName.c_str()));
+            lock.Unlock(MUTEX_CONTEXT);
+            return status;
+        }
+        if (IsSnapshot(fd)) {
+            /* Another application wrote the older format */
+            status = Compact(keyStore, fd, false);
+        } else {
+            /* Catch up with records appended by other applications sharing the key store */
+            status = rewrite ? ER_OK : Replay(keyStore, fd);
+            if ((status == ER_OK) && (offset > 0) && !rewrite) {
+                status = Append(keyStore, fd);
+            } else {
+                /* New, unreadable or incompletely written log */
+                status = Compact(keyStore, fd, false);
+            }
+        }
+        if (status == ER_OK) {
+            QCC_DbgHLPrintf(("Wrote key store to %s", fileName.c_str()));
+            if (keyStore.LogNeedsCompaction()) {
+                compactor.Compact(keyStore);
+            }
+        }
+        close(fd);
+        lock.Unlock(MUTEX_CONTEXT);
+        return status;
+    }
+
+  private:
+
+    class Compactor : public qcc::Thread {
+      public:
+        Compactor(DefaultKeyStoreListener& listener) : qcc::Thread("KeyStoreCompactor"), listener(listener), keyStore(NULL) { }
+
+        void Compact(KeyStore& keyStore)
         {
-            FileSink sink(fileName, FileSink::PRIVATE);
-            if (!sink.IsValid()) {
-                status = ER_BUS_WRITE_ERROR;
-                QCC_LogError(status, ("Cannot initialize key store %s", fileName.c_str()));
-                return status;
+            if (!IsRunning()) {
+                Join();
+                this->keyStore = &keyStore;
+                Start();
             }
         }
-        /* Load the empty keystore */
+
+      protected:
+        qcc::ThreadReturn STDCALL Run(void* arg)
         {
-            FileSource source(fileName);
-            if (source.IsValid()) {
-                source.Lock(true);
-                status = keyStore.Pull(source, fileName);
+            QCC_UNUSED(arg);
+            listener.CompactRequest(*keyStore);
+            return 0;
+        }
+
+      private:
+        DefaultKeyStoreListener& listener;
+        KeyStore* keyStore;
+    };
+
+    void CompactRequest(KeyStore& keyStore) {
+        lock.Lock(MUTEX_CONTEXT);
+        int fd = OpenLocked();
+        if (fd >= 0) {
+            if (!IsSnapshot(fd) && keyStore.LogNeedsCompaction()) {
+                QStatus status = Compact(keyStore, fd, true);
                 if (status == ER_OK) {
-                    QCC_DbgHLPrintf(("Initialized key store %s", fileName.c_str()));
-                } else {
-                    QCC_LogError(status, ("Failed to initialize key store %s", fileName.c_str()));
+                    QCC_DbgHLPrintf(("Compacted key store %s", fileName.c_str()));
                 }
-                source.Unlock();
-            } else {
-                status = ER_BUS_READ_ERROR;
             }
-            return status;
+            close(fd);
         }
+        lock.Unlock(MUTEX_CONTEXT);
     }
 
-    QStatus StoreRequest(KeyStore& keyStore) {
-        QStatus status;
-        FileSink sink(fileName, FileSink::PRIVATE);
-        if (sink.IsValid()) {
-            sink.Lock(true);
-            status = keyStore.Push(sink);
+    /*
+     * Open the key store file, creating it if needed, and lock it. The file
+     * may be replaced by another application compacting it while waiting for
+     * the lock in which case the replacement is opened.
+     */
+    int OpenLocked() {
+        while (true) {
+            int fd = open(fileName.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+            if ((fd < 0) && (errno == ENOENT) && (MakeParentDirs(fileName) == ER_OK)) {
+                fd = open(fileName.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+            }
+            if (fd < 0) {
+                QCC_LogError(ER_OS_ERROR, ("open(%s) failed with '%s'", fileName.c_str(), strerror(errno)));
+                return -1;
+            }
+            if (flock(fd, LOCK_EX) != 0) {
+                QCC_LogError(ER_OS_ERROR, ("Lock fd %d failed with '%s'", fd, strerror(errno)));
+                close(fd);
+                return -1;
+            }
+            struct stat fdStat;
+            struct stat pathStat;
+            if ((fstat(fd, &fdStat) == 0) && (stat(fileName.c_str(), &pathStat) == 0) &&
+                (fdStat.st_dev == pathStat.st_dev) && (fdStat.st_ino == pathStat.st_ino)) {
+                if ((fdStat.st_dev != fileDev) || (fdStat.st_ino != fileIno) || (fdStat.st_size < (off_t)offset)) {
+                    /* Not the file that was last read */
+                    fileDev = fdStat.st_dev;
+                    fileIno = fdStat.st_ino;
+                    offset = 0;
+                }
+                return fd;
+            }
+            close(fd);
+        }
+    }
+
+    /*
+     * Check if the file holds a key store in the format that preceded the log
+     */
+    bool IsSnapshot(int fd) {
+        uint8_t magic[4];
+        ssize_t ret = pread(fd, magic, sizeof(magic), 0);
+        return (ret > 0) && !KeyStore::IsLog(magic, ret);
+    }
+
+    /*
+     * Apply the records that were appended to the log since it was last read
+     */
+    QStatus Replay(KeyStore& keyStore, int fd) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            return ER_BUS_READ_ERROR;
+        }
+        size_t len = st.st_size;
+        if ((offset > 0) && (offset == len)) {
+            /* Nothing new */
+            return ER_OK;
+        }
+        const uint8_t* log = NULL;
+        if (len > 0) {
+            void* map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                QCC_LogError(ER_OS_ERROR, ("mmap(%s) failed with '%s'", fileName.c_str(), strerror(errno)));
+                return ER_BUS_READ_ERROR;
+            }
+            log = static_cast<const uint8_t*>(map);
+        }
+        QStatus status = keyStore.PullLog(log, len, offset, fileName);
+        if (log) {
+            munmap(const_cast<uint8_t*>(log), len);
+        }
+        if ((status == ER_OK) && (offset < len)) {
+            /*
+             * Discard a record that was cut short by the end of the file.
+             * PullLog() fails on any other damage, which leaves the file alone.
+             */
+            QCC_DbgHLPrintf(("Truncating key store %s from %u to %u", fileName.c_str(), (unsigned int)len, (unsigned int)offset));
+            if (ftruncate(fd, offset) != 0) {
+                status = ER_BUS_WRITE_ERROR;
+            }
+        }
+        return status;
+    }
+
+    /*
+     * Append the keys that changed to the log
+     */
+    QStatus Append(KeyStore& keyStore, int fd) {
+        StringSink sink;
+        QStatus status = keyStore.PushLog(sink, false);
+        if ((status == ER_OK) && !sink.GetString().empty()) {
+            status = WriteAll(fd, sink.GetString(), offset);
             if (status == ER_OK) {
-                QCC_DbgHLPrintf(("Wrote key store to %s", fileName.c_str()));
+                offset += sink.GetString().size();
+            } else {
+                /* The changes are no longer pending so rewrite the whole log next time */
+                if (ftruncate(fd, offset) != 0) {
+                    QCC_LogError(ER_OS_ERROR, ("Truncating key store failed with '%s'", strerror(errno)));
+                }
+                rewrite = true;
             }
-            sink.Unlock();
-        } else {
-            status = ER_BUS_WRITE_ERROR;
-            QCC_LogError(status, ("Cannot write key store to %s", fileName.c_str()));
         }
         return status;
     }
 
-  private:
+    /*
+     * Replace the log with one holding only the current keys. The new log is
+     * written to a temporary file that is then renamed over the old one so
+     * the old log stays intact until the new one is complete.
+     */
+    QStatus Compact(KeyStore& keyStore, int fd, bool replay) {
+        QStatus status = ER_OK;
+        if (replay) {
+            status = Replay(keyStore, fd);
+            if (status != ER_OK) {
+                return status;
+            }
+        }
+        qcc::String tmpName = fileName + ".tmp";
+        int tmp = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (tmp < 0) {
+            status = ER_BUS_WRITE_ERROR;
+            QCC_LogError(status, ("open(%s) failed with '%s'", tmpName.c_str(), strerror(errno)));
+            return status;
+        }
+        StringSink sink;
+        status = keyStore.PushLog(sink, true);
+        if (status == ER_OK) {
+            status = WriteAll(tmp, sink.GetString(), 0);
+        }
+        if ((status == ER_OK) && (fsync(tmp) != 0)) {
+            status = ER_BUS_WRITE_ERROR;
+        }
+        struct stat st;
+        if ((status == ER_OK) && ((fstat(tmp, &st) != 0) || (rename(tmpName.c_str(), fileName.c_str()) != 0))) {
+            status = ER_BUS_WRITE_ERROR;
+            QCC_LogError(status, ("Replacing key store %s failed with '%s'", fileName.c_str(), strerror(errno)));
+        }
+        close(tmp);
+        if (status == ER_OK) {
+            fileDev = st.st_dev;
+            fileIno = st.st_ino;
+            offset = sink.GetString().size();
+            rewrite = false;
+        } else {
+            unlink(tmpName.c_str());
+            rewrite = true;
+        }
+        return status;
+    }
 
     qcc::String fileName;
 
+    qcc::Mutex lock;    /* Serializes access to the file within this process */
+
+    size_t offset;      /* Offset in the log up to which it has been read or written */
+
+    dev_t fileDev;      /* Identifies the file that offset refers to */
+
+    ino_t fileIno;
+
+    bool rewrite;       /* Changes were lost writing the log so it must be rewritten */
+
+    Compactor compactor;
+
 };
 
 KeyStoreListener* KeyStoreListenerFactory::CreateInstance(const qcc::String& application, const char* fname)
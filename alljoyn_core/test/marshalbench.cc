@@ -0,0 +1,219 @@
+/**
+ * @file
+ *
+ * This file measures the time taken to marshal and unmarshal arrays of
+ * scalar values in native and non-native endianess.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <qcc/Util.h>
+#include <qcc/Pipe.h>
+#include <qcc/String.h>
+#include <qcc/time.h>
+#include <qcc/ManagedObj.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/version.h>
+
+#include <alljoyn/Status.h>
+
+/* Private files included for benchmarking */
+#include <RemoteEndpoint.h>
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+using namespace std;
+using namespace ajn;
+
+static BusAttachment* gBus;
+
+class _BenchMessage : public _Message {
+  public:
+
+    _BenchMessage() : _Message(*gBus) { };
+
+    QStatus MethodCall(const MsgArg* argList, size_t numArgs)
+    {
+        qcc::String sig = MsgArg::Signature(argList, numArgs);
+        return CallMsg(sig, "desti.nation", 0, "/foo/bar", "foo.bar", "test", argList, numArgs, 0);
+    }
+
+    QStatus Deliver(RemoteEndpoint& ep) { return _Message::Deliver(ep); }
+
+    QStatus Read(RemoteEndpoint& ep) { return _Message::Read(ep, true); }
+
+    QStatus Unmarshal(RemoteEndpoint& ep) { return _Message::Unmarshal(ep, true); }
+
+    QStatus UnmarshalBody() { return UnmarshalArgs("*"); }
+};
+
+typedef qcc::ManagedObj<_BenchMessage> BenchMessage;
+
+/*
+ * Marshal, deliver, read and unmarshal a single array argument repeatedly for
+ * at least the requested time and report the average time per round trip.
+ */
+static QStatus Bench(const char* endianess, const MsgArg& arg, size_t numElements, uint32_t duration)
+{
+    QStatus status = ER_OK;
+    Pipe stream;
+    Pipe* pStream = &stream;
+    const bool incoming = false;
+    RemoteEndpoint ep(*gBus, incoming, String::Empty, pStream);
+
+    uint64_t start = GetTimestamp64();
+    uint64_t elapsed = 0;
+    uint32_t iterations = 0;
+    while ((status == ER_OK) && (elapsed < duration)) {
+        BenchMessage msg;
+        status = msg->MethodCall(&arg, 1);
+        if (status == ER_OK) {
+            status = msg->Deliver(ep);
+        }
+        if (status == ER_OK) {
+            status = msg->Read(ep);
+        }
+        if (status == ER_OK) {
+            status = msg->Unmarshal(ep);
+        }
+        if (status == ER_OK) {
+            status = msg->UnmarshalBody();
+        }
+        ++iterations;
+        elapsed = GetTimestamp64() - start;
+    }
+
+    if (status == ER_OK) {
+        printf("%-6s %-4s %8u %10.2f us\n", endianess, arg.Signature().c_str(), (unsigned int)numElements,
+               (1000.0 * elapsed) / iterations);
+    } else {
+        printf("%-6s %-4s %8u failed: %s\n", endianess, arg.Signature().c_str(), (unsigned int)numElements, QCC_StatusText(status));
+    }
+    return status;
+}
+
+static QStatus BenchArrays(const char* endianess, size_t numElements, uint32_t duration)
+{
+    uint8_t* bytes = new uint8_t[numElements];
+    bool* bools = new bool[numElements];
+    int16_t* int16s = new int16_t[numElements];
+    int32_t* int32s = new int32_t[numElements];
+    double* doubles = new double[numElements];
+    for (size_t i = 0; i < numElements; ++i) {
+        bytes[i] = (uint8_t)i;
+        bools[i] = (i & 1) != 0;
+        int16s[i] = (int16_t)i;
+        int32s[i] = (int32_t)(i * 65537);
+        doubles[i] = i * 1.5;
+    }
+
+    MsgArg args[5];
+    args[0].Set("ay", numElements, bytes);
+    args[1].Set("ab", numElements, bools);
+    args[2].Set("an", numElements, int16s);
+    args[3].Set("ai", numElements, int32s);
+    args[4].Set("ad", numElements, doubles);
+
+    QStatus status = ER_OK;
+    for (size_t i = 0; (status == ER_OK) && (i < ArraySize(args)); ++i) {
+        status = Bench(endianess, args[i], numElements, duration);
+    }
+
+    delete [] bytes;
+    delete [] bools;
+    delete [] int16s;
+    delete [] int32s;
+    delete [] doubles;
+    return status;
+}
+
+static void usage(void)
+{
+    printf("Usage: marshalbench [-t <ms>]\n");
+    printf("Options:\n");
+    printf("   -t <ms>   = Minimum time spent on each measurement (default 200)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+#ifdef ROUTER
+    if (AllJoynRouterInit() != ER_OK) {
+        AllJoynShutdown();
+        return 1;
+    }
+#endif
+    uint32_t duration = 200;
+    QStatus status = ER_OK;
+
+    printf("AllJoyn Library version: %s\n", ajn::GetVersion());
+    printf("AllJoyn Library build info: %s\n", ajn::GetBuildInfo());
+
+    /* Parse command line args */
+    for (int j = 1; j < argc; ++j) {
+        if ((0 == strcmp("-t", argv[j])) && ((j + 1) < argc)) {
+            duration = strtoul(argv[++j], NULL, 10);
+            if (duration == 0) {
+                usage();
+                exit(1);
+            }
+        } else {
+            usage();
+            exit(1);
+        }
+    }
+
+    gBus = new BusAttachment("marshalbench");
+    gBus->Start();
+
+    /* The largest size keeps an array of doubles within the maximum message size */
+    const size_t sizes[] = { 16, 256, 4096, 16000 };
+    const struct {
+        const char* name;
+        char endian;
+    } endianess[] = {
+        { "little", ALLJOYN_LITTLE_ENDIAN },
+        { "big", ALLJOYN_BIG_ENDIAN }
+    };
+
+    printf("endian type elements  round trip\n");
+    for (size_t e = 0; (status == ER_OK) && (e < ArraySize(endianess)); ++e) {
+        _Message::SetEndianess(endianess[e].endian);
+        for (size_t s = 0; (status == ER_OK) && (s < ArraySize(sizes)); ++s) {
+            status = BenchArrays(endianess[e].name, sizes[s], duration);
+        }
+    }
+
+    delete gBus;
+
+#ifdef ROUTER
+    AllJoynRouterShutdown();
+#endif
+    AllJoynShutdown();
+    return (status == ER_OK) ? 0 : 1;
+}
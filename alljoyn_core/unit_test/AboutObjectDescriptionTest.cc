@@ -26,10 +26,15 @@
 
 #include <alljoyn/MsgArg.h>
 #include <gtest/gtest.h>
+#include <vector>
 #include <qcc/String.h>
+#include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
+#include <qcc/Util.h>
 
+#include "AboutObjectDescriptionInternal.h"
 #include "BusInternal.h"
+#include "MsgArgUtils.h"
 #include "ajTestCommon.h"
 
 using namespace ajn;
@@ -764,3 +769,67 @@ TEST(AboutObjectDescriptionTest, AssignmentOperator)
 
     EXPECT_TRUE(aodCopy.HasInterface("org.alljoyn.About"));
 }
+
+TEST(AboutObjectDescriptionTest, SameObjectDescription)
+{
+    const char* interfaces[] = { "org.test.A", "org.test.B" };
+    MsgArg objects[2];
+    EXPECT_EQ(ER_OK, objects[0].Set("(oas)", "/test/one", ArraySize(interfaces), interfaces));
+    EXPECT_EQ(ER_OK, objects[1].Set("(oas)", "/test/empty", static_cast<size_t>(0), NULL));
+    MsgArg arg("a(oas)", ArraySize(objects), objects);
+
+    /* Parsing the same object description again gives the same result */
+    AboutObjectDescription aod1(arg);
+    AboutObjectDescription aod2(arg);
+    EXPECT_EQ(static_cast<size_t>(1), aod1.GetPaths(NULL, 0));
+    EXPECT_EQ(static_cast<size_t>(1), aod2.GetPaths(NULL, 0));
+    EXPECT_TRUE(aod2.HasInterface("/test/one", "org.test.B"));
+    EXPECT_FALSE(aod2.HasPath("/test/empty"));
+
+    /* Changing one description does not change the others */
+    const char* more[] = { "org.test.C" };
+    MsgArg moreObjects[1];
+    EXPECT_EQ(ER_OK, moreObjects[0].Set("(oas)", "/test/one", ArraySize(more), more));
+    MsgArg moreArg("a(oas)", ArraySize(moreObjects), moreObjects);
+    EXPECT_EQ(ER_OK, aod2.CreateFromMsgArg(moreArg));
+    EXPECT_EQ(static_cast<size_t>(3), aod2.GetInterfaces("/test/one", NULL, 0));
+    EXPECT_EQ(static_cast<size_t>(2), aod1.GetInterfaces("/test/one", NULL, 0));
+
+    aod1.Clear();
+    EXPECT_FALSE(aod1.HasPath("/test/one"));
+    AboutObjectDescription aod3(arg);
+    EXPECT_EQ(static_cast<size_t>(2), aod3.GetInterfaces("/test/one", NULL, 0));
+    EXPECT_FALSE(aod3.HasInterface("org.test.C"));
+}
+
+TEST(AboutObjectDescriptionTest, CacheReplacesLeastRecentlyUsed)
+{
+    const size_t count = AnnouncedObjectsCache::MAX_ENTRIES + 1;
+    std::vector<MsgArg> args(count);
+    std::vector<uint64_t> hashes(count);
+    for (size_t i = 0; i < count; ++i) {
+        qcc::String path = "/test/lru/" + U32ToString(static_cast<uint32_t>(i));
+        const char* interfaces[] = { "org.test.A" };
+        MsgArg objects[1];
+        EXPECT_EQ(ER_OK, objects[0].Set("(oas)", path.c_str(), ArraySize(interfaces), interfaces));
+        args[i].Set("a(oas)", ArraySize(objects), objects);
+        args[i].Stabilize();
+        hashes[i] = MsgArgUtils::Hash(args[i]);
+    }
+
+    AnnouncedObjects found;
+    for (size_t i = 0; i < count - 1; ++i) {
+        AnnouncedObjects parsed;
+        AnnouncedObjectsCache::Add(args[i], hashes[i], parsed);
+    }
+    /* Using the first description makes the second the least recently used */
+    EXPECT_TRUE(AnnouncedObjectsCache::Find(args[0], hashes[0], found));
+
+    /* A full cache still takes new descriptions */
+    AnnouncedObjects parsed;
+    AnnouncedObjectsCache::Add(args[count - 1], hashes[count - 1], parsed);
+    EXPECT_TRUE(AnnouncedObjectsCache::Find(args[count - 1], hashes[count - 1], found));
+    EXPECT_TRUE(AnnouncedObjectsCache::Find(args[0], hashes[0], found));
+    EXPECT_FALSE(AnnouncedObjectsCache::Find(args[1], hashes[1], found));
+    EXPECT_TRUE(AnnouncedObjectsCache::Find(args[2], hashes[2], found));
+}
@@ -16,9 +16,13 @@
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/AutoPinger.h>
 #include <qcc/Thread.h>
+#include <qcc/time.h>
 #include <gtest/gtest.h>
 #include <qcc/Thread.h>
 
+#include <map>
+#include <set>
+
 #include "ajTestCommon.h"
 
 using namespace ajn;
@@ -202,3 +206,95 @@ TEST_F(AutoPingerTest, Multibus) {
 
 }
 
+
+/*
+ * Records when each group first reported a destination lost.
+ */
+class LostTimeListener : public PingListener {
+  public:
+    LostTimeListener() { }
+
+    virtual void DestinationLost(const qcc::String& group, const qcc::String& destination) {
+        QCC_UNUSED(destination);
+        lock.Lock();
+        if (lostTimes.find(group) == lostTimes.end()) {
+            lostTimes[group] = qcc::GetTimestamp64();
+        }
+        lock.Unlock();
+    }
+
+    virtual void DestinationFound(const qcc::String& group, const qcc::String& destination) {
+        QCC_UNUSED(destination);
+        lock.Lock();
+        found.insert(group);
+        lock.Unlock();
+    }
+
+    bool WaitFor(std::set<qcc::String>& groups, size_t count) {
+        for (int retries = 0; retries < MAX_RETRIES; ++retries) {
+            lock.Lock();
+            size_t n = groups.size();
+            lock.Unlock();
+            if (n >= count) {
+                return true;
+            }
+            qcc::Sleep(10);
+        }
+        return false;
+    }
+
+    std::set<qcc::String> LostGroups() {
+        std::set<qcc::String> groups;
+        lock.Lock();
+        for (std::map<qcc::String, uint64_t>::iterator it = lostTimes.begin(); it != lostTimes.end(); ++it) {
+            groups.insert(it->first);
+        }
+        lock.Unlock();
+        return groups;
+    }
+
+    qcc::Mutex lock;
+    std::set<qcc::String> found;
+    std::map<qcc::String, uint64_t> lostTimes;
+};
+
+/*
+ * Two groups created together with the same interval do not ping at the same
+ * moment. The first periodic ping of the second group comes about 0.382 of the
+ * interval after the groups were created and that of the first group a full
+ * interval after.
+ */
+TEST_F(AutoPingerTest, GroupsStaggered) {
+
+    BusAttachment clientBus("app", false);
+    EXPECT_EQ(ER_OK, clientBus.Start());
+    EXPECT_EQ(ER_OK, clientBus.Connect());
+    qcc::String uniqueName = clientBus.GetUniqueName();
+
+    LostTimeListener listener;
+    uint64_t start = qcc::GetTimestamp64();
+    autoPinger.AddPingGroup("firstgroup", listener, 2);
+    autoPinger.AddPingGroup("secondgroup", listener, 2);
+
+    /* Adding a destination pings it right away, periodic pings follow */
+    EXPECT_EQ(ER_OK, autoPinger.AddDestination("firstgroup", uniqueName));
+    EXPECT_EQ(ER_OK, autoPinger.AddDestination("secondgroup", uniqueName));
+    ASSERT_TRUE(listener.WaitFor(listener.found, 2));
+    clientBus.Disconnect();
+
+    for (int retries = 0; (retries < 400) && (listener.LostGroups().size() < 2); ++retries) {
+        qcc::Sleep(10);
+    }
+    ASSERT_EQ(2U, listener.LostGroups().size());
+    uint64_t firstLost = listener.lostTimes["firstgroup"] - start;
+    uint64_t secondLost = listener.lostTimes["secondgroup"] - start;
+    EXPECT_LE(764U, secondLost + 100);
+    EXPECT_LE(2000U, firstLost + 100);
+    EXPECT_LE(secondLost + 800, firstLost);
+
+    autoPinger.RemovePingGroup("firstgroup");
+    autoPinger.RemovePingGroup("secondgroup");
+
+    clientBus.Stop();
+    clientBus.Join();
+}
@@ -21,6 +21,7 @@
 
 #include <qcc/String.h>
 #include <qcc/Thread.h>
+#include <qcc/Util.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/DBusStd.h>
@@ -641,6 +642,93 @@ TEST_F(BusAttachmentTest, PingAsync_other_on_same_bus) {
     otherBus.Join();
 }
 
+TEST_F(BusAttachmentTest, Ping_multiple) {
+    BusAttachment otherBus("BusAttachment OtherBus", false);
+
+    QStatus status = ER_OK;
+    status = otherBus.Start();
+    ASSERT_EQ(ER_OK, status);
+    status = otherBus.Connect(getConnectArg().c_str());
+    ASSERT_EQ(ER_OK, status);
+
+    /* names appearing more than once are pinged once and report the same outcome */
+    const char* names[] = { bus.GetUniqueName().c_str(), otherBus.GetUniqueName().c_str(), ":1badNaME.2", bus.GetUniqueName().c_str() };
+    QStatus statuses[ArraySize(names)];
+    ASSERT_EQ(ER_OK, bus.Ping(names, ArraySize(names), 1000, statuses));
+    EXPECT_EQ(ER_OK, statuses[0]);
+    EXPECT_EQ(ER_OK, statuses[1]);
+    EXPECT_EQ(ER_ALLJOYN_PING_REPLY_UNKNOWN_NAME, statuses[2]);
+    EXPECT_EQ(ER_OK, statuses[3]);
+
+    EXPECT_EQ(ER_BAD_ARG_2, bus.Ping(names, 0, 1000, statuses));
+    names[2] = NULL;
+    EXPECT_EQ(ER_BUS_BAD_BUS_NAME, bus.Ping(names, ArraySize(names), 1000, statuses));
+
+    otherBus.Stop();
+    otherBus.Join();
+}
+
+TEST_F(BusAttachmentTest, Ping_multiple_over_limit) {
+    /* The routing node refuses a request this large so the names are pinged one at a time */
+    std::vector<const char*> names(2000, bus.GetUniqueName().c_str());
+    std::vector<QStatus> statuses(names.size(), ER_FAIL);
+    ASSERT_EQ(ER_OK, bus.Ping(&names[0], names.size(), 1000, &statuses[0]));
+    for (size_t i = 0; i < statuses.size(); ++i) {
+        EXPECT_EQ(ER_OK, statuses[i]);
+    }
+}
+
+class TestPingMultipleAsyncCB : public BusAttachment::PingMultipleAsyncCB {
+  public:
+    TestPingMultipleAsyncCB() : m_context(NULL) { }
+
+    void PingMultipleCB(const char** names, const QStatus* statuses, size_t numNames, void* context) {
+        for (size_t i = 0; i < numNames; ++i) {
+            m_names.push_back(names[i]);
+            m_statuses.push_back(statuses[i]);
+        }
+        m_context = context;
+        pingAsyncFlag = true;
+    }
+    std::vector<qcc::String> m_names;
+    std::vector<QStatus> m_statuses;
+    void* m_context;
+};
+
+TEST_F(BusAttachmentTest, PingAsync_multiple) {
+    BusAttachment otherBus("BusAttachment OtherBus", false);
+
+    QStatus status = ER_OK;
+    status = otherBus.Start();
+    ASSERT_EQ(ER_OK, status);
+    status = otherBus.Connect(getConnectArg().c_str());
+    ASSERT_EQ(ER_OK, status);
+
+    pingAsyncFlag = false;
+    TestPingMultipleAsyncCB pingCB;
+    const char* contextStr = "PingMultipleContextTestString";
+    const char* names[] = { otherBus.GetUniqueName().c_str(), ":1badNaME.2" };
+    ASSERT_EQ(ER_OK, bus.PingAsync(names, ArraySize(names), 1000, &pingCB, (void*)contextStr));
+
+    // wait just over 1 seconds
+    for (size_t msecs = 0; msecs < 1100; msecs += 5) {
+        if (pingAsyncFlag) {
+            break;
+        }
+        qcc::Sleep(5);
+    }
+
+    ASSERT_EQ(ArraySize(names), pingCB.m_statuses.size());
+    EXPECT_EQ(otherBus.GetUniqueName(), pingCB.m_names[0]);
+    EXPECT_EQ(ER_OK, pingCB.m_statuses[0]);
+    EXPECT_EQ(qcc::String(":1badNaME.2"), pingCB.m_names[1]);
+    EXPECT_EQ(ER_ALLJOYN_PING_REPLY_UNKNOWN_NAME, pingCB.m_statuses[1]);
+    EXPECT_STREQ(contextStr, (char*)pingCB.m_context);
+
+    otherBus.Stop();
+    otherBus.Join();
+}
+
 TEST_F(BusAttachmentTest, BasicSecureConnection)
 {
     DefaultECDHEAuthListener al;
@@ -21,6 +21,7 @@
 #include <alljoyn/BusListener.h>
 #include <alljoyn/BusObject.h>
 #include <alljoyn/ProxyBusObject.h>
+#include <alljoyn/TypedArgs.h>
 #include <alljoyn/InterfaceDescription.h>
 #include <alljoyn/DBusStd.h>
 #include <qcc/Debug.h>
@@ -594,3 +595,101 @@ TEST(BusObjectTest, GetAllPropsWithStaticMsgArgProp)
     status = pbo.GetAllProperties("org.test", props);
     EXPECT_EQ(ER_OK, status);
 }
+
+class TypedArgsTestBusObject : public BusObject {
+  public:
+    TypedArgsTestBusObject(BusAttachment& bus, const char* path) : BusObject(path), argsUnmarshaled(false)
+    {
+        const InterfaceDescription* intf = bus.GetInterface("org.test");
+        EXPECT_TRUE(intf != NULL);
+        AddInterface(*intf);
+        QStatus status = AddTypedMethodHandler(intf->GetMember("count"), static_cast<MessageReceiver::MethodHandler>(&TypedArgsTestBusObject::Count));
+        EXPECT_EQ(ER_OK, status);
+    }
+
+    void Count(const InterfaceDescription::Member* member, Message& msg)
+    {
+        QCC_UNUSED(member);
+        argsUnmarshaled = (msg->GetArg(0) != NULL);
+
+        qcc::String name;
+        std::vector<uint8_t> data;
+        QStatus status = TypedArgs<qcc::String, std::vector<uint8_t> >::Get(msg, name, data);
+        EXPECT_EQ(ER_OK, status);
+        if (status == ER_OK) {
+            uint32_t count = static_cast<uint32_t>(data.size());
+            status = MethodReply(msg, TypedArgs<uint32_t, qcc::String>(count, name));
+        } else {
+            status = MethodReply(msg, status);
+        }
+        EXPECT_EQ(ER_OK, status);
+    }
+
+    bool argsUnmarshaled;
+};
+
+TEST(BusObjectTest, TypedMethodHandler)
+{
+    BusAttachment busService("TypedArgsService");
+    BusAttachment busClient("TypedArgsClient");
+
+    InterfaceDescription* intf = NULL;
+    QStatus status = busService.CreateInterface("org.test", intf);
+    EXPECT_EQ(ER_OK, status);
+    ASSERT_TRUE(intf != NULL);
+    status = intf->AddMethod("count", "say", "us", "name,data,count,echo", 0);
+    EXPECT_EQ(ER_OK, status);
+    intf->Activate();
+
+    status = busService.Start();
+    EXPECT_EQ(ER_OK, status);
+    status = busService.Connect(ajn::getConnectArg().c_str());
+    EXPECT_EQ(ER_OK, status);
+    status = busClient.Start();
+    EXPECT_EQ(ER_OK, status);
+    status = busClient.Connect(ajn::getConnectArg().c_str());
+    EXPECT_EQ(ER_OK, status);
+
+    TypedArgsTestBusObject bo(busService, OBJECT_PATH);
+    status = busService.RegisterBusObject(bo);
+    EXPECT_EQ(ER_OK, status);
+
+    ProxyBusObject pbo(busClient, busService.GetUniqueName().c_str(), OBJECT_PATH, 0, false);
+    status = pbo.IntrospectRemoteObject();
+    EXPECT_EQ(ER_OK, status);
+    const InterfaceDescription::Member* countMethod = pbo.GetInterface("org.test")->GetMember("count");
+    ASSERT_TRUE(countMethod != NULL);
+
+    Message reply(busClient);
+    std::vector<uint8_t> data(5, 0xAA);
+    status = pbo.MethodCall(*countMethod, TypedArgs<qcc::String, std::vector<uint8_t> >("typed", data), reply);
+    ASSERT_EQ(ER_OK, status);
+    EXPECT_FALSE(bo.argsUnmarshaled);
+
+    uint32_t count = 0;
+    qcc::String echo;
+    status = TypedArgs<uint32_t, qcc::String>::Get(reply, count, echo);
+    EXPECT_EQ(ER_OK, status);
+    EXPECT_EQ(5U, count);
+    EXPECT_STREQ("typed", echo.c_str());
+
+    /* A MsgArg method call reaches the typed handler too */
+    MsgArg args[2];
+    args[0].Set("s", "msgarg");
+    args[1].Set("ay", data.size(), &data[0]);
+    status = pbo.MethodCall(*countMethod, args, ArraySize(args), reply);
+    ASSERT_EQ(ER_OK, status);
+    const char* echoStr = NULL;
+    status = reply->GetArgs("us", &count, &echoStr);
+    EXPECT_EQ(ER_OK, status);
+    EXPECT_EQ(5U, count);
+    EXPECT_STREQ("msgarg", echoStr);
+
+    busService.UnregisterBusObject(bo);
+    EXPECT_EQ(ER_OK, busClient.Disconnect());
+    EXPECT_EQ(ER_OK, busClient.Stop());
+    EXPECT_EQ(ER_OK, busClient.Join());
+    EXPECT_EQ(ER_OK, busService.Disconnect());
+    EXPECT_EQ(ER_OK, busService.Stop());
+    EXPECT_EQ(ER_OK, busService.Join());
+}
@@ -20,6 +20,15 @@
  ******************************************************************************/
 #include "ns/IpNameServiceImpl.h"
 
+#include <set>
+
+#include <qcc/GUID.h>
+#include <qcc/IfConfig.h>
+#include <qcc/IPAddress.h>
+#include <qcc/Mutex.h>
+#include <qcc/Socket.h>
+#include <qcc/Thread.h>
+
 /* Header files included for Google Test Framework */
 #include <gtest/gtest.h>
 #include "ajTestCommon.h"
@@ -99,3 +108,337 @@ INSTANTIATE_TEST_CASE_P(DiscoveryDynamic, DiscoveryDynamicTest,
                         testing::Values(DynamicParams(17, 16, 2, 16, 2, 8),
                                         DynamicParams(2, 16, 17, 16, 2, 8),
                                         DynamicParams(2, 16, 2, 16, 9, 8)));
+
+/*
+ * One in-process name service instance, talking to the others over the
+ * multicast loopback of the loopback interface.  The ConfigDB it reads is the
+ * one owned by the bundled router.
+ */
+class NameServiceNode {
+  public:
+    NameServiceNode() : guid(qcc::GUID128().ToString()), portFd(qcc::INVALID_SOCKET_FD) { }
+
+    ~NameServiceNode()
+    {
+        if (portFd != qcc::INVALID_SOCKET_FD) {
+            qcc::Close(portFd);
+        }
+    }
+
+    QStatus Start(const qcc::String& interfaceName)
+    {
+        /*
+         * The advertised port is never connected to, but hold on to an
+         * ephemeral one so that the advertisement does not name a port that
+         * something else is using.
+         */
+        uint16_t port = 0;
+        qcc::IPAddress addr("127.0.0.1");
+        QStatus status = qcc::Socket(qcc::QCC_AF_INET, qcc::QCC_SOCK_STREAM, portFd);
+        if (status == ER_OK) {
+            status = qcc::Bind(portFd, addr, 0);
+        }
+        if (status == ER_OK) {
+            status = qcc::GetLocalAddress(portFd, addr, port);
+        }
+        if (status == ER_OK) {
+            status = impl.Init(guid, false);
+        }
+        if (status == ER_OK) {
+            status = impl.Start();
+        }
+        if (status == ER_OK) {
+            impl.SetCallback(TRANSPORT_TCP, new CallbackImpl<NameServiceNode, void, const qcc::String&, const qcc::String&, std::vector<qcc::String>&, uint32_t>(this, &NameServiceNode::Found));
+            status = impl.OpenInterface(TRANSPORT_TCP, interfaceName);
+        }
+        if (status == ER_OK) {
+            std::map<qcc::String, uint16_t> portMap;
+            portMap["*"] = port;
+            impl.Enable(TRANSPORT_TCP, portMap, 0, std::map<qcc::String, uint16_t>(), 0, true, false, false, false);
+        }
+        return status;
+    }
+
+    void Stop()
+    {
+        impl.Stop();
+        impl.Join();
+    }
+
+    void Found(const qcc::String& busAddr, const qcc::String& otherGuid, std::vector<qcc::String>& names, uint32_t timer)
+    {
+        QCC_UNUSED(busAddr);
+        QCC_UNUSED(otherGuid);
+        if (timer) {
+            lock.Lock();
+            foundNames.insert(names.begin(), names.end());
+            lock.Unlock();
+        }
+    }
+
+    bool HasFoundName(const qcc::String& name)
+    {
+        lock.Lock();
+        bool result = foundNames.find(name) != foundNames.end();
+        lock.Unlock();
+        return result;
+    }
+
+    qcc::String guid;
+    IpNameServiceImpl impl;
+    qcc::Mutex lock;
+    std::set<qcc::String> foundNames;
+    qcc::SocketFd portFd;
+};
+
+/*
+ * Find the name of the IPv4 loopback interface.
+ */
+static bool GetLoopbackInterface(qcc::String& name)
+{
+    std::vector<qcc::IfConfigEntry> entries;
+    if (qcc::IfConfig(entries) != ER_OK) {
+        return false;
+    }
+    for (std::vector<qcc::IfConfigEntry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+        if ((it->m_flags & qcc::IfConfigEntry::UP) && (it->m_flags & qcc::IfConfigEntry::LOOPBACK) &&
+            (it->m_family == qcc::QCC_AF_INET)) {
+            name = it->m_name;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Another host on the link, sending hand-made version zero name service
+ * packets to the name service multicast group out of the loopback interface.
+ * Version one questions always carry the flag that marks them as coming from
+ * a version two peer, and so are never answered.
+ */
+class NameServicePeer {
+  public:
+    NameServicePeer() : sockFd(qcc::INVALID_SOCKET_FD) { }
+
+    ~NameServicePeer()
+    {
+        if (sockFd != qcc::INVALID_SOCKET_FD) {
+            qcc::Close(sockFd);
+        }
+    }
+
+    QStatus Start(const qcc::String& interfaceName)
+    {
+        QStatus status = qcc::Socket(qcc::QCC_AF_INET, qcc::QCC_SOCK_DGRAM, sockFd);
+        if (status == ER_OK) {
+            status = qcc::SetMulticastInterface(sockFd, qcc::QCC_AF_INET, interfaceName);
+        }
+        return status;
+    }
+
+    QStatus Ask(const qcc::String& name)
+    {
+        WhoHas whoHas;
+        whoHas.SetVersion(0, 0);
+        whoHas.SetTcpFlag(true);
+        whoHas.AddName(name);
+        NSPacket nspacket;
+        nspacket->SetVersion(0, 0);
+        nspacket->SetTimer(120);
+        nspacket->AddQuestion(whoHas);
+        return Send(nspacket);
+    }
+
+    QStatus Answer(const qcc::String& guid, const qcc::String& name)
+    {
+        IsAt isAt;
+        isAt.SetVersion(0, 0);
+        isAt.SetTcpFlag(true);
+        isAt.SetGuid(guid);
+        isAt.SetCompleteFlag(true);
+        isAt.SetIPv4("127.0.0.1");
+        isAt.SetPort(9955);
+        isAt.AddName(name);
+        NSPacket nspacket;
+        nspacket->SetVersion(0, 0);
+        nspacket->SetTimer(120);
+        nspacket->AddAnswer(isAt);
+        return Send(nspacket);
+    }
+
+  private:
+    QStatus Send(NSPacket nspacket)
+    {
+        std::vector<uint8_t> buffer(nspacket->GetSerializedSize());
+        size_t size = nspacket->Serialize(&buffer[0]);
+        size_t sent = 0;
+        qcc::IPAddress group("224.0.0.113");
+        return qcc::SendTo(sockFd, group, 9956, &buffer[0], size, sent);
+    }
+
+    qcc::SocketFd sockFd;
+};
+
+/*
+ * Wait for a name service packet counter to reach a value.
+ */
+static uint32_t WaitForStat(IpNameServiceImpl& impl, uint32_t IpNameServiceImpl::PacketBuildStats::* stat, uint32_t value, uint32_t msecs)
+{
+    IpNameServiceImpl::PacketBuildStats stats;
+    impl.GetPacketBuildStats(stats);
+    for (uint32_t waited = 0; (stats.*stat < value) && (waited < msecs); waited += 10) {
+        qcc::Sleep(10);
+        impl.GetPacketBuildStats(stats);
+    }
+    return stats.*stat;
+}
+
+TEST(DiscoveryMultiInstanceTest, DuplicateQuestionsAreSuppressed)
+{
+    qcc::String loopback;
+    if (!GetLoopbackInterface(loopback)) {
+        printf("Skipping test since there is no IPv4 loopback interface\n");
+        return;
+    }
+
+    NameServiceNode advertiser;
+    NameServicePeer firstQuerier;
+    NameServicePeer secondQuerier;
+    ASSERT_EQ(ER_OK, advertiser.Start(loopback));
+    ASSERT_EQ(ER_OK, firstQuerier.Start(loopback));
+    ASSERT_EQ(ER_OK, secondQuerier.Start(loopback));
+    qcc::String name = "org.alljoyn.DiscoveryDuplicateQuestionTest.n" + advertiser.guid;
+    ASSERT_EQ(ER_OK, advertiser.impl.AdvertiseName(TRANSPORT_TCP, name, false, TRANSPORT_TCP));
+
+    // The advertisement goes out once the interface is live
+    ASSERT_LT(0U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::packetsSerialized, 1, 10000));
+
+    // The first question is answered right away
+    ASSERT_EQ(ER_OK, firstQuerier.Ask("org.alljoyn.DiscoveryDuplicateQuestionTest.*"));
+    ASSERT_EQ(1U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::responsesSent, 1, 5000));
+
+    // The same question from another host is answered once the interval has passed
+    ASSERT_EQ(ER_OK, secondQuerier.Ask("org.alljoyn.DiscoveryDuplicateQuestionTest.*"));
+    ASSERT_EQ(1U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::responsesSuppressed, 1, 5000));
+
+    // A question under a different guise has the same answer and is merged with it
+    ASSERT_EQ(ER_OK, firstQuerier.Ask(name));
+    ASSERT_EQ(1U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::responsesMerged, 1, 5000));
+
+    ASSERT_EQ(2U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::responsesSent, 2, 5000));
+    qcc::Sleep(2 * IpNameServiceImpl::RESPONSE_SUPPRESSION_INTERVAL);
+
+    IpNameServiceImpl::PacketBuildStats stats;
+    advertiser.impl.GetPacketBuildStats(stats);
+    EXPECT_EQ(2U, stats.responsesSent);
+    EXPECT_EQ(1U, stats.responsesSuppressed);
+    EXPECT_EQ(1U, stats.responsesMerged);
+    EXPECT_EQ(0U, stats.answersObserved);
+
+    advertiser.Stop();
+}
+
+TEST(DiscoveryMultiInstanceTest, AnswersFromOtherHostsAreNotRepeated)
+{
+    qcc::String loopback;
+    if (!GetLoopbackInterface(loopback)) {
+        printf("Skipping test since there is no IPv4 loopback interface\n");
+        return;
+    }
+
+    NameServiceNode advertiser;
+    NameServicePeer querier;
+    NameServicePeer relay;
+    ASSERT_EQ(ER_OK, advertiser.Start(loopback));
+    ASSERT_EQ(ER_OK, querier.Start(loopback));
+    ASSERT_EQ(ER_OK, relay.Start(loopback));
+    qcc::String name = "org.alljoyn.DiscoveryObservedAnswerTest.n" + advertiser.guid;
+    ASSERT_EQ(ER_OK, advertiser.impl.AdvertiseName(TRANSPORT_TCP, name, false, TRANSPORT_TCP));
+
+    // The advertisement goes out once the interface is live
+    ASSERT_LT(0U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::packetsSerialized, 1, 10000));
+
+    // Answers that are not identical to ours change nothing
+    ASSERT_EQ(ER_OK, relay.Answer(advertiser.guid, name + ".other"));
+    ASSERT_EQ(ER_OK, relay.Answer(qcc::GUID128().ToString(), name));
+
+    // Our answer was just heard on the link so the question is not answered right away
+    ASSERT_EQ(ER_OK, relay.Answer(advertiser.guid, name));
+    ASSERT_EQ(1U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::answersObserved, 1, 5000));
+    ASSERT_EQ(ER_OK, querier.Ask("org.alljoyn.DiscoveryObservedAnswerTest.*"));
+    ASSERT_EQ(1U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::responsesSuppressed, 1, 5000));
+
+    // Hearing it again before the deferred response is due makes that response unnecessary
+    ASSERT_EQ(ER_OK, relay.Answer(advertiser.guid, name));
+    ASSERT_EQ(2U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::answersObserved, 2, 5000));
+    qcc::Sleep(2 * IpNameServiceImpl::RESPONSE_SUPPRESSION_INTERVAL);
+
+    IpNameServiceImpl::PacketBuildStats stats;
+    advertiser.impl.GetPacketBuildStats(stats);
+    EXPECT_EQ(0U, stats.responsesSent);
+    EXPECT_EQ(1U, stats.responsesSuppressed);
+    EXPECT_EQ(2U, stats.answersObserved);
+
+    // Once the interval has passed we answer again
+    ASSERT_EQ(ER_OK, querier.Ask("org.alljoyn.DiscoveryObservedAnswerTest.*"));
+    EXPECT_EQ(1U, WaitForStat(advertiser.impl, &IpNameServiceImpl::PacketBuildStats::responsesSent, 1, 5000));
+
+    advertiser.Stop();
+}
+
+TEST(DiscoveryMultiInstanceTest, PacketCache)
+{
+    qcc::String loopback;
+    if (!GetLoopbackInterface(loopback)) {
+        printf("Skipping test since there is no IPv4 loopback interface\n");
+        return;
+    }
+
+    NameServiceNode advertiser;
+    NameServiceNode finder;
+    ASSERT_EQ(ER_OK, advertiser.Start(loopback));
+    ASSERT_EQ(ER_OK, finder.Start(loopback));
+    qcc::String first = "org.alljoyn.DiscoveryPacketCacheTest.a" + advertiser.guid;
+    qcc::String second = "org.alljoyn.DiscoveryPacketCacheTest.b" + advertiser.guid;
+    ASSERT_EQ(ER_OK, advertiser.impl.AdvertiseName(TRANSPORT_TCP, first, false, TRANSPORT_TCP));
+
+    // Different questions so that the answers are not suppressed as duplicates
+    IpNameServiceImpl::PacketBuildStats before;
+    IpNameServiceImpl::PacketBuildStats stats;
+    advertiser.impl.GetPacketBuildStats(before);
+    const char* questions[] = {
+        "name='org.alljoyn.DiscoveryPacketCacheTest.*'",
+        "name='org.alljoyn.DiscoveryPacketCacheTest.a*'"
+    };
+    for (size_t i = 0; i < ArraySize(questions); ++i) {
+        ASSERT_EQ(ER_OK, finder.impl.FindAdvertisement(TRANSPORT_TCP, questions[i], IpNameServiceImpl::ALWAYS_RETRY, TRANSPORT_TCP));
+    }
+    for (uint32_t msecs = 0; msecs < 10000; msecs += 100) {
+        advertiser.impl.GetPacketBuildStats(stats);
+        if (finder.HasFoundName(first) && (stats.packetsReused > before.packetsReused)) {
+            break;
+        }
+        qcc::Sleep(100);
+    }
+    EXPECT_TRUE(finder.HasFoundName(first));
+    EXPECT_LT(before.packetsReused, stats.packetsReused);
+
+    // A new name invalidates the cache and the next answer is built with it
+    before = stats;
+    ASSERT_EQ(ER_OK, advertiser.impl.AdvertiseName(TRANSPORT_TCP, second, false, TRANSPORT_TCP));
+    advertiser.impl.GetPacketBuildStats(stats);
+    EXPECT_LT(before.cacheInvalidations, stats.cacheInvalidations);
+    ASSERT_EQ(ER_OK, finder.impl.FindAdvertisement(TRANSPORT_TCP, "name='org.alljoyn.DiscoveryPacketCacheTest.b*'", IpNameServiceImpl::ALWAYS_RETRY, TRANSPORT_TCP));
+    for (uint32_t msecs = 0; msecs < 10000; msecs += 100) {
+        advertiser.impl.GetPacketBuildStats(stats);
+        if (finder.HasFoundName(second) && (stats.packetsBuilt > before.packetsBuilt)) {
+            break;
+        }
+        qcc::Sleep(100);
+    }
+    EXPECT_TRUE(finder.HasFoundName(second));
+    EXPECT_LT(before.packetsBuilt, stats.packetsBuilt);
+
+    finder.Stop();
+    advertiser.Stop();
+}
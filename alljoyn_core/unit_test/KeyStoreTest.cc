@@ -36,6 +36,7 @@
 
 #include <alljoyn/version.h>
 #include "KeyStore.h"
+#include "InMemoryKeyStore.h"
 
 #include <alljoyn/Status.h>
 
@@ -215,3 +216,305 @@ TEST(KeyStoreTest, keystore_store_load_merge) {
     DeleteFile("keystore_test");
 }
 
+#if defined(QCC_OS_GROUP_POSIX) && !defined(QCC_OS_DARWIN)
+
+/*
+ * The default key store listener on these platforms stores the keys in a log
+ */
+static qcc::String LogPath(const char* application)
+{
+    return GetHomeDir() + "/.alljoyn_keystore/" + application;
+}
+
+static qcc::String ReadFile(const qcc::String& fileName)
+{
+    qcc::String contents;
+    FileSource source(fileName);
+    uint8_t buf[1024];
+    size_t pulled;
+    while (source.PullBytes(buf, sizeof(buf), pulled) == ER_OK) {
+        contents.append((const char*)buf, pulled);
+    }
+    return contents;
+}
+
+static void AppendFile(const qcc::String& fileName, const qcc::String& data)
+{
+    qcc::String contents = ReadFile(fileName) + data;
+    FileSink sink(fileName, FileSink::PRIVATE);
+    size_t pushed;
+    sink.PushBytes(contents.data(), contents.size(), pushed);
+}
+
+TEST(KeyStoreTest, log_appends_changes) {
+    const char* app = "keystore_log_test";
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, qcc::GUID128());
+    KeyStore::Key idx2(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyStore::Key idx3(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyBlob key;
+    DeleteFile(LogPath(app));
+
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        qcc::String first = ReadFile(LogPath(app));
+        ASSERT_TRUE(KeyStore::IsLog((const uint8_t*)first.data(), first.size()));
+
+        /* Adding and deleting keys only appends to the log */
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx3, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        qcc::String second = ReadFile(LogPath(app));
+        ASSERT_GT(second.size(), first.size());
+        EXPECT_TRUE(second.compare(0, first.size(), first) == 0);
+
+        EXPECT_EQ(ER_OK, keyStore.DelKey(idx2));
+        qcc::String third = ReadFile(LogPath(app));
+        ASSERT_GT(third.size(), second.size());
+        EXPECT_TRUE(third.compare(0, second.size(), second) == 0);
+    }
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, key));
+        EXPECT_EQ(ER_BUS_KEY_UNAVAILABLE, keyStore.GetKey(idx2, key));
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx3, key));
+
+        /* A cleared key store stays cleared */
+        EXPECT_EQ(ER_OK, keyStore.Clear());
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        EXPECT_EQ(ER_BUS_KEY_UNAVAILABLE, keyStore.GetKey(idx1, key));
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key));
+        EXPECT_EQ(ER_BUS_KEY_UNAVAILABLE, keyStore.GetKey(idx3, key));
+    }
+    DeleteFile(LogPath(app));
+}
+
+TEST(KeyStoreTest, log_ignores_partial_record) {
+    const char* app = "keystore_log_test";
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, qcc::GUID128());
+    KeyStore::Key idx2(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyBlob key;
+    DeleteFile(LogPath(app));
+
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+    qcc::String complete = ReadFile(LogPath(app));
+    /* Looks like the start of a record that was never finished */
+    AppendFile(LogPath(app), qcc::String("\x40\x00\x00\x00\x05\x00\x00\x00garbage", 15));
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, key));
+        /* The partial record is cut off */
+        EXPECT_TRUE(ReadFile(LogPath(app)) == complete);
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, key));
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key));
+    }
+    DeleteFile(LogPath(app));
+}
+
+TEST(KeyStoreTest, log_rejects_damaged_record) {
+    const char* app = "keystore_log_test";
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, qcc::GUID128());
+    KeyStore::Key idx2(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyBlob key;
+    DeleteFile(LogPath(app));
+
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+    qcc::String log = ReadFile(LogPath(app));
+
+    /* A complete last record that fails to decrypt is not a partial write */
+    qcc::String damaged = log;
+    damaged[damaged.size() - 1] ^= 0x01;
+    {
+        FileSink sink(LogPath(app), FileSink::PRIVATE);
+        size_t pushed;
+        sink.PushBytes(damaged.data(), damaged.size(), pushed);
+    }
+    {
+        KeyStore keyStore(app);
+        EXPECT_EQ(ER_BUS_CORRUPT_KEYSTORE, keyStore.Init(NULL, false));
+    }
+    EXPECT_TRUE(ReadFile(LogPath(app)) == damaged);
+
+    /* Nor is a record length too short to hold the authentication tag */
+    damaged = log + qcc::String("\x04\x00\x00\x00\x09\x00\x00\x00", 8);
+    {
+        FileSink sink(LogPath(app), FileSink::PRIVATE);
+        size_t pushed;
+        sink.PushBytes(damaged.data(), damaged.size(), pushed);
+    }
+    {
+        KeyStore keyStore(app);
+        EXPECT_EQ(ER_BUS_CORRUPT_KEYSTORE, keyStore.Init(NULL, false));
+    }
+    EXPECT_TRUE(ReadFile(LogPath(app)) == damaged);
+    DeleteFile(LogPath(app));
+}
+
+TEST(KeyStoreTest, log_converts_older_format) {
+    const char* app = "keystore_log_test";
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, qcc::GUID128());
+    KeyBlob key;
+    key.Rand(64, KeyBlob::GENERIC);
+    qcc::String path = LogPath(app);
+    DeleteFile(path);
+
+    {
+        /* The default listener uses the file name as the password */
+        qcc::String empty;
+        InMemoryKeyStoreListener listener(empty, path);
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.SetListener(listener));
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        FileSink sink(path, FileSink::PRIVATE);
+        ASSERT_EQ(ER_OK, keyStore.Push(sink));
+    }
+    qcc::String snapshot = ReadFile(path);
+    ASSERT_FALSE(KeyStore::IsLog((const uint8_t*)snapshot.data(), snapshot.size()));
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        KeyBlob loaded;
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx1, loaded));
+        EXPECT_EQ(0, memcmp(key.GetData(), loaded.GetData(), key.GetSize()));
+    }
+    qcc::String log = ReadFile(path);
+    EXPECT_TRUE(KeyStore::IsLog((const uint8_t*)log.data(), log.size()));
+    DeleteFile(path);
+}
+
+TEST(KeyStoreTest, log_is_compacted) {
+    const char* app = "keystore_log_test";
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, qcc::GUID128());
+    KeyStore::Key idx2(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyBlob key;
+    qcc::String path = LogPath(app);
+    DeleteFile(path);
+
+    size_t largest = 0;
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx1, key));
+        /* Keep replacing the same key so most of the log is superseded */
+        for (size_t i = 0; i < 1100; ++i) {
+            key.Rand(64, KeyBlob::GENERIC);
+            EXPECT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+            ASSERT_EQ(ER_OK, keyStore.Store());
+            largest = max(largest, ReadFile(path).size());
+        }
+        /* Compaction happens in the background */
+        for (int i = 0; (i < 500) && (ReadFile(path).size() >= largest / 2); ++i) {
+            qcc::Sleep(10);
+        }
+        EXPECT_LT(ReadFile(path).size(), largest / 2);
+
+        key.Rand(64, KeyBlob::GENERIC);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(idx2, key));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+    {
+        KeyStore keyStore(app);
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        KeyBlob loaded;
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, loaded));
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx2, loaded));
+        EXPECT_EQ(0, memcmp(key.GetData(), loaded.GetData(), key.GetSize()));
+    }
+    DeleteFile(path);
+}
+
+#endif
+
+TEST(KeyStoreTest, search_associated_and_expired_keys) {
+    qcc::GUID128 head;
+    qcc::GUID128 otherHead;
+    KeyStore::Key headIdx(KeyStore::Key::REMOTE, head);
+    KeyStore::Key otherHeadIdx(KeyStore::Key::REMOTE, otherHead);
+    KeyStore::Key member1(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyStore::Key member2(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyStore::Key member3(KeyStore::Key::REMOTE, qcc::GUID128());
+    KeyStore::Key* list = NULL;
+    size_t numItems = 0;
+    KeyBlob key;
+
+    {
+        KeyStore keyStore("keystore_index_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        ASSERT_EQ(ER_OK, keyStore.Clear());
+
+        key.Rand(64, KeyBlob::GENERIC);
+        key.SetAssociation(head);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(member1, key));
+        EXPECT_EQ(ER_OK, keyStore.AddKey(member2, key));
+        key.SetAssociation(otherHead);
+        EXPECT_EQ(ER_OK, keyStore.AddKey(member3, key));
+
+        ASSERT_EQ(ER_OK, keyStore.SearchAssociatedKeys(headIdx, &list, &numItems));
+        ASSERT_EQ(2U, numItems);
+        EXPECT_TRUE(((list[0] == member1) && (list[1] == member2)) || ((list[0] == member2) && (list[1] == member1)));
+        delete [] list;
+
+        /* Replacing a key moves it to its new association */
+        EXPECT_EQ(ER_OK, keyStore.AddKey(member2, key));
+        ASSERT_EQ(ER_OK, keyStore.SearchAssociatedKeys(headIdx, &list, &numItems));
+        ASSERT_EQ(1U, numItems);
+        EXPECT_TRUE(list[0] == member1);
+        delete [] list;
+
+        EXPECT_EQ(ER_OK, keyStore.DelKey(member1));
+        ASSERT_EQ(ER_OK, keyStore.SearchAssociatedKeys(headIdx, &list, &numItems));
+        EXPECT_EQ(0U, numItems);
+        ASSERT_EQ(ER_OK, keyStore.Store());
+
+        /* Expire a key */
+        EXPECT_EQ(ER_OK, keyStore.SetKeyExpiration(member3, qcc::Timespec<qcc::EpochTime>(GetEpochTimestamp() - 1000)));
+        ASSERT_EQ(ER_OK, keyStore.Store());
+    }
+    {
+        KeyStore keyStore("keystore_index_test");
+        ASSERT_EQ(ER_OK, keyStore.Init(NULL, false));
+        EXPECT_FALSE(keyStore.HasKey(member3));
+        ASSERT_EQ(ER_OK, keyStore.SearchAssociatedKeys(otherHeadIdx, &list, &numItems));
+        ASSERT_EQ(1U, numItems);
+        EXPECT_TRUE(list[0] == member2);
+        delete [] list;
+        EXPECT_EQ(ER_OK, keyStore.Clear());
+    }
+}
@@ -1674,6 +1674,53 @@ TEST(MarshalTest, TestBigArrays) {
     fuzzingBus = NULL;
 
 }
+
+TEST(MarshalTest, ScalarArraysInBothEndianess) {
+    fuzzingBus = new BusAttachment("TestMsgUnPack", false);
+    fuzzingBus->Start();
+    fuzzing = false;
+    nobig = true;
+    quiet = true;
+
+    /* Odd length so that the bulk conversions have a remainder to deal with */
+    const size_t num = 77;
+    bool bools[num];
+    int16_t int16s[num];
+    uint16_t uint16s[num];
+    int32_t int32s[num];
+    uint32_t uint32s[num];
+    int64_t int64s[num];
+    uint64_t uint64s[num];
+    double doubles[num];
+    for (size_t i = 0; i < num; ++i) {
+        bools[i] = (i % 3) == 1;
+        int16s[i] = (int16_t)(-1000 + 31 * i);
+        uint16s[i] = (uint16_t)(0x0102 * i);
+        int32s[i] = (int32_t)(-100000 + 4099 * i);
+        uint32s[i] = (uint32_t)(0x01020304 * i);
+        int64s[i] = -10000000000LL + 1234567891LL * i;
+        uint64s[i] = 0x0102030405060708ULL * i;
+        doubles[i] = 0.125 * i - 3.0;
+    }
+
+    const char endianess[] = { ALLJOYN_LITTLE_ENDIAN, ALLJOYN_BIG_ENDIAN };
+    for (size_t e = 0; e < ArraySize(endianess); ++e) {
+        _Message::SetEndianess(endianess[e]);
+        MsgArg argList;
+        QStatus status = argList.Set("(abanaqaiauaxatad)", num, bools, num, int16s, num, uint16s, num, int32s, num, uint32s,
+                                     num, int64s, num, uint64s, num, doubles);
+        if (status == ER_OK) {
+            status = TestMarshal(argList.v_struct.members, argList.v_struct.numMembers);
+        }
+        EXPECT_EQ(ER_OK, status) << errString.c_str();
+    }
+    _Message::SetEndianess(0);
+
+    fuzzingBus->Stop();
+    fuzzingBus->Join();
+    delete fuzzingBus;
+    fuzzingBus = NULL;
+}
 /*--------------------------FUZZING TEST CODE---------------------------------*/
 
 
@@ -14,10 +14,12 @@
  *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  ******************************************************************************/
 #include <qcc/platform.h>
+#include <qcc/Util.h>
 
 #include <alljoyn/MsgArg.h>
 #include <alljoyn/Message.h>
 #include <alljoyn/Status.h>
+#include "MsgArgUtils.h"
 /* Header files included for Google Test Framework */
 #include <gtest/gtest.h>
 #include "ajTestCommon.h"
@@ -693,6 +695,21 @@ TEST(MsgArgTest, Comparison) {
     b.SetOwnershipFlags(MsgArg::OwnsArgs, true);
 }
 
+TEST(MsgArgTest, Hash) {
+    const char* strs[] = { "one", "two" };
+    MsgArg a("(sasu)", "test", ArraySize(strs), strs, 1);
+    MsgArg b("(sasu)", "test", ArraySize(strs), strs, 1);
+    MsgArg c("(sasu)", "test", ArraySize(strs), strs, 2);
+    MsgArg d("(sasu)", "test", static_cast<size_t>(1), strs, 1);
+    EXPECT_EQ(MsgArgUtils::Hash(a), MsgArgUtils::Hash(b));
+    EXPECT_NE(MsgArgUtils::Hash(a), MsgArgUtils::Hash(c));
+    EXPECT_NE(MsgArgUtils::Hash(a), MsgArgUtils::Hash(d));
+
+    /* A copy hashes the same as the original */
+    MsgArg copy(a);
+    EXPECT_EQ(MsgArgUtils::Hash(a), MsgArgUtils::Hash(copy));
+}
+
 // this test has been added mostly for memory verification tools to check that
 // memory is released as it should be.  We also expect the code to not crash
 TEST(MsgArgTest, SetOwnershipFlags_scalar_arrays) {
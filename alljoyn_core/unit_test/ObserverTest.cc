@@ -236,6 +236,17 @@ class Participant : public SessionPortListener, public SessionListener {
         ASSERT_EQ(ER_OK, aboutObj.Announce(port, aboutData));
     }
 
+    void ReplaceObject(qcc::String name, vector<qcc::String> interfaces) {
+        ObjectMap::iterator it = objects.find(name);
+        ASSERT_NE(objects.end(), it) << "No such object.";
+        ASSERT_TRUE(it->second.second) << "Object not on bus.";
+        bus.UnregisterBusObject(*(it->second.first));
+        delete it->second.first;
+        it->second.first = new TestObject(bus, qcc::String(PATH_PREFIX) + name, interfaces);
+        ASSERT_EQ(ER_OK, bus.RegisterBusObject(*(it->second.first)));
+        ASSERT_EQ(ER_OK, aboutObj.Announce(port, aboutData));
+    }
+
     virtual bool AcceptSessionJoiner(SessionPort sessionPort, const char* joiner, const SessionOpts& sessionOpts) {
         QCC_UNUSED(sessionPort);
         QCC_UNUSED(joiner);
@@ -1287,6 +1298,48 @@ TEST_F(ObserverTest, DiscoverWhileRunning) {
     delete obsA;
 }
 
+TEST_F(ObserverTest, InterfacesChanged) {
+    // set up observers
+    Participant consumer;
+    Observer obsA(consumer.bus, cintfA, 1);
+    Observer obsAB(consumer.bus, cintfAB, 2);
+    ObserverListener lisA(consumer.bus);
+    ObserverListener lisAB(consumer.bus);
+    obsA.RegisterListener(lisA);
+    obsAB.RegisterListener(lisAB);
+    vector<Event*> eventsA, eventsAB;
+    eventsA.push_back(&(lisA.event));
+    eventsAB.push_back(&(lisAB.event));
+
+    Participant provider;
+    provider.CreateObject("a", intfA);
+    lisA.ExpectInvocations(1);
+    provider.RegisterObject("a");
+    EXPECT_TRUE(WaitForAll(eventsA));
+
+    // the object on the same path gains an interface
+    lisAB.ExpectInvocations(1);
+    provider.ReplaceObject("a", intfAB);
+    EXPECT_TRUE(WaitForAll(eventsAB));
+    EXPECT_EQ(1, CountProxies(obsA));
+    EXPECT_EQ(1, CountProxies(obsAB));
+
+    // and loses it again
+    lisAB.ExpectInvocations(1);
+    provider.ReplaceObject("a", intfA);
+    EXPECT_TRUE(WaitForAll(eventsAB));
+    EXPECT_EQ(1, CountProxies(obsA));
+    EXPECT_EQ(0, CountProxies(obsAB));
+
+    lisA.ExpectInvocations(1);
+    provider.UnregisterObject("a");
+    EXPECT_TRUE(WaitForAll(eventsA));
+    EXPECT_EQ(0, lisAB.counter);
+
+    obsA.UnregisterAllListeners();
+    obsAB.UnregisterAllListeners();
+}
+
 TEST_F(ObserverTest, StopBus) {
     // set up two participants
     Participant one, two;
@@ -17,6 +17,7 @@
 #include "PermissionMgmtTest.h"
 #include "KeyInfoHelper.h"
 #include "KeyExchanger.h"
+#include "BusInternal.h"
 #include <qcc/Crypto.h>
 #include <qcc/Util.h>
 #include <string>
@@ -2899,6 +2900,38 @@ TEST_F(PermissionMgmtUseCaseTest, TestResetPolicy)
 }
 
 
+/*
+ *  Case: repeated calls are authorized from the cache until the policy changes
+ */
+TEST_F(PermissionMgmtUseCaseTest, AuthorizationDecisionsAreCached)
+{
+    Claims(false);
+    PermissionPolicy policy;
+    ASSERT_EQ(ER_OK, GeneratePolicy(adminBus, serviceBus, policy, adminBus)) << "GeneratePolicy failed.";
+    InstallPolicyToService(policy);
+    PermissionPolicy consumerPolicy;
+    ASSERT_EQ(ER_OK, GenerateFullAccessOutgoingPolicy(adminBus, consumerBus, consumerPolicy)) << "GeneratePolicy failed.";
+    InstallPolicyToConsumer(consumerPolicy);
+    InstallMembershipToConsumer();
+    CreateAppInterfaces(serviceBus, true);
+    CreateAppInterfaces(consumerBus, false);
+
+    AnyUserCanCallOnAndNotOff(consumerBus);
+    uint32_t hits;
+    uint32_t misses;
+    serviceBus.GetInternal().GetPermissionManager().GetAuthorizationCacheStats(hits, misses);
+    AnyUserCanCallOnAndNotOff(consumerBus);
+    uint32_t moreHits;
+    uint32_t moreMisses;
+    serviceBus.GetInternal().GetPermissionManager().GetAuthorizationCacheStats(moreHits, moreMisses);
+    /* the On and Off calls were both decided from the cache */
+    EXPECT_LE(hits + 2, moreHits);
+
+    /* the default policy does not let the consumer call On */
+    ResetPolicyFromApp(adminBus, serviceBus);
+    AppCannotCallTVOn(consumerBus, serviceBus);
+}
+
 TEST_F(PermissionMgmtUseCaseTest, RetrievePropertyApplicationState)
 {
     Claims(false);
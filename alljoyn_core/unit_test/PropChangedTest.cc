@@ -336,12 +336,14 @@ class PropChangedTestBusObject :
     const vector<InterfaceParameters> intfParams;
     map<String, int> propvalOffsets;
     map<String, int> getsPerPropName;
+    int bulkGets;
 
     PropChangedTestBusObject(BusAttachment& bus,
                              const vector<InterfaceParameters> ip,
-                             const char* path = OBJECT_PATH) :
+                             const char* path = OBJECT_PATH,
+                             bool bulkGetter = false) :
         BusObject(path), status(ER_OK), bus(bus),
-        intfParams(ip)
+        intfParams(ip), bulkGets(0)
     {
         //QCC_SyncPrintf("PropChangedTestBusObject::constructor for %s\n", path);
         for (size_t i = 0; i < ip.size(); i++) {
@@ -350,6 +352,9 @@ class PropChangedTestBusObject :
             propvalOffsets[ip[i].name] = 0;
         }
         EXPECT_EQ(ER_OK, status);
+        if (bulkGetter) {
+            EXPECT_EQ(ER_OK, SetPropsGetter(static_cast<PropsGetter>(&PropChangedTestBusObject::GetBulk)));
+        }
         status = bus.RegisterBusObject(*this);
         EXPECT_EQ(ER_OK, status);
     }
@@ -381,6 +386,16 @@ class PropChangedTestBusObject :
         return ER_OK;
     }
 
+    QStatus GetBulk(const char* ifcName, const char** propNames, size_t numProps, MsgArg* vals)
+    {
+        bulkGets += 1;
+        QStatus result = ER_OK;
+        for (size_t i = 0; (result == ER_OK) && (i < numProps); i++) {
+            result = Get(ifcName, propNames[i], vals[i]);
+        }
+        return result;
+    }
+
     void ChangePropertyValues(const InterfaceParameters& ip, int offset)
     {
         propvalOffsets[ip.name] = offset;
@@ -1349,6 +1364,197 @@ TEST_F(PropChangedTest, ListenerNotCalled_AfterUnregister)
     proxy->listeners[0]->registeredInterfaces.erase(tp.intfParams[0].name);
 }
 
+static void ValidateCoalescedSample(const MsgArg& changed, const char** names, const int32_t* values, size_t num)
+{
+    size_t numEntries = 0;
+    MsgArg* entries = NULL;
+    ASSERT_EQ(ER_OK, changed.Get("a{sv}", &numEntries, &entries));
+    ASSERT_EQ(num, numEntries);
+    for (size_t i = 0; i < num; i++) {
+        const char* name = NULL;
+        MsgArg* val = NULL;
+        ASSERT_EQ(ER_OK, entries[i].Get("{sv}", &name, &val));
+        EXPECT_STREQ(names[i], name);
+        int32_t v = 0;
+        ASSERT_EQ(ER_OK, val->Get("i", &v));
+        EXPECT_EQ(values[i], v);
+    }
+}
+
+/*
+ * Enable coalescing on the BusObject and mark properties P1 and P2 as changed
+ * several times within the interval. Verify that a single PropertiesChanged
+ * signal carries both properties with their latest values and that each
+ * property was only read once.
+ */
+TEST_F(PropChangedTest, Coalesce)
+{
+    TestParameters tp(true, InterfaceParameters(P1to2));
+    SetupPropChanged(tp, tp);
+    const char* ifcName = tp.intfParams[0].name.c_str();
+
+    EXPECT_EQ(ER_OK, obj->SetPropChangedCoalescing(TIMEOUT_EXPECTED));
+    for (int i = 1; i <= 3; i++) {
+        obj->ChangePropertyValues(tp, i * 10);
+        EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED));
+        EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P2", SESSION_ID_ALL_HOSTED));
+    }
+    EXPECT_EQ(ER_OK, proxy->TimedWait(TIMEOUT));
+    EXPECT_EQ(ER_TIMEOUT, proxy->TimedWait(TIMEOUT_EXPECTED));
+
+    ASSERT_EQ(1U, proxy->changedSamples[ifcName].size());
+    const char* names[] = { "P1", "P2" };
+    const int32_t values[] = { 31, 32 };
+    ValidateCoalescedSample(proxy->changedSamples[ifcName][0], names, values, 2);
+    EXPECT_EQ(1, obj->getsPerPropName["P1"]);
+    EXPECT_EQ(1, obj->getsPerPropName["P2"]);
+}
+
+/*
+ * Enable coalescing with a batch size of two and an interval that will not
+ * expire during the test. Verify that marking two properties emits them right
+ * away and that a single pending property is emitted on FlushPropChanged.
+ */
+TEST_F(PropChangedTest, CoalesceBatchAndFlush)
+{
+    TestParameters tp(true, InterfaceParameters(P1to3));
+    SetupPropChanged(tp, tp);
+    const char* ifcName = tp.intfParams[0].name.c_str();
+
+    EXPECT_EQ(ER_OK, obj->SetPropChangedCoalescing(60 * TIMEOUT, 2));
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_TIMEOUT, proxy->TimedWait(TIMEOUT_EXPECTED));
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P2", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_OK, proxy->TimedWait(TIMEOUT));
+
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P3", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_TIMEOUT, proxy->TimedWait(TIMEOUT_EXPECTED));
+    EXPECT_EQ(ER_OK, obj->FlushPropChanged());
+    EXPECT_EQ(ER_OK, proxy->TimedWait(TIMEOUT));
+
+    ASSERT_EQ(2U, proxy->changedSamples[ifcName].size());
+    const char* names[] = { "P1", "P2", "P3" };
+    const int32_t values[] = { 1, 2, 3 };
+    ValidateCoalescedSample(proxy->changedSamples[ifcName][0], names, values, 2);
+    ValidateCoalescedSample(proxy->changedSamples[ifcName][1], &names[2], &values[2], 1);
+}
+
+/*
+ * Enable coalescing and mark P1 as changed. Unregister the BusObject before
+ * the interval expires. Verify that the pending change is dropped without P1
+ * being read and that marking properties is refused from then on.
+ */
+TEST_F(PropChangedTest, CoalesceStoppedOnUnregister)
+{
+    TestParameters tp(true, InterfaceParameters(P1to2));
+    SetupPropChanged(tp, tp);
+    const char* ifcName = tp.intfParams[0].name.c_str();
+
+    EXPECT_EQ(ER_OK, obj->SetPropChangedCoalescing(TIMEOUT_EXPECTED));
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED));
+    serviceBus.UnregisterBusObject(*obj);
+    EXPECT_EQ(ER_TIMEOUT, proxy->TimedWait(2 * TIMEOUT_EXPECTED));
+    EXPECT_TRUE(obj->getsPerPropName.end() == obj->getsPerPropName.find("P1"));
+    EXPECT_EQ(ER_BUS_OBJECT_NOT_REGISTERED, obj->MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED));
+}
+
+class PropChangedMarker : public Thread {
+  public:
+    PropChangedMarker(BusObject& obj, const char* ifcName) : Thread("PropChangedMarker"), obj(obj), ifcName(ifcName), marks(0) { }
+
+    BusObject& obj;
+    const char* ifcName;
+    volatile uint32_t marks;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        while (!IsStopping()) {
+            obj.MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED);
+            ++marks;
+        }
+        return 0;
+    }
+};
+
+/*
+ * Enable coalescing with a short interval and keep marking P1 as changed from
+ * another thread while the BusObject is unregistered. Verify that nothing is
+ * read from the timer once unregistering has returned.
+ */
+TEST_F(PropChangedTest, CoalesceStopWhileMarking)
+{
+    TestParameters tp(true, InterfaceParameters(P1to2));
+    SetupPropChanged(tp, tp);
+    const char* ifcName = tp.intfParams[0].name.c_str();
+
+    EXPECT_EQ(ER_OK, obj->SetPropChangedCoalescing(1));
+    PropChangedMarker marker(*obj, ifcName);
+    ASSERT_EQ(ER_OK, marker.Start());
+    while (marker.marks < 1000) {
+        qcc::Sleep(1);
+    }
+    serviceBus.UnregisterBusObject(*obj);
+    marker.Stop();
+    marker.Join();
+
+    int gets = obj->getsPerPropName["P1"];
+    EXPECT_LT(0, gets);
+    qcc::Sleep(50);
+    EXPECT_EQ(gets, obj->getsPerPropName["P1"]);
+}
+
+/*
+ * Register a handler that reads several properties at once. Verify that
+ * PropertiesChanged for P1 and P2 reads them in a single call.
+ */
+TEST_F(PropChangedTest, PropsGetter)
+{
+    TestParameters tp(true, InterfaceParameters(P1to2));
+    clientBus.WaitForSession();
+    obj = new PropChangedTestBusObject(serviceBus, tp.intfParams, OBJECT_PATH, true);
+    proxy = new PropChangedTestProxyBusObject(clientBus, serviceName, tp);
+    qcc::Sleep(TIMEOUT_BEFORE_SIGNAL);
+    const char* ifcName = tp.intfParams[0].name.c_str();
+
+    const char* names[] = { "P1", "P2" };
+    EXPECT_EQ(ER_OK, obj->EmitPropChanged(ifcName, names, 2, SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_OK, proxy->TimedWait(TIMEOUT));
+    EXPECT_EQ(1, obj->bulkGets);
+    EXPECT_EQ(1, obj->getsPerPropName["P1"]);
+    EXPECT_EQ(1, obj->getsPerPropName["P2"]);
+}
+
+/*
+ * Enable coalescing with an interval that will not expire during the test and
+ * mark P1 and P2 as changed. Verify that switching coalescing off emits both
+ * right away and that later changes are no longer held back.
+ */
+TEST_F(PropChangedTest, CoalesceSwitchedOff)
+{
+    TestParameters tp(true, InterfaceParameters(P1to2));
+    SetupPropChanged(tp, tp);
+    const char* ifcName = tp.intfParams[0].name.c_str();
+
+    EXPECT_EQ(ER_OK, obj->SetPropChangedCoalescing(60 * TIMEOUT));
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P1", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P2", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_TIMEOUT, proxy->TimedWait(TIMEOUT_EXPECTED));
+    EXPECT_EQ(ER_OK, obj->SetPropChangedCoalescing(0));
+    EXPECT_EQ(ER_OK, proxy->TimedWait(TIMEOUT));
+
+    EXPECT_EQ(ER_OK, obj->MarkPropChanged(ifcName, "P2", SESSION_ID_ALL_HOSTED));
+    EXPECT_EQ(ER_OK, proxy->TimedWait(TIMEOUT));
+
+    ASSERT_EQ(2U, proxy->changedSamples[ifcName].size());
+    const char* names[] = { "P1", "P2" };
+    const int32_t values[] = { 1, 2 };
+    ValidateCoalescedSample(proxy->changedSamples[ifcName][0], names, values, 2);
+    ValidateCoalescedSample(proxy->changedSamples[ifcName][1], &names[1], &values[1], 1);
+}
+
 /*
  * Create a ProxyBusObject and register a listener to look for
  * PropertiesChanged for property P1. The BusObject contains two properties P1
@@ -2364,3 +2570,127 @@ TEST_F(PropChangedTest, PropertyCache_consistentWithConcurrentCallbackMultiProxy
     delete anotherProxy;
     delete l;
 }
+
+/*
+ * Reads all properties of an interface from the cache until stopped and
+ * checks that every read comes from one update of the cache.
+ */
+class PropertyCacheReader : public Thread {
+  public:
+    PropertyCacheReader(ProxyBusObject& proxy, const char* ifcName, size_t numProps) :
+        Thread("PropertyCacheReader"), proxy(proxy), ifcName(ifcName), numProps(numProps),
+        stop(false), reads(0), failedReads(0), tornReads(0), backwardReads(0) { }
+
+    ProxyBusObject& proxy;
+    const char* ifcName;
+    size_t numProps;
+    volatile bool stop;
+    uint32_t reads;
+    uint32_t failedReads;
+    uint32_t tornReads;      /**< Reads that mixed values of different updates */
+    uint32_t backwardReads;  /**< Reads older than a previous read */
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        int32_t lastOffset = 0;
+        while (!stop) {
+            MsgArg value;
+            size_t n;
+            MsgArg* props;
+            if ((proxy.GetAllProperties(ifcName, value) != ER_OK) ||
+                (value.Get("a{sv}", &n, &props) != ER_OK) || (n != numProps)) {
+                ++failedReads;
+                continue;
+            }
+            /* Property Pk holds the value offset + k where offset identifies the update */
+            int32_t offset = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const char* name;
+                MsgArg* val;
+                int32_t intval;
+                if ((props[i].Get("{sv}", &name, &val) != ER_OK) || (val->Get("i", &intval) != ER_OK)) {
+                    ++failedReads;
+                    break;
+                }
+                int32_t propOffset = intval - atoi(&name[1]);
+                if (i == 0) {
+                    offset = propOffset;
+                } else if (propOffset != offset) {
+                    ++tornReads;
+                    break;
+                }
+            }
+            if (offset < lastOffset) {
+                ++backwardReads;
+            }
+            lastOffset = offset;
+            ++reads;
+        }
+        return 0;
+    }
+};
+
+/*
+ * Read all properties of a cached interface from several threads while the
+ * cache is updated by PropertiesChanged signals that change all of the
+ * properties at once. Verify that every read sees all of the properties of
+ * either the update before or the update after, never a mix of the two.
+ */
+TEST_F(PropChangedTest, PropertyCache_concurrentReaders)
+{
+    TestParameters tpClient(true, P1to3, P1to3, PCM_INTROSPECT);
+    tpClient.AddInterfaceParameters(InterfaceParameters(P1to3, "true", false, INTERFACE_NAME "1"));
+    TestParameters tpService = tpClient;
+    const char* ifcName = tpService.intfParams[0].name.c_str();
+
+    SetupPropChanged(tpService, tpClient);
+    proxy->EnablePropertyCaching();
+    /* Wait a little while for the property cache to be enabled.
+     * We don't have an easy way to detect when this is the case, so we just rely on a long-enough sleep */
+    qcc::Sleep(WAIT_CACHE_ENABLED_MS);
+
+    /* Fill the cache */
+    MsgArg value;
+    EXPECT_EQ(ER_OK, proxy->GetAllProperties(ifcName, value));
+
+    const size_t numReaders = 4;
+    vector<PropertyCacheReader*> readers;
+    for (size_t i = 0; i < numReaders; ++i) {
+        readers.push_back(new PropertyCacheReader(*proxy, ifcName, 3));
+        EXPECT_EQ(ER_OK, readers[i]->Start());
+    }
+
+    const int32_t updates = 50;
+    for (int32_t i = 1; i <= updates; ++i) {
+        obj->ChangePropertyValues(tpService, i * 100);
+        obj->EmitSignals(tpService);
+        EXPECT_EQ(ER_OK, proxy->signalSema.TimedWait(TIMEOUT));
+    }
+
+    for (size_t i = 0; i < numReaders; ++i) {
+        readers[i]->stop = true;
+        readers[i]->Join();
+        EXPECT_LT(0U, readers[i]->reads);
+        EXPECT_EQ(0U, readers[i]->failedReads);
+        EXPECT_EQ(0U, readers[i]->tornReads);
+        EXPECT_EQ(0U, readers[i]->backwardReads);
+        delete readers[i];
+    }
+
+    /* The last update is the one left in the cache */
+    size_t n;
+    MsgArg* props;
+    const char* name;
+    MsgArg* val;
+    int32_t intval;
+    EXPECT_EQ(ER_OK, proxy->GetAllProperties(ifcName, value));
+    ASSERT_EQ(ER_OK, value.Get("a{sv}", &n, &props));
+    ASSERT_EQ(3U, n);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(ER_OK, props[i].Get("{sv}", &name, &val));
+        ASSERT_EQ(ER_OK, val->Get("i", &intval));
+        EXPECT_EQ(updates * 100 + atoi(&name[1]), intval);
+    }
+}
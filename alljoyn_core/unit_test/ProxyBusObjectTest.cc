@@ -18,7 +18,9 @@
 #include "ajTestCommon.h"
 #include <qcc/Condition.h>
 #include <qcc/Mutex.h>
+#include <qcc/StringUtil.h>
 #include <qcc/Util.h>
+#include <alljoyn/AllJoynStd.h>
 #include <alljoyn/Message.h>
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/BusObject.h>
@@ -28,6 +30,8 @@
 #include <alljoyn/DBusStd.h>
 #include <qcc/Thread.h>
 
+#include "XmlHelper.h"
+
 using namespace ajn;
 using namespace qcc;
 
@@ -291,6 +295,168 @@ TEST_F(ProxyBusObjectTest, ParseXml) {
     EXPECT_STREQ(expectedIntrospect, introspect.c_str());
 }
 
+TEST_F(ProxyBusObjectTest, ParseXmlChildren) {
+    const char* busObjectXML =
+        "<!DOCTYPE node PUBLIC \"-//freedesktop//DTD D-BUS Object Introspection 1.0//EN\"\n"
+        "\"http://standards.freedesktop.org/dbus/introspect-1.0.dtd\">\n"
+        "<node name=\"/org/alljoyn/test\">\n"
+        "  <node name=\"first\">\n"
+        "    <interface name=\"org.alljoyn.test.ParseXmlChildren\">\n"
+        "      <method name=\"ping\">\n"
+        "        <arg name=\"in\" type=\"s\" direction=\"in\"/>\n"
+        "      </method>\n"
+        "    </interface>\n"
+        "    <node name=\"grandchild\"/>\n"
+        "  </node>\n"
+        "  <!-- The secure annotation applies to children that come before it -->\n"
+        "  <annotation name=\"org.alljoyn.Bus.Secure\" value=\"true\"/>\n"
+        "  <node name=\"second\">\n"
+        "    <interface name=\"org.alljoyn.test.ParseXmlChildren\">\n"
+        "      <method name=\"ping\">\n"
+        "        <arg name=\"in\" type=\"s\" direction=\"in\"/>\n"
+        "      </method>\n"
+        "    </interface>\n"
+        "  </node>\n"
+        "</node>\n";
+
+    ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+    EXPECT_EQ(ER_OK, proxyObj.ParseXml(busObjectXML, NULL));
+    EXPECT_TRUE(proxyObj.IsSecure());
+
+    ProxyBusObject* first = proxyObj.GetChild("first");
+    ASSERT_TRUE(first != NULL);
+    EXPECT_TRUE(first->IsSecure());
+    EXPECT_TRUE(first->GetChild("grandchild") != NULL);
+    ProxyBusObject* second = proxyObj.GetChild("second");
+    ASSERT_TRUE(second != NULL);
+
+    /* Both children share the interface registered with the bus */
+    const InterfaceDescription* intf = bus.GetInterface("org.alljoyn.test.ParseXmlChildren");
+    ASSERT_TRUE(intf != NULL);
+    EXPECT_EQ(intf, first->GetInterface("org.alljoyn.test.ParseXmlChildren"));
+    EXPECT_EQ(intf, second->GetInterface("org.alljoyn.test.ParseXmlChildren"));
+
+    /* Parsing the same XML again finds the existing children */
+    EXPECT_EQ(ER_OK, proxyObj.ParseXml(busObjectXML, NULL));
+    EXPECT_EQ(first, proxyObj.GetChild("first"));
+    EXPECT_EQ(2U, proxyObj.GetChildren());
+}
+
+TEST_F(ProxyBusObjectTest, ParseXmlLenient) {
+    /* An attribute without a value is tolerated */
+    const char* busObjectXML =
+        "<node attr>\n"
+        "  <interface name=\"org.alljoyn.test.ParseXmlLenient\">\n"
+        "    <method name=\"ping\"/>\n"
+        "  </interface>\n"
+        "  <node name=\"child\"/>\n"
+        "</node>\n";
+
+    ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+    EXPECT_EQ(ER_OK, proxyObj.ParseXml(busObjectXML, NULL));
+    EXPECT_TRUE(proxyObj.ImplementsInterface("org.alljoyn.test.ParseXmlLenient"));
+    EXPECT_TRUE(proxyObj.GetChild("child") != NULL);
+}
+
+TEST_F(ProxyBusObjectTest, ParseXmlRejectedLeavesNoTrace) {
+    /* Well formed up to the last element, which is cut short */
+    const char* busObjectXML =
+        "<node>\n"
+        "  <annotation name=\"org.alljoyn.Bus.Secure\" value=\"true\"/>\n"
+        "  <interface name=\"org.alljoyn.test.ParseXmlRejected\">\n"
+        "    <method name=\"ping\"/>\n"
+        "  </interface>\n"
+        "  <node name=\"child\">\n"
+        "    <interface name=\"org.alljoyn.test.ParseXmlRejectedChild\">\n"
+        "      <method name=\"ping\"/>\n"
+        "    </interface>\n"
+        "  </node>\n"
+        "  <node name=\"truncated\"\n";
+
+    ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+    size_t numIfaces = proxyObj.GetInterfaces();
+    EXPECT_NE(ER_OK, proxyObj.ParseXml(busObjectXML, NULL));
+    EXPECT_FALSE(proxyObj.IsSecure());
+    EXPECT_EQ(0U, proxyObj.GetChildren());
+    EXPECT_EQ(numIfaces, proxyObj.GetInterfaces());
+    EXPECT_TRUE(bus.GetInterface("org.alljoyn.test.ParseXmlRejected") == NULL);
+    EXPECT_TRUE(bus.GetInterface("org.alljoyn.test.ParseXmlRejectedChild") == NULL);
+}
+
+TEST_F(ProxyBusObjectTest, ParseXmlInterfaceMismatch) {
+    const char* busObjectXML =
+        "<node>\n"
+        "  <interface name=\"org.alljoyn.test.ParseXmlMismatch\">\n"
+        "    <method name=\"ping\"/>\n"
+        "  </interface>\n"
+        "</node>\n";
+    const char* mismatchXML =
+        "<node>\n"
+        "  <interface name=\"org.alljoyn.test.ParseXmlMismatch\">\n"
+        "    <method name=\"pong\"/>\n"
+        "  </interface>\n"
+        "</node>\n";
+
+    ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+    EXPECT_EQ(ER_OK, proxyObj.ParseXml(busObjectXML, NULL));
+    EXPECT_EQ(ER_BUS_INTERFACE_MISMATCH, proxyObj.ParseXml(mismatchXML, NULL));
+}
+
+/*
+ * Introspection XML for an interface with a given number of methods.
+ */
+static qcc::String InterfaceXml(const qcc::String& name, size_t numMethods)
+{
+    qcc::String xml = "<interface name=\"" + name + "\">\n";
+    for (size_t i = 0; i < numMethods; ++i) {
+        xml += "  <method name=\"method" + qcc::U32ToString(i) + "\">\n";
+        xml += "    <arg name=\"in\" type=\"s\" direction=\"in\"/>\n";
+        xml += "  </method>\n";
+    }
+    xml += "</interface>\n";
+    return xml;
+}
+
+TEST_F(ProxyBusObjectTest, ParseXmlInterfaceCacheIsBounded) {
+    /* Enough interfaces to go over the byte limit well before the count limit */
+    const size_t numMethods = 20;
+    qcc::String first = InterfaceXml("org.alljoyn.test.ParseXmlBounded0", numMethods);
+    size_t numInterfaces = 2 * XmlHelper::MAX_CACHED_INTERFACE_BYTES / first.size();
+    ASSERT_GT(XmlHelper::MAX_CACHED_INTERFACES, numInterfaces);
+    for (size_t i = 0; i < numInterfaces; ++i) {
+        qcc::String xml = "<node>\n" + InterfaceXml("org.alljoyn.test.ParseXmlBounded" + qcc::U32ToString(i), numMethods) + "</node>\n";
+        ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+        EXPECT_EQ(ER_OK, proxyObj.ParseXml(xml.c_str(), NULL));
+        size_t count;
+        size_t bytes;
+        XmlHelper::GetInterfaceCacheSize(count, bytes);
+        EXPECT_GE(XmlHelper::MAX_CACHED_INTERFACE_BYTES, bytes);
+        EXPECT_GE(XmlHelper::MAX_CACHED_INTERFACES, count);
+    }
+
+    /* An interface dropped from the cache is parsed again */
+    ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+    EXPECT_EQ(ER_OK, proxyObj.ParseXml(("<node>\n" + first + "</node>\n").c_str(), NULL));
+    EXPECT_TRUE(proxyObj.ImplementsInterface("org.alljoyn.test.ParseXmlBounded0"));
+}
+
+TEST_F(ProxyBusObjectTest, ParseXmlLargeInterfaceNotCached) {
+    qcc::String intf = InterfaceXml("org.alljoyn.test.ParseXmlLarge", 200);
+    ASSERT_LT(XmlHelper::MAX_CACHED_INTERFACE_SIZE, intf.size());
+    size_t count;
+    size_t bytes;
+    XmlHelper::GetInterfaceCacheSize(count, bytes);
+
+    ProxyBusObject proxyObj(bus, NULL, "/org/alljoyn/test", 0);
+    EXPECT_EQ(ER_OK, proxyObj.ParseXml(("<node>\n" + intf + "</node>\n").c_str(), NULL));
+    EXPECT_TRUE(proxyObj.ImplementsInterface("org.alljoyn.test.ParseXmlLarge"));
+    size_t newCount;
+    size_t newBytes;
+    XmlHelper::GetInterfaceCacheSize(newCount, newBytes);
+    EXPECT_EQ(count, newCount);
+    EXPECT_EQ(bytes, newBytes);
+}
+
 TEST_F(ProxyBusObjectTest, SecureConnection) {
     auth_complete_listener1_flag = false;
     auth_complete_listener2_flag = false;
@@ -447,6 +613,106 @@ TEST_F(ProxyBusObjectTest, GetChildren) {
     delete [] children;
 }
 
+class ProxyBusObjectTreeObject : public BusObject {
+  public:
+    ProxyBusObjectTreeObject(BusAttachment& bus, const char* path, bool tree) : BusObject(path)
+    {
+        EXPECT_EQ(ER_OK, AddInterface(*bus.GetInterface(INTERFACE_NAME)));
+        if (tree) {
+            EXPECT_EQ(ER_OK, AddInterface(*bus.GetInterface(org::allseen::IntrospectableTree::InterfaceName)));
+        }
+    }
+};
+
+static void IntrospectRemoteObjectTree(BusAttachment& bus, BusAttachment& servicebus, bool tree)
+{
+    InterfaceDescription* testIntf = NULL;
+    ASSERT_EQ(ER_OK, servicebus.CreateInterface(INTERFACE_NAME, testIntf, false));
+    testIntf->AddMember(MESSAGE_METHOD_CALL, "ping", "s", "s", "in,out", 0);
+    testIntf->Activate();
+    ASSERT_EQ(ER_OK, servicebus.Start());
+    ASSERT_EQ(ER_OK, servicebus.Connect(ajn::getConnectArg().c_str()));
+
+    ProxyBusObjectTreeObject root(servicebus, "/org/alljoyn/test/tree", tree);
+    ProxyBusObjectTreeObject a(servicebus, "/org/alljoyn/test/tree/a", false);
+    ProxyBusObjectTreeObject ab(servicebus, "/org/alljoyn/test/tree/a/b", false);
+    ProxyBusObjectTreeObject c(servicebus, "/org/alljoyn/test/tree/c", false);
+    EXPECT_EQ(ER_OK, servicebus.RegisterBusObject(root));
+    EXPECT_EQ(ER_OK, servicebus.RegisterBusObject(a));
+    EXPECT_EQ(ER_OK, servicebus.RegisterBusObject(ab, true));
+    EXPECT_EQ(ER_OK, servicebus.RegisterBusObject(c));
+
+    ProxyBusObject proxyObj(bus, servicebus.GetUniqueName().c_str(), "/org/alljoyn/test/tree", 0);
+    EXPECT_EQ(ER_OK, proxyObj.IntrospectRemoteObjectTree());
+    EXPECT_EQ(tree, proxyObj.ImplementsInterface(org::allseen::IntrospectableTree::InterfaceName));
+    EXPECT_TRUE(proxyObj.ImplementsInterface(INTERFACE_NAME));
+    EXPECT_EQ(2U, proxyObj.GetChildren());
+
+    ProxyBusObject* child = proxyObj.GetChild("a/b");
+    ASSERT_TRUE(child != NULL);
+    EXPECT_TRUE(child->ImplementsInterface(INTERFACE_NAME));
+    EXPECT_TRUE(child->IsSecure());
+    child = proxyObj.GetChild("c");
+    ASSERT_TRUE(child != NULL);
+    EXPECT_TRUE(child->ImplementsInterface(INTERFACE_NAME));
+    EXPECT_FALSE(child->IsSecure());
+
+    servicebus.UnregisterBusObject(c);
+    servicebus.UnregisterBusObject(ab);
+    servicebus.UnregisterBusObject(a);
+    servicebus.UnregisterBusObject(root);
+}
+
+TEST_F(ProxyBusObjectTest, IntrospectRemoteObjectTree) {
+    IntrospectRemoteObjectTree(bus, servicebus, true);
+}
+
+TEST_F(ProxyBusObjectTest, IntrospectRemoteObjectTreeFallback) {
+    IntrospectRemoteObjectTree(bus, servicebus, false);
+}
+
+class ProxyBusObjectSilentTreeObject : public BusObject {
+  public:
+    ProxyBusObjectSilentTreeObject(BusAttachment& bus, const char* path) : BusObject(path)
+    {
+        EXPECT_EQ(ER_OK, AddInterface(*bus.GetInterface(INTERFACE_NAME)));
+        const InterfaceDescription* treeIntf = bus.GetInterface(org::allseen::IntrospectableTree::InterfaceName);
+        EXPECT_EQ(ER_OK, AddInterface(*treeIntf));
+        EXPECT_EQ(ER_OK, AddMethodHandler(treeIntf->GetMember("IntrospectTree"), static_cast<MessageReceiver::MethodHandler>(&ProxyBusObjectSilentTreeObject::IntrospectTree)));
+    }
+
+    /* Never replies so the caller times out */
+    void IntrospectTree(const InterfaceDescription::Member* member, Message& msg)
+    {
+        QCC_UNUSED(member);
+        QCC_UNUSED(msg);
+    }
+};
+
+TEST_F(ProxyBusObjectTest, IntrospectRemoteObjectTreeFallbackOnTimeout) {
+    InterfaceDescription* testIntf = NULL;
+    ASSERT_EQ(ER_OK, servicebus.CreateInterface(INTERFACE_NAME, testIntf, false));
+    testIntf->AddMember(MESSAGE_METHOD_CALL, "ping", "s", "s", "in,out", 0);
+    testIntf->Activate();
+    ASSERT_EQ(ER_OK, servicebus.Start());
+    ASSERT_EQ(ER_OK, servicebus.Connect(ajn::getConnectArg().c_str()));
+
+    ProxyBusObjectSilentTreeObject root(servicebus, "/org/alljoyn/test/tree");
+    ProxyBusObjectTreeObject child(servicebus, "/org/alljoyn/test/tree/child", false);
+    EXPECT_EQ(ER_OK, servicebus.RegisterBusObject(root));
+    EXPECT_EQ(ER_OK, servicebus.RegisterBusObject(child));
+
+    ProxyBusObject proxyObj(bus, servicebus.GetUniqueName().c_str(), "/org/alljoyn/test/tree", 0);
+    EXPECT_EQ(ER_OK, proxyObj.IntrospectRemoteObjectTree(500));
+    EXPECT_TRUE(proxyObj.ImplementsInterface(INTERFACE_NAME));
+    ProxyBusObject* proxyChild = proxyObj.GetChild("child");
+    ASSERT_TRUE(proxyChild != NULL);
+    EXPECT_TRUE(proxyChild->ImplementsInterface(INTERFACE_NAME));
+
+    servicebus.UnregisterBusObject(child);
+    servicebus.UnregisterBusObject(root);
+}
+
 // ALLJOYN-1908
 TEST_F(ProxyBusObjectTest, AddChild_regressionTest) {
     InterfaceDescription* testIntf = NULL;
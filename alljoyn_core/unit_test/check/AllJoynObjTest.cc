@@ -14,6 +14,14 @@
  *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  ******************************************************************************/
 #include <qcc/platform.h>
+#include <qcc/Event.h>
+#include <qcc/Mutex.h>
+#include <qcc/Thread.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
 
 #include "AllJoynObj.h"
 #include "ConfigDB.h"
@@ -143,8 +151,8 @@ class TestAllJoynObj : public AllJoynObj {
         JoinSessionMethodCall msg(bus, ":joiner.3", id, ":host.3", port, opts);
 
         bool isJoin = true;
-        TestJoinSessionThread joinSessionThread(*this, Message::cast(msg), isJoin);
-        joinSessionThread.RunJoin();
+        TestJoinSessionRequest joinSessionRequest(*this, Message::cast(msg), isJoin);
+        joinSessionRequest.RunJoin();
     }
     virtual Transport* GetTransport(const String& transportSpec) {
         for (vector<TestTransport*>::iterator it = transportList.begin(); it != transportList.end(); ++it) {
@@ -206,10 +214,10 @@ class TestAllJoynObj : public AllJoynObj {
         return ER_OK;
     }
 
-    class TestJoinSessionThread : public JoinSessionThread {
+    class TestJoinSessionRequest : public JoinSessionRequest {
       public:
-        TestJoinSessionThread(TestAllJoynObj& ajObj, const Message& msg, bool isJoin)
-            : JoinSessionThread(ajObj, msg, isJoin), ajObj(ajObj) { }
+        TestJoinSessionRequest(TestAllJoynObj& ajObj, const Message& msg, bool isJoin)
+            : JoinSessionRequest(ajObj, msg, isJoin), ajObj(ajObj) { }
         virtual QStatus Reply(uint32_t sessionReplyCode, SessionId id, SessionOpts optsOut) {
             QCC_UNUSED(id);
             ajObj.replyCode = sessionReplyCode;
@@ -372,3 +380,269 @@ TEST(AllJoynObjTest, JoinSessionTriesAllAvailableTransportsAfterAttachSessionFai
     EXPECT_EQ(TRANSPORT_UDP | TRANSPORT_TCP, ajObj.triedTransports);
     EXPECT_EQ(TRANSPORT_TCP, ajObj.connectedTransport);
 }
+
+/*
+ * Keeps track of the session setup requests of one kind.
+ */
+struct SessionSetupProbe {
+    SessionSetupProbe() : running(0), peakRunning(0), deleted(0) { }
+
+    Mutex lock;
+    Event release;              /* Set to let the requests finish */
+    uint32_t running;
+    uint32_t peakRunning;
+    uint32_t deleted;
+    vector<uint32_t> started;   /* The requests in the order they started running */
+};
+
+class SessionSetupAllJoynObj : public TestAllJoynObj {
+  public:
+    SessionSetupAllJoynObj(Bus& bus) : TestAllJoynObj(bus) { }
+
+    QStatus StartDispatchers(uint32_t maxJoins, uint32_t maxAttaches) {
+        return StartSessionSetupDispatchers(maxJoins, maxAttaches);
+    }
+
+    /*
+     * Queue a request that does nothing but wait for its probe to be released.
+     */
+    void Queue(bool isJoin, uint32_t tag) {
+        Message msg(bus);
+        DispatchSessionSetup(new BlockingRequest(*this, msg, isJoin, tag, isJoin ? joins : attaches));
+    }
+
+    /*
+     * Wait for the number of requests being processed or completed to reach the given counts.
+     */
+    bool WaitForStats(uint32_t joinsInFlight, uint32_t joinsCompleted, uint32_t attachesInFlight, uint32_t attachesCompleted) {
+        for (uint32_t i = 0; i < 400; ++i) {
+            SessionSetupStats joinStats;
+            SessionSetupStats attachStats;
+            GetSessionSetupStats(joinStats, attachStats);
+            if ((joinStats.inFlight == joinsInFlight) && (joinStats.completed == joinsCompleted) &&
+                (attachStats.inFlight == attachesInFlight) && (attachStats.completed == attachesCompleted)) {
+                return true;
+            }
+            qcc::Sleep(5);
+        }
+        return false;
+    }
+
+    class BlockingRequest : public JoinSessionRequest {
+      public:
+        BlockingRequest(AllJoynObj& ajObj, const Message& msg, bool isJoin, uint32_t tag, SessionSetupProbe& probe)
+            : JoinSessionRequest(ajObj, msg, isJoin), tag(tag), probe(probe) { }
+
+        ~BlockingRequest() {
+            probe.lock.Lock();
+            ++probe.deleted;
+            probe.lock.Unlock();
+        }
+
+      protected:
+        virtual void Run() {
+            probe.lock.Lock();
+            probe.started.push_back(tag);
+            probe.peakRunning = max(probe.peakRunning, ++probe.running);
+            probe.lock.Unlock();
+
+            /* Stopping the dispatcher alerts the wait */
+            Event::Wait(probe.release);
+
+            probe.lock.Lock();
+            --probe.running;
+            probe.lock.Unlock();
+        }
+
+      private:
+        uint32_t tag;
+        SessionSetupProbe& probe;
+    };
+
+    SessionSetupProbe joins;
+    SessionSetupProbe attaches;
+};
+
+TEST(AllJoynObjTest, SessionSetupRequestsQueueBeyondConcurrencyLimit)
+{
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+
+    TransportFactoryContainer factories;
+    Bus bus("AllJoynObjTest", factories);
+
+    SessionSetupAllJoynObj ajObj(bus);
+    ASSERT_EQ(ER_OK, ajObj.StartDispatchers(2, 1));
+    for (uint32_t i = 0; i < 5; ++i) {
+        ajObj.Queue(true, i);
+    }
+    for (uint32_t i = 0; i < 3; ++i) {
+        ajObj.Queue(false, i);
+    }
+
+    // Only as many requests as the limits allow are processed, the rest wait
+    ASSERT_TRUE(ajObj.WaitForStats(2, 0, 1, 0));
+    qcc::Sleep(50);
+    AllJoynObj::SessionSetupStats joinStats;
+    AllJoynObj::SessionSetupStats attachStats;
+    ajObj.GetSessionSetupStats(joinStats, attachStats);
+    EXPECT_EQ(3U, joinStats.queued);
+    EXPECT_EQ(2U, joinStats.inFlight);
+    EXPECT_EQ(0U, joinStats.completed);
+    EXPECT_EQ(2U, attachStats.queued);
+    EXPECT_EQ(1U, attachStats.inFlight);
+    EXPECT_EQ(0U, attachStats.completed);
+    EXPECT_EQ(2U, ajObj.joins.started.size());
+    EXPECT_EQ(1U, ajObj.attaches.started.size());
+
+    // Once released the queued requests are all processed
+    ajObj.joins.release.SetEvent();
+    ajObj.attaches.release.SetEvent();
+    ASSERT_TRUE(ajObj.WaitForStats(0, 5, 0, 3));
+    ajObj.GetSessionSetupStats(joinStats, attachStats);
+    EXPECT_EQ(0U, joinStats.queued);
+    EXPECT_EQ(0U, attachStats.queued);
+    EXPECT_LE(50U, joinStats.maxLatency);
+    EXPECT_LE(joinStats.maxLatency, joinStats.totalLatency);
+    EXPECT_LE(50U, attachStats.maxLatency);
+    EXPECT_LE(attachStats.maxLatency, attachStats.totalLatency);
+
+    EXPECT_EQ(2U, ajObj.joins.peakRunning);
+    EXPECT_EQ(1U, ajObj.attaches.peakRunning);
+    EXPECT_EQ(5U, ajObj.joins.deleted);
+    EXPECT_EQ(3U, ajObj.attaches.deleted);
+
+    // With a single dispatcher thread requests run in the order they arrived
+    ASSERT_EQ(3U, ajObj.attaches.started.size());
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(i, ajObj.attaches.started[i]);
+    }
+}
+
+TEST(AllJoynObjTest, SessionSetupStopDropsQueuedRequests)
+{
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+
+    TransportFactoryContainer factories;
+    Bus bus("AllJoynObjTest", factories);
+
+    SessionSetupAllJoynObj ajObj(bus);
+    ASSERT_EQ(ER_OK, ajObj.StartDispatchers(1, 1));
+    for (uint32_t i = 0; i < 4; ++i) {
+        ajObj.Queue(true, i);
+    }
+    ASSERT_TRUE(ajObj.WaitForStats(1, 0, 0, 0));
+
+    // The running request is alerted and the queued ones are dropped
+    ajObj.Stop();
+    ajObj.Join();
+    AllJoynObj::SessionSetupStats joinStats;
+    AllJoynObj::SessionSetupStats attachStats;
+    ajObj.GetSessionSetupStats(joinStats, attachStats);
+    EXPECT_EQ(0U, joinStats.queued);
+    EXPECT_EQ(0U, joinStats.inFlight);
+    EXPECT_EQ(1U, joinStats.completed);
+    EXPECT_EQ(1U, ajObj.joins.started.size());
+    EXPECT_EQ(4U, ajObj.joins.deleted);
+
+    // Requests arriving after Stop() are never queued
+    ajObj.Queue(true, 4);
+    ajObj.GetSessionSetupStats(joinStats, attachStats);
+    EXPECT_EQ(0U, joinStats.queued);
+    EXPECT_EQ(5U, ajObj.joins.deleted);
+    EXPECT_EQ(1U, ajObj.joins.started.size());
+}
+
+/*
+ * Resolves names to virtual endpoints behind given bus-to-bus endpoints.
+ */
+class PingRouteAllJoynObj : public TestAllJoynObj {
+  public:
+    using AllJoynObj::PingRoute;
+    using AllJoynObj::PingRouteMap;
+    using AllJoynObj::noPingMultipleRoutes;
+
+    PingRouteAllJoynObj(Bus& bus) : TestAllJoynObj(bus) { }
+
+    void AddName(const String& name, RemoteEndpoint& b2bEp) {
+        TestVirtualEndpoint vep(name, b2bEp);
+        endpoints[name] = BusEndpoint::cast(vep);
+    }
+
+    virtual BusEndpoint FindEndpoint(const String& busName) {
+        map<String, BusEndpoint>::iterator it = endpoints.find(busName);
+        return (it == endpoints.end()) ? BusEndpoint() : it->second;
+    }
+
+    void Group(const set<String>& names, PingRouteMap& routes, vector<String>& single) {
+        GroupPingsByRoute(names, routes, single);
+    }
+
+    map<String, BusEndpoint> endpoints;
+};
+
+static RemoteEndpoint CreateB2BEndpoint(Bus& bus, const char* uniqueName, uint32_t protocolVersion)
+{
+    bool incoming = false;
+    const char* connectSpec = "";
+    Stream* stream = NULL;
+    RemoteEndpoint b2bEp(bus, incoming, connectSpec, stream);
+    b2bEp->SetUniqueName(uniqueName);
+    b2bEp->GetFeatures().protocolVersion = protocolVersion;
+    return b2bEp;
+}
+
+TEST(AllJoynObjTest, PingMultipleBatchesUnlessRoutingNodeRefused)
+{
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+
+    TransportFactoryContainer factories;
+    Bus bus("AllJoynObjTest", factories);
+    PingRouteAllJoynObj ajObj(bus);
+
+    RemoteEndpoint newNode = CreateB2BEndpoint(bus, ":new.1", ALLJOYN_PROTOCOL_VERSION);
+    RemoteEndpoint oldNode = CreateB2BEndpoint(bus, ":old.1", ALLJOYN_PROTOCOL_VERSION);
+    RemoteEndpoint loneNode = CreateB2BEndpoint(bus, ":lone.1", ALLJOYN_PROTOCOL_VERSION);
+    ajObj.AddName(":a.2", newNode);
+    ajObj.AddName(":a.3", newNode);
+    ajObj.AddName("org.example.A", newNode);
+    ajObj.AddName(":b.2", oldNode);
+    ajObj.AddName(":b.3", oldNode);
+    ajObj.AddName(":c.2", loneNode);
+
+    // The routing node behind oldNode answered an earlier PingMultiple with an error
+    ajObj.noPingMultipleRoutes.insert(":old.1");
+
+    set<String> names;
+    names.insert(":a.2");
+    names.insert(":a.3");
+    names.insert("org.example.A");
+    names.insert(":b.2");
+    names.insert(":b.3");
+    names.insert(":c.2");
+    names.insert(":unknown.2");
+
+    PingRouteAllJoynObj::PingRouteMap routes;
+    vector<String> single;
+    ajObj.Group(names, routes, single);
+
+    // Only the names behind the routing node that did not refuse PingMultiple are batched
+    ASSERT_EQ(1U, routes.size());
+    ASSERT_TRUE(routes.find(":new.1") != routes.end());
+    PingRouteAllJoynObj::PingRoute& route = routes[":new.1"];
+    EXPECT_TRUE(route.b2bEp == newNode);
+    ASSERT_EQ(3U, route.names.size());
+    EXPECT_STREQ(":a.2", route.names[0].c_str());
+    EXPECT_STREQ(":a.3", route.names[1].c_str());
+    EXPECT_STREQ("org.example.A", route.names[2].c_str());
+
+    // Names behind a routing node that refused PingMultiple, alone behind theirs or not behind one at all fall back to Ping
+    sort(single.begin(), single.end());
+    ASSERT_EQ(4U, single.size());
+    EXPECT_STREQ(":b.2", single[0].c_str());
+    EXPECT_STREQ(":b.3", single[1].c_str());
+    EXPECT_STREQ(":c.2", single[2].c_str());
+    EXPECT_STREQ(":unknown.2", single[3].c_str());
+}
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Thread.h>
+
+#include <vector>
+
+#include <alljoyn/BusAttachment.h>
+
+#include "CachedProps.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+class CachedPropsTest : public testing::Test {
+  public:
+    CachedPropsTest() : bus("CachedPropsTest"), iface(NULL) { }
+
+    virtual void SetUp()
+    {
+        InterfaceDescription* intf = NULL;
+        ASSERT_EQ(ER_OK, bus.CreateInterface("org.test.cachedprops", intf));
+        ASSERT_EQ(ER_OK, intf->AddProperty("A", "u", PROP_ACCESS_READ));
+        ASSERT_EQ(ER_OK, intf->AddPropertyAnnotation("A", org::freedesktop::DBus::AnnotateEmitsChanged, "true"));
+        ASSERT_EQ(ER_OK, intf->AddProperty("B", "u", PROP_ACCESS_READ));
+        ASSERT_EQ(ER_OK, intf->AddPropertyAnnotation("B", org::freedesktop::DBus::AnnotateEmitsChanged, "true"));
+        intf->Activate();
+        iface = intf;
+    }
+
+    /*
+     * Change both properties to the same value.
+     */
+    static void Change(CachedProps& cache, uint32_t value, uint32_t serial)
+    {
+        MsgArg changed[2];
+        MsgArg a("u", value);
+        MsgArg b("u", value);
+        changed[0].Set("{sv}", "A", &a);
+        changed[1].Set("{sv}", "B", &b);
+        cache.PropertiesChanged(changed, 2, NULL, 0, serial);
+    }
+
+    BusAttachment bus;
+    const InterfaceDescription* iface;
+};
+
+class CachedPropsReader : public Thread {
+  public:
+    CachedPropsReader(CachedProps& cache) : Thread("CachedPropsReader"), cache(cache), stop(false), reads(0), errors(0), maxSnapshots(0) { }
+
+    CachedProps& cache;
+    volatile bool stop;
+    uint32_t reads;
+    uint32_t errors;
+    int32_t maxSnapshots;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        uint32_t last = 0;
+        while (!stop) {
+            MsgArg all;
+            if (cache.GetAll(all)) {
+                MsgArg* entries;
+                size_t num;
+                uint32_t values[2] = { 0, 0 };
+                if ((all.Get("a{sv}", &num, &entries) != ER_OK) || (num != 2)) {
+                    ++errors;
+                    continue;
+                }
+                for (size_t i = 0; i < num; ++i) {
+                    const char* name;
+                    MsgArg* val;
+                    if ((entries[i].Get("{sv}", &name, &val) != ER_OK) || (val->Get("u", &values[i]) != ER_OK)) {
+                        ++errors;
+                    }
+                }
+                /* Every update changes both so a reader never sees them differ */
+                if ((values[0] != values[1]) || (values[0] < last)) {
+                    ++errors;
+                }
+                last = values[0];
+            }
+            MsgArg one;
+            cache.Get("A", one);
+            int32_t snapshots = cache.GetNumSnapshots();
+            if (snapshots > maxSnapshots) {
+                maxSnapshots = snapshots;
+            }
+            ++reads;
+        }
+        return 0;
+    }
+};
+
+TEST_F(CachedPropsTest, Get)
+{
+    CachedProps cache(iface);
+    cache.Enable();
+    MsgArg val;
+    EXPECT_FALSE(cache.Get("A", val));
+    EXPECT_FALSE(cache.GetAll(val));
+
+    Change(cache, 7, 1);
+    ASSERT_TRUE(cache.Get("A", val));
+    uint32_t value = 0;
+    EXPECT_EQ(ER_OK, val.Get("u", &value));
+    EXPECT_EQ(7U, value);
+    EXPECT_TRUE(cache.GetAll(val));
+
+    /* An out-of-order update invalidates the cache */
+    Change(cache, 8, 0);
+    EXPECT_FALSE(cache.Get("A", val));
+    EXPECT_EQ(1, cache.GetNumSnapshots());
+}
+
+TEST_F(CachedPropsTest, SnapshotsBoundedUnderReaders)
+{
+    const size_t numReaders = 4;
+    const uint32_t numUpdates = 5000;
+    CachedProps cache(iface);
+    cache.Enable();
+
+    vector<CachedPropsReader*> readers;
+    for (size_t i = 0; i < numReaders; ++i) {
+        readers.push_back(new CachedPropsReader(cache));
+        ASSERT_EQ(ER_OK, readers[i]->Start());
+    }
+
+    /* The readers are always active so replaced snapshots never see a quiet moment */
+    int32_t maxSnapshots = 0;
+    for (uint32_t i = 1; i <= numUpdates; ++i) {
+        Change(cache, i, i);
+        int32_t snapshots = cache.GetNumSnapshots();
+        if (snapshots > maxSnapshots) {
+            maxSnapshots = snapshots;
+        }
+    }
+
+    for (size_t i = 0; i < numReaders; ++i) {
+        readers[i]->stop = true;
+        readers[i]->Join();
+        EXPECT_LT(0U, readers[i]->reads);
+        EXPECT_EQ(0U, readers[i]->errors);
+        EXPECT_GE(2, readers[i]->maxSnapshots);
+        delete readers[i];
+    }
+    EXPECT_GE(2, maxSnapshots);
+    EXPECT_EQ(1, cache.GetNumSnapshots());
+
+    MsgArg val;
+    ASSERT_TRUE(cache.Get("B", val));
+    uint32_t value = 0;
+    EXPECT_EQ(ER_OK, val.Get("u", &value));
+    EXPECT_EQ(numUpdates, value);
+}
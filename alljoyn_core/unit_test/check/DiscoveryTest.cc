@@ -20,6 +20,8 @@
  ******************************************************************************/
 #include "ns/IpNameServiceImpl.h"
 
+#include <set>
+
 /* Header files included for Google Test Framework */
 #include <gtest/gtest.h>
 #include "../ajTestCommon.h"
@@ -126,6 +128,171 @@ TEST_P(DiscoveryTest, ComputePriority)
     ASSERT_EQ(tp.priority, priority);
 }
 
+TEST(DiscoveryPacketTest, TextRDataSerializedSize)
+{
+    // The size used to decide when a packet is full must match what Serialize() writes
+    MDNSAdvertiseRData advRData;
+    advRData.SetTransport(TRANSPORT_TCP);
+    for (uint32_t i = 0; i < 32; ++i) {
+        advRData.SetValue("name", "org.alljoyn.DiscoveryPacketTest.n" + U32ToString(i));
+    }
+    advRData.SetTransport(TRANSPORT_UDP);
+    advRData.SetValue("implements");
+
+    std::map<qcc::String, uint32_t> offsets;
+    size_t size = advRData.GetSerializedSize(offsets);
+    uint8_t* buffer = new uint8_t[size];
+    size_t written = advRData.Serialize(buffer, offsets, 0);
+    delete [] buffer;
+    ASSERT_EQ(size, written);
+}
+
+static IsAt IsAtAnswer(const qcc::String& name)
+{
+    IsAt isAt;
+    isAt.SetVersion(0, 0);
+    isAt.AddName(name);
+    return isAt;
+}
+
+static Packet IsAtPacket(const qcc::String& name)
+{
+    NSPacket nspacket;
+    nspacket->SetVersion(0, 0);
+    nspacket->AddAnswer(IsAtAnswer(name));
+    return Packet::cast(nspacket);
+}
+
+TEST(DiscoveryPacketCacheTest, CapturesCopiesOfBuiltPackets)
+{
+    IpNameServiceImpl::PacketCache cache;
+    uint64_t key = IpNameServiceImpl::PacketCache::Key(TRANSPORT_TCP, 0, 1, false);
+
+    // Nothing is cached unless a capture is in progress
+    ASSERT_TRUE(cache.Find(key, 0) == NULL);
+    ASSERT_FALSE(cache.Add(IsAtPacket("org.alljoyn.a")));
+
+    // Retransmit() reuses the packet it builds, so the cache must keep a copy
+    cache.BeginCapture(key, 0);
+    Packet packet = IsAtPacket("org.alljoyn.a");
+    ASSERT_TRUE(cache.Add(packet));
+    NSPacket::cast(packet)->AddAnswer(IsAtAnswer("org.alljoyn.b"));
+    ASSERT_TRUE(cache.Add(packet));
+    cache.EndCapture();
+    ASSERT_FALSE(cache.Add(packet));
+
+    std::list<IpNameServiceImpl::PacketCache::CachedPacket>* packets = cache.Find(key, 0);
+    ASSERT_TRUE(packets != NULL);
+    ASSERT_EQ(2U, packets->size());
+    ASSERT_EQ(1U, NSPacket::cast(packets->front().packet)->GetNumberAnswers());
+    ASSERT_EQ(2U, NSPacket::cast(packets->back().packet)->GetNumberAnswers());
+
+    // Capturing again replaces what was cached for the key
+    cache.BeginCapture(key, 0);
+    ASSERT_TRUE(cache.Add(IsAtPacket("org.alljoyn.c")));
+    cache.EndCapture();
+    packets = cache.Find(key, 0);
+    ASSERT_TRUE(packets != NULL);
+    ASSERT_EQ(1U, packets->size());
+    ASSERT_EQ(qcc::String("org.alljoyn.c"), NSPacket::cast(packets->front().packet)->GetAnswer(0).GetName(0));
+}
+
+TEST(DiscoveryPacketCacheTest, KeysAndInvalidation)
+{
+    IpNameServiceImpl::PacketCache cache;
+
+    // Every Retransmit() argument the packets depend on is part of the key
+    std::set<uint64_t> keys;
+    keys.insert(IpNameServiceImpl::PacketCache::Key(TRANSPORT_TCP, 0, 1, false));
+    keys.insert(IpNameServiceImpl::PacketCache::Key(TRANSPORT_TCP | TRANSPORT_UDP, 0, 1, false));
+    keys.insert(IpNameServiceImpl::PacketCache::Key(TRANSPORT_TCP, 1, 1, false));
+    keys.insert(IpNameServiceImpl::PacketCache::Key(TRANSPORT_TCP, 0, 3, false));
+    keys.insert(IpNameServiceImpl::PacketCache::Key(TRANSPORT_TCP, 0, 1, true));
+    ASSERT_EQ(5U, keys.size());
+
+    for (std::set<uint64_t>::iterator it = keys.begin(); it != keys.end(); ++it) {
+        cache.BeginCapture(*it, 7);
+        ASSERT_TRUE(cache.Add(IsAtPacket("org.alljoyn.a")));
+        cache.EndCapture();
+    }
+    ASSERT_EQ(keys.size(), cache.Size());
+
+    // Serialized forms are dropped with the live interfaces, the packets are kept
+    std::list<IpNameServiceImpl::PacketCache::CachedPacket>* packets = cache.Find(*keys.begin(), 7);
+    ASSERT_TRUE(packets != NULL);
+    packets->front().serialized[0].buffer.assign(4, 0);
+    cache.ClearSerialized();
+    packets = cache.Find(*keys.begin(), 7);
+    ASSERT_TRUE(packets != NULL);
+    ASSERT_TRUE(packets->front().serialized.empty());
+
+    // Packets built with another priority are stale
+    ASSERT_TRUE(cache.Find(*keys.begin(), 8) == NULL);
+    ASSERT_EQ(keys.size() - 1, cache.Size());
+    ASSERT_TRUE(cache.Find(*keys.begin(), 7) == NULL);
+
+    // A stale entry being captured into is no longer captured into
+    cache.BeginCapture(*keys.begin(), 7);
+    ASSERT_TRUE(cache.Find(*keys.begin(), 8) == NULL);
+    ASSERT_FALSE(cache.Add(IsAtPacket("org.alljoyn.a")));
+
+    cache.BeginCapture(*keys.begin(), 7);
+    cache.Invalidate();
+    ASSERT_EQ(0U, cache.Size());
+    ASSERT_FALSE(cache.Add(IsAtPacket("org.alljoyn.a")));
+}
+
+TEST(DiscoveryResponseTrackerTest, SuppressesWithinInterval)
+{
+    IpNameServiceImpl::ResponseTracker tracker(1000);
+    ASSERT_TRUE(tracker.Answer("a", 5000));
+    // The same response within the interval is suppressed, a different one is not
+    ASSERT_FALSE(tracker.Answer("a", 5999));
+    ASSERT_TRUE(tracker.Answer("b", 5999));
+    // Once the interval has passed the response goes out again
+    ASSERT_TRUE(tracker.Answer("a", 6000));
+    ASSERT_FALSE(tracker.Answer("a", 6500));
+}
+
+TEST(DiscoveryResponseTrackerTest, DeferMergesPendingResponses)
+{
+    IpNameServiceImpl::ResponseTracker tracker(1000);
+    uint64_t due = 0;
+    ASSERT_TRUE(tracker.Answer("a", 5000));
+    ASSERT_FALSE(tracker.Answer("a", 5100));
+    ASSERT_TRUE(tracker.Defer("a", due));
+    ASSERT_EQ(6000U, due);
+    // Further questions are merged into the pending response
+    ASSERT_FALSE(tracker.Answer("a", 5200));
+    ASSERT_FALSE(tracker.Defer("a", due));
+    // Pending responses survive a purge, answered ones are forgotten
+    ASSERT_TRUE(tracker.Answer("b", 5200));
+    tracker.Purge(7000);
+    ASSERT_EQ(1U, tracker.Size());
+    ASSERT_TRUE(tracker.Answer("a", 7000));
+    tracker.Purge(8000);
+    ASSERT_EQ(0U, tracker.Size());
+}
+
+TEST(DiscoveryResponseTrackerTest, ObservedAnswersCountAsSent)
+{
+    IpNameServiceImpl::ResponseTracker tracker(1000);
+    // An identical answer from another host suppresses ours
+    ASSERT_FALSE(tracker.Observe("a", 5000));
+    ASSERT_FALSE(tracker.Answer("a", 5500));
+    ASSERT_TRUE(tracker.Answer("a", 6000));
+    // A pending response is satisfied by an identical answer and restarts the interval
+    uint64_t due = 0;
+    ASSERT_FALSE(tracker.Answer("a", 6100));
+    ASSERT_TRUE(tracker.Defer("a", due));
+    ASSERT_TRUE(tracker.Observe("a", 6200));
+    ASSERT_FALSE(tracker.Observe("a", 6300));
+    ASSERT_FALSE(tracker.Answer("a", 7200));
+    ASSERT_TRUE(tracker.Answer("a", 7300));
+    tracker.Purge(8300);
+    ASSERT_EQ(0U, tracker.Size());
+}
+
 INSTANTIATE_TEST_CASE_P(Discovery, DiscoveryTest,
                         testing::Values(TestParams(StaticParams(ajn::IpNameServiceImpl::ROUTER_POWER_SOURCE_MIN, ajn::IpNameServiceImpl::ROUTER_MOBILITY_MIN, ajn::IpNameServiceImpl::ROUTER_AVAILABILITY_MIN, ajn::IpNameServiceImpl::ROUTER_NODE_CONNECTION_MIN, 7987),
                                                    DynamicParams(1, 16, 2, 16, 2, 8, 1439), 56109),
@@ -0,0 +1,279 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Event.h>
+#include <qcc/ManagedObj.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketStream.h>
+#include <qcc/String.h>
+#include <qcc/Thread.h>
+
+#include <alljoyn/BusAttachment.h>
+
+#include "Bus.h"
+#include "RemoteEndpoint.h"
+#include "TransportFactory.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/*
+ * A remote endpoint over one end of a socket pair that can be told to
+ * redirect the other side.
+ */
+class _TestAuthEndpoint : public _RemoteEndpoint {
+  public:
+    _TestAuthEndpoint(BusAttachment& bus, bool incoming, SocketFd sock) :
+        _RemoteEndpoint(bus, incoming, "test", &stream, "test"), stream(sock) { }
+
+    qcc::String RedirectionAddress() { return redirection; }
+
+    SocketStream stream;
+    qcc::String redirection;
+};
+
+typedef ManagedObj<_TestAuthEndpoint> TestAuthEndpoint;
+
+static const bool INCOMING = true;
+static const bool OUTGOING = false;
+
+/*
+ * Lets anonymous clients in without a router behind the endpoint.
+ */
+class TestEndpointListener : public _RemoteEndpoint::EndpointListener {
+  public:
+    void EndpointExit(RemoteEndpoint& ep) { QCC_UNUSED(ep); }
+    QStatus UntrustedClientStart() { return ER_OK; }
+};
+
+/*
+ * Runs the blocking client side of the handshake.
+ */
+class ClientThread : public Thread {
+  public:
+    ClientThread(TestAuthEndpoint& ep) : Thread("ClientThread"), ep(ep), status(ER_FAIL) { }
+
+    TestAuthEndpoint ep;
+    QStatus status;
+    qcc::String authUsed;
+    qcc::String redirection;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        status = ep->Establish("ANONYMOUS", authUsed, redirection, NULL, 5000);
+        if (status == ER_BUS_ENDPOINT_REDIRECTED) {
+            /* Hang up like a transport would before following the redirection */
+            ep->stream.Close();
+        }
+        return 0;
+    }
+};
+
+class EndpointAuthTest : public testing::Test {
+  public:
+    EndpointAuthTest() :
+        serverBus("EndpointAuthTest", factories),
+        clientBus("EndpointAuthTestClient"),
+        fds(),
+        server(serverBus, INCOMING, fds.fd[0]),
+        client(clientBus, OUTGOING, fds.fd[1])
+    {
+    }
+
+    virtual void SetUp()
+    {
+        ASSERT_EQ(ER_OK, fds.status);
+        ASSERT_EQ(ER_OK, serverBus.Start());
+        ASSERT_EQ(ER_OK, clientBus.Start());
+        server->SetListener(&listener);
+    }
+
+    virtual void TearDown()
+    {
+        clientBus.Stop();
+        clientBus.Join();
+        serverBus.Stop();
+        serverBus.Join();
+    }
+
+    /*
+     * Feeds the server side of the handshake until it stops waiting for the
+     * client.
+     */
+    QStatus DriveServer(qcc::String& authUsed, qcc::String& redirection)
+    {
+        QStatus status = server->ContinueEstablish(authUsed, redirection);
+        while (status == ER_WOULDBLOCK) {
+            status = Event::Wait(server->stream.GetSourceEvent(), 5000);
+            if (status == ER_OK) {
+                status = server->ContinueEstablish(authUsed, redirection);
+            }
+        }
+        return status;
+    }
+
+    /*
+     * Sends raw bytes from the client end of the socket pair.
+     */
+    void SendRaw(const char* str)
+    {
+        size_t sent;
+        ASSERT_EQ(ER_OK, Send(fds.fd[1], str, strlen(str), sent));
+        ASSERT_EQ(strlen(str), sent);
+    }
+
+    /*
+     * Reads whatever the server has sent back to the client end.
+     */
+    qcc::String RecvRaw()
+    {
+        char buf[256];
+        size_t received = 0;
+        if (Recv(fds.fd[1], buf, sizeof(buf), received) != ER_OK) {
+            return qcc::String();
+        }
+        return qcc::String(buf, received);
+    }
+
+    struct SocketPairFds {
+        SocketPairFds() {
+            status = SocketPair(fd);
+            if (status == ER_OK) {
+                SetBlocking(fd[0], false);
+                SetBlocking(fd[1], false);
+            }
+        }
+        SocketFd fd[2];
+        QStatus status;
+    };
+
+    TransportFactoryContainer factories;
+    Bus serverBus;
+    BusAttachment clientBus;
+    SocketPairFds fds;
+    TestAuthEndpoint server;
+    TestAuthEndpoint client;
+    TestEndpointListener listener;
+};
+
+TEST_F(EndpointAuthTest, Established)
+{
+    ASSERT_EQ(ER_OK, server->BeginEstablish("ANONYMOUS", NULL, 5000));
+
+    ClientThread thread(client);
+    ASSERT_EQ(ER_OK, thread.Start());
+    qcc::String authUsed;
+    qcc::String redirection;
+    EXPECT_EQ(ER_OK, DriveServer(authUsed, redirection));
+    thread.Join();
+
+    EXPECT_EQ(ER_OK, thread.status);
+    EXPECT_STREQ("ANONYMOUS", authUsed.c_str());
+    EXPECT_TRUE(redirection.empty());
+    EXPECT_FALSE(server->GetRemoteName().empty());
+    EXPECT_EQ(server->GetRemoteName(), client->GetUniqueName());
+    EXPECT_EQ(static_cast<uint32_t>(Event::WAIT_FOREVER), server->GetEstablishTimeRemaining());
+    EXPECT_EQ(ER_BUS_NO_ENDPOINT, server->ContinueEstablish(authUsed, redirection));
+}
+
+TEST_F(EndpointAuthTest, PartialSaslLines)
+{
+    ASSERT_EQ(ER_OK, server->BeginEstablish("ANONYMOUS", NULL, 5000));
+    qcc::String authUsed;
+    qcc::String redirection;
+
+    /* Nothing is answered until the line is complete */
+    SendRaw("AUTH ANONY");
+    EXPECT_EQ(ER_WOULDBLOCK, server->ContinueEstablish(authUsed, redirection));
+    EXPECT_TRUE(RecvRaw().empty());
+
+    SendRaw("MOUS\r\n");
+    EXPECT_EQ(ER_WOULDBLOCK, server->ContinueEstablish(authUsed, redirection));
+    qcc::String reply = RecvRaw();
+    EXPECT_EQ(0U, reply.find("OK ")) << reply.c_str();
+
+    /* A complete line and the start of the next one in the same read */
+    SendRaw("BEGIN\r\nxyz");
+    EXPECT_EQ(ER_WOULDBLOCK, server->ContinueEstablish(authUsed, redirection));
+    EXPECT_EQ(_BusEndpoint::ENDPOINT_FLOW_HELLO, server->GetFlowType());
+}
+
+TEST_F(EndpointAuthTest, AbortDuringHello)
+{
+    int32_t refs = server.GetRefCount();
+    ASSERT_EQ(ER_OK, server->BeginEstablish("ANONYMOUS", NULL, 5000));
+    EXPECT_LT(refs, server.GetRefCount());
+
+    qcc::String authUsed;
+    qcc::String redirection;
+    SendRaw("AUTH ANONYMOUS\r\nBEGIN\r\n");
+    EXPECT_EQ(ER_WOULDBLOCK, server->ContinueEstablish(authUsed, redirection));
+    EXPECT_EQ(_BusEndpoint::ENDPOINT_FLOW_HELLO, server->GetFlowType());
+
+    /* Aborting drops the reference the handshake held on the endpoint */
+    server->AbortEstablish();
+    EXPECT_EQ(refs, server.GetRefCount());
+    EXPECT_EQ(_BusEndpoint::ENDPOINT_FLOW_MSGS, server->GetFlowType());
+    EXPECT_EQ(static_cast<uint32_t>(Event::WAIT_FOREVER), server->GetEstablishTimeRemaining());
+    EXPECT_EQ(ER_BUS_NO_ENDPOINT, server->ContinueEstablish(authUsed, redirection));
+}
+
+TEST_F(EndpointAuthTest, Timeout)
+{
+    int32_t refs = server.GetRefCount();
+    ASSERT_EQ(ER_OK, server->BeginEstablish("ANONYMOUS", NULL, 100));
+    uint32_t remaining = server->GetEstablishTimeRemaining();
+    EXPECT_GE(100U, remaining);
+    EXPECT_LT(0U, remaining);
+
+    /* A client that trickles in part of a line does not extend the deadline */
+    qcc::String authUsed;
+    qcc::String redirection;
+    SendRaw("AUTH");
+    EXPECT_EQ(ER_WOULDBLOCK, server->ContinueEstablish(authUsed, redirection));
+    EXPECT_GE(remaining, server->GetEstablishTimeRemaining());
+
+    qcc::Sleep(150);
+    EXPECT_EQ(0U, server->GetEstablishTimeRemaining());
+    EXPECT_EQ(ER_TIMEOUT, server->ContinueEstablish(authUsed, redirection));
+    EXPECT_EQ(refs, server.GetRefCount());
+    EXPECT_EQ(ER_BUS_NO_ENDPOINT, server->ContinueEstablish(authUsed, redirection));
+}
+
+TEST_F(EndpointAuthTest, Redirect)
+{
+    server->redirection = "tcp:addr=192.0.2.1,port=9955";
+    ASSERT_EQ(ER_OK, server->BeginEstablish("ANONYMOUS", NULL, 5000));
+
+    ClientThread thread(client);
+    ASSERT_EQ(ER_OK, thread.Start());
+    qcc::String authUsed;
+    qcc::String redirection;
+
+    /* The server only finishes once the client has hung up */
+    EXPECT_EQ(ER_BUS_ENDPOINT_REDIRECTED, DriveServer(authUsed, redirection));
+    EXPECT_EQ(server->redirection, redirection);
+    thread.Join();
+    EXPECT_EQ(ER_BUS_ENDPOINT_REDIRECTED, thread.status);
+    EXPECT_EQ(server->redirection, thread.redirection);
+}
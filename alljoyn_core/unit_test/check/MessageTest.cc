@@ -17,6 +17,9 @@
 
 #include <alljoyn/Message.h>
 
+#include "BusInternal.h"
+#include "HeaderTemplateCache.h"
+
 /* Header files included for Google Test Framework */
 #include <gtest/gtest.h>
 #include "../ajTestCommon.h"
@@ -27,7 +30,9 @@ using namespace ajn;
 
 class _TestMessage : public _Message {
   public:
+    _TestMessage(BusAttachment& bus) : _Message(bus) { }
     _TestMessage(BusAttachment& bus, const HeaderFields& hdrFields) : _Message(bus, hdrFields) { }
+    using _Message::CallMsg;
 };
 typedef ManagedObj<_TestMessage> TestMessage;
 
@@ -51,3 +56,108 @@ TEST(MessageTest, GetNullHeaderFieldsReturnsEmptyString)
     EXPECT_STREQ("", msg->GetSender());
     EXPECT_STREQ("", msg->GetDestination());
 }
+
+TEST(MessageTest, RepeatedCallsReuseHeaderFields)
+{
+    BusAttachment bus(NULL);
+    HeaderTemplateCache& cache = bus.GetInternal().GetHeaderTemplateCache();
+    qcc::String sender = ":sender.2";
+    qcc::String destination = ":destination.2";
+    static const int member = 0;
+    MsgArg arg("s", "first");
+    uint32_t hits;
+    uint32_t misses;
+
+    TestMessage first(bus);
+    ASSERT_EQ(ER_OK, first->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &member));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(0U, hits);
+    EXPECT_EQ(1U, misses);
+
+    /* The second call is served from the template without building the header fields */
+    arg.Set("s", "second");
+    TestMessage second(bus);
+    ASSERT_EQ(ER_OK, second->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &member));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1U, hits);
+    EXPECT_EQ(1U, misses);
+    EXPECT_STREQ("/test", second->GetObjectPath());
+    EXPECT_STREQ("org.test", second->GetInterface());
+    EXPECT_STREQ("Method", second->GetMemberName());
+    EXPECT_STREQ(":sender.2", second->GetSender());
+    EXPECT_STREQ(":destination.2", second->GetDestination());
+    EXPECT_STREQ("s", second->GetSignature());
+    EXPECT_EQ(0U, second->GetSessionId());
+    /* The fields must point into the second message, not the first or the caller's strings */
+    EXPECT_NE(first->GetObjectPath(), second->GetObjectPath());
+    EXPECT_NE(destination.c_str(), second->GetDestination());
+    EXPECT_NE(first->GetCallSerial(), second->GetCallSerial());
+
+    /* A different session id needs different header fields */
+    TestMessage third(bus);
+    ASSERT_EQ(ER_OK, third->CallMsg("s", sender, destination, 1234, "/test", "org.test", "Method", &arg, 1, 0, NULL, &member));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1U, hits);
+    EXPECT_EQ(2U, misses);
+    EXPECT_EQ(1234U, third->GetSessionId());
+    EXPECT_STREQ("/test", third->GetObjectPath());
+
+    TestMessage fourth(bus);
+    ASSERT_EQ(ER_OK, fourth->CallMsg("s", sender, destination, 1234, "/test", "org.test", "Method", &arg, 1, 0, NULL, &member));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(2U, hits);
+    EXPECT_EQ(1234U, fourth->GetSessionId());
+
+    /* A different member at the same key is not served from the template */
+    TestMessage fifth(bus);
+    ASSERT_EQ(ER_OK, fifth->CallMsg("s", sender, destination, 0, "/test", "org.test", "Other", &arg, 1, 0, NULL, &member));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(2U, hits);
+    EXPECT_EQ(3U, misses);
+    EXPECT_STREQ("Other", fifth->GetMemberName());
+
+    /* Without a key the cache is not used */
+    TestMessage sixth(bus);
+    ASSERT_EQ(ER_OK, sixth->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(2U, hits);
+    EXPECT_EQ(3U, misses);
+}
+
+TEST(MessageTest, HeaderTemplatesReplaceLeastRecentlyUsed)
+{
+    BusAttachment bus(NULL);
+    HeaderTemplateCache& cache = bus.GetInternal().GetHeaderTemplateCache();
+    qcc::String sender = ":sender.2";
+    qcc::String destination = ":destination.2";
+    static int members[HeaderTemplateCache::MAX_TEMPLATES + 1];
+    MsgArg arg("s", "arg");
+    uint32_t hits;
+    uint32_t misses;
+
+    for (size_t i = 0; i < HeaderTemplateCache::MAX_TEMPLATES; ++i) {
+        TestMessage msg(bus);
+        ASSERT_EQ(ER_OK, msg->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &members[i]));
+    }
+
+    /* Use the template with the lowest key so it is no longer the oldest */
+    TestMessage used(bus);
+    ASSERT_EQ(ER_OK, used->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &members[0]));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(1U, hits);
+
+    /* A full cache replaces the template that was used longest ago */
+    TestMessage added(bus);
+    ASSERT_EQ(ER_OK, added->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &members[HeaderTemplateCache::MAX_TEMPLATES]));
+
+    TestMessage kept(bus);
+    ASSERT_EQ(ER_OK, kept->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &members[0]));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(2U, hits);
+
+    TestMessage replaced(bus);
+    ASSERT_EQ(ER_OK, replaced->CallMsg("s", sender, destination, 0, "/test", "org.test", "Method", &arg, 1, 0, NULL, &members[1]));
+    cache.GetStats(hits, misses);
+    EXPECT_EQ(2U, hits);
+    EXPECT_EQ(HeaderTemplateCache::MAX_TEMPLATES + 2, misses);
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Thread.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/BusObject.h>
+
+#include "MethodTable.h"
+#include "SignalTable.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/* Interface names made of the same characters in a different order */
+static const char* ifaceNames[] = { "org.test.ab", "org.test.ba" };
+
+class MethodTableTestObject : public BusObject {
+  public:
+    MethodTableTestObject(BusAttachment& bus, const char* path) : BusObject(path)
+    {
+        for (size_t i = 0; i < ArraySize(ifaceNames); ++i) {
+            const InterfaceDescription* iface = bus.GetInterface(ifaceNames[i]);
+            AddInterface(*iface);
+            AddMethodHandler(iface->GetMember("Method"), static_cast<MessageReceiver::MethodHandler>(&MethodTableTestObject::Handler));
+        }
+    }
+
+    void Handler(const InterfaceDescription::Member* member, Message& msg)
+    {
+        QCC_UNUSED(member);
+        QCC_UNUSED(msg);
+    }
+};
+
+class MethodTableTest : public testing::Test {
+  public:
+    MethodTableTest() : bus("MethodTableTest") { }
+
+    virtual void SetUp()
+    {
+        for (size_t i = 0; i < ArraySize(ifaceNames); ++i) {
+            InterfaceDescription* iface = NULL;
+            ASSERT_EQ(ER_OK, bus.CreateInterface(ifaceNames[i], iface));
+            ASSERT_EQ(ER_OK, iface->AddMethod("Method", NULL, NULL, NULL));
+            iface->Activate();
+        }
+    }
+
+    BusAttachment bus;
+};
+
+TEST_F(MethodTableTest, PermutedInterfaceNamesHashApart)
+{
+    MethodTableTestObject object(bus, "/test");
+    MethodTable table;
+    table.AddAll(&object);
+
+    for (size_t i = 0; i < ArraySize(ifaceNames); ++i) {
+        MethodTable::SafeEntry found;
+        ASSERT_TRUE(table.Find("/test", ifaceNames[i], "Method", found));
+        EXPECT_STREQ(ifaceNames[i], found.entry->member->iface->GetName());
+    }
+    /* Method calls without an interface find the first interface added */
+    MethodTable::SafeEntry found;
+    ASSERT_TRUE(table.Find("/test", NULL, "Method", found));
+    EXPECT_EQ(&object, found.entry->object);
+
+    MethodTable::SafeEntry missing;
+    EXPECT_FALSE(table.Find("/other", ifaceNames[0], "Method", missing));
+    EXPECT_TRUE(missing.entry == NULL);
+}
+
+TEST_F(MethodTableTest, RemoveAllHidesEntries)
+{
+    MethodTableTestObject object(bus, "/test");
+    MethodTable table;
+    table.AddAll(&object);
+    table.RemoveAll(&object);
+
+    MethodTable::SafeEntry found;
+    EXPECT_FALSE(table.Find("/test", ifaceNames[0], "Method", found));
+    EXPECT_FALSE(table.Find("/test", NULL, "Method", found));
+}
+
+class MethodTableReader : public Thread {
+  public:
+    MethodTableReader(MethodTable& table) : Thread("MethodTableReader"), table(table), lookups(0) { }
+
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        while (!IsStopping()) {
+            MethodTable::SafeEntry found;
+            if (table.Find("/test", ifaceNames[lookups % ArraySize(ifaceNames)], "Method", found)) {
+                QCC_ASSERT(found.entry->object != NULL);
+            }
+            ++lookups;
+        }
+        return 0;
+    }
+
+    MethodTable& table;
+    volatile uint32_t lookups;
+};
+
+TEST_F(MethodTableTest, FindWhileTableChanges)
+{
+    MethodTableTestObject object(bus, "/test");
+    MethodTable table;
+    MethodTableReader reader(table);
+    ASSERT_EQ(ER_OK, reader.Start());
+    while (reader.lookups == 0) {
+        qcc::Sleep(1);
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        table.AddAll(&object);
+        table.RemoveAll(&object);
+        if ((i % 20) == 0) {
+            /* Let the reader run between changes on a single core */
+            qcc::Sleep(1);
+        }
+    }
+    table.AddAll(&object);
+    reader.Stop();
+    reader.Join();
+
+    MethodTable::SafeEntry found;
+    EXPECT_TRUE(table.Find("/test", ifaceNames[1], "Method", found));
+}
+
+class SignalTableTestReceiver : public MessageReceiver {
+  public:
+    void Handler(const InterfaceDescription::Member* member, const char* srcPath, Message& msg)
+    {
+        QCC_UNUSED(member);
+        QCC_UNUSED(srcPath);
+        QCC_UNUSED(msg);
+    }
+};
+
+TEST_F(MethodTableTest, SignalRangeOutlivesRemoval)
+{
+    InterfaceDescription* iface = NULL;
+    ASSERT_EQ(ER_OK, bus.CreateInterface("org.test.signal", iface));
+    ASSERT_EQ(ER_OK, iface->AddSignal("Signal", NULL, NULL));
+    iface->Activate();
+    const InterfaceDescription::Member* member = iface->GetMember("Signal");
+
+    SignalTableTestReceiver receiver;
+    MessageReceiver::SignalHandler handler = static_cast<MessageReceiver::SignalHandler>(&SignalTableTestReceiver::Handler);
+    SignalTable table;
+    table.Add(&receiver, handler, member, "type='signal'");
+    table.Add(&receiver, handler, member, "type='signal',path='/a'");
+
+    SignalTable::SafeRange range;
+    table.Find("org.test.signal", "Signal", range);
+    ASSERT_FALSE(range.empty());
+
+    /* The pinned range is unaffected by changes made while it is held */
+    table.RemoveAll(&receiver);
+    size_t count = 0;
+    for (SignalTable::const_iterator it = range.begin(); it != range.end(); ++it) {
+        EXPECT_EQ(&receiver, it->second.object);
+        ++count;
+    }
+    EXPECT_EQ(2U, count);
+
+    SignalTable::SafeRange after;
+    table.Find("org.test.signal", "Signal", after);
+    EXPECT_TRUE(after.empty());
+}
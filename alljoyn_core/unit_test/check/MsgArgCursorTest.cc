@@ -0,0 +1,239 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Util.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Message.h>
+#include "MsgArgCursor.h"
+#include "Rule.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+class _MsgArgCursorTestMessage : public _Message {
+  public:
+    _MsgArgCursorTestMessage(BusAttachment& bus) : _Message(bus) { }
+    using _Message::CallMsg;
+};
+typedef ManagedObj<_MsgArgCursorTestMessage> MsgArgCursorTestMessage;
+
+static const char* sender = ":sender.4";
+static const char* destination = ":destination.4";
+
+class MsgArgCursorTest : public testing::Test {
+  public:
+    MsgArgCursorTest() : bus(NULL) { }
+
+    virtual void TearDown()
+    {
+        /* Restore native endianess */
+        _Message::SetEndianess(0);
+    }
+
+    /* Compose an org.alljoyn.About.Announce style message */
+    Message Announce(const char* iface, const char* member)
+    {
+        const char* intfs0[] = { "org.test.A", "org.test.B" };
+        const char* intfs1[] = { "org.test.C" };
+        MsgArg objects[2];
+        objects[0].Set("(oas)", "/a", ArraySize(intfs0), intfs0);
+        objects[1].Set("(oas)", "/b/c", ArraySize(intfs1), intfs1);
+        MsgArg entries[2];
+        entries[0].Set("{sv}", "AppName", new MsgArg("s", "cursor"));
+        entries[1].Set("{sv}", "Number", new MsgArg("t", 0x1122334455667788ULL));
+        entries[0].SetOwnershipFlags(MsgArg::OwnsArgs, true);
+        entries[1].SetOwnershipFlags(MsgArg::OwnsArgs, true);
+        MsgArg args[4];
+        args[0].Set("q", 1);
+        args[1].Set("q", 2);
+        args[2].Set("a(oas)", ArraySize(objects), objects);
+        args[3].Set("a{sv}", ArraySize(entries), entries);
+        MsgArgCursorTestMessage msg(bus);
+        EXPECT_EQ(ER_OK, msg->CallMsg("qqa(oas)a{sv}", sender, destination, 0, "/About", iface, member, args, ArraySize(args), 0));
+        return Message::cast(msg);
+    }
+
+    void ReadArgs()
+    {
+        const uint8_t bytes[] = { 1, 2, 3 };
+        MsgArg args[5];
+        args[0].Set("y", 7);
+        args[1].Set("ay", ArraySize(bytes), bytes);
+        args[2].Set("s", "skipped over");
+        args[3].Set("(bnd)", true, -3, 1.5);
+        args[4].Set("u", 0xDEADBEEF);
+        MsgArgCursorTestMessage msg(bus);
+        ASSERT_EQ(ER_OK, msg->CallMsg("yays(bnd)u", sender, destination, 0, "/test", "org.test", "Method", args, ArraySize(args), 0));
+        Message message = Message::cast(msg);
+
+        MsgArgCursor cursor(message);
+        ASSERT_EQ(ER_OK, cursor.GetStatus());
+        MsgArg arg;
+
+        /* Jump straight to the last argument */
+        ASSERT_EQ(ER_OK, cursor.Seek(4));
+        EXPECT_EQ(ALLJOYN_UINT32, cursor.GetTypeId());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_EQ(0xDEADBEEF, arg.v_uint32);
+        EXPECT_TRUE(cursor.AtEnd());
+        EXPECT_EQ(ALLJOYN_INVALID, cursor.GetTypeId());
+
+        ASSERT_EQ(ER_OK, cursor.Seek(2));
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_STREQ("skipped over", arg.v_string.str);
+
+        /* Containers must be entered */
+        EXPECT_EQ(ALLJOYN_STRUCT, cursor.GetTypeId());
+        EXPECT_EQ(ER_BUS_BAD_VALUE_TYPE, cursor.Get(arg));
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_TRUE(arg.v_bool);
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_EQ(-3, arg.v_int16);
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_EQ(1.5, arg.v_double);
+        EXPECT_TRUE(cursor.AtEnd());
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_EQ(0xDEADBEEF, arg.v_uint32);
+
+        ASSERT_EQ(ER_OK, cursor.Seek(1));
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        for (size_t i = 0; i < ArraySize(bytes); ++i) {
+            ASSERT_EQ(ER_OK, cursor.Get(arg));
+            EXPECT_EQ(bytes[i], arg.v_byte);
+        }
+        EXPECT_TRUE(cursor.AtEnd());
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_STREQ("skipped over", arg.v_string.str);
+
+        EXPECT_EQ(ER_BUS_SIGNATURE_MISMATCH, cursor.Seek(5));
+
+        /* The message was never unmarshaled */
+        EXPECT_TRUE(message->GetArg(0) == NULL);
+    }
+
+    void ReadAnnounce()
+    {
+        Message message = Announce("org.alljoyn.About", "Announce");
+        MsgArgCursor cursor(message);
+        MsgArg arg;
+
+        /* Walk the object descriptions */
+        ASSERT_EQ(ER_OK, cursor.Seek(2));
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_STREQ("/a", arg.v_string.str);
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_STREQ("org.test.A", arg.v_string.str);
+        /* Leave the interface array and its struct early */
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        EXPECT_EQ(ALLJOYN_STRUCT, cursor.GetTypeId());
+        ASSERT_EQ(ER_OK, cursor.Skip());
+        EXPECT_TRUE(cursor.AtEnd());
+        ASSERT_EQ(ER_OK, cursor.Exit());
+
+        /* Look inside the variants of the dictionary */
+        EXPECT_EQ(ALLJOYN_ARRAY, cursor.GetTypeId());
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Skip());
+        EXPECT_EQ(ALLJOYN_DICT_ENTRY, cursor.GetTypeId());
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_STREQ("Number", arg.v_string.str);
+        EXPECT_EQ(ALLJOYN_VARIANT, cursor.GetTypeId());
+        ASSERT_EQ(ER_OK, cursor.Enter());
+        ASSERT_EQ(ER_OK, cursor.Get(arg));
+        EXPECT_EQ(0x1122334455667788ULL, arg.v_uint64);
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        EXPECT_TRUE(cursor.AtEnd());
+        ASSERT_EQ(ER_OK, cursor.Exit());
+        EXPECT_TRUE(cursor.AtEnd());
+        EXPECT_EQ(ER_BUS_NO_SUCH_OBJECT, cursor.Exit());
+    }
+
+    BusAttachment bus;
+};
+
+TEST_F(MsgArgCursorTest, ReadsSelectedArgs)
+{
+    ReadArgs();
+}
+
+TEST_F(MsgArgCursorTest, ReadsSelectedArgsInOtherEndianess)
+{
+    _Message::SetEndianess(ALLJOYN_LITTLE_ENDIAN);
+    ReadArgs();
+    _Message::SetEndianess(ALLJOYN_BIG_ENDIAN);
+    ReadArgs();
+}
+
+TEST_F(MsgArgCursorTest, ReadsNestedContainers)
+{
+    _Message::SetEndianess(ALLJOYN_LITTLE_ENDIAN);
+    ReadAnnounce();
+    _Message::SetEndianess(ALLJOYN_BIG_ENDIAN);
+    ReadAnnounce();
+}
+
+TEST_F(MsgArgCursorTest, EmptyBody)
+{
+    MsgArgCursorTestMessage msg(bus);
+    ASSERT_EQ(ER_OK, msg->CallMsg("", sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0));
+    MsgArgCursor cursor(Message::cast(msg));
+    ASSERT_EQ(ER_OK, cursor.GetStatus());
+    EXPECT_TRUE(cursor.AtEnd());
+    EXPECT_EQ(ER_BUS_SIGNATURE_MISMATCH, cursor.Seek(0));
+    MsgArg arg;
+    EXPECT_EQ(ER_BUS_NO_SUCH_OBJECT, cursor.Get(arg));
+}
+
+TEST_F(MsgArgCursorTest, RuleMatchesWithoutUnmarshaling)
+{
+    const char* args[] = { "zero", "one" };
+    MsgArg arg("as", ArraySize(args), args);
+    MsgArgCursorTestMessage msg(bus);
+    MsgArg msgArgs[3];
+    msgArgs[0].Set("s", "first");
+    msgArgs[1] = arg;
+    msgArgs[2].Set("s", "third");
+    ASSERT_EQ(ER_OK, msg->CallMsg("sass", sender, destination, 0, "/test", "org.test", "Method", msgArgs, ArraySize(msgArgs), 0));
+    Message message = Message::cast(msg);
+
+    EXPECT_TRUE(Rule("arg0='first',arg2='third'").IsMatch(message));
+    EXPECT_FALSE(Rule("arg2='first'").IsMatch(message));
+    /* Only string arguments can match */
+    EXPECT_FALSE(Rule("arg1='zero'").IsMatch(message));
+    EXPECT_TRUE(message->GetArg(0) == NULL);
+
+    Message announce = Announce("org.alljoyn.About", "Announce");
+    EXPECT_TRUE(Rule("implements='org.test.A',implements='org.test.C'").IsMatch(announce));
+    EXPECT_TRUE(Rule("implements='org.test.*'").IsMatch(announce));
+    EXPECT_FALSE(Rule("implements='org.test.D'").IsMatch(announce));
+    EXPECT_FALSE(Rule("implements='org.test.A'").IsMatch(Announce("org.test", "Announce")));
+    EXPECT_TRUE(announce->GetArg(0) == NULL);
+}
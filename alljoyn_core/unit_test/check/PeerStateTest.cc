@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include "PeerState.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace qcc;
+using namespace ajn;
+
+TEST(PeerStateTest, CachedAuthorization)
+{
+    PeerState peer;
+    bool authorized = false;
+    uint32_t clears;
+    EXPECT_FALSE(peer->GetCachedAuthorization(1, "request", authorized, clears));
+    peer->CacheAuthorization(1, clears, "request", true);
+    EXPECT_TRUE(peer->GetCachedAuthorization(1, "request", authorized, clears));
+    EXPECT_TRUE(authorized);
+
+    /* Decisions made under another policy do not apply */
+    EXPECT_FALSE(peer->GetCachedAuthorization(2, "request", authorized, clears));
+
+    peer->ClearAuthorizationCache();
+    EXPECT_FALSE(peer->GetCachedAuthorization(1, "request", authorized, clears));
+}
+
+TEST(PeerStateTest, ClearDuringAuthorizationDropsDecision)
+{
+    PeerState peer;
+    bool authorized = false;
+    uint32_t clears;
+    EXPECT_FALSE(peer->GetCachedAuthorization(1, "request", authorized, clears));
+
+    /* The keys change while the decision is being made */
+    peer->ClearAuthorizationCache();
+    peer->CacheAuthorization(1, clears, "request", true);
+    EXPECT_FALSE(peer->GetCachedAuthorization(1, "request", authorized, clears));
+
+    /* A decision made after the clear is kept */
+    peer->CacheAuthorization(1, clears, "request", false);
+    EXPECT_TRUE(peer->GetCachedAuthorization(1, "request", authorized, clears));
+    EXPECT_FALSE(authorized);
+}
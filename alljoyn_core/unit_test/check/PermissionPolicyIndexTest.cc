@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Util.h>
+
+#include <vector>
+
+#include <alljoyn/PermissionPolicy.h>
+#include "PermissionPolicyIndex.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/* Interface names of the rules in the order they appear in the ACL */
+static const char* interfaces[] = {
+    "org.test.A",       /* 0 */
+    "org.test.*",       /* 1 */
+    "*",                /* 2 */
+    "org.test.A?",      /* 3 */
+    "",                 /* 4: never matches */
+    "org.test.A",       /* 5: no members, never matches */
+    "org.other",        /* 6 */
+    "org.test.A*"       /* 7 */
+};
+
+static void BuildPolicy(PermissionPolicy& policy)
+{
+    PermissionPolicy::Rule rules[ArraySize(interfaces)];
+    for (size_t i = 0; i < ArraySize(interfaces); ++i) {
+        rules[i].SetObjPath("*");
+        rules[i].SetInterfaceName(interfaces[i]);
+        if (i != 5) {
+            PermissionPolicy::Rule::Member member;
+            member.Set("*", PermissionPolicy::Rule::Member::NOT_SPECIFIED, PermissionPolicy::Rule::Member::ACTION_PROVIDE);
+            rules[i].SetMembers(1, &member);
+        }
+    }
+    PermissionPolicy::Acl acls[2];
+    acls[0].SetRules(ArraySize(rules), rules);
+    acls[1].SetRules(1, &rules[6]);
+    policy.SetAcls(ArraySize(acls), acls);
+}
+
+static vector<size_t> Candidates(const PermissionPolicyIndex& index, size_t acl, const char* iName)
+{
+    return index.GetCandidateRules(acl, iName);
+}
+
+TEST(PermissionPolicyIndexTest, CandidateRules)
+{
+    PermissionPolicy policy;
+    BuildPolicy(policy);
+    PermissionPolicyIndex index(policy);
+
+    const size_t exact[] = { 0, 1, 2, 3, 7 };
+    EXPECT_EQ(vector<size_t>(exact, exact + ArraySize(exact)), Candidates(index, 0, "org.test.A"));
+
+    const size_t longer[] = { 1, 2, 3, 7 };
+    EXPECT_EQ(vector<size_t>(longer, longer + ArraySize(longer)), Candidates(index, 0, "org.test.AB"));
+
+    const size_t sibling[] = { 1, 2 };
+    EXPECT_EQ(vector<size_t>(sibling, sibling + ArraySize(sibling)), Candidates(index, 0, "org.test.B"));
+
+    const size_t other[] = { 2, 6 };
+    EXPECT_EQ(vector<size_t>(other, other + ArraySize(other)), Candidates(index, 0, "org.other"));
+
+    const size_t unrelated[] = { 2 };
+    EXPECT_EQ(vector<size_t>(unrelated, unrelated + ArraySize(unrelated)), Candidates(index, 0, "net.test"));
+
+    /* Each ACL has its own index */
+    const size_t second[] = { 0 };
+    EXPECT_EQ(vector<size_t>(second, second + ArraySize(second)), Candidates(index, 1, "org.other"));
+    EXPECT_TRUE(Candidates(index, 1, "org.test.A").empty());
+    EXPECT_TRUE(Candidates(index, 2, "org.test.A").empty());
+}
+
+TEST(PermissionPolicyIndexTest, CandidatesKeptWithIndex)
+{
+    PermissionPolicy policy;
+    BuildPolicy(policy);
+    PermissionPolicyIndex index(policy);
+
+    /* Lookups hand out the lists built with the index instead of new ones */
+    EXPECT_EQ(&index.GetCandidateRules(0, "org.test.A"), &index.GetCandidateRules(0, "org.test.A"));
+    EXPECT_EQ(&index.GetCandidateRules(0, "org.test.AB"), &index.GetCandidateRules(0, "org.test.AC"));
+    EXPECT_EQ(&index.GetCandidateRules(0, "net.test"), &index.GetCandidateRules(0, "com.test"));
+    EXPECT_NE(&index.GetCandidateRules(0, "org.test.A"), &index.GetCandidateRules(0, "org.test.AB"));
+}
+
+TEST(PermissionPolicyIndexTest, EmptyPolicy)
+{
+    PermissionPolicy policy;
+    PermissionPolicyIndex index(policy);
+    EXPECT_TRUE(Candidates(index, 0, "org.test.A").empty());
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <map>
+
+#include <qcc/String.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Message.h>
+
+#include "BusEndpoint.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+#ifdef ENABLE_POLICYDB
+
+#include "PolicyDB.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+static const char* TEST_IFACE = "org.allseen.PolicyDBTest";
+static const char* TEST_PROTECTED = "org.allseen.PolicyDBTest.Protected";
+
+/*
+ * An endpoint with a unique name and user and group IDs, which is all the
+ * policy looks at.
+ */
+class _TestPolicyEndpoint : public _BusEndpoint {
+  public:
+    _TestPolicyEndpoint(const String& name, uint32_t uid, uint32_t gid) : _BusEndpoint(ENDPOINT_TYPE_REMOTE), name(name)
+    {
+        SetUserId(uid);
+        SetGroupId(gid);
+    }
+    const String& GetUniqueName() const { return name; }
+
+  private:
+    String name;
+};
+typedef ManagedObj<_TestPolicyEndpoint> TestPolicyEndpoint;
+
+/*
+ * A broadcast signal, which is what gets checked against many destinations.
+ */
+class _TestPolicyMessage : public _Message {
+  public:
+    _TestPolicyMessage(BusAttachment& bus, const String& sender, const String& member) : _Message(bus)
+    {
+        SignalMsg("", sender, NULL, 0, "/test", TEST_IFACE, member, NULL, 0, 0, 0);
+    }
+};
+
+class PolicyDBTest : public testing::Test {
+  public:
+    PolicyDBTest() : bus("PolicyDBTest") { }
+
+    void AddRule(const char* perm, const char* attr1, const char* val1, const char* attr2, const char* val2)
+    {
+        map<String, String> attrs;
+        attrs[attr1] = val1;
+        attrs[attr2] = val2;
+        ASSERT_TRUE(policy->AddRule("context", "mandatory", perm, attrs));
+    }
+
+    Message Signal(const char* member)
+    {
+        ManagedObj<_TestPolicyMessage> msg(bus, ":1.1", member);
+        return Message::cast(msg);
+    }
+
+    BusEndpoint Endpoint(const char* name, uint32_t uid, uint32_t gid)
+    {
+        String unique(name);
+        policy->NameOwnerChanged(unique, NULL, SessionOpts::ALL_NAMES, &unique, SessionOpts::ALL_NAMES);
+        TestPolicyEndpoint ep(unique, uid, gid);
+        return BusEndpoint::cast(ep);
+    }
+
+    BusAttachment bus;
+    PolicyDB policy;
+};
+
+TEST_F(PolicyDBTest, VerdictsCachedByUserAndGroup)
+{
+    AddRule("deny", "send_member", "Blocked", "send_same_user", "false");
+    AddRule("deny", "receive_member", "Blocked", "receive_same_user", "false");
+    policy->Finalize(NULL);
+
+    BusEndpoint sender = Endpoint(":1.1", 1000, 1000);
+    BusEndpoint same1 = Endpoint(":1.2", 1000, 1000);
+    BusEndpoint same2 = Endpoint(":1.3", 1000, 1000);
+    BusEndpoint other = Endpoint(":1.4", 2000, 1000);
+
+    Message msg = Signal("Blocked");
+    NormalizedMsgHdr nmh(msg, policy, sender);
+    EXPECT_FALSE(nmh.SendNeedsDestName());
+
+    /* Destinations with the same user and group share a verdict */
+    EXPECT_TRUE(policy->OKToSend(nmh, same1));
+    EXPECT_EQ(1U, nmh.CachedSendVerdicts());
+    EXPECT_TRUE(policy->OKToSend(nmh, same2));
+    EXPECT_EQ(1U, nmh.CachedSendVerdicts());
+    EXPECT_FALSE(policy->OKToSend(nmh, other));
+    EXPECT_EQ(2U, nmh.CachedSendVerdicts());
+    EXPECT_FALSE(policy->OKToSend(nmh, other));
+    EXPECT_TRUE(policy->OKToSend(nmh, same1));
+
+    EXPECT_TRUE(policy->OKToReceive(nmh, same1));
+    EXPECT_TRUE(policy->OKToReceive(nmh, same2));
+    EXPECT_EQ(1U, nmh.CachedReceiveVerdicts());
+    EXPECT_FALSE(policy->OKToReceive(nmh, other));
+    EXPECT_EQ(2U, nmh.CachedReceiveVerdicts());
+    EXPECT_FALSE(policy->OKToReceive(nmh, other));
+
+    /* The cache lives with the message so another message starts afresh */
+    Message allowed = Signal("Allowed");
+    NormalizedMsgHdr nmh2(allowed, policy, sender);
+    EXPECT_EQ(0U, nmh2.CachedSendVerdicts());
+    EXPECT_TRUE(policy->OKToSend(nmh2, other));
+    EXPECT_TRUE(policy->OKToReceive(nmh2, other));
+}
+
+TEST_F(PolicyDBTest, DestinationRuleBypassesSendCache)
+{
+    AddRule("deny", "send_destination", TEST_PROTECTED, "send_member", "Blocked");
+    policy->Finalize(NULL);
+
+    BusEndpoint sender = Endpoint(":1.1", 1000, 1000);
+    BusEndpoint owner = Endpoint(":1.2", 1000, 1000);
+    BusEndpoint bystander = Endpoint(":1.3", 1000, 1000);
+    String protectedName(TEST_PROTECTED);
+    String ownerName(":1.2");
+    policy->NameOwnerChanged(protectedName, NULL, SessionOpts::ALL_NAMES, &ownerName, SessionOpts::ALL_NAMES);
+
+    Message msg = Signal("Blocked");
+    NormalizedMsgHdr nmh(msg, policy, sender);
+    EXPECT_TRUE(nmh.SendNeedsDestName());
+
+    /*
+     * Both destinations have the same user and group, so a cached verdict
+     * for one would be wrong for the other.
+     */
+    EXPECT_FALSE(policy->OKToSend(nmh, owner));
+    EXPECT_TRUE(policy->OKToSend(nmh, bystander));
+    EXPECT_FALSE(policy->OKToSend(nmh, owner));
+    EXPECT_EQ(0U, nmh.CachedSendVerdicts());
+
+    /* Receive rules never name the destination so they are still cached */
+    EXPECT_TRUE(policy->OKToReceive(nmh, owner));
+    EXPECT_TRUE(policy->OKToReceive(nmh, bystander));
+    EXPECT_EQ(1U, nmh.CachedReceiveVerdicts());
+
+    /* A destination rule that does not match the message leaves the cache on */
+    Message other = Signal("Allowed");
+    NormalizedMsgHdr nmh2(other, policy, sender);
+    EXPECT_FALSE(nmh2.SendNeedsDestName());
+    EXPECT_TRUE(policy->OKToSend(nmh2, owner));
+    EXPECT_TRUE(policy->OKToSend(nmh2, bystander));
+    EXPECT_EQ(1U, nmh2.CachedSendVerdicts());
+}
+
+#endif
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Util.h>
+
+#include <vector>
+
+#include "ScalarArrayUtils.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/* Large enough to exercise the vector loops and every length of remainder */
+static const size_t MAX_ELEMENTS = 100;
+
+/*
+ * Convert at an odd offset into the buffers so that neither the source nor
+ * the destination is aligned to the vector size.
+ */
+TEST(ScalarArrayUtilsTest, Swap)
+{
+    vector<uint16_t> in16(MAX_ELEMENTS + 1), out16(MAX_ELEMENTS + 1);
+    vector<uint32_t> in32(MAX_ELEMENTS + 1), out32(MAX_ELEMENTS + 1);
+    vector<uint64_t> in64(MAX_ELEMENTS + 1), out64(MAX_ELEMENTS + 1);
+    for (size_t i = 0; i <= MAX_ELEMENTS; ++i) {
+        in16[i] = (uint16_t)(0x0102 * (i + 1));
+        in32[i] = (uint32_t)(0x01020304 * (i + 1));
+        in64[i] = 0x0102030405060708ULL * (i + 1);
+    }
+    for (size_t num = 0; num < MAX_ELEMENTS; ++num) {
+        out16.assign(MAX_ELEMENTS + 1, 0xAAAA);
+        out32.assign(MAX_ELEMENTS + 1, 0xAAAAAAAA);
+        out64.assign(MAX_ELEMENTS + 1, 0xAAAAAAAAAAAAAAAAULL);
+        ScalarArrayUtils::Swap16(&out16[1], &in16[1], num);
+        ScalarArrayUtils::Swap32(&out32[1], &in32[1], num);
+        ScalarArrayUtils::Swap64(&out64[1], &in64[1], num);
+        for (size_t i = 1; i <= num; ++i) {
+            ASSERT_EQ(EndianSwap16(in16[i]), out16[i]) << "num " << num << " index " << i;
+            ASSERT_EQ(EndianSwap32(in32[i]), out32[i]) << "num " << num << " index " << i;
+            ASSERT_EQ(EndianSwap64(in64[i]), out64[i]) << "num " << num << " index " << i;
+        }
+        /* Nothing is written past the end */
+        EXPECT_EQ(0xAAAA, out16[0]);
+        if (num < MAX_ELEMENTS) {
+            EXPECT_EQ(0xAAAA, out16[num + 1]);
+            EXPECT_EQ(0xAAAAAAAA, out32[num + 1]);
+            EXPECT_EQ(0xAAAAAAAAAAAAAAAAULL, out64[num + 1]);
+        }
+    }
+}
+
+TEST(ScalarArrayUtilsTest, Booleans)
+{
+    bool in[MAX_ELEMENTS];
+    bool out[MAX_ELEMENTS];
+    uint32_t marshaled[MAX_ELEMENTS];
+    for (size_t i = 0; i < MAX_ELEMENTS; ++i) {
+        in[i] = (i % 3) == 0;
+    }
+    for (int swap = 0; swap < 2; ++swap) {
+        bool endianSwap = (swap != 0);
+        const uint32_t one = endianSwap ? EndianSwap32(1) : 1;
+        for (size_t num = 0; num < MAX_ELEMENTS; ++num) {
+            ScalarArrayUtils::MarshalBooleans(marshaled, in, num, endianSwap);
+            for (size_t i = 0; i < num; ++i) {
+                ASSERT_EQ(in[i] ? one : 0, marshaled[i]) << "num " << num << " index " << i;
+            }
+            memset(out, 0xFF, sizeof(out));
+            ASSERT_TRUE(ScalarArrayUtils::UnmarshalBooleans(out, marshaled, num, endianSwap));
+            for (size_t i = 0; i < num; ++i) {
+                ASSERT_EQ(in[i], out[i]) << "num " << num << " index " << i;
+            }
+        }
+    }
+}
+
+TEST(ScalarArrayUtilsTest, InvalidBooleans)
+{
+    uint32_t marshaled[MAX_ELEMENTS];
+    bool out[MAX_ELEMENTS];
+    const uint32_t invalid[] = { 2, 0x100, 0x10000, 0x80000000, 0xFFFFFFFF, 0x01000001 };
+    for (int swap = 0; swap < 2; ++swap) {
+        bool endianSwap = (swap != 0);
+        for (size_t v = 0; v < ArraySize(invalid); ++v) {
+            /* Put the bad value at every position including the remainder */
+            for (size_t pos = 0; pos < MAX_ELEMENTS; ++pos) {
+                for (size_t i = 0; i < MAX_ELEMENTS; ++i) {
+                    uint32_t b = i & 1;
+                    marshaled[i] = endianSwap ? EndianSwap32(b) : b;
+                }
+                marshaled[pos] = invalid[v];
+                EXPECT_FALSE(ScalarArrayUtils::UnmarshalBooleans(out, marshaled, MAX_ELEMENTS, endianSwap)) << "value " << invalid[v] << " at " << pos;
+            }
+        }
+    }
+    /* A 1 in the wrong endianess is not a boolean */
+    marshaled[0] = EndianSwap32(1);
+    EXPECT_FALSE(ScalarArrayUtils::UnmarshalBooleans(out, marshaled, 1, false));
+    marshaled[0] = 1;
+    EXPECT_FALSE(ScalarArrayUtils::UnmarshalBooleans(out, marshaled, 1, true));
+}
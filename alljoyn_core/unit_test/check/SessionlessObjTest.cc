@@ -14,6 +14,7 @@
  *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  ******************************************************************************/
 #include <qcc/platform.h>
+#include <qcc/Util.h>
 
 #include "SessionlessObj.h"
 
@@ -160,3 +161,177 @@ INSTANTIATE_TEST_CASE_P(SessionlessPendingWork,
                                            ::testing::Bool())); /* oldRuleMatchesInterface */
 
 #endif /* GTEST_HAS_COMBINE */
+
+TEST(SessionlessInterestFilterTest, MayMatch)
+{
+    SessionlessObj::InterestFilter filter;
+    filter.Add("org.alljoyn.About", "Announce");
+    filter.Add("org.test.Foo", "Bar");
+
+    EXPECT_TRUE(filter.MayMatch(Rule("type='signal'")));
+    EXPECT_TRUE(filter.MayMatch(Rule("interface='org.alljoyn.About'")));
+    EXPECT_TRUE(filter.MayMatch(Rule("member='Announce'")));
+    EXPECT_TRUE(filter.MayMatch(Rule("interface='org.alljoyn.About',member='Announce'")));
+    EXPECT_TRUE(filter.MayMatch(Rule("interface='org.test.Foo',member='Bar'")));
+
+    EXPECT_FALSE(filter.MayMatch(Rule("interface='org.test.Nothing'")));
+    EXPECT_FALSE(filter.MayMatch(Rule("member='Nothing'")));
+    EXPECT_FALSE(filter.MayMatch(Rule("interface='org.test.Foo',member='Nothing'")));
+}
+
+TEST(SessionlessInterestFilterTest, ToFromString)
+{
+    SessionlessObj::InterestFilter filter;
+    filter.Add("org.alljoyn.About", "Announce");
+    String str = filter.ToString();
+    EXPECT_EQ(SessionlessObj::InterestFilter::MIN_BITS / 4, str.size());
+
+    SessionlessObj::InterestFilter parsed;
+    EXPECT_EQ(ER_OK, parsed.FromString(str));
+    EXPECT_TRUE(filter == parsed);
+
+    EXPECT_EQ(ER_FAIL, parsed.FromString(str.substr(1)));
+    EXPECT_EQ(ER_FAIL, parsed.FromString("z" + str.substr(1)));
+    EXPECT_EQ(ER_FAIL, parsed.FromString(str.substr(8)));
+
+    /* The size of a larger filter is carried by the length of the string */
+    SessionlessObj::InterestFilter large(SessionlessObj::InterestFilter::MAX_BITS);
+    large.Add("org.alljoyn.About", "Announce");
+    str = large.ToString();
+    EXPECT_EQ(SessionlessObj::InterestFilter::MAX_BITS / 4, str.size());
+    EXPECT_EQ(ER_OK, parsed.FromString(str));
+    EXPECT_EQ(SessionlessObj::InterestFilter::MAX_BITS, parsed.GetNumBits());
+    EXPECT_TRUE(large == parsed);
+    EXPECT_TRUE(parsed.MayMatch(Rule("interface='org.alljoyn.About',member='Announce'")));
+    EXPECT_EQ(ER_FAIL, parsed.FromString(str + "00000000"));
+}
+
+TEST(SessionlessInterestFilterTest, SizedFromContents)
+{
+    EXPECT_EQ(SessionlessObj::InterestFilter::MIN_BITS, SessionlessObj::InterestFilter::NumBits(0));
+    EXPECT_EQ(SessionlessObj::InterestFilter::MAX_BITS, SessionlessObj::InterestFilter::NumBits(100000));
+    uint32_t numBits = SessionlessObj::InterestFilter::NumBits(70);
+    EXPECT_EQ(0U, numBits % 32);
+    EXPECT_LE(70 * SessionlessObj::InterestFilter::BITS_PER_KEY, numBits);
+
+    /* 10 interfaces of 3 signals each */
+    set<pair<String, String> > members;
+    for (uint32_t i = 0; i < 10; ++i) {
+        for (uint32_t j = 0; j < 3; ++j) {
+            members.insert(pair<String, String>("org.test.Interface" + U32ToString(i), "Signal" + U32ToString(i) + "_" + U32ToString(j)));
+        }
+    }
+    SessionlessObj::InterestFilter filter = SessionlessObj::InterestFilter::Create(members);
+    EXPECT_EQ(SessionlessObj::InterestFilter::NumBits(10 + 30 + 30), filter.GetNumBits());
+    for (set<pair<String, String> >::iterator it = members.begin(); it != members.end(); ++it) {
+        EXPECT_TRUE(filter.MayMatch(Rule(("interface='" + it->first + "',member='" + it->second + "'").c_str())));
+    }
+
+    /* Rules for names not in the filter rarely match */
+    const uint32_t numProbes = 2000;
+    uint32_t falsePositives = 0;
+    for (uint32_t i = 0; i < numProbes; ++i) {
+        if (filter.MayMatch(Rule(("interface='org.test.Other" + U32ToString(i) + "'").c_str()))) {
+            ++falsePositives;
+        }
+        if (filter.MayMatch(Rule(("member='Other" + U32ToString(i) + "'").c_str()))) {
+            ++falsePositives;
+        }
+    }
+    EXPECT_GT(2 * numProbes * 5 / 100, falsePositives);
+}
+
+TEST(SessionlessInterestFilterTest, PendingWork)
+{
+    SessionlessObj::TimestampedRules rules;
+    uint32_t nextRulesId = 0;
+    Rule rule("interface='org.alljoyn.About',member='Nothing'");
+    rules.insert(std::pair<String, SessionlessObj::TimestampedRule>
+                     (":test.2", SessionlessObj::TimestampedRule(rule, nextRulesId++)));
+
+    SessionlessObj::RemoteCache cache("org.alljoyn.sl.y2VZ0CWRc.x1", 1 /* version */, "2VZ0CWRc",
+                                      "org.alljoyn.About", 1 /* changeId */, TRANSPORT_UDP);
+    EXPECT_EQ(SessionlessObj::REQUEST_NEW_SIGNALS, SessionlessObj::PendingWork(cache, rules, nextRulesId));
+
+    /* A filter without the rule's member rules out the fetch */
+    cache.haveFilter = true;
+    cache.filter.Add("org.alljoyn.About", "Announce");
+    cache.filterChangeId = 1;
+    EXPECT_EQ(SessionlessObj::NONE, SessionlessObj::PendingWork(cache, rules, nextRulesId));
+
+    /* A stale filter is ignored */
+    cache.changeId = 2;
+    EXPECT_EQ(SessionlessObj::REQUEST_NEW_SIGNALS, SessionlessObj::PendingWork(cache, rules, nextRulesId));
+}
+
+static vector<uint32_t> ChangeIdsInRange(SessionlessObj::ChangeIdIndex& index, uint32_t fromChangeId, uint32_t toChangeId, bool erase = false)
+{
+    vector<uint32_t> ids;
+    SessionlessObj::ChangeIdIndex::const_iterator it = SessionlessObj::NextInRange(index, fromChangeId, toChangeId, NULL);
+    while (it != index.end()) {
+        SessionlessObj::ChangeIdIndex::value_type pos = *it;
+        ids.push_back(pos.first);
+        if (erase) {
+            index.erase(pos);
+        }
+        it = SessionlessObj::NextInRange(index, fromChangeId, toChangeId, &pos);
+    }
+    return ids;
+}
+
+class SessionlessChangeIdIndexTest : public testing::Test {
+  public:
+    virtual void SetUp()
+    {
+        const uint32_t changeIds[] = { 0, 1, 5, 100, 0xfffffff0, 0xffffffff };
+        for (size_t i = 0; i < ArraySize(changeIds); ++i) {
+            index.insert(make_pair(changeIds[i], SessionlessObj::SessionlessMessageKey(":sender.1", "org.test", "Signal", "/a")));
+        }
+        /* Two messages with the same change ID */
+        index.insert(make_pair(5U, SessionlessObj::SessionlessMessageKey(":sender.2", "org.test", "Signal", "/b")));
+    }
+
+    static vector<uint32_t> Ids(const uint32_t* ids, size_t n) { return vector<uint32_t>(ids, ids + n); }
+
+    SessionlessObj::ChangeIdIndex index;
+};
+
+TEST_F(SessionlessChangeIdIndexTest, Range)
+{
+    const uint32_t expected[] = { 1, 5, 5 };
+    EXPECT_EQ(Ids(expected, ArraySize(expected)), ChangeIdsInRange(index, 1, 100));
+    EXPECT_TRUE(ChangeIdsInRange(index, 5, 5).empty());
+    EXPECT_TRUE(ChangeIdsInRange(index, 6, 100).empty());
+    EXPECT_TRUE(ChangeIdsInRange(index, 101, 0xfffffff0).empty());
+}
+
+TEST_F(SessionlessChangeIdIndexTest, Wraparound)
+{
+    /* The top of the change ID space comes first */
+    const uint32_t expected[] = { 0xfffffff0, 0xffffffff, 0, 1 };
+    EXPECT_EQ(Ids(expected, ArraySize(expected)), ChangeIdsInRange(index, 0xfffffff0, 2));
+
+    const uint32_t top[] = { 0xffffffff };
+    EXPECT_EQ(Ids(top, ArraySize(top)), ChangeIdsInRange(index, 0xffffffff, 0));
+
+    /* Nothing in the first segment */
+    SessionlessObj::ChangeIdIndex low;
+    low.insert(make_pair(0U, SessionlessObj::SessionlessMessageKey(":sender.1", "org.test", "Signal", "/a")));
+    low.insert(make_pair(1U, SessionlessObj::SessionlessMessageKey(":sender.1", "org.test", "Signal", "/b")));
+    const uint32_t bottom[] = { 0, 1 };
+    EXPECT_EQ(Ids(bottom, ArraySize(bottom)), ChangeIdsInRange(low, 0xfffffff0, 6));
+
+    /* Nothing in the second segment, and no going around twice */
+    SessionlessObj::ChangeIdIndex high;
+    high.insert(make_pair(0xfffffff5U, SessionlessObj::SessionlessMessageKey(":sender.1", "org.test", "Signal", "/a")));
+    EXPECT_EQ(1U, ChangeIdsInRange(high, 0xfffffff0, 0x10).size());
+}
+
+TEST_F(SessionlessChangeIdIndexTest, EraseWhileWalking)
+{
+    /* Entries visited last are removed, as expired messages are */
+    const uint32_t expected[] = { 0xffffffff, 0, 1, 5, 5, 100 };
+    EXPECT_EQ(Ids(expected, ArraySize(expected)), ChangeIdsInRange(index, 0xfffffff1, 101, true));
+    EXPECT_EQ(1U, index.size());
+    EXPECT_EQ(0xfffffff0U, index.begin()->first);
+}
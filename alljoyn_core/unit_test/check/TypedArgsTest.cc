@@ -0,0 +1,336 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/TypedArgs.h>
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+class _TypedArgsTestMessage : public _Message {
+  public:
+    _TypedArgsTestMessage(BusAttachment& bus) : _Message(bus) { }
+    using _Message::CallMsg;
+};
+typedef ManagedObj<_TypedArgsTestMessage> TypedArgsTestMessage;
+
+static const char* sender = ":sender.3";
+static const char* destination = ":destination.3";
+
+/* Compare the marshaled bodies of two messages */
+static void ExpectSameBody(Message& a, Message& b, const char* signature)
+{
+    const uint8_t* aBody;
+    size_t aLen;
+    bool aSwap;
+    const uint8_t* bBody;
+    size_t bLen;
+    bool bSwap;
+    ASSERT_EQ(ER_OK, a->GetMarshaledBody(signature, aBody, aLen, aSwap));
+    ASSERT_EQ(ER_OK, b->GetMarshaledBody(signature, bBody, bLen, bSwap));
+    EXPECT_EQ(aSwap, bSwap);
+    ASSERT_EQ(aLen, bLen);
+    EXPECT_EQ(0, memcmp(aBody, bBody, aLen));
+}
+
+class TypedArgsTest : public testing::Test {
+  public:
+    TypedArgsTest() : bus(NULL) { }
+
+    virtual void TearDown()
+    {
+        /* Restore native endianess */
+        _Message::SetEndianess(0);
+    }
+
+    void MarshalAndCompare()
+    {
+        uint8_t byte = 0x5A;
+        bool flag = true;
+        int16_t i16 = -2;
+        uint64_t u64 = 0x0102030405060708ULL;
+        double dbl = 3.25;
+        qcc::String name = "typed";
+        vector<uint8_t> bytes;
+        for (uint8_t i = 0; i < 7; ++i) {
+            bytes.push_back(i);
+        }
+        vector<uint64_t> wide;
+        wide.push_back(1);
+        wide.push_back(0xFFFFFFFF00000000ULL);
+        vector<string> words;
+        words.push_back("one");
+        words.push_back("");
+        words.push_back("three");
+
+        typedef TypedArgs<uint8_t, bool, int16_t, uint64_t, double, qcc::String, vector<uint8_t>, vector<uint64_t>, vector<string> > Args;
+        const char* signature = "ybntdsayatas";
+
+        Args body(byte, flag, i16, u64, dbl, name, bytes, wide, words);
+        TypedArgsTestMessage typed(bus);
+        ASSERT_EQ(ER_OK, typed->CallMsg(signature, sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &body));
+        EXPECT_STREQ(signature, typed->GetSignature());
+
+        /* The same values marshaled from MsgArgs */
+        const char* wordStrs[] = { "one", "", "three" };
+        MsgArg args[9];
+        args[0].Set("y", byte);
+        args[1].Set("b", flag);
+        args[2].Set("n", i16);
+        args[3].Set("t", u64);
+        args[4].Set("d", dbl);
+        args[5].Set("s", name.c_str());
+        args[6].Set("ay", bytes.size(), &bytes[0]);
+        args[7].Set("at", wide.size(), &wide[0]);
+        args[8].Set("as", ArraySize(wordStrs), wordStrs);
+        TypedArgsTestMessage untyped(bus);
+        ASSERT_EQ(ER_OK, untyped->CallMsg(signature, sender, destination, 0, "/test", "org.test", "Method", args, ArraySize(args), 0));
+
+        Message typedMsg = Message::cast(typed);
+        Message untypedMsg = Message::cast(untyped);
+        ExpectSameBody(typedMsg, untypedMsg, signature);
+
+        /* Read back the MsgArg marshaled message */
+        uint8_t outByte = 0;
+        bool outFlag = false;
+        int16_t outI16 = 0;
+        uint64_t outU64 = 0;
+        double outDbl = 0;
+        qcc::String outName;
+        vector<uint8_t> outBytes;
+        vector<uint64_t> outWide;
+        vector<string> outWords;
+        ASSERT_EQ(ER_OK, Args::Get(untypedMsg, outByte, outFlag, outI16, outU64, outDbl, outName, outBytes, outWide, outWords));
+        EXPECT_EQ(byte, outByte);
+        EXPECT_EQ(flag, outFlag);
+        EXPECT_EQ(i16, outI16);
+        EXPECT_EQ(u64, outU64);
+        EXPECT_EQ(dbl, outDbl);
+        EXPECT_EQ(name, outName);
+        EXPECT_TRUE(bytes == outBytes);
+        EXPECT_TRUE(wide == outWide);
+        EXPECT_TRUE(words == outWords);
+
+        /* Nothing was unmarshaled into MsgArgs */
+        EXPECT_TRUE(untyped->GetArg(0) == NULL);
+    }
+
+    BusAttachment bus;
+};
+
+TEST_F(TypedArgsTest, SignatureFromTypes)
+{
+    vector<uint8_t> bytes;
+    string str;
+    EXPECT_STREQ("isay", (TypedArgs<int32_t, string, vector<uint8_t> >(1, str, bytes).GetSignature()));
+
+    vector<vector<uint32_t> > nested;
+    vector<qcc::String> strings;
+    EXPECT_STREQ("bdaauas", (TypedArgs<bool, double, vector<vector<uint32_t> >, vector<qcc::String> >(true, 1.0, nested, strings).GetSignature()));
+
+    EXPECT_STREQ("", TypedArgs<>().GetSignature());
+    EXPECT_EQ(0U, TypedArgs<>().GetSize());
+}
+
+TEST_F(TypedArgsTest, MatchesMsgArgMarshaling)
+{
+    MarshalAndCompare();
+}
+
+TEST_F(TypedArgsTest, MatchesMsgArgMarshalingInOtherEndianess)
+{
+    _Message::SetEndianess(ALLJOYN_LITTLE_ENDIAN);
+    MarshalAndCompare();
+    _Message::SetEndianess(ALLJOYN_BIG_ENDIAN);
+    MarshalAndCompare();
+}
+
+TEST_F(TypedArgsTest, ViewsPointIntoMessage)
+{
+    const char* str = "view";
+    uint8_t data[] = { 1, 2, 3 };
+    StringView strView(str);
+    ByteArrayView dataView(data, sizeof(data));
+    TypedArgs<StringView, ByteArrayView> views(strView, dataView);
+    TypedArgsTestMessage msg(bus);
+    ASSERT_EQ(ER_OK, msg->CallMsg("say", sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &views));
+
+    Message message = Message::cast(msg);
+    StringView outStr;
+    ByteArrayView outData;
+    ASSERT_EQ(ER_OK, (TypedArgs<StringView, ByteArrayView>::Get(message, outStr, outData)));
+    EXPECT_STREQ("view", outStr.str);
+    EXPECT_EQ(4U, outStr.len);
+    ASSERT_EQ(sizeof(data), outData.len);
+    EXPECT_EQ(0, memcmp(data, outData.data, sizeof(data)));
+
+    const uint8_t* body;
+    size_t bodyLen;
+    bool endianSwap;
+    ASSERT_EQ(ER_OK, message->GetMarshaledBody("say", body, bodyLen, endianSwap));
+    EXPECT_TRUE((reinterpret_cast<const uint8_t*>(outStr.str) > body) && (reinterpret_cast<const uint8_t*>(outStr.str) < (body + bodyLen)));
+    EXPECT_TRUE((outData.data > body) && (outData.data < (body + bodyLen)));
+}
+
+TEST_F(TypedArgsTest, SignatureMismatchIsRejected)
+{
+    uint32_t value = 7;
+    TypedArgs<uint32_t> body(value);
+    TypedArgsTestMessage msg(bus);
+    /* The interface signature must match the types */
+    EXPECT_EQ(ER_BUS_UNEXPECTED_SIGNATURE, msg->CallMsg("i", sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &body));
+
+    ASSERT_EQ(ER_OK, msg->CallMsg("u", sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &body));
+    Message message = Message::cast(msg);
+    int32_t wrongType;
+    EXPECT_EQ(ER_BUS_SIGNATURE_MISMATCH, TypedArgs<int32_t>::Get(message, wrongType));
+    uint32_t out = 0;
+    EXPECT_EQ(ER_OK, TypedArgs<uint32_t>::Get(message, out));
+    EXPECT_EQ(value, out);
+}
+
+/* A body writer that claims a signature but writes a body of a different length */
+class MismatchedBodyWriter : public MsgBodyWriter {
+  public:
+    MismatchedBodyWriter(const char* signature, size_t size) : signature(signature), size(size) { }
+
+    const char* GetSignature() const { return signature; }
+
+    size_t GetSize() const { return size; }
+
+    QStatus Marshal(uint8_t* buf, bool endianSwap) const
+    {
+        QCC_UNUSED(endianSwap);
+        memset(buf, 0, size);
+        return ER_OK;
+    }
+
+  private:
+    const char* signature;
+    size_t size;
+};
+
+TEST_F(TypedArgsTest, EmptyBodyWithSignatureIsRejected)
+{
+    MismatchedBodyWriter noBody("u", 0);
+    TypedArgsTestMessage msg(bus);
+    ASSERT_EQ(ER_OK, msg->CallMsg("u", sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &noBody));
+    Message message = Message::cast(msg);
+    const uint8_t* body;
+    size_t bodyLen;
+    bool endianSwap;
+    EXPECT_EQ(ER_BUS_BAD_BODY_LEN, message->GetMarshaledBody("u", body, bodyLen, endianSwap));
+    uint32_t out;
+    EXPECT_EQ(ER_BUS_BAD_BODY_LEN, TypedArgs<uint32_t>::Get(message, out));
+
+    MismatchedBodyWriter noSignature("", 4);
+    ASSERT_EQ(ER_OK, msg->CallMsg("", sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &noSignature));
+    EXPECT_EQ(ER_BUS_BAD_BODY_LEN, message->GetMarshaledBody("", body, bodyLen, endianSwap));
+    EXPECT_EQ(ER_BUS_BAD_BODY_LEN, TypedArgs<>::Get(message));
+}
+
+/* Marshal a message and return a writable pointer to its body */
+template <typename... Ts>
+static uint8_t* MarshalBody(TypedArgsTestMessage& msg, const TypedArgs<Ts...>& args, size_t& bodyLen)
+{
+    const uint8_t* body = NULL;
+    bool endianSwap;
+    if ((msg->CallMsg(args.GetSignature(), sender, destination, 0, "/test", "org.test", "Method", NULL, 0, 0, &args) != ER_OK) ||
+        (msg->GetMarshaledBody(args.GetSignature(), body, bodyLen, endianSwap) != ER_OK)) {
+        return NULL;
+    }
+    return const_cast<uint8_t*>(body);
+}
+
+TEST_F(TypedArgsTest, TruncatedBodyIsRejected)
+{
+    qcc::String str = "view";
+    TypedArgs<qcc::String> strArgs(str);
+    TypedArgsTestMessage strMsg(bus);
+    size_t bodyLen;
+    uint8_t* body = MarshalBody(strMsg, strArgs, bodyLen);
+    ASSERT_TRUE(body != NULL);
+    Message message = Message::cast(strMsg);
+    qcc::String outStr;
+    /* A string length running past the end of the body */
+    uint32_t len32 = static_cast<uint32_t>(bodyLen);
+    memcpy(body, &len32, sizeof(len32));
+    EXPECT_EQ(ER_BUS_BAD_LENGTH, TypedArgs<qcc::String>::Get(message, outStr));
+
+    vector<uint8_t> bytes(8, 0xAB);
+    TypedArgs<vector<uint8_t> > byteArgs(bytes);
+    TypedArgsTestMessage byteMsg(bus);
+    body = MarshalBody(byteMsg, byteArgs, bodyLen);
+    ASSERT_TRUE(body != NULL);
+    message = Message::cast(byteMsg);
+    vector<uint8_t> outBytes;
+    len32 = 9;
+    memcpy(body, &len32, sizeof(len32));
+    EXPECT_EQ(ER_BUS_BAD_LENGTH, TypedArgs<vector<uint8_t> >::Get(message, outBytes));
+    /* A shorter array leaves bytes over at the end of the body */
+    len32 = 7;
+    memcpy(body, &len32, sizeof(len32));
+    EXPECT_EQ(ER_BUS_BAD_SIGNATURE, TypedArgs<vector<uint8_t> >::Get(message, outBytes));
+
+    vector<uint32_t> words(2, 1);
+    TypedArgs<vector<uint32_t> > wordArgs(words);
+    TypedArgsTestMessage wordMsg(bus);
+    body = MarshalBody(wordMsg, wordArgs, bodyLen);
+    ASSERT_TRUE(body != NULL);
+    message = Message::cast(wordMsg);
+    vector<uint32_t> outWords;
+    len32 = 12;
+    memcpy(body, &len32, sizeof(len32));
+    EXPECT_EQ(ER_BUS_BAD_LENGTH, TypedArgs<vector<uint32_t> >::Get(message, outWords));
+    /* The last element must not run past the end of the array */
+    len32 = 6;
+    memcpy(body, &len32, sizeof(len32));
+    EXPECT_EQ(ER_BUS_BAD_LENGTH, TypedArgs<vector<uint32_t> >::Get(message, outWords));
+}
+
+TEST_F(TypedArgsTest, MalformedBodyIsRejected)
+{
+    qcc::String str = "view";
+    TypedArgs<qcc::String> strArgs(str);
+    TypedArgsTestMessage strMsg(bus);
+    size_t bodyLen;
+    uint8_t* body = MarshalBody(strMsg, strArgs, bodyLen);
+    ASSERT_TRUE(body != NULL);
+    Message message = Message::cast(strMsg);
+    qcc::String outStr;
+    /* Overwrite the NUL terminator */
+    body[bodyLen - 1] = 'x';
+    EXPECT_EQ(ER_BUS_NOT_NUL_TERMINATED, TypedArgs<qcc::String>::Get(message, outStr));
+
+    bool flag = true;
+    TypedArgs<bool> boolArgs(flag);
+    TypedArgsTestMessage boolMsg(bus);
+    body = MarshalBody(boolMsg, boolArgs, bodyLen);
+    ASSERT_TRUE(body != NULL);
+    message = Message::cast(boolMsg);
+    bool outFlag;
+    /* Booleans can only be 0 or 1 */
+    uint32_t two = 2;
+    memcpy(body, &two, sizeof(two));
+    EXPECT_EQ(ER_BUS_BAD_VALUE, TypedArgs<bool>::Get(message, outFlag));
+}
@@ -0,0 +1,198 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/Mutex.h>
+#include <qcc/Thread.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "UDPMessagePump.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/*
+ * A message pump that records what it dispatches instead of pushing messages
+ * into a router.
+ */
+class TestMessagePump : public MessagePump {
+  public:
+    TestMessagePump(uint32_t maxThreads, vector<ArdpRcvBuf*>& released) : MessagePump(maxThreads), slowConnId(0), overlap(false), released(released) { }
+
+    ~TestMessagePump()
+    {
+        Stop();
+        Join();
+        ReleaseQueued();
+    }
+
+    size_t Dispatched(uint32_t connId)
+    {
+        lock.Lock();
+        size_t n = dispatched[connId].size();
+        lock.Unlock();
+        return n;
+    }
+
+    bool WaitForDispatched(uint64_t count)
+    {
+        for (uint32_t i = 0; i < 1000; ++i) {
+            UDPTransport::MessagePumpStats stats;
+            GetStats(stats);
+            if (stats.dispatchedMessages >= count) {
+                return true;
+            }
+            qcc::Sleep(5);
+        }
+        return false;
+    }
+
+    uint32_t slowConnId;
+    Mutex lock;
+    map<uint32_t, vector<ArdpRcvBuf*> > dispatched;
+    set<uint32_t> active;
+    bool overlap;
+
+  protected:
+    virtual void Dispatch(QueueEntry& entry)
+    {
+        lock.Lock();
+        if (!active.insert(entry.m_connId).second) {
+            overlap = true;
+        }
+        lock.Unlock();
+
+        if (entry.m_connId == slowConnId) {
+            qcc::Sleep(50);
+        }
+
+        lock.Lock();
+        dispatched[entry.m_connId].push_back(entry.m_rcv);
+        active.erase(entry.m_connId);
+        lock.Unlock();
+    }
+
+    virtual void Release(QueueEntry& entry)
+    {
+        released.push_back(entry.m_rcv);
+    }
+
+  private:
+    vector<ArdpRcvBuf*>& released;
+};
+
+TEST(UDPMessagePumpTest, PerConnectionOrder)
+{
+    const uint32_t connections = 8;
+    const uint32_t messages = 50;
+    vector<ArdpRcvBuf> bufs(connections * messages);
+    vector<ArdpRcvBuf*> released;
+    TestMessagePump pump(4, released);
+
+    /* Interleave the messages of all of the connections */
+    for (uint32_t m = 0; m < messages; ++m) {
+        for (uint32_t c = 0; c < connections; ++c) {
+            pump.RecvCb(NULL, NULL, c + 1, &bufs[c * messages + m], ER_OK);
+        }
+    }
+    ASSERT_TRUE(pump.WaitForDispatched(connections * messages));
+
+    EXPECT_FALSE(pump.overlap);
+    for (uint32_t c = 0; c < connections; ++c) {
+        vector<ArdpRcvBuf*>& got = pump.dispatched[c + 1];
+        ASSERT_EQ(messages, got.size());
+        for (uint32_t m = 0; m < messages; ++m) {
+            EXPECT_EQ(&bufs[c * messages + m], got[m]);
+        }
+    }
+
+    UDPTransport::MessagePumpStats stats;
+    pump.GetStats(stats);
+    EXPECT_EQ(4U, stats.maxThreads);
+    EXPECT_GE(stats.maxThreads, stats.threads);
+    EXPECT_LT(0U, stats.threads);
+    EXPECT_EQ(0U, stats.busyThreads);
+    EXPECT_GE(stats.threads, stats.peakBusyThreads);
+    EXPECT_LT(0U, stats.peakBusyThreads);
+    EXPECT_EQ(0U, stats.queuedMessages);
+    EXPECT_GE(connections * messages, stats.peakQueuedMessages);
+    EXPECT_LT(0U, stats.peakQueuedMessages);
+    EXPECT_EQ(0U, stats.queuedConnections);
+    EXPECT_EQ(static_cast<uint64_t>(connections * messages), stats.dispatchedMessages);
+    EXPECT_FALSE(pump.IsActive());
+}
+
+TEST(UDPMessagePumpTest, SlowConnectionDoesNotStallOthers)
+{
+    vector<ArdpRcvBuf> bufs(15);
+    vector<ArdpRcvBuf*> released;
+    TestMessagePump pump(2, released);
+    pump.slowConnId = 1;
+
+    for (uint32_t m = 0; m < 5; ++m) {
+        pump.RecvCb(NULL, NULL, 1, &bufs[m], ER_OK);
+    }
+    for (uint32_t m = 5; m < 15; ++m) {
+        pump.RecvCb(NULL, NULL, 2, &bufs[m], ER_OK);
+    }
+
+    /* The slow connection only ties up one of the two threads */
+    for (uint32_t i = 0; (i < 200) && (pump.Dispatched(2) < 10); ++i) {
+        qcc::Sleep(1);
+    }
+    EXPECT_EQ(10U, pump.Dispatched(2));
+    EXPECT_GT(5U, pump.Dispatched(1));
+
+    ASSERT_TRUE(pump.WaitForDispatched(15));
+    EXPECT_FALSE(pump.overlap);
+}
+
+TEST(UDPMessagePumpTest, ReleaseQueuedInOrder)
+{
+    vector<ArdpRcvBuf> bufs(4);
+    vector<ArdpRcvBuf*> released;
+    {
+        TestMessagePump pump(2, released);
+        pump.Stop();
+
+        /* Messages received after Stop() are queued but never dispatched */
+        pump.RecvCb(NULL, NULL, 7, &bufs[0], ER_OK);
+        pump.RecvCb(NULL, NULL, 8, &bufs[1], ER_OK);
+        pump.RecvCb(NULL, NULL, 7, &bufs[2], ER_OK);
+        pump.RecvCb(NULL, NULL, 8, &bufs[3], ER_OK);
+
+        UDPTransport::MessagePumpStats stats;
+        pump.GetStats(stats);
+        EXPECT_EQ(0U, stats.threads);
+        EXPECT_EQ(4U, stats.queuedMessages);
+        EXPECT_EQ(2U, stats.queuedConnections);
+        EXPECT_EQ(0U, stats.dispatchedMessages);
+    }
+
+    /* Released connection by connection, each in the order received */
+    ASSERT_EQ(4U, released.size());
+    EXPECT_EQ(&bufs[0], released[0]);
+    EXPECT_EQ(&bufs[2], released[1]);
+    EXPECT_EQ(&bufs[1], released[2]);
+    EXPECT_EQ(&bufs[3], released[3]);
+}
@@ -288,6 +288,25 @@ void QCC_RegisterOutputCallback(QCC_DbgMsgCallback cb, void* context);
  */
 void QCC_RegisterOutputFile(FILE* file);
 
+/**
+ * Get the number of debug messages that were dropped because the debug writer
+ * thread could not keep up.  Messages are only written by a separate thread
+ * when the ER_DEBUG_ASYNC environment variable is set, otherwise none are
+ * ever dropped.
+ *
+ * @return  The number of messages dropped since start up.
+ */
+uint32_t QCC_GetDroppedDebugMessages(void);
+
+/**
+ * Turn writing debug messages from a separate thread on or off, as the
+ * ER_DEBUG_ASYNC environment variable does at start up.  Turning it off
+ * writes out the messages still waiting for the thread before returning.
+ *
+ * @param async  true to queue debug messages for the writer thread.
+ */
+void QCC_SetAsyncDebugOutput(bool async);
+
 /**
  * @cond ALLJOYN_DEV
  * @internal
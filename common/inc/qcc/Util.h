@@ -101,6 +101,29 @@ inline size_t hash_string(const char* __s) {
     return size_t(__h);
 }
 
+/**
+ * Offset basis of the 64-bit FNV-1a hash
+ */
+const uint64_t FNV1A_64_INIT = 14695981039346656037ULL;
+
+/**
+ * Returns the 64-bit FNV-1a hash of a block of bytes.  Data spread over
+ * several blocks is hashed by passing the hash of the previous blocks.
+ *
+ * @param data  The bytes to hash
+ * @param len   Number of bytes
+ * @param hash  Hash of the preceding data or FNV1A_64_INIT
+ *
+ * @return Hash value
+ */
+inline uint64_t hash_fnv1a(const void* data, size_t len, uint64_t hash = FNV1A_64_INIT) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (len--) {
+        hash = (hash ^ *p++) * 1099511628211ULL;
+    }
+    return hash;
+}
+
 /**
  * The enum defining the high level operating system on the device.
  */
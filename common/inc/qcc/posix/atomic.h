@@ -72,6 +72,21 @@ inline int32_t DecrementAndFetch(volatile int32_t* mem)
     return __atomic_dec(mem) - 1;
 }
 
+/**
+ * Replace the value of an int32_t if it holds the expected value, atomically
+ * and with a full memory barrier.
+ *
+ * @param mem            Pointer to int32_t to be replaced.
+ * @param expectedValue  Value *mem must hold for it to be replaced.
+ * @param newValue       Value to store in *mem.
+ * @return  true if *mem held expectedValue and was replaced
+ */
+inline bool CompareAndExchange(volatile int32_t* mem, int32_t expectedValue, int32_t newValue)
+{
+    /* Androids built in __atomic_cmpxchg operation returns 0 if the value was replaced */
+    return __atomic_cmpxchg(expectedValue, newValue, mem) == 0;
+}
+
 #elif defined(QCC_OS_LINUX)
 
 /**
@@ -94,6 +109,19 @@ inline int32_t DecrementAndFetch(volatile int32_t* mem) {
     return __sync_sub_and_fetch(mem, 1);
 }
 
+/**
+ * Replace the value of an int32_t if it holds the expected value, atomically
+ * and with a full memory barrier.
+ *
+ * @param mem            Pointer to int32_t to be replaced.
+ * @param expectedValue  Value *mem must hold for it to be replaced.
+ * @param newValue       Value to store in *mem.
+ * @return  true if *mem held expectedValue and was replaced
+ */
+inline bool CompareAndExchange(volatile int32_t* mem, int32_t expectedValue, int32_t newValue) {
+    return __sync_bool_compare_and_swap(mem, expectedValue, newValue);
+}
+
 #elif defined(QCC_OS_DARWIN)
 
 /**
@@ -116,6 +144,19 @@ inline int32_t DecrementAndFetch(volatile int32_t* mem) {
     return OSAtomicDecrement32(mem);
 }
 
+/**
+ * Replace the value of an int32_t if it holds the expected value, atomically
+ * and with a full memory barrier.
+ *
+ * @param mem            Pointer to int32_t to be replaced.
+ * @param expectedValue  Value *mem must hold for it to be replaced.
+ * @param newValue       Value to store in *mem.
+ * @return  true if *mem held expectedValue and was replaced
+ */
+inline bool CompareAndExchange(volatile int32_t* mem, int32_t expectedValue, int32_t newValue) {
+    return OSAtomicCompareAndSwap32Barrier(expectedValue, newValue, mem);
+}
+
 #else
 
 /**
@@ -134,6 +175,17 @@ int32_t IncrementAndFetch(volatile int32_t* mem);
  */
 int32_t DecrementAndFetch(volatile int32_t* mem);
 
+/**
+ * Replace the value of an int32_t if it holds the expected value, atomically
+ * and with a full memory barrier.
+ *
+ * @param mem            Pointer to int32_t to be replaced.
+ * @param expectedValue  Value *mem must hold for it to be replaced.
+ * @param newValue       Value to store in *mem.
+ * @return  true if *mem held expectedValue and was replaced
+ */
+bool CompareAndExchange(volatile int32_t* mem, int32_t expectedValue, int32_t newValue);
+
 #endif
 
 }
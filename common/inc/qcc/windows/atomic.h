@@ -48,6 +48,19 @@ inline int32_t DecrementAndFetch(volatile int32_t* mem) {
     return InterlockedDecrement(reinterpret_cast<volatile long*>(mem));
 }
 
+/**
+ * Replace the value of an int32_t if it holds the expected value, atomically
+ * and with a full memory barrier.
+ *
+ * @param mem            Pointer to int32_t to be replaced.
+ * @param expectedValue  Value *mem must hold for it to be replaced.
+ * @param newValue       Value to store in *mem.
+ * @return  true if *mem held expectedValue and was replaced
+ */
+inline bool CompareAndExchange(volatile int32_t* mem, int32_t expectedValue, int32_t newValue) {
+    return InterlockedCompareExchange(reinterpret_cast<volatile long*>(mem), newValue, expectedValue) == expectedValue;
+}
+
 }
 
 #endif
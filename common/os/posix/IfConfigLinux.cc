@@ -320,12 +320,24 @@ static uint32_t NetlinkRecv(int sockFd, char* buffer, int buflen)
         }
 
         struct nlmsghdr* p = (struct nlmsghdr*)&buffer[nBytes];
+        nBytes += tmp;
 
-        if (p->nlmsg_type == NLMSG_DONE) {
-            break;
+        //
+        // Newer kernels may fold the NLMSG_DONE into the same datagram as the
+        // last messages of the dump rather than sending it on its own, so we
+        // have to look through the whole datagram for it.
+        //
+        bool done = false;
+        for (int remaining = tmp; NLMSG_OK(p, remaining); p = NLMSG_NEXT(p, remaining)) {
+            if (p->nlmsg_type == NLMSG_DONE) {
+                done = true;
+                break;
+            }
         }
 
-        nBytes += tmp;
+        if (done) {
+            break;
+        }
     }
 
     return nBytes;
@@ -55,6 +55,8 @@ Mutex* Thread::threadListLock = NULL;
 map<ThreadId, Thread*>* Thread::threadList = NULL;
 
 static pthread_key_t cleanExternalThreadKey;
+/* The Thread running on this thread while in RunInternal, read without taking threadListLock */
+static pthread_key_t currentThreadKey;
 static bool initialized = false;
 
 void Thread::CleanExternalThread(void* t)
@@ -88,6 +90,14 @@ QStatus Thread::Init()
             delete threadListLock;
             return ER_OS_ERROR;
         }
+        ret = pthread_key_create(&currentThreadKey, NULL);
+        if (ret != 0) {
+            QCC_LogError(ER_OS_ERROR, ("Creating TLS key: %s", strerror(ret)));
+            pthread_key_delete(cleanExternalThreadKey);
+            delete threadList;
+            delete threadListLock;
+            return ER_OS_ERROR;
+        }
         initialized = true;
     }
     return ER_OK;
@@ -104,6 +114,10 @@ QStatus Thread::Shutdown()
         if (ret != 0) {
             QCC_LogError(ER_OS_ERROR, ("Deleting TLS key: %s", strerror(ret)));
         }
+        ret = pthread_key_delete(currentThreadKey);
+        if (ret != 0) {
+            QCC_LogError(ER_OS_ERROR, ("Deleting TLS key: %s", strerror(ret)));
+        }
         delete Thread::threadList;
         delete Thread::threadListLock;
         initialized = false;
@@ -118,7 +132,10 @@ QStatus Sleep(uint32_t ms) {
 
 Thread* Thread::GetThread()
 {
-    Thread* ret = NULL;
+    Thread* ret = reinterpret_cast<Thread*>(pthread_getspecific(currentThreadKey));
+    if (ret != NULL) {
+        return ret;
+    }
 
     /* Find thread on Thread::threadList */
     threadListLock->Lock();
@@ -138,7 +155,10 @@ Thread* Thread::GetThread()
 
 const char* Thread::GetThreadName()
 {
-    Thread* thread = NULL;
+    Thread* thread = reinterpret_cast<Thread*>(pthread_getspecific(currentThreadKey));
+    if (thread != NULL) {
+        return thread->GetName();
+    }
 
     /* Find thread on Thread::threadList */
     threadListLock->Lock();
@@ -257,6 +277,7 @@ ThreadInternalReturn Thread::RunInternal(void* arg)
     thread->state = RUNNING;
     pthread_sigmask(SIG_UNBLOCK, &newmask, NULL);
     threadListLock->Unlock();
+    pthread_setspecific(currentThreadKey, thread);
 
     /* Start the thread if it hasn't been stopped */
     if (!thread->isStopping) {
@@ -276,6 +297,7 @@ ThreadInternalReturn Thread::RunInternal(void* arg)
      */
     void* retVal = thread->exitValue;
     ThreadHandle handle = thread->handle;
+    pthread_setspecific(currentThreadKey, NULL);
 
 
     /* Call aux listeners before main listener since main listner may delete the thread */
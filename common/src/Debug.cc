@@ -31,12 +31,14 @@
 #include <qcc/Debug.h>
 #include <qcc/Logger.h>
 #include <qcc/Environ.h>
+#include <qcc/Event.h>
 #include <qcc/Mutex.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
 #include <qcc/time.h>
 #include <qcc/OSLogger.h>
+#include <qcc/atomic.h>
 #include "DebugControl.h"
 
 using namespace std;
@@ -52,6 +54,94 @@ static DebugControl* dbgControl = NULL;
 static bool initialized = false;
 static bool dbgUseEpoch = false;
 
+/*
+ * Longest debug message, longer messages are truncated
+ */
+static const size_t MAX_DEBUG_MSG_LEN = 2000;
+
+/*
+ * Queued debug messages are stored as variable-length records in a ring of
+ * fixed-size slots.  A record takes as many consecutive slots as it needs for
+ * a DebugRecordHeader followed by the module, file name, thread name and
+ * message, each terminated by a NUL.  Everything the prefix is made of is
+ * captured when the message is logged so it can be formatted later on the
+ * writer thread.
+ */
+static const size_t DEBUG_SLOT_DATA = 124;
+
+struct DebugSlot {
+    volatile int32_t sequence;      /* See QueueDebugMessage() */
+    char data[DEBUG_SLOT_DATA];
+};
+
+struct DebugRecordHeader {
+    uint32_t slots;
+    DbgMsgType type;
+    int lineno;
+    uint64_t timestamp;
+};
+
+/*
+ * Longest module, file and thread names kept in a record, longer names are
+ * truncated.  Only the end of the file name is kept since the prefix only has
+ * room for that much.
+ */
+static const size_t MAX_DEBUG_MODULE_LEN = 31;
+static const size_t MAX_DEBUG_FILENAME_LEN = 63;
+static const size_t MAX_DEBUG_THREADNAME_LEN = 63;
+
+static const size_t MAX_DEBUG_RECORD_SLOTS = (sizeof(DebugRecordHeader) + MAX_DEBUG_MODULE_LEN + MAX_DEBUG_FILENAME_LEN +
+                                              MAX_DEBUG_THREADNAME_LEN + MAX_DEBUG_MSG_LEN + 4 + DEBUG_SLOT_DATA - 1) / DEBUG_SLOT_DATA;
+
+/*
+ * Number of slots in the ring, must be a power of 2.  With 128 byte slots the
+ * ring takes 1 MB.  A typical message with its header fits in two slots, so
+ * about 4000 messages can be waiting for the writer thread.
+ */
+static const uint32_t DEBUG_RING_SLOTS = 8192;
+
+/*
+ * How long the writer thread lets messages collect before writing them out.
+ * It is woken up sooner on errors and once a quarter of the ring is in use.
+ */
+static const uint32_t DEBUG_WRITE_INTERVAL = 100;
+static const uint32_t DEBUG_WAKE_SLOTS = DEBUG_RING_SLOTS / 4;
+
+/* Bytes of output the writer thread collects before writing them to a file */
+static const size_t DEBUG_WRITE_BATCH = 16 * 1024;
+
+/*
+ * Whether messages are queued for the writer thread.  Changed with
+ * CompareAndExchange() only.
+ */
+static const int32_t DEBUG_WRITER_STOPPED = 0;
+static const int32_t DEBUG_WRITER_RUNNING = 1;
+static volatile int32_t debugWriterState = DEBUG_WRITER_STOPPED;
+
+/*
+ * Number of threads that may be queueing a message.  The ring and the event
+ * are only freed once the writer is stopped and this has dropped to 0.
+ */
+static volatile int32_t debugProducers = 0;
+
+static DebugSlot* debugRing = NULL;
+static volatile int32_t debugEnqueuePos = 0;
+static volatile int32_t debugDequeuePos = 0;
+static volatile int32_t debugDropped = 0;
+static int32_t debugDroppedReported = 0;
+static qcc::Event* debugWriteEvent = NULL;
+static qcc::Mutex* debugWriterLock = NULL;
+
+class DebugWriterThread : public Thread {
+  public:
+    DebugWriterThread() : Thread("DebugWriter") { }
+
+  protected:
+    virtual ThreadReturn STDCALL Run(void* arg);
+};
+
+static DebugWriterThread* debugWriter = NULL;
+
 int QCC_SyncPrintf(const char* fmt, ...)
 {
     int ret = 0;
@@ -103,6 +193,7 @@ void DebugControl::Init()
 {
     if (!initialized) {
         stdoutLock = new qcc::Mutex();
+        debugWriterLock = new qcc::Mutex();
         dbgControl = new DebugControl();
         initialized = true;
     }
@@ -113,11 +204,13 @@ void DebugControl::Shutdown()
     if (initialized) {
         delete dbgControl;
         delete stdoutLock;
+        delete debugWriterLock;
+        debugWriterLock = NULL;
         initialized = false;
     }
 }
 
-DebugControl::DebugControl(void) : cb(Output), context(stderr), allLevel(0), printThread(true)
+DebugControl::DebugControl(void) : cb(Output), context(stderr), allLevel(0), printThread(true), asyncOutput(false)
 {
     Environ* env = Environ::GetAppEnviron();
     Environ::const_iterator iter;
@@ -134,6 +227,10 @@ DebugControl::DebugControl(void) : cb(Output), context(stderr), allLevel(0), pri
             printThread = ((iter->second.compare("0") != 0) &&
                            (iter->second.compare("off") != 0) &&
                            (iter->second.compare("OFF") != 0));
+        } else if (var.compare("ER_DEBUG_ASYNC") == 0) {
+            asyncOutput = ((iter->second.compare("0") != 0) &&
+                           (iter->second.compare("off") != 0) &&
+                           (iter->second.compare("OFF") != 0));
         } else if (var.compare(0, varPrefixLen, varPrefix) == 0) {
             uint32_t level = StringToU32(iter->second, 0, 0);
             if (var.compare("ER_DEBUG_ALL") == 0) {
@@ -169,11 +266,26 @@ void DebugControl::Register(QCC_DbgMsgCallback callback, void* cbContext)
     this->cb = callback;
 }
 
+bool DebugControl::OutputToFile() const
+{
+    return cb == WriteMsg;
+}
+
 bool DebugControl::PrintThread() const
 {
     return printThread;
 }
 
+bool DebugControl::AsyncOutput() const
+{
+    return asyncOutput;
+}
+
+void DebugControl::SetAsyncOutput(bool async)
+{
+    asyncOutput = async;
+}
+
 bool DebugControl::Check(DbgMsgType type, const char* module)
 {
     map<const qcc::String, uint32_t>::const_iterator iter;
@@ -250,7 +362,13 @@ static const char* Type2Str(DbgMsgType type)
 }
 
 
-static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, const char* filename, int lineno, bool printThread, bool useEpoch)
+static uint64_t GetDebugTimestamp(void)
+{
+    return dbgUseEpoch ? GetEpochTimestamp() : GetTimestamp();
+}
+
+static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, const char* filename, int lineno,
+                      const char* threadName, uint64_t timestamp, bool useEpoch)
 {
     static const size_t timeTypeWidth = 18;
     static const size_t moduleWidth = 12;
@@ -263,13 +381,11 @@ static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, con
 
     if (useEpoch) {
         colStop = 24;
-        uint64_t timestamp = GetEpochTimestamp();
         logTimeSecond = U64ToString(timestamp / 1000, 10, 10, ' ');
         logTimeMS = U64ToString(timestamp % 1000, 10, 3, '0');
     } else {
-        uint32_t timestamp = GetTimestamp();
-        logTimeSecond = U32ToString((timestamp / 1000) % 10000, 10, 4, ' ');
-        logTimeMS = U32ToString(timestamp % 1000, 10, 3, '0');
+        logTimeSecond = U32ToString(static_cast<uint32_t>((timestamp / 1000) % 10000), 10, 4, ' ');
+        logTimeMS = U32ToString(static_cast<uint32_t>(timestamp % 1000), 10, 3, '0');
     }
 
     oss.reserve(colStop + moduleWidth + threadWidth + fileLineWidth + oss.capacity());
@@ -293,10 +409,10 @@ static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, con
         oss.push_back(' ');
     } while (oss.size() < colStop);
 
-    if (printThread) {
+    if (threadName) {
         // Thread name - col 30
         colStop += threadWidth;
-        oss.append(Thread::GetThreadName());
+        oss.append(threadName);
         do {
             oss.push_back(' ');
         } while (oss.size() < colStop);
@@ -331,7 +447,7 @@ static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, con
 
 class DebugContext {
   private:
-    char msg[2000];  // Just allocate a buffer that's 'big enough'.
+    char msg[MAX_DEBUG_MSG_LEN];  // Just allocate a buffer that's 'big enough'.
     size_t msgLen;
 
   public:
@@ -353,13 +469,256 @@ class DebugContext {
     }
 };
 
+/*
+ * Copy bytes into the ring at the slot and offset given, moving on to the
+ * following slots as they fill up.
+ */
+static void CopyToRing(uint32_t& pos, size_t& offset, const void* src, size_t len)
+{
+    const char* p = static_cast<const char*>(src);
+    while (len > 0) {
+        if (offset == DEBUG_SLOT_DATA) {
+            ++pos;
+            offset = 0;
+        }
+        size_t n = (std::min)(len, DEBUG_SLOT_DATA - offset);
+        memcpy(debugRing[pos & (DEBUG_RING_SLOTS - 1)].data + offset, p, n);
+        offset += n;
+        p += n;
+        len -= n;
+    }
+}
+
+static void CopyStringToRing(uint32_t& pos, size_t& offset, const char* src, size_t len)
+{
+    CopyToRing(pos, offset, src, len);
+    CopyToRing(pos, offset, "", 1);
+}
+
+/*
+ * Queue a debug message for the writer thread.  The ring is a bounded
+ * multi-producer queue.  The sequence of a free slot equals the position it
+ * is written at.  A producer claims the slots of a record by advancing
+ * debugEnqueuePos past them once the last one is free, and publishes the
+ * record by advancing the sequence of its first slot by one.  The writer
+ * thread frees the slots in order by advancing their sequences to the
+ * positions they will be written at next time around the ring, so the last
+ * slot being free means all of them are.  When the ring is full the message
+ * is dropped and counted rather than making the caller wait.
+ */
+static void QueueDebugMessage(DbgMsgType type, const char* module, const char* filename, int lineno,
+                              const char* msg, size_t msgLen)
+{
+    const char* threadName = dbgControl->PrintThread() ? Thread::GetThreadName() : "";
+    size_t moduleLen = (std::min)(strlen(module), MAX_DEBUG_MODULE_LEN);
+    size_t filenameLen = strlen(filename);
+    if (filenameLen > MAX_DEBUG_FILENAME_LEN) {
+        filename += filenameLen - MAX_DEBUG_FILENAME_LEN;
+        filenameLen = MAX_DEBUG_FILENAME_LEN;
+    }
+    size_t threadNameLen = (std::min)(strlen(threadName), MAX_DEBUG_THREADNAME_LEN);
+    size_t size = sizeof(DebugRecordHeader) + moduleLen + filenameLen + threadNameLen + msgLen + 4;
+    uint32_t slots = static_cast<uint32_t>((size + DEBUG_SLOT_DATA - 1) / DEBUG_SLOT_DATA);
+
+    uint32_t pos = static_cast<uint32_t>(debugEnqueuePos);
+    while (true) {
+        uint32_t last = pos + slots - 1;
+        int32_t diff = static_cast<int32_t>(static_cast<uint32_t>(debugRing[last & (DEBUG_RING_SLOTS - 1)].sequence) - last);
+        if (diff == 0) {
+            if (CompareAndExchange(&debugEnqueuePos, static_cast<int32_t>(pos), static_cast<int32_t>(pos + slots))) {
+                break;
+            }
+        } else if (diff < 0) {
+            IncrementAndFetch(&debugDropped);
+            return;
+        }
+        pos = static_cast<uint32_t>(debugEnqueuePos);
+    }
+
+    DebugRecordHeader hdr;
+    hdr.slots = slots;
+    hdr.type = type;
+    hdr.lineno = lineno;
+    hdr.timestamp = GetDebugTimestamp();
+    uint32_t slot = pos;
+    size_t offset = 0;
+    CopyToRing(slot, offset, &hdr, sizeof(hdr));
+    CopyStringToRing(slot, offset, module, moduleLen);
+    CopyStringToRing(slot, offset, filename, filenameLen);
+    CopyStringToRing(slot, offset, threadName, threadNameLen);
+    CopyStringToRing(slot, offset, msg, msgLen);
+    IncrementAndFetch(&debugRing[pos & (DEBUG_RING_SLOTS - 1)].sequence);
+
+    /*
+     * Errors are written out right away, everything else once the ring starts
+     * to fill up.  Only the message that crosses the mark wakes the writer.
+     */
+    uint32_t inUse = pos - static_cast<uint32_t>(debugDequeuePos);
+    if ((type == DBG_LOCAL_ERROR) || ((inUse < DEBUG_WAKE_SLOTS) && ((inUse + slots) >= DEBUG_WAKE_SLOTS))) {
+        debugWriteEvent->SetEvent();
+    }
+}
+
+/*
+ * Format and write out the queued debug messages.  Only called by the writer
+ * thread, or once it has stopped.
+ */
+static void WriteQueuedDebugMessages(void)
+{
+    static char record[MAX_DEBUG_RECORD_SLOTS * DEBUG_SLOT_DATA];
+    qcc::String oss;
+    oss.reserve(MAX_DEBUG_MSG_LEN + 128);
+    /* Lines going to a file are written out together rather than one at a time */
+    qcc::String batch;
+    bool toFile = dbgControl->OutputToFile();
+    if (toFile) {
+        batch.reserve(DEBUG_WRITE_BATCH + MAX_DEBUG_MSG_LEN + 128);
+    }
+    while (true) {
+        uint32_t pos = static_cast<uint32_t>(debugDequeuePos);
+        DebugSlot* first = &debugRing[pos & (DEBUG_RING_SLOTS - 1)];
+        /* The exchange leaves the sequence alone, it is only used for the memory barrier */
+        if (!CompareAndExchange(&first->sequence, static_cast<int32_t>(pos + 1), static_cast<int32_t>(pos + 1))) {
+            break;
+        }
+        DebugRecordHeader hdr;
+        memcpy(&hdr, first->data, sizeof(hdr));
+        for (uint32_t i = 0; i < hdr.slots; ++i) {
+            memcpy(record + i * DEBUG_SLOT_DATA, debugRing[(pos + i) & (DEBUG_RING_SLOTS - 1)].data, DEBUG_SLOT_DATA);
+        }
+
+        /* Free the slots before the slow part so producers can reuse them */
+        CompareAndExchange(&first->sequence, static_cast<int32_t>(pos + 1), static_cast<int32_t>(pos + DEBUG_RING_SLOTS));
+        for (uint32_t i = 1; i < hdr.slots; ++i) {
+            CompareAndExchange(&debugRing[(pos + i) & (DEBUG_RING_SLOTS - 1)].sequence, static_cast<int32_t>(pos + i), static_cast<int32_t>(pos + i + DEBUG_RING_SLOTS));
+        }
+        debugDequeuePos = static_cast<int32_t>(pos + hdr.slots);
+
+        const char* module = record + sizeof(hdr);
+        const char* filename = module + strlen(module) + 1;
+        const char* threadName = filename + strlen(filename) + 1;
+        const char* msg = threadName + strlen(threadName) + 1;
+        oss.clear();
+        GenPrefix(oss, hdr.type, module, filename, hdr.lineno,
+                  dbgControl->PrintThread() ? threadName : NULL, hdr.timestamp, dbgUseEpoch);
+        oss.append(msg);
+        oss.push_back('\n');
+        if (!toFile) {
+            dbgControl->WriteDebugMessage(hdr.type, module, oss);
+            continue;
+        }
+        batch.append(oss);
+        if (batch.size() >= DEBUG_WRITE_BATCH) {
+            dbgControl->WriteDebugMessage(hdr.type, module, batch);
+            batch.clear();
+        }
+    }
+    if (!batch.empty()) {
+        dbgControl->WriteDebugMessage(DBG_GEN_MESSAGE, QCC_MODULE, batch);
+    }
+
+    int32_t dropped = debugDropped;
+    if (dropped != debugDroppedReported) {
+        oss.clear();
+        GenPrefix(oss, DBG_LOCAL_ERROR, QCC_MODULE, __FILE__, __LINE__,
+                  dbgControl->PrintThread() ? Thread::GetThreadName() : NULL, GetDebugTimestamp(), dbgUseEpoch);
+        oss.append(U32ToString(static_cast<uint32_t>(dropped - debugDroppedReported)));
+        oss.append(" debug messages dropped\n");
+        dbgControl->WriteDebugMessage(DBG_LOCAL_ERROR, QCC_MODULE, oss);
+        debugDroppedReported = dropped;
+    }
+}
+
+ThreadReturn STDCALL DebugWriterThread::Run(void* arg)
+{
+    QCC_UNUSED(arg);
+
+    while (!IsStopping()) {
+        Event::Wait(*debugWriteEvent, DEBUG_WRITE_INTERVAL);
+        debugWriteEvent->ResetEvent();
+        WriteQueuedDebugMessages();
+    }
+    return 0;
+}
+
+void DebugControl::StartWriter()
+{
+    if (!initialized) {
+        return;
+    }
+    debugWriterLock->Lock();
+    if (dbgControl->AsyncOutput() && !debugWriter) {
+        debugRing = new DebugSlot[DEBUG_RING_SLOTS];
+        for (uint32_t i = 0; i < DEBUG_RING_SLOTS; ++i) {
+            debugRing[i].sequence = static_cast<int32_t>(i);
+        }
+        debugEnqueuePos = 0;
+        debugDequeuePos = 0;
+        debugWriteEvent = new Event();
+        debugWriter = new DebugWriterThread();
+        if (debugWriter->Start() == ER_OK) {
+            /* Publishes the ring to the producers */
+            CompareAndExchange(&debugWriterState, DEBUG_WRITER_STOPPED, DEBUG_WRITER_RUNNING);
+        } else {
+            delete debugWriter;
+            debugWriter = NULL;
+            delete debugWriteEvent;
+            debugWriteEvent = NULL;
+            delete [] debugRing;
+            debugRing = NULL;
+        }
+    }
+    debugWriterLock->Unlock();
+}
+
+void DebugControl::StopWriter()
+{
+    if (!initialized) {
+        return;
+    }
+    debugWriterLock->Lock();
+    if (debugWriter) {
+        CompareAndExchange(&debugWriterState, DEBUG_WRITER_RUNNING, DEBUG_WRITER_STOPPED);
+        /*
+         * Producers check the state after counting themselves in, so once the
+         * count drops to 0 nobody is left writing to the ring or the event.
+         */
+        while (!CompareAndExchange(&debugProducers, 0, 0)) {
+            qcc::Sleep(1);
+        }
+        debugWriter->Stop();
+        debugWriter->Join();
+        delete debugWriter;
+        debugWriter = NULL;
+        WriteQueuedDebugMessages();
+        delete debugWriteEvent;
+        debugWriteEvent = NULL;
+        delete [] debugRing;
+        debugRing = NULL;
+    }
+    debugWriterLock->Unlock();
+}
+
 void DebugContext::Process(DbgMsgType type, const char* module, const char* filename, int lineno)
 {
+    /* A plain read first so that synchronous output pays for no atomic operations */
+    if (debugWriterState == DEBUG_WRITER_RUNNING) {
+        IncrementAndFetch(&debugProducers);
+        bool queued = CompareAndExchange(&debugWriterState, DEBUG_WRITER_RUNNING, DEBUG_WRITER_RUNNING);
+        if (queued) {
+            QueueDebugMessage(type, module, filename, lineno, msg, (std::min)(msgLen, sizeof(msg) - 1));
+        }
+        DecrementAndFetch(&debugProducers);
+        if (queued) {
+            return;
+        }
+    }
+
     qcc::String oss;
 
     oss.reserve(sizeof(msg));
 
-    GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread(), dbgUseEpoch);
+    GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread() ? Thread::GetThreadName() : NULL, GetDebugTimestamp(), dbgUseEpoch);
 
     if (msg != NULL) {
         oss.append(msg);
@@ -374,25 +733,23 @@ void DebugContext::Vprintf(const char* fmt, va_list ap)
 {
     int mlen;
 
-    if (ER_OK == stdoutLock->Lock()) {
-        if (msgLen < sizeof(msg)) {
+    /* The buffer belongs to this context so no lock is needed to format into it */
+    if (msgLen < sizeof(msg)) {
 
 // vsnprintf has been deprecated in the Windows API. Switching Windows to the _s version but
 // leaving other platforms with the standard version of the API until compatibility can be confirmed
 #if defined(QCC_OS_GROUP_WINDOWS)
-            mlen = _vsnprintf_s(msg + msgLen, sizeof(msg) - msgLen, _TRUNCATE, fmt, ap);
+        mlen = _vsnprintf_s(msg + msgLen, sizeof(msg) - msgLen, _TRUNCATE, fmt, ap);
 #else
-            mlen = vsnprintf(msg + msgLen, sizeof(msg) - msgLen, fmt, ap);
+        mlen = vsnprintf(msg + msgLen, sizeof(msg) - msgLen, fmt, ap);
 #endif
 
-            if (mlen > 0) {
-                msgLen += mlen;
-                if (msgLen > sizeof(msg)) {
-                    msgLen = sizeof(msg);
-                }
+        if (mlen > 0) {
+            msgLen += mlen;
+            if (msgLen > sizeof(msg)) {
+                msgLen = sizeof(msg);
             }
         }
-        stdoutLock->Unlock();
     }
 }
 
@@ -442,6 +799,26 @@ void QCC_RegisterOutputFile(FILE* file)
     dbgControl->Register(WriteMsg, reinterpret_cast<void*>(file));
 }
 
+uint32_t QCC_GetDroppedDebugMessages(void)
+{
+    return static_cast<uint32_t>(debugDropped);
+}
+
+void QCC_SetAsyncDebugOutput(bool async)
+{
+    if (!initialized) {
+        return;
+    }
+    debugWriterLock->Lock();
+    dbgControl->SetAsyncOutput(async);
+    if (async) {
+        DebugControl::StartWriter();
+    } else {
+        DebugControl::StopWriter();
+    }
+    debugWriterLock->Unlock();
+}
+
 
 int _QCC_DbgPrintCheck(DbgMsgType type, const char* module)
 {
@@ -466,7 +843,8 @@ void _QCC_DbgDumpHex(DbgMsgType type, const char* module, const char* filename,
 
             oss.reserve(strlen(dataStr) + 8 + dataLen * 4 + (((dataLen + 15) / 16) * (40 + strlen(module))));
 
-            GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread(), dbgUseEpoch);
+            /* Hex dumps can be much longer than a queued message so they are always written right away */
+            GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread() ? Thread::GetThreadName() : NULL, GetDebugTimestamp(), dbgUseEpoch);
 
             oss.append(dataStr);
             oss.push_back('[');
@@ -33,6 +33,18 @@ class DebugControl {
     static void Init();
     static void Shutdown();
 
+    /**
+     * Start the thread that writes debug messages when asynchronous output
+     * is enabled.  Called once threads can be created.
+     */
+    static void StartWriter();
+
+    /**
+     * Stop the thread that writes debug messages and write out any messages
+     * still waiting for it.
+     */
+    static void StopWriter();
+
     DebugControl();
 
     void AddTagLevelPair(const char* tag, uint32_t level);
@@ -41,12 +53,22 @@ class DebugControl {
 
     void WriteDebugMessage(DbgMsgType type, const char* module, const qcc::String msg);
 
+    /**
+     * Whether debug messages go to a file, in which case several of them can
+     * be written in one call to WriteDebugMessage().
+     */
+    bool OutputToFile() const;
+
     void Register(QCC_DbgMsgCallback cb, void* context);
 
     bool Check(DbgMsgType type, const char* module);
 
     bool PrintThread() const;
 
+    bool AsyncOutput() const;
+
+    void SetAsyncOutput(bool async);
+
   private:
     Mutex mutex;
     QCC_DbgMsgCallback cb;
@@ -54,6 +76,7 @@ class DebugControl {
     uint32_t allLevel;
     std::map<const qcc::String, uint32_t> modLevels;
     bool printThread;
+    bool asyncOutput;
 };
 
 }
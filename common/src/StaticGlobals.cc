@@ -63,6 +63,7 @@ class StaticGlobals {
             Shutdown();
             return status;
         }
+        DebugControl::StartWriter();
         status = Crypto::Init();
         if (status != ER_OK) {
             Shutdown();
@@ -74,6 +75,7 @@ class StaticGlobals {
     static QStatus Shutdown()
     {
         Crypto::Shutdown();
+        DebugControl::StopWriter();
         Thread::Shutdown();
         LoggerSetting::Shutdown();
         DebugControl::Shutdown();
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <qcc/atomic.h>
+#include <qcc/Thread.h>
+
+#include <Status.h>
+
+using namespace std;
+using namespace qcc;
+
+TEST(AtomicTest, CompareAndExchange)
+{
+    volatile int32_t value = 5;
+    EXPECT_FALSE(CompareAndExchange(&value, 4, 6));
+    EXPECT_EQ(5, value);
+    EXPECT_TRUE(CompareAndExchange(&value, 5, 6));
+    EXPECT_EQ(6, value);
+    EXPECT_TRUE(CompareAndExchange(&value, 6, 6));
+    EXPECT_EQ(6, value);
+    EXPECT_TRUE(CompareAndExchange(&value, 6, -1));
+    EXPECT_EQ(-1, value);
+}
+
+/*
+ * Adds one to a shared counter at a time with CompareAndExchange.
+ */
+class CompareAndExchangeThread : public Thread {
+  public:
+    CompareAndExchangeThread(volatile int32_t* counter, uint32_t count) :
+        Thread("CompareAndExchangeThread"), counter(counter), count(count) { }
+
+    volatile int32_t* counter;
+    uint32_t count;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t value;
+            do {
+                value = *counter;
+            } while (!CompareAndExchange(counter, value, value + 1));
+        }
+        return 0;
+    }
+};
+
+TEST(AtomicTest, CompareAndExchange_concurrent)
+{
+    const uint32_t numThreads = 4;
+    const uint32_t count = 100000;
+    volatile int32_t counter = 0;
+    vector<CompareAndExchangeThread*> threads;
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads.push_back(new CompareAndExchangeThread(&counter, count));
+        ASSERT_EQ(ER_OK, threads[i]->Start());
+    }
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads[i]->Join();
+        delete threads[i];
+    }
+    /* No increment was lost */
+    EXPECT_EQ(static_cast<int32_t>(numThreads * count), counter);
+}
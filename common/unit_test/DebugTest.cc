@@ -0,0 +1,311 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Debug.h>
+#include <qcc/Event.h>
+#include <qcc/Log.h>
+#include <qcc/Mutex.h>
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+
+#include <Status.h>
+
+#define QCC_MODULE "DEBUGTEST"
+
+using namespace std;
+using namespace qcc;
+
+struct DebugLine {
+    DbgMsgType type;
+    qcc::String module;
+    qcc::String msg;
+};
+
+/*
+ * Collects the debug output.  The writer can be held up in the callback to
+ * fill the ring.
+ */
+class DebugTest : public testing::Test {
+  public:
+    DebugTest() : block(false) { }
+
+    virtual void SetUp()
+    {
+        QCC_SetDebugLevel(QCC_MODULE, 7);
+        QCC_RegisterOutputCallback(Output, this);
+    }
+
+    virtual void TearDown()
+    {
+        QCC_SetAsyncDebugOutput(false);
+        QCC_UseOSLogging(false);
+    }
+
+    static void Output(DbgMsgType type, const char* module, const char* msg, void* context)
+    {
+        DebugTest* test = reinterpret_cast<DebugTest*>(context);
+        if ((strcmp(module, QCC_MODULE) != 0) && (strstr(msg, "debug messages dropped") == NULL)) {
+            return;
+        }
+        if (test->block) {
+            test->block = false;
+            test->blocked.SetEvent();
+            Event::Wait(test->unblock, 5000);
+        }
+        DebugLine line;
+        line.type = type;
+        line.module = module;
+        /* Drop the prefix */
+        const char* text = strstr(msg, "| ");
+        line.msg = text ? text + 2 : msg;
+        test->lock.Lock();
+        test->lines.push_back(line);
+        test->lock.Unlock();
+    }
+
+    /*
+     * The lines logged from this module in the order they were written.
+     */
+    vector<DebugLine> Lines(bool withDropReports = false)
+    {
+        vector<DebugLine> result;
+        lock.Lock();
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (withDropReports || (lines[i].module == QCC_MODULE)) {
+                result.push_back(lines[i]);
+            }
+        }
+        lock.Unlock();
+        return result;
+    }
+
+    Mutex lock;
+    vector<DebugLine> lines;
+    volatile bool block;
+    Event blocked;
+    Event unblock;
+};
+
+class DebugLogThread : public Thread {
+  public:
+    DebugLogThread(uint32_t id, uint32_t count) : Thread("DebugLogThread"), id(id), count(count) { }
+
+    uint32_t id;
+    uint32_t count;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < count; ++i) {
+            QCC_LogMsg(("%u %u", id, i));
+        }
+        return 0;
+    }
+};
+
+TEST_F(DebugTest, AsyncKeepsOrder)
+{
+    const uint32_t count = 1000;
+    uint32_t dropped = QCC_GetDroppedDebugMessages();
+    QCC_SetAsyncDebugOutput(true);
+    for (uint32_t i = 0; i < count; ++i) {
+        QCC_LogMsg(("0 %u", i));
+    }
+    QCC_SetAsyncDebugOutput(false);
+
+    /* Well within the ring so nothing is dropped */
+    EXPECT_EQ(dropped, QCC_GetDroppedDebugMessages());
+    vector<DebugLine> result = Lines();
+    ASSERT_EQ(count, result.size());
+    for (uint32_t i = 0; i < count; ++i) {
+        EXPECT_EQ(DBG_HIGH_LEVEL, result[i].type);
+        EXPECT_STREQ(("0 " + U32ToString(i) + "\n").c_str(), result[i].msg.c_str());
+    }
+}
+
+TEST_F(DebugTest, AsyncKeepsOrderPerThread)
+{
+    const uint32_t numThreads = 4;
+    const uint32_t count = 2000;
+    uint32_t dropped = QCC_GetDroppedDebugMessages();
+    QCC_SetAsyncDebugOutput(true);
+    vector<DebugLogThread*> threads;
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads.push_back(new DebugLogThread(i, count));
+        ASSERT_EQ(ER_OK, threads[i]->Start());
+    }
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads[i]->Join();
+        delete threads[i];
+    }
+    QCC_SetAsyncDebugOutput(false);
+
+    /* Messages may be dropped but every message is either written or counted */
+    vector<DebugLine> result = Lines();
+    EXPECT_EQ(numThreads * count, result.size() + (QCC_GetDroppedDebugMessages() - dropped));
+    vector<int64_t> last(numThreads, -1);
+    for (size_t i = 0; i < result.size(); ++i) {
+        unsigned int id;
+        unsigned int seq;
+        ASSERT_EQ(2, sscanf(result[i].msg.c_str(), "%u %u", &id, &seq));
+        ASSERT_LT(id, numThreads);
+        EXPECT_LT(last[id], static_cast<int64_t>(seq));
+        last[id] = seq;
+    }
+}
+
+TEST_F(DebugTest, AsyncCountsDroppedMessages)
+{
+    const uint32_t count = 10000;
+    uint32_t dropped = QCC_GetDroppedDebugMessages();
+    QCC_SetAsyncDebugOutput(true);
+
+    /* Hold the writer up in the output callback while the ring fills */
+    block = true;
+    QCC_LogError(ER_FAIL, ("first"));
+    ASSERT_EQ(ER_OK, Event::Wait(blocked, 5000));
+    for (uint32_t i = 0; i < count; ++i) {
+        QCC_LogMsg(("%u", i));
+    }
+    uint32_t droppedNow = QCC_GetDroppedDebugMessages() - dropped;
+    EXPECT_LT(0U, droppedNow);
+    EXPECT_GT(count, droppedNow);
+    unblock.SetEvent();
+    QCC_SetAsyncDebugOutput(false);
+
+    EXPECT_EQ(droppedNow, QCC_GetDroppedDebugMessages() - dropped);
+    vector<DebugLine> result = Lines();
+    EXPECT_EQ(count + 1, result.size() + droppedNow);
+
+    /* The writer reports the drops in the log */
+    result = Lines(true);
+    ASSERT_FALSE(result.empty());
+    EXPECT_EQ(DBG_LOCAL_ERROR, result.back().type);
+    EXPECT_STREQ((U32ToString(droppedNow) + " debug messages dropped\n").c_str(), result.back().msg.c_str());
+}
+
+TEST_F(DebugTest, AsyncStopWhileLogging)
+{
+    const uint32_t numThreads = 4;
+    const uint32_t count = 20000;
+    uint32_t dropped = QCC_GetDroppedDebugMessages();
+    vector<DebugLogThread*> threads;
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads.push_back(new DebugLogThread(i, count));
+        ASSERT_EQ(ER_OK, threads[i]->Start());
+    }
+
+    /* Messages logged while the ring is freed go out synchronously */
+    for (uint32_t i = 0; i < 20; ++i) {
+        QCC_SetAsyncDebugOutput(true);
+        qcc::Sleep(1);
+        QCC_SetAsyncDebugOutput(false);
+    }
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        threads[i]->Join();
+        delete threads[i];
+    }
+    EXPECT_EQ(numThreads * count, Lines().size() + (QCC_GetDroppedDebugMessages() - dropped));
+}
+
+TEST_F(DebugTest, AsyncFileOutput)
+{
+    const uint32_t count = 2000;
+    FILE* file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    uint32_t dropped = QCC_GetDroppedDebugMessages();
+    QCC_RegisterOutputFile(file);
+    QCC_SetAsyncDebugOutput(true);
+    for (uint32_t i = 0; i < count; ++i) {
+        QCC_LogMsg(("%u", i));
+    }
+    QCC_SetAsyncDebugOutput(false);
+    QCC_RegisterOutputCallback(Output, this);
+    ASSERT_EQ(dropped, QCC_GetDroppedDebugMessages());
+
+    /* The lines are written in batches but each one is whole and in order */
+    rewind(file);
+    char buf[256];
+    uint32_t next = 0;
+    while (fgets(buf, sizeof(buf), file)) {
+        const char* text = strstr(buf, "| ");
+        if ((strstr(buf, QCC_MODULE) == NULL) || (text == NULL)) {
+            continue;
+        }
+        EXPECT_STREQ((U32ToString(next) + "\n").c_str(), text + 2);
+        ++next;
+    }
+    EXPECT_EQ(count, next);
+    fclose(file);
+}
+
+TEST_F(DebugTest, AsyncSourceCompatible)
+{
+    QCC_SetAsyncDebugOutput(true);
+
+    QCC_LogError(ER_FAIL, ("error %d", 1));
+    QCC_LogMsg(("log %s", "msg"));
+    QCC_DbgHLPrintf(("high level %d", 2));
+    QCC_DbgPrintf(("general %d", 3));
+    QCC_DbgTrace(("trace %d", 4));
+    QCC_DbgRemoteError(("remote %d", 5));
+
+    void* ctx = _QCC_DbgPrintContext("built %s", "in");
+    _QCC_DbgPrintAppend(ctx, " %u parts", 2);
+    _QCC_DbgPrintProcess(ctx, DBG_GEN_MESSAGE, QCC_MODULE, __FILE__, __LINE__);
+
+    /* A context can still be read back and deleted without being output */
+    ctx = _QCC_DbgPrintContext("not %s", "output");
+    EXPECT_STREQ("not output", _QCC_DbgGetMsg(ctx));
+    _QCC_DbgDeleteCtx(ctx);
+
+    QCC_SetAsyncDebugOutput(false);
+
+    vector<DebugLine> result = Lines();
+    size_t i = 0;
+    ASSERT_LT(i, result.size());
+    EXPECT_EQ(DBG_LOCAL_ERROR, result[i].type);
+#if defined(NDEBUG)
+    EXPECT_STREQ(" 0x0001\n", result[i].msg.c_str());
+#else
+    EXPECT_STREQ("error 1: ER_FAIL\n", result[i].msg.c_str());
+#endif
+    ++i;
+    ASSERT_LT(i, result.size());
+    EXPECT_STREQ("log msg\n", result[i++].msg.c_str());
+#if !defined(NDEBUG)
+    ASSERT_LT(i, result.size());
+    EXPECT_STREQ("high level 2\n", result[i++].msg.c_str());
+    ASSERT_LT(i, result.size());
+    EXPECT_STREQ("general 3\n", result[i++].msg.c_str());
+    ASSERT_LT(i, result.size());
+    EXPECT_STREQ("trace 4\n", result[i++].msg.c_str());
+    ASSERT_LT(i, result.size());
+    EXPECT_EQ(DBG_REMOTE_ERROR, result[i].type);
+    EXPECT_STREQ("remote 5\n", result[i++].msg.c_str());
+#endif
+    ASSERT_LT(i, result.size());
+    EXPECT_EQ(DBG_GEN_MESSAGE, result[i].type);
+    EXPECT_STREQ("built in 2 parts\n", result[i++].msg.c_str());
+    EXPECT_EQ(i, result.size());
+}
@@ -46,3 +46,28 @@ TEST(ThreadTest, CleanExternalThread) {
     ASSERT_NE(0, CloseHandle(reinterpret_cast<HANDLE>(handle)));
 #endif
 }
+
+class NameThread : public Thread {
+  public:
+    NameThread() : Thread("NameThread"), current(NULL) { }
+
+    Thread* current;
+    qcc::String name;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        current = Thread::GetThread();
+        name = Thread::GetThreadName();
+        return NULL;
+    }
+};
+
+TEST(ThreadTest, GetThreadName) {
+    NameThread thread;
+    ASSERT_EQ(ER_OK, thread.Start());
+    ASSERT_EQ(ER_OK, thread.Join());
+    EXPECT_EQ(&thread, thread.current);
+    EXPECT_STREQ("NameThread", thread.name.c_str());
+}